@@ -18,6 +18,20 @@ class IAddrMapper {
      * 
      */
     virtual void apply(Request& req) = 0;   
+
+    /**
+     * @brief  Lines (RD/WR bursts) at the tail of every row that the mapping keeps free for inline ECC parity, 0 if
+     *         data uses whole rows
+     * 
+     */
+    virtual int inline_parity_lines() const { return 0; };
+
+    /**
+     * @brief  Sets addr to a physical address that the mapping maps to addr_vec (every level down to the column set).
+     *         Returns false if no address does or the mapper cannot invert its mapping
+     * 
+     */
+    virtual bool invert(const AddrVec_t& addr_vec, Addr_t& addr) { return false; };
 };
 
 }       // namespace Ramulator
@@ -0,0 +1,251 @@
+#ifndef     RAMULATOR_ADDR_MAPPER_BIT_MASK_MAPPING_H
+#define     RAMULATOR_ADDR_MAPPER_BIT_MASK_MAPPING_H
+
+#include <vector>
+#include <cstdint>
+#include <bit>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#include "base/type.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    An address mapping compiled into bit masks, from the physical address to the id of every level
+ * @details
+ * Every bit of a level id is the parity of a set of physical address bits (a single bit for the plain mappings, two or
+ * more for the XOR ones). compile() splits each level into planes: plane k holds the k-th address bit of every id bit,
+ * which works whenever those bits ascend with the id bits and only the top id bits lack a k-th term. A level id is
+ * then the XOR of one bit extraction per plane: a PEXT with BMI2, otherwise a few shifts and masks over the contiguous
+ * runs of the plane precomputed at compile time. Levels that do not fit the planes use one parity per id bit.
+ *
+ * The id bits are linear over GF(2), so compile() also reduces their masks (Gauss-Jordan) for invert(), which solves
+ * for a physical address that maps to an address vector.
+ *
+ */
+class BitMaskMapping {
+  public:
+    // The address bits whose parity makes each bit of a level id, from its least-significant bit
+    using LevelBits = std::vector<uint64_t>;
+    // Marks a level that the mapping leaves unset (-1)
+    static inline const LevelBits UNMAPPED = {~uint64_t(0)};
+
+  private:
+    struct Run {
+      int src;            // Lowest address bit of the run
+      int dst;            // Where it goes in the level id
+      uint64_t mask;      // The bits of the run, from bit 0
+    };
+
+    struct Plane {
+      uint64_t mask = 0;
+      std::vector<Run> runs;
+    };
+
+    struct Level {
+      bool mapped = true;
+      std::vector<Plane> planes;
+      std::vector<uint64_t> parity_bits;    // Empty unless the level does not fit the planes
+    };
+    std::vector<Level> m_levels;
+
+    // The id bit masks reduced to one pivot address bit each. combo marks the id bits (in level order) XORed into the
+    // row, so the pivot bit of an address is the parity of those id bits
+    struct Reduced {
+      uint64_t mask;
+      uint64_t combo;
+      int pivot;          // -1 for a dependent id bit, whose combo must have an even parity
+    };
+    std::vector<Reduced> m_reduced;
+    bool m_invertible = false;
+
+  public:
+    void compile(const std::vector<LevelBits>& levels) {
+      m_levels.clear();
+      for (const LevelBits& bits : levels) {
+        Level& level = m_levels.emplace_back();
+        if (bits == UNMAPPED) {
+          level.mapped = false;
+          continue;
+        }
+        if (!make_planes(bits, level.planes)) {
+          level.planes.clear();
+          level.parity_bits = bits;
+        }
+      }
+      reduce(levels);
+    };
+
+    void apply(Addr_t addr, AddrVec_t& addr_vec) const {
+      uint64_t x = addr;
+      addr_vec.resize(m_levels.size(), -1);
+      for (size_t i = 0; i < m_levels.size(); i++) {
+        const Level& level = m_levels[i];
+        if (!level.mapped) {
+          continue;
+        }
+        uint64_t id = 0;
+        for (const Plane& plane : level.planes) {
+          id ^= extract(x, plane);
+        }
+        for (size_t bit = 0; bit < level.parity_bits.size(); bit++) {
+          id |= uint64_t(std::popcount(x & level.parity_bits[bit]) & 1) << bit;
+        }
+        addr_vec[i] = int(id);
+      }
+    };
+
+    /**
+     * @brief    Sets addr to a physical address that maps to addr_vec (its unmapped levels are ignored), with only the
+     *           pivot bits of the reduced masks set. Returns false if no address does, or the mapping has more than 64 id bits.
+     *
+     */
+    bool invert(const AddrVec_t& addr_vec, Addr_t& addr) const {
+      if (!m_invertible || addr_vec.size() < m_levels.size()) {
+        return false;
+      }
+      uint64_t target = 0;      // The id bits, in level order
+      int pos = 0;
+      for (size_t i = 0; i < m_levels.size(); i++) {
+        const Level& level = m_levels[i];
+        if (!level.mapped) {
+          continue;
+        }
+        int num_bits = num_id_bits(level);
+        if (addr_vec[i] < 0 || (num_bits < 32 && (addr_vec[i] >> num_bits) != 0)) {
+          return false;
+        }
+        if (num_bits > 0) {
+          target |= (uint64_t(addr_vec[i]) & (num_bits < 64 ? (uint64_t(1) << num_bits) - 1 : ~uint64_t(0))) << pos;
+        }
+        pos += num_bits;
+      }
+
+      uint64_t x = 0;
+      for (const Reduced& row : m_reduced) {
+        bool parity = std::popcount(target & row.combo) & 1;
+        if (row.pivot == -1) {
+          if (parity) {
+            return false;
+          }
+        } else if (parity) {
+          x |= uint64_t(1) << row.pivot;
+        }
+      }
+      addr = Addr_t(x);
+      return true;
+    };
+
+    /**
+     * @brief    The masks of num_bits consecutive address bits from first_bit.
+     *
+     */
+    static LevelBits contiguous(int first_bit, int num_bits) {
+      LevelBits bits;
+      for (int i = 0; i < num_bits; i++) {
+        bits.push_back(uint64_t(1) << (first_bit + i));
+      }
+      return bits;
+    };
+
+  private:
+    static int num_id_bits(const Level& level) {
+      if (!level.parity_bits.empty()) {
+        return level.parity_bits.size();
+      }
+      return level.planes.empty() ? 0 : std::popcount(level.planes[0].mask);
+    };
+
+    void reduce(const std::vector<LevelBits>& levels) {
+      m_reduced.clear();
+      m_invertible = false;
+      std::vector<uint64_t> masks;
+      for (const LevelBits& bits : levels) {
+        if (bits != UNMAPPED) {
+          masks.insert(masks.end(), bits.begin(), bits.end());
+        }
+      }
+      if (masks.size() > 64) {
+        return;
+      }
+      for (size_t i = 0; i < masks.size(); i++) {
+        Reduced row = {masks[i], uint64_t(1) << i, -1};
+        for (const Reduced& prev : m_reduced) {
+          if (prev.pivot != -1 && ((row.mask >> prev.pivot) & 1)) {
+            row.mask ^= prev.mask;
+            row.combo ^= prev.combo;
+          }
+        }
+        if (row.mask != 0) {
+          row.pivot = std::countr_zero(row.mask);
+          for (Reduced& prev : m_reduced) {
+            if ((prev.mask >> row.pivot) & 1) {
+              prev.mask ^= row.mask;
+              prev.combo ^= row.combo;
+            }
+          }
+        }
+        m_reduced.push_back(row);
+      }
+      m_invertible = true;
+    };
+
+    static uint64_t extract(uint64_t x, const Plane& plane) {
+#if defined(__BMI2__)
+      return _pext_u64(x, plane.mask);
+#else
+      uint64_t id = 0;
+      for (const Run& run : plane.runs) {
+        id |= ((x >> run.src) & run.mask) << run.dst;
+      }
+      return id;
+#endif
+    };
+
+    static bool make_planes(const LevelBits& bits, std::vector<Plane>& planes) {
+      for (size_t k = 0; ; k++) {
+        Plane plane;
+        int prev_src = -1;
+        size_t num_bits = 0;
+        for (size_t bit = 0; bit < bits.size(); bit++) {
+          uint64_t term = kth_bit(bits[bit], k);
+          if (term == 0) {
+            continue;
+          }
+          int src = std::countr_zero(term);
+          // The id bits with a k-th term must be a prefix, with ascending address bits
+          if (bit != num_bits || src <= prev_src) {
+            return false;
+          }
+          if (!plane.runs.empty() && src == prev_src + 1) {
+            plane.runs.back().mask = (plane.runs.back().mask << 1) | 1;
+          } else {
+            plane.runs.push_back({src, int(bit), 1});
+          }
+          plane.mask |= term;
+          prev_src = src;
+          num_bits++;
+        }
+        if (num_bits == 0) {
+          return true;
+        }
+        planes.push_back(std::move(plane));
+      }
+    };
+
+    // The k-th lowest set bit of mask, or 0
+    static uint64_t kth_bit(uint64_t mask, size_t k) {
+      for (size_t i = 0; i < k && mask; i++) {
+        mask &= mask - 1;
+      }
+      return mask & (~mask + 1);
+    };
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_ADDR_MAPPER_BIT_MASK_MAPPING_H
@@ -1,8 +1,11 @@
 #include <vector>
+#include <string>
 
 #include "base/base.h"
+#include "base/utils.h"
 #include "dram/dram.h"
 #include "addr_mapper/addr_mapper.h"
+#include "addr_mapper/impl/bit_mask_mapping.h"
 #include "memory_system/memory_system.h"
 
 namespace Ramulator {
@@ -18,6 +21,16 @@ class LinearMapperBase : public IAddrMapper {
     int m_col_bits_idx = -1;
     int m_row_bits_idx = -1;
 
+    BitMaskMapping m_mapping;     // Compiled by the mappers at setup()
+
+    // Inline ECC: the last m_parity_lines lines of every row hold parity, the data of a bank is packed into the others
+    int m_parity_lines = 0;
+    int m_lines_per_row = 0;
+    int m_data_lines_per_row = 0;
+    int m_num_rows = 0;
+    float s_capacity_loss = 0;            // Fraction of the DRAM capacity taken by the parity columns
+    size_t s_aliased_requests = 0;        // Requests beyond the data capacity, wrapped around onto lower rows
+
 
   protected:
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system) {
@@ -46,8 +59,62 @@ class LinearMapperBase : public IAddrMapper {
 
       // Assume column is always the last level
       m_col_bits_idx = m_num_levels - 1;
+
+      // The parameters and statistics shared by all linear mappers
+      Implementation* impl = dynamic_cast<Implementation*>(this);
+      m_parity_lines = impl->param<int>("inline_parity_lines").desc("Lines (RD/WR bursts) at the tail of every row reserved for inline ECC parity (0 = none).").default_val(0);
+      m_lines_per_row = 1 << m_addr_bits[m_col_bits_idx];
+      m_data_lines_per_row = m_lines_per_row - m_parity_lines;
+      m_num_rows = count[m_row_bits_idx];
+      if (m_parity_lines < 0 || m_data_lines_per_row <= 0) {
+        throw ConfigurationError("Linear address mapper: inline_parity_lines must leave data lines in a row of {} lines (got {})!", m_lines_per_row, m_parity_lines);
+      }
+      if (m_parity_lines > 0) {
+        s_capacity_loss = (float) m_parity_lines / (float) m_lines_per_row;
+        impl->register_stat(m_parity_lines).name("inline_parity_lines");
+        impl->register_stat(s_capacity_loss).name("inline_parity_capacity_loss");
+        impl->register_stat(s_aliased_requests).name("inline_parity_aliased_requests");
+      }
+    }
+
+  public:
+    void apply(Request& req) override {
+      m_mapping.apply(req.addr, req.addr_vec);
+      if (m_parity_lines > 0) {
+        skip_parity_columns(req.addr_vec);
+      }
+    }
+
+    int inline_parity_lines() const override { return m_parity_lines; };
+
+    bool invert(const AddrVec_t& addr_vec, Addr_t& addr) override {
+      AddrVec_t mapped = addr_vec;
+      if (m_parity_lines > 0) {
+        // Back to the (row, column) of the mapping, undoing skip_parity_columns()
+        if (addr_vec[m_col_bits_idx] < 0 || addr_vec[m_col_bits_idx] >= m_data_lines_per_row) {
+          return false;
+        }
+        int64_t line = (int64_t) addr_vec[m_row_bits_idx] * m_data_lines_per_row + addr_vec[m_col_bits_idx];
+        mapped[m_row_bits_idx] = line / m_lines_per_row;
+        mapped[m_col_bits_idx] = line % m_lines_per_row;
+      }
+      return m_mapping.invert(mapped, addr);
     }
 
+  protected:
+    // The (row, column) the mapping gives is the line row * lines_per_row + column of its bank. Line k of a bank then
+    // goes to column k % data_lines_per_row of row k / data_lines_per_row, so consecutive lines stay in one row and
+    // the parity columns are never used for data. The lines that no longer fit the bank wrap around onto its first rows.
+    void skip_parity_columns(AddrVec_t& addr_vec) {
+      int64_t line = (int64_t) addr_vec[m_row_bits_idx] * m_lines_per_row + addr_vec[m_col_bits_idx];
+      int64_t row = line / m_data_lines_per_row;
+      if (row >= m_num_rows) {
+        s_aliased_requests++;
+        row %= m_num_rows;
+      }
+      addr_vec[m_row_bits_idx] = row;
+      addr_vec[m_col_bits_idx] = line % m_data_lines_per_row;
+    }
 };
 
 
@@ -59,14 +126,15 @@ class ChRaBaRoCo final : public LinearMapperBase, public Implementation {
 
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
       LinearMapperBase::setup(frontend, memory_system);
-    }
 
-    void apply(Request& req) override {
-      req.addr_vec.resize(m_num_levels, -1);
-      Addr_t addr = req.addr >> m_tx_offset;
-      for (int i = m_addr_bits.size() - 1; i >= 0; i--) {
-        req.addr_vec[i] = slice_lower_bits(addr, m_addr_bits[i]);
+      // From the column at the bottom to the channel at the top
+      std::vector<BitMaskMapping::LevelBits> levels(m_num_levels);
+      int pos = m_tx_offset;
+      for (int i = m_num_levels - 1; i >= 0; i--) {
+        levels[i] = BitMaskMapping::contiguous(pos, m_addr_bits[i]);
+        pos += m_addr_bits[i];
       }
+      m_mapping.compile(levels);
     }
 };
 
@@ -79,16 +147,19 @@ class RoBaRaCoCh final : public LinearMapperBase, public Implementation {
 
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
       LinearMapperBase::setup(frontend, memory_system);
-    }
 
-    void apply(Request& req) override {
-      req.addr_vec.resize(m_num_levels, -1);
-      Addr_t addr = req.addr >> m_tx_offset;
-      req.addr_vec[0] = slice_lower_bits(addr, m_addr_bits[0]);
-      req.addr_vec[m_addr_bits.size() - 1] = slice_lower_bits(addr, m_addr_bits[m_addr_bits.size() - 1]);
+      // The channel, then the column, then the levels from the rank up to the row
+      std::vector<BitMaskMapping::LevelBits> levels(m_num_levels, BitMaskMapping::UNMAPPED);
+      int pos = m_tx_offset;
+      levels[0] = BitMaskMapping::contiguous(pos, m_addr_bits[0]);
+      pos += m_addr_bits[0];
+      levels[m_col_bits_idx] = BitMaskMapping::contiguous(pos, m_addr_bits[m_col_bits_idx]);
+      pos += m_addr_bits[m_col_bits_idx];
       for (int i = 1; i <= m_row_bits_idx; i++) {
-        req.addr_vec[i] = slice_lower_bits(addr, m_addr_bits[i]);
+        levels[i] = BitMaskMapping::contiguous(pos, m_addr_bits[i]);
+        pos += m_addr_bits[i];
       }
+      m_mapping.compile(levels);
     }
 };
 
@@ -101,26 +172,123 @@ class MOP4CLXOR final : public LinearMapperBase, public Implementation {
 
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
       LinearMapperBase::setup(frontend, memory_system);
-    }
 
-    void apply(Request& req) override {
-      req.addr_vec.resize(m_num_levels, -1);
-      Addr_t addr = req.addr >> m_tx_offset;
-      req.addr_vec[m_col_bits_idx] = slice_lower_bits(addr, 2);
-      for (int lvl = 0 ; lvl < m_row_bits_idx ; lvl++)
-          req.addr_vec[lvl] = slice_lower_bits(addr, m_addr_bits[lvl]);
-      req.addr_vec[m_col_bits_idx] += slice_lower_bits(addr, m_addr_bits[m_col_bits_idx]-2) << 2;
-      req.addr_vec[m_row_bits_idx] = (int) addr;
-
-      int row_xor_index = 0; 
-      for (int lvl = 0 ; lvl < m_col_bits_idx ; lvl++){
-        if (m_addr_bits[lvl] > 0){
-          int mask = (req.addr_vec[m_col_bits_idx] >> row_xor_index) & ((1<<m_addr_bits[lvl])-1);
-          req.addr_vec[lvl] = req.addr_vec[lvl] xor mask;
+      // The 2 lowest column bits, the levels below the row, the rest of the column, then the row in all the upper bits
+      std::vector<BitMaskMapping::LevelBits> levels(m_num_levels, BitMaskMapping::UNMAPPED);
+      int pos = m_tx_offset;
+      BitMaskMapping::LevelBits col_bits = BitMaskMapping::contiguous(pos, 2);
+      pos += 2;
+      for (int lvl = 0; lvl < m_row_bits_idx; lvl++) {
+        levels[lvl] = BitMaskMapping::contiguous(pos, m_addr_bits[lvl]);
+        pos += m_addr_bits[lvl];
+      }
+      BitMaskMapping::LevelBits col_upper_bits = BitMaskMapping::contiguous(pos, m_addr_bits[m_col_bits_idx] - 2);
+      col_bits.insert(col_bits.end(), col_upper_bits.begin(), col_upper_bits.end());
+      levels[m_col_bits_idx] = col_bits;
+      pos += m_addr_bits[m_col_bits_idx] - 2;
+      levels[m_row_bits_idx] = BitMaskMapping::contiguous(pos, 64 - pos);
+
+      // Every level above the column is XORed with the next column bits
+      int row_xor_index = 0;
+      for (int lvl = 0; lvl < m_col_bits_idx; lvl++) {
+        if (m_addr_bits[lvl] > 0 && levels[lvl] != BitMaskMapping::UNMAPPED) {
+          for (int bit = 0; bit < m_addr_bits[lvl] && row_xor_index + bit < int(col_bits.size()); bit++) {
+            levels[lvl][bit] |= col_bits[row_xor_index + bit];
+          }
           row_xor_index += m_addr_bits[lvl];
         }
       }
+      m_mapping.compile(levels);
     }
 };
 
+
+class BitMask final : public LinearMapperBase, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IAddrMapper, BitMask, "BitMask", "Applies a mapping given as the physical address bits of every level.");
+
+  private:
+    std::vector<std::pair<std::string, std::vector<std::string>>> m_level_bits;
+
+  public:
+    void init() override {
+      const YAML::Node& levels = m_config["levels"];
+      if (!levels || !levels.IsMap()) {
+        throw ConfigurationError("BitMask address mapper needs a map of levels to their address bits!");
+      }
+      for (const auto& level : levels) {
+        m_level_bits.push_back({level.first.as<std::string>(), level.second.as<std::vector<std::string>>()});
+      }
+    };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      LinearMapperBase::setup(frontend, memory_system);
+
+      std::vector<BitMaskMapping::LevelBits> levels(m_num_levels);
+      std::vector<bool> is_given(m_num_levels, false);
+      for (const auto& [name, bit_strs] : m_level_bits) {
+        int level = -1;
+        try {
+          level = m_dram->m_levels(name);
+        } catch (const std::out_of_range& r) {
+          throw ConfigurationError("BitMask address mapper: level {} is not in the organization!", name);
+        }
+        for (const std::string& bit_str : bit_strs) {
+          parse_bits(bit_str, levels[level]);
+        }
+        if (int(levels[level].size()) != m_addr_bits[level]) {
+          throw ConfigurationError("BitMask address mapper: level {} needs {} address bits, got {}!", name, m_addr_bits[level], levels[level].size());
+        }
+        is_given[level] = true;
+      }
+      for (int level = 0; level < m_num_levels; level++) {
+        if (!is_given[level] && m_addr_bits[level] > 0) {
+          throw ConfigurationError("BitMask address mapper: the address bits of level {} are not given!", level);
+        }
+      }
+      m_mapping.compile(levels);
+    }
+
+  private:
+    // "a" is address bit a, "a-b" the bits from a to b, "a^b^..." their XOR (one bit of the level), and "0x..." the
+    // XOR of the address bits set in the mask (a row of an XOR matrix)
+    static void parse_bits(const std::string& bit_str, BitMaskMapping::LevelBits& bits) {
+      try {
+        if (bit_str.starts_with("0x")) {
+          uint64_t mask = std::stoull(bit_str.substr(2), nullptr, 16);
+          if (mask == 0) {
+            throw std::invalid_argument(bit_str);
+          }
+          bits.push_back(mask);
+          return;
+        }
+        if (size_t dash = bit_str.find('-'); dash != std::string::npos) {
+          int first = std::stoi(bit_str.substr(0, dash));
+          int last = std::stoi(bit_str.substr(dash + 1));
+          if (first < 0 || last > 63 || first > last) {
+            throw std::out_of_range(bit_str);
+          }
+          BitMaskMapping::LevelBits range = BitMaskMapping::contiguous(first, last - first + 1);
+          bits.insert(bits.end(), range.begin(), range.end());
+          return;
+        }
+        std::vector<std::string> terms;
+        tokenize(terms, bit_str, "^");
+        uint64_t mask = 0;
+        for (const std::string& term : terms) {
+          int bit = std::stoi(term);
+          if (bit < 0 || bit > 63) {
+            throw std::out_of_range(bit_str);
+          }
+          mask ^= uint64_t(1) << bit;
+        }
+        if (mask == 0) {
+          throw std::invalid_argument(bit_str);
+        }
+        bits.push_back(mask);
+      } catch (const std::logic_error&) {
+        throw ConfigurationError("BitMask address mapper: invalid address bits \"{}\"!", bit_str);
+      }
+    };
+};
+
 }   // namespace Ramulator
\ No newline at end of file
@@ -38,28 +38,72 @@ void LinearMapperBase_with_rit::init_rit(int num_banks, int num_rit_entries){
   m_row_level = m_dram->m_levels("row");
 
   // setup RIT
-  for (int i = 0; i < num_banks; i++) {
-    std::unordered_map<int, RIT_entry> rit_bank;
-    m_row_indirection_table.push_back(rit_bank);
+  int num_rows = m_dram->m_organization.count[m_row_level];
+  m_row_indirection_table.resize(num_banks);
+  for (BankRIT& bank : m_row_indirection_table) {
+    bank.swapped.assign((num_rows + 63) / 64, 0);
+    bank.pages.resize((num_rows + (1 << PAGE_BITS) - 1) >> PAGE_BITS);
   }
 }
 
+// The swapped bits, the allocated pages and the row lists of every bank
+size_t LinearMapperBase_with_rit::rit_footprint() const {
+  size_t bytes = heap_bytes(m_row_indirection_table);
+  for (const BankRIT& bank : m_row_indirection_table) {
+    bytes += heap_bytes(bank.swapped) + heap_bytes(bank.pages) + heap_bytes(bank.rows);
+    for (const std::unique_ptr<RIT_entry[]>& page : bank.pages) {
+      bytes += page ? sizeof(RIT_entry) << PAGE_BITS : 0;
+    }
+  }
+  return bytes;
+}
+
+void LinearMapperBase_with_rit::set_entry(BankRIT& bank, int src_row, int dst_row) {
+  if (!is_swapped(bank, src_row)) {
+    bank.swapped[src_row >> 6] |= uint64_t(1) << (src_row & 63);
+    std::unique_ptr<RIT_entry[]>& page = bank.pages[src_row >> PAGE_BITS];
+    if (!page) {
+      page = std::make_unique<RIT_entry[]>(1 << PAGE_BITS);
+    }
+    entry(bank, src_row).list_idx = bank.rows.size();
+    bank.rows.push_back(src_row);
+  }
+  RIT_entry& src_entry = entry(bank, src_row);
+  src_entry.dst_row = dst_row;
+  src_entry.lock = true;
+}
+
+void LinearMapperBase_with_rit::erase_entry(BankRIT& bank, int row) {
+  if (!is_swapped(bank, row)) {
+    return;
+  }
+  bank.swapped[row >> 6] &= ~(uint64_t(1) << (row & 63));
+  // Move the last listed row into the erased one's place
+  int list_idx = entry(bank, row).list_idx;
+  int last_row = bank.rows.back();
+  bank.rows[list_idx] = last_row;
+  entry(bank, last_row).list_idx = list_idx;
+  bank.rows.pop_back();
+}
+
 // check if the entry is in the RIT
 int LinearMapperBase_with_rit::check_rit(int flat_bank_id, int src_row){
-  if (m_row_indirection_table[flat_bank_id].find(src_row) != m_row_indirection_table[flat_bank_id].end()) {
-    return m_row_indirection_table[flat_bank_id][src_row].dst_row;
+  BankRIT& bank = m_row_indirection_table[flat_bank_id];
+  if (is_swapped(bank, src_row)) {
+    return entry(bank, src_row).dst_row;
   }
   return -1;
 }
 
 // check if the RIT is full
 bool LinearMapperBase_with_rit::is_rit_full(int flat_bank_id){
-  return m_row_indirection_table[flat_bank_id].size() >= m_num_rit_entries;
+  return m_row_indirection_table[flat_bank_id].rows.size() >= m_num_rit_entries;
 }
 
 // check if the entry is locked
 bool LinearMapperBase_with_rit::is_rit_locked(int flat_bank_id, int src_row){
-  return m_row_indirection_table[flat_bank_id][src_row].lock;
+  BankRIT& bank = m_row_indirection_table[flat_bank_id];
+  return is_swapped(bank, src_row) && entry(bank, src_row).lock;
 }
 
 // performs the indirection if the row is in the RIT
@@ -75,40 +119,32 @@ void LinearMapperBase_with_rit::apply_indirection(Request& req){
     accumulated_dimension *= m_dram->m_organization.count[i + 1];
     flat_bank_id += req.addr_vec[i] * accumulated_dimension;
   }
+  // if the row is in the RIT, update the request row address, otherwise, do nothing
+  BankRIT& bank = m_row_indirection_table[flat_bank_id];
   int src_row = req.addr_vec[m_row_level];
-  int dst_row = -1;
-  // check if the row is in the RIT
-  dst_row = check_rit(flat_bank_id, src_row);
-
-  // if dst_row is found, update the request row address, otherwise, do nothing
-  if (dst_row != -1) {
-    req.addr_vec[m_row_level] = dst_row;
+  if (is_swapped(bank, src_row)) {
+    req.addr_vec[m_row_level] = entry(bank, src_row).dst_row;
   }
 }
 
 // unlocks all the entries in the RIT at the end of each Epoch
 void LinearMapperBase_with_rit::rit_unlock() {
   for (auto& bank : m_row_indirection_table) {
-    for (auto& entry : bank) {
-      entry.second.lock = false;
+    for (int row : bank.rows) {
+      entry(bank, row).lock = false;
     }
   }
 }
 
 // inserts the entry and its pair into the RIT
 void LinearMapperBase_with_rit::rit_insert_entry(int flat_bank_id, int src_row, int dst_row) {
+  BankRIT& bank = m_row_indirection_table[flat_bank_id];
   // insert the entry into the RIT
-  RIT_entry entry0;
-  entry0.dst_row = dst_row;
-  entry0.lock = true;
-  m_row_indirection_table[flat_bank_id][src_row] = entry0;
+  set_entry(bank, src_row, dst_row);
   // insert the pair of entry into the RIT
-  RIT_entry entry1;
-  entry1.dst_row = src_row;
-  entry1.lock = true;
-  m_row_indirection_table[flat_bank_id][dst_row] = entry1;
+  set_entry(bank, dst_row, src_row);
 
-  if(m_row_indirection_table[flat_bank_id].size() > m_num_rit_entries){
+  if(bank.rows.size() > m_num_rit_entries){
     std::cerr << "RIT is full!!!!!!!!!! Check before insertion." << std::endl;
     exit(1);
   }
@@ -116,20 +152,20 @@ void LinearMapperBase_with_rit::rit_insert_entry(int flat_bank_id, int src_row,
 
 // removes the entry and its pair from the RIT
 void LinearMapperBase_with_rit::rit_remove_entry(int flat_bank_id, int src_row, int dst_row) {
+  BankRIT& bank = m_row_indirection_table[flat_bank_id];
   // remove the entry from the RIT
-  m_row_indirection_table[flat_bank_id].erase(src_row);
+  erase_entry(bank, src_row);
   // remove the pair of entry from the RIT
-  m_row_indirection_table[flat_bank_id].erase(dst_row);
+  erase_entry(bank, dst_row);
 }
 
-// gets a pair of entries from the RIT to unswap, the pair cannot be in the exclusion_list
-std::pair<int, int> LinearMapperBase_with_rit::get_unswap_pair(int flat_bank_id, const std::unordered_map<int, int>& exclusion_list){
-  std::pair<int, int> unswap_pair;
-  for (auto& entry : m_row_indirection_table[flat_bank_id]) {
-    if (!entry.second.lock && exclusion_list.find(entry.first) == exclusion_list.end() && exclusion_list.find(entry.second.dst_row) == exclusion_list.end()) {
-      unswap_pair.first = entry.first;
-      unswap_pair.second = entry.second.dst_row;
-      return unswap_pair;
+// gets a pair of entries from the RIT to unswap, neither row of the pair can be excluded
+std::pair<int, int> LinearMapperBase_with_rit::get_unswap_pair(int flat_bank_id, const std::function<bool(int)>& is_excluded){
+  BankRIT& bank = m_row_indirection_table[flat_bank_id];
+  for (int row : bank.rows) {
+    const RIT_entry& row_entry = entry(bank, row);
+    if (!row_entry.lock && !is_excluded(row) && !is_excluded(row_entry.dst_row)) {
+      return {row, row_entry.dst_row};
     }
   }
   std::cerr << "No unlocked entry found in the RIT! Should not happen!" << std::endl;
@@ -138,11 +174,13 @@ std::pair<int, int> LinearMapperBase_with_rit::get_unswap_pair(int flat_bank_id,
 
 // dumps RIT for debug
 void LinearMapperBase_with_rit::dump_rit(int flat_bank_id) {
+  BankRIT& bank = m_row_indirection_table[flat_bank_id];
   std::cout << "======================" << std::endl
-            << "RIT[" << flat_bank_id << "].size(): " << m_row_indirection_table[flat_bank_id].size() << std::endl;
+            << "RIT[" << flat_bank_id << "].size(): " << bank.rows.size() << std::endl;
 
-  for (auto entry: m_row_indirection_table[flat_bank_id]){
-    std::cout << entry.first << " -> " << entry.second.dst_row << "\t" << (entry.second.lock ? "locked": "unlocked") << std::endl;
+  for (int row : bank.rows) {
+    const RIT_entry& row_entry = entry(bank, row);
+    std::cout << row << " -> " << row_entry.dst_row << "\t" << (row_entry.lock ? "locked": "unlocked") << std::endl;
   }
   std::cout << "======================" << std::endl;
 }
@@ -153,6 +191,8 @@ class ChRaBaRoCo_with_rit final : public LinearMapperBase_with_rit, public Imple
   public:
     void init() override { };
 
+    size_t memory_footprint() const override { return rit_footprint(); };
+
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
       LinearMapperBase_with_rit::setup(frontend, memory_system);
     }
@@ -175,6 +215,8 @@ class RoBaRaCoCh_with_rit final : public LinearMapperBase_with_rit, public Imple
   public:
     void init() override { };
 
+    size_t memory_footprint() const override { return rit_footprint(); };
+
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
       LinearMapperBase_with_rit::setup(frontend, memory_system);
     }
@@ -199,6 +241,8 @@ class MOP4CLXOR_with_rit final : public LinearMapperBase_with_rit, public Implem
   public:
     void init() override { };
 
+    size_t memory_footprint() const override { return rit_footprint(); };
+
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
       LinearMapperBase_with_rit::setup(frontend, memory_system);
     }
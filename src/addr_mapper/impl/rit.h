@@ -1,7 +1,9 @@
 #include <vector>
-#include <unordered_map>
+#include <memory>
+#include <functional>
 
 #include "base/base.h"
+#include "base/memory_report.h"
 #include "dram/dram.h"
 #include "addr_mapper/addr_mapper.h"
 #include "memory_system/memory_system.h"
@@ -25,11 +27,24 @@ class LinearMapperBase_with_rit : public IAddrMapper {
     int m_num_rit_entries = -1;
 
     struct RIT_entry {
-      // src_row is the key of the unordered_map
-      int dst_row;
-      bool lock;
+      int dst_row = -1;
+      bool lock = false;
+      int list_idx = -1;      // Position of the source row in BankRIT::rows
     };
-    std::vector<std::unordered_map<int, RIT_entry>> m_row_indirection_table;
+    /**
+     * @brief    The swapped rows of a bank, indexed by source row
+     * @details
+     * A bit per row marks the swapped ones, so the common case of an access to an unswapped row is one bit test. The
+     * entries are stored in pages of 2^PAGE_BITS rows that are allocated on the first swap of one of their rows, and
+     * the swapped rows are also listed densely for the scans over the entries.
+     */
+    struct BankRIT {
+      std::vector<uint64_t> swapped;
+      std::vector<std::unique_ptr<RIT_entry[]>> pages;
+      std::vector<int> rows;
+    };
+    static constexpr int PAGE_BITS = 10;
+    std::vector<BankRIT> m_row_indirection_table;
 
   public:
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system);
@@ -41,8 +56,15 @@ class LinearMapperBase_with_rit : public IAddrMapper {
     void rit_unlock();
     void rit_insert_entry(int flat_bank_id, int src_row, int dst_row);
     void rit_remove_entry(int flat_bank_id, int src_row, int dst_row);
-    std::pair<int, int> get_unswap_pair(int flat_bank_id, const std::unordered_map<int, int>& exclusion_list);
+    std::pair<int, int> get_unswap_pair(int flat_bank_id, const std::function<bool(int)>& is_excluded);
     void dump_rit(int flat_bank_id);
+    size_t rit_footprint() const;
+
+  private:
+    bool is_swapped(const BankRIT& bank, int row) const { return (bank.swapped[row >> 6] >> (row & 63)) & 1; };
+    RIT_entry& entry(BankRIT& bank, int row) { return bank.pages[row >> PAGE_BITS][row & ((1 << PAGE_BITS) - 1)]; };
+    void set_entry(BankRIT& bank, int src_row, int dst_row);
+    void erase_entry(BankRIT& bank, int row);
 };
 
 }   // namespace Ramulator
\ No newline at end of file
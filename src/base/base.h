@@ -21,6 +21,9 @@
 #include "base/request.h"
 #include "base/utils.h"
 #include "base/stats.h"
+#include "base/profile.h"
+#include "base/context.h"
+#include "base/serialization.h"
 
 
 #ifndef uint
@@ -62,6 +65,13 @@ class Implementation {
     Stats m_stats;            // All statistics of the implementation are held here.
     Logger_t m_logger;        // Pointer to an pdlog logger.
 
+    std::shared_ptr<const SimulationContext> m_context = SimulationContext::current();  // The simulation I belong to
+
+#ifdef RAMULATOR_PROFILE
+  public:
+    Profile::Counter m_profile;   // The hot-path calls into me timed by RAMULATOR_PROFILE_CALL
+#endif
+
 
   public:
     Implementation(const YAML::Node& config, std::string ifce_name, std::string name, std::string desc, Implementation* parent):
@@ -152,6 +162,8 @@ class Implementation {
     _ParamChainer<T> param(const char* param_name) { return param<T>(std::string(param_name)); };
 
     _ParamGroupChainer param_group(std::string group_name) { return m_params._group(group_name); };
+    // Whether the config has the group, for the optional groups whose params all have defaults
+    bool has_param_group(const std::string& group_name) const { return bool(m_config[group_name]); };
   
     template <typename T>
     StatWrapper<T>& register_stat(T& val) { StatWrapper<T>* s = new StatWrapper<T>(val, *this, m_stats); return *s; };
@@ -178,6 +190,15 @@ class Implementation {
 
         // Print all my stats
         emitter << m_stats;
+#ifdef RAMULATOR_PROFILE
+        // Print the profiled time spent in me
+        if (uint64_t calls = m_profile.calls.load(); calls != 0) {
+          uint64_t tsc_cycles = m_profile.tsc_cycles.load();
+          emitter << YAML::Key << "profile_calls" << YAML::Value << calls;
+          emitter << YAML::Key << "profile_tsc_cycles" << YAML::Value << tsc_cycles;
+          emitter << YAML::Key << "profile_avg_tsc_cycles" << YAML::Value << double(tsc_cycles) / calls;
+        }
+#endif
         // Print all my children
         for (auto child_impl : m_children) {
           if (child_impl->has_stats()) {
@@ -191,9 +212,95 @@ class Implementation {
       emitter << YAML::Newline;
     };
 
+    /**
+     * @brief    Recursively add the stats of myself and all my childs to a stats stream (or a ConvergenceMonitor)
+     * 
+     */
+    template <class StreamT>
+    void stream_stats_to(StreamT& stream, const std::string& prefix = "") {
+      std::string path = prefix + get_ifce_name();
+      if (get_id() != "_default_id") {
+        path += "[" + get_id() + "]";
+      }
+      stream.add(path, m_stats);
+      for (auto child_impl : m_children) {
+        child_impl->stream_stats_to(stream, path + ".");
+      }
+    };
+
+    const SimulationContext& get_context() const { return *m_context; };
+
+    /**
+     * @brief    My path in the component tree, named as in the checkpoints (e.g.,
+     *           "MemorySystem.Controller[Channel 0].ControllerPlugin:PARA").
+     * 
+     */
+    std::string get_path() const {
+      std::string path = ":" + get_name();
+      for (const Implementation* impl = this; impl; impl = impl->m_parent) {
+        std::string node = impl->get_ifce_name();
+        if (impl->get_id() != "_default_id") {
+          node += "[" + impl->get_id() + "]";
+        }
+        path = (impl->m_parent ? "." : "") + node + path;
+      }
+      return path;
+    };
+
+    /**
+     * @brief    A stream of the simulation's random number generator keyed by my path, the given seed (e.g., my
+     *           configured one) and stream id. My path is final once my parents have named me (e.g., a memory system
+     *           names its controllers by channel), so the components of a memory system create their streams at setup().
+     * 
+     */
+    RandomStream random_stream(uint64_t seed, uint64_t stream = 0) const {
+      return m_context->random_stream(get_path(), seed, stream);
+    };
+
+    /**
+     * @brief    The bytes of memory I own in my major data structures (not my childs'), for the MemoryReport. 0 if I do
+     *           not report my footprint.
+     * 
+     */
+    virtual size_t memory_footprint() const { return 0; };
+
+    /**
+     * @brief    Recursively add myself and all my childs to a MemoryReport, named "<path>:<implementation>"
+     * 
+     */
+    template <class ReportT>
+    void report_memory_to(ReportT& report, const std::string& prefix = "") {
+      std::string path = prefix + get_ifce_name();
+      if (get_id() != "_default_id") {
+        path += "[" + get_id() + "]";
+      }
+      report.add(path + ":" + get_name(), this);
+      for (auto child_impl : m_children) {
+        child_impl->report_memory_to(report, path + ".");
+      }
+    };
+
+    /**
+     * @brief    Recursively collect myself and all my childs that keep state in checkpoints, with their section names
+     * 
+     */
+    void collect_checkpointables(std::vector<std::pair<std::string, Checkpointable*>>& components, const std::string& prefix = "") {
+      std::string path = prefix + get_ifce_name();
+      if (get_id() != "_default_id") {
+        path += "[" + get_id() + "]";
+      }
+      if (auto component = dynamic_cast<Checkpointable*>(this)) {
+        components.emplace_back(path + ":" + get_name(), component);
+      }
+      for (auto child_impl : m_children) {
+        child_impl->collect_checkpointables(components, path + ".");
+      }
+    };
+
     std::string get_id() const { return m_id; };
     void set_id(std::string id) { m_id = id; };
 
+    Implementation* get_parent() const { return m_parent; };
     void set_parent(Implementation* parent) { m_parent = parent; };
     void add_child(Implementation* child) { m_children.push_back(child); };
 
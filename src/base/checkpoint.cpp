@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <filesystem>
+
+#include "base/base.h"
+#include "base/checkpoint.h"
+
+namespace Ramulator {
+
+namespace Checkpoint {
+
+namespace {
+
+constexpr char MAGIC[4] = {'R', 'C', 'K', 'P'};
+
+using Sections_t = std::map<std::string, std::string>;   // path -> state
+
+std::vector<std::pair<std::string, Checkpointable*>> collect(const std::vector<Implementation*>& roots) {
+  std::vector<std::pair<std::string, Checkpointable*>> components;
+  for (Implementation* root : roots) {
+    root->collect_checkpointables(components);
+  }
+  return components;
+}
+
+Sections_t read_file(const std::string& path) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file) {
+    throw ConfigurationError("Checkpoint {} cannot be opened!", path);
+  }
+
+  char magic[4];
+  if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + 4, MAGIC)) {
+    throw ConfigurationError("{} is not a checkpoint!", path);
+  }
+  if (uint32_t version = read<uint32_t>(file); version != VERSION) {
+    throw ConfigurationError("Checkpoint {} has format version {}, but version {} is supported!", path, version, VERSION);
+  }
+
+  Sections_t sections;
+  uint32_t num_sections = read<uint32_t>(file);
+  for (uint32_t i = 0; i < num_sections; i++) {
+    std::vector<char> name = read_vector<char>(file);
+    std::vector<char> state = read_vector<char>(file);
+    sections.emplace(std::string(name.begin(), name.end()), std::string(state.begin(), state.end()));
+  }
+  return sections;
+}
+
+/**
+ * @brief    Returns the sections of the checkpoint at path, read once per process (like the traces in TraceCache).
+ *
+ */
+std::shared_ptr<const Sections_t> load_shared(const std::string& path) {
+  static std::mutex mutex;
+  static std::map<std::string, std::shared_ptr<const Sections_t>> checkpoints;
+
+  std::error_code ec;
+  std::string key = std::filesystem::weakly_canonical(path, ec).string();
+  if (ec) {
+    key = path;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (auto it = checkpoints.find(key); it != checkpoints.end()) {
+    return it->second;
+  }
+  auto sections = std::make_shared<const Sections_t>(read_file(path));
+  checkpoints[key] = sections;
+  return sections;
+}
+
+}        // namespace
+
+
+Options Options::from_config(const YAML::Node& config) {
+  Options options;
+  if (!config) {
+    return options;
+  }
+  options.save_path = config["save"].as<std::string>("");
+  options.save_at_clk = config["save_at_clk"].as<int64_t>(-1);
+  options.restore_path = config["restore"].as<std::string>("");
+  if (options.save_at_clk != -1 && options.save_path.empty()) {
+    throw ConfigurationError("Checkpoint save_at_clk is given without a save path!");
+  }
+  return options;
+}
+
+
+void save(const std::string& path, const std::vector<Implementation*>& roots) {
+  Sections_t sections;
+  for (const auto& [name, component] : collect(roots)) {
+    std::ostringstream state(std::ios::out | std::ios::binary);
+    component->save_checkpoint(state);
+    if (!sections.emplace(name, state.str()).second) {
+      throw ConfigurationError("Two components have the same checkpoint section {}!", name);
+    }
+  }
+
+  std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file) {
+    throw ConfigurationError("Checkpoint {} cannot be opened for writing!", path);
+  }
+  file.write(MAGIC, sizeof(MAGIC));
+  write<uint32_t>(file, VERSION);
+  write<uint32_t>(file, sections.size());
+  for (const auto& [name, state] : sections) {
+    write(file, std::vector<char>(name.begin(), name.end()));
+    write(file, std::vector<char>(state.begin(), state.end()));
+  }
+  if (!file) {
+    throw ConfigurationError("Failed to write checkpoint {}!", path);
+  }
+  spdlog::info("Saved {} components to checkpoint {}.", sections.size(), path);
+}
+
+
+void restore(const std::string& path, const std::vector<Implementation*>& roots) {
+  std::shared_ptr<const Sections_t> sections = load_shared(path);
+
+  size_t num_restored = 0;
+  for (const auto& [name, component] : collect(roots)) {
+    auto it = sections->find(name);
+    if (it == sections->end()) {
+      spdlog::warn("Checkpoint {} has no state for {}, it starts cold.", path, name);
+      continue;
+    }
+    std::istringstream state(it->second, std::ios::in | std::ios::binary);
+    try {
+      component->load_checkpoint(state);
+    } catch (const ConfigurationError& e) {
+      throw ConfigurationError("Cannot restore {} from checkpoint {}: {}", name, path, e.what());
+    }
+    num_restored++;
+  }
+  spdlog::info("Restored {} components from checkpoint {}.", num_restored, path);
+}
+
+}        // namespace Checkpoint
+
+}        // namespace Ramulator
@@ -0,0 +1,105 @@
+#ifndef     RAMULATOR_BASE_CHECKPOINT_H
+#define     RAMULATOR_BASE_CHECKPOINT_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include <type_traits>
+
+#include <yaml-cpp/yaml.h>
+
+#include "base/exception.h"
+#include "base/serialization.h"
+
+namespace Ramulator {
+
+class Implementation;
+
+/**
+ * @brief    Versioned binary checkpoints of the state of all Checkpointable components
+ * @details
+ * A checkpoint file starts with "RCKP", the format version (uint32_t) and the number of sections (uint32_t). Each
+ * section is the path of its component (as in the statistics, followed by ":<implementation>"), then the length
+ * (uint64_t) and the bytes written by the component's save_checkpoint(). A component restores from the section with
+ * its path, so a checkpoint can seed any configuration with the same components, e.g., all the points of a sweep.
+ * A component without a section in the checkpoint starts cold.
+ *
+ */
+namespace Checkpoint {
+
+inline constexpr uint32_t VERSION = 3;
+
+/**
+ * @brief    The checkpoint options of a simulation (read from the optional top-level "Checkpoint" section).
+ *
+ */
+struct Options {
+  std::string save_path = "";       // Where to save the checkpoint, if not empty
+  int64_t save_at_clk = -1;         // The memory system cycle to save (and stop) at, or -1 for the end of the simulation
+  std::string restore_path = "";    // Which checkpoint to start from, if not empty
+
+  static Options from_config(const YAML::Node& config);
+};
+
+void save(const std::string& path, const std::vector<Implementation*>& roots);
+
+/**
+ * @brief    Restores the components from a checkpoint. The file is read once per process and shared by the
+ *           simulations that restore from it.
+ *
+ */
+void restore(const std::string& path, const std::vector<Implementation*>& roots);
+
+
+template<typename T>
+requires std::is_trivially_copyable_v<T>
+void write(std::ostream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+requires std::is_trivially_copyable_v<T>
+void write(std::ostream& out, const std::vector<T>& values) {
+  write<uint64_t>(out, values.size());
+  out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+template<typename T>
+requires std::is_trivially_copyable_v<T>
+T read(std::istream& in) {
+  T value;
+  if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+    throw ConfigurationError("Checkpoint section is truncated!");
+  }
+  return value;
+}
+
+template<typename T>
+requires std::is_trivially_copyable_v<T>
+std::vector<T> read_vector(std::istream& in) {
+  std::vector<T> values(read<uint64_t>(in));
+  if (!in.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(T))) {
+    throw ConfigurationError("Checkpoint section is truncated!");
+  }
+  return values;
+}
+
+/**
+ * @brief    Reads a value saved for validation and throws if it differs from the expected one.
+ *
+ */
+template<typename T>
+void expect(std::istream& in, const T& expected, const std::string& what) {
+  if (read<T>(in) != expected) {
+    throw ConfigurationError("Checkpoint was saved with a different {}!", what);
+  }
+}
+
+}        // namespace Checkpoint
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_BASE_CHECKPOINT_H
@@ -3,8 +3,11 @@
 
 #include <vector>
 #include <string>
+#include <numeric>
+#include <utility>
 
 #include "base/type.h"
+#include "base/exception.h"
 
 namespace Ramulator {
 
@@ -27,6 +30,73 @@ class Clocked {
     Clocked() {};
 };
 
+/**
+ * @brief    The repeating pattern in which clock domains with different clock ratios tick
+ * @details
+ * A domain with clock ratio r ticks once every (P / r) steps of the base clock, where P is the least common multiple
+ * of all ratios, so the pattern repeats every P steps. The steps in which no domain ticks are dropped, and in a step
+ * the domains tick in the order they were given. The pattern is computed once, so running it needs no divisions.
+ * 
+ */
+class ClockSchedule {
+  private:
+    std::vector<uint32_t> m_steps;  // The bitmask of the domains that tick in each step
+    size_t m_num_domains = 0;
+
+    template<size_t... I, typename... TickFuncs>
+    static bool tick_step(uint32_t step, std::index_sequence<I...>, TickFuncs&... ticks) {
+      // Stops at the first domain that asks to stop
+      return ((((step >> I) & 1) && ticks()) || ...);
+    };
+
+  public:
+    explicit ClockSchedule(const std::vector<int>& ratios): m_num_domains(ratios.size()) {
+      if (ratios.empty() || ratios.size() > 32) {
+        throw ConfigurationError("A clock schedule needs between 1 and 32 clock domains (got {})!", ratios.size());
+      }
+      uint64_t period = 1;
+      for (int ratio : ratios) {
+        if (ratio <= 0) {
+          throw ConfigurationError("Clock ratio {} is not positive!", ratio);
+        }
+        period = std::lcm(period, (uint64_t) ratio);
+      }
+      for (uint64_t i = 0; i < period; i++) {
+        uint32_t step = 0;
+        for (size_t d = 0; d < ratios.size(); d++) {
+          if (i % (period / ratios[d]) == 0) {
+            step |= 1u << d;
+          }
+        }
+        if (step != 0) {
+          m_steps.push_back(step);
+        }
+      }
+    };
+
+    const std::vector<uint32_t>& get_steps() const { return m_steps; };
+
+    /**
+     * @brief    Ticks the domains in the pattern until one of them asks to stop.
+     * @details
+     * Takes one callable per domain, in the order of the ratios, that ticks the domain and returns whether to stop.
+     * 
+     */
+    template<typename... TickFuncs>
+    void run(TickFuncs&&... ticks) {
+      if (sizeof...(ticks) != m_num_domains) {
+        throw InitializationError("The clock schedule has {} domains but got {} tick functions!", m_num_domains, sizeof...(ticks));
+      }
+      while (true) {
+        for (uint32_t step : m_steps) {
+          if (tick_step(step, std::index_sequence_for<TickFuncs...>{}, ticks...)) {
+            return;
+          }
+        }
+      }
+    };
+};
+
 }        // namespace Ramulator
 
 
@@ -20,6 +20,39 @@ YAML::Node Config::parse_config_file(const std::string& path_str, const std::vec
   return node;
 }
 
+std::vector<std::vector<std::string>> Config::expand_sweep_grid(const YAML::Node& grid) {
+  if (!grid.IsMap()) {
+    throw ConfigurationError("The sweep grid must map parameter names to sequences of values!");
+  }
+
+  std::vector<std::vector<std::string>> points = {{}};
+  for (YAML::const_iterator it = grid.begin(); it != grid.end(); ++it) {
+    std::string name = it->first.as<std::string>();
+    std::vector<std::string> values;
+    if (it->second.IsSequence()) {
+      for (const auto& value : it->second) {
+        values.push_back(value.as<std::string>());
+      }
+    } else if (it->second.IsScalar()) {
+      values.push_back(it->second.as<std::string>());
+    }
+    if (values.empty()) {
+      throw ConfigurationError("Sweep parameter {} has no values!", name);
+    }
+
+    std::vector<std::vector<std::string>> next_points;
+    next_points.reserve(points.size() * values.size());
+    for (const auto& point : points) {
+      for (const auto& value : values) {
+        next_points.push_back(point);
+        next_points.back().push_back(name + "=" + value);
+      }
+    }
+    points = std::move(next_points);
+  }
+  return points;
+}
+
 YAML::Node Config::Details::load_config_file(const std::string& path_str) {
   fs::path path(path_str);
   if (!fs::exists(path)) {
@@ -22,6 +22,14 @@ namespace Config {
  */
 YAML::Node parse_config_file(const std::string& path, const std::vector<std::string>& params);
 
+/**
+ * @brief    Expand a sweep grid into the parameter overrides of all its configurations.
+ *
+ * @param    grid           A map from parameter names (as in the command line overrides) to sequences of values.
+ * @return   The "name=value" overrides of every configuration in the cartesian product, the last parameter varying fastest.
+ */
+std::vector<std::vector<std::string>> expand_sweep_grid(const YAML::Node& grid);
+
 
 namespace Details {
 
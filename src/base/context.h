@@ -0,0 +1,82 @@
+#ifndef     RAMULATOR_BASE_CONTEXT_H
+#define     RAMULATOR_BASE_CONTEXT_H
+
+#include <string>
+#include <memory>
+#include <cstdint>
+
+#include <yaml-cpp/yaml.h>
+
+#include "base/random.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    The state of one simulation that is not part of its components, so several simulations can be built and
+ *           run concurrently in one process.
+ * @details
+ * Read from the optional top-level "Simulation" section of the configuration. Every component holds the context of
+ * the simulation it was created in. The context is made current for the calling thread while the Factory builds the
+ * component trees of a simulation, so components pick it up without it being passed through every constructor.
+ *
+ */
+struct SimulationContext {
+  std::string name = "";    // Tags the loggers of the simulation. Empty for a standalone simulation
+  uint64_t seed = 0;        // Keys every stream of the random number generator, with the configured seeds
+
+  /**
+   * @brief    The stream of the simulator-wide counter-based RNG keyed by the simulation seed, a component (its path),
+   *           the component's configured seed and a stream id, so no two components or streams share numbers.
+   *
+   */
+  RandomStream random_stream(std::string_view component, uint64_t component_seed, uint64_t stream = 0) const {
+    uint64_t key = mix64(mix64(seed + 0x9E3779B97F4A7C15ull) ^ fnv1a(component));
+    return RandomStream(mix64(key ^ mix64(component_seed)), stream);
+  };
+
+  static std::shared_ptr<const SimulationContext> from_config(const YAML::Node& config) {
+    auto context = std::make_shared<SimulationContext>();
+    if (config) {
+      context->name = config["name"].as<std::string>("");
+      context->seed = config["seed"].as<uint64_t>(0);
+    }
+    return context;
+  };
+
+  /**
+   * @brief    The context of the simulation being built on this thread (the default context outside of a Scope).
+   *
+   */
+  static const std::shared_ptr<const SimulationContext>& current() {
+    return current_ref();
+  };
+
+  /**
+   * @brief    Makes a context current for the calling thread during its lifetime.
+   *
+   */
+  class Scope {
+    private:
+      std::shared_ptr<const SimulationContext> m_prev;
+
+    public:
+      explicit Scope(std::shared_ptr<const SimulationContext> context): m_prev(std::move(current_ref())) {
+        current_ref() = std::move(context);
+      };
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+      ~Scope() { current_ref() = std::move(m_prev); };
+  };
+
+  private:
+    static std::shared_ptr<const SimulationContext>& current_ref() {
+      static const std::shared_ptr<const SimulationContext> default_context = std::make_shared<SimulationContext>();
+      thread_local std::shared_ptr<const SimulationContext> context = default_context;
+      return context;
+    };
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_BASE_CONTEXT_H
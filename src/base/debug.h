@@ -4,8 +4,12 @@
 #include <vector>
 #include <string>
 #include <type_traits>
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
 
 #include "base/logging.h"
+#include "base/exception.h"
 
 namespace Ramulator {
 
@@ -37,6 +41,65 @@ inline constexpr bool is_debug_enabled = std::false_type::value;
 #define ENABLE_DEBUG_FLAG(flagT)
 #define DEBUG_LOG(flagT, logger, msg, ...)
 #endif
+
+
+/**
+ * @brief       Categories of the runtime debug traces (e.g., the "debug" parameters of the plugins)
+ * 
+ */
+enum class Category : uint32_t {
+  Power       = 1u << 0,    // The DRAM power model
+  Plugin      = 1u << 1,    // The controller plugins
+  Controller  = 1u << 2,
+  Scheduler   = 1u << 3,
+  Frontend    = 1u << 4,
+};
+
+/**
+ * @brief       Whether the traces are compiled in. Only Debug builds (or builds with RAMULATOR_TRACE) have them, so in
+ *              Release builds a trace and the checks guarding it cost nothing.
+ * 
+ */
+#if defined(RAMULATOR_DEBUG) || defined(RAMULATOR_TRACE)
+inline constexpr bool trace_compiled = true;
+#else
+inline constexpr bool trace_compiled = false;
+#endif
+
+inline std::atomic<uint32_t> trace_mask = ~0u;   // The categories traced at runtime (all by default)
+
+inline bool trace_enabled(Category category) {
+  return trace_mask.load(std::memory_order_relaxed) & static_cast<uint32_t>(category);
+}
+
+/**
+ * @brief       Traces only the given categories (by name, e.g., "power", "plugin").
+ * 
+ */
+inline void set_trace_categories(const std::vector<std::string>& names) {
+  static const std::vector<std::pair<std::string, Category>> categories = {
+    {"power", Category::Power}, {"plugin", Category::Plugin}, {"controller", Category::Controller},
+    {"scheduler", Category::Scheduler}, {"frontend", Category::Frontend},
+  };
+  uint32_t mask = 0;
+  for (const auto& name : names) {
+    auto it = std::find_if(categories.begin(), categories.end(), [&name](const auto& c) { return c.first == name; });
+    if (it == categories.end()) {
+      throw ConfigurationError("Unknown trace category {}!", name);
+    }
+    mask |= static_cast<uint32_t>(it->second);
+  }
+  trace_mask.store(mask, std::memory_order_relaxed);
+}
+
+/**
+ * @brief       Guards the statement that follows (usually a block printing a trace) by the category mask and cond.
+ *              The statement is discarded at compile time in Release builds.
+ * 
+ */
+#define RAMULATOR_TRACE_IF(category, cond) \
+  if constexpr (::Ramulator::Debug::trace_compiled) \
+    if (::Ramulator::Debug::trace_enabled(::Ramulator::Debug::Category::category) && (cond))
 }        // namespace Debug
 
 }        // namespace Ramulator
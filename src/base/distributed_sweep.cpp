@@ -0,0 +1,493 @@
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <spdlog/spdlog.h>
+
+#include "base/random.h"
+#include "base/distributed_sweep.h"
+
+namespace Ramulator {
+
+namespace DistributedSweep {
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;    // A worker that went away must not kill the coordinator with SIGPIPE
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief    A TCP connection that exchanges lines and byte strings. Reads give up when the peer closes, or when stop is
+ *           set while they wait (with a receive timeout).
+ *
+ */
+class Connection {
+  private:
+    int m_fd = -1;
+    std::string m_buffer;
+    const std::atomic<bool>* m_stop = nullptr;
+
+  public:
+    Connection(int fd, const std::atomic<bool>* stop = nullptr): m_fd(fd), m_stop(stop) {
+      int one = 1;
+      setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      if (m_stop) {
+        timeval timeout = {1, 0};
+        setsockopt(m_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+      }
+    };
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+    ~Connection() { close(m_fd); };
+
+    bool send_all(const std::string& data) {
+      size_t sent = 0;
+      while (sent < data.size()) {
+        ssize_t n = send(m_fd, data.data() + sent, data.size() - sent, SEND_FLAGS);
+        if (n < 0 && errno == EINTR) {
+          continue;
+        }
+        if (n <= 0) {
+          return false;
+        }
+        sent += n;
+      }
+      return true;
+    };
+
+    bool read_line(std::string& line) {
+      size_t end;
+      while ((end = m_buffer.find('\n')) == std::string::npos) {
+        if (!fill()) {
+          return false;
+        }
+      }
+      line = m_buffer.substr(0, end);
+      m_buffer.erase(0, end + 1);
+      return true;
+    };
+
+    bool read_bytes(size_t size, std::string& bytes) {
+      while (m_buffer.size() < size) {
+        if (!fill()) {
+          return false;
+        }
+      }
+      bytes = m_buffer.substr(0, size);
+      m_buffer.erase(0, size);
+      return true;
+    };
+
+  private:
+    bool fill() {
+      char chunk[65536];
+      while (true) {
+        ssize_t n = recv(m_fd, chunk, sizeof(chunk), 0);
+        if (n > 0) {
+          m_buffer.append(chunk, n);
+          return true;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+          if (m_stop && m_stop->load()) {
+            return false;
+          }
+          continue;
+        }
+        return false;
+      }
+    };
+};
+
+/**
+ * @brief    The points of the sweep and who holds them.
+ *
+ */
+class PointQueue {
+  private:
+    enum class State { Pending, Leased, Done };
+    struct Point {
+      State state = State::Pending;
+      Clock::time_point leased_at;
+    };
+
+    std::mutex m_mutex;
+    std::vector<Point> m_points;
+    std::deque<size_t> m_pending;
+    size_t m_num_done = 0;
+    size_t m_num_failed = 0;
+    double m_lease_timeout;
+
+  public:
+    PointQueue(size_t num_points, const std::set<size_t>& done, double lease_timeout):
+    m_points(num_points), m_lease_timeout(lease_timeout) {
+      for (size_t i = 0; i < num_points; i++) {
+        if (done.contains(i)) {
+          m_points[i].state = State::Done;
+          m_num_done++;
+        } else {
+          m_pending.push_back(i);
+        }
+      }
+    };
+
+    /**
+     * @brief    Leases the next pending point (or one whose lease timed out). Returns false if there is none.
+     *
+     */
+    bool lease(size_t& point) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      while (!m_pending.empty()) {
+        point = m_pending.front();
+        m_pending.pop_front();
+        // A point that was released twice is in the queue twice
+        if (m_points[point].state == State::Pending) {
+          m_points[point] = {State::Leased, Clock::now()};
+          return true;
+        }
+      }
+      if (m_lease_timeout > 0.0) {
+        auto now = Clock::now();
+        for (point = 0; point < m_points.size(); point++) {
+          if (m_points[point].state == State::Leased && std::chrono::duration<double>(now - m_points[point].leased_at).count() > m_lease_timeout) {
+            spdlog::warn("The lease of sweep point {} timed out, giving it to another worker.", point);
+            m_points[point].leased_at = now;
+            return true;
+          }
+        }
+      }
+      return false;
+    };
+
+    /// Puts a point whose worker went away back into the queue
+    void release(size_t point) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_points[point].state == State::Leased) {
+        m_points[point].state = State::Pending;
+        m_pending.push_front(point);
+      }
+    };
+
+    /// Records the result of a point, if it is the first. Returns whether it was.
+    bool complete(size_t point, const PointResult& result, const ResultHandler& on_result) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_points[point].state == State::Done) {
+        return false;
+      }
+      m_points[point].state = State::Done;
+      m_num_done++;
+      m_num_failed += !result.error.empty();
+      on_result(point, result);
+      spdlog::info("Sweep point {} done ({}/{}).", point, m_num_done, m_points.size());
+      return true;
+    };
+
+    size_t size() const { return m_points.size(); };
+
+    bool finished() {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return m_num_done == m_points.size();
+    };
+
+    size_t num_failed() {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return m_num_failed;
+    };
+};
+
+/**
+ * @brief    Talks to one worker thread until it disconnects or the sweep is finished.
+ *
+ */
+void serve(int fd, PointQueue& queue, uint64_t fingerprint, const ResultHandler& on_result, const std::atomic<bool>& stop) {
+  Connection connection(fd, &stop);
+  std::string line;
+  if (!connection.read_line(line)) {
+    return;
+  }
+  if (line != fmt::format("HELLO {:016x}", fingerprint)) {
+    spdlog::error("Rejected a sweep worker with another configuration or grid ({}).", line);
+    connection.send_all(fmt::format("ERROR the coordinator sweeps configuration {:016x}\n", fingerprint));
+    return;
+  }
+  connection.send_all("OK\n");
+
+  std::set<size_t> held;
+  while (connection.read_line(line)) {
+    std::istringstream request(line);
+    std::string command;
+    request >> command;
+    if (command == "NEXT") {
+      size_t point;
+      std::string reply;
+      if (queue.lease(point)) {
+        held.insert(point);
+        reply = fmt::format("POINT {}\n", point);
+      } else if (queue.finished()) {
+        reply = "DONE\n";
+      } else {
+        reply = "WAIT 2\n";
+      }
+      if (!connection.send_all(reply)) {
+        break;
+      }
+    } else if (command == "RESULT") {
+      size_t point, stats_size, error_size, row_size;
+      request >> point >> stats_size >> error_size >> row_size;
+      PointResult result;
+      if (!request || point >= queue.size() || !connection.read_bytes(stats_size, result.stats) || !connection.read_bytes(error_size, result.error) || !connection.read_bytes(row_size, result.table_row)) {
+        break;
+      }
+      held.erase(point);
+      queue.complete(point, result, on_result);
+      if (!connection.send_all("OK\n")) {
+        break;
+      }
+    } else {
+      spdlog::error("Unknown request \"{}\" from a sweep worker!", line);
+      break;
+    }
+  }
+  for (size_t point : held) {
+    queue.release(point);
+  }
+}
+
+int connect_to(const std::string& host, int port) {
+  addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* addresses = nullptr;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+    return -1;
+  }
+  int fd = -1;
+  for (addrinfo* address = addresses; address; address = address->ai_next) {
+    fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (fd < 0) {
+      continue;
+    }
+    if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+      break;
+    }
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(addresses);
+  return fd;
+}
+
+}        // namespace
+
+
+Options Options::from_config(const YAML::Node& config) {
+  Options options;
+  if (!config) {
+    return options;
+  }
+  options.enabled = true;
+  options.port = config["port"].as<int>(options.port);
+  options.lease_timeout = config["lease_timeout"].as<double>(options.lease_timeout);
+  options.connect_timeout = config["connect_timeout"].as<double>(options.connect_timeout);
+  options.resume = config["resume"].as<bool>(options.resume);
+  if (options.port <= 0 || options.port > 65535) {
+    throw ConfigurationError("Invalid distributed sweep port {}!", options.port);
+  }
+  return options;
+}
+
+uint64_t fingerprint(const YAML::Node& base_config, const std::vector<std::vector<std::string>>& points) {
+  std::string text = YAML::Dump(base_config);
+  for (const auto& point : points) {
+    text += "\n---";
+    for (const auto& param : point) {
+      text += "\n" + param;
+    }
+  }
+  return fnv1a(text);
+}
+
+std::set<size_t> completed_points(const std::string& output_path) {
+  std::set<size_t> done;
+  std::ifstream output(output_path, std::ios::binary);
+  if (!output) {
+    return done;
+  }
+
+  // A document is complete once its end marker "..." is written. An incomplete last one is cut off
+  std::string line;
+  size_t point = 0;
+  bool has_point = false;
+  bool failed = false;
+  std::streamoff complete_end = 0;
+  while (std::getline(output, line)) {
+    if (line == "---") {
+      has_point = false;
+      failed = false;
+    } else if (line.starts_with("sweep_point: ")) {
+      point = std::stoull(line.substr(13));
+      has_point = true;
+    } else if (line.starts_with("sweep_error: ")) {
+      failed = true;
+    } else if (line == "...") {
+      if (has_point && !failed) {
+        done.insert(point);
+      }
+      complete_end = output.tellg();
+    }
+  }
+  output.close();
+  if (complete_end < (std::streamoff) std::filesystem::file_size(output_path)) {
+    spdlog::warn("Cutting off the incomplete last document of sweep output {}.", output_path);
+    std::filesystem::resize_file(output_path, complete_end);
+  }
+  return done;
+}
+
+size_t coordinate(const Options& options, size_t num_points, const std::set<size_t>& done, uint64_t fingerprint, const ResultHandler& on_result) {
+  PointQueue queue(num_points, done, options.lease_timeout);
+  if (queue.finished()) {
+    spdlog::info("All {} sweep points are done.", num_points);
+    return 0;
+  }
+
+  int listener = socket(AF_INET6, SOCK_STREAM, 0);
+  bool is_ipv6 = listener >= 0;
+  if (!is_ipv6) {
+    listener = socket(AF_INET, SOCK_STREAM, 0);
+  }
+  int one = 1;
+  int zero = 0;
+  setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  int bound;
+  if (is_ipv6) {
+    // Accept IPv4 workers too
+    setsockopt(listener, IPPROTO_IPV6, IPV6_V6ONLY, &zero, sizeof(zero));
+    sockaddr_in6 address = {};
+    address.sin6_family = AF_INET6;
+    address.sin6_addr = in6addr_any;
+    address.sin6_port = htons(options.port);
+    bound = bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+  } else {
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(options.port);
+    bound = bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+  }
+  if (listener < 0 || bound != 0 || listen(listener, 128) != 0) {
+    close(listener);
+    throw ConfigurationError("Cannot listen for sweep workers on port {}!", options.port);
+  }
+  spdlog::info("Coordinating {} sweep points ({} done) on port {}.", num_points, done.size(), options.port);
+
+  std::atomic<bool> stop = false;
+  std::vector<std::thread> handlers;
+  while (!queue.finished()) {
+    pollfd listening = {listener, POLLIN, 0};
+    if (poll(&listening, 1, 1000) <= 0) {
+      continue;
+    }
+    int fd = accept(listener, nullptr, nullptr);
+    if (fd >= 0) {
+      handlers.emplace_back(serve, fd, std::ref(queue), fingerprint, std::cref(on_result), std::cref(stop));
+    }
+  }
+  close(listener);
+  // Let the waiting workers (WAIT 2) ask for their next point and hear that the sweep is done
+  std::this_thread::sleep_for(std::chrono::seconds(3));
+  stop = true;
+  for (auto& handler : handlers) {
+    handler.join();
+  }
+  return queue.num_failed();
+}
+
+size_t work(const Options& options, const std::string& host, size_t num_threads, uint64_t fingerprint, const PointRunner& run_point) {
+  std::atomic<size_t> num_failed = 0;
+  std::mutex error_mutex;
+  std::exception_ptr error = nullptr;
+
+  auto worker = [&] {
+    try {
+      int fd = -1;
+      auto deadline = Clock::now() + std::chrono::duration<double>(options.connect_timeout);
+      while ((fd = connect_to(host, options.port)) < 0) {
+        if (Clock::now() >= deadline) {
+          throw ConfigurationError("Cannot connect to the sweep coordinator {}:{}!", host, options.port);
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+      }
+      Connection connection(fd);
+      std::string line;
+      if (!connection.send_all(fmt::format("HELLO {:016x}\n", fingerprint)) || !connection.read_line(line)) {
+        throw ConfigurationError("The sweep coordinator {}:{} closed the connection!", host, options.port);
+      }
+      if (line != "OK") {
+        throw ConfigurationError("The sweep coordinator {}:{} refused this worker: {}", host, options.port, line);
+      }
+
+      while (connection.send_all("NEXT\n") && connection.read_line(line)) {
+        std::istringstream reply(line);
+        std::string command;
+        size_t value = 0;
+        reply >> command >> value;
+        if (command == "DONE") {
+          return;
+        } else if (command == "WAIT") {
+          std::this_thread::sleep_for(std::chrono::seconds(value));
+        } else if (command == "POINT") {
+          PointResult result = run_point(value);
+          num_failed += !result.error.empty();
+          std::string message = fmt::format("RESULT {} {} {} {}\n", value, result.stats.size(), result.error.size(), result.table_row.size());
+          if (!connection.send_all(message + result.stats + result.error + result.table_row) || !connection.read_line(line)) {
+            break;
+          }
+        } else {
+          throw ConfigurationError("Unknown reply \"{}\" from the sweep coordinator!", line);
+        }
+      }
+      // The coordinator is gone: the points of this worker that it did not get are given to others when it restarts
+      spdlog::warn("Lost the connection to the sweep coordinator {}:{}.", host, options.port);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  };
+
+  spdlog::info("Working for the sweep coordinator {}:{} on {} threads.", host, options.port, num_threads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back(worker);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return num_failed;
+}
+
+}        // namespace DistributedSweep
+
+}        // namespace Ramulator
@@ -0,0 +1,95 @@
+#ifndef     RAMULATOR_BASE_DISTRIBUTED_SWEEP_H
+#define     RAMULATOR_BASE_DISTRIBUTED_SWEEP_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <functional>
+#include <cstdint>
+
+#include <yaml-cpp/yaml.h>
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Splits the points of a sweep across the worker processes of many nodes through a TCP work queue
+ * @details
+ * The coordinator (ramulator2 -s with a "distributed" section in the sweep file) holds the queue of the points and
+ * writes every result, so the output and the stats table of the whole sweep are written by one process. A worker
+ * (ramulator2 -s ... --sweep_worker <coordinator host>) opens one connection per thread, and every thread asks for a
+ * point, simulates it and sends its result back, until the queue is empty. Workers expand the grid themselves from the
+ * same (read-only, shared) configuration and sweep files, and are only let in if they compute the same fingerprint.
+ *
+ * The protocol is line based:
+ *   worker: "HELLO <fingerprint>"           coordinator: "OK" or "ERROR <message>"
+ *   worker: "NEXT"                          coordinator: "POINT <i>", "WAIT <seconds>" or "DONE"
+ *   worker: "RESULT <i> <n_stats> <n_error> <n_row>" and the three strings of that many bytes
+ *                                           coordinator: "OK"
+ *
+ * Restarts are idempotent. A point is leased to one worker thread at a time and goes back to the queue when its
+ * connection drops or its lease times out (then the first result of the point wins). Workers hold no state, so they
+ * can be restarted or added at any time, and a coordinator resumes from the points its output file already holds.
+ *
+ */
+namespace DistributedSweep {
+
+/**
+ * @brief    The options of the "distributed" section of a sweep file.
+ *
+ */
+struct Options {
+  bool enabled = false;
+  int port = 5555;                  // The coordinator listens on this port
+  double lease_timeout = 0.0;       // Seconds before a leased point is given to another worker (0 = never)
+  double connect_timeout = 60.0;    // Seconds a worker retries to connect, so it can start before the coordinator
+  bool resume = true;               // Skip the points the output file already holds
+
+  static Options from_config(const YAML::Node& config);
+};
+
+struct PointResult {
+  std::string stats;        // The YAML statistics
+  std::string error;        // Empty if the simulation succeeded
+  std::string table_row;    // The stats table row, if the configuration has a stats table
+};
+
+/// Called by the coordinator for each point the first time its result arrives, one call at a time
+using ResultHandler = std::function<void(size_t point, const PointResult& result)>;
+
+/// Simulates a point on a worker thread
+using PointRunner = std::function<PointResult(size_t point)>;
+
+/**
+ * @brief    A fingerprint of the base configuration and the points, that the workers must share with the coordinator.
+ *
+ */
+uint64_t fingerprint(const YAML::Node& base_config, const std::vector<std::vector<std::string>>& points);
+
+/**
+ * @brief    The points the sweep documents of an output file hold without an error.
+ *
+ */
+std::set<size_t> completed_points(const std::string& output_path);
+
+/**
+ * @brief    Serves the points that are not done yet to the workers until all of them are. Returns the number of points
+ *           whose result was an error.
+ *
+ */
+size_t coordinate(const Options& options, size_t num_points, const std::set<size_t>& done, uint64_t fingerprint, const ResultHandler& on_result);
+
+/**
+ * @brief    Runs num_threads workers of the coordinator at host until it has no more points. Returns the number of
+ *           points whose simulation failed.
+ *
+ */
+size_t work(const Options& options, const std::string& host, size_t num_threads, uint64_t fingerprint, const PointRunner& run_point);
+
+}        // namespace DistributedSweep
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_BASE_DISTRIBUTED_SWEEP_H
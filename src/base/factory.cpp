@@ -2,6 +2,7 @@
 #include <queue>
 
 #include "base/factory.h"
+#include "base/context.h"
 #include "frontend/frontend.h"
 #include "memory_system/memory_system.h"
 
@@ -10,6 +11,11 @@ namespace Ramulator {
 bool Factory::register_interface(std::string ifce_name, std::string ifce_desc) {
   DEBUG_LOG(DFACTORY, Logging::get("Base"), "Registering interface {}...", ifce_name)
 
+  std::lock_guard<std::mutex> lock(m_registry_mutex);
+  if (m_sealed) {
+    throw InitializationError("Interface class {} is registered after the registry is sealed!", ifce_name);
+  }
+
   if (auto it = m_registry.find(ifce_name); it == m_registry.end()) {
     m_registry[ifce_name] = {ifce_name, ifce_desc};
     return true;
@@ -23,7 +29,17 @@ bool Factory::register_interface(std::string ifce_name, std::string ifce_desc) {
 };
 
 
+void Factory::seal() {
+  if (!m_sealed.load(std::memory_order_acquire)) {
+    // Waits for a registration in progress
+    std::lock_guard<std::mutex> lock(m_registry_mutex);
+    m_sealed.store(true, std::memory_order_release);
+  }
+}
+
+
 bool Factory::query_interface(std::string ifce_name) {
+  seal();
   if (auto it = m_registry.find(ifce_name); it != m_registry.end()) {
     return true;
   } else {
@@ -35,6 +51,11 @@ bool Factory::query_interface(std::string ifce_name) {
 bool Factory::register_implementation(std::string ifce_name, std::string impl_name, std::string impl_desc, const Constructor_t& cstr) {
   DEBUG_LOG(DFACTORY, Logging::get("Base"), "Registering implementation {} to interface {}...", impl_name, ifce_name)
 
+  std::lock_guard<std::mutex> lock(m_registry_mutex);
+  if (m_sealed) {
+    throw InitializationError("Implementation {} of interface {} is registered after the registry is sealed!", impl_name, ifce_name);
+  }
+
   // First we search for the interface metadata.
   if (auto ifce_it = m_registry.find(ifce_name); ifce_it != m_registry.end()) {
     auto& [_ifce_name, ifce_info] = *ifce_it;
@@ -64,6 +85,7 @@ bool Factory::register_implementation(std::string ifce_name, std::string impl_na
 
 Implementation* Factory::create_implementation(std::string ifce_name, std::string impl_name, const YAML::Node& config, Implementation* parent) {
   DEBUG_LOG(DFACTORY, Logging::get("Base"), "Creating implementation {} of interface {}...", impl_name, ifce_name)
+  seal();
 
   if (const auto ifce_it = m_registry.find(ifce_name); ifce_it != m_registry.end()) {
     const auto& [_ifce_name, ifce_info] = *ifce_it;
@@ -90,6 +112,7 @@ Implementation* Factory::create_implementation(std::string ifce_name, std::strin
 
 Implementation* Factory::create_implementation(std::string ifce_name, const YAML::Node& config, Implementation* parent) {
   DEBUG_LOG(DFACTORY, Logging::get("Base"), "Creating an implementation of interface {}...", ifce_name)
+  seal();
 
   if (!config[ifce_name]) {
     throw InitializationError("Interface {} not found in the configuration!", ifce_name); 
@@ -128,6 +151,7 @@ Implementation* Factory::create_implementation(std::string ifce_name, const YAML
 
 
 void Factory::dump() {
+  seal();
   for (const auto& [ifce_name, ifce_info] : m_registry) {
     std::cout << fmt::format("Interface \"{}\":", ifce_name) << std::endl;
     for (const auto& [impl_name, impl_info] : ifce_info.impls_info) {
@@ -137,6 +161,7 @@ void Factory::dump() {
 }
 
 IFrontEnd* Factory::create_frontend(const YAML::Node& config) {
+  SimulationContext::Scope context(SimulationContext::from_config(config["Simulation"]));
   Implementation* impl = Factory::create_implementation(IFrontEnd::get_name(), config, nullptr);
   IFrontEnd* frontend = dynamic_cast<IFrontEnd*>(impl);
   if (frontend == nullptr) {
@@ -150,6 +175,7 @@ IFrontEnd* Factory::create_frontend(const YAML::Node& config) {
 };
 
 IMemorySystem* Factory::create_memory_system(const YAML::Node& config) {
+  SimulationContext::Scope context(SimulationContext::from_config(config["Simulation"]));
   Implementation* impl = Factory::create_implementation(IMemorySystem::get_name(), config, nullptr);
   IMemorySystem* memory_system = dynamic_cast<IMemorySystem*>(impl);
   if (memory_system == nullptr) {
@@ -5,6 +5,8 @@
 #include <vector>
 #include <unordered_map>
 #include <functional>
+#include <atomic>
+#include <mutex>
 
 #include <spdlog/spdlog.h>
 #include <yaml-cpp/yaml.h>
@@ -38,7 +40,18 @@ class Factory {
   };
 
   private:
+    // The registry of all interfaces and implementations. It is built while the static registrations run at startup
+    // and sealed when the first implementation is created. From then on it is immutable, so any number of threads
+    // can look it up (and build their own simulations) without locking.
     inline static Registry_t<InterfaceInfo> m_registry;
+    inline static std::mutex m_registry_mutex;
+    inline static std::atomic<bool> m_sealed = false;
+
+    /**
+     * @brief     Seals the registry, after which registering throws.
+     *
+     */
+    static void seal();
 
   public:
     /**
@@ -67,6 +80,13 @@ class Factory {
     static Implementation* create_implementation(std::string ifce_name, std::string impl_name, const YAML::Node& config, Implementation* parent);
     static Implementation* create_implementation(std::string ifce_name, const YAML::Node& config, Implementation* parent);
 
+    /**
+     * @brief     Construct the top-level frontend (memory system) of a simulation and all its components.
+     * @details
+     * The components are given the SimulationContext of the optional "Simulation" section of the configuration.
+     * Simulations with independent configurations can be constructed from different threads concurrently.
+     *
+    */
     static IFrontEnd* create_frontend(const YAML::Node& config);
     static IMemorySystem* create_memory_system(const YAML::Node& config);
 
@@ -0,0 +1,81 @@
+#ifndef     RAMULATOR_BASE_LAZY_ARRAY_H
+#define     RAMULATOR_BASE_LAZY_ARRAY_H
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace Ramulator {
+
+/**
+ * @brief    A fixed-size array of entries that start as all zero bytes, for the large tables of the controller plugins
+ *           (e.g., a counter per row of every bank)
+ * @details
+ * The array is allocated with calloc, which takes large blocks straight from the OS as zero pages that only get
+ * memory when they are first written. So a table costs nothing to build however large it is, and only the parts that
+ * the simulation touches are ever allocated. The entries must be trivially copyable and all zero bytes must be their
+ * initial (or reset) state.
+ *
+ */
+template<typename T>
+class LazyArray {
+  static_assert(std::is_trivially_copyable_v<T>, "LazyArray entries must be trivially copyable!");
+
+  private:
+    struct Free {
+      void operator()(T* data) const { std::free(data); };
+    };
+    std::unique_ptr<T[], Free> m_data;
+    size_t m_size = 0;
+
+  public:
+    LazyArray() = default;
+    explicit LazyArray(size_t size) { assign_zero(size); };
+
+    LazyArray(const LazyArray& other) {
+      assign_zero(other.m_size);
+      if (m_size > 0) {
+        std::memcpy(m_data.get(), other.m_data.get(), m_size * sizeof(T));
+      }
+    };
+    LazyArray& operator=(const LazyArray& other) {
+      if (this != &other) {
+        *this = LazyArray(other);
+      }
+      return *this;
+    };
+    LazyArray(LazyArray&&) noexcept = default;
+    LazyArray& operator=(LazyArray&&) noexcept = default;
+
+    /**
+     * @brief    Replaces the array with size zeroed entries.
+     *
+     */
+    void assign_zero(size_t size) {
+      m_data.reset();
+      m_size = size;
+      if (size > 0) {
+        m_data.reset(static_cast<T*>(std::calloc(size, sizeof(T))));
+        if (!m_data) {
+          throw std::bad_alloc();
+        }
+      }
+    };
+
+    T& operator[](size_t idx) { return m_data[idx]; };
+    const T& operator[](size_t idx) const { return m_data[idx]; };
+    size_t size() const { return m_size; };
+
+    /// The bytes reserved for the entries (the memory only backs the pages that were written)
+    size_t bytes() const { return m_size * sizeof(T); };
+};
+
+template<typename T>
+size_t heap_bytes(const LazyArray<T>& a) { return a.bytes(); };
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_BASE_LAZY_ARRAY_H
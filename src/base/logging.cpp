@@ -1,10 +1,24 @@
+#include <mutex>
+
 #include "base/logging.h"
+#include "base/context.h"
 
 
 namespace Ramulator {
 
 Logger_t Logging::create_logger(std::string name, std::string pattern) {
-  auto logger = spdlog::stdout_color_st("Ramulator::" + name);
+  // The loggers of a named simulation are tagged with its name. Several instances of a component in one
+  // simulation share its logger
+  const std::string& context_name = SimulationContext::current()->name;
+  std::string full_name = context_name.empty() ? "Ramulator::" + name : "Ramulator::" + context_name + "::" + name;
+
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (auto logger = spdlog::get(full_name)) {
+    return logger;
+  }
+
+  auto logger = spdlog::stdout_color_mt(full_name);
 
   if (!logger) {
     throw InitializationError("Error creating logger {}!", name);
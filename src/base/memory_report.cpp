@@ -0,0 +1,120 @@
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+#include "base/base.h"
+#include "base/memory_report.h"
+
+namespace Ramulator {
+
+MemoryReport::MemoryReport(const std::string& path, uint64_t epoch): m_epoch(epoch) {
+  if (epoch == 0) {
+    return;
+  }
+  m_file.open(path, std::ios::out | std::ios::trunc);
+  if (!m_file.is_open()) {
+    throw ConfigurationError("Cannot open memory report file {}!", path);
+  }
+}
+
+std::unique_ptr<MemoryReport> MemoryReport::from_config(const YAML::Node& config) {
+  if (!config) {
+    return nullptr;
+  }
+  uint64_t epoch = config["epoch"].as<uint64_t>(0);
+  std::string path = config["path"].as<std::string>("memory_report.csv");
+  return std::make_unique<MemoryReport>(path, epoch);
+}
+
+void MemoryReport::add(const std::string& path, const Implementation* component) {
+  if (m_header_written) {
+    throw ConfigurationError("Cannot add {} to the memory report after its first sample!", path);
+  }
+  m_components.emplace_back(path, component);
+}
+
+void MemoryReport::sample(uint64_t clk) {
+  if (m_epoch == 0) {
+    return;
+  }
+  if (!m_header_written) {
+    m_file << "clk,rss_bytes,tracked_bytes";
+    for (const auto& [path, component] : m_components) {
+      m_file << "," << path;
+    }
+    m_file << "\n";
+    m_header_written = true;
+  }
+
+  std::vector<size_t> footprints;
+  size_t tracked = 0;
+  for (const auto& [path, component] : m_components) {
+    footprints.push_back(component->memory_footprint());
+    tracked += footprints.back();
+  }
+  m_file << clk << "," << resident_bytes() << "," << tracked;
+  for (size_t bytes : footprints) {
+    m_file << "," << bytes;
+  }
+  m_file << "\n";
+  m_file.flush();
+}
+
+void MemoryReport::report(YAML::Emitter& emitter) const {
+  std::vector<std::pair<size_t, const std::string*>> footprints;
+  size_t tracked = 0;
+  for (const auto& [path, component] : m_components) {
+    size_t bytes = component->memory_footprint();
+    if (bytes > 0) {
+      footprints.emplace_back(bytes, &path);
+      tracked += bytes;
+    }
+  }
+  std::stable_sort(footprints.begin(), footprints.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+  emitter << YAML::BeginMap;
+  emitter << YAML::Key << "MemoryReport" << YAML::Value << YAML::BeginMap;
+  // The peak is only updated by the kernel from time to time, so it can lag the current resident memory
+  size_t rss = resident_bytes();
+  emitter << YAML::Key << "rss_bytes" << YAML::Value << rss;
+  emitter << YAML::Key << "peak_rss_bytes" << YAML::Value << std::max(rss, peak_resident_bytes());
+  emitter << YAML::Key << "tracked_bytes" << YAML::Value << tracked;
+  emitter << YAML::Key << "components" << YAML::Value << YAML::BeginMap;
+  for (const auto& [bytes, path] : footprints) {
+    emitter << YAML::Key << *path << YAML::Value << bytes;
+  }
+  emitter << YAML::EndMap;
+  emitter << YAML::EndMap;
+  emitter << YAML::EndMap;
+}
+
+size_t MemoryReport::resident_bytes() {
+#if defined(__linux__)
+  std::ifstream statm("/proc/self/statm");
+  size_t total_pages = 0;
+  size_t resident_pages = 0;
+  if (statm >> total_pages >> resident_pages) {
+    return resident_pages * size_t(sysconf(_SC_PAGESIZE));
+  }
+#endif
+  return 0;
+}
+
+size_t MemoryReport::peak_resident_bytes() {
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+    return size_t(usage.ru_maxrss);           // Bytes
+#else
+    return size_t(usage.ru_maxrss) * 1024;    // Kilobytes
+#endif
+  }
+#endif
+  return 0;
+}
+
+}        // namespace Ramulator
@@ -0,0 +1,75 @@
+#ifndef     RAMULATOR_BASE_MEMORY_REPORT_H
+#define     RAMULATOR_BASE_MEMORY_REPORT_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <memory>
+#include <cstdint>
+
+#include <yaml-cpp/yaml.h>
+
+namespace Ramulator {
+
+class Implementation;
+
+/// The heap bytes of the elements a vector holds (its capacity), for Implementation::memory_footprint()
+template<typename T>
+size_t heap_bytes(const std::vector<T>& v) { return v.capacity() * sizeof(T); };
+
+/**
+ * @brief    Reports the memory every component owns (its Implementation::memory_footprint()) next to the resident
+ *           memory of the process, at the end of a run and optionally every epoch.
+ * @details
+ * The footprints are only what the components report for their major data structures, so the difference between the
+ * resident memory and their sum is the memory nobody reports (e.g., the allocator, the code and the small members).
+ *
+ * Every epoch, a CSV row of the cycle, the resident bytes, the sum of the footprints and the footprint of every
+ * component is appended to the file. The columns are named "<component path>:<implementation>", as in the checkpoints,
+ * and fixed at the first sample.
+ *
+ */
+class MemoryReport {
+  private:
+    std::vector<std::pair<std::string, const Implementation*>> m_components;
+    std::ofstream m_file;
+    uint64_t m_epoch;
+    bool m_header_written = false;
+
+  public:
+    MemoryReport(const std::string& path, uint64_t epoch);
+
+    /**
+     * @brief    Creates a memory report from its configuration (epoch, path), or nullptr if there is none.
+     *
+     */
+    static std::unique_ptr<MemoryReport> from_config(const YAML::Node& config);
+
+    void add(const std::string& path, const Implementation* component);
+
+    /**
+     * @brief    Appends the footprints at cycle clk as one row of the file (nothing without an epoch).
+     *
+     */
+    void sample(uint64_t clk);
+
+    /// The number of cycles between two samples (0 = only at the end).
+    uint64_t get_epoch() const { return m_epoch; };
+
+    /**
+     * @brief    Emits the resident memory of the process and the components with a footprint, largest first, as a
+     *           "MemoryReport" map.
+     *
+     */
+    void report(YAML::Emitter& emitter) const;
+
+    /// The resident memory of the process (0 where it cannot be read)
+    static size_t resident_bytes();
+    /// The peak resident memory of the process (0 where it cannot be read)
+    static size_t peak_resident_bytes();
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_BASE_MEMORY_REPORT_H
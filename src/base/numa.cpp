@@ -0,0 +1,78 @@
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#include "base/numa.h"
+
+namespace Ramulator {
+
+namespace NUMA {
+
+int current_cpu() {
+#if defined(__linux__)
+  return sched_getcpu();
+#else
+  return -1;
+#endif
+}
+
+int cpu_node(int cpu) {
+#if defined(__linux__)
+  if (cpu < 0) {
+    return -1;
+  }
+  // The CPU directory links to its node as "node<id>"
+  std::error_code error;
+  std::filesystem::directory_iterator entries("/sys/devices/system/cpu/cpu" + std::to_string(cpu), error);
+  for (; !error && entries != std::filesystem::directory_iterator(); entries.increment(error)) {
+    std::string name = entries->path().filename().string();
+    if (name.size() > 4 && name.compare(0, 4, "node") == 0 && name.find_first_not_of("0123456789", 4) == std::string::npos) {
+      return std::stoi(name.substr(4));
+    }
+  }
+#endif
+  return -1;
+}
+
+double node_fraction(std::span<const std::byte> memory, int node, size_t max_pages) {
+#if defined(__linux__) && defined(SYS_move_pages)
+  if (memory.empty() || node < 0 || max_pages == 0) {
+    return -1.0;
+  }
+  uintptr_t page_size = uintptr_t(sysconf(_SC_PAGESIZE));
+  uintptr_t first = uintptr_t(memory.data()) & ~(page_size - 1);
+  uintptr_t last = (uintptr_t(memory.data()) + memory.size() - 1) & ~(page_size - 1);
+  size_t num_pages = (last - first) / page_size + 1;
+  size_t stride = (num_pages + max_pages - 1) / max_pages;
+
+  std::vector<void*> pages;
+  for (size_t i = 0; i < num_pages; i += stride) {
+    pages.push_back(reinterpret_cast<void*>(first + i * page_size));
+  }
+  // Without target nodes, move_pages() only reports the node of every page
+  std::vector<int> status(pages.size(), -1);
+  if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0) != 0) {
+    return -1.0;
+  }
+  size_t num_local = 0;
+  size_t num_known = 0;
+  for (int page_node : status) {
+    num_known += page_node >= 0;
+    num_local += page_node == node;
+  }
+  return num_known ? double(num_local) / double(num_known) : -1.0;
+#else
+  return -1.0;
+#endif
+}
+
+}        // namespace NUMA
+
+}        // namespace Ramulator
@@ -0,0 +1,33 @@
+#ifndef     RAMULATOR_BASE_NUMA_H
+#define     RAMULATOR_BASE_NUMA_H
+
+#include <cstddef>
+#include <span>
+
+namespace Ramulator {
+
+/**
+ * @brief    Where the calling thread runs and where memory lives, read from the kernel (Linux only, without libnuma).
+ *           Every query returns -1 where it cannot be answered (e.g., another OS, or a kernel without NUMA).
+ *
+ */
+namespace NUMA {
+
+/// The CPU the calling thread runs on
+int current_cpu();
+
+/// The NUMA node of a CPU
+int cpu_node(int cpu);
+
+/**
+ * @brief    The fraction of the pages of memory that are on NUMA node node, sampling at most max_pages of them.
+ *
+ */
+double node_fraction(std::span<const std::byte> memory, int node, size_t max_pages = 1024);
+
+}        // namespace NUMA
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_BASE_NUMA_H
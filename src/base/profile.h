@@ -0,0 +1,84 @@
+#ifndef     RAMULATOR_BASE_PROFILE_H
+#define     RAMULATOR_BASE_PROFILE_H
+
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RAMULATOR_PROFILE_X86 1
+#include <x86intrin.h>
+#else
+#define RAMULATOR_PROFILE_X86 0
+#endif
+
+namespace Ramulator {
+
+namespace Profile {
+
+/**
+ * @brief     Reads the time stamp counter, or a nanosecond clock where there is none.
+ *
+ */
+inline uint64_t read_tsc() {
+#if RAMULATOR_PROFILE_X86
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * @brief     The number of profiled calls into a component and the TSC cycles spent in them.
+ * @details
+ * Relaxed atomics, since e.g. the DRAM device is called by the controllers of all channels when they tick in parallel.
+ *
+ */
+struct Counter {
+  std::atomic<uint64_t> calls {0};
+  std::atomic<uint64_t> tsc_cycles {0};
+};
+
+/**
+ * @brief     Adds the TSC cycles of its lifetime to a counter.
+ *
+ */
+class ScopedTimer {
+  private:
+    Counter& m_counter;
+    uint64_t m_start;
+
+  public:
+    explicit ScopedTimer(Counter& counter): m_counter(counter), m_start(read_tsc()) {};
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+    ~ScopedTimer() {
+      m_counter.tsc_cycles.fetch_add(read_tsc() - m_start, std::memory_order_relaxed);
+      m_counter.calls.fetch_add(1, std::memory_order_relaxed);
+    };
+};
+
+template<typename Func>
+decltype(auto) timed(Counter& counter, Func&& func) {
+  ScopedTimer timer(counter);
+  return func();
+}
+
+}        // namespace Profile
+
+/**
+ * @brief     Calls a hot-path method of a component through its interface pointer, timed with the counter of its
+ *            implementation if Ramulator is built with RAMULATOR_PROFILE. Otherwise it is just the call.
+ *
+ */
+#ifdef RAMULATOR_PROFILE
+#define RAMULATOR_PROFILE_CALL(ifce, call) \
+  ::Ramulator::Profile::timed((ifce)->m_impl->m_profile, [&]() -> decltype(auto) { return (ifce)->call; })
+#else
+#define RAMULATOR_PROFILE_CALL(ifce, call) ((ifce)->call)
+#endif
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_BASE_PROFILE_H
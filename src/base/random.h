@@ -0,0 +1,178 @@
+#ifndef     RAMULATOR_BASE_RANDOM_H
+#define     RAMULATOR_BASE_RANDOM_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    SplitMix64 finalizer: a bijection that spreads every input bit over the output, to derive keys.
+ *
+ */
+inline uint64_t mix64(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+/**
+ * @brief    64-bit FNV-1a hash of a string, to key the streams of a component by its path.
+ *
+ */
+inline uint64_t fnv1a(std::string_view s) {
+  uint64_t h = 0xCBF29CE484222325ull;
+  for (char c : s) {
+    h = (h ^ (uint8_t) c) * 0x100000001B3ull;
+  }
+  return h;
+}
+
+/**
+ * @brief    Philox4x32-10 (Salmon et al., SC'11): a keyed bijection of 128-bit counters whose outputs pass BigCrush.
+ *
+ */
+struct Philox4x32 {
+  using Counter = std::array<uint32_t, 4>;
+  using Key = std::array<uint32_t, 2>;
+
+  static Counter block(Counter ctr, Key key) {
+    for (int round = 0; round < 10; round++) {
+      if (round > 0) {
+        key[0] += 0x9E3779B9u;
+        key[1] += 0xBB67AE85u;
+      }
+      uint64_t p0 = (uint64_t) 0xD2511F53u * ctr[0];
+      uint64_t p1 = (uint64_t) 0xCD9E8D57u * ctr[2];
+      ctr = {uint32_t(p1 >> 32) ^ ctr[1] ^ key[0], uint32_t(p1), uint32_t(p0 >> 32) ^ ctr[3] ^ key[1], uint32_t(p0)};
+    }
+    return ctr;
+  };
+};
+
+
+/**
+ * @brief    A stream of the simulator-wide counter-based random number generator.
+ *
+ * @details
+ * Number n of a stream is half of the Philox4x32-10 block of the counter (n / 2, stream id) under the stream's key, so
+ * a stream holds no state but its position: it can be created anywhere, drawn from at any position in constant time
+ * (at()), and checkpointed as one integer. Components get their streams from Implementation::random_stream(), keyed by
+ * the simulation seed, their path in the component tree and their configured seed, so every component draws its own
+ * reproducible numbers however the simulation is scheduled.
+ *
+ * Satisfies UniformRandomBitGenerator so it can drive the <random> distributions.
+ *
+ */
+class RandomStream {
+  public:
+    using result_type = uint64_t;
+
+  private:
+    Philox4x32::Key m_key = {0, 0};
+    uint64_t m_stream = 0;
+    uint64_t m_position = 0;              // Of the next number
+    Philox4x32::Counter m_block = {};     // Of the counter m_position / 2 while m_position is odd
+
+  public:
+    RandomStream() {};
+    RandomStream(uint64_t key, uint64_t stream): m_key({uint32_t(key), uint32_t(key >> 32)}), m_stream(stream) {};
+
+    static constexpr result_type min() { return 0; };
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); };
+
+    result_type operator()() {
+      if (m_position % 2 == 0) {
+        m_block = Philox4x32::block(counter(m_position / 2), m_key);
+      }
+      return half(m_block, m_position++ % 2);
+    };
+
+    /**
+     * @brief    Number position of the stream, without moving it.
+     *
+     */
+    result_type at(uint64_t position) const {
+      return half(Philox4x32::block(counter(position / 2), m_key), position % 2);
+    };
+
+    /**
+     * @brief    Uniform double in (0, 1].
+     *
+     */
+    double next_open_unit() {
+      return ((*this)() >> 11) * 0x1.0p-53 + 0x1.0p-53;
+    };
+
+    // For checkpoints: the number of numbers drawn
+    uint64_t position() const { return m_position; };
+    void seek(uint64_t position) {
+      m_position = position;
+      if (m_position % 2 == 1) {
+        m_block = Philox4x32::block(counter(m_position / 2), m_key);
+      }
+    };
+
+  private:
+    Philox4x32::Counter counter(uint64_t index) const {
+      return {uint32_t(index), uint32_t(index >> 32), uint32_t(m_stream), uint32_t(m_stream >> 32)};
+    };
+    static result_type half(const Philox4x32::Counter& block, int i) {
+      return (uint64_t(block[2 * i + 1]) << 32) | block[2 * i];
+    };
+};
+
+
+/**
+ * @brief    The number of failed Bernoulli(p) trials before the next success
+ *
+ * @details
+ * Instead of one random draw per trial, a user draws the gap to the next success once and counts it down, so the
+ * trials in between cost a decrement. The gaps follow the same distribution as the trials would, by inverse transform
+ * sampling of Geometric(p): floor(log(U) / log(1 - p)) for U uniform in (0, 1].
+ *
+ */
+class GeometricSampler {
+  private:
+    double m_p = 0.0;
+    double m_inv_log_failure = 0.0;   // 1 / log(1 - p)
+
+  public:
+    GeometricSampler() {};
+    explicit GeometricSampler(double p): m_p(p) {
+      if (p < 0.0 || p > 1.0) {
+        throw ConfigurationError("Probability {} is not in [0, 1]!", p);
+      }
+      if (p > 0.0 && p < 1.0) {
+        m_inv_log_failure = 1.0 / std::log1p(-p);
+      }
+    };
+
+    double probability() const { return m_p; };
+
+    /**
+     * @brief    Draws the number of failures before the next success, saturated to limit (e.g., never for p = 0).
+     *
+     */
+    template <typename RNG>
+    uint64_t next(RNG& rng, uint64_t limit = std::numeric_limits<uint64_t>::max()) const {
+      if (m_p >= 1.0) {
+        return 0;
+      }
+      if (m_p <= 0.0) {
+        return limit;
+      }
+      double gap = std::floor(std::log(rng.next_open_unit()) * m_inv_log_failure);
+      return gap >= (double) limit ? limit : (uint64_t) gap;
+    };
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_BASE_RANDOM_H
@@ -1,14 +1,57 @@
 #ifndef     RAMULATOR_BASE_REQUEST_H
 #define     RAMULATOR_BASE_REQUEST_H
 
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <list>
+#include <memory>
+#include <new>
+#include <vector>
 #include <string>
+#include <type_traits>
 
 #include "base/base.h"
 
 namespace Ramulator {
 
+struct Request;
+
+/**
+ * @brief    A request completion callback that stores its callable inline.
+ *
+ * @details
+ * Any callable of at most CAPACITY bytes that is trivially copyable (e.g., a lambda capturing `this` and a few
+ * integers, or a function pointer) is copied into the handle; larger or owning callables are rejected at compile
+ * time. Copying a handle copies CAPACITY bytes and a function pointer, without allocation.
+ *
+ */
+class RequestCallback {
+  public:
+    static constexpr size_t CAPACITY = 3 * sizeof(void*);
+
+    RequestCallback() = default;
+    RequestCallback(std::nullptr_t) {};
+
+    template<typename F> requires (!std::is_same_v<std::decay_t<F>, RequestCallback> && std::is_invocable_v<F&, Request&>)
+    RequestCallback(F callable) {
+      static_assert(sizeof(F) <= CAPACITY, "RequestCallback: the callable does not fit the inline storage!");
+      static_assert(alignof(F) <= alignof(std::max_align_t), "RequestCallback: the callable is over-aligned!");
+      static_assert(std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>,
+                    "RequestCallback: the callable must be trivially copyable (capture pointers and values only)!");
+      ::new (static_cast<void*>(m_storage)) F(callable);
+      m_invoke = [](void* storage, Request& req) { (*static_cast<F*>(storage))(req); };
+    };
+
+    void operator()(Request& req) const { m_invoke(m_storage, req); };
+    explicit operator bool() const { return m_invoke != nullptr; };
+
+  private:
+    alignas(std::max_align_t) mutable unsigned char m_storage[CAPACITY] = {};
+    void (*m_invoke)(void*, Request&) = nullptr;
+};
+
 struct Request { 
   Addr_t    addr = -1;
   AddrVec_t addr_vec {};
@@ -28,38 +71,85 @@ struct Request {
 
   int command = -1;          // The command that need to be issued to progress the request
   int final_command = -1;    // The final command that is needed to finish the request
+  int64_t preq_version = -1;    // IDRAM::get_state_version() of addr_vec when command was last computed (-1 = unknown)
   bool is_stat_updated = false; // Memory controller stats
+  int lifecycle_id = -1;        // Slot of a sampled request in the lifecycle sampler of its controller (-1 = not sampled)
 
   Clk_t arrive = -1;   // Clock cycle when the request arrive at the memory controller
   Clk_t depart = -1;   // Clock cycle when the request depart the memory controller
 
   std::array<int, 4> scratchpad = { 0 };    // A scratchpad for the request
 
-  std::function<void(Request&)> callback;
+  RequestCallback callback;
 
   void* m_payload = nullptr;    // Point to a generic payload
 
   Request(Addr_t addr, int type);
   Request(AddrVec_t addr_vec, int type);
-  Request(Addr_t addr, int type, int source_id, std::function<void(Request&)> callback);
+  Request(Addr_t addr, int type, int source_id, RequestCallback callback);
 };
-
-
+static_assert(std::is_trivially_copyable_v<Request>, "Requests are copied between buffers and should stay memcpy-cheap");
+
+
+/**
+ * @brief    A request buffer backed by a pool of request slots.
+ *
+ * @details
+ * The slots are allocated in chunks of CHUNK_SIZE and never move, so an iterator (and a reference to its request)
+ * stays valid until that request is removed. Requests are kept in arrival order by a doubly-linked list of slot
+ * indices, and removed slots go to a free list: enqueue() and remove() are O(1) and, once the pool has grown to the
+ * occupancy of the buffer, do not allocate. A free slot keeps its old Request, so that assigning a new one reuses
+ * the capacity of its addr_vec. transfer() moves a request to another buffer by swapping it into a slot of that buffer.
+ *
+ * Chunks are only allocated on demand, so that buffers with a very large max_size (e.g., the pending queue) cost
+ * no more memory than their peak occupancy.
+ *
+ */
 struct ReqBuffer {
-  std::list<Request> buffer;
+  static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+  static constexpr uint32_t CHUNK_BITS = 6;
+  static constexpr uint32_t CHUNK_SIZE = 1u << CHUNK_BITS;
+
   size_t max_size = 32;
 
+  class iterator {
+    friend struct ReqBuffer;
+
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type = Request;
+      using difference_type = std::ptrdiff_t;
+      using pointer = Request*;
+      using reference = Request&;
+
+      iterator() = default;
+
+      reference operator*() const { return m_buffer->slot(m_slot).request; };
+      pointer operator->() const { return &m_buffer->slot(m_slot).request; };
+
+      iterator& operator++() { m_slot = m_buffer->slot(m_slot).next; return *this; };
+      iterator operator++(int) { iterator it = *this; ++(*this); return it; };
+      iterator& operator--() { m_slot = (m_slot == NIL) ? m_buffer->m_tail : m_buffer->slot(m_slot).prev; return *this; };
+      iterator operator--(int) { iterator it = *this; --(*this); return it; };
 
-  using iterator = std::list<Request>::iterator;
-  iterator begin() { return buffer.begin(); };
-  iterator end() { return buffer.end(); };
+      bool operator==(const iterator& other) const { return m_slot == other.m_slot && m_buffer == other.m_buffer; };
 
+    private:
+      iterator(ReqBuffer* buffer, uint32_t slot): m_buffer(buffer), m_slot(slot) {};
 
-  size_t size() const { return buffer.size(); }
+      ReqBuffer* m_buffer = nullptr;
+      uint32_t m_slot = NIL;
+  };
+
+  iterator begin() { return iterator(this, m_head); };
+  iterator end() { return iterator(this, NIL); };
+
+
+  size_t size() const { return m_size; }
 
   bool enqueue(const Request& request) {
-    if (buffer.size() <= max_size) {
-      buffer.push_back(request);
+    if (m_size <= max_size) {
+      slot(acquire()).request = request;
       return true;
     } else {
       return false;
@@ -67,8 +157,80 @@ struct ReqBuffer {
   }
 
   void remove(iterator it) {
-    buffer.erase(it);
+    release(it.m_slot);
+  }
+
+  /**
+   * @brief    Moves the request at it to the back of dst without copying it. Returns false if dst is full.
+   *
+   */
+  bool transfer(iterator it, ReqBuffer& dst) {
+    if (dst.m_size > dst.max_size) {
+      return false;
+    }
+    std::swap(dst.slot(dst.acquire()).request, slot(it.m_slot).request);
+    release(it.m_slot);
+    return true;
   }
+
+  private:
+    struct Slot {
+      Request request = Request(Addr_t(-1), -1);
+      uint32_t prev = NIL;
+      uint32_t next = NIL;
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> m_chunks;
+    uint32_t m_head = NIL;
+    uint32_t m_tail = NIL;
+    uint32_t m_free = NIL;          // Free slots, linked through Slot::next
+    size_t m_size = 0;
+
+    Slot& slot(uint32_t idx) { return m_chunks[idx >> CHUNK_BITS][idx & (CHUNK_SIZE - 1)]; };
+
+    // Takes a free slot (growing the pool by one chunk if there is none) and links it at the back
+    uint32_t acquire() {
+      if (m_free == NIL) {
+        uint32_t base = m_chunks.size() * CHUNK_SIZE;
+        m_chunks.push_back(std::make_unique<Slot[]>(CHUNK_SIZE));
+        for (uint32_t i = CHUNK_SIZE; i-- > 0;) {
+          m_chunks.back()[i].next = m_free;
+          m_free = base + i;
+        }
+      }
+      uint32_t idx = m_free;
+      Slot& s = slot(idx);
+      m_free = s.next;
+      s.prev = m_tail;
+      s.next = NIL;
+      if (m_tail != NIL) {
+        slot(m_tail).next = idx;
+      } else {
+        m_head = idx;
+      }
+      m_tail = idx;
+      m_size++;
+      return idx;
+    }
+
+    // Unlinks a slot and returns it to the free list
+    void release(uint32_t idx) {
+      Slot& s = slot(idx);
+      if (s.prev != NIL) {
+        slot(s.prev).next = s.next;
+      } else {
+        m_head = s.next;
+      }
+      if (s.next != NIL) {
+        slot(s.next).prev = s.prev;
+      } else {
+        m_tail = s.prev;
+      }
+      s.prev = NIL;
+      s.next = m_free;
+      m_free = idx;
+      m_size--;
+    }
 };
 
 }        // namespace Ramulator
@@ -2,6 +2,8 @@
 #define     RAMULATOR_BASE_SERIALIZATION_H
 
 #include <string>
+#include <istream>
+#include <ostream>
 
 
 namespace Ramulator {
@@ -29,6 +31,32 @@ class Serializable {
 };  
 
 
+/**
+ * @brief    Interface of the implementations whose state is saved in (and restored from) a simulator checkpoint.
+ * @details
+ * Each implementation writes its state to its own section of the checkpoint (see Checkpoint::save). Only the state
+ * that needs a long simulation to warm up belongs there (e.g., cache contents, open rows, tracker tables), while the
+ * requests in flight are not saved, so a restored simulation starts with empty queues and fresh statistics.
+ *
+ */
+class Checkpointable {
+  public:
+    virtual ~Checkpointable() = default;
+
+    /**
+     * @brief Writes my state to my checkpoint section.
+     *
+     */
+    virtual void save_checkpoint(std::ostream& out) = 0;
+
+    /**
+     * @brief Restores my state from the section written by save_checkpoint(). Called after setup().
+     *
+     */
+    virtual void load_checkpoint(std::istream& in) = 0;
+};
+
+
 }        // namespace Ramulator
 
 
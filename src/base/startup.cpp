@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <fmt/format.h>
+
+#include "base/startup.h"
+
+namespace Ramulator {
+
+namespace Startup {
+
+namespace {
+
+struct Pool {
+  static constexpr auto IDLE_TIMEOUT = std::chrono::milliseconds(200);
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::function<void()>> tasks;
+  size_t num_workers = 0;
+  size_t num_idle = 0;
+  size_t max_workers = std::max(1u, std::thread::hardware_concurrency());
+
+  void work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      num_idle++;
+      bool has_task = cv.wait_for(lock, IDLE_TIMEOUT, [this] { return !tasks.empty(); });
+      num_idle--;
+      if (!has_task) {
+        num_workers--;
+        return;
+      }
+      std::function<void()> task = std::move(tasks.front());
+      tasks.pop_front();
+      lock.unlock();
+      task();
+      lock.lock();
+    }
+  };
+};
+
+// Never destroyed, so that workers still winding down at exit do not outlive it
+Pool& pool() {
+  static Pool* pool = new Pool();
+  return *pool;
+}
+
+}       // namespace
+
+
+namespace Details {
+
+void enqueue(std::function<void()> task) {
+  Pool& p = pool();
+  std::lock_guard<std::mutex> lock(p.mutex);
+  p.tasks.push_back(std::move(task));
+  if (p.num_idle < p.tasks.size() && p.num_workers < p.max_workers) {
+    p.num_workers++;
+    std::thread([&p] { p.work(); }).detach();
+  } else {
+    p.cv.notify_one();
+  }
+}
+
+}       // namespace Details
+
+
+void PhaseTimer::phase(const std::string& name) {
+  if (!m_phase.empty()) {
+    m_phases.emplace_back(m_phase, ms_since(m_phase_start));
+  }
+  m_phase = name;
+  m_phase_start = Clock::now();
+}
+
+void PhaseTimer::finish() {
+  phase("");
+  m_total_ms = ms_since(m_start);
+}
+
+std::string PhaseTimer::summary() const {
+  std::string summary;
+  for (const auto& [name, ms] : m_phases) {
+    summary += fmt::format("{}{} {:.1f} ms", summary.empty() ? "" : ", ", name, ms);
+  }
+  return summary;
+}
+
+void PhaseTimer::report(YAML::Emitter& emitter) const {
+  emitter << YAML::BeginMap;
+  emitter << YAML::Key << "Startup" << YAML::Value << YAML::BeginMap;
+  for (const auto& [name, ms] : m_phases) {
+    emitter << YAML::Key << name + "_ms" << YAML::Value << ms;
+  }
+  emitter << YAML::Key << "total_ms" << YAML::Value << m_total_ms;
+  emitter << YAML::EndMap;
+  emitter << YAML::EndMap;
+}
+
+}        // namespace Startup
+
+}        // namespace Ramulator
@@ -0,0 +1,82 @@
+#ifndef     RAMULATOR_BASE_STARTUP_H
+#define     RAMULATOR_BASE_STARTUP_H
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+namespace Ramulator {
+
+/**
+ * @brief    The work of building a simulation that can run while the rest of it is built (e.g., parsing the traces)
+ * @details
+ * Startup::run() queues a task on a process-wide pool of at most one thread per hardware thread, and returns the
+ * future of its result (get() rethrows its exception). The workers are started on demand and exit once they have been
+ * idle for a while, so the pool costs nothing after the startup. A task must not wait for another task of the pool,
+ * which may be queued behind it.
+ *
+ */
+namespace Startup {
+
+namespace Details {
+void enqueue(std::function<void()> task);
+}
+
+template<typename Task>
+auto run(Task task) -> std::shared_future<decltype(task())> {
+  using Result = decltype(task());
+  auto packaged = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+  std::shared_future<Result> result = packaged->get_future().share();
+  Details::enqueue([packaged] { (*packaged)(); });
+  return result;
+};
+
+
+/**
+ * @brief    The wall time of the phases of the startup of a simulation, up to its first cycle
+ * @details
+ * A phase ends when the next one starts (or at finish()). Phases that overlap (e.g., the frontend and the memory system
+ * built on two threads) are timed on their own with add().
+ *
+ */
+class PhaseTimer {
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point m_start = Clock::now();
+    Clock::time_point m_phase_start = m_start;
+    std::string m_phase;
+    std::vector<std::pair<std::string, double>> m_phases;    // Milliseconds
+    double m_total_ms = -1;
+
+  public:
+    static double ms_since(Clock::time_point start) {
+      return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+    static Clock::time_point now() { return Clock::now(); };
+
+    void phase(const std::string& name);
+    void add(const std::string& name, double ms) { m_phases.emplace_back(name, ms); };
+    void finish();
+
+    double total_ms() const { return m_total_ms; };
+
+    /// "<phase> <ms> ms, ..." for the log
+    std::string summary() const;
+
+    /// Emits the phases and the total as a "Startup" map (in milliseconds)
+    void report(YAML::Emitter& emitter) const;
+};
+
+}        // namespace Startup
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_BASE_STARTUP_H
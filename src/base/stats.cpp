@@ -1,3 +1,10 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
 #include "base/stats.h"
 
 namespace Ramulator {
@@ -9,4 +16,597 @@ YAML::Emitter& operator << (YAML::Emitter& emitter, const Stats& s) {
 	return emitter;
 }
 
+
+StatsStream::StatsStream(const std::string& path, Format format, bool delta, uint64_t epoch):
+m_format(format), m_delta(delta), m_epoch(epoch) {
+  std::ios::openmode mode = std::ios::out | std::ios::trunc;
+  if (format == Format::Binary) {
+    mode |= std::ios::binary;
+  }
+  m_file.open(path, mode);
+  if (!m_file.is_open()) {
+    throw ConfigurationError("Cannot open stats stream file {}!", path);
+  }
+}
+
+std::unique_ptr<StatsStream> StatsStream::from_config(const YAML::Node& config) {
+  if (!config) {
+    return nullptr;
+  }
+
+  uint64_t epoch = config["epoch"].as<uint64_t>(0);
+  if (epoch == 0) {
+    throw ConfigurationError("StatsStream needs an epoch of at least one cycle!");
+  }
+
+  std::string format_str = config["format"].as<std::string>("csv");
+  Format format;
+  if (format_str == "csv") {
+    format = Format::CSV;
+  } else if (format_str == "binary") {
+    format = Format::Binary;
+  } else {
+    throw ConfigurationError("Unknown StatsStream format {}! (csv, binary)", format_str);
+  }
+
+  std::string mode_str = config["mode"].as<std::string>("cumulative");
+  if (mode_str != "cumulative" && mode_str != "delta") {
+    throw ConfigurationError("Unknown StatsStream mode {}! (cumulative, delta)", mode_str);
+  }
+
+  std::string path = config["path"].as<std::string>(format == Format::CSV ? "stats_stream.csv" : "stats_stream.bin");
+  return std::make_unique<StatsStream>(path, format, mode_str == "delta", epoch);
+}
+
+void StatsStream::add(const std::string& prefix, const Stats& stats) {
+  if (m_header_written) {
+    throw InitializationError("Stats are added to a StatsStream after its first sample!");
+  }
+  std::vector<const StatWrapperBase*> sorted;
+  for (auto [stat_name, stat_ptr] : stats._registry) {
+    sorted.push_back(stat_ptr);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const StatWrapperBase* a, const StatWrapperBase* b) {
+    return a->get_name() < b->get_name();
+  });
+  for (const StatWrapperBase* stat : sorted) {
+    m_stats.emplace_back(prefix, stat);
+  }
+}
+
+void StatsStream::write_header() {
+  std::vector<double> values;
+  for (const auto& [prefix, stat] : m_stats) {
+    values.clear();
+    stat->sample_to(values);
+    m_widths.push_back(values.size());
+    std::string name = prefix + "." + stat->get_name();
+    if (values.size() == 1) {
+      m_columns.push_back(name);
+    } else {
+      for (size_t i = 0; i < values.size(); i++) {
+        m_columns.push_back(fmt::format("{}[{}]", name, i));
+      }
+    }
+  }
+
+  if (m_format == Format::CSV) {
+    m_file << "clk";
+    for (const auto& column : m_columns) {
+      m_file << "," << column;
+    }
+    m_file << "\n";
+  } else {
+    uint32_t num_columns = m_columns.size();
+    m_file.write("RSTS", 4);
+    m_file.write(reinterpret_cast<const char*>(&num_columns), sizeof(num_columns));
+    for (const auto& column : m_columns) {
+      m_file.write(column.c_str(), column.size() + 1);
+    }
+  }
+  m_last_values.assign(m_columns.size(), 0.0);
+  m_header_written = true;
+}
+
+void StatsStream::sample(uint64_t clk) {
+  if (!m_header_written) {
+    write_header();
+  }
+
+  m_values.clear();
+  for (size_t i = 0; i < m_stats.size(); i++) {
+    size_t begin = m_values.size();
+    m_stats[i].second->sample_to(m_values);
+    // A vector stat that was resized after the first sample keeps its original columns
+    m_values.resize(begin + m_widths[i], 0.0);
+  }
+
+  if (m_delta) {
+    for (size_t i = 0; i < m_values.size(); i++) {
+      std::swap(m_values[i], m_last_values[i]);
+      m_values[i] = m_last_values[i] - m_values[i];
+    }
+  }
+
+  if (m_format == Format::CSV) {
+    m_file << clk;
+    for (double value : m_values) {
+      m_file << "," << value;
+    }
+    m_file << "\n";
+  } else {
+    m_file.write(reinterpret_cast<const char*>(&clk), sizeof(clk));
+    m_file.write(reinterpret_cast<const char*>(m_values.data()), m_values.size() * sizeof(double));
+  }
+  m_file.flush();
+}
+
+
+namespace {
+
+// Whether name matches pattern, where "*" matches any (possibly empty) sequence of characters
+bool glob_match(std::string_view pattern, std::string_view name) {
+  size_t p = 0, n = 0;
+  size_t star = std::string_view::npos, star_n = 0;
+  while (n < name.size()) {
+    if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      star_n = n;
+    } else if (p < pattern.size() && pattern[p] == name[n]) {
+      p++;
+      n++;
+    } else if (star != std::string_view::npos) {
+      p = star + 1;
+      n = ++star_n;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*') {
+    p++;
+  }
+  return p == pattern.size();
+}
+
+std::string trim(const std::string& str) {
+  size_t begin = str.find_first_not_of(" \t");
+  size_t end = str.find_last_not_of(" \t");
+  return begin == std::string::npos ? "" : str.substr(begin, end - begin + 1);
+}
+
+}        // namespace
+
+
+ConvergenceMonitor::ConvergenceMonitor(const std::vector<std::string>& targets, uint64_t batch, int warmup_batches,
+                                       int min_batches, double confidence, double width):
+m_batch(batch), m_warmup_batches(warmup_batches), m_min_batches(min_batches), m_confidence(confidence), m_width(width) {
+  if (targets.empty()) {
+    throw ConfigurationError("Convergence needs at least one target stat!");
+  }
+  if (batch == 0 || warmup_batches < 0 || min_batches < 2) {
+    throw ConfigurationError("Convergence needs a batch of at least one cycle, no negative warmup and at least 2 batches!");
+  }
+  if (confidence <= 0.0 || confidence >= 1.0 || width <= 0.0) {
+    throw ConfigurationError("Convergence needs a confidence in (0, 1) and a positive width (got {} and {})!", confidence, width);
+  }
+  for (const std::string& spec : targets) {
+    m_targets.push_back({.spec = spec});
+  }
+
+  // The standard normal quantile of (1 + confidence) / 2, by bisection
+  double p = (1.0 + confidence) / 2.0;
+  double lo = 0.0, hi = 10.0;
+  for (int i = 0; i < 100; i++) {
+    double mid = (lo + hi) / 2.0;
+    (0.5 * (1.0 + std::erf(mid / std::sqrt(2.0))) < p ? lo : hi) = mid;
+  }
+  m_z = (lo + hi) / 2.0;
+}
+
+std::unique_ptr<ConvergenceMonitor> ConvergenceMonitor::from_config(const YAML::Node& config) {
+  if (!config) {
+    return nullptr;
+  }
+  if (!config["targets"] || !config["targets"].IsSequence()) {
+    throw ConfigurationError("Convergence needs a list of target stats!");
+  }
+  return std::make_unique<ConvergenceMonitor>(
+    config["targets"].as<std::vector<std::string>>(),
+    config["batch"].as<uint64_t>(100000),
+    config["warmup_batches"].as<int>(1),
+    config["min_batches"].as<int>(10),
+    config["confidence"].as<double>(0.95),
+    config["width"].as<double>(0.05)
+  );
+}
+
+void ConvergenceMonitor::add(const std::string& prefix, const Stats& stats) {
+  if (m_resolved) {
+    throw InitializationError("Stats are added to a ConvergenceMonitor after its first batch!");
+  }
+  for (auto [stat_name, stat_ptr] : stats._registry) {
+    m_stats.emplace_back(prefix, stat_ptr);
+  }
+}
+
+std::vector<size_t> ConvergenceMonitor::match(const std::string& pattern) const {
+  std::vector<size_t> matches;
+  for (size_t i = 0; i < m_stats.size(); i++) {
+    const std::string& name = m_stats[i].second->get_name();
+    if (glob_match(pattern, name) || glob_match(pattern, m_stats[i].first + "." + name)) {
+      matches.push_back(i);
+    }
+  }
+  if (matches.empty()) {
+    throw ConfigurationError("Convergence target {} matches no stat!", pattern);
+  }
+  return matches;
+}
+
+void ConvergenceMonitor::resolve() {
+  for (Target& target : m_targets) {
+    size_t slash = target.spec.find('/');
+    target.numerator = match(trim(target.spec.substr(0, slash)));
+    if (slash != std::string::npos) {
+      target.denominator = match(trim(target.spec.substr(slash + 1)));
+    }
+  }
+  m_resolved = true;
+}
+
+double ConvergenceMonitor::sum(const std::vector<size_t>& stats) const {
+  std::vector<double> values;
+  for (size_t i : stats) {
+    m_stats[i].second->sample_to(values);
+  }
+  double total = 0;
+  for (double value : values) {
+    total += value;
+  }
+  return total;
+}
+
+bool ConvergenceMonitor::end_batch(uint64_t clk) {
+  if (!m_resolved) {
+    resolve();
+  }
+  m_num_batches++;
+  bool is_warmup = m_num_batches <= m_warmup_batches;
+
+  bool converged = true;
+  for (Target& target : m_targets) {
+    double numerator = sum(target.numerator);
+    double denominator = target.denominator.empty() ? (double) clk : sum(target.denominator);
+    double delta_denominator = denominator - target.last_denominator;
+    if (!is_warmup && delta_denominator != 0) {
+      target.batches.push_back((numerator - target.last_numerator) / delta_denominator);
+    }
+    target.last_numerator = numerator;
+    target.last_denominator = denominator;
+
+    size_t n = target.batches.size();
+    if (n < (size_t) m_min_batches) {
+      converged = false;
+      continue;
+    }
+    double mean = 0;
+    for (double value : target.batches) {
+      mean += value;
+    }
+    mean /= n;
+    double variance = 0;
+    for (double value : target.batches) {
+      variance += (value - mean) * (value - mean);
+    }
+    variance /= (n - 1);
+    target.mean = mean;
+    target.half_width = m_z * std::sqrt(variance / n);
+    converged &= 2.0 * target.half_width <= m_width * std::abs(mean);
+  }
+  m_last_clk = clk;
+  m_converged = converged;
+  return converged;
+}
+
+void ConvergenceMonitor::report(YAML::Emitter& emitter) const {
+  emitter << YAML::BeginMap;
+  emitter << YAML::Key << "Convergence" << YAML::Value << YAML::BeginMap;
+  emitter << YAML::Key << "converged" << YAML::Value << m_converged;
+  emitter << YAML::Key << "cycles" << YAML::Value << m_last_clk;
+  emitter << YAML::Key << "batches" << YAML::Value << m_num_batches;
+  emitter << YAML::Key << "confidence" << YAML::Value << m_confidence;
+  emitter << YAML::Key << "targets" << YAML::Value << YAML::BeginMap;
+  for (const Target& target : m_targets) {
+    double relative_width = 0.0;
+    if (target.half_width > 0) {
+      relative_width = target.mean != 0 ? 2.0 * target.half_width / std::abs(target.mean) : std::numeric_limits<double>::infinity();
+    }
+    emitter << YAML::Key << target.spec << YAML::Value << YAML::BeginMap;
+    emitter << YAML::Key << "mean" << YAML::Value << target.mean;
+    emitter << YAML::Key << "half_width" << YAML::Value << target.half_width;
+    emitter << YAML::Key << "relative_width" << YAML::Value << relative_width;
+    emitter << YAML::Key << "batches" << YAML::Value << target.batches.size();
+    emitter << YAML::EndMap;
+  }
+  emitter << YAML::EndMap;
+  emitter << YAML::EndMap;
+  emitter << YAML::EndMap;
+}
+
+
+namespace {
+
+// Removes the instance ids ("[Channel 3]") from a component path, appending their trailing numbers to indices
+std::string strip_ids(const std::string& path, std::vector<size_t>& indices) {
+  std::string stripped;
+  size_t pos = 0;
+  while (pos < path.size()) {
+    size_t open = path.find('[', pos);
+    size_t close = open == std::string::npos ? std::string::npos : path.find(']', open);
+    if (close == std::string::npos) {
+      stripped += path.substr(pos);
+      break;
+    }
+    stripped += path.substr(pos, open - pos);
+    std::string_view id(path.data() + open + 1, close - open - 1);
+    size_t digits = id.find_last_not_of("0123456789") + 1;
+    if (digits < id.size()) {
+      indices.push_back(std::stoull(std::string(id.substr(digits))));
+    }
+    pos = close + 1;
+  }
+  return stripped;
+}
+
+// Removes the "_core_N", "_coreN" or "_N" suffix from a stat name, appending N to indices (except for a "_N" suffix
+// when the path already has an index)
+std::string strip_index(const std::string& name, bool has_path_index, std::vector<size_t>& indices) {
+  size_t digits = name.find_last_not_of("0123456789") + 1;
+  if (digits == name.size() || digits == 0) {
+    return name;
+  }
+  size_t index = std::stoull(name.substr(digits));
+  std::string_view base(name.data(), digits);
+  for (std::string_view suffix : {"_core_", "_core"}) {
+    if (base.size() > suffix.size() && base.ends_with(suffix)) {
+      indices.push_back(index);
+      return std::string(base.substr(0, base.size() - suffix.size()));
+    }
+  }
+  if (base.size() > 1 && base.ends_with('_')) {
+    if (!has_path_index) {
+      indices.push_back(index);
+    }
+    return std::string(base.substr(0, base.size() - 1));
+  }
+  return name;
+}
+
+void write_json_string(std::ostream& out, std::string_view str) {
+  out << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if ((unsigned char) c < 0x20) {
+      out << fmt::format("\\u{:04x}", (int) c);
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+// Writes the values of the dimensions of shape from dim on, starting at values[offset], as nested JSON arrays
+void write_json_values(std::ostream& out, const std::vector<uint32_t>& shape, size_t dim, const double* values) {
+  if (dim == shape.size()) {
+    if (std::isfinite(*values)) {
+      out << fmt::format("{}", *values);
+    } else {
+      out << "null";
+    }
+    return;
+  }
+  size_t stride = 1;
+  for (size_t d = dim + 1; d < shape.size(); d++) {
+    stride *= shape[d];
+  }
+  out << '[';
+  for (uint32_t i = 0; i < shape[dim]; i++) {
+    if (i != 0) {
+      out << ',';
+    }
+    write_json_values(out, shape, dim + 1, values + i * stride);
+  }
+  out << ']';
+}
+
+template<typename T>
+void write_raw(std::ostream& out, T value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+}        // namespace
+
+
+StatsTable::StatsTable(const std::string& path, Format format, bool emit_yaml, const std::vector<std::string>& labels):
+m_path(path), m_format(format), m_emit_yaml(emit_yaml), m_labels(labels) {}
+
+std::unique_ptr<StatsTable> StatsTable::from_config(const YAML::Node& config) {
+  if (!config) {
+    return nullptr;
+  }
+
+  std::string format_str = config["format"].as<std::string>("json");
+  Format format;
+  if (format_str == "json") {
+    format = Format::JSON;
+  } else if (format_str == "binary") {
+    format = Format::Binary;
+  } else {
+    throw ConfigurationError("Unknown StatsTable format {}! (json, binary)", format_str);
+  }
+
+  std::string path = config["path"].as<std::string>(format == Format::JSON ? "stats_table.jsonl" : "stats_table.bin");
+  std::vector<std::string> labels = config["labels"].as<std::vector<std::string>>(std::vector<std::string>{});
+  return std::make_unique<StatsTable>(path, format, config["yaml"].as<bool>(true), labels);
+}
+
+void StatsTable::add(const std::string& prefix, const Stats& stats) {
+  std::vector<const StatWrapperBase*> sorted;
+  for (auto [stat_name, stat_ptr] : stats._registry) {
+    sorted.push_back(stat_ptr);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const StatWrapperBase* a, const StatWrapperBase* b) {
+    return a->get_name() < b->get_name();
+  });
+  for (const StatWrapperBase* stat : sorted) {
+    m_stats.emplace_back(prefix, stat);
+  }
+}
+
+std::vector<StatsTable::Column> StatsTable::collect() const {
+  struct Entry {
+    std::vector<size_t> indices;
+    std::vector<double> values;
+    std::string full_name;
+  };
+  std::vector<std::pair<std::string, std::vector<Entry>>> groups;
+  std::unordered_map<std::string, size_t> group_ids;
+
+  for (const auto& [prefix, stat] : m_stats) {
+    Entry entry;
+    stat->sample_to(entry.values);
+    if (entry.values.empty()) {
+      continue;
+    }
+    std::string path = strip_ids(prefix, entry.indices);
+    std::string name = path + "." + strip_index(stat->get_name(), !entry.indices.empty(), entry.indices);
+    entry.full_name = prefix + "." + stat->get_name();
+    auto [it, is_new] = group_ids.try_emplace(name, groups.size());
+    if (is_new) {
+      groups.emplace_back(name, std::vector<Entry>());
+    }
+    groups[it->second].second.push_back(std::move(entry));
+  }
+
+  std::vector<Column> columns;
+  auto add_column = [&](const std::string& name, const std::vector<Entry>& entries) {
+    Column& column = columns.emplace_back();
+    column.name = name;
+    size_t num_dims = entries.front().indices.size();
+    column.shape.assign(num_dims, 0);
+    size_t width = 1;
+    for (const Entry& entry : entries) {
+      for (size_t d = 0; d < num_dims; d++) {
+        column.shape[d] = std::max<uint32_t>(column.shape[d], entry.indices[d] + 1);
+      }
+      width = std::max(width, entry.values.size());
+    }
+    if (width > 1) {
+      column.shape.push_back(width);
+    }
+    size_t size = 1;
+    for (uint32_t dim : column.shape) {
+      size *= dim;
+    }
+    column.values.assign(size, std::numeric_limits<double>::quiet_NaN());
+    for (const Entry& entry : entries) {
+      size_t offset = 0;
+      for (size_t d = 0; d < num_dims; d++) {
+        offset = offset * column.shape[d] + entry.indices[d];
+      }
+      std::copy(entry.values.begin(), entry.values.end(), column.values.begin() + offset * width);
+    }
+  };
+
+  for (const auto& [name, entries] : groups) {
+    // Entries with different dimensions or on the same element cannot share a column
+    bool is_consistent = true;
+    std::vector<std::vector<size_t>> seen;
+    for (const Entry& entry : entries) {
+      is_consistent &= entry.indices.size() == entries.front().indices.size();
+      seen.push_back(entry.indices);
+    }
+    std::sort(seen.begin(), seen.end());
+    is_consistent &= std::adjacent_find(seen.begin(), seen.end()) == seen.end();
+
+    if (is_consistent) {
+      add_column(name, entries);
+    } else {
+      for (const Entry& entry : entries) {
+        Entry alone = entry;
+        alone.indices.clear();
+        add_column(entry.full_name, {alone});
+      }
+    }
+  }
+  return columns;
+}
+
+void StatsTable::write_json(std::ostream& out, const std::string& name, uint64_t clk, const std::vector<Column>& columns) const {
+  out << "{\"name\":";
+  write_json_string(out, name);
+  out << ",\"labels\":[";
+  for (size_t i = 0; i < m_labels.size(); i++) {
+    if (i != 0) {
+      out << ',';
+    }
+    write_json_string(out, m_labels[i]);
+  }
+  out << "],\"cycles\":" << clk << ",\"stats\":{";
+  for (size_t i = 0; i < columns.size(); i++) {
+    if (i != 0) {
+      out << ',';
+    }
+    write_json_string(out, columns[i].name);
+    out << ':';
+    write_json_values(out, columns[i].shape, 0, columns[i].values.data());
+  }
+  out << "}}\n";
+}
+
+void StatsTable::write_binary(std::ostream& out, const std::string& name, uint64_t clk, const std::vector<Column>& columns) const {
+  out.write("RSTT", 4);
+  write_raw<uint32_t>(out, m_labels.size() + 1);
+  out.write(name.c_str(), name.size() + 1);
+  for (const std::string& label : m_labels) {
+    out.write(label.c_str(), label.size() + 1);
+  }
+  write_raw<uint64_t>(out, clk);
+  write_raw<uint32_t>(out, columns.size());
+  for (const Column& column : columns) {
+    out.write(column.name.c_str(), column.name.size() + 1);
+    write_raw<uint32_t>(out, column.shape.size());
+    for (uint32_t dim : column.shape) {
+      write_raw<uint32_t>(out, dim);
+    }
+    out.write(reinterpret_cast<const char*>(column.values.data()), column.values.size() * sizeof(double));
+  }
+}
+
+void StatsTable::append(const std::string& name, uint64_t clk) const {
+  append_row(m_path, row(name, clk));
+}
+
+std::string StatsTable::row(const std::string& name, uint64_t clk) const {
+  std::ostringstream row;
+  if (m_format == Format::JSON) {
+    write_json(row, name, clk, collect());
+  } else {
+    write_binary(row, name, clk, collect());
+  }
+  return row.str();
+}
+
+void StatsTable::append_row(const std::string& path, const std::string& row) {
+  // The runs of a sweep append to the same file
+  static std::mutex file_mutex;
+  std::lock_guard<std::mutex> lock(file_mutex);
+  std::ofstream file(path, std::ios::out | std::ios::app | std::ios::binary);
+  if (!file) {
+    throw ConfigurationError("Cannot open stats table file {}!", path);
+  }
+  file.write(row.data(), row.size());
+}
+
 }        // namespace Ramulator
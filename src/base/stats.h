@@ -4,6 +4,9 @@
 #include <vector>
 #include <string>
 #include <variant>
+#include <fstream>
+#include <type_traits>
+#include <memory>
 
 #include <spdlog/spdlog.h>
 #include <yaml-cpp/yaml.h>
@@ -18,6 +21,9 @@ class Implementation;
 class StatWrapperBase {
   public:
     virtual void emit_to(YAML::Emitter& emitter) = 0;
+    /// Appends the current value(s) of the stat as doubles (nothing for non-arithmetic stats).
+    virtual void sample_to(std::vector<double>& values) const = 0;
+    virtual const std::string& get_name() const = 0;
 };
 
 template<typename T>
@@ -26,6 +32,9 @@ class StatWrapper;
 class Stats {
   template<typename T>
   friend class StatWrapper;
+  friend class StatsStream;
+  friend class ConvergenceMonitor;
+  friend class StatsTable;
   friend YAML::Emitter& operator << (YAML::Emitter& emitter, const Stats& s);
 
   private:
@@ -89,6 +98,249 @@ class StatWrapper : public StatWrapperBase {
       }
 
     };
+
+    void sample_to(std::vector<double>& values) const override {
+      if constexpr (std::is_arithmetic_v<T>) {
+        if        (std::holds_alternative<T*>(_ref)) {
+          values.push_back(static_cast<double>(*(std::get<T*>(_ref))));
+        } else if (std::holds_alternative<std::vector<T>*>(_ref)) {
+          for (const auto _val : *(std::get<std::vector<T>*>(_ref))) {
+            values.push_back(static_cast<double>(_val));
+          }
+        }
+      }
+    };
+
+    const std::string& get_name() const override { return _name; };
+};
+
+
+/**
+ * @brief    Streams snapshots of registered stats to an append-only file, one record per epoch.
+ * @details
+ * Sampling only reads the variables behind the registered stats, so the components are not involved. The columns
+ * (one per scalar stat, one per element of a vector stat) are fixed at the first sample. In delta mode every record
+ * holds the change since the previous record instead of the running value.
+ * 
+ * The CSV format has a header row and then one row per record, starting with the cycle. The binary format starts with
+ * "RSTS", the number of columns (uint32_t) and the NUL-terminated column names, then one record per epoch of the
+ * cycle (uint64_t) and one double per column, all in host byte order.
+ * 
+ */
+class StatsStream {
+  public:
+    enum class Format { CSV, Binary };
+
+  private:
+    std::ofstream m_file;
+    Format m_format;
+    bool m_delta;
+    uint64_t m_epoch;
+
+    std::vector<std::pair<std::string, const StatWrapperBase*>> m_stats;  // (prefix, stat)
+    std::vector<std::string> m_columns;
+    std::vector<size_t> m_widths;         // The number of columns of each stat
+    std::vector<double> m_values;
+    std::vector<double> m_last_values;
+    bool m_header_written = false;
+
+    void write_header();
+
+  public:
+    StatsStream(const std::string& path, Format format, bool delta, uint64_t epoch);
+
+    /**
+     * @brief    Creates a stats stream from its configuration (epoch, path, format, mode), or nullptr if there is none.
+     * 
+     */
+    static std::unique_ptr<StatsStream> from_config(const YAML::Node& config);
+
+    /**
+     * @brief    Adds all stats in the registry, named "<prefix>.<stat>". Must be called before the first sample.
+     * 
+     */
+    void add(const std::string& prefix, const Stats& stats);
+
+    /**
+     * @brief    Snapshots all added stats and appends them as one record of the given cycle.
+     * 
+     */
+    void sample(uint64_t clk);
+
+    /// The number of cycles between two samples.
+    uint64_t get_epoch() const { return m_epoch; };
+};
+
+
+/**
+ * @brief    Stops a simulation once the target stats have converged, estimated by batch means.
+ * @details
+ * Every batch (of batch cycles) ends with a sample of the registered stats. A target is a stat pattern, or a ratio
+ * "numerator / denominator" of two patterns, where "*" matches any characters and a pattern matches the stat names with
+ * and without their "<component path>." prefix. The stats a pattern matches are summed (e.g., over the channels). The
+ * value of a target in a batch is the change of its numerator over the change of its denominator (or over the batch
+ * cycles), so a target like "read_latency_* / num_read_reqs_*" estimates the average read latency. Batches whose
+ * denominator did not change are skipped.
+ *
+ * After warmup_batches batches, the batch values of each target are treated as independent samples. The simulation has
+ * converged when, after at least min_batches batches, the confidence interval of the mean of every target is at most
+ * width times its mean wide (e.g., 0.05 for +-2.5%). report() emits the estimates and their achieved relative widths.
+ *
+ */
+class ConvergenceMonitor {
+  private:
+    struct Target {
+      std::string spec;
+      std::vector<size_t> numerator;        // Indices into m_stats of the matching stats
+      std::vector<size_t> denominator;      // Empty for a rate per cycle
+      double last_numerator = 0;
+      double last_denominator = 0;
+      std::vector<double> batches;
+      double mean = 0;
+      double half_width = 0;
+    };
+
+    uint64_t m_batch;
+    int m_warmup_batches;
+    int m_min_batches;
+    double m_confidence;
+    double m_width;
+    double m_z;                               // Standard normal quantile of the confidence
+
+    std::vector<std::pair<std::string, const StatWrapperBase*>> m_stats;   // (prefix, stat)
+    std::vector<Target> m_targets;
+    bool m_resolved = false;
+    int m_num_batches = 0;
+    uint64_t m_last_clk = 0;
+    bool m_converged = false;
+
+    std::vector<size_t> match(const std::string& pattern) const;
+    void resolve();
+    double sum(const std::vector<size_t>& stats) const;
+
+  public:
+    ConvergenceMonitor(const std::vector<std::string>& targets, uint64_t batch, int warmup_batches, int min_batches,
+                       double confidence, double width);
+
+    /**
+     * @brief    Creates a convergence monitor from its configuration (targets, batch, warmup_batches, min_batches,
+     *           confidence, width), or nullptr if there is none.
+     *
+     */
+    static std::unique_ptr<ConvergenceMonitor> from_config(const YAML::Node& config);
+
+    /**
+     * @brief    Adds all stats in the registry, named "<prefix>.<stat>". Must be called before the first batch.
+     *
+     */
+    void add(const std::string& prefix, const Stats& stats);
+
+    /**
+     * @brief    Ends the batch at cycle clk. Returns true once every target has converged.
+     *
+     */
+    bool end_batch(uint64_t clk);
+
+    /// The number of cycles in a batch.
+    uint64_t get_batch() const { return m_batch; };
+
+    bool is_converged() const { return m_converged; };
+
+    /**
+     * @brief    Emits the estimates of the targets and their confidence intervals as a "Convergence" map.
+     *
+     */
+    void report(YAML::Emitter& emitter) const;
+};
+
+
+/**
+ * @brief    Appends the final stats of a run as one row of a table in compact JSON or a binary columnar format.
+ * @details
+ * The indexed stats are grouped into arrays. A column is named by the component path without the instance ids and the
+ * stat name without its index (e.g., "MemorySystem.Controller.row_hits"), and its dimensions are, in order:
+ *   - the instance ids that end in a number (e.g., "Channel 3" of a controller),
+ *   - the "_core_N" or "_coreN" suffix of the stat name,
+ *   - the "_N" suffix of the stat name, unless the path already has an index (the per-channel stats repeat the channel
+ *     id of their controller),
+ *   - the elements of a vector stat.
+ * Missing elements are null (JSON) or NaN (binary). Stats that would land on the same element keep their own column,
+ * named by their full path. Stats that are not numbers are left out.
+ *
+ * In JSON, every row is one line (JSON Lines) with the "name" of the simulation, its "labels" (e.g., the overrides of a
+ * sweep point), the memory system "cycles" and the "stats" map from column to value or nested array. In the binary
+ * format, every row is a block of host byte order:
+ *   "RSTT", the number of labels (uint32_t) and the NUL-terminated labels (the first is the name), the cycles
+ *   (uint64_t), the number of columns (uint32_t), then per column its NUL-terminated name, its number of dimensions
+ *   (uint32_t), the size of each (uint32_t) and its values in row-major order (double).
+ * The rows of concurrent runs (e.g., the points of a sweep) that append to the same file are written whole, so a sweep
+ * produces one table.
+ *
+ */
+class StatsTable {
+  public:
+    enum class Format { JSON, Binary };
+
+    struct Column {
+      std::string name;
+      std::vector<uint32_t> shape;
+      std::vector<double> values;   // Row-major, NaN if missing
+    };
+
+  private:
+    std::string m_path;
+    Format m_format;
+    bool m_emit_yaml;
+    std::vector<std::string> m_labels;
+
+    std::vector<std::pair<std::string, const StatWrapperBase*>> m_stats;   // (prefix, stat)
+
+    void write_json(std::ostream& out, const std::string& name, uint64_t clk, const std::vector<Column>& columns) const;
+    void write_binary(std::ostream& out, const std::string& name, uint64_t clk, const std::vector<Column>& columns) const;
+
+  public:
+    StatsTable(const std::string& path, Format format, bool emit_yaml, const std::vector<std::string>& labels);
+
+    /**
+     * @brief    Creates a stats table from its configuration (path, format, yaml, labels), or nullptr if there is none.
+     *
+     */
+    static std::unique_ptr<StatsTable> from_config(const YAML::Node& config);
+
+    /**
+     * @brief    Adds all stats in the registry, named "<prefix>.<stat>".
+     *
+     */
+    void add(const std::string& prefix, const Stats& stats);
+
+    /// Whether the YAML stats are still printed.
+    bool emits_yaml() const { return m_emit_yaml; };
+
+    /**
+     * @brief    Groups the current values of all added stats into columns.
+     *
+     */
+    std::vector<Column> collect() const;
+
+    /**
+     * @brief    Appends the current values of all added stats as the row of the run name at cycle clk.
+     *
+     */
+    void append(const std::string& name, uint64_t clk) const;
+
+    /**
+     * @brief    The row append() would write, e.g., for a distributed sweep worker to send it to its coordinator.
+     *
+     */
+    std::string row(const std::string& name, uint64_t clk) const;
+
+    /**
+     * @brief    Appends a whole row to the table file at path.
+     *
+     */
+    static void append_row(const std::string& path, const std::string& row);
+
+    const std::string& get_path() const { return m_path; };
 };
 
 }        // namespace Ramulator
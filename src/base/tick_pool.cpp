@@ -0,0 +1,178 @@
+#include "base/tick_pool.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+namespace {
+
+/**
+ * @brief    Waits until value differs from old: spins for a while, then sleeps on the atomic.
+ *
+ */
+template <class T>
+T wait_for_change(const std::atomic<T>& value, T old, int spin_iterations) {
+  for (int i = 0; i < spin_iterations; i++) {
+    T current = value.load(std::memory_order_acquire);
+    if (current != old) {
+      return current;
+    }
+  }
+  T current = value.load(std::memory_order_acquire);
+  while (current == old) {
+    value.wait(old, std::memory_order_acquire);
+    current = value.load(std::memory_order_acquire);
+  }
+  return current;
+}
+
+}       // namespace
+
+TickPool::TickPool(int num_threads, int num_units, TickFunc tick, const std::vector<int>& cpus):
+m_tick(std::move(tick)), m_num_units(num_units), m_num_threads(std::min(num_threads, num_units)) {
+  if (num_threads < 2) {
+    throw ConfigurationError("The tick pool needs at least two threads (got {})!", num_threads);
+  }
+  if (!cpus.empty() && int(cpus.size()) < m_num_threads) {
+    throw ConfigurationError("The tick pool needs a CPU for each of its {} threads (got {})!", m_num_threads, cpus.size());
+  }
+
+  m_errors.resize(m_num_threads);
+  m_workers.reserve(m_num_threads - 1);
+  for (int i = 1; i < m_num_threads; i++) {
+    m_workers.emplace_back(&TickPool::worker_loop, this, i);
+  }
+
+  // The workers touch nothing before their first epoch, so they are pinned before they allocate anything
+  try {
+    for (int i = 0; i < int(cpus.size()) && i < m_num_threads; i++) {
+      pin(i, cpus[i]);
+    }
+  } catch (...) {
+    stop();
+    throw;
+  }
+}
+
+TickPool::~TickPool() {
+  stop();
+}
+
+void TickPool::stop() {
+  m_stop.store(true);
+  m_epoch.fetch_add(1, std::memory_order_release);
+  m_epoch.notify_all();
+  for (std::thread& worker : m_workers) {
+    worker.join();
+  }
+  m_workers.clear();
+#if defined(__linux__)
+  if (m_is_caller_pinned) {
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &m_caller_affinity);
+    m_is_caller_pinned = false;
+  }
+#endif
+}
+
+void TickPool::pin(int thread_id, int cpu) {
+#if defined(__linux__)
+  if (cpu < 0 || cpu >= CPU_SETSIZE) {
+    throw ConfigurationError("Cannot pin tick pool thread {} to CPU {}!", thread_id, cpu);
+  }
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  pthread_t thread = pthread_self();
+  if (thread_id == 0) {
+    if (!m_is_caller_pinned && pthread_getaffinity_np(thread, sizeof(cpu_set_t), &m_caller_affinity) == 0) {
+      m_is_caller_pinned = true;
+    }
+  } else {
+    thread = m_workers[thread_id - 1].native_handle();
+  }
+  if (pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpu_set) != 0) {
+    throw ConfigurationError("Cannot pin tick pool thread {} to CPU {} (is it online and allowed?)!", thread_id, cpu);
+  }
+#else
+  throw ConfigurationError("Pinning the tick pool threads to CPUs is only supported on Linux!");
+#endif
+}
+
+void TickPool::tick_all() {
+  run(&m_tick, -1);
+}
+
+void TickPool::run_all(const TickFunc& func) {
+  run(&func, -1);
+}
+
+void TickPool::run_on(int unit_id, const TickFunc& func) {
+  if (get_thread(unit_id) == 0) {
+    func(unit_id);
+    return;
+  }
+  run(&func, unit_id);
+}
+
+void TickPool::run(const TickFunc* task, int task_unit) {
+  // Published to the workers by the release of the epoch
+  m_task = task;
+  m_task_unit = task_unit;
+  m_num_done.store(0, std::memory_order_relaxed);
+  m_epoch.fetch_add(1, std::memory_order_release);
+  m_epoch.notify_all();
+
+  tick_units(0);
+
+  int num_workers = m_num_threads - 1;
+  int num_done = m_num_done.load(std::memory_order_acquire);
+  while (num_done != num_workers) {
+    num_done = wait_for_change(m_num_done, num_done, SPIN_ITERATIONS);
+  }
+
+  for (std::exception_ptr& error : m_errors) {
+    if (error) {
+      std::exception_ptr rethrown = error;
+      error = nullptr;
+      std::rethrow_exception(rethrown);
+    }
+  }
+}
+
+void TickPool::worker_loop(int thread_id) {
+  // Not m_epoch.load(): the first tick_all() may already have bumped it when this thread starts
+  uint32_t epoch = 0;
+  while (true) {
+    epoch = wait_for_change(m_epoch, epoch, SPIN_ITERATIONS);
+    if (m_stop.load()) {
+      return;
+    }
+
+    tick_units(thread_id);
+
+    m_num_done.fetch_add(1, std::memory_order_release);
+    m_num_done.notify_one();
+  }
+}
+
+void TickPool::tick_units(int thread_id) {
+  try {
+    if (m_task_unit != -1) {
+      if (get_thread(m_task_unit) == thread_id) {
+        (*m_task)(m_task_unit);
+      }
+      return;
+    }
+    for (int unit_id = thread_id; unit_id < m_num_units; unit_id += m_num_threads) {
+      (*m_task)(unit_id);
+    }
+  } catch (...) {
+    m_errors[thread_id] = std::current_exception();
+  }
+}
+
+}        // namespace Ramulator
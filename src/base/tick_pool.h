@@ -0,0 +1,97 @@
+#ifndef     RAMULATOR_BASE_TICK_POOL_H
+#define     RAMULATOR_BASE_TICK_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace Ramulator {
+
+/**
+ * @brief    Threads that tick independent units (e.g., the channels of a memory system or the cores of a processor) in
+ *           parallel, one step (a cycle or a quantum) at a time.
+ *
+ * @details
+ * Unit u is ticked by thread u % num_threads; the simulation thread acts as thread 0. tick_all() releases the
+ * workers by bumping an epoch counter, ticks its own units, and returns once every worker has reported back, so
+ * each step ends with a barrier. Waiting threads spin briefly and then sleep on the atomics (C++20
+ * wait/notify). An exception thrown while ticking a unit is rethrown by tick_all() on the simulation thread.
+ *
+ * Thread t can be pinned to CPU cpus[t] (on Linux), and run_on() runs a function on the thread of a unit, so that the
+ * state of the unit can be allocated by the thread that ticks it (first touch puts its pages on the NUMA node of
+ * that thread).
+ *
+ */
+class TickPool {
+  public:
+    using TickFunc = std::function<void(int unit_id)>;
+
+  private:
+    static constexpr int SPIN_ITERATIONS = 4096;
+
+    TickFunc m_tick;
+    int m_num_units = 0;
+    int m_num_threads = 0;
+
+    alignas(64) std::atomic<uint32_t> m_epoch = 0;       // Bumped once per step, workers sleep on it
+    alignas(64) std::atomic<int> m_num_done = 0;         // Workers done with the running epoch
+    std::atomic<bool> m_stop = false;
+
+    const TickFunc* m_task = nullptr;                    // What the running epoch runs
+    int m_task_unit = -1;                                // The only unit it runs it for (-1 = every unit)
+
+    std::vector<std::exception_ptr> m_errors;            // First exception of each thread in the running epoch
+    std::vector<std::thread> m_workers;
+
+#if defined(__linux__)
+    cpu_set_t m_caller_affinity;                         // Of the simulation thread, restored when the pool is gone
+    bool m_is_caller_pinned = false;
+#endif
+
+  public:
+    /**
+     * @brief    Starts the workers, and pins thread t to CPU cpus[t] if cpus is not empty.
+     *
+     */
+    TickPool(int num_threads, int num_units, TickFunc tick, const std::vector<int>& cpus = {});
+    ~TickPool();
+
+    /**
+     * @brief    Runs the tick function of every unit once and returns when all of them are done.
+     *
+     */
+    void tick_all();
+
+    /**
+     * @brief    Runs func for every unit on the thread of the unit and returns when all of them are done.
+     *
+     */
+    void run_all(const TickFunc& func);
+
+    /**
+     * @brief    Runs func for one unit on the thread of the unit and returns when it is done.
+     *
+     */
+    void run_on(int unit_id, const TickFunc& func);
+
+    int get_num_threads() const { return m_num_threads; };
+    int get_thread(int unit_id) const { return unit_id % m_num_threads; };
+
+  private:
+    void run(const TickFunc* task, int task_unit);
+    void pin(int thread_id, int cpu);
+    void stop();
+    void worker_loop(int thread_id);
+    void tick_units(int thread_id);
+};
+
+}        // namespace Ramulator
+
+#endif   // RAMULATOR_BASE_TICK_POOL_H
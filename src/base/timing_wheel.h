@@ -0,0 +1,116 @@
+#ifndef     RAMULATOR_BASE_TIMING_WHEEL_H
+#define     RAMULATOR_BASE_TIMING_WHEEL_H
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+
+#include "base/type.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Calendar queue of items that become due at a clock cycle
+ * @details
+ * Items are hashed into a ring of buckets by their due cycle, so draining a cycle only touches the items scheduled for
+ * it instead of everything outstanding. The ring should span the usual scheduling distance (e.g., a fixed latency);
+ * items scheduled further ahead stay in their bucket for the extra rounds. Due items that a consumer refuses (e.g., a
+ * send that failed) stay due, ahead of the items that become due later, and are offered again at the next drain.
+ *
+ */
+template<typename T>
+class TimingWheel {
+  private:
+    struct Entry {
+      Clk_t due;
+      T item;
+    };
+
+    std::vector<std::vector<Entry>> m_buckets;
+    size_t m_mask;
+    Clk_t m_clk = -1;                 // The last cycle drained
+    std::vector<T> m_due;             // Due and not yet consumed, in due order
+    size_t m_size = 0;
+
+  public:
+    /**
+     * @brief    horizon: the largest distance (in cycles) items are usually scheduled ahead of the current cycle.
+     *
+     */
+    explicit TimingWheel(Clk_t horizon = 64) {
+      size_t num_buckets = 1;
+      while (num_buckets <= size_t(horizon)) {
+        num_buckets <<= 1;
+      }
+      m_buckets.resize(num_buckets);
+      m_mask = num_buckets - 1;
+    };
+
+    size_t size() const { return m_size; };
+    bool empty() const { return m_size == 0; };
+
+    /**
+     * @brief    Schedules item to become due at cycle due. Items due before the next drain are due right away.
+     *
+     */
+    void schedule(Clk_t due, T item) {
+      m_size++;
+      if (due <= m_clk) {
+        m_due.push_back(std::move(item));
+        return;
+      }
+      m_buckets[due & m_mask].push_back({due, std::move(item)});
+    };
+
+    /**
+     * @brief    Offers every item due at or before clk, in due (then scheduling) order, to consume(T&), which returns
+     *           whether it took the item. Items scheduled while draining are offered at the next drain.
+     *
+     */
+    template<typename F>
+    void drain(Clk_t clk, F&& consume) {
+      advance(clk);
+
+      size_t num_due = m_due.size();
+      size_t num_kept = 0;
+      for (size_t i = 0; i < num_due; i++) {
+        // consume() may schedule more items, which can reallocate m_due
+        T item = std::move(m_due[i]);
+        if (consume(item)) {
+          m_size--;
+        } else {
+          m_due[num_kept++] = std::move(item);
+        }
+      }
+      // Keep the items scheduled during the drain after the refused ones
+      m_due.erase(m_due.begin() + num_kept, m_due.begin() + num_due);
+    };
+
+  private:
+    // Moves the items due at or before clk into m_due
+    void advance(Clk_t clk) {
+      if (clk <= m_clk) {
+        return;
+      }
+      // Every bucket is visited at most once, even if many cycles have passed since the last drain
+      Clk_t first = std::max(m_clk + 1, clk - Clk_t(m_mask));
+      for (Clk_t c = first; c <= clk; c++) {
+        std::vector<Entry>& bucket = m_buckets[c & m_mask];
+        auto kept_end = std::remove_if(bucket.begin(), bucket.end(), [this, clk](Entry& entry) {
+          if (entry.due > clk) {
+            return false;
+          }
+          m_due.push_back(std::move(entry.item));
+          return true;
+        });
+        bucket.erase(kept_end, bucket.end());
+      }
+      m_clk = clk;
+    };
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_BASE_TIMING_WHEEL_H
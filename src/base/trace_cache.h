@@ -0,0 +1,105 @@
+#ifndef     RAMULATOR_BASE_TRACE_CACHE_H
+#define     RAMULATOR_BASE_TRACE_CACHE_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <filesystem>
+
+#include "base/startup.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Process-wide cache of parsed traces
+ * @details
+ * Every trace file is parsed once per entry type and then shared, read-only, by all the frontends (and cores) that
+ * replay it, e.g., by the configurations of a sweep that run concurrently in one process. A trace requested while it
+ * is being parsed waits for that parse instead of starting another one. The traces stay loaded until the process exits.
+ *
+ * prefetch() starts the parse on the startup pool (see Startup::run()) without waiting for it, so a frontend can parse
+ * all its traces in parallel, and with the rest of the simulation being built, before its cores load() them.
+ *
+ */
+class TraceCache {
+  public:
+    template<typename Entry>
+    using Trace_t = std::shared_ptr<const std::vector<Entry>>;
+
+    /**
+     * @brief    Returns the trace at path, parsed by loader() (which returns a std::vector<Entry>) on the first request.
+     *
+     */
+    template<typename Entry, typename Loader>
+    static Trace_t<Entry> load(const std::string& path, Loader&& loader) {
+      return request<Entry>(path, std::forward<Loader>(loader), false).get();
+    };
+
+    /**
+     * @brief    Starts parsing the trace at path with loader() in the background, unless it is already requested.
+     *
+     */
+    template<typename Entry, typename Loader>
+    static void prefetch(const std::string& path, Loader loader) {
+      request<Entry>(path, std::move(loader), true);
+    };
+
+  private:
+    template<typename Entry>
+    struct Registry {
+      std::mutex mutex;
+      std::map<std::string, std::shared_future<Trace_t<Entry>>> traces;
+    };
+
+    // One per entry type, whatever the loader
+    template<typename Entry>
+    static Registry<Entry>& registry() {
+      static Registry<Entry> registry;
+      return registry;
+    };
+
+    template<typename Entry, typename Loader>
+    static std::shared_future<Trace_t<Entry>> request(const std::string& path, Loader&& loader, bool in_background) {
+      Registry<Entry>& r = registry<Entry>();
+      std::error_code ec;
+      std::string key = std::filesystem::weakly_canonical(path, ec).string();
+      if (ec) {
+        key = path;
+      }
+
+      auto promise = std::make_shared<std::promise<Trace_t<Entry>>>();
+      std::shared_future<Trace_t<Entry>> trace = promise->get_future().share();
+      {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (auto it = r.traces.find(key); it != r.traces.end()) {
+          return it->second;
+        }
+        r.traces.emplace(key, trace);
+      }
+
+      auto parse = [promise, key, loader = std::forward<Loader>(loader), &r]() mutable {
+        try {
+          promise->set_value(std::make_shared<const std::vector<Entry>>(loader()));
+        } catch (...) {
+          // The current waiters see the error, and the next request tries again
+          promise->set_exception(std::current_exception());
+          std::lock_guard<std::mutex> lock(r.mutex);
+          r.traces.erase(key);
+        }
+      };
+      if (in_background) {
+        Startup::run(std::move(parse));
+      } else {
+        parse();
+      }
+      return trace;
+    };
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_BASE_TRACE_CACHE_H
@@ -1,6 +1,10 @@
 #ifndef     RAMULATOR_BASE_TYPE_H
 #define     RAMULATOR_BASE_TYPE_H
 
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
 #include <vector>
 #include <unordered_map>
 #include <string>
@@ -9,9 +13,146 @@
 
 namespace Ramulator {
 
+/**
+ * @brief    A vector of at most N elements stored inline, with the std::vector interface the simulator uses.
+ *
+ * @details
+ * Copying one copies a fixed-size array: there is no heap allocation, and the type is trivially copyable
+ * whenever T is. Growing it past N throws std::length_error.
+ *
+ */
+template<typename T, size_t N>
+class InlineVector {
+  public:
+    using value_type      = T;
+    using size_type       = size_t;
+    using reference       = T&;
+    using const_reference = const T&;
+    using iterator        = T*;
+    using const_iterator  = const T*;
+
+    constexpr InlineVector() = default;
+    constexpr explicit InlineVector(size_t count, const T& value = T()) { resize(count, value); };
+    constexpr InlineVector(std::initializer_list<T> init) {
+      check_capacity(init.size());
+      for (const T& elem : init) {
+        m_data[m_size++] = elem;
+      }
+    };
+    template<typename InputIt> requires (!std::is_integral_v<InputIt>)
+    constexpr InlineVector(InputIt first, InputIt last) {
+      for (; first != last; ++first) {
+        push_back(*first);
+      }
+    };
+
+    static constexpr size_t capacity() { return N; };
+    constexpr size_t size() const { return m_size; };
+    constexpr bool empty() const { return m_size == 0; };
+
+    constexpr T& operator[](size_t idx) { return m_data[idx]; };
+    constexpr const T& operator[](size_t idx) const { return m_data[idx]; };
+    constexpr T& front() { return m_data[0]; };
+    constexpr const T& front() const { return m_data[0]; };
+    constexpr T& back() { return m_data[m_size - 1]; };
+    constexpr const T& back() const { return m_data[m_size - 1]; };
+    constexpr T* data() { return m_data.data(); };
+    constexpr const T* data() const { return m_data.data(); };
+
+    constexpr iterator begin() { return m_data.data(); };
+    constexpr iterator end() { return m_data.data() + m_size; };
+    constexpr const_iterator begin() const { return m_data.data(); };
+    constexpr const_iterator end() const { return m_data.data() + m_size; };
+
+    constexpr void push_back(const T& value) {
+      check_capacity(m_size + 1);
+      m_data[m_size++] = value;
+    };
+    constexpr void pop_back() { m_size--; };
+    constexpr void clear() { m_size = 0; };
+    constexpr void resize(size_t count, const T& value = T()) {
+      check_capacity(count);
+      for (size_t i = m_size; i < count; i++) {
+        m_data[i] = value;
+      }
+      m_size = count;
+    };
+
+    constexpr bool operator==(const InlineVector& other) const {
+      if (m_size != other.m_size) {
+        return false;
+      }
+      for (size_t i = 0; i < m_size; i++) {
+        if (m_data[i] != other.m_data[i]) {
+          return false;
+        }
+      }
+      return true;
+    };
+
+  private:
+    std::array<T, N> m_data {};
+    uint32_t m_size = 0;
+
+    static constexpr void check_capacity(size_t count) {
+      if (count > N) {
+        throw std::length_error("InlineVector capacity exceeded!");
+      }
+    };
+};
+
+/**
+ * @brief    A ring buffer of a fixed size set at runtime (at most N), stored inline, that keeps the latest values pushed.
+ *
+ * @details
+ * push_front() overwrites the oldest value in O(1), and [i] is the i-th most recent value, so [size() - 1] is the
+ * oldest. There is no heap allocation; resizing it past N throws std::length_error.
+ *
+ */
+template<typename T, size_t N>
+class InlineRingBuffer {
+  public:
+    constexpr InlineRingBuffer() = default;
+
+    static constexpr size_t capacity() { return N; };
+    constexpr size_t size() const { return m_size; };
+    constexpr bool empty() const { return m_size == 0; };
+
+    constexpr T& operator[](size_t idx) { return m_data[wrap(m_head + idx)]; };
+    constexpr const T& operator[](size_t idx) const { return m_data[wrap(m_head + idx)]; };
+
+    constexpr void push_front(const T& value) {
+      m_head = (m_head == 0) ? m_size - 1 : m_head - 1;
+      m_data[m_head] = value;
+    };
+    constexpr void clear() { m_size = 0; m_head = 0; };
+    /// Sets the size and fills the buffer with value.
+    constexpr void resize(size_t count, const T& value = T()) {
+      if (count > N) {
+        throw std::length_error("InlineRingBuffer capacity exceeded!");
+      }
+      for (size_t i = 0; i < count; i++) {
+        m_data[i] = value;
+      }
+      m_size = count;
+      m_head = 0;
+    };
+
+  private:
+    std::array<T, N> m_data {};
+    uint32_t m_size = 0;
+    uint32_t m_head = 0;      // Index of the most recent value
+
+    constexpr size_t wrap(size_t idx) const { return (idx >= m_size) ? idx - m_size : idx; };
+};
+
+// Upper bound on the levels of a device organization: the deepest spec in dram/impl has 6 (channel to column).
+// RAMULATOR_DECLARE_SPECS() checks every spec against it at compile time.
+inline constexpr size_t MAX_DRAM_LEVELS = 8;
+
 using Clk_t     = int64_t;            // Clock cycle
 using Addr_t    = int64_t;            // Plain address as seen by the OS
-using AddrVec_t = std::vector<int>;   // Device address vector as is sent to the device from the controller
+using AddrVec_t = InlineVector<int, MAX_DRAM_LEVELS>;   // Device address vector as is sent to the device from the controller
 
 template<typename T>
 using Registry_t = std::unordered_map<std::string, T>;
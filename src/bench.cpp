@@ -0,0 +1,356 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <argparse/argparse.hpp>
+#include <spdlog/spdlog.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fcntl.h>
+#define RAMULATOR_BENCH_FORK
+#endif
+
+#include "base/base.h"
+#include "base/config.h"
+#include "frontend/frontend.h"
+#include "memory_system/memory_system.h"
+
+// Simulator-throughput benchmark: simulates a fixed matrix of configurations (DRAM standard x scheduler x plugins) on
+// SyntheticTraffic, and reports the simulated cycles and requests per second of wall time and the peak RSS of each.
+// Every configuration runs in a child process (where fork() exists), so that its peak RSS is its own.
+
+namespace {
+
+struct Options {
+  std::vector<std::string> drams;
+  std::vector<std::string> schedulers;
+  std::vector<std::string> plugins;
+  std::string pattern = "random";
+  int num_streams = 4;
+  size_t num_requests = 100000;
+  double rate = 0.25;
+  double write_ratio = 0.3;
+  int repeats = 3;
+  bool isolate = true;
+};
+
+struct Sample {
+  int ok = 0;
+  double seconds = 0;
+  uint64_t mem_cycles = 0;
+  long peak_rss_kb = 0;
+  char error[256] = {};
+};
+
+struct Result {
+  std::string dram;
+  std::string scheduler;
+  std::string plugins;
+  std::vector<Sample> samples;
+  std::string error;
+
+  // The sample of median wall time
+  const Sample& median() const {
+    std::vector<const Sample*> sorted;
+    for (const Sample& s : samples) {
+      sorted.push_back(&s);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Sample* a, const Sample* b) { return a->seconds < b->seconds; });
+    return *sorted[sorted.size() / 2];
+  };
+  long peak_rss_kb() const {
+    long rss = 0;
+    for (const Sample& s : samples) {
+      rss = std::max(rss, s.peak_rss_kb);
+    }
+    return rss;
+  };
+};
+
+std::string dram_config(const std::string& dram) {
+  if (dram == "DDR4") {
+    return "    impl: DDR4\n    org: {preset: DDR4_8Gb_x8, channel: 1, rank: 2}\n    timing: {preset: DDR4_2400R}\n";
+  } else if (dram == "DDR5") {
+    return "    impl: DDR5\n    org: {preset: DDR5_16Gb_x8, channel: 1, rank: 2}\n    timing: {preset: DDR5_3200AN}\n";
+  } else if (dram == "HBM3") {
+    return "    impl: HBM3\n    org: {preset: HBM3_2Gb, channel: 1, pseudochannel: 2}\n    timing: {preset: HBM3_2Gbps}\n";
+  }
+  throw Ramulator::ConfigurationError("Unsupported DRAM \"{}\" (expected DDR4, DDR5 or HBM3)!", dram);
+}
+
+std::string plugin_config(const std::string& plugins) {
+  if (plugins == "none") {
+    return "";
+  } else if (plugins == "ecc") {
+    return "      - ControllerPlugin: {impl: ECCPlugin}\n";
+  } else if (plugins == "rowhammer") {
+    return "      - ControllerPlugin: {impl: Graphene, num_table_entries: 64, activation_threshold: 1000, reset_period_ns: 32000000}\n";
+  } else if (plugins == "ecc+rowhammer") {
+    return plugin_config("ecc") + plugin_config("rowhammer");
+  }
+  throw Ramulator::ConfigurationError("Unsupported plugins \"{}\" (expected none, ecc, rowhammer or ecc+rowhammer)!", plugins);
+}
+
+/**
+ * @brief    The configuration of one point of the matrix. BLISS needs the BlockHammer controller and its plugin.
+ *
+ */
+YAML::Node make_config(const Options& opt, const std::string& dram, const std::string& scheduler, const std::string& plugins) {
+  std::string frontend = fmt::format(
+    "Frontend:\n"
+    "  impl: SyntheticTraffic\n"
+    "  clock_ratio: 8\n"
+    "  pattern: {}\n"
+    "  num_streams: {}\n"
+    "  num_requests: {}\n"
+    "  rate: {}\n"
+    "  write_ratio: {}\n"
+    "  footprint: 256MB\n",
+    opt.pattern, opt.num_streams, opt.num_requests, opt.rate, opt.write_ratio);
+
+  std::string controller;
+  if (scheduler == "FRFCFS") {
+    controller =
+      "  impl: GenericDRAM\n"
+      "  clock_ratio: 3\n"
+      "  Controller:\n"
+      "    impl: Generic\n"
+      "    Scheduler: {impl: FRFCFS}\n"
+      "    RefreshManager: {impl: AllBank}\n"
+      "    RowPolicy: {impl: OpenRowPolicy}\n"
+      "    plugins:\n" + plugin_config(plugins);
+  } else if (scheduler == "BLISS") {
+    controller =
+      "  impl: BHDRAMSystem\n"
+      "  clock_ratio: 3\n"
+      "  BHDRAMController:\n"
+      "    impl: BHDRAMController\n"
+      "    BHScheduler: {impl: BLISS}\n"
+      "    RefreshManager: {impl: AllBank}\n"
+      "    RowPolicy: {impl: OpenRowPolicy}\n"
+      "    plugins:\n"
+      "      - ControllerPlugin: {impl: BLISS, blacklist_thresh: 4, unblacklist_cycles: 10000}\n" + plugin_config(plugins);
+  } else {
+    throw Ramulator::ConfigurationError("Unsupported scheduler \"{}\" (expected FRFCFS or BLISS)!", scheduler);
+  }
+
+  std::string memory_system = "MemorySystem:\n" + controller + "  DRAM:\n" + dram_config(dram) + "  AddrMapper: {impl: RoBaRaCoCh}\n";
+  return YAML::Load(frontend + memory_system);
+}
+
+/**
+ * @brief    Simulates the configuration to completion (as ramulator2 does, with the statistics discarded).
+ *
+ */
+Sample simulate(const YAML::Node& config) {
+  Sample sample;
+  std::ostringstream stats;
+  auto start = std::chrono::steady_clock::now();
+
+  auto frontend = Ramulator::Factory::create_frontend(config);
+  auto memory_system = Ramulator::Factory::create_memory_system(config);
+  frontend->set_stats_output(stats);
+  memory_system->set_stats_output(stats);
+  frontend->connect_memory_system(memory_system);
+  memory_system->connect_frontend(frontend);
+
+  Ramulator::ClockSchedule schedule({frontend->get_clock_ratio(), memory_system->get_clock_ratio()});
+  uint64_t mem_clk = 0;
+  schedule.run(
+    [&] {
+      frontend->tick();
+      return frontend->is_finished();
+    },
+    [&] {
+      memory_system->tick();
+      mem_clk++;
+      return false;
+    }
+  );
+  frontend->finalize();
+  memory_system->finalize();
+
+  sample.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  sample.mem_cycles = mem_clk;
+  sample.ok = 1;
+#ifdef RAMULATOR_BENCH_FORK
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+  sample.peak_rss_kb = usage.ru_maxrss / 1024;
+#else
+  sample.peak_rss_kb = usage.ru_maxrss;
+#endif
+#endif
+  return sample;
+}
+
+Sample run_sample(const Options& opt, const YAML::Node& config) {
+  auto run = [&config]() {
+    Sample sample;
+    try {
+      sample = simulate(config);
+    } catch (const std::exception& e) {
+      std::strncpy(sample.error, e.what(), sizeof(sample.error) - 1);
+    }
+    return sample;
+  };
+
+#ifdef RAMULATOR_BENCH_FORK
+  if (opt.isolate) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+      throw std::runtime_error("Cannot create a pipe to the benchmark process!");
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+      close(fds[0]);
+      // Keeps the logs of the components out of the results
+      int null_fd = open("/dev/null", O_WRONLY);
+      dup2(null_fd, STDOUT_FILENO);
+      Sample sample = run();
+      ssize_t written = write(fds[1], &sample, sizeof(sample));
+      _exit(written == sizeof(sample) ? 0 : 1);
+    }
+    close(fds[1]);
+    Sample sample;
+    ssize_t num_read = read(fds[0], &sample, sizeof(sample));
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (num_read != sizeof(sample)) {
+      sample = Sample{};
+      std::snprintf(sample.error, sizeof(sample.error), "The benchmark process ended abnormally (status %d)", status);
+    }
+    return sample;
+  }
+#endif
+  return run();
+}
+
+void print_text(const Options& opt, const std::vector<Result>& results) {
+  fmt::print("{:<6} {:<8} {:<14} {:>12} {:>10} {:>14} {:>14} {:>12}\n",
+             "dram", "sched", "plugins", "mem_cycles", "seconds", "cycles/s", "requests/s", "peak_rss_kb");
+  for (const Result& r : results) {
+    if (!r.error.empty()) {
+      fmt::print("{:<6} {:<8} {:<14} error: {}\n", r.dram, r.scheduler, r.plugins, r.error);
+      continue;
+    }
+    const Sample& s = r.median();
+    fmt::print("{:<6} {:<8} {:<14} {:>12} {:>10.3f} {:>14.0f} {:>14.0f} {:>12}\n",
+               r.dram, r.scheduler, r.plugins, s.mem_cycles, s.seconds, s.mem_cycles / s.seconds,
+               opt.num_streams * opt.num_requests / s.seconds, r.peak_rss_kb());
+  }
+}
+
+void print_json(const Options& opt, const std::vector<Result>& results) {
+  fmt::print("{{\n  \"config\": {{\"pattern\": \"{}\", \"num_streams\": {}, \"num_requests\": {}, \"rate\": {}, \"write_ratio\": {}, \"repeats\": {}, \"isolate\": {}}},\n",
+             opt.pattern, opt.num_streams, opt.num_requests, opt.rate, opt.write_ratio, opt.repeats, opt.isolate);
+  fmt::print("  \"results\": [\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result& r = results[i];
+    const char* sep = (i + 1 < results.size()) ? "," : "";
+    if (!r.error.empty()) {
+      fmt::print("    {{\"dram\": \"{}\", \"scheduler\": \"{}\", \"plugins\": \"{}\", \"error\": \"{}\"}}{}\n",
+                 r.dram, r.scheduler, r.plugins, r.error, sep);
+      continue;
+    }
+    const Sample& s = r.median();
+    fmt::print("    {{\"dram\": \"{}\", \"scheduler\": \"{}\", \"plugins\": \"{}\", \"mem_cycles\": {}, \"seconds\": {:.4f}, "
+               "\"cycles_per_s\": {:.1f}, \"requests_per_s\": {:.1f}, \"peak_rss_kb\": {}}}{}\n",
+               r.dram, r.scheduler, r.plugins, s.mem_cycles, s.seconds, s.mem_cycles / s.seconds,
+               opt.num_streams * opt.num_requests / s.seconds, r.peak_rss_kb(), sep);
+  }
+  fmt::print("  ]\n}}\n");
+}
+
+}       // namespace
+
+
+int main(int argc, char* argv[]) {
+  argparse::ArgumentParser program("ramulator_bench", "2.0");
+  program.add_argument("-d", "--drams").nargs(argparse::nargs_pattern::at_least_one)
+    .default_value(std::vector<std::string>{"DDR4", "DDR5", "HBM3"})
+    .help("DRAM standards: DDR4, DDR5, HBM3.");
+  program.add_argument("-s", "--schedulers").nargs(argparse::nargs_pattern::at_least_one)
+    .default_value(std::vector<std::string>{"FRFCFS", "BLISS"})
+    .help("Schedulers: FRFCFS (Generic controller), BLISS (BlockHammer controller).");
+  program.add_argument("-p", "--plugins").nargs(argparse::nargs_pattern::at_least_one)
+    .default_value(std::vector<std::string>{"none", "ecc", "rowhammer", "ecc+rowhammer"})
+    .help("Controller plugins: none, ecc (ECCPlugin), rowhammer (Graphene), ecc+rowhammer.");
+  program.add_argument("--pattern").default_value(std::string("random"))
+    .help("SyntheticTraffic pattern of the generated requests.");
+  program.add_argument("--num_streams").scan<'i', int>().default_value(4)
+    .help("SyntheticTraffic streams (cores).");
+  program.add_argument("--num_requests").scan<'u', size_t>().default_value((size_t) 100000)
+    .help("Requests per stream.");
+  program.add_argument("--rate").scan<'g', double>().default_value(0.25)
+    .help("Requests per frontend cycle per stream.");
+  program.add_argument("--write_ratio").scan<'g', double>().default_value(0.3)
+    .help("Fraction of writes.");
+  program.add_argument("--repeats").scan<'i', int>().default_value(3)
+    .help("Runs per configuration; the run of median wall time is reported.");
+  program.add_argument("--no_isolate").default_value(false).implicit_value(true)
+    .help("Run the configurations in this process (the peak RSS is then that of the process so far, and the logs of the components go to stdout).");
+  program.add_argument("--json").default_value(false).implicit_value(true)
+    .help("Print the results as JSON.");
+
+  Options opt;
+  try {
+    program.parse_args(argc, argv);
+    opt.drams = program.get<std::vector<std::string>>("--drams");
+    opt.schedulers = program.get<std::vector<std::string>>("--schedulers");
+    opt.plugins = program.get<std::vector<std::string>>("--plugins");
+    opt.pattern = program.get<std::string>("--pattern");
+    opt.num_streams = program.get<int>("--num_streams");
+    opt.num_requests = program.get<size_t>("--num_requests");
+    opt.rate = program.get<double>("--rate");
+    opt.write_ratio = program.get<double>("--write_ratio");
+    opt.repeats = program.get<int>("--repeats");
+    opt.isolate = !program.get<bool>("--no_isolate");
+    if (opt.num_streams < 1 || opt.num_requests < 1 || opt.repeats < 1) {
+      throw std::runtime_error("num_streams, num_requests and repeats must be positive!");
+    }
+  }
+  catch (const std::runtime_error& err) {
+    spdlog::error(err.what());
+    std::cerr << program;
+    std::exit(1);
+  }
+
+  std::vector<Result> results;
+  for (const std::string& dram : opt.drams) {
+    for (const std::string& scheduler : opt.schedulers) {
+      for (const std::string& plugins : opt.plugins) {
+        Result& r = results.emplace_back(Result{dram, scheduler, plugins});
+        try {
+          YAML::Node config = make_config(opt, dram, scheduler, plugins);
+          for (int i = 0; i < opt.repeats && r.error.empty(); i++) {
+            Sample sample = run_sample(opt, config);
+            if (!sample.ok) {
+              r.error = sample.error;
+            }
+            r.samples.push_back(sample);
+          }
+        } catch (const std::runtime_error& err) {
+          r.error = err.what();
+        }
+      }
+    }
+  }
+
+  if (program.get<bool>("--json")) {
+    print_json(opt, results);
+  } else {
+    print_text(opt, results);
+  }
+  bool has_error = std::any_of(results.begin(), results.end(), [](const Result& r) { return !r.error.empty(); });
+  return has_error ? 1 : 0;
+}
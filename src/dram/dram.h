@@ -4,11 +4,16 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
 #include <functional>
+#include <span>
+#include <cstddef>
 
 #include "base/base.h"
 #include "dram/spec.h"
 #include "dram/node.h"
+#include "dram/subarray_timing.h"
+#include "dram/link_retry.h"
 
 namespace Ramulator {
 
@@ -24,6 +29,40 @@ class IDRAM : public Clocked<IDRAM> {
     Organization m_organization;        // The organization of the device (density, dq, levels)
     int m_channel_width = -1;           // Channel width (should be set by the implementation's config)
 
+    // Flat bank ids number the banks of a channel, from the rank level (or the level below the channel, without ranks)
+    // down to the bank level. The implementation calls set_flat_bank_strides() once its organization is set.
+    int m_flat_bank_first_level = -1;
+    int m_flat_bank_last_level = -1;
+    std::vector<int> m_flat_bank_strides;   // Per level from the first to the bank level, its weight in the flat bank id
+    int m_num_flat_banks = -1;              // Banks per channel
+
+    void set_flat_bank_strides() {
+      m_flat_bank_first_level = m_levels.contains("rank") ? m_levels("rank") : 1;
+      m_flat_bank_last_level = m_levels("bank");
+      m_flat_bank_strides.assign(m_flat_bank_last_level - m_flat_bank_first_level + 1, 1);
+      for (int level = m_flat_bank_last_level - 1; level >= m_flat_bank_first_level; level--) {
+        int i = level - m_flat_bank_first_level;
+        m_flat_bank_strides[i] = m_flat_bank_strides[i + 1] * m_organization.count[level + 1];
+      }
+      m_num_flat_banks = m_flat_bank_strides[0] * m_organization.count[m_flat_bank_first_level];
+    };
+
+    /**
+     * @brief     The flat id of the bank of addr_vec in its channel, or -1 if addr_vec has a wildcard down to the bank
+     *            level (e.g., an all-bank refresh).
+     * 
+     */
+    int flat_bank_id(const AddrVec_t& addr_vec) const {
+      // No early exit, so the loop over the few levels has no data-dependent branch
+      int flat_bank = 0;
+      bool is_wildcard = false;
+      for (int level = m_flat_bank_first_level; level <= m_flat_bank_last_level; level++) {
+        is_wildcard |= addr_vec[level] < 0;
+        flat_bank += addr_vec[level] * m_flat_bank_strides[level - m_flat_bank_first_level];
+      }
+      return is_wildcard ? -1 : flat_bank;
+    };
+
 
   /************************************************
    *             Requests & Commands
@@ -36,8 +75,78 @@ class IDRAM : public Clocked<IDRAM> {
     SpecDef m_requests;                                     // The definition of all requests supported
     SpecLUT<Command_t> m_request_translations{m_requests};  // A LUT of the final DRAM commands needed by every request
 
-    // TODO: make this a priority queue
-    std::vector<FutureAction> m_future_actions;  // A vector of requests that requires future state changes
+    bool m_dual_command_bus = false;    // Whether row and column commands have separate command buses (e.g., HBM), so a controller may issue one of each per cycle
+
+    FutureActionQueue m_future_actions;          // The requests that require future state changes, by their cycle
+    std::mutex m_future_actions_mutex;           // Controllers of different channels may issue commands concurrently
+
+    /**
+     * @brief     Queues a future state change. Safe to call from the threads that tick different channels; tick()
+     *            handles the queued actions on the simulation thread.
+     * 
+     */
+    void add_future_action(FutureAction action) {
+      if (!m_channel_clks.empty()) {
+        m_channel_future_actions[action.addr_vec[0]].push(std::move(action));
+        return;
+      }
+      std::lock_guard<std::mutex> lock(m_future_actions_mutex);
+      m_future_actions.push(std::move(action));
+    };
+
+    /**
+     * @brief     Handles the queued future actions that are due at clk, on the simulation thread.
+     * 
+     */
+    void handle_future_actions(Clk_t clk) {
+      m_future_actions.pop_due(clk, [this](const FutureAction& action) {
+        handle_future_action(action.cmd, action.addr_vec);
+      });
+    };
+
+    /**
+     * @brief     Applies a future state change once its cycle is reached. Devices that queue future actions override it.
+     * 
+     */
+    virtual void handle_future_action(int command, const AddrVec_t& addr_vec) { };
+
+  /************************************************
+   *              Per-Channel Clocks
+   ***********************************************/
+  public:
+    /**
+     * @brief     Lets every channel keep its own clock, advanced by tick_channel() instead of tick().
+     * @details
+     * For memory systems whose channels advance independently for a few cycles at a time. The future actions of
+     * a channel are then queued and handled with its clock.
+     * 
+     */
+    void enable_channel_clocks() {
+      int num_channels = get_level_size("channel");
+      m_channel_clks.assign(num_channels, m_clk);
+      m_channel_future_actions.resize(num_channels);
+    };
+
+    /**
+     * @brief     Advances the clock of one channel and handles its due future actions. Only touches that channel.
+     * 
+     */
+    void tick_channel(int channel_id) {
+      Clk_t clk = ++m_channel_clks[channel_id];
+      m_channel_future_actions[channel_id].pop_due(clk, [this](const FutureAction& action) {
+        handle_future_action(action.cmd, action.addr_vec);
+      });
+    };
+
+    /**
+     * @brief     The current cycle of a channel (the top level of every address vector).
+     * 
+     */
+    Clk_t get_clk(int channel_id) const { return m_channel_clks.empty() ? m_clk : m_channel_clks[channel_id]; };
+
+  protected:
+    std::vector<Clk_t> m_channel_clks;                              // Empty unless enable_channel_clocks() was called
+    std::vector<FutureActionQueue> m_channel_future_actions;
 
   /************************************************
    *                Node States
@@ -55,8 +164,13 @@ class IDRAM : public Clocked<IDRAM> {
     SpecLUT<int> m_timing_vals{m_timings};  // The LUT of the values for each timing constraints
 
     TimingCons m_timing_cons;           // The actual timing constraints used by Ramulator's DRAM model
+    TimingConsTable m_timing_cons_table;  // The same constraints flattened for update_timing() (built by populate_timingcons())
 
     Clk_t m_read_latency = -1;          // Number of cycles needed between issuing RD command and receiving data.
+    bool m_flat_timing = false;         // Whether the nodes keep their timing state in per-channel flat tables (see FlatTimingTable)
+    bool m_ready_clk_cache = false;     // Whether the channels memoize the ready cycles of their nodes (see ReadyClkCache)
+    std::unique_ptr<SubarrayTiming> m_subarrays;  // The row command timing per subarray, only with subarray-level parallelism (see populate_subarrays())
+    std::unique_ptr<LinkRetry> m_link_retry;      // The data link errors and replays, only with a link error model (see populate_link_retry())
 
   /***********************************************
    *                   Power
@@ -77,6 +191,36 @@ class IDRAM : public Clocked<IDRAM> {
     double s_total_cmd_energy = 0;        // Total command energy consumed by the device
     double s_total_energy = 0;            // Total energy consumed by the device
 
+    Clk_t m_power_epoch = 0;              // Cycles between two updates of the energy stats (0 = only at the end)
+    double s_epoch_power = 0;             // Average power of the device over the last epoch (mW)
+
+    /**
+     * @brief     Recomputes the energy stats of every rank and of the device from the command counters and the
+     *            active/idle cycles up to the current cycle. Devices with the DRAMPower model override it.
+     *
+     */
+    virtual void compute_energy() { };
+
+    /**
+     * @brief     Every power epoch, updates the energy stats and the average power of each rank over the epoch, so
+     *            that a StatsStream with the same epoch records the power over time.
+     *
+     */
+    void tick_power_epoch() {
+      if (m_power_epoch == 0 || m_clk % m_power_epoch != 0) {
+        return;
+      }
+      compute_energy();
+      // Energies are in nJ, so nJ / ns = W
+      double epoch_ns = m_power_epoch * m_timing_vals("tCK_ps") / 1000.0;
+      s_epoch_power = 0;
+      for (PowerStats& rank_stats : m_power_stats) {
+        rank_stats.epoch_power = (rank_stats.total_energy - rank_stats.epoch_start_energy) / epoch_ns * 1E3;
+        rank_stats.epoch_start_energy = rank_stats.total_energy;
+        s_epoch_power += rank_stats.epoch_power;
+      }
+    };
+
   /************************************************
    *          Device Behavior Interface
    ***********************************************/   
@@ -108,6 +252,19 @@ class IDRAM : public Clocked<IDRAM> {
      */
     virtual bool check_ready(int command, const AddrVec_t& addr_vec) = 0;
 
+    /**
+     * @brief     Earliest cycle at which the device could accept the command, given the commands issued so far.
+     * @details
+     * check_ready() holds exactly when this is at most the current cycle. Issuing commands only ever delays it, so as
+     * long as the prerequisite of a request does not change (see get_state_version()) it is a lower bound on the cycle
+     * the request becomes ready. The default only knows whether the command is ready now.
+     * 
+     */
+    virtual Clk_t get_ready_clk(int command, const AddrVec_t& addr_vec) {
+      Clk_t clk = get_clk(addr_vec[0]);
+      return check_ready(command, addr_vec) ? clk : clk + 1;
+    };
+
     /**
      * @brief     Checks whether the command will result in a rowbuffer hit
      * @details
@@ -123,6 +280,17 @@ class IDRAM : public Clocked<IDRAM> {
      */
     virtual bool check_node_open(int command, const AddrVec_t& addr_vec) = 0;
 
+    /**
+     * @brief     Returns a version of the device states that the prerequisite of a command to addr_vec depends on
+     * @details
+     * The version changes whenever a command or a future action updates the state of a node on the path of addr_vec,
+     * so a prerequisite returned by get_preq_command() holds until the version changes. -1 means that the version is
+     * unknown (e.g., addr_vec has wildcards, or the prerequisites of the device also depend on time) and the prerequisite
+     * has to be recomputed every time.
+     * 
+     */
+    virtual int64_t get_state_version(const AddrVec_t& addr_vec) { return -1; };
+
     /**
      * @brief     An universal interface for the host to change DRAM configurations on the fly
      * @details
@@ -133,6 +301,14 @@ class IDRAM : public Clocked<IDRAM> {
      */
     virtual void notify(std::string_view key, uint64_t value) {};
 
+    /**
+     * @brief     Builds the nodes of a channel again on the calling thread, which will tick the channel, so that their
+     *            memory is local to it, and returns the memory of the nodes (empty if the device cannot). Only before
+     *            the channel is used (see rebuild_channel()).
+     *
+     */
+    virtual std::span<const std::byte> place_channel(int channel_id) { return {}; };
+
     /**
      * @brief     
     */
@@ -153,6 +329,7 @@ class IDRAM : public Clocked<IDRAM> {
 };
 
 #define RAMULATOR_DECLARE_SPECS() \
+  static_assert(m_levels.size() <= AddrVec_t::capacity(), "The organization has more levels than AddrVec_t can hold!"); \
   IDRAM::m_internal_prefetch_size = m_internal_prefetch_size; \
   IDRAM::m_levels = m_levels; \
   IDRAM::m_commands = m_commands; \
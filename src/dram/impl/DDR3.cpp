@@ -3,7 +3,7 @@
 
 namespace Ramulator {
 
-class DDR3 : public IDRAM, public Implementation {
+class DDR3 : public IDRAM, public Implementation, public Checkpointable {
   RAMULATOR_REGISTER_IMPLEMENTATION(IDRAM, DDR3, "DDR3", "DDR3 Device Model")
 
   public:
@@ -145,9 +145,27 @@ class DDR3 : public IDRAM, public Implementation {
       m_clk++;
     };
 
+    // The open rows of all channels
+    void save_checkpoint(std::ostream& out) override {
+      Checkpoint::write(out, m_organization.count);
+      for (auto channel : m_channels) {
+        channel->save_open_rows(out, m_states["Opened"]);
+      }
+    };
+
+    void load_checkpoint(std::istream& in) override {
+      if (Checkpoint::read_vector<int>(in) != m_organization.count) {
+        throw ConfigurationError("Checkpoint was saved with a different DRAM organization!");
+      }
+      for (auto channel : m_channels) {
+        channel->load_open_rows(in, m_states["Opened"]);
+      }
+    };
+
     void init() override {
       RAMULATOR_DECLARE_SPECS();
       set_organization();
+      set_flat_bank_strides();
       set_timing_vals();
 
       set_actions();
@@ -160,28 +178,38 @@ class DDR3 : public IDRAM, public Implementation {
 
     void issue_command(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      m_channels[channel_id]->update_timing(command, addr_vec, m_clk);
-      m_channels[channel_id]->update_states(command, addr_vec, m_clk);
+      m_channels[channel_id]->update_timing(command, addr_vec, get_clk(channel_id));
+      m_channels[channel_id]->update_states(command, addr_vec, get_clk(channel_id));
     };
 
     int get_preq_command(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->get_preq_command(command, addr_vec, m_clk);
+      return m_channels[channel_id]->get_preq_command(command, addr_vec, get_clk(channel_id));
     };
 
     bool check_ready(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->check_ready(command, addr_vec, m_clk);
+      return m_channels[channel_id]->check_ready(command, addr_vec, get_clk(channel_id));
+    };
+
+    Clk_t get_ready_clk(int command, const AddrVec_t& addr_vec) override {
+      int channel_id = addr_vec[m_levels["channel"]];
+      return m_channels[channel_id]->get_ready_clk(command, addr_vec);
     };
 
     bool check_rowbuffer_hit(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->check_rowbuffer_hit(command, addr_vec, m_clk);
+      return m_channels[channel_id]->check_rowbuffer_hit(command, addr_vec, get_clk(channel_id));
     };
     
     bool check_node_open(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->check_node_open(command, addr_vec, m_clk);
+      return m_channels[channel_id]->check_node_open(command, addr_vec, get_clk(channel_id));
+    };
+
+    int64_t get_state_version(const AddrVec_t& addr_vec) override {
+      int channel_id = addr_vec[m_levels["channel"]];
+      return m_channels[channel_id]->get_state_version(addr_vec);
     };
 
   private:
@@ -435,12 +463,18 @@ class DDR3 : public IDRAM, public Implementation {
 
 
     void create_nodes() {
+      m_flat_timing = param<bool>("flat_timing").desc("Keep the timing state of each channel in flat per-level tables instead of the node tree").default_val(false);
+      m_ready_clk_cache = param<bool>("ready_clk_cache").desc("Memoize the earliest ready cycle of each command and node until the next command to the channel").default_val(true);
       int num_channels = m_organization.count[m_levels["channel"]];
       for (int i = 0; i < num_channels; i++) {
         Node* channel = new Node(this, nullptr, 0, i);
         m_channels.push_back(channel);
       }
     };
+
+    std::span<const std::byte> place_channel(int channel_id) override {
+      return rebuild_channel(this, m_channels, channel_id);
+    };
 };
 
 
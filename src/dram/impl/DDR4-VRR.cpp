@@ -3,7 +3,7 @@
 
 namespace Ramulator {
 
-class DDR4VRR : public IDRAM, public Implementation {
+class DDR4VRR : public IDRAM, public Implementation, public Checkpointable {
   RAMULATOR_REGISTER_IMPLEMENTATION(IDRAM, DDR4VRR, "DDR4-VRR", "DDR4 with Victim Row Refresh")
   private:
     int m_RH_radius = -1;
@@ -196,18 +196,33 @@ class DDR4VRR : public IDRAM, public Implementation {
       m_clk++;
 
       // Check if there is any future action at this cycle
-      for (int i = m_future_actions.size() - 1; i >= 0; i--) {
-        auto& future_action = m_future_actions[i];
-        if (future_action.clk == m_clk) {
-          handle_future_action(future_action.cmd, future_action.addr_vec);
-          m_future_actions.erase(m_future_actions.begin() + i);
-        }
+      handle_future_actions(m_clk);
+
+      // Update the energy stats at the end of every power epoch
+      tick_power_epoch();
+    };
+
+    // The open rows of all channels
+    void save_checkpoint(std::ostream& out) override {
+      Checkpoint::write(out, m_organization.count);
+      for (auto channel : m_channels) {
+        channel->save_open_rows(out, m_states["Opened"]);
+      }
+    };
+
+    void load_checkpoint(std::istream& in) override {
+      if (Checkpoint::read_vector<int>(in) != m_organization.count) {
+        throw ConfigurationError("Checkpoint was saved with a different DRAM organization!");
+      }
+      for (auto channel : m_channels) {
+        channel->load_open_rows(in, m_states["Opened"]);
       }
     };
 
     void init() override {
       RAMULATOR_DECLARE_SPECS();
       set_organization();
+      set_flat_bank_strides();
       set_timing_vals();
 
       set_actions();
@@ -221,23 +236,24 @@ class DDR4VRR : public IDRAM, public Implementation {
 
     void issue_command(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      m_channels[channel_id]->update_timing(command, addr_vec, m_clk);
-      m_channels[channel_id]->update_powers(command, addr_vec, m_clk);
-      m_channels[channel_id]->update_states(command, addr_vec, m_clk);
+      m_channels[channel_id]->update_timing(command, addr_vec, get_clk(channel_id));
+      m_channels[channel_id]->update_powers(command, addr_vec, get_clk(channel_id));
+      m_channels[channel_id]->update_states(command, addr_vec, get_clk(channel_id));
 
       // Check if the command requires future action
       check_future_action(command, addr_vec);
     };
 
     void check_future_action(int command, const AddrVec_t& addr_vec) {
+      Clk_t clk = get_clk(addr_vec[m_levels["channel"]]);
       switch (command) {
         case m_commands("REFab"):
           // REFab command requires future action after nRFC cycles
-          m_future_actions.push_back({command, addr_vec, m_clk + m_timing_vals("nRFC") - 1});
+          add_future_action({command, addr_vec, clk + m_timing_vals("nRFC") - 1});
           break;
         case m_commands("VRR"):
           // Check if there is any bank that is not in the closed state
-          m_future_actions.push_back({command, addr_vec, m_clk + m_timing_vals("nVRR") - 1});
+          add_future_action({command, addr_vec, clk + m_timing_vals("nVRR") - 1});
           break;
         default:
           // Other commands do not require future actions
@@ -245,16 +261,16 @@ class DDR4VRR : public IDRAM, public Implementation {
       }
     }
 
-    void handle_future_action(int command, const AddrVec_t& addr_vec) {
+    void handle_future_action(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
       switch (command) {
         case m_commands("REFab"):
-          m_channels[channel_id]->update_powers(m_commands("REFab_end"), addr_vec, m_clk);
-          m_channels[channel_id]->update_states(m_commands("REFab_end"), addr_vec, m_clk);
+          m_channels[channel_id]->update_powers(m_commands("REFab_end"), addr_vec, get_clk(channel_id));
+          m_channels[channel_id]->update_states(m_commands("REFab_end"), addr_vec, get_clk(channel_id));
           break;
         case m_commands("VRR"):
-          m_channels[channel_id]->update_powers(m_commands("VRR_end"), addr_vec, m_clk);
-          m_channels[channel_id]->update_states(m_commands("VRR_end"), addr_vec, m_clk);
+          m_channels[channel_id]->update_powers(m_commands("VRR_end"), addr_vec, get_clk(channel_id));
+          m_channels[channel_id]->update_states(m_commands("VRR_end"), addr_vec, get_clk(channel_id));
           break;
         default:
           // Other commands do not require future actions
@@ -264,22 +280,32 @@ class DDR4VRR : public IDRAM, public Implementation {
 
     int get_preq_command(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->get_preq_command(command, addr_vec, m_clk);
+      return m_channels[channel_id]->get_preq_command(command, addr_vec, get_clk(channel_id));
     };
 
     bool check_ready(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->check_ready(command, addr_vec, m_clk);
+      return m_channels[channel_id]->check_ready(command, addr_vec, get_clk(channel_id));
+    };
+
+    Clk_t get_ready_clk(int command, const AddrVec_t& addr_vec) override {
+      int channel_id = addr_vec[m_levels["channel"]];
+      return m_channels[channel_id]->get_ready_clk(command, addr_vec);
     };
 
     bool check_rowbuffer_hit(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->check_rowbuffer_hit(command, addr_vec, m_clk);
+      return m_channels[channel_id]->check_rowbuffer_hit(command, addr_vec, get_clk(channel_id));
     };
     
     bool check_node_open(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->check_node_open(command, addr_vec, m_clk);
+      return m_channels[channel_id]->check_node_open(command, addr_vec, get_clk(channel_id));
+    };
+
+    int64_t get_state_version(const AddrVec_t& addr_vec) override {
+      int channel_id = addr_vec[m_levels["channel"]];
+      return m_channels[channel_id]->get_state_version(addr_vec);
     };
 
   private:
@@ -603,6 +629,7 @@ class DDR4VRR : public IDRAM, public Implementation {
       }
       
       m_power_debug = param<bool>("power_debug").default_val(false);
+      m_power_epoch = param<Clk_t>("power_epoch").desc("Cycles between two updates of the energy stats and the epoch power (0 = only at the end).").default_val(0);
 
       // TODO: Check for multichannel configs.
       int num_channels = m_organization.count[m_levels["channel"]];
@@ -635,6 +662,9 @@ class DDR4VRR : public IDRAM, public Implementation {
       register_stat(s_total_background_energy).name("total_background_energy");
       register_stat(s_total_cmd_energy).name("total_cmd_energy");
       register_stat(s_total_energy).name("total_energy");
+      if (m_power_epoch > 0) {
+        register_stat(s_epoch_power).name("epoch_power_mW");
+      }
       register_stat(s_total_vrr_energy).name("total_vrr_energy");
       
       for (auto& power_stat : m_power_stats){
@@ -645,10 +675,21 @@ class DDR4VRR : public IDRAM, public Implementation {
         register_stat(power_stat.pre_background_energy).name("pre_background_energy_rank{}", power_stat.rank_id);
         register_stat(power_stat.active_cycles).name("active_cycles_rank{}", power_stat.rank_id);
         register_stat(power_stat.idle_cycles).name("idle_cycles_rank{}", power_stat.rank_id);
+        if (m_power_epoch > 0) {
+          register_stat(power_stat.act_cmd_energy).name("act_cmd_energy_rank{}", power_stat.rank_id);
+          register_stat(power_stat.pre_cmd_energy).name("pre_cmd_energy_rank{}", power_stat.rank_id);
+          register_stat(power_stat.rd_cmd_energy).name("rd_cmd_energy_rank{}", power_stat.rank_id);
+          register_stat(power_stat.wr_cmd_energy).name("wr_cmd_energy_rank{}", power_stat.rank_id);
+          register_stat(power_stat.ref_cmd_energy).name("ref_cmd_energy_rank{}", power_stat.rank_id);
+          register_stat(power_stat.other_cmd_energy).name("other_cmd_energy_rank{}", power_stat.rank_id);
+          register_stat(power_stat.epoch_power).name("epoch_power_mW_rank{}", power_stat.rank_id);
+        }
       }
     }
 
     void create_nodes() {
+      m_flat_timing = param<bool>("flat_timing").desc("Keep the timing state of each channel in flat per-level tables instead of the node tree").default_val(false);
+      m_ready_clk_cache = param<bool>("ready_clk_cache").desc("Memoize the earliest ready cycle of each command and node until the next command to the channel").default_val(true);
       int num_channels = m_organization.count[m_levels["channel"]];
       for (int i = 0; i < num_channels; i++) {
         Node* channel = new Node(this, nullptr, 0, i);
@@ -656,10 +697,23 @@ class DDR4VRR : public IDRAM, public Implementation {
       }
     }
 
+    std::span<const std::byte> place_channel(int channel_id) override {
+      return rebuild_channel(this, m_channels, channel_id);
+    }
+
     void finalize() override {
+      compute_energy();
+    }
+
+    void compute_energy() override {
       if (!m_drampower_enable)
         return;
-        
+
+      // Recomputed from the counters
+      s_total_background_energy = 0;
+      s_total_cmd_energy = 0;
+      s_total_energy = 0;
+
       int num_channels = m_organization.count[m_levels["channel"]];
       int num_ranks = m_organization.count[m_levels["rank"]];
       for (int i = 0; i < num_channels; i++) {
@@ -686,33 +740,35 @@ class DDR4VRR : public IDRAM, public Implementation {
                                             * rank_stats.idle_cycles * tCK_ns / 1E3;
 
 
-      double act_cmd_energy  = (VE("VDD") * (CE("IDD0") - CE("IDD3N")) + VE("VPP") * (CE("IPP0") - CE("IPP3N"))) 
+      rank_stats.act_cmd_energy  = (VE("VDD") * (CE("IDD0") - CE("IDD3N")) + VE("VPP") * (CE("IPP0") - CE("IPP3N"))) 
                                       * rank_stats.cmd_counters[m_cmds_counted("ACT")] * TS("nRAS") * tCK_ns / 1E3;
 
-      double pre_cmd_energy  = (VE("VDD") * (CE("IDD0") - CE("IDD2N")) + VE("VPP") * (CE("IPP0") - CE("IPP2N"))) 
+      rank_stats.pre_cmd_energy  = (VE("VDD") * (CE("IDD0") - CE("IDD2N")) + VE("VPP") * (CE("IPP0") - CE("IPP2N"))) 
                                       * rank_stats.cmd_counters[m_cmds_counted("PRE")] * TS("nRP")  * tCK_ns / 1E3;
 
-      double rd_cmd_energy   = (VE("VDD") * (CE("IDD4R") - CE("IDD3N")) + VE("VPP") * (CE("IPP4R") - CE("IPP3N"))) 
+      rank_stats.rd_cmd_energy   = (VE("VDD") * (CE("IDD4R") - CE("IDD3N")) + VE("VPP") * (CE("IPP4R") - CE("IPP3N"))) 
                                       * rank_stats.cmd_counters[m_cmds_counted("RD")] * TS("nBL") * tCK_ns / 1E3;
 
-      double wr_cmd_energy   = (VE("VDD") * (CE("IDD4W") - CE("IDD3N")) + VE("VPP") * (CE("IPP4W") - CE("IPP3N"))) 
+      rank_stats.wr_cmd_energy   = (VE("VDD") * (CE("IDD4W") - CE("IDD3N")) + VE("VPP") * (CE("IPP4W") - CE("IPP3N"))) 
                                       * rank_stats.cmd_counters[m_cmds_counted("WR")] * TS("nBL") * tCK_ns / 1E3;
 
-      double ref_cmd_energy  = (VE("VDD") * (CE("IDD5B")) + VE("VPP") * (CE("IPP5B"))) 
+      rank_stats.ref_cmd_energy  = (VE("VDD") * (CE("IDD5B")) + VE("VPP") * (CE("IPP5B"))) 
                                       * rank_stats.cmd_counters[m_cmds_counted("REF")] * TS("nRFC") * tCK_ns / 1E3;
 
       double vrr_cmd_energy  = (VE("VDD") * (CE("IDD0") - CE("IDD3N")) + VE("VPP") * (CE("IPP0") - CE("IPP3N"))) 
                                       * rank_stats.cmd_counters[m_cmds_counted("VRR")] * TS("nVRR") * tCK_ns / 1E3;
 
       rank_stats.total_background_energy = rank_stats.act_background_energy + rank_stats.pre_background_energy;
-      rank_stats.total_cmd_energy = act_cmd_energy 
-                                    + pre_cmd_energy 
-                                    + rd_cmd_energy
-                                    + wr_cmd_energy 
-                                    + ref_cmd_energy
+      rank_stats.total_cmd_energy = rank_stats.act_cmd_energy 
+                                    + rank_stats.pre_cmd_energy 
+                                    + rank_stats.rd_cmd_energy
+                                    + rank_stats.wr_cmd_energy 
+                                    + rank_stats.ref_cmd_energy
                                     + vrr_cmd_energy;
 
       rank_stats.total_energy = rank_stats.total_background_energy + rank_stats.total_cmd_energy;
+      rank_stats.other_cmd_energy = rank_stats.total_cmd_energy - rank_stats.act_cmd_energy - rank_stats.pre_cmd_energy
+                                    - rank_stats.rd_cmd_energy - rank_stats.wr_cmd_energy - rank_stats.ref_cmd_energy;
 
       s_total_background_energy += rank_stats.total_background_energy;
       s_total_cmd_energy += rank_stats.total_cmd_energy;
@@ -1,9 +1,10 @@
 #include "dram/dram.h"
 #include "dram/lambdas.h"
+#include "dram/odecc.h"
 
 namespace Ramulator {
 
-class DDR5VRR : public IDRAM, public Implementation {
+class DDR5VRR : public IDRAM, public Implementation, public Checkpointable {
   RAMULATOR_REGISTER_IMPLEMENTATION(IDRAM, DDR5VRR, "DDR5-VRR", "DDR5 with Victim Row Refresh")
   private:
     int m_RH_radius = -1;
@@ -26,10 +27,10 @@ class DDR5VRR : public IDRAM, public Implementation {
     };
 
     inline static const std::map<std::string, std::vector<int>> timing_presets = {
-      //   name         rate   nBL  nCL nRCD   nRP  nRAS   nRC   nWR  nRTP nCWL nPPD nCCDS nCCDS_WR nCCDS_WTR nCCDL nCCDL_WR nCCDL_WTR nRRDS nRRDL nFAW nRFC1 nRFC2 nRFCsb nREFI nREFSBRD nRFM1 nRFM2 nRFMsb nDRFMab nDRFMsb nVRR nCS, tCK_ps
-      {"DDR5_3200AN",  {3200,   8,  24,  24,   24,   52,   75,   48,   12,  22,  2,    8,     8,     22+8+4,    8,     16,    22+8+16,   8,   -1,   -1,  -1,   -1,   -1,    -1,     30,    -1,   -1,   -1,     -1,     -1,    -1,  2,   625}},
-      {"DDR5_3200BN",  {3200,   8,  26,  26,   26,   52,   77,   48,   12,  24,  2,    8,     8,     24+8+4,    8,     16,    24+8+16,   8,   -1,   -1,  -1,   -1,   -1,    -1,     30,    -1,   -1,   -1,     -1,     -1,    -1,  2,   625}},
-      {"DDR5_3200C",   {3200,   8,  28,  28,   28,   52,   79,   48,   12,  26,  2,    8,     8,     26+8+4,    8,     16,    26+8+16,   8,   -1,   -1,  -1,   -1,   -1,    -1,     30,    -1,   -1,   -1,     -1,     -1,    -1,  2,   625}},
+      //   name         rate   nBL  nCL nRCD   nRP  nRAS   nRC   nWR  nRTP nCWL nPPD nCCDS nCCDS_WR nCCDS_WTR nCCDL nCCDL_WR nCCDL_WTR nRRDS nRRDL nFAW nRFC1 nRFC2 nRFCsb nREFI nREFSBRD nRFM1 nRFM2 nRFMsb nDRFMab nDRFMsb nVRR nPRAC nRMW nECS nECSint nCS, tCK_ps
+      {"DDR5_3200AN",  {3200,   8,  24,  24,   24,   52,   75,   48,   12,  22,  2,    8,     8,     22+8+4,    8,     16,    22+8+16,   8,   -1,   -1,  -1,   -1,   -1,    -1,     30,    -1,   -1,   -1,     -1,     -1,    -1,    -1,    -1,   -1,     -1,  2,   625}},
+      {"DDR5_3200BN",  {3200,   8,  26,  26,   26,   52,   77,   48,   12,  24,  2,    8,     8,     24+8+4,    8,     16,    24+8+16,   8,   -1,   -1,  -1,   -1,   -1,    -1,     30,    -1,   -1,   -1,     -1,     -1,    -1,    -1,    -1,   -1,     -1,  2,   625}},
+      {"DDR5_3200C",   {3200,   8,  28,  28,   28,   52,   79,   48,   12,  26,  2,    8,     8,     26+8+4,    8,     16,    26+8+16,   8,   -1,   -1,  -1,   -1,   -1,    -1,     30,    -1,   -1,   -1,     -1,     -1,    -1,    -1,    -1,   -1,     -1,  2,   625}},
     };
 
     inline static const std::map<std::string, std::vector<double>> voltage_presets = {
@@ -62,6 +63,7 @@ class DDR5VRR : public IDRAM, public Implementation {
       "RFMab",  "RFMsb", "RFMab_end", "RFMsb_end",
       "DRFMab", "DRFMsb", "DRFMab_end", "DRFMsb_end",
       "VRR", "VRR_end",
+      "WRP", "ECS",
     };
 
     inline static const ImplLUT m_command_scopes = LUT (
@@ -73,6 +75,7 @@ class DDR5VRR : public IDRAM, public Implementation {
         {"RFMab",  "rank"},  {"RFMsb",  "bank"}, {"RFMab_end",  "rank"},  {"RFMsb_end",  "bank"},
         {"DRFMab", "rank"},  {"DRFMsb", "bank"}, {"DRFMab_end", "rank"},  {"DRFMsb_end", "bank"},
         {"VRR",   "bank"},   {"VRR_end",   "bank"},
+        {"WRP",   "column"}, {"ECS",    "bank"},
       }
     );
 
@@ -101,26 +104,30 @@ class DDR5VRR : public IDRAM, public Implementation {
         {"DRFMsb_end",  {false,  true,    false,   false}},
         {"VRR",         {false,  false,   false,   true }},
         {"VRR_end",     {false,  true,    false,   false}},
+        {"WRP",         {false,  false,   true,    false}},
+        {"ECS",         {false,  false,   false,   false}},
       }
     );
 
     inline static constexpr ImplDef m_requests = {
-      "read", "write", 
+      "read", "write", "partial-write", 
       "all-bank-refresh", "same-bank-refresh", 
       "rfm", "same-bank-rfm",
       "directed-rfm", "same-bank-directed-rfm",
       "victim-row-refresh", "open-row", "close-row",
-      "close-all-bank"
+      "close-all-bank",
+      "ecs"
     };
 
     inline static const ImplLUT m_request_translations = LUT (
       m_requests, m_commands, {
-        {"read", "RD"}, {"write", "WR"}, 
+        {"read", "RD"}, {"write", "WR"}, {"partial-write", "WRP"}, 
         {"all-bank-refresh", "REFab"}, {"same-bank-refresh", "REFsb"}, 
         {"rfm", "RFMab"}, {"same-bank-rfm", "RFMsb"}, 
         {"directed-rfm", "DRFMab"}, {"same-bank-directed-rfm", "DRFMsb"}, 
         {"victim-row-refresh", "VRR"}, {"open-row", "ACT"}, {"close-row", "PRE"},
-        {"close-all-bank", "PREA"}
+        {"close-all-bank", "PREA"},
+        {"ecs", "ECS"}
       }
     );
    
@@ -139,6 +146,8 @@ class DDR5VRR : public IDRAM, public Implementation {
       "nRFM1", "nRFM2", "nRFMsb", 
       "nDRFMab", "nDRFMsb", 
       "nVRR",
+      "nPRAC",
+      "nRMW", "nECS", "nECSint",
       "nCS",
       "tCK_ps"
     };
@@ -202,23 +211,45 @@ class DDR5VRR : public IDRAM, public Implementation {
     int m_BRC = 2;
 
 
+  /************************************************
+   *                 On-Die ECC
+   ***********************************************/
+  public:
+    OnDieECC m_odecc;
+
+
   public:
     void tick() override {
       m_clk++;
 
       // Check if there is any future action at this cycle
-      for (int i = m_future_actions.size() - 1; i >= 0; i--) {
-        auto& future_action = m_future_actions[i];
-        if (future_action.clk == m_clk) {
-          handle_future_action(future_action.cmd, future_action.addr_vec);
-          m_future_actions.erase(m_future_actions.begin() + i);
-        }
+      handle_future_actions(m_clk);
+
+      // Update the energy stats at the end of every power epoch
+      tick_power_epoch();
+    };
+
+    // The open rows of all channels
+    void save_checkpoint(std::ostream& out) override {
+      Checkpoint::write(out, m_organization.count);
+      for (auto channel : m_channels) {
+        channel->save_open_rows(out, m_states["Opened"]);
+      }
+    };
+
+    void load_checkpoint(std::istream& in) override {
+      if (Checkpoint::read_vector<int>(in) != m_organization.count) {
+        throw ConfigurationError("Checkpoint was saved with a different DRAM organization!");
+      }
+      for (auto channel : m_channels) {
+        channel->load_open_rows(in, m_states["Opened"]);
       }
     };
 
     void init() override {
       RAMULATOR_DECLARE_SPECS();
       set_organization();
+      set_flat_bank_strides();
       set_timing_vals();
 
       set_actions();
@@ -232,36 +263,38 @@ class DDR5VRR : public IDRAM, public Implementation {
 
     void issue_command(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      m_channels[channel_id]->update_timing(command, addr_vec, m_clk);
-      m_channels[channel_id]->update_powers(command, addr_vec, m_clk);
-      m_channels[channel_id]->update_states(command, addr_vec, m_clk);
+      m_channels[channel_id]->update_timing(command, addr_vec, get_clk(channel_id));
+      m_channels[channel_id]->update_powers(command, addr_vec, get_clk(channel_id));
+      m_channels[channel_id]->update_states(command, addr_vec, get_clk(channel_id));
+      m_odecc.on_command(command);
 
       // Check if the command requires future action
       check_future_action(command, addr_vec);
     };
 
     void check_future_action(int command, const AddrVec_t& addr_vec) {
+      Clk_t clk = get_clk(addr_vec[m_levels["channel"]]);
       switch (command) {
         case m_commands("REFab"):
-          m_future_actions.push_back({command, addr_vec, m_clk + m_timing_vals("nRFC1") - 1});
+          add_future_action({command, addr_vec, clk + m_timing_vals("nRFC1") - 1});
           break;
         case m_commands("REFsb"):
-          m_future_actions.push_back({command, addr_vec, m_clk + m_timing_vals("nRFCsb") - 1});
+          add_future_action({command, addr_vec, clk + m_timing_vals("nRFCsb") - 1});
           break;
         case m_commands("RFMab"):
-          m_future_actions.push_back({command, addr_vec, m_clk + m_timing_vals("nRFM1") - 1});
+          add_future_action({command, addr_vec, clk + m_timing_vals("nRFM1") - 1});
           break;
         case m_commands("RFMsb"):
-          m_future_actions.push_back({command, addr_vec, m_clk + m_timing_vals("nRFMsb") - 1});
+          add_future_action({command, addr_vec, clk + m_timing_vals("nRFMsb") - 1});
           break;
         case m_commands("DRFMab"):
-          m_future_actions.push_back({command, addr_vec, m_clk + m_timing_vals("nDRFMab") - 1});
+          add_future_action({command, addr_vec, clk + m_timing_vals("nDRFMab") - 1});
           break;
         case m_commands("DRFMsb"):
-          m_future_actions.push_back({command, addr_vec, m_clk + m_timing_vals("nDRFMsb") - 1});
+          add_future_action({command, addr_vec, clk + m_timing_vals("nDRFMsb") - 1});
           break;
         case m_commands("VRR"):
-          m_future_actions.push_back({command, addr_vec, m_clk + m_timing_vals("nVRR") - 1});
+          add_future_action({command, addr_vec, clk + m_timing_vals("nVRR") - 1});
           break;
         default:
           // Other commands do not require future actions
@@ -269,36 +302,36 @@ class DDR5VRR : public IDRAM, public Implementation {
       }
     }
 
-    void handle_future_action(int command, const AddrVec_t& addr_vec) {
+    void handle_future_action(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
       switch (command) {
         case m_commands("REFab"):
-          m_channels[channel_id]->update_powers(m_commands("REFab_end"), addr_vec, m_clk);
-          m_channels[channel_id]->update_states(m_commands("REFab_end"), addr_vec, m_clk);
+          m_channels[channel_id]->update_powers(m_commands("REFab_end"), addr_vec, get_clk(channel_id));
+          m_channels[channel_id]->update_states(m_commands("REFab_end"), addr_vec, get_clk(channel_id));
           break;
         case m_commands("REFsb"):
-          m_channels[channel_id]->update_powers(m_commands("REFsb_end"), addr_vec, m_clk);
-          m_channels[channel_id]->update_states(m_commands("REFsb_end"), addr_vec, m_clk);
+          m_channels[channel_id]->update_powers(m_commands("REFsb_end"), addr_vec, get_clk(channel_id));
+          m_channels[channel_id]->update_states(m_commands("REFsb_end"), addr_vec, get_clk(channel_id));
           break;
         case m_commands("RFMab"):
-          m_channels[channel_id]->update_powers(m_commands("RFMab_end"), addr_vec, m_clk);
-          m_channels[channel_id]->update_states(m_commands("RFMab_end"), addr_vec, m_clk);
+          m_channels[channel_id]->update_powers(m_commands("RFMab_end"), addr_vec, get_clk(channel_id));
+          m_channels[channel_id]->update_states(m_commands("RFMab_end"), addr_vec, get_clk(channel_id));
           break;
         case m_commands("RFMsb"):
-          m_channels[channel_id]->update_powers(m_commands("RFMsb_end"), addr_vec, m_clk);
-          m_channels[channel_id]->update_states(m_commands("RFMsb_end"), addr_vec, m_clk);
+          m_channels[channel_id]->update_powers(m_commands("RFMsb_end"), addr_vec, get_clk(channel_id));
+          m_channels[channel_id]->update_states(m_commands("RFMsb_end"), addr_vec, get_clk(channel_id));
           break;
         case m_commands("DRFMab"):
-          m_channels[channel_id]->update_powers(m_commands("DRFMab_end"), addr_vec, m_clk);
-          m_channels[channel_id]->update_states(m_commands("DRFMab_end"), addr_vec, m_clk);
+          m_channels[channel_id]->update_powers(m_commands("DRFMab_end"), addr_vec, get_clk(channel_id));
+          m_channels[channel_id]->update_states(m_commands("DRFMab_end"), addr_vec, get_clk(channel_id));
           break;
         case m_commands("DRFMsb"):
-          m_channels[channel_id]->update_powers(m_commands("DRFMsb_end"), addr_vec, m_clk);
-          m_channels[channel_id]->update_states(m_commands("DRFMsb_end"), addr_vec, m_clk);
+          m_channels[channel_id]->update_powers(m_commands("DRFMsb_end"), addr_vec, get_clk(channel_id));
+          m_channels[channel_id]->update_states(m_commands("DRFMsb_end"), addr_vec, get_clk(channel_id));
           break;
         case m_commands("VRR"):
-          m_channels[channel_id]->update_powers(m_commands("VRR_end"), addr_vec, m_clk);
-          m_channels[channel_id]->update_states(m_commands("VRR_end"), addr_vec, m_clk);
+          m_channels[channel_id]->update_powers(m_commands("VRR_end"), addr_vec, get_clk(channel_id));
+          m_channels[channel_id]->update_states(m_commands("VRR_end"), addr_vec, get_clk(channel_id));
           break;
         default:
           // Other commands do not require future actions
@@ -308,22 +341,32 @@ class DDR5VRR : public IDRAM, public Implementation {
 
     int get_preq_command(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->get_preq_command(command, addr_vec, m_clk);
+      return m_channels[channel_id]->get_preq_command(command, addr_vec, get_clk(channel_id));
     };
 
     bool check_ready(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->check_ready(command, addr_vec, m_clk);
+      return m_channels[channel_id]->check_ready(command, addr_vec, get_clk(channel_id));
+    };
+
+    Clk_t get_ready_clk(int command, const AddrVec_t& addr_vec) override {
+      int channel_id = addr_vec[m_levels["channel"]];
+      return m_channels[channel_id]->get_ready_clk(command, addr_vec);
     };
 
     bool check_rowbuffer_hit(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->check_rowbuffer_hit(command, addr_vec, m_clk);
+      return m_channels[channel_id]->check_rowbuffer_hit(command, addr_vec, get_clk(channel_id));
     };
 
     bool check_node_open(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->check_node_open(command, addr_vec, m_clk);
+      return m_channels[channel_id]->check_node_open(command, addr_vec, get_clk(channel_id));
+    };
+
+    int64_t get_state_version(const AddrVec_t& addr_vec) override {
+      int channel_id = addr_vec[m_levels["channel"]];
+      return m_channels[channel_id]->get_state_version(addr_vec);
     };
 
   private:
@@ -521,7 +564,6 @@ class DDR5VRR : public IDRAM, public Implementation {
         std::cout << "[Ramulator::DDR5-VRR] <PRAC ENABLED> Timings are updated automatically. " << std::endl;
         // Table 343 JEDEC 79-5C_v1.30
         m_timing_vals("nRAS") = std::max((int) JEDEC_rounding_DDR5(16, tCK_ps), m_timing_vals("nRAS"));
-        m_timing_vals("nRP") = std::max((int) JEDEC_rounding_DDR5(36, tCK_ps), m_timing_vals("nRP"));
         m_timing_vals("nRC") = std::max((int) JEDEC_rounding_DDR5(52, tCK_ps), m_timing_vals("nRC"));
         m_timing_vals("nRTP") = std::max((int) JEDEC_rounding_DDR5(5, tCK_ps), m_timing_vals("nRTP"));
         m_timing_vals("nWR") = std::max((int) JEDEC_rounding_DDR5(10, tCK_ps), m_timing_vals("nWR"));
@@ -535,6 +577,9 @@ class DDR5VRR : public IDRAM, public Implementation {
       std::cout << "[Ramulator::DDR5-VRR] nRFM1: " << m_timing_vals("nRFM1") << std::endl;
       std::cout << "[Ramulator::DDR5-VRR] nRFMsb: " << m_timing_vals("nRFMsb") << std::endl;
 
+      // On-die ECC
+      m_odecc.configure(this);
+
       // Overwrite timing parameters with any user-provided value
       // Rate and tCK should not be overwritten
       for (int i = 1; i < m_timings.size() - 1; i++) {
@@ -549,6 +594,15 @@ class DDR5VRR : public IDRAM, public Implementation {
         }
       }
 
+      // PRAC: the precharge reads, increments and writes back the activation counter of the row in nPRAC more cycles.
+      // Unless provided, nPRAC extends nRP to the PRAC tRP (36 ns) of Table 343.
+      if (m_timing_vals("nPRAC") == -1) {
+        m_timing_vals("nPRAC") = prac_enabled ? std::max(0, (int) JEDEC_rounding_DDR5(36, tCK_ps) - m_timing_vals("nRP")) : 0;
+      }
+      m_timing_vals("nRP") += m_timing_vals("nPRAC");
+
+      m_odecc.set_timings(this, tCK_ps);
+
       // Check if there is any uninitialized timings
       for (int i = 0; i < m_timing_vals.size(); i++) {
         if (m_timing_vals(i) == -1) {
@@ -565,28 +619,28 @@ class DDR5VRR : public IDRAM, public Implementation {
       populate_timingcons(this, {
           /*** Channel ***/ 
           // Two-Cycle Commands
-          {.level = "channel", .preceding = {"ACT", "RD", "RDA", "WR", "WRA"}, .following = all_commands, .latency = 2},
+          {.level = "channel", .preceding = {"ACT", "RD", "RDA", "WR", "WRA", "WRP"}, .following = all_commands, .latency = 2},
 
           // CAS <-> CAS
           /// Data bus occupancy
           {.level = "channel", .preceding = {"RD", "RDA"}, .following = {"RD", "RDA"}, .latency = V("nBL")},
-          {.level = "channel", .preceding = {"WR", "WRA"}, .following = {"WR", "WRA"}, .latency = V("nBL")},
+          {.level = "channel", .preceding = {"WR", "WRA", "WRP"}, .following = {"WR", "WRA", "WRP"}, .latency = V("nBL")},
 
           /*** Rank (or different BankGroup) ***/ 
           // CAS <-> CAS
           /// nCCDS is the minimal latency for column commands 
           {.level = "rank", .preceding = {"RD", "RDA"}, .following = {"RD", "RDA"}, .latency = V("nCCDS")},
-          {.level = "rank", .preceding = {"WR", "WRA"}, .following = {"WR", "WRA"}, .latency = V("nCCDS_WR")},
+          {.level = "rank", .preceding = {"WR", "WRA", "WRP"}, .following = {"WR", "WRA", "WRP"}, .latency = V("nCCDS_WR")},
           /// RD <-> WR, Minimum Read to Write, Assuming Read DQS Offset = 0, tRPST = 0.5, tWPRE = 2 tCK                          
-          {.level = "rank", .preceding = {"RD", "RDA"}, .following = {"WR", "WRA"}, .latency = V("nCL") + V("nBL") + 2 - V("nCWL") + 2},   // nCCDS_RTW
+          {.level = "rank", .preceding = {"RD", "RDA"}, .following = {"WR", "WRA", "WRP"}, .latency = V("nCL") + V("nBL") + 2 - V("nCWL") + 2},   // nCCDS_RTW
           /// WR <-> RD, Minimum Read after Write
-          {.level = "rank", .preceding = {"WR", "WRA"}, .following = {"RD", "RDA"}, .latency = V("nCCDS_WTR")},
+          {.level = "rank", .preceding = {"WR", "WRA", "WRP"}, .following = {"RD", "RDA"}, .latency = V("nCCDS_WTR")},
           /// CAS <-> CAS between sibling ranks, nCS (rank switching) is needed for new DQS
-          {.level = "rank", .preceding = {"RD", "RDA"}, .following = {"RD", "RDA", "WR", "WRA"}, .latency = V("nBL") + V("nCS"), .is_sibling = true},
-          {.level = "rank", .preceding = {"WR", "WRA"}, .following = {"RD", "RDA"}, .latency = V("nCL")  + V("nBL") + V("nCS") - V("nCWL"), .is_sibling = true},
+          {.level = "rank", .preceding = {"RD", "RDA"}, .following = {"RD", "RDA", "WR", "WRA", "WRP"}, .latency = V("nBL") + V("nCS"), .is_sibling = true},
+          {.level = "rank", .preceding = {"WR", "WRA", "WRP"}, .following = {"RD", "RDA"}, .latency = V("nCL")  + V("nBL") + V("nCS") - V("nCWL"), .is_sibling = true},
           /// CAS <-> PREab
           {.level = "rank", .preceding = {"RD"}, .following = {"PREA"}, .latency = V("nRTP")},
-          {.level = "rank", .preceding = {"WR"}, .following = {"PREA"}, .latency = V("nCWL") + V("nBL") + V("nWR")},          
+          {.level = "rank", .preceding = {"WR", "WRP"}, .following = {"PREA"}, .latency = V("nCWL") + V("nBL") + V("nWR")},          
           /// RAS <-> RAS
           {.level = "rank", .preceding = {"ACT"}, .following = {"ACT"}, .latency = V("nRRDS")},          
           {.level = "rank", .preceding = {"ACT"}, .following = {"ACT"}, .latency = V("nFAW"), .window = 4},          
@@ -609,22 +663,22 @@ class DDR5VRR : public IDRAM, public Implementation {
           /*** Same Bank Group ***/ 
           /// CAS <-> CAS
           {.level = "bankgroup", .preceding = {"RD", "RDA"}, .following = {"RD", "RDA"}, .latency = V("nCCDL")},          
-          {.level = "bankgroup", .preceding = {"WR", "WRA"}, .following = {"WR", "WRA"}, .latency = V("nCCDL_WR")},          
-          {.level = "bankgroup", .preceding = {"WR", "WRA"}, .following = {"RD", "RDA"}, .latency = V("nCCDL_WTR")},
+          {.level = "bankgroup", .preceding = {"WR", "WRA", "WRP"}, .following = {"WR", "WRA", "WRP"}, .latency = V("nCCDL_WR")},          
+          {.level = "bankgroup", .preceding = {"WR", "WRA", "WRP"}, .following = {"RD", "RDA"}, .latency = V("nCCDL_WTR")},
           /// RAS <-> RAS
           {.level = "bankgroup", .preceding = {"ACT"}, .following = {"ACT"}, .latency = V("nRRDL")},  
 
           /*** Bank ***/ 
           {.level = "bank", .preceding = {"ACT"}, .following = {"ACT", "VRR", "REFsb", "RFMsb", "DRFMsb"}, .latency = V("nRC")},  
           {.level = "bank", .preceding = {"VRR"}, .following = {"ACT", "VRR", "REFsb", "RFMsb", "DRFMsb"}, .latency = V("nVRR")},  
-          {.level = "bank", .preceding = {"ACT"}, .following = {"RD", "RDA", "WR", "WRA"}, .latency = V("nRCD")},  
+          {.level = "bank", .preceding = {"ACT"}, .following = {"RD", "RDA", "WR", "WRA", "WRP"}, .latency = V("nRCD")},  
           {.level = "bank", .preceding = {"ACT"}, .following = {"PRE", "PREsb"}, .latency = V("nRAS")},  
           {.level = "bank", .preceding = {"PRE", "PREsb"}, .following = {"ACT", "VRR", "REFsb", "RFMsb", "DRFMsb"}, .latency = V("nRP")},  
           {.level = "bank", .preceding = {"RD"},  .following = {"PRE", "PREsb"}, .latency = V("nRTP")},  
-          {.level = "bank", .preceding = {"WR"},  .following = {"PRE", "PREsb"}, .latency = V("nCWL") + V("nBL") + V("nWR")},  
+          {.level = "bank", .preceding = {"WR", "WRP"},  .following = {"PRE", "PREsb"}, .latency = V("nCWL") + V("nBL") + V("nWR")},  
           {.level = "bank", .preceding = {"RDA"}, .following = {"ACT", "VRR", "REFsb", "RFMsb", "DRFMsb"}, .latency = V("nRTP") + V("nRP")},  
           {.level = "bank", .preceding = {"WRA"}, .following = {"ACT", "VRR", "REFsb", "RFMsb", "DRFMsb"}, .latency = V("nCWL") + V("nBL") + V("nWR") + V("nRP")},  
-          {.level = "bank", .preceding = {"WR"},  .following = {"RDA"}, .latency = V("nCWL") + V("nBL") + V("nWR") - V("nRTP")},  
+          {.level = "bank", .preceding = {"WR", "WRP"},  .following = {"RDA"}, .latency = V("nCWL") + V("nBL") + V("nWR") - V("nRTP")},  
 
           /// Same-bank refresh/RFM timings. The timings of the bank in other BGs will be updated by action function
           {.level = "bank", .preceding = {"REFsb"},  .following = {"ACT", "VRR", "REFsb", "RFMsb", "DRFMsb"}, .latency = V("nRFCsb")},  
@@ -634,6 +688,16 @@ class DDR5VRR : public IDRAM, public Implementation {
       );
       #undef V
 
+      m_odecc.populate_timingcons(this);
+      if (m_odecc.is_enabled()) {
+        // ECS and the victim row refreshes of the same bank
+        populate_timingcons(this, {
+          {.level = "bank", .preceding = {"VRR"}, .following = {"ECS"}, .latency = m_timing_vals("nVRR")},
+          {.level = "bank", .preceding = {"ECS"}, .following = {"VRR"}, .latency = m_timing_vals("nECS")},
+        });
+      }
+      m_odecc.register_stats(this);
+
     };
 
     void set_actions() {
@@ -685,9 +749,11 @@ class DDR5VRR : public IDRAM, public Implementation {
       // Bank Preqs
       m_preqs[m_levels["bank"]][m_commands["RD"]] = Lambdas::Preq::Bank::RequireRowOpen<DDR5VRR>;
       m_preqs[m_levels["bank"]][m_commands["WR"]] = Lambdas::Preq::Bank::RequireRowOpen<DDR5VRR>;
+      m_preqs[m_levels["bank"]][m_commands["WRP"]] = Lambdas::Preq::Bank::RequireRowOpen<DDR5VRR>;
       m_preqs[m_levels["bank"]][m_commands["VRR"]] = Lambdas::Preq::Bank::RequireBankClosed<DDR5VRR>;
       m_preqs[m_levels["bank"]][m_commands["ACT"]] = Lambdas::Preq::Bank::RequireRowOpen<DDR5VRR>;
       m_preqs[m_levels["bank"]][m_commands["PRE"]] = Lambdas::Preq::Bank::RequireBankClosed<DDR5VRR>;
+      m_preqs[m_levels["bank"]][m_commands["ECS"]] = Lambdas::Preq::Bank::RequireBankClosed<DDR5VRR>;
 
     };
 
@@ -696,6 +762,7 @@ class DDR5VRR : public IDRAM, public Implementation {
 
       m_rowhits[m_levels["bank"]][m_commands["RD"]] = Lambdas::RowHit::Bank::RDWR<DDR5VRR>;
       m_rowhits[m_levels["bank"]][m_commands["WR"]] = Lambdas::RowHit::Bank::RDWR<DDR5VRR>;
+      m_rowhits[m_levels["bank"]][m_commands["WRP"]] = Lambdas::RowHit::Bank::RDWR<DDR5VRR>;
     }
 
 
@@ -704,6 +771,7 @@ class DDR5VRR : public IDRAM, public Implementation {
 
       m_rowopens[m_levels["bank"]][m_commands["RD"]] = Lambdas::RowOpen::Bank::RDWR<DDR5VRR>;
       m_rowopens[m_levels["bank"]][m_commands["WR"]] = Lambdas::RowOpen::Bank::RDWR<DDR5VRR>;
+      m_rowopens[m_levels["bank"]][m_commands["WRP"]] = Lambdas::RowOpen::Bank::RDWR<DDR5VRR>;
     }
 
     void set_powers() {
@@ -734,6 +802,7 @@ class DDR5VRR : public IDRAM, public Implementation {
       }
 
       m_power_debug = param<bool>("power_debug").default_val(false);
+      m_power_epoch = param<Clk_t>("power_epoch").desc("Cycles between two updates of the energy stats and the epoch power (0 = only at the end).").default_val(0);
 
       // TODO: Check for multichannel configs.
       int num_channels = m_organization.count[m_levels["channel"]];
@@ -752,6 +821,8 @@ class DDR5VRR : public IDRAM, public Implementation {
       m_powers[m_levels["bank"]][m_commands["PRE"]] = Lambdas::Power::Bank::PRE<DDR5VRR>;
       m_powers[m_levels["bank"]][m_commands["RD"]]  = Lambdas::Power::Bank::RD<DDR5VRR>;
       m_powers[m_levels["bank"]][m_commands["WR"]]  = Lambdas::Power::Bank::WR<DDR5VRR>;
+      m_powers[m_levels["bank"]][m_commands["WRP"]] = Lambdas::Power::Bank::WR<DDR5VRR>;
+      m_powers[m_levels["bank"]][m_commands["ECS"]] = Lambdas::Power::Bank::ECS<DDR5VRR>;
       m_powers[m_levels["bank"]][m_commands["VRR"]]  = Lambdas::Power::Bank::VRR<DDR5VRR>;
 
       // m_powers[m_levels["rank"]][m_commands["REFsb"]] = Lambdas::Power::Rank::REFsb<DDR5VRR>;
@@ -779,6 +850,9 @@ class DDR5VRR : public IDRAM, public Implementation {
       register_stat(s_total_background_energy).name("total_background_energy");
       register_stat(s_total_cmd_energy).name("total_cmd_energy");
       register_stat(s_total_energy).name("total_energy");
+      if (m_power_epoch > 0) {
+        register_stat(s_epoch_power).name("epoch_power_mW");
+      }
       register_stat(s_total_rfm_energy).name("total_rfm_energy");
       register_stat(s_total_vrr_energy).name("total_vrr_energy");
             
@@ -790,21 +864,46 @@ class DDR5VRR : public IDRAM, public Implementation {
         register_stat(power_stat.pre_background_energy).name("pre_background_energy_rank{}", power_stat.rank_id);
         register_stat(power_stat.active_cycles).name("active_cycles_rank{}", power_stat.rank_id);
         register_stat(power_stat.idle_cycles).name("idle_cycles_rank{}", power_stat.rank_id);
+        if (m_power_epoch > 0) {
+          register_stat(power_stat.act_cmd_energy).name("act_cmd_energy_rank{}", power_stat.rank_id);
+          register_stat(power_stat.pre_cmd_energy).name("pre_cmd_energy_rank{}", power_stat.rank_id);
+          register_stat(power_stat.rd_cmd_energy).name("rd_cmd_energy_rank{}", power_stat.rank_id);
+          register_stat(power_stat.wr_cmd_energy).name("wr_cmd_energy_rank{}", power_stat.rank_id);
+          register_stat(power_stat.ref_cmd_energy).name("ref_cmd_energy_rank{}", power_stat.rank_id);
+          register_stat(power_stat.other_cmd_energy).name("other_cmd_energy_rank{}", power_stat.rank_id);
+          register_stat(power_stat.epoch_power).name("epoch_power_mW_rank{}", power_stat.rank_id);
+        }
       }
     }
 
     void create_nodes() {
+      m_flat_timing = param<bool>("flat_timing").desc("Keep the timing state of each channel in flat per-level tables instead of the node tree").default_val(false);
+      m_ready_clk_cache = param<bool>("ready_clk_cache").desc("Memoize the earliest ready cycle of each command and node until the next command to the channel").default_val(true);
       int num_channels = m_organization.count[m_levels["channel"]];
       for (int i = 0; i < num_channels; i++) {
         Node* channel = new Node(this, nullptr, 0, i);
         m_channels.push_back(channel);
       }
     }
+
+    std::span<const std::byte> place_channel(int channel_id) override {
+      return rebuild_channel(this, m_channels, channel_id);
+    }
     
     void finalize() override {
+      compute_energy();
+    }
+
+    void compute_energy() override {
       if (!m_drampower_enable)
         return;
 
+      // Recomputed from the counters
+      s_total_background_energy = 0;
+      s_total_cmd_energy = 0;
+      s_total_energy = 0;
+      s_total_rfm_energy = 0;
+
       int num_channels = m_organization.count[m_levels["channel"]];
       int num_ranks = m_organization.count[m_levels["rank"]];
       for (int i = 0; i < num_channels; i++) {
@@ -833,19 +932,19 @@ class DDR5VRR : public IDRAM, public Implementation {
                                             * rank_stats.idle_cycles * tCK_ns / 1E3;
 
 
-      double act_cmd_energy  = (VE("VDD") * (CE("IDD0") - CE("IDD3N")) + VE("VPP") * (CE("IPP0") - CE("IPP3N"))) 
+      rank_stats.act_cmd_energy  = (VE("VDD") * (CE("IDD0") - CE("IDD3N")) + VE("VPP") * (CE("IPP0") - CE("IPP3N"))) 
                                       * rank_stats.cmd_counters[m_cmds_counted("ACT")] * TS("nRAS") * tCK_ns / 1E3;
 
-      double pre_cmd_energy  = (VE("VDD") * (CE("IDD0") - CE("IDD2N")) + VE("VPP") * (CE("IPP0") - CE("IPP2N"))) 
+      rank_stats.pre_cmd_energy  = (VE("VDD") * (CE("IDD0") - CE("IDD2N")) + VE("VPP") * (CE("IPP0") - CE("IPP2N"))) 
                                       * rank_stats.cmd_counters[m_cmds_counted("PRE")] * TS("nRP")  * tCK_ns / 1E3;
 
-      double rd_cmd_energy   = (VE("VDD") * (CE("IDD4R") - CE("IDD3N")) + VE("VPP") * (CE("IPP4R") - CE("IPP3N"))) 
+      rank_stats.rd_cmd_energy   = (VE("VDD") * (CE("IDD4R") - CE("IDD3N")) + VE("VPP") * (CE("IPP4R") - CE("IPP3N"))) 
                                       * rank_stats.cmd_counters[m_cmds_counted("RD")] * TS("nBL") * tCK_ns / 1E3;
 
-      double wr_cmd_energy   = (VE("VDD") * (CE("IDD4W") - CE("IDD3N")) + VE("VPP") * (CE("IPP4W") - CE("IPP3N"))) 
+      rank_stats.wr_cmd_energy   = (VE("VDD") * (CE("IDD4W") - CE("IDD3N")) + VE("VPP") * (CE("IPP4W") - CE("IPP3N"))) 
                                       * rank_stats.cmd_counters[m_cmds_counted("WR")] * TS("nBL") * tCK_ns / 1E3;
 
-      double ref_cmd_energy  = (VE("VDD") * (CE("IDD5B")) + VE("VPP") * (CE("IPP5B"))) 
+      rank_stats.ref_cmd_energy  = (VE("VDD") * (CE("IDD5B")) + VE("VPP") * (CE("IPP5B"))) 
                                       * rank_stats.cmd_counters[m_cmds_counted("REF")] * TS("nRFC1") * tCK_ns / 1E3;
 
       double rfm_cmd_energy = (VE("VDD") * (CE("IDD0") - CE("IDD3N")) + VE("VPP") * (CE("IPP0") - CE("IPP3N"))) * num_bankgroups
@@ -855,15 +954,17 @@ class DDR5VRR : public IDRAM, public Implementation {
                                       * rank_stats.cmd_counters[m_cmds_counted("VRR")] * TS("nVRR") * tCK_ns / 1E3;
 
       rank_stats.total_background_energy = rank_stats.act_background_energy + rank_stats.pre_background_energy;
-      rank_stats.total_cmd_energy = act_cmd_energy 
-                                    + pre_cmd_energy 
-                                    + rd_cmd_energy
-                                    + wr_cmd_energy 
-                                    + ref_cmd_energy
+      rank_stats.total_cmd_energy = rank_stats.act_cmd_energy 
+                                    + rank_stats.pre_cmd_energy 
+                                    + rank_stats.rd_cmd_energy
+                                    + rank_stats.wr_cmd_energy 
+                                    + rank_stats.ref_cmd_energy
                                     + rfm_cmd_energy
                                     + vrr_cmd_energy;
 
       rank_stats.total_energy = rank_stats.total_background_energy + rank_stats.total_cmd_energy;
+      rank_stats.other_cmd_energy = rank_stats.total_cmd_energy - rank_stats.act_cmd_energy - rank_stats.pre_cmd_energy
+                                    - rank_stats.rd_cmd_energy - rank_stats.wr_cmd_energy - rank_stats.ref_cmd_energy;
 
       s_total_background_energy += rank_stats.total_background_energy;
       s_total_cmd_energy += rank_stats.total_cmd_energy;
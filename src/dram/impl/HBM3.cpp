@@ -3,7 +3,7 @@
 
 namespace Ramulator {
 
-class HBM3 : public IDRAM, public Implementation {
+class HBM3 : public IDRAM, public Implementation, public Checkpointable {
   RAMULATOR_REGISTER_IMPLEMENTATION(IDRAM, HBM3, "HBM3", "HBM3 Device Model")
 
   public:
@@ -70,13 +70,15 @@ class HBM3 : public IDRAM, public Implementation {
     );
 
     inline static constexpr ImplDef m_requests = {
-      "read", "write", "all-bank-refresh", "per-bank-refresh", "all-bank-rfm", "per-bank-rfm"
+      "read", "write", "all-bank-refresh", "per-bank-refresh", "all-bank-rfm", "per-bank-rfm",
+      "open-row", "close-row"
     };
 
     inline static const ImplLUT m_request_translations = LUT (
       m_requests, m_commands, {
         {"read", "RD"}, {"write", "WR"}, {"all-bank-refresh", "REFab"}, {"per-bank-refresh", "REFsb"}, 
         {"all-bank-rfm", "RFMab"}, {"per-bank-rfm", "RFMsb"}, 
+        {"open-row", "ACT"}, {"close-row", "PRE"}
       }
     );
 
@@ -132,10 +134,30 @@ class HBM3 : public IDRAM, public Implementation {
       m_clk++;
     };
 
+    // The open rows of all channels
+    void save_checkpoint(std::ostream& out) override {
+      Checkpoint::write(out, m_organization.count);
+      for (auto channel : m_channels) {
+        channel->save_open_rows(out, m_states["Opened"]);
+      }
+    };
+
+    void load_checkpoint(std::istream& in) override {
+      if (Checkpoint::read_vector<int>(in) != m_organization.count) {
+        throw ConfigurationError("Checkpoint was saved with a different DRAM organization!");
+      }
+      for (auto channel : m_channels) {
+        channel->load_open_rows(in, m_states["Opened"]);
+      }
+    };
+
     void init() override {
       RAMULATOR_DECLARE_SPECS();
       set_organization();
+      set_flat_bank_strides();
       set_timing_vals();
+      populate_subarrays(this);
+      populate_link_retry(this, "pseudochannel");
 
       set_actions();
       set_preqs();
@@ -147,28 +169,57 @@ class HBM3 : public IDRAM, public Implementation {
 
     void issue_command(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      m_channels[channel_id]->update_timing(command, addr_vec, m_clk);
-      m_channels[channel_id]->update_states(command, addr_vec, m_clk);
+      m_channels[channel_id]->update_timing(command, addr_vec, get_clk(channel_id));
+      if (m_subarrays) {
+        m_subarrays->update_timing(command, addr_vec, get_clk(channel_id));
+      }
+      if (m_link_retry) {
+        m_link_retry->update_timing(command, addr_vec, get_clk(channel_id));
+      }
+      m_channels[channel_id]->update_states(command, addr_vec, get_clk(channel_id));
     };
 
     int get_preq_command(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->get_preq_command(command, addr_vec, m_clk);
+      return m_channels[channel_id]->get_preq_command(command, addr_vec, get_clk(channel_id));
     };
 
     bool check_ready(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->check_ready(command, addr_vec, m_clk);
+      if (m_subarrays && !m_subarrays->check_ready(command, addr_vec, get_clk(channel_id))) {
+        return false;
+      }
+      if (m_link_retry && !m_link_retry->check_ready(command, addr_vec, get_clk(channel_id))) {
+        return false;
+      }
+      return m_channels[channel_id]->check_ready(command, addr_vec, get_clk(channel_id));
+    };
+
+    Clk_t get_ready_clk(int command, const AddrVec_t& addr_vec) override {
+      int channel_id = addr_vec[m_levels["channel"]];
+      Clk_t ready_clk = m_channels[channel_id]->get_ready_clk(command, addr_vec);
+      if (m_subarrays) {
+        ready_clk = std::max(ready_clk, m_subarrays->get_ready_clk(command, addr_vec));
+      }
+      if (m_link_retry) {
+        ready_clk = std::max(ready_clk, m_link_retry->get_ready_clk(command, addr_vec));
+      }
+      return ready_clk;
     };
 
     bool check_rowbuffer_hit(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->check_rowbuffer_hit(command, addr_vec, m_clk);
+      return m_channels[channel_id]->check_rowbuffer_hit(command, addr_vec, get_clk(channel_id));
     };
     
     bool check_node_open(int command, const AddrVec_t& addr_vec) override {
       int channel_id = addr_vec[m_levels["channel"]];
-      return m_channels[channel_id]->check_node_open(command, addr_vec, m_clk);
+      return m_channels[channel_id]->check_node_open(command, addr_vec, get_clk(channel_id));
+    };
+
+    int64_t get_state_version(const AddrVec_t& addr_vec) override {
+      int channel_id = addr_vec[m_levels["channel"]];
+      return m_channels[channel_id]->get_state_version(addr_vec);
     };
 
   private:
@@ -176,6 +227,9 @@ class HBM3 : public IDRAM, public Implementation {
       // Channel width
       m_channel_width = param_group("org").param<int>("channel_width").default_val(64);
 
+      // HBM has separate row (ACT, PRE, REF) and column (RD, WR) command buses
+      m_dual_command_bus = true;
+
       // Organization
       m_organization.count.resize(m_levels.size(), -1);
 
@@ -385,6 +439,12 @@ class HBM3 : public IDRAM, public Implementation {
       m_actions[m_levels["bank"]][m_commands["PRE"]] = Lambdas::Action::Bank::PRE<HBM3>;
       m_actions[m_levels["bank"]][m_commands["RDA"]] = Lambdas::Action::Bank::PRE<HBM3>;
       m_actions[m_levels["bank"]][m_commands["WRA"]] = Lambdas::Action::Bank::PRE<HBM3>;
+      if (m_subarrays) {
+        // A precharge only closes the subarray of its row
+        m_actions[m_levels["bank"]][m_commands["PRE"]] = Lambdas::Action::Bank::PREsa<HBM3>;
+        m_actions[m_levels["bank"]][m_commands["RDA"]] = Lambdas::Action::Bank::PREsa<HBM3>;
+        m_actions[m_levels["bank"]][m_commands["WRA"]] = Lambdas::Action::Bank::PREsa<HBM3>;
+      }
     };
 
     void set_preqs() {
@@ -397,6 +457,10 @@ class HBM3 : public IDRAM, public Implementation {
       m_preqs[m_levels["bank"]][m_commands["REFsb"]] = Lambdas::Preq::Bank::RequireBankClosed<HBM3>;
       m_preqs[m_levels["bank"]][m_commands["RD"]] = Lambdas::Preq::Bank::RequireRowOpen<HBM3>;
       m_preqs[m_levels["bank"]][m_commands["WR"]] = Lambdas::Preq::Bank::RequireRowOpen<HBM3>;
+      if (m_subarrays) {
+        m_preqs[m_levels["bank"]][m_commands["RD"]] = Lambdas::Preq::Bank::RequireSubarrayRowOpen<HBM3>;
+        m_preqs[m_levels["bank"]][m_commands["WR"]] = Lambdas::Preq::Bank::RequireSubarrayRowOpen<HBM3>;
+      }
     };
 
     void set_rowhits() {
@@ -412,16 +476,26 @@ class HBM3 : public IDRAM, public Implementation {
 
       m_rowopens[m_levels["bank"]][m_commands["RD"]] = Lambdas::RowOpen::Bank::RDWR<HBM3>;
       m_rowopens[m_levels["bank"]][m_commands["WR"]] = Lambdas::RowOpen::Bank::RDWR<HBM3>;
+      if (m_subarrays) {
+        m_rowopens[m_levels["bank"]][m_commands["RD"]] = Lambdas::RowOpen::Bank::SubarrayRDWR<HBM3>;
+        m_rowopens[m_levels["bank"]][m_commands["WR"]] = Lambdas::RowOpen::Bank::SubarrayRDWR<HBM3>;
+      }
     }
 
 
     void create_nodes() {
+      m_flat_timing = param<bool>("flat_timing").desc("Keep the timing state of each channel in flat per-level tables instead of the node tree").default_val(false);
+      m_ready_clk_cache = param<bool>("ready_clk_cache").desc("Memoize the earliest ready cycle of each command and node until the next command to the channel").default_val(true);
       int num_channels = m_organization.count[m_levels["channel"]];
       for (int i = 0; i < num_channels; i++) {
         Node* channel = new Node(this, nullptr, 0, i);
         m_channels.push_back(channel);
       }
     };
+
+    std::span<const std::byte> place_channel(int channel_id) override {
+      return rebuild_channel(this, m_channels, channel_id);
+    };
 };
 
 
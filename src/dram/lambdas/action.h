@@ -25,6 +25,25 @@ namespace Bank {
     node->m_row_state.clear();
   };
 
+  // With subarray-level parallelism, a precharge only closes the row in the subarray of target_id (all without one)
+  template <class T>
+  void PREsa(typename T::Node* node, int cmd, int target_id, Clk_t clk) {
+    if (target_id == -1) {
+      node->m_row_state.clear();
+    } else {
+      const SubarrayTiming& subarrays = *node->m_spec->m_subarrays;
+      int subarray = subarrays.subarray(target_id);
+      int closed_row = -1;
+      node->m_row_state.for_each([&](int row, int) {
+        if (subarrays.subarray(row) == subarray) {
+          closed_row = row;
+        }
+      });
+      node->m_row_state.erase(closed_row);
+    }
+    node->m_state = node->m_row_state.empty() ? T::m_states["Closed"] : T::m_states["Opened"];
+  };
+
   template <class T>
   void VRR(typename T::Node* node, int cmd, int target_id, Clk_t clk) {
     node->m_state = T::m_states["Refreshing"];
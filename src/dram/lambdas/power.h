@@ -1,6 +1,9 @@
 #ifndef RAMULATOR_DRAM_LAMBDAS_POWER_H
 #define RAMULATOR_DRAM_LAMBDAS_POWER_H
 
+#include <iostream>
+#include <string_view>
+
 #include <spdlog/spdlog.h>
 
 namespace Ramulator {
@@ -9,65 +12,66 @@ namespace Power {
 namespace Bank {
   template <class T>
   int get_flat_rank_id(typename T::Node* node) {
-    int channel_id = -1;
-    int rank_id = -1;
-    int num_ranks = node->m_spec->get_level_size("rank");
-    if constexpr (T::m_levels["bank"] - T::m_levels["rank"] == 1) {
-      auto rank_node = node->m_parent_node;
-      auto channel_node = rank_node->m_parent_node;
-      rank_id = rank_node->m_node_id;
-      channel_id = channel_node->m_node_id;
-    } else if constexpr (T::m_levels["bank"] - T::m_levels["rank"] == 2) {
-      auto bg_node = node->m_parent_node;
-      auto rank_node = bg_node->m_parent_node;
-      auto channel_node = rank_node->m_parent_node;
-      rank_id = rank_node->m_node_id;
-      channel_id = channel_node->m_node_id;
+    constexpr int rank_level = T::m_levels["rank"];
+    auto rank_node = node->m_parent_node;
+    for (int level = T::m_levels["bank"] - 1; level > rank_level; level--) {
+      rank_node = rank_node->m_parent_node;
     }
-    return channel_id * num_ranks + rank_id;
+    int num_ranks = node->m_spec->m_organization.count[rank_level];
+    return rank_node->m_parent_node->m_node_id * num_ranks + rank_node->m_node_id;
   }
 
-  template <class T>
-  void debug(typename T::Node* node, std::string msg, Clk_t clk) {
-    if (node->m_spec->m_power_debug) {
-      std::cout << "[Power] Rank" << Bank::get_flat_rank_id<T>(node) << " Bank" << node->m_node_id << " " << msg << " @ " << clk << std::endl;
+  template <class T, typename... Msg>
+  void debug(typename T::Node* node, Clk_t clk, const Msg&... msg) {
+    RAMULATOR_TRACE_IF(Power, node->m_spec->m_power_debug) {
+      std::cout << "[Power] Rank" << Bank::get_flat_rank_id<T>(node) << " Bank" << node->m_node_id << " ";
+      (std::cout << ... << msg) << " @ " << clk << std::endl;
     }
   }
 
+  template <class T>
+  void increment_counter(typename T::Node* node, int counter, std::string_view name, Clk_t clk) {
+    Bank::debug<T>(node, clk, "Incrementing ", name, " counter.");
+    node->m_spec->m_power_stats[Bank::get_flat_rank_id<T>(node)].cmd_counters[counter]++;
+  }
+
   template <class T>
   void ACT(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Bank::debug<T>(node, "Incrementing ACT counter.", clk);
-    node->m_spec->m_power_stats[Bank::get_flat_rank_id<T>(node)].cmd_counters[T::m_cmds_counted("ACT")]++;
+    Bank::increment_counter<T>(node, T::m_cmds_counted["ACT"], "ACT", clk);
   }
 
   template <class T>
   void PRE(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Bank::debug<T>(node, "Incrementing PRE counter.", clk);
-    node->m_spec->m_power_stats[Bank::get_flat_rank_id<T>(node)].cmd_counters[T::m_cmds_counted("PRE")]++;
+    Bank::increment_counter<T>(node, T::m_cmds_counted["PRE"], "PRE", clk);
   }
 
   template <class T>
   void RD(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Bank::debug<T>(node, "Incrementing RD counter.", clk);
-    node->m_spec->m_power_stats[Bank::get_flat_rank_id<T>(node)].cmd_counters[T::m_cmds_counted("RD")]++;
+    Bank::increment_counter<T>(node, T::m_cmds_counted["RD"], "RD", clk);
   }
 
   template <class T>
   void WR(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Bank::debug<T>(node, "Incrementing WR counter.", clk);
-    node->m_spec->m_power_stats[Bank::get_flat_rank_id<T>(node)].cmd_counters[T::m_cmds_counted("WR")]++;
+    Bank::increment_counter<T>(node, T::m_cmds_counted["WR"], "WR", clk);
+  }
+
+  // The internal ACT, RD, WR and PRE of an on-die ECC scrub
+  template <class T>
+  void ECS(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
+    Bank::increment_counter<T>(node, T::m_cmds_counted["ACT"], "ACT", clk);
+    Bank::increment_counter<T>(node, T::m_cmds_counted["RD"], "RD", clk);
+    Bank::increment_counter<T>(node, T::m_cmds_counted["WR"], "WR", clk);
+    Bank::increment_counter<T>(node, T::m_cmds_counted["PRE"], "PRE", clk);
   }
 
   template <class T>
   void VRR(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Bank::debug<T>(node, "Incrementing VRR counter.", clk);
-    node->m_spec->m_power_stats[Bank::get_flat_rank_id<T>(node)].cmd_counters[T::m_cmds_counted("VRR")]++;
+    Bank::increment_counter<T>(node, T::m_cmds_counted["VRR"], "VRR", clk);
   }
 
   template <class T>
   void RVRR(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Bank::debug<T>(node, "Incrementing RVRR counter.", clk);
-    node->m_spec->m_power_stats[Bank::get_flat_rank_id<T>(node)].cmd_counters[T::m_cmds_counted("RVRR")]++;
+    Bank::increment_counter<T>(node, T::m_cmds_counted["RVRR"], "RVRR", clk);
   }
 }      // namespace Bank
 
@@ -79,226 +83,210 @@ namespace Bank {
 namespace Rank {
   template <class T>
   int get_flat_rank_id(typename T::Node* node) {
-    int num_ranks = node->m_spec->get_level_size("rank");
-    auto channel_node = node->m_parent_node;
-    int rank_id = node->m_node_id;
-    int channel_id = channel_node->m_node_id;
-    return channel_id * num_ranks + rank_id;
+    int num_ranks = node->m_spec->m_organization.count[T::m_levels["rank"]];
+    return node->m_parent_node->m_node_id * num_ranks + node->m_node_id;
   }
 
-  template <class T>
-  void debug(typename T::Node* node, std::string msg, Clk_t clk) {
-    if (node->m_spec->m_power_debug) {
-      std::cout << "[Power] Rank" << Rank::get_flat_rank_id<T>(node) << " " << msg << " @ " << clk << std::endl;
+  template <class T, typename... Msg>
+  void debug(typename T::Node* node, Clk_t clk, const Msg&... msg) {
+    RAMULATOR_TRACE_IF(Power, node->m_spec->m_power_debug) {
+      std::cout << "[Power] Rank" << Rank::get_flat_rank_id<T>(node) << " ";
+      (std::cout << ... << msg) << " @ " << clk << std::endl;
     }
   }
 
-  template <class T>
-  int get_open_bank_count(typename T::Node* node) {
-    int bank_count = 0;
-    if constexpr (T::m_levels["bank"] - T::m_levels["rank"] == 1) {
-      for (auto bank: node->m_child_nodes) {
-        if (bank->m_state == T::m_states["Opened"]) {
-          bank_count++;
-        }
-      }
-    } else if constexpr (T::m_levels["bank"] - T::m_levels["rank"] == 2) {
-      for (auto bg : node->m_child_nodes) {
-        for (auto bank: bg->m_child_nodes) {
-          if (bank->m_state == T::m_states["Opened"]) {
-              bank_count++;
-          }
-        }
-      }
-    }
-    return bank_count;
-  }
+  struct BankStateCounts {
+    int opened = 0;
+    int refreshing = 0;
+  };
 
+  /// Counts the opened and the refreshing banks of the rank in one pass over its banks.
   template <class T>
-  int get_refreshing_bank_count(typename T::Node* node) {
-    int bank_count = 0;
+  BankStateCounts get_bank_state_counts(typename T::Node* node) {
+    BankStateCounts counts;
+    auto count_bank = [&counts](typename T::Node* bank) {
+      if (bank->m_state == T::m_states["Opened"]) {
+        counts.opened++;
+      } else if (bank->m_state == T::m_states["Refreshing"]) {
+        counts.refreshing++;
+      }
+    };
     if constexpr (T::m_levels["bank"] - T::m_levels["rank"] == 1) {
-      for (auto bank: node->m_child_nodes) {
-        if (bank->m_state == T::m_states["Refreshing"]) {
-          bank_count++;
-        }
+      for (auto bank = node->m_children; bank != node->m_children + node->m_num_children; bank++) {
+        count_bank(bank);
       }
     } else if constexpr (T::m_levels["bank"] - T::m_levels["rank"] == 2) {
-      for (auto bg : node->m_child_nodes) {
-        for (auto bank: bg->m_child_nodes) {
-          if (bank->m_state == T::m_states["Refreshing"]) {
-              bank_count++;
-          }
+      for (auto bg = node->m_children; bg != node->m_children + node->m_num_children; bg++) {
+        for (auto bank = bg->m_children; bank != bg->m_children + bg->m_num_children; bank++) {
+          count_bank(bank);
         }
       }
     }
-    return bank_count;
+    return counts;
   }
 
   template <class T>
   void ACT(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Rank::debug<T>(node, "------ACT------", clk);
+    Rank::debug<T>(node, clk, "------ACT------");
     auto& cur_power_stats = node->m_spec->m_power_stats[Rank::get_flat_rank_id<T>(node)];
-    bool is_rank_idle = get_open_bank_count<T>(node) == 0 && get_refreshing_bank_count<T>(node) == 0;
-    
+    BankStateCounts banks = get_bank_state_counts<T>(node);
+    bool is_rank_idle = banks.opened == 0 && banks.refreshing == 0;
+
     if (is_rank_idle) {
       cur_power_stats.idle_cycles += clk - cur_power_stats.idle_start_cycle;
       cur_power_stats.active_start_cycle = clk;
-      std::string msg = "Rank is idle. idle_cycles: " + std::to_string(cur_power_stats.idle_cycles) + "    active_start_cycle: " + std::to_string(cur_power_stats.active_start_cycle);
-      Rank::debug<T>(node, msg, clk);
+      Rank::debug<T>(node, clk, "Rank is idle. idle_cycles: ", cur_power_stats.idle_cycles, "    active_start_cycle: ", cur_power_stats.active_start_cycle);
       cur_power_stats.cur_power_state = PowerStats::PowerState::ACTIVE;
     }
   }
 
   template <class T>
   void PRE(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Rank::debug<T>(node, "------PRE------", clk);
+    Rank::debug<T>(node, clk, "------PRE------");
     auto& cur_power_stats = node->m_spec->m_power_stats[Rank::get_flat_rank_id<T>(node)];
-    bool is_rank_going_idle = get_open_bank_count<T>(node) == 1 && get_refreshing_bank_count<T>(node) == 0; // TODO: AND this PRE is targetting the active bank
+    BankStateCounts banks = get_bank_state_counts<T>(node);
+    bool is_rank_going_idle = banks.opened == 1 && banks.refreshing == 0; // TODO: AND this PRE is targetting the active bank
 
     if (is_rank_going_idle) {
       cur_power_stats.active_cycles += clk - cur_power_stats.active_start_cycle;
       cur_power_stats.idle_start_cycle = clk;
-      std::string msg = "Rank is going idle. active_cycles: " + std::to_string(cur_power_stats.active_cycles) + "    idle_start_cycle: " + std::to_string(cur_power_stats.idle_start_cycle);
-      Rank::debug<T>(node, msg, clk);
+      Rank::debug<T>(node, clk, "Rank is going idle. active_cycles: ", cur_power_stats.active_cycles, "    idle_start_cycle: ", cur_power_stats.idle_start_cycle);
       cur_power_stats.cur_power_state = PowerStats::PowerState::IDLE;
     }
   }
 
   template <class T>
   void PREA(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Rank::debug<T>(node, "------PREA------", clk);
+    Rank::debug<T>(node, clk, "------PREA------");
     auto& cur_power_stats = node->m_spec->m_power_stats[Rank::get_flat_rank_id<T>(node)];
-    bool is_rank_idle = get_open_bank_count<T>(node) == 0 && get_refreshing_bank_count<T>(node) == 0;
+    BankStateCounts banks = get_bank_state_counts<T>(node);
+    bool is_rank_idle = banks.opened == 0 && banks.refreshing == 0;
 
-    assert(get_refreshing_bank_count<T>(node) == 0 && "PREA should not be called when there are refreshing banks");
+    assert(banks.refreshing == 0 && "PREA should not be called when there are refreshing banks");
 
-    cur_power_stats.cmd_counters[T::m_cmds_counted("PRE")] += get_open_bank_count<T>(node);
-    Rank::debug<T>(node, "Incrementing PRE counter.", clk);
+    cur_power_stats.cmd_counters[T::m_cmds_counted["PRE"]] += banks.opened;
+    Rank::debug<T>(node, clk, "Incrementing PRE counter.");
     if (!is_rank_idle) {
       cur_power_stats.active_cycles += clk - cur_power_stats.active_start_cycle;
       cur_power_stats.idle_start_cycle = clk;
-      std::string msg = "Rank is not idle. active_cycles: " + std::to_string(cur_power_stats.active_cycles) + "    idle_start_cycle: " + std::to_string(cur_power_stats.idle_start_cycle);
-      Rank::debug<T>(node, msg, clk);
+      Rank::debug<T>(node, clk, "Rank is not idle. active_cycles: ", cur_power_stats.active_cycles, "    idle_start_cycle: ", cur_power_stats.idle_start_cycle);
       cur_power_stats.cur_power_state = PowerStats::PowerState::IDLE;
     }    
   }
 
   template <class T>
   void REFab(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Rank::debug<T>(node, "------REFab------", clk);
+    Rank::debug<T>(node, clk, "------REFab------");
     auto& cur_power_stats = node->m_spec->m_power_stats[Rank::get_flat_rank_id<T>(node)];
-    cur_power_stats.cmd_counters[T::m_cmds_counted("REF")]++;
+    cur_power_stats.cmd_counters[T::m_cmds_counted["REF"]]++;
 
     // We assume rank is idle when REF is called
 
     cur_power_stats.idle_cycles += clk - cur_power_stats.idle_start_cycle;
-    std::string msg = "Refresh starts. idle_cycles: " + std::to_string(cur_power_stats.idle_cycles);
-    Rank::debug<T>(node, msg, clk);
+    Rank::debug<T>(node, clk, "Refresh starts. idle_cycles: ", cur_power_stats.idle_cycles);
     cur_power_stats.cur_power_state = PowerStats::PowerState::REFRESHING;
   }
 
   template <class T>
   void REFab_end(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Rank::debug<T>(node, "------REFab_end------", clk);
+    Rank::debug<T>(node, clk, "------REFab_end------");
     auto& cur_power_stats = node->m_spec->m_power_stats[Rank::get_flat_rank_id<T>(node)];
 
     cur_power_stats.idle_start_cycle = clk;
-    std::string msg = "Refresh ends. idle_start_cycle: " + std::to_string(cur_power_stats.idle_start_cycle);
-    Rank::debug<T>(node, msg, clk);
+    Rank::debug<T>(node, clk, "Refresh ends. idle_start_cycle: ", cur_power_stats.idle_start_cycle);
     cur_power_stats.cur_power_state = PowerStats::PowerState::IDLE;
   }
 
   template <class T>
   void VRR(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Rank::debug<T>(node, "------VRR------", clk);
+    Rank::debug<T>(node, clk, "------VRR------");
     auto& cur_power_stats = node->m_spec->m_power_stats[Rank::get_flat_rank_id<T>(node)];
-    bool is_rank_idle = get_open_bank_count<T>(node) == 0 && get_refreshing_bank_count<T>(node) == 0;
+    BankStateCounts banks = get_bank_state_counts<T>(node);
+    bool is_rank_idle = banks.opened == 0 && banks.refreshing == 0;
 
     if (is_rank_idle) {
       cur_power_stats.idle_cycles += clk - cur_power_stats.idle_start_cycle;
       cur_power_stats.active_start_cycle = clk;
-      std::string msg = "Rank is idle. idle_cycles: " + std::to_string(cur_power_stats.idle_cycles) + "    active_start_cycle: " + std::to_string(cur_power_stats.active_start_cycle);
-      Rank::debug<T>(node, msg, clk);
+      Rank::debug<T>(node, clk, "Rank is idle. idle_cycles: ", cur_power_stats.idle_cycles, "    active_start_cycle: ", cur_power_stats.active_start_cycle);
       cur_power_stats.cur_power_state = PowerStats::PowerState::ACTIVE;
     }
   }
   
   template <class T>
   void VRR_end(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Rank::debug<T>(node, "------VRR_end------", clk);
+    Rank::debug<T>(node, clk, "------VRR_end------");
     auto& cur_power_stats = node->m_spec->m_power_stats[Rank::get_flat_rank_id<T>(node)];
-    bool is_rank_going_idle = get_open_bank_count<T>(node) == 0 && get_refreshing_bank_count<T>(node) == 1;
+    BankStateCounts banks = get_bank_state_counts<T>(node);
+    bool is_rank_going_idle = banks.opened == 0 && banks.refreshing == 1;
 
     if (is_rank_going_idle) {
       cur_power_stats.active_cycles += clk - cur_power_stats.active_start_cycle;
       cur_power_stats.idle_start_cycle = clk;
-      std::string msg = "Rank is going idle. idle_start_cycle: " + std::to_string(cur_power_stats.idle_start_cycle) + "    active_cycles: " + std::to_string(cur_power_stats.active_cycles);
-      Rank::debug<T>(node, msg, clk);
+      Rank::debug<T>(node, clk, "Rank is going idle. idle_start_cycle: ", cur_power_stats.idle_start_cycle, "    active_cycles: ", cur_power_stats.active_cycles);
       cur_power_stats.cur_power_state = PowerStats::PowerState::IDLE;
     }
   }
 
   template <class T>
   void RFMsb(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Rank::debug<T>(node, "------RFMsb------", clk);
+    Rank::debug<T>(node, clk, "------RFMsb------");
     auto& cur_power_stats = node->m_spec->m_power_stats[Rank::get_flat_rank_id<T>(node)];
-    bool is_rank_idle = get_open_bank_count<T>(node) == 0 && get_refreshing_bank_count<T>(node) == 0;
+    BankStateCounts banks = get_bank_state_counts<T>(node);
+    bool is_rank_idle = banks.opened == 0 && banks.refreshing == 0;
 
-    cur_power_stats.cmd_counters[T::m_cmds_counted("RFM")]++;
+    cur_power_stats.cmd_counters[T::m_cmds_counted["RFM"]]++;
     if (is_rank_idle) {
       cur_power_stats.idle_cycles += clk - cur_power_stats.idle_start_cycle;
       cur_power_stats.active_start_cycle = clk;
-      std::string msg = "Rank is idle. idle_cycles: " + std::to_string(cur_power_stats.idle_cycles) + "    active_start_cycle: " + std::to_string(cur_power_stats.active_start_cycle);
-      Rank::debug<T>(node, msg, clk);
+      Rank::debug<T>(node, clk, "Rank is idle. idle_cycles: ", cur_power_stats.idle_cycles, "    active_start_cycle: ", cur_power_stats.active_start_cycle);
       cur_power_stats.cur_power_state = PowerStats::PowerState::ACTIVE;
     }
   }
 
   template <class T>
   void RFMsb_end(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Rank::debug<T>(node, "------RFMsb_end------", clk);
+    Rank::debug<T>(node, clk, "------RFMsb_end------");
     auto& cur_power_stats = node->m_spec->m_power_stats[Rank::get_flat_rank_id<T>(node)];
-    size_t num_bankgroups = node->m_child_nodes.size();
-    bool is_rank_going_idle = get_open_bank_count<T>(node) == 0 && get_refreshing_bank_count<T>(node) == num_bankgroups;
+    int num_bankgroups = node->m_num_children;
+    BankStateCounts banks = get_bank_state_counts<T>(node);
+    bool is_rank_going_idle = banks.opened == 0 && banks.refreshing == num_bankgroups;
 
     if (is_rank_going_idle) {
       cur_power_stats.active_cycles += clk - cur_power_stats.active_start_cycle;
       cur_power_stats.idle_start_cycle = clk;
-      std::string msg = "Rank is going idle. idle_start_cycle: " + std::to_string(cur_power_stats.idle_start_cycle) + "    active_cycles: " + std::to_string(cur_power_stats.active_cycles);
-      Rank::debug<T>(node, msg, clk);
+      Rank::debug<T>(node, clk, "Rank is going idle. idle_start_cycle: ", cur_power_stats.idle_start_cycle, "    active_cycles: ", cur_power_stats.active_cycles);
       cur_power_stats.cur_power_state = PowerStats::PowerState::IDLE;
     }
   }
 
   template <class T>
   void RRFMsb(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Rank::debug<T>(node, "------RRFMsb------", clk);
+    Rank::debug<T>(node, clk, "------RRFMsb------");
     auto& cur_power_stats = node->m_spec->m_power_stats[Rank::get_flat_rank_id<T>(node)];
-    bool is_rank_idle = get_open_bank_count<T>(node) == 0 && get_refreshing_bank_count<T>(node) == 0;
+    BankStateCounts banks = get_bank_state_counts<T>(node);
+    bool is_rank_idle = banks.opened == 0 && banks.refreshing == 0;
 
-    cur_power_stats.cmd_counters[T::m_cmds_counted("RRFM")]++;
+    cur_power_stats.cmd_counters[T::m_cmds_counted["RRFM"]]++;
     if (is_rank_idle) {
       cur_power_stats.idle_cycles += clk - cur_power_stats.idle_start_cycle;
       cur_power_stats.active_start_cycle = clk;
-      std::string msg = "Rank is idle. idle_cycles: " + std::to_string(cur_power_stats.idle_cycles) + "    active_start_cycle: " + std::to_string(cur_power_stats.active_start_cycle);
-      Rank::debug<T>(node, msg, clk);
+      Rank::debug<T>(node, clk, "Rank is idle. idle_cycles: ", cur_power_stats.idle_cycles, "    active_start_cycle: ", cur_power_stats.active_start_cycle);
       cur_power_stats.cur_power_state = PowerStats::PowerState::ACTIVE;
     }
   }
 
   template <class T>
   void RRFMsb_end(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Rank::debug<T>(node, "------RRFMsb_end------", clk);
+    Rank::debug<T>(node, clk, "------RRFMsb_end------");
     auto& cur_power_stats = node->m_spec->m_power_stats[Rank::get_flat_rank_id<T>(node)];
-    size_t num_bankgroups = node->m_child_nodes.size();
-    bool is_rank_going_idle = get_open_bank_count<T>(node) == 0 && get_refreshing_bank_count<T>(node) == num_bankgroups;
+    int num_bankgroups = node->m_num_children;
+    BankStateCounts banks = get_bank_state_counts<T>(node);
+    bool is_rank_going_idle = banks.opened == 0 && banks.refreshing == num_bankgroups;
 
     if (is_rank_going_idle) {
       cur_power_stats.active_cycles += clk - cur_power_stats.active_start_cycle;
       cur_power_stats.idle_start_cycle = clk;
-      std::string msg = "Rank is going idle. idle_start_cycle: " + std::to_string(cur_power_stats.idle_start_cycle) + "    active_cycles: " + std::to_string(cur_power_stats.active_cycles);
-      Rank::debug<T>(node, msg, clk);
+      Rank::debug<T>(node, clk, "Rank is going idle. idle_start_cycle: ", cur_power_stats.idle_start_cycle, "    active_cycles: ", cur_power_stats.active_cycles);
       cur_power_stats.cur_power_state = PowerStats::PowerState::IDLE;
     }
   }
@@ -309,8 +297,8 @@ namespace Rank {
 
     int open_target_banks = 0;
     bool is_rank_going_idle = true;
-    for (auto bankgroup_node : node->m_child_nodes) {
-      for (auto bank_node : bankgroup_node->m_child_nodes) {
+    for (auto bankgroup_node = node->m_children; bankgroup_node != node->m_children + node->m_num_children; bankgroup_node++) {
+      for (auto bank_node = bankgroup_node->m_children; bank_node != bankgroup_node->m_children + bankgroup_node->m_num_children; bank_node++) {
         if (bank_node->m_state == T::m_states["Opened"]) {
           if (bank_node->m_node_id == addr_vec[T::m_levels["bank"]]) {
             open_target_banks++;
@@ -321,25 +309,27 @@ namespace Rank {
       }
     }
 
-    cur_power_stats.cmd_counters[T::m_cmds_counted("PRE")] += open_target_banks;
+    cur_power_stats.cmd_counters[T::m_cmds_counted["PRE"]] += open_target_banks;
     if (is_rank_going_idle) {
       cur_power_stats.active_cycles += clk - cur_power_stats.active_start_cycle;
       cur_power_stats.idle_start_cycle = clk;
-      std::string msg = "Rank is going idle. active_cycles: " + std::to_string(cur_power_stats.active_cycles) + "    idle_start_cycle: " + std::to_string(cur_power_stats.idle_start_cycle);
-      Bank::debug<T>(node, msg, clk);
+      Rank::debug<T>(node, clk, "Rank is going idle. active_cycles: ", cur_power_stats.active_cycles, "    idle_start_cycle: ", cur_power_stats.idle_start_cycle);
       cur_power_stats.cur_power_state = PowerStats::PowerState::IDLE;
     }
   }
 
+  /// Accounts the cycles of the current power state up to clk. Can be called repeatedly (e.g., every power epoch).
   template <class T>
   void finalize_rank(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
-    Rank::debug<T>(node, "------finalize_rank------", clk);
+    Rank::debug<T>(node, clk, "------finalize_rank------");
     auto& cur_power_stats = node->m_spec->m_power_stats[Rank::get_flat_rank_id<T>(node)];
 
     if (cur_power_stats.cur_power_state == PowerStats::PowerState::IDLE) {
       cur_power_stats.idle_cycles += clk - cur_power_stats.idle_start_cycle;
+      cur_power_stats.idle_start_cycle = clk;
     } else if (cur_power_stats.cur_power_state == PowerStats::PowerState::ACTIVE) {
       cur_power_stats.active_cycles += clk - cur_power_stats.active_start_cycle;
+      cur_power_stats.active_start_cycle = clk;
     } else if (cur_power_stats.cur_power_state == PowerStats::PowerState::REFRESHING) {
       // do nothing
     }
@@ -12,7 +12,7 @@ int RequireRowOpen(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, C
   switch (node->m_state) {
     case T::m_states["Closed"]: return T::m_commands["ACT"];
     case T::m_states["Opened"]: {
-      if (node->m_row_state.find(addr_vec[T::m_levels["row"]]) != node->m_row_state.end()) {
+      if (node->m_row_state.contains(addr_vec[T::m_levels["row"]])) {
         return cmd;
       } else {
         return T::m_commands["PRE"];
@@ -26,6 +26,32 @@ int RequireRowOpen(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, C
   }
 };
 
+// With subarray-level parallelism, only an open row in the subarray of the target row has to be closed first
+template <class T>
+int RequireSubarrayRowOpen(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
+  switch (node->m_state) {
+    case T::m_states["Closed"]: return T::m_commands["ACT"];
+    case T::m_states["Opened"]: {
+      int row = addr_vec[T::m_levels["row"]];
+      if (node->m_row_state.contains(row)) {
+        return cmd;
+      }
+      const SubarrayTiming& subarrays = *node->m_spec->m_subarrays;
+      int subarray = subarrays.subarray(row);
+      bool is_conflict = false;
+      node->m_row_state.for_each([&](int open_row, int) {
+        is_conflict |= subarrays.subarray(open_row) == subarray;
+      });
+      return is_conflict ? T::m_commands["PRE"] : T::m_commands["ACT"];
+    }
+    case T::m_states["Refreshing"]: return T::m_commands["ACT"];
+    default: {
+      spdlog::error("[Preq::Bank] Invalid bank state for an RD/WR command!");
+      std::exit(-1);      
+    } 
+  }
+};
+
 template <class T>
 int RequireBankClosed(typename T::Node* node, int cmd, const AddrVec_t& addr_vec, Clk_t clk) {
   switch (node->m_state) {
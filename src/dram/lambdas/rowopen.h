@@ -19,6 +19,28 @@ namespace Bank {
       }
     }
   }
+
+  // With subarray-level parallelism, the node a request needs open is the subarray of its row
+  template <class T>
+  bool SubarrayRDWR(typename T::Node* node, int cmd, int target_id, Clk_t clk) {
+    switch (node->m_state)  {
+      case T::m_states["Closed"]: return false;
+      case T::m_states["Opened"]: {
+        const SubarrayTiming& subarrays = *node->m_spec->m_subarrays;
+        int subarray = subarrays.subarray(target_id);
+        bool is_open = false;
+        node->m_row_state.for_each([&](int row, int) {
+          is_open |= subarrays.subarray(row) == subarray;
+        });
+        return is_open;
+      }
+      case T::m_states["Refreshing"]: return false;
+      default: {
+        spdlog::error("[RowHit::Bank] Invalid bank state for an RD/WR command!");
+        std::exit(-1);      
+      }
+    }
+  }
 }       // namespace Bank
 }       // namespace RowHit
 }       // namespace Lambdas
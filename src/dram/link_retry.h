@@ -0,0 +1,192 @@
+#ifndef RAMULATOR_DRAM_LINK_RETRY_H
+#define RAMULATOR_DRAM_LINK_RETRY_H
+
+#include <vector>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+
+#include "base/type.h"
+#include "base/exception.h"
+#include "base/random.h"
+#include "dram/spec.h"
+
+namespace Ramulator {
+
+/**
+ * @brief     Errors on the data link of a device and the retries that replay the failed bursts
+ * @details
+ * Every data burst (RD, WR, RDA, WRA) carries overhead_cycles of link ECC/CRC after its nBL data cycles, and fails its
+ * link check with probability error_rate. A failed burst is replayed after retry_latency cycles (the round trip that
+ * reports the error), and the replay may fail again. Until the burst is through, the data bus of its bus level node
+ * (e.g., the HBM pseudochannel) takes no other burst, and the data of a read arrives as late as its last replay.
+ *
+ * Each channel draws its errors from its own random stream and keeps its own counters, so channels ticked in parallel
+ * do not share any state.
+ *
+ */
+class LinkRetry {
+  private:
+    int m_bus_level = -1;
+    std::vector<int> m_level_sizes;                 // Organization counts from the channel down to the bus level
+    int m_buses_per_channel = 1;
+    std::vector<DRAMCommandMeta> m_command_meta;
+    std::vector<bool> m_is_read;
+
+    double m_error_rate = 0.0;
+    Clk_t m_burst_cycles = 0;                       // nBL
+    Clk_t m_overhead_cycles = 0;
+    Clk_t m_retry_latency = 0;
+    double m_bytes_per_cycle = 0.0;                 // Data bytes a bus moves per cycle
+
+    std::vector<Clk_t> m_ready_clk;                 // When the next burst can start, per bus
+    std::vector<RandomStream> m_rngs;               // Per channel
+    std::vector<Clk_t> m_last_delay;                // Extra cycles of the last burst of each channel
+
+  public:
+    static constexpr int MAX_RETRIES = 16;          // Replays of one burst before the link gives up retrying it
+
+    std::vector<size_t> s_bursts;                   // Per channel
+    std::vector<size_t> s_retries;
+    std::vector<size_t> s_lost_cycles;              // Data bus cycles spent on link ECC and replays
+    std::vector<size_t> s_read_retry_latency;       // Cycles the replays added to the reads
+
+  public:
+    LinkRetry(const Organization& organization, int bus_level, std::vector<DRAMCommandMeta> command_meta, const std::vector<int>& read_cmds,
+              double error_rate, Clk_t burst_cycles, Clk_t overhead_cycles, Clk_t retry_latency, size_t burst_bytes, std::vector<RandomStream> rngs):
+    m_bus_level(bus_level), m_command_meta(std::move(command_meta)), m_error_rate(error_rate), m_burst_cycles(burst_cycles),
+    m_overhead_cycles(overhead_cycles), m_retry_latency(retry_latency), m_rngs(std::move(rngs)) {
+      if (error_rate < 0.0 || error_rate >= 1.0) {
+        throw ConfigurationError("The link error rate must be within [0, 1) (got {})!", error_rate);
+      }
+      if (overhead_cycles < 0 || retry_latency < 0) {
+        throw ConfigurationError("The link ECC overhead and retry latency cannot be negative!");
+      }
+      m_bytes_per_cycle = double(burst_bytes) / double(burst_cycles);
+      m_is_read.resize(m_command_meta.size(), false);
+      for (int cmd : read_cmds) {
+        m_is_read[cmd] = true;
+      }
+
+      for (int level = 0; level <= bus_level; level++) {
+        m_level_sizes.push_back(organization.count[level]);
+        if (level > 0) {
+          m_buses_per_channel *= organization.count[level];
+        }
+      }
+      int num_channels = organization.count[0];
+      m_ready_clk.resize(size_t(num_channels) * m_buses_per_channel, -1);
+      if (m_rngs.size() != size_t(num_channels)) {
+        throw ConfigurationError("The link error model needs one random stream per channel ({}, got {})!", num_channels, m_rngs.size());
+      }
+      m_last_delay.resize(num_channels, 0);
+      s_bursts.resize(num_channels, 0);
+      s_retries.resize(num_channels, 0);
+      s_lost_cycles.resize(num_channels, 0);
+      s_read_retry_latency.resize(num_channels, 0);
+    };
+
+    bool check_ready(int command, const AddrVec_t& addr_vec, Clk_t clk) const {
+      return clk >= get_ready_clk(command, addr_vec);
+    };
+
+    /// The earliest cycle the data bus allows the command (-1 = no constraint)
+    Clk_t get_ready_clk(int command, const AddrVec_t& addr_vec) const {
+      if (!m_command_meta[command].is_accessing) {
+        return -1;
+      }
+      int bus = flat_bus(addr_vec);
+      return bus == -1 ? -1 : m_ready_clk[bus];
+    };
+
+    void update_timing(int command, const AddrVec_t& addr_vec, Clk_t clk) {
+      int channel = addr_vec[0];
+      m_last_delay[channel] = 0;
+      int bus = flat_bus(addr_vec);
+      if (!m_command_meta[command].is_accessing || bus == -1) {
+        return;
+      }
+
+      std::uniform_real_distribution<double> dist(0.0, 1.0);
+      int retries = 0;
+      while (retries < MAX_RETRIES && dist(m_rngs[channel]) < m_error_rate) {
+        retries++;
+      }
+      Clk_t delay = m_overhead_cycles + retries * (m_retry_latency + m_burst_cycles + m_overhead_cycles);
+      m_ready_clk[bus] = std::max(m_ready_clk[bus], clk + m_burst_cycles + delay);
+      m_last_delay[channel] = delay;
+
+      s_bursts[channel]++;
+      s_retries[channel] += retries;
+      s_lost_cycles[channel] += delay;
+      if (m_is_read[command]) {
+        s_read_retry_latency[channel] += delay;
+      }
+    };
+
+    /// Extra cycles before the data of the last command issued to channel is through (link ECC and replays)
+    Clk_t last_delay(int channel) const { return m_last_delay[channel]; };
+
+    /// Data bytes the lost cycles of all channels could have moved
+    size_t lost_bytes() const {
+      size_t lost_cycles = 0;
+      for (size_t cycles : s_lost_cycles) {
+        lost_cycles += cycles;
+      }
+      return size_t(lost_cycles * m_bytes_per_cycle);
+    };
+
+  private:
+    int flat_bus(const AddrVec_t& addr_vec) const {
+      int id = 0;
+      for (int level = 0; level <= m_bus_level; level++) {
+        if (addr_vec[level] < 0) {
+          return -1;
+        }
+        id = id * m_level_sizes[level] + addr_vec[level];
+      }
+      return id;
+    };
+};
+
+/**
+ * @brief     Enables the link error model on a device whose timings are set, if its config asks for it. The data bus of
+ *            a burst is its node at bus_level.
+ *
+ */
+template<class T>
+void populate_link_retry(T* spec, std::string_view bus_level) {
+  if (!spec->has_param_group("link_ecc")) {
+    return;
+  }
+  double error_rate = spec->param_group("link_ecc").template param<double>("error_rate").desc("Probability that a data burst fails its link ECC/CRC check and is replayed.").default_val(0.0);
+  Clk_t overhead_cycles = spec->param_group("link_ecc").template param<Clk_t>("overhead_cycles").desc("Data bus cycles of link ECC/CRC after every burst.").default_val(0);
+  Clk_t retry_latency = spec->param_group("link_ecc").template param<Clk_t>("retry_latency").desc("Cycles from a failed burst to its replay (-1 = nCL + nBL).").default_val(-1);
+  uint64_t seed = spec->param_group("link_ecc").template param<uint64_t>("seed").desc("Seed of the link errors.").default_val(1);
+  if (error_rate == 0.0 && overhead_cycles == 0) {
+    return;
+  }
+  if (retry_latency == -1) {
+    retry_latency = spec->m_timing_vals("nCL") + spec->m_timing_vals("nBL");
+  }
+
+  std::vector<int> read_cmds = {T::m_commands("RD"), T::m_commands("RDA")};
+  std::vector<DRAMCommandMeta> command_meta(T::m_command_meta.begin(), T::m_command_meta.end());
+  size_t burst_bytes = size_t(spec->m_channel_width) / 8 * spec->m_internal_prefetch_size;
+  std::vector<RandomStream> rngs;
+  for (int channel = 0; channel < spec->m_organization.count[0]; channel++) {
+    rngs.push_back(spec->random_stream(seed, channel));
+  }
+  spec->m_link_retry = std::make_unique<LinkRetry>(spec->m_organization, T::m_levels(bus_level), std::move(command_meta), read_cmds,
+                                                   error_rate, spec->m_timing_vals("nBL"), overhead_cycles, retry_latency, burst_bytes, std::move(rngs));
+  spec->register_stat(spec->m_link_retry->s_bursts).name("link_bursts");
+  spec->register_stat(spec->m_link_retry->s_retries).name("link_retries");
+  spec->register_stat(spec->m_link_retry->s_lost_cycles).name("link_lost_cycles");
+  spec->register_stat(spec->m_link_retry->s_read_retry_latency).name("link_read_retry_latency");
+};
+
+}        // namespace Ramulator
+
+#endif   // RAMULATOR_DRAM_LINK_RETRY_H
@@ -2,13 +2,20 @@
 #define RAMULATOR_DRAM_NODE_H
 
 #include <vector>
-#include <map>
-#include <deque>
+#include <array>
+#include <bit>
 #include <functional>
 #include <concepts>
+#include <memory>
+#include <stdexcept>
+#include <span>
+#include <cstddef>
 
 #include "base/type.h"
+#include "base/checkpoint.h"
 #include "dram/spec.h"
+#include "dram/timing_table.h"
+#include "dram/subarray_timing.h"
 
 namespace Ramulator {
 
@@ -26,6 +33,110 @@ concept IsDRAMSpec = requires(T t) {
 // };
 
 
+// Upper bound on the window of a timing constraint: the widest in dram/impl is 4 (tFAW).
+inline constexpr size_t MAX_TIMING_WINDOW = 8;
+using CmdHistory_t = InlineRingBuffer<Clk_t, MAX_TIMING_WINDOW>;
+
+/**
+ * @brief     The states of the rows that are not closed in a bank-ish node: N inline slots and a bitmask of the used ones
+ * @details
+ * A bank has one open row, or a few with subarray-level parallelism, so lookups are a scan over at most N slots.
+ * Opening more than N rows at once throws std::length_error.
+ *
+ */
+template<size_t N>
+class RowStateSet {
+  public:
+    using RowId_t = int;
+    using RowState_t = int;
+
+    bool contains(RowId_t row) const { return find_slot(row) != -1; };
+    size_t size() const { return std::popcount(m_used); };
+    bool empty() const { return m_used == 0; };
+
+    /// The state of the row, inserted if the row is not tracked yet.
+    RowState_t& operator[](RowId_t row) {
+      int slot = find_slot(row);
+      if (slot == -1) {
+        slot = std::countr_one(m_used);
+        if (slot >= N) {
+          throw std::length_error("RowStateSet capacity exceeded!");
+        }
+        m_used |= 1u << slot;
+        m_rows[slot] = row;
+        m_states[slot] = -1;
+      }
+      return m_states[slot];
+    };
+
+    void erase(RowId_t row) {
+      int slot = find_slot(row);
+      if (slot != -1) {
+        m_used &= ~(1u << slot);
+      }
+    };
+    void clear() { m_used = 0; };
+
+    template<typename Func>
+    void for_each(Func&& func) const {
+      for (uint32_t used = m_used; used != 0; used &= used - 1) {
+        int slot = std::countr_zero(used);
+        func(m_rows[slot], m_states[slot]);
+      }
+    };
+
+  private:
+    static_assert(N <= 32, "RowStateSet keeps its used slots in a 32-bit mask!");
+
+    std::array<RowId_t, N> m_rows {};
+    std::array<RowState_t, N> m_states {};
+    uint32_t m_used = 0;
+
+    int find_slot(RowId_t row) const {
+      for (uint32_t used = m_used; used != 0; used &= used - 1) {
+        int slot = std::countr_zero(used);
+        if (m_rows[slot] == row) {
+          return slot;
+        }
+      }
+      return -1;
+    };
+};
+
+/**
+ * @brief     Storage for a fixed number of nodes in one allocation, constructed in order
+ *
+ */
+template<typename NodeType>
+class NodeArena {
+  private:
+    std::allocator<NodeType> m_allocator;
+    NodeType* m_nodes = nullptr;
+    size_t m_capacity = 0;
+    size_t m_size = 0;
+
+  public:
+    explicit NodeArena(size_t capacity): m_nodes(m_allocator.allocate(capacity)), m_capacity(capacity) { };
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+    ~NodeArena() {
+      std::destroy_n(m_nodes, m_size);
+      m_allocator.deallocate(m_nodes, m_capacity);
+    };
+
+    template<typename... Args>
+    NodeType* emplace(Args&&... args) {
+      if (m_size == m_capacity) {
+        throw std::length_error("NodeArena capacity exceeded!");
+      }
+      NodeType* node = std::construct_at(m_nodes + m_size, std::forward<Args>(args)...);
+      m_size++;
+      return node;
+    };
+
+    std::span<const std::byte> bytes() const { return {reinterpret_cast<const std::byte*>(m_nodes), m_size * sizeof(NodeType)}; };
+};
+
 /**
  * @brief     CRTP-ish (?) base class of a DRAM Device Node
  * 
@@ -35,6 +146,10 @@ struct DRAMNodeBase {
     using NodeType = typename T::Node;
     NodeType* m_parent_node = nullptr;
     std::vector<NodeType*> m_child_nodes;
+    NodeType* m_children = nullptr;   // m_child_nodes are adjacent in memory: m_children[0, m_num_children)
+    int m_num_children = 0;
+
+    std::unique_ptr<NodeArena<NodeType>> m_arena;   // All the nodes below me, if I am a channel
 
     T* m_spec = nullptr;
 
@@ -43,48 +158,140 @@ struct DRAMNodeBase {
     int m_size = -1;       // The size of the node (e.g., how many rows in a bank)
 
     int m_state = -1;      // The state of the node
+    int64_t m_state_version = 0;   // Number of actions that updated the states at this node (see get_state_version())
 
     std::vector<Clk_t> m_cmd_ready_clk;             // The next cycle that each command can be issued again at this level
-    std::vector<std::deque<Clk_t>> m_cmd_history;   // Issue-history of each command at this level
+    std::vector<CmdHistory_t> m_cmd_history;        // Issue-history of each command at this level, most recent first
+
+    std::unique_ptr<FlatTimingTable> m_timing_table;  // The timing state of the whole channel instead, if I am a channel and flat timing is on
+    std::unique_ptr<ReadyClkCache> m_ready_cache;     // The ready cycles of the channel computed since its last command, if I am a channel
 
     using RowId_t = int;
     using RowState_t = int;
-    std::map<RowId_t, RowState_t> m_row_state;  // The state of the rows, if I am a bank-ish node
+    RowStateSet<SubarrayTiming::MAX_SUBARRAYS> m_row_state;  // The state of the rows, if I am a bank-ish node
 
     DRAMNodeBase(T* spec, NodeType* parent, int level, int id):
     m_spec(spec), m_parent_node(parent), m_level(level), m_node_id(id) {
       int num_cmds = T::m_commands.size();
-      m_cmd_ready_clk.resize(num_cmds, -1);
-      m_cmd_history.resize(num_cmds);
-      for (int cmd = 0; cmd < num_cmds; cmd++) {
-        int window = 0;
-        for (const auto& t : spec->m_timing_cons[level][cmd]) {
-          window = std::max(window, t.window);
-        }
-        if (window != 0) {
-          m_cmd_history[cmd].resize(window, -1);
-        } else {
-          m_cmd_history[cmd].clear();
+      if (!spec->m_flat_timing) {
+        m_cmd_ready_clk.resize(num_cmds, -1);
+        m_cmd_history.resize(num_cmds);
+        for (int cmd = 0; cmd < num_cmds; cmd++) {
+          int window = 0;
+          for (const auto& t : spec->m_timing_cons[level][cmd]) {
+            window = std::max(window, t.window);
+          }
+          if (window != 0) {
+            m_cmd_history[cmd].resize(window, -1);
+          } else {
+            m_cmd_history[cmd].clear();
+          }
         }
       }
 
       m_state = spec->m_init_states[m_level];
 
-      // Recursively construct next levels
-      int next_level = level + 1;
-      int last_level = T::m_levels["row"];
-      if (next_level == last_level) {
+      if (level != 0) {
+        // The channel constructs all the levels below it
         return;
-      } else {
+      }
+
+      // Nodes exist down to the level above the rows, or to the first level without a size
+      int last_level = T::m_levels["row"];
+      int num_node_levels = 1;
+      while (num_node_levels < last_level && m_spec->m_organization.count[num_node_levels] > 0) {
+        num_node_levels++;
+      }
+
+      if (spec->m_flat_timing || spec->m_ready_clk_cache) {
+        std::vector<int> command_scopes(num_cmds);
+        for (int cmd = 0; cmd < num_cmds; cmd++) {
+          command_scopes[cmd] = spec->m_command_scopes[cmd];
+        }
+        if (spec->m_ready_clk_cache) {
+          m_ready_cache = std::make_unique<ReadyClkCache>(spec->m_organization, command_scopes, num_node_levels);
+        }
+        if (spec->m_flat_timing) {
+          m_timing_table = std::make_unique<FlatTimingTable>(spec->m_timing_cons_table, spec->m_organization, std::move(command_scopes), num_node_levels);
+        }
+      }
+
+      // Construct the next levels breadth-first in one arena, so that the children of every node are adjacent
+      size_t num_nodes = 0;
+      size_t level_size = 1;
+      for (int next_level = 1; next_level < num_node_levels; next_level++) {
+        level_size *= m_spec->m_organization.count[next_level];
+        num_nodes += level_size;
+      }
+      m_arena = std::make_unique<NodeArena<NodeType>>(num_nodes);
+
+      std::vector<NodeType*> parents = {static_cast<NodeType*>(this)};
+      std::vector<NodeType*> children;
+      for (int next_level = 1; next_level < num_node_levels; next_level++) {
         int next_level_size = m_spec->m_organization.count[next_level];
-        if (next_level_size == 0) {
-          return;
-        } else {
+        children.clear();
+        for (NodeType* parent : parents) {
           for (int i = 0; i < next_level_size; i++) {
-            NodeType* child = new NodeType(spec, static_cast<NodeType*>(this), next_level, i);
-            static_cast<NodeType*>(this)->m_child_nodes.push_back(child);
+            NodeType* child = m_arena->emplace(spec, parent, next_level, i);
+            if (i == 0) {
+              parent->m_children = child;
+            }
+            parent->m_child_nodes.push_back(child);
+            children.push_back(child);
           }
+          parent->m_num_children = next_level_size;
         }
+        parents.swap(children);
+      }
+    };
+
+    template<typename Func>
+    void for_each_node(Func&& func) {
+      func(static_cast<NodeType*>(this));
+      for (NodeType* child = m_children; child != m_children + m_num_children; child++) {
+        child->for_each_node(func);
+      }
+    };
+
+    /**
+     * @brief    Saves the open rows of all the nodes in the opened state below me (including me).
+     * 
+     */
+    void save_open_rows(std::ostream& out, int opened_state) {
+      std::vector<int> open_rows;   // (node, row, row state), the nodes numbered depth-first
+      int node_idx = 0;
+      for_each_node([&](NodeType* node) {
+        if (node->m_state == opened_state) {
+          node->m_row_state.for_each([&](int row, int row_state) {
+            open_rows.insert(open_rows.end(), {node_idx, row, row_state});
+          });
+        }
+        node_idx++;
+      });
+      Checkpoint::write(out, open_rows);
+    };
+
+    /**
+     * @brief    Reopens the rows saved by save_open_rows(). The timing state is not restored, so the nodes can take
+     *           any command the open rows allow.
+     * 
+     */
+    void load_open_rows(std::istream& in, int opened_state) {
+      std::vector<NodeType*> nodes;
+      for_each_node([&](NodeType* node) { nodes.push_back(node); });
+
+      std::vector<int> open_rows = Checkpoint::read_vector<int>(in);
+      if (open_rows.size() % 3 != 0) {
+        throw ConfigurationError("Checkpoint has malformed open rows!");
+      }
+      for (size_t i = 0; i < open_rows.size(); i += 3) {
+        if (open_rows[i] < 0 || open_rows[i] >= (int) nodes.size()) {
+          throw ConfigurationError("Checkpoint has an open row in a node that does not exist!");
+        }
+        NodeType* node = nodes[open_rows[i]];
+        node->m_state = opened_state;
+        node->m_row_state[open_rows[i + 1]] = open_rows[i + 2];
+        node->m_state_version++;
       }
     };
 
@@ -93,18 +300,19 @@ struct DRAMNodeBase {
       if (m_spec->m_actions[m_level][command]) {
         // update the state machine at this level
         m_spec->m_actions[m_level][command](static_cast<NodeType*>(this), command, child_id, clk); 
+        m_state_version++;
       }
-      if (m_level == m_spec->m_command_scopes[command] || !m_child_nodes.size()) {
+      if (m_level == m_spec->m_command_scopes[command] || m_num_children == 0) {
         // stop recursion: updated all levels
         return; 
       }
       // recursively update child nodes
       if (child_id == -1) {
-        for (auto child : m_child_nodes) {
+        for (NodeType* child = m_children; child != m_children + m_num_children; child++) {
           child->update_states(command, addr_vec, clk);
         }
       } else {
-        m_child_nodes[child_id]->update_states(command, addr_vec, clk);
+        m_children[child_id].update_states(command, addr_vec, clk);
       }
     };
 
@@ -117,31 +325,34 @@ struct DRAMNodeBase {
         // update the power model at this level
         m_spec->m_powers[m_level][command](static_cast<NodeType*>(this), command, addr_vec, clk);
       }
-      if (m_level == m_spec->m_command_scopes[command] || !m_child_nodes.size()) {
+      if (m_level == m_spec->m_command_scopes[command] || m_num_children == 0) {
         // stop recursion: updated all levels
         return; 
       }
       // recursively update child nodes
       if (child_id == -1){
-        for (auto child : m_child_nodes) {
+        for (NodeType* child = m_children; child != m_children + m_num_children; child++) {
           child->update_powers(command, addr_vec, clk);
         }
       } else {
-        m_child_nodes[child_id]->update_powers(command, addr_vec, clk);
+        m_children[child_id].update_powers(command, addr_vec, clk);
       }
     };
 
     void update_timing(int command, const AddrVec_t& addr_vec, Clk_t clk) {
+      if (m_ready_cache) {
+        m_ready_cache->invalidate();
+      }
+      if (m_timing_table) {
+        m_timing_table->update_timing(command, addr_vec, clk);
+        return;
+      }
+
       /************************************************
        *         Update Sibling Node Timing
        ***********************************************/
       if (m_node_id != addr_vec[m_level] && addr_vec[m_level] != -1) {
-        for (const auto& t : m_spec->m_timing_cons[m_level][command]) {
-          if (!t.sibling) {
-            // not sibling timing parameter
-            continue; 
-          }
-
+        for (const auto& t : m_spec->m_timing_cons_table.siblings(m_level, command)) {
           // update earliest schedulable time of every command
           Clk_t future = clk + t.val;
           m_cmd_ready_clk[t.cmd] = std::max(m_cmd_ready_clk[t.cmd], future); 
@@ -155,15 +366,10 @@ struct DRAMNodeBase {
        ***********************************************/
       // Update history
       if (m_cmd_history[command].size()) {
-        m_cmd_history[command].pop_back();
-        m_cmd_history[command].push_front(clk); 
+        m_cmd_history[command].push_front(clk);
       }
 
-      for (const auto& t : m_spec->m_timing_cons[m_level][command]) {
-        if (t.sibling) {
-          continue; 
-        }
-
+      for (const auto& t : m_spec->m_timing_cons_table.targets(m_level, command)) {
         // Get the oldest history
         Clk_t past = m_cmd_history[command][t.window-1];
         if (past < 0) {
@@ -176,13 +382,13 @@ struct DRAMNodeBase {
         m_cmd_ready_clk[t.cmd] = std::max(m_cmd_ready_clk[t.cmd], future);
       }
 
-      if (!m_child_nodes.size()) {
+      if (m_num_children == 0) {
         // stop recursion: updated all levels
         return; 
       }
 
       // recursively update all of my children
-      for (auto child : m_child_nodes) {
+      for (NodeType* child = m_children; child != m_children + m_num_children; child++) {
         child->update_timing(command, addr_vec, clk);
       }
     };
@@ -197,23 +403,48 @@ struct DRAMNodeBase {
         }
       }
 
-      if (!m_child_nodes.size()) {
+      if (m_num_children == 0) {
         // stop recursion: there were no prequisites at any level
         return command; 
       }
 
       // recursively get_preq_command at my child
-      return m_child_nodes[child_id]->get_preq_command(command, addr_vec, m_clk);
+      return m_children[child_id].get_preq_command(command, addr_vec, m_clk);
+    };
+
+    int64_t get_state_version(const AddrVec_t& addr_vec) {
+      if (m_num_children == 0) {
+        // stop recursion: reached the leaf node
+        return m_state_version;
+      }
+
+      int child_id = addr_vec[m_level + 1];
+      if (child_id == -1) {
+        // the prerequisite may depend on the states of all my children
+        return -1;
+      }
+
+      // actions at this level may also update the states of my children, so they count towards their versions
+      int64_t child_version = m_children[child_id].get_state_version(addr_vec);
+      return (child_version == -1) ? -1 : m_state_version + child_version;
     };
 
     bool check_ready(int command, const AddrVec_t& addr_vec, Clk_t clk) {
+      if (m_ready_cache) {
+        // the check passes at every level exactly when the latest ready cycle on the path has been reached
+        return clk >= get_ready_clk(command, addr_vec);
+      }
+      if (m_timing_table) {
+        return m_timing_table->check_ready(command, addr_vec, clk);
+      }
+
       if (m_cmd_ready_clk[command] != -1 && clk < m_cmd_ready_clk[command]) {
         // stop recursion: the check failed at this level
         return false; 
       }
 
       int child_id = addr_vec[m_level+1];
-      if (m_level == m_spec->m_command_scopes[command] || !m_child_nodes.size()) {
+      if (m_level == m_spec->m_command_scopes[command] || m_num_children == 0) {
         // stop recursion: the check passed at all levels
         return true; 
       }
@@ -221,13 +452,42 @@ struct DRAMNodeBase {
       if (child_id == -1) {
         // if it is a same bank command, recurse all children in rank level
         bool ready = true;
-        for (auto child : m_child_nodes) {
+        for (NodeType* child = m_children; child != m_children + m_num_children; child++) {
           ready = ready && child->check_ready(command, addr_vec, clk);
         }
         return ready;
       } else {
         // recursively check my child
-        return m_child_nodes[child_id]->check_ready(command, addr_vec, clk);
+        return m_children[child_id].check_ready(command, addr_vec, clk);
+      }
+    };
+
+    Clk_t get_ready_clk(int command, const AddrVec_t& addr_vec) {
+      if (m_ready_cache) {
+        return m_ready_cache->get(command, addr_vec, [&] { return walk_ready_clk(command, addr_vec); });
+      }
+      return walk_ready_clk(command, addr_vec);
+    };
+
+    Clk_t walk_ready_clk(int command, const AddrVec_t& addr_vec) {
+      if (m_timing_table) {
+        return m_timing_table->get_ready_clk(command, addr_vec);
+      }
+
+      // the latest ready cycle on the path check_ready() walks (-1 = no constraint)
+      Clk_t ready_clk = m_cmd_ready_clk[command];
+      if (m_level == m_spec->m_command_scopes[command] || m_num_children == 0) {
+        return ready_clk;
+      }
+
+      int child_id = addr_vec[m_level+1];
+      if (child_id == -1) {
+        for (NodeType* child = m_children; child != m_children + m_num_children; child++) {
+          ready_clk = std::max(ready_clk, child->walk_ready_clk(command, addr_vec));
+        }
+        return ready_clk;
+      } else {
+        return std::max(ready_clk, m_children[child_id].walk_ready_clk(command, addr_vec));
       }
     };
 
@@ -239,13 +499,13 @@ struct DRAMNodeBase {
         return m_spec->m_rowhits[m_level][command](static_cast<NodeType*>(this), command, child_id, m_clk);  
       }
 
-      if (!m_child_nodes.size()) {
+      if (m_num_children == 0) {
         // stop recursion: there were no row hits at any level
         return false; 
       }
 
       // recursively check for row hits at my child
-      return m_child_nodes[child_id]->check_rowbuffer_hit(command, addr_vec, m_clk);
+      return m_children[child_id].check_rowbuffer_hit(command, addr_vec, m_clk);
     };    
     
     bool check_node_open(int command, const AddrVec_t& addr_vec, Clk_t m_clk) {
@@ -255,15 +515,28 @@ struct DRAMNodeBase {
         // stop recursion: there is a row open at this level
         return m_spec->m_rowopens[m_level][command](static_cast<NodeType*>(this), command, child_id, m_clk);  
 
-      if (!m_child_nodes.size())
+      if (m_num_children == 0)
         // stop recursion: there were no row hits at any level
         return false; 
 
       // recursively check for row hits at my child
-      return m_child_nodes[child_id]->check_node_open(command, addr_vec, m_clk);
+      return m_children[child_id].check_node_open(command, addr_vec, m_clk);
     }
 };
 
+/**
+ * @brief     Builds the nodes of a channel again on the calling thread, so that their memory is first touched (and placed
+ *            on the NUMA node of) the thread that will update them, and returns the arena of the nodes below the channel.
+ *            Only before the channel is used: the old nodes and their states are discarded.
+ *
+ */
+template<typename NodeType, typename T>
+std::span<const std::byte> rebuild_channel(T* spec, std::vector<NodeType*>& channels, int channel_id) {
+  delete channels[channel_id];
+  channels[channel_id] = new NodeType(spec, nullptr, 0, channel_id);
+  return channels[channel_id]->m_arena->bytes();
+};
+
 template<class T>
 using ActionFunc_t = std::function<void(typename T::Node* node, int cmd, int target_id, Clk_t clk)>;
 template<class T>
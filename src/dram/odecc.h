@@ -0,0 +1,173 @@
+#ifndef RAMULATOR_DRAM_ODECC_H
+#define RAMULATOR_DRAM_ODECC_H
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+#include "base/type.h"
+#include "base/utils.h"
+#include "dram/dram.h"
+#include "dram/spec.h"
+
+namespace Ramulator {
+
+/**
+ * @brief     On-die ECC (ODECC) of the DDR5 devices: the internal read-modify-write of partial writes and ECS
+ * @details
+ * A DDR5 device protects every 128 data bits of its array with an on-die ECC codeword. A write that does not cover its
+ * whole codeword reads the codeword inside the device before writing it back: a masked write (WRP, the partial-write
+ * request), and any write of an x4 device, whose BL16 burst is half a codeword. Such a write keeps its bank group from
+ * taking a read for nRMW more cycles, and its bank from being precharged. The x4 tCCD_L_WR of the timing tables already
+ * includes the read-modify-write, so only the masked writes of x8/x16 devices add nRMW to it.
+ *
+ * ECS (error check and scrub) reads one codeword of a closed bank, corrects it and writes it back, keeping the bank busy
+ * for nECS cycles. The refresh manager issues an ECS to one bank of every rank each nECSint cycles, by default often
+ * enough to scrub all the codewords of the device every 24 hours.
+ *
+ * The devices list "WRP" and "ECS" in their commands, "partial-write" (at Request::Type::PartialWrite) and "ecs" in
+ * their requests, and "nRMW", "nECS" and "nECSint" in their timings. The timings are 0 with ODECC disabled.
+ *
+ */
+class OnDieECC {
+  public:
+    static constexpr int CODEWORD_BITS = 128;
+    static constexpr double SCRUB_PERIOD_NS = 24.0 * 3600.0 * 1E9;
+
+  private:
+    bool m_enabled = false;
+    std::vector<bool> m_is_rmw_write;     // Per command, the writes that read-modify-write their codeword
+    int m_ecs_command = -1;
+
+  public:
+    size_t s_rmw_writes = 0;
+    size_t s_ecs_commands = 0;
+
+  public:
+    bool is_enabled() const { return m_enabled; };
+
+    /// Whether dram is a device with its on-die ECC enabled
+    static bool is_enabled(IDRAM* dram) {
+      return dram->m_commands.contains("ECS") && (dram->m_timing_vals("nRMW") > 0 || dram->m_timing_vals("nECSint") > 0);
+    };
+
+    /// Per command of an on-die ECC device, whether it read-modify-writes its codeword
+    static std::vector<bool> rmw_writes(IDRAM* dram) {
+      std::vector<bool> is_rmw_write(dram->m_commands.size(), false);
+      is_rmw_write[dram->m_commands("WRP")] = true;
+      if (dram->m_organization.dq == 4) {
+        is_rmw_write[dram->m_commands("WR")] = true;
+        is_rmw_write[dram->m_commands("WRA")] = true;
+      }
+      return is_rmw_write;
+    };
+
+    /**
+     * @brief     Reads the ODECC parameters of the device. Call before set_timings().
+     *
+     */
+    template<class T>
+    void configure(T* spec) {
+      m_enabled = spec->has_param_group("ODECC") && spec->param_group("ODECC").template param<bool>("enable").desc("Model the read-modify-write of partial writes and the ECS operations of the on-die ECC.").default_val(false);
+      m_is_rmw_write = rmw_writes(spec);
+      m_ecs_command = T::m_commands["ECS"];
+    };
+
+    /**
+     * @brief     Sets the ODECC timings the user did not provide. Call after the user timings are applied.
+     *
+     */
+    template<class T>
+    void set_timings(T* spec, int tCK_ps) {
+      auto set_default = [spec](std::string_view timing, int value) {
+        if (spec->m_timing_vals(timing) == -1) {
+          spec->m_timing_vals(timing) = value;
+        }
+      };
+      if (!m_enabled) {
+        set_default("nRMW", 0);
+        set_default("nECS", 0);
+        set_default("nECSint", 0);
+        return;
+      }
+      // tCCD_L_WR (with the read-modify-write) minus tCCD_L_WR2 (without): max(16 nCK, 10 ns)
+      set_default("nRMW", std::max<int>(16, JEDEC_rounding_DDR5(10, tCK_ps)));
+      // The internal ACT, RD, WR and PRE of one codeword
+      set_default("nECS", spec->m_timing_vals("nRCD") + spec->m_timing_vals("nCL") + spec->m_timing_vals("nBL") +
+                          spec->m_timing_vals("nCWL") + spec->m_timing_vals("nBL") + spec->m_timing_vals("nWR") +
+                          spec->m_timing_vals("nRP"));
+      // All the codewords of the device once per scrub period
+      double num_codewords = double(spec->m_organization.density) * (1 << 20) / CODEWORD_BITS;
+      set_default("nECSint", std::max(1, int(SCRUB_PERIOD_NS * 1000.0 / num_codewords / tCK_ps)));
+    };
+
+    /**
+     * @brief     Adds the read-modify-write and ECS constraints to the timing constraints of the device.
+     *
+     */
+    template<class T>
+    void populate_timingcons(T* spec) {
+      if (!m_enabled) {
+        return;
+      }
+      #define V(timing) (spec->m_timing_vals(timing))
+      bool is_x4 = spec->m_organization.dq == 4;
+      std::vector<std::string_view> rmw_writes = {"WRP"};
+      std::vector<std::string_view> rmw_writes_no_ap = {"WRP"};
+      if (is_x4) {
+        rmw_writes = {"WR", "WRA", "WRP"};
+        rmw_writes_no_ap = {"WR", "WRP"};
+      }
+      std::vector<TimingConsInitializer> timing_cons = {
+        /*** Read-modify-write of the ODECC codeword ***/
+        {.level = "rank",      .preceding = rmw_writes_no_ap, .following = {"PREA"}, .latency = V("nCWL") + V("nBL") + V("nWR") + V("nRMW")},
+        {.level = "bankgroup", .preceding = rmw_writes, .following = {"RD", "RDA"}, .latency = V("nCCDL_WTR") + V("nRMW")},
+        {.level = "bank",      .preceding = rmw_writes_no_ap, .following = {"PRE", "PREsb"}, .latency = V("nCWL") + V("nBL") + V("nWR") + V("nRMW")},
+        {.level = "bank",      .preceding = rmw_writes_no_ap, .following = {"RDA"}, .latency = V("nCWL") + V("nBL") + V("nWR") + V("nRMW") - V("nRTP")},
+
+        /*** ECS: one codeword of a closed bank ***/
+        {.level = "rank", .preceding = {"PREA"},   .following = {"ECS"}, .latency = V("nRP")},
+        {.level = "rank", .preceding = {"REFab"},  .following = {"ECS"}, .latency = V("nRFC1")},
+        {.level = "rank", .preceding = {"RFMab"},  .following = {"ECS"}, .latency = V("nRFM1")},
+        {.level = "rank", .preceding = {"DRFMab"}, .following = {"ECS"}, .latency = V("nDRFMab")},
+        {.level = "rank", .preceding = {"ECS"},    .following = {"REFab", "RFMab", "DRFMab"}, .latency = V("nECS")},
+        {.level = "bank", .preceding = {"ACT"},    .following = {"ECS"}, .latency = V("nRC")},
+        {.level = "bank", .preceding = {"PRE", "PREsb"}, .following = {"ECS"}, .latency = V("nRP")},
+        {.level = "bank", .preceding = {"RDA"},    .following = {"ECS"}, .latency = V("nRTP") + V("nRP")},
+        {.level = "bank", .preceding = {"WRA"},    .following = {"ECS"}, .latency = V("nCWL") + V("nBL") + V("nWR") + V("nRP")},
+        {.level = "bank", .preceding = {"REFsb"},  .following = {"ECS"}, .latency = V("nRFCsb")},
+        {.level = "bank", .preceding = {"RFMsb"},  .following = {"ECS"}, .latency = V("nRFMsb")},
+        {.level = "bank", .preceding = {"DRFMsb"}, .following = {"ECS"}, .latency = V("nDRFMsb")},
+        {.level = "bank", .preceding = {"ECS"},    .following = {"ACT", "ECS", "REFsb", "RFMsb", "DRFMsb"}, .latency = V("nECS")},
+      };
+      if (is_x4) {
+        // The x4 tCCD_L_WR already includes the read-modify-write, but the auto-precharge of a WRA waits for it
+        timing_cons.push_back({.level = "bank", .preceding = {"WRA"}, .following = {"ACT", "REFsb", "RFMsb", "DRFMsb", "ECS"}, .latency = V("nCWL") + V("nBL") + V("nWR") + V("nRMW") + V("nRP")});
+      } else {
+        timing_cons.push_back({.level = "bankgroup", .preceding = {"WRP"}, .following = {"WR", "WRA", "WRP"}, .latency = V("nCCDL_WR") + V("nRMW")});
+      }
+      #undef V
+      Ramulator::populate_timingcons(spec, timing_cons);
+    };
+
+    template<class T>
+    void register_stats(T* spec) {
+      if (!m_enabled) {
+        return;
+      }
+      spec->register_stat(s_rmw_writes).name("odecc_rmw_writes");
+      spec->register_stat(s_ecs_commands).name("odecc_ecs_commands");
+    };
+
+    void on_command(int command) {
+      if (!m_enabled) {
+        return;
+      }
+      s_rmw_writes += m_is_rmw_write[command];
+      s_ecs_commands += (command == m_ecs_command);
+    };
+};
+
+}        // namespace Ramulator
+
+#endif   // RAMULATOR_DRAM_ODECC_H
@@ -3,10 +3,12 @@
 
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <unordered_map>
 #include <map>
 #include <array>
 #include <ranges>
+#include <span>
 #include <stdexcept>
 
 #include <spdlog/spdlog.h>
@@ -43,6 +45,50 @@ struct FutureAction {
   Clk_t clk;
 };
 
+/**
+ * @brief    Future actions ordered by their cycle in a min-heap, so a tick only touches the actions that are due.
+ * @details
+ * Actions due at the same cycle are handled in the reverse order they were added. Actions whose cycle has already
+ * passed when they come up are dropped without being handled.
+ *
+ */
+class FutureActionQueue {
+  private:
+    struct Entry {
+      FutureAction action;
+      uint64_t seq;
+    };
+    // The heap top is the earliest action, the most recently added one among actions of the same cycle
+    static bool later(const Entry& a, const Entry& b) {
+      return a.action.clk != b.action.clk ? a.action.clk > b.action.clk : a.seq < b.seq;
+    };
+
+    std::vector<Entry> m_heap;
+    uint64_t m_seq = 0;
+
+  public:
+    void push(FutureAction action) {
+      m_heap.push_back({std::move(action), m_seq++});
+      std::push_heap(m_heap.begin(), m_heap.end(), later);
+    };
+
+    bool empty() const { return m_heap.empty(); };
+    size_t size() const { return m_heap.size(); };
+
+    /// Removes every action due at or before clk, and calls handle(action) on the ones due exactly at clk.
+    template<typename Handler>
+    void pop_due(Clk_t clk, Handler&& handle) {
+      while (!m_heap.empty() && m_heap.front().action.clk <= clk) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), later);
+        FutureAction action = std::move(m_heap.back().action);
+        m_heap.pop_back();
+        if (action.clk == clk) {
+          handle(action);
+        }
+      }
+    };
+};
+
 // Timing Constraint
 struct TimingConsEntry {
   /// The command that the timing constraint is constraining.
@@ -65,6 +111,56 @@ struct TimingConsEntry {
 
 using TimingCons = std::vector<std::vector<std::vector<TimingConsEntry>>>;
 
+/**
+ * @brief    All timing constraints of a device in one contiguous array, indexed by (level, preceding command).
+ * @details
+ * The constraints of each (level, command) pair are stored next to each other, the ones on the siblings of the target
+ * node first, so update_timing() iterates them without chasing the pointers of the nested TimingCons vectors. Built
+ * once by populate_timingcons(). Constraints on the target with a window of 0 never apply and are dropped.
+ *
+ */
+class TimingConsTable {
+  private:
+    int m_num_cmds = 0;
+    std::vector<TimingConsEntry> m_entries;
+    std::vector<uint32_t> m_offsets;    // [2 * (level * m_num_cmds + cmd)] = first sibling, [+ 1] = first target, [+ 2] = end
+
+  public:
+    void build(const TimingCons& timing_cons) {
+      m_num_cmds = timing_cons.empty() ? 0 : timing_cons[0].size();
+      m_entries.clear();
+      m_offsets.assign(1, 0);
+      for (const auto& level_cons : timing_cons) {
+        for (const auto& cmd_cons : level_cons) {
+          for (const auto& t : cmd_cons) {
+            if (t.sibling) {
+              m_entries.push_back(t);
+            }
+          }
+          m_offsets.push_back(m_entries.size());
+          for (const auto& t : cmd_cons) {
+            if (!t.sibling && t.window > 0) {
+              m_entries.push_back(t);
+            }
+          }
+          m_offsets.push_back(m_entries.size());
+        }
+      }
+    };
+
+    /// The constraints that a command at this level puts on the siblings of its target node.
+    std::span<const TimingConsEntry> siblings(int level, int cmd) const {
+      size_t idx = 2 * (size_t(level) * m_num_cmds + cmd);
+      return {m_entries.data() + m_offsets[idx], m_entries.data() + m_offsets[idx + 1]};
+    };
+
+    /// The constraints that a command at this level puts on its target node, based on the history of the command.
+    std::span<const TimingConsEntry> targets(int level, int cmd) const {
+      size_t idx = 2 * (size_t(level) * m_num_cmds + cmd);
+      return {m_entries.data() + m_offsets[idx + 1], m_entries.data() + m_offsets[idx + 2]};
+    };
+};
+
 // // TODO: Write a expression parser and evaluator
 // template<class T>
 // int EvalTimingExpr(T* spec, std::string_view expr) {
@@ -95,6 +191,7 @@ void populate_timingcons(T* spec, std::vector<TimingConsInitializer> initializer
       }
     }
   }
+  spec->m_timing_cons_table.build(spec->m_timing_cons);
 };
 
 
@@ -311,6 +408,17 @@ struct PowerStats {
     double total_cmd_energy = 0;
     double total_energy = 0;
 
+    // The command energy by command (other: the device-specific commands, e.g., RFM or VRR)
+    double act_cmd_energy = 0;
+    double pre_cmd_energy = 0;
+    double rd_cmd_energy = 0;
+    double wr_cmd_energy = 0;
+    double ref_cmd_energy = 0;
+    double other_cmd_energy = 0;
+
+    double epoch_start_energy = 0;  // total_energy at the start of the power epoch
+    double epoch_power = 0;         // Average power over the last power epoch (mW)
+
     std::vector<size_t> cmd_counters;
 
     Clk_t active_cycles = 0;
@@ -0,0 +1,226 @@
+#ifndef RAMULATOR_DRAM_SUBARRAY_TIMING_H
+#define RAMULATOR_DRAM_SUBARRAY_TIMING_H
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <string_view>
+
+#include "base/type.h"
+#include "base/exception.h"
+#include "dram/spec.h"
+
+namespace Ramulator {
+
+/**
+ * @brief     Subarray-level parallelism (MASA, Kim et al., ISCA'12) for the devices whose deepest node level is the bank
+ * @details
+ * The rows of a bank are split into num_subarrays groups of consecutive rows, each with its own local row buffer, so a
+ * bank holds up to one open row per subarray. The bank-level constraints between the row commands (ACT, PRE, RD, WR,
+ * RDA, WRA), e.g., nRCD, nRAS, nRP, nRC and nRTP, are taken out of the node tree and kept here per subarray, so they
+ * only hold between commands to the same subarray: a bank can activate or precharge one subarray while another one is
+ * being read. The other bank-level constraints (e.g., ACT to a same-bank refresh) stay on the bank. A column command to
+ * another subarray than the previous column command of its bank waits switch_latency more cycles (the subarray select of
+ * MASA). A row command without a row (-1) applies to all the subarrays of its bank.
+ *
+ */
+class SubarrayTiming {
+  private:
+    int m_bank_level = -1;
+    int m_row_level = -1;
+    int m_num_subarrays = 1;
+    int m_rows_per_subarray = 1;
+    Clk_t m_switch_latency = 0;
+    int m_num_cmds = 0;
+
+    std::vector<int> m_level_sizes;                         // Organization counts from the channel down to the bank
+    int m_banks_per_channel = 1;
+    std::vector<bool> m_is_row_cmd;
+    std::vector<DRAMCommandMeta> m_command_meta;
+    std::vector<std::vector<TimingConsEntry>> m_cons;      // [preceding cmd], the moved bank-level constraints
+
+    std::vector<Clk_t> m_ready_clk;                         // [(bank * num_subarrays + subarray) * num_cmds + cmd]
+    std::vector<uint32_t> m_open;                           // Subarrays with an open row, a bit per subarray, per bank
+    std::vector<int> m_column_subarray;                     // Subarray of the last column command of each bank (-1: none)
+    std::vector<Clk_t> m_switch_ready_clk;                  // When a column command to another subarray can issue, per bank
+
+  public:
+    std::vector<size_t> s_parallel_activations;             // ACTs to a bank with another subarray open, per channel
+
+  public:
+    static constexpr int MAX_SUBARRAYS = 8;                 // The open rows a bank node tracks (DRAMNodeBase::m_row_state)
+
+    /**
+     * @brief     Takes the bank-level constraints among row_cmds out of timing_cons (the caller rebuilds its table)
+     *
+     */
+    SubarrayTiming(const Organization& organization, int bank_level, int row_level, int num_subarrays, Clk_t switch_latency,
+                   const std::vector<int>& row_cmds, std::vector<DRAMCommandMeta> command_meta, TimingCons& timing_cons):
+    m_bank_level(bank_level), m_row_level(row_level), m_num_subarrays(num_subarrays), m_switch_latency(switch_latency),
+    m_num_cmds(command_meta.size()), m_command_meta(std::move(command_meta)) {
+      int num_rows = organization.count[row_level];
+      if (num_subarrays < 2 || num_subarrays > MAX_SUBARRAYS || num_rows % num_subarrays != 0) {
+        throw ConfigurationError("The number of subarrays ({}) must be within [2, {}] and divide the {} rows of a bank!",
+                                 num_subarrays, MAX_SUBARRAYS, num_rows);
+      }
+      if (switch_latency < 0) {
+        throw ConfigurationError("The subarray switch latency cannot be negative!");
+      }
+      m_rows_per_subarray = num_rows / num_subarrays;
+
+      for (int level = 0; level <= bank_level; level++) {
+        m_level_sizes.push_back(organization.count[level]);
+        if (level > 0) {
+          m_banks_per_channel *= organization.count[level];
+        }
+      }
+      int num_banks = m_banks_per_channel * organization.count[0];
+
+      m_is_row_cmd.resize(m_num_cmds, false);
+      for (int cmd : row_cmds) {
+        m_is_row_cmd[cmd] = true;
+      }
+      m_cons.resize(m_num_cmds);
+      for (int p_cmd = 0; p_cmd < m_num_cmds; p_cmd++) {
+        std::vector<TimingConsEntry>& bank_cons = timing_cons[bank_level][p_cmd];
+        if (!m_is_row_cmd[p_cmd]) {
+          continue;
+        }
+        auto moved = std::stable_partition(bank_cons.begin(), bank_cons.end(), [&](const TimingConsEntry& t) {
+          return t.sibling || t.window != 1 || !m_is_row_cmd[t.cmd];
+        });
+        m_cons[p_cmd].assign(moved, bank_cons.end());
+        bank_cons.erase(moved, bank_cons.end());
+      }
+
+      m_ready_clk.resize(size_t(num_banks) * num_subarrays * m_num_cmds, -1);
+      m_open.resize(num_banks, 0);
+      m_column_subarray.resize(num_banks, -1);
+      m_switch_ready_clk.resize(num_banks, -1);
+      s_parallel_activations.resize(organization.count[0], 0);
+    };
+
+    int num_subarrays() const { return m_num_subarrays; };
+    int subarray(int row) const { return row < 0 ? -1 : row / m_rows_per_subarray; };
+
+    bool check_ready(int command, const AddrVec_t& addr_vec, Clk_t clk) const {
+      return clk >= get_ready_clk(command, addr_vec);
+    };
+
+    /// The earliest cycle the subarray constraints allow the command (-1 = no constraint)
+    Clk_t get_ready_clk(int command, const AddrVec_t& addr_vec) const {
+      if (!m_is_row_cmd[command]) {
+        return -1;
+      }
+      int bank = flat_bank(addr_vec);
+      if (bank == -1) {
+        return -1;
+      }
+      int sa = subarray(addr_vec[m_row_level]);
+      Clk_t ready_clk = -1;
+      int first = (sa == -1) ? 0 : sa;
+      int last = (sa == -1) ? m_num_subarrays : sa + 1;
+      for (int s = first; s < last; s++) {
+        ready_clk = std::max(ready_clk, m_ready_clk[index(bank, s, command)]);
+      }
+      if (m_command_meta[command].is_accessing && sa != -1 && m_column_subarray[bank] != -1 && m_column_subarray[bank] != sa) {
+        ready_clk = std::max(ready_clk, m_switch_ready_clk[bank]);
+      }
+      return ready_clk;
+    };
+
+    void update_timing(int command, const AddrVec_t& addr_vec, Clk_t clk) {
+      const DRAMCommandMeta& meta = m_command_meta[command];
+      int bank = flat_bank(addr_vec);
+      if (!m_is_row_cmd[command] || bank == -1) {
+        // Closes and refreshes of several banks close all their subarrays
+        if (meta.is_closing || meta.is_refreshing) {
+          for_each_bank(addr_vec, 0, 0, [&](int b) { m_open[b] = 0; });
+        }
+        return;
+      }
+
+      int sa = subarray(addr_vec[m_row_level]);
+      int first = (sa == -1) ? 0 : sa;
+      int last = (sa == -1) ? m_num_subarrays : sa + 1;
+      for (int s = first; s < last; s++) {
+        for (const auto& t : m_cons[command]) {
+          Clk_t& ready_clk = m_ready_clk[index(bank, s, t.cmd)];
+          ready_clk = std::max(ready_clk, clk + t.val);
+        }
+      }
+
+      if (meta.is_opening && sa != -1) {
+        if (m_open[bank] & ~(1u << sa)) {
+          s_parallel_activations[addr_vec[0]]++;
+        }
+        m_open[bank] |= 1u << sa;
+      }
+      if (meta.is_accessing && sa != -1) {
+        m_column_subarray[bank] = sa;
+        m_switch_ready_clk[bank] = clk + m_switch_latency;
+      }
+      if (meta.is_closing) {
+        m_open[bank] &= (sa == -1) ? 0 : ~(1u << sa);
+      }
+    };
+
+  private:
+    size_t index(int bank, int sa, int cmd) const {
+      return (size_t(bank) * m_num_subarrays + sa) * m_num_cmds + cmd;
+    };
+
+    int flat_bank(const AddrVec_t& addr_vec) const {
+      int id = 0;
+      for (int level = 0; level <= m_bank_level; level++) {
+        if (addr_vec[level] < 0) {
+          return -1;
+        }
+        id = id * m_level_sizes[level] + addr_vec[level];
+      }
+      return id;
+    };
+
+    template<typename Func>
+    void for_each_bank(const AddrVec_t& addr_vec, int level, int id, Func&& func) {
+      if (level > m_bank_level) {
+        func(id);
+        return;
+      }
+      if (addr_vec[level] >= 0) {
+        for_each_bank(addr_vec, level + 1, id * m_level_sizes[level] + addr_vec[level], func);
+        return;
+      }
+      for (int node = 0; node < m_level_sizes[level]; node++) {
+        for_each_bank(addr_vec, level + 1, id * m_level_sizes[level] + node, func);
+      }
+    };
+};
+
+/**
+ * @brief     Enables subarray-level parallelism on a device whose timing constraints are populated, if its config asks
+ *            for subarrays. Must run before the nodes are created.
+ *
+ */
+template<class T>
+void populate_subarrays(T* spec) {
+  int num_subarrays = spec->template param<int>("subarrays").desc("Subarrays per bank with their own row buffer (subarray-level parallelism, 1 = off).").default_val(1);
+  Clk_t switch_latency = spec->template param<Clk_t>("subarray_switch_latency").desc("Extra cycles of a column command to another subarray than the previous one of its bank.").default_val(0);
+  if (num_subarrays <= 1) {
+    return;
+  }
+
+  std::vector<int> row_cmds;
+  for (std::string_view name : {"ACT", "PRE", "RD", "WR", "RDA", "WRA"}) {
+    row_cmds.push_back(T::m_commands(name));
+  }
+  std::vector<DRAMCommandMeta> command_meta(T::m_command_meta.begin(), T::m_command_meta.end());
+  spec->m_subarrays = std::make_unique<SubarrayTiming>(spec->m_organization, T::m_levels["bank"], T::m_levels["row"], num_subarrays,
+                                                       switch_latency, row_cmds, std::move(command_meta), spec->m_timing_cons);
+  spec->m_timing_cons_table.build(spec->m_timing_cons);
+  spec->register_stat(spec->m_subarrays->s_parallel_activations).name("salp_parallel_activations");
+};
+
+}        // namespace Ramulator
+
+#endif   // RAMULATOR_DRAM_SUBARRAY_TIMING_H
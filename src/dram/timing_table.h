@@ -0,0 +1,264 @@
+#ifndef RAMULATOR_DRAM_TIMING_TABLE_H
+#define RAMULATOR_DRAM_TIMING_TABLE_H
+
+#include <vector>
+#include <algorithm>
+
+#include "base/type.h"
+#include "dram/spec.h"
+
+namespace Ramulator {
+
+/**
+ * @brief     The timing state (ready cycles and command histories) of one channel, stored per level in flat arrays
+ * @details
+ * The nodes of a level are numbered in order, so the children of node p at the next level are the contiguous ids
+ * [p * fanout, (p + 1) * fanout). The ready cycles of a level are stored command-major ([cmd][node]), which turns the
+ * sibling updates of DRAMNodeBase::update_timing() into loops over contiguous arrays. Each command with a timing window
+ * keeps window entries of history per node, most recent first. The results are the same as those of the node tree.
+ *
+ */
+class FlatTimingTable {
+  private:
+    struct LevelTable {
+      int num_nodes = 0;                    // Nodes of this level in the channel
+      int fanout = 0;                       // Nodes of this level under each node of the level above
+
+      std::vector<Clk_t> ready_clk;         // [cmd * num_nodes + node], -1 = no constraint
+      std::vector<int> history_window;      // Entries of history kept per node for each command (0 = none)
+      std::vector<int> history_offset;      // Start of the history of each command in history
+      std::vector<Clk_t> history;           // [history_offset[cmd] + node * window + i], i = 0 is the most recent
+    };
+
+    const TimingConsTable& m_timing_cons;
+    int m_num_cmds = 0;
+    std::vector<LevelTable> m_levels;
+    std::vector<int> m_command_scopes;
+
+    std::vector<int> m_targets;           // Scratch: the target nodes of the level being updated
+    std::vector<int> m_next_targets;
+
+  public:
+    /**
+     * @brief     Builds the tables for the node levels [0, num_node_levels) of one channel
+     *
+     */
+    FlatTimingTable(const TimingConsTable& timing_cons, const Organization& organization, std::vector<int> command_scopes, int num_node_levels):
+    m_timing_cons(timing_cons), m_num_cmds(command_scopes.size()), m_command_scopes(std::move(command_scopes)) {
+      int num_nodes = 1;
+      for (int level = 0; level < num_node_levels; level++) {
+        LevelTable& table = m_levels.emplace_back();
+        table.fanout = (level == 0) ? 1 : organization.count[level];
+        num_nodes *= table.fanout;
+        table.num_nodes = num_nodes;
+
+        table.ready_clk.resize(size_t(m_num_cmds) * num_nodes, -1);
+        table.history_window.resize(m_num_cmds, 0);
+        table.history_offset.resize(m_num_cmds, 0);
+
+        size_t history_size = 0;
+        for (int cmd = 0; cmd < m_num_cmds; cmd++) {
+          int window = 0;
+          for (const auto& t : timing_cons.siblings(level, cmd)) {
+            window = std::max(window, t.window);
+          }
+          for (const auto& t : timing_cons.targets(level, cmd)) {
+            window = std::max(window, t.window);
+          }
+          table.history_window[cmd] = window;
+          table.history_offset[cmd] = history_size;
+          history_size += size_t(window) * num_nodes;
+        }
+        table.history.resize(history_size, -1);
+      }
+
+      m_targets.reserve(m_levels.back().num_nodes);
+      m_next_targets.reserve(m_levels.back().num_nodes);
+    };
+
+    void update_timing(int command, const AddrVec_t& addr_vec, Clk_t clk) {
+      m_targets.assign(1, 0);
+      for (int level = 0; level < m_levels.size(); level++) {
+        LevelTable& table = m_levels[level];
+
+        if (level > 0) {
+          // The targets of this level are the children of the last targets. The other children are their siblings.
+          int child_id = addr_vec[level];
+          m_next_targets.clear();
+          for (int parent : m_targets) {
+            int first = parent * table.fanout;
+            if (child_id == -1) {
+              for (int node = first; node < first + table.fanout; node++) {
+                m_next_targets.push_back(node);
+              }
+            } else {
+              m_next_targets.push_back(first + child_id);
+              update_siblings(level, command, first, first + child_id, clk);
+              update_siblings(level, command, first + child_id + 1, first + table.fanout, clk);
+            }
+          }
+          m_targets.swap(m_next_targets);
+        }
+
+        for (int node : m_targets) {
+          update_target(level, command, node, clk);
+        }
+      }
+    };
+
+    bool check_ready(int command, const AddrVec_t& addr_vec, Clk_t clk) const {
+      return check_ready(command, addr_vec, clk, 0, 0);
+    };
+
+    Clk_t get_ready_clk(int command, const AddrVec_t& addr_vec) const {
+      return get_ready_clk(command, addr_vec, 0, 0);
+    };
+
+  private:
+    void update_siblings(int level, int command, int first, int last, Clk_t clk) {
+      LevelTable& table = m_levels[level];
+      for (const auto& t : m_timing_cons.siblings(level, command)) {
+        // update earliest schedulable time of every command
+        Clk_t future = clk + t.val;
+        Clk_t* ready_clk = table.ready_clk.data() + size_t(t.cmd) * table.num_nodes;
+        for (int node = first; node < last; node++) {
+          ready_clk[node] = std::max(ready_clk[node], future);
+        }
+      }
+    };
+
+    void update_target(int level, int command, int node, Clk_t clk) {
+      LevelTable& table = m_levels[level];
+      int window = table.history_window[command];
+      if (window == 0) {
+        return;
+      }
+
+      // Update history
+      Clk_t* history = table.history.data() + table.history_offset[command] + size_t(node) * window;
+      std::copy_backward(history, history + window - 1, history + window);
+      history[0] = clk;
+
+      for (const auto& t : m_timing_cons.targets(level, command)) {
+        // Get the oldest history
+        Clk_t past = history[t.window - 1];
+        if (past < 0) {
+          // not enough history
+          continue;
+        }
+
+        // update earliest schedulable time of every command
+        Clk_t& ready_clk = table.ready_clk[size_t(t.cmd) * table.num_nodes + node];
+        ready_clk = std::max(ready_clk, past + t.val);
+      }
+    };
+
+    bool check_ready(int command, const AddrVec_t& addr_vec, Clk_t clk, int level, int node) const {
+      Clk_t ready_clk = m_levels[level].ready_clk[size_t(command) * m_levels[level].num_nodes + node];
+      if (ready_clk != -1 && clk < ready_clk) {
+        return false;
+      }
+
+      if (level == m_command_scopes[command] || level + 1 == m_levels.size()) {
+        return true;
+      }
+
+      int fanout = m_levels[level + 1].fanout;
+      int child_id = addr_vec[level + 1];
+      if (child_id == -1) {
+        for (int child = node * fanout; child < (node + 1) * fanout; child++) {
+          if (!check_ready(command, addr_vec, clk, level + 1, child)) {
+            return false;
+          }
+        }
+        return true;
+      }
+      return check_ready(command, addr_vec, clk, level + 1, node * fanout + child_id);
+    };
+
+    Clk_t get_ready_clk(int command, const AddrVec_t& addr_vec, int level, int node) const {
+      Clk_t ready_clk = m_levels[level].ready_clk[size_t(command) * m_levels[level].num_nodes + node];
+      if (level == m_command_scopes[command] || level + 1 == m_levels.size()) {
+        return ready_clk;
+      }
+
+      int fanout = m_levels[level + 1].fanout;
+      int child_id = addr_vec[level + 1];
+      if (child_id == -1) {
+        for (int child = node * fanout; child < (node + 1) * fanout; child++) {
+          ready_clk = std::max(ready_clk, get_ready_clk(command, addr_vec, level + 1, child));
+        }
+        return ready_clk;
+      }
+      return std::max(ready_clk, get_ready_clk(command, addr_vec, level + 1, node * fanout + child_id));
+    };
+};
+
+/**
+ * @brief     Memo of the earliest ready cycle of each (command, node) pair of one channel
+ * @details
+ * The earliest cycle a command can be issued to a node only changes when a command is issued to the channel, so the
+ * entries stay valid across cycles. invalidate() drops all of them in O(1) by bumping a version. A command is keyed by
+ * the node at its scope (or at the last node level), and addresses with wildcards on that path are not cached.
+ *
+ */
+class ReadyClkCache {
+  private:
+    struct Entry {
+      int64_t version = -1;
+      Clk_t ready_clk = -1;
+    };
+
+    std::vector<int> m_level_counts;      // Organization counts of the node levels
+    std::vector<int> m_key_levels;        // The level each command is keyed at
+    std::vector<size_t> m_offsets;        // Start of the entries of each command in m_entries
+    std::vector<Entry> m_entries;         // [m_offsets[cmd] + flat id of the node at m_key_levels[cmd]]
+    int64_t m_version = 0;
+
+  public:
+    ReadyClkCache(const Organization& organization, const std::vector<int>& command_scopes, int num_node_levels) {
+      std::vector<size_t> num_nodes(num_node_levels, 1);
+      m_level_counts.resize(num_node_levels, 1);
+      for (int level = 1; level < num_node_levels; level++) {
+        m_level_counts[level] = organization.count[level];
+        num_nodes[level] = num_nodes[level - 1] * m_level_counts[level];
+      }
+
+      size_t num_entries = 0;
+      for (int scope : command_scopes) {
+        int key_level = std::min(scope, num_node_levels - 1);
+        m_key_levels.push_back(key_level);
+        m_offsets.push_back(num_entries);
+        num_entries += num_nodes[key_level];
+      }
+      m_entries.resize(num_entries);
+    };
+
+    void invalidate() { m_version++; };
+
+    /**
+     * @brief     Returns the cached ready cycle of the command to addr_vec, calling compute() if there is none
+     *
+     */
+    template<typename F>
+    Clk_t get(int command, const AddrVec_t& addr_vec, F&& compute) {
+      size_t node = 0;
+      for (int level = 1; level <= m_key_levels[command]; level++) {
+        if (addr_vec[level] == -1) {
+          return compute();
+        }
+        node = node * m_level_counts[level] + addr_vec[level];
+      }
+
+      Entry& entry = m_entries[m_offsets[command] + node];
+      if (entry.version != m_version) {
+        entry.ready_clk = compute();
+        entry.version = m_version;
+      }
+      return entry.ready_clk;
+    };
+};
+
+}        // namespace Ramulator
+
+#endif   // RAMULATOR_DRAM_TIMING_TABLE_H
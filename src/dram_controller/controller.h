@@ -28,6 +28,11 @@ class IDRAMController : public Clocked<IDRAMController> {
     std::vector<IControllerPlugin*> m_plugins;
 
     int m_channel_id = -1;
+
+    CommandEvent m_command_event;       // The command issued in this cycle, valid in the plugins' update(true, ...)
+
+  private:
+    int m_event_row_level = -1;
   public:
     /**
      * @brief       Send a request to the memory controller.
@@ -44,14 +49,127 @@ class IDRAMController : public Clocked<IDRAMController> {
      */
     virtual bool priority_send(Request& req) = 0;
 
+    /**
+     * @brief       Whether the read and write buffers hold no demand requests (e.g., for idle-time maintenance).
+     * 
+     */
+    virtual bool is_demand_idle() = 0;
+
+    /**
+     * @brief       Hands read data that a plugin assembled from several bursts (e.g., a whole ECC codeword) to the
+     *              controller's decoder stage, which calls the callback of req when it is done. Controllers without a
+     *              decoder stage call it right away.
+     * 
+     */
+    virtual void complete_read(Request& req) {
+      if (req.callback) {
+        req.callback(req);
+      }
+    };
+
+    /**
+     * @brief       Number of requests in the active buffer (i.e., with an opened row) to the bank(s) of addr_vec.
+     * @details
+     * Wildcards (-1) at or above the bank level match every node at that level, so e.g. a rank-level address
+     * counts all requests to that rank. A closing command to addr_vec is only safe when this is 0.
+     * 
+     */
+    virtual int num_active_requests(const AddrVec_t& addr_vec) = 0;
+
+    /**
+     * @brief       Number of requests in the read and write buffers to the row of addr_vec (e.g., for a row policy that
+     *              closes idle rows). Controllers that do not track this return 0.
+     * 
+     */
+    virtual int num_row_requests(const AddrVec_t& addr_vec) { return 0; };
+
     /**
      * @brief       Ticks the memory controller.
      * 
      */
     virtual void tick() = 0;
+
+    /**
+     * @brief       Number of upcoming ticks that are guaranteed not to issue a command, send a request or call a callback.
+     * @details
+     * An event-driven memory system does not tick the controller for these cycles and later catches up on them with
+     * skip_cycles() (e.g., before the next send()). 0 (the default) means the controller has to be ticked every cycle.
+     * 
+     */
+    virtual Clk_t get_idle_cycles() { return 0; };
+
+    /**
+     * @brief       Advances the controller by num_cycles idle cycles (at most get_idle_cycles()), keeping its statistics
+     *              as if it had been ticked.
+     * 
+     */
+    virtual void skip_cycles(Clk_t num_cycles) {
+      for (Clk_t i = 0; i < num_cycles; i++) {
+        tick();
+      }
+    };
+
+    /**
+     * @brief       Decodes the command of req, which is issued in this cycle, into m_command_event. Controllers call
+     *              this before updating the plugins with the request (is_same_cycle for a second command in the cycle).
+     * 
+     */
+    void decode_command(const Request& req, bool is_same_cycle = false) {
+      if (m_event_row_level < 0) {
+        m_event_row_level = m_dram->m_levels("row");
+      }
+
+      CommandEvent& event = m_command_event;
+      const DRAMCommandMeta& meta = m_dram->m_command_meta(req.command);
+      event.command = req.command;
+      event.scope = m_dram->m_command_scopes(req.command);
+      event.is_opening = meta.is_opening;
+      event.is_closing = meta.is_closing;
+      event.is_refreshing = meta.is_refreshing;
+      event.is_activation = meta.is_opening && event.scope == m_event_row_level;
+      event.flat_rank = event.scope >= m_dram->m_flat_bank_first_level ? req.addr_vec[m_dram->m_flat_bank_first_level] : -1;
+      // A wildcard (e.g., the bankgroups of a same-bank refresh) leaves the bank at -1
+      event.flat_bank = event.scope >= m_dram->m_flat_bank_last_level ? m_dram->flat_bank_id(req.addr_vec) : -1;
+      event.row = event.scope >= m_event_row_level ? req.addr_vec[m_event_row_level] : -1;
+      event.clk = m_clk;
+      event.is_same_cycle = is_same_cycle;
+    };
+
+    /**
+     * @brief       Offers an incoming request to the plugins that subscribed to requests. Returns true if one of them
+     *              serves it (see IControllerPlugin::serve_request()).
+     * 
+     */
+    bool serve_by_plugins(Request& req) {
+      for (auto plugin : m_plugins) {
+        if (plugin->get_subscription().requests && plugin->serve_request(req)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /**
+     * @brief       The first plugin that implements T (e.g., an interface a scheduler depends on), or nullptr.
+     * 
+     */
+    template <class T>
+    T* get_plugin() {
+      for (auto plugin : m_plugins) {
+        T* cast = dynamic_cast<T*>(plugin);
+        if (cast) {
+          return cast;
+        }
+      }
+      return nullptr;
+    }
    
 };
 
+inline bool IControllerPlugin::is_new_cycle(bool request_found) const {
+  return !request_found || !m_ctrl->m_command_event.is_same_cycle;
+}
+
 }       // namespace Ramulator
 
 #endif  // RAMULATOR_CONTROLLER_CONTROLLER_H
\ No newline at end of file
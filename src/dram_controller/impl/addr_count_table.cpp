@@ -0,0 +1,67 @@
+#include "dram_controller/impl/addr_count_table.h"
+
+namespace Ramulator {
+
+AddrCountTable::AddrCountTable(): m_entries(64), m_mask(63) {};
+
+size_t AddrCountTable::home_slot(Addr_t addr) const {
+  uint64_t h = static_cast<uint64_t>(addr) * 0x9E3779B97F4A7C15ull;
+  return (h ^ (h >> 32)) & m_mask;
+}
+
+size_t AddrCountTable::find_slot(Addr_t addr) const {
+  size_t slot = home_slot(addr);
+  while (m_entries[slot].count != 0 && m_entries[slot].addr != addr) {
+    slot = (slot + 1) & m_mask;
+  }
+  return slot;
+}
+
+bool AddrCountTable::contains(Addr_t addr) const {
+  return m_entries[find_slot(addr)].count != 0;
+}
+
+void AddrCountTable::insert(Addr_t addr) {
+  if (2 * (m_size + 1) > m_entries.size()) {
+    grow();
+  }
+  Entry& entry = m_entries[find_slot(addr)];
+  if (entry.count == 0) {
+    entry.addr = addr;
+    m_size++;
+  }
+  entry.count++;
+}
+
+void AddrCountTable::erase(Addr_t addr) {
+  size_t slot = find_slot(addr);
+  if (m_entries[slot].count == 0 || --m_entries[slot].count != 0) {
+    return;
+  }
+  m_size--;
+
+  // Backward-shift deletion: pull later entries of the probe sequence into the hole unless they would move
+  // before their home slot
+  size_t hole = slot;
+  for (size_t next = (hole + 1) & m_mask; m_entries[next].count != 0; next = (next + 1) & m_mask) {
+    size_t home = home_slot(m_entries[next].addr);
+    if (((next - home) & m_mask) >= ((next - hole) & m_mask)) {
+      m_entries[hole] = m_entries[next];
+      hole = next;
+    }
+  }
+  m_entries[hole] = Entry();
+}
+
+void AddrCountTable::grow() {
+  std::vector<Entry> old_entries(m_entries.size() * 2);
+  old_entries.swap(m_entries);
+  m_mask = m_entries.size() - 1;
+  for (const Entry& entry : old_entries) {
+    if (entry.count != 0) {
+      m_entries[find_slot(entry.addr)] = entry;
+    }
+  }
+}
+
+}        // namespace Ramulator
@@ -0,0 +1,45 @@
+#ifndef RAMULATOR_CONTROLLER_ADDR_COUNT_TABLE_H
+#define RAMULATOR_CONTROLLER_ADDR_COUNT_TABLE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "base/type.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Open-addressing multiset of addresses: how many requests to each address are in a buffer.
+ *
+ * @details
+ * Linear probing with backward-shift deletion, so there are no tombstones and lookups stay O(1) however many
+ * addresses come and go. The table doubles when it is half full and never shrinks, so a buffer that keeps
+ * the table next to it stops allocating once it has reached its peak occupancy.
+ *
+ */
+class AddrCountTable {
+  public:
+    AddrCountTable();
+
+    void insert(Addr_t addr);
+    void erase(Addr_t addr);      // Removes one occurrence of addr (no-op if there is none)
+    bool contains(Addr_t addr) const;
+    size_t size() const { return m_size; };
+
+  private:
+    struct Entry {
+      Addr_t addr = -1;
+      int count = 0;        // 0 = empty slot
+    };
+    std::vector<Entry> m_entries;
+    size_t m_mask = 0;
+    size_t m_size = 0;      // Number of distinct addresses
+
+    size_t home_slot(Addr_t addr) const;
+    size_t find_slot(Addr_t addr) const;
+    void grow();
+};
+
+}        // namespace Ramulator
+
+#endif   // RAMULATOR_CONTROLLER_ADDR_COUNT_TABLE_H
@@ -0,0 +1,740 @@
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <vector>
+
+#include "dram_controller/controller.h"
+#include "memory_system/memory_system.h"
+#include "dram_controller/impl/addr_count_table.h"
+#include "dram_controller/impl/bank_queue_set.h"
+#include "dram_controller/impl/plugin/ecc/decoder_pipeline.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    The Generic controller with its read and write buffers split into per-bank queues.
+ *
+ * @details
+ * Requests wait in one BankQueueSet per direction. Each pass only evaluates the banks whose requests may be ready
+ * (see BankQueueSet), so the scheduling cost follows the number of ready banks instead of the queue occupancy.
+ * The scheduler child only orders the active buffer. With the age arbiter and no bank depth limit, it issues the same
+ * request as the Generic controller with FRFCFS, except that requests arriving in the same cycle are ordered by bank
+ * instead of by arrival order.
+ *
+ */
+class BankPartitionedDRAMController final : public IDRAMController, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IDRAMController, BankPartitionedDRAMController, "BankPartitioned", "A DRAM controller with per-bank request queues.");
+  private:
+    ReqBuffer pending;                    // A queue for read requests that are about to finish (callback after RL)
+
+    struct PendingDepart {
+      Clk_t depart;
+      uint64_t seq;                       // Arrival order in pending, breaks ties between equal departs
+      ReqBuffer::iterator req_it;
+      bool operator>(const PendingDepart& other) const { return std::tie(depart, seq) > std::tie(other.depart, other.seq); };
+    };
+    std::priority_queue<PendingDepart, std::vector<PendingDepart>, std::greater<PendingDepart>> m_pending_departs;   // Min-heap over pending
+    uint64_t m_pending_seq = 0;
+    DecoderPipeline m_decoder;            // ECC decoder stage between the read data and the callback (disabled if decoder_lanes is 0)
+
+    ReqBuffer m_active_buffer;            // Buffer for requests being served. This has the highest priority 
+    ReqBuffer m_priority_buffer;          // Buffer for high-priority requests (e.g., maintenance like refresh).
+    BankQueueSet m_read_buffer;           // Read requests, per bank
+    BankQueueSet m_write_buffer;          // Write requests, per bank
+    AddrCountTable m_write_addrs;         // Addresses in m_write_buffer, for write-to-read forwarding
+
+    int m_bank_addr_idx = -1;
+
+    bool m_plugin_dispatch_ready = false;
+    std::vector<IControllerPlugin*> m_tick_plugins;                   // Plugins updated every cycle
+    std::vector<std::vector<IControllerPlugin*>> m_command_plugins;   // Plugins updated per issued command id, in configuration order
+    std::vector<int> m_level_sizes;       // Organization counts from the channel down to the bank level
+    std::vector<int> m_active_bank_reqs;  // Number of requests in m_active_buffer per flat bank id
+    int m_num_wildcard_active_reqs = 0;   // Requests in m_active_buffer with a wildcard down to the bank level
+
+    int m_bank_queue_depth = 0;
+    BankQueueSet::Arbiter m_arbiter = BankQueueSet::Arbiter::Age;
+
+    float m_wr_low_watermark;
+    float m_wr_high_watermark;
+    bool  m_is_write_mode = false;
+
+    size_t s_row_hits = 0;
+    size_t s_row_misses = 0;
+    size_t s_row_conflicts = 0;
+    size_t s_read_row_hits = 0;
+    size_t s_read_row_misses = 0;
+    size_t s_read_row_conflicts = 0;
+    size_t s_write_row_hits = 0;
+    size_t s_write_row_misses = 0;
+    size_t s_write_row_conflicts = 0;
+
+    size_t m_num_cores = 0;
+    std::vector<size_t> s_read_row_hits_per_core;
+    std::vector<size_t> s_read_row_misses_per_core;
+    std::vector<size_t> s_read_row_conflicts_per_core;
+
+    size_t s_num_read_reqs = 0;
+    size_t s_num_write_reqs = 0;
+    size_t s_num_other_reqs = 0;
+    size_t s_queue_len = 0;
+    size_t s_read_queue_len = 0;
+    size_t s_write_queue_len = 0;
+    size_t s_priority_queue_len = 0;
+    float s_queue_len_avg = 0;
+    float s_read_queue_len_avg = 0;
+    float s_write_queue_len_avg = 0;
+    float s_priority_queue_len_avg = 0;
+    size_t s_refresh_stall_cycles = 0;    // Cycles demand requests waited behind a priority (e.g., refresh) request that was not ready
+
+    size_t s_read_latency = 0;
+    float s_avg_read_latency = 0;
+
+    float s_decoder_occupancy = 0;
+    float s_decoder_queue_len_avg = 0;
+    float s_avg_decoder_latency = 0;
+    size_t s_decoder_latency_p99 = 0;
+    size_t s_decoder_latency_p999 = 0;
+
+
+  public:
+    void init() override {
+      m_wr_low_watermark =  param<float>("wr_low_watermark").desc("Threshold for switching back to read mode.").default_val(0.2f);
+      m_wr_high_watermark = param<float>("wr_high_watermark").desc("Threshold for switching to write mode.").default_val(0.8f);
+      m_bank_queue_depth = param<int>("bank_queue_depth").desc("Maximum number of read (and of write) requests queued per bank (0 = only the buffer size limits them).").default_val(0);
+      if (m_bank_queue_depth < 0) {
+        throw ConfigurationError("BankPartitioned controller: bank_queue_depth must be non-negative!");
+      }
+      std::string arbiter = param<std::string>("arbiter").desc("Arbiter over the banks with a ready request (age or round_robin).").default_val("age");
+      if (arbiter == "age") {
+        m_arbiter = BankQueueSet::Arbiter::Age;
+      } else if (arbiter == "round_robin") {
+        m_arbiter = BankQueueSet::Arbiter::RoundRobin;
+      } else {
+        throw ConfigurationError("BankPartitioned controller: unknown arbiter \"{}\"!", arbiter);
+      }
+
+      m_scheduler = create_child_ifce<IScheduler>();
+      m_refresh = create_child_ifce<IRefreshManager>();    
+      m_rowpolicy = create_child_ifce<IRowPolicy>();    
+
+      int decoder_lanes = param<int>("decoder_lanes").desc("Number of parallel ECC decoder lanes (0 = no decoder stage).").default_val(0);
+      if (decoder_lanes > 0) {
+        Clk_t decoder_depth = param<Clk_t>("decoder_depth").desc("Cycles a full ECC decode takes.").default_val(8);
+        Clk_t decoder_ii = param<Clk_t>("decoder_initiation_interval").desc("Cycles between two codewords entering one decoder lane.").default_val(1);
+        Clk_t decoder_edc_latency = param<Clk_t>("decoder_edc_latency").desc("Cycles of the EDC check of reads that need no correction.").default_val(1);
+        m_decoder = DecoderPipeline(decoder_lanes, decoder_depth, decoder_ii, decoder_edc_latency);
+      }
+
+      if (m_config["plugins"]) {
+        YAML::Node plugin_configs = m_config["plugins"];
+        for (YAML::iterator it = plugin_configs.begin(); it != plugin_configs.end(); ++it) {
+          m_plugins.push_back(create_child_ifce<IControllerPlugin>(*it));
+        }
+      }
+    };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      m_dram = memory_system->get_ifce<IDRAM>();
+      m_bank_addr_idx = m_dram->m_levels("bank");
+      size_t num_banks = 1;
+      for (int level = 0; level <= m_bank_addr_idx; level++) {
+        m_level_sizes.push_back(m_dram->m_organization.count[level]);
+        num_banks *= m_level_sizes.back();
+      }
+      m_active_bank_reqs.resize(num_banks, 0);
+      m_read_buffer.init(num_banks, m_bank_queue_depth, m_arbiter);
+      m_write_buffer.init(num_banks, m_bank_queue_depth, m_arbiter);
+      m_priority_buffer.max_size = 512*3 + 32;
+      pending.max_size = std::numeric_limits<size_t>::max();
+
+      m_num_cores = frontend->get_num_cores();
+
+      s_read_row_hits_per_core.resize(m_num_cores, 0);
+      s_read_row_misses_per_core.resize(m_num_cores, 0);
+      s_read_row_conflicts_per_core.resize(m_num_cores, 0);
+
+      register_stat(s_row_hits).name("row_hits_{}", m_channel_id);
+      register_stat(s_row_misses).name("row_misses_{}", m_channel_id);
+      register_stat(s_row_conflicts).name("row_conflicts_{}", m_channel_id);
+      register_stat(s_read_row_hits).name("read_row_hits_{}", m_channel_id);
+      register_stat(s_read_row_misses).name("read_row_misses_{}", m_channel_id);
+      register_stat(s_read_row_conflicts).name("read_row_conflicts_{}", m_channel_id);
+      register_stat(s_write_row_hits).name("write_row_hits_{}", m_channel_id);
+      register_stat(s_write_row_misses).name("write_row_misses_{}", m_channel_id);
+      register_stat(s_write_row_conflicts).name("write_row_conflicts_{}", m_channel_id);
+
+      for (size_t core_id = 0; core_id < m_num_cores; core_id++) {
+        register_stat(s_read_row_hits_per_core[core_id]).name("read_row_hits_core_{}", core_id);
+        register_stat(s_read_row_misses_per_core[core_id]).name("read_row_misses_core_{}", core_id);
+        register_stat(s_read_row_conflicts_per_core[core_id]).name("read_row_conflicts_core_{}", core_id);
+      }
+
+      register_stat(s_num_read_reqs).name("num_read_reqs_{}", m_channel_id);
+      register_stat(s_num_write_reqs).name("num_write_reqs_{}", m_channel_id);
+      register_stat(s_num_other_reqs).name("num_other_reqs_{}", m_channel_id);
+      register_stat(s_queue_len).name("queue_len_{}", m_channel_id);
+      register_stat(s_read_queue_len).name("read_queue_len_{}", m_channel_id);
+      register_stat(s_write_queue_len).name("write_queue_len_{}", m_channel_id);
+      register_stat(s_priority_queue_len).name("priority_queue_len_{}", m_channel_id);
+      register_stat(s_queue_len_avg).name("queue_len_avg_{}", m_channel_id);
+      register_stat(s_read_queue_len_avg).name("read_queue_len_avg_{}", m_channel_id);
+      register_stat(s_write_queue_len_avg).name("write_queue_len_avg_{}", m_channel_id);
+      register_stat(s_priority_queue_len_avg).name("priority_queue_len_avg_{}", m_channel_id);
+      register_stat(s_refresh_stall_cycles).name("refresh_stall_cycles_{}", m_channel_id);
+
+      register_stat(s_read_latency).name("read_latency_{}", m_channel_id);
+      register_stat(s_avg_read_latency).name("avg_read_latency_{}", m_channel_id);
+
+      if (m_decoder.enabled()) {
+        register_stat(m_decoder.s_fast_path_reads).name("decoder_fast_path_reads_{}", m_channel_id);
+        register_stat(m_decoder.s_slow_path_reads).name("decoder_slow_path_reads_{}", m_channel_id);
+        register_stat(m_decoder.s_stall_cycles).name("decoder_stall_cycles_{}", m_channel_id);
+        register_stat(m_decoder.s_added_latency).name("decoder_latency_{}", m_channel_id);
+        register_stat(m_decoder.s_max_added_latency).name("decoder_latency_max_{}", m_channel_id);
+        register_stat(s_avg_decoder_latency).name("avg_decoder_latency_{}", m_channel_id);
+        register_stat(s_decoder_latency_p99).name("decoder_latency_p99_{}", m_channel_id);
+        register_stat(s_decoder_latency_p999).name("decoder_latency_p999_{}", m_channel_id);
+        register_stat(s_decoder_occupancy).name("decoder_occupancy_{}", m_channel_id);
+        register_stat(s_decoder_queue_len_avg).name("decoder_queue_len_avg_{}", m_channel_id);
+      }
+    };
+
+    bool send(Request& req) override {
+      req.final_command = m_dram->m_request_translations(req.type_id);
+
+      switch (req.type_id) {
+        case Request::Type::Read: {
+          s_num_read_reqs++;
+          break;
+        }
+        case Request::Type::Write: {
+          s_num_write_reqs++;
+          break;
+        }
+        default: {
+          s_num_other_reqs++;
+          break;
+        }
+      }
+
+      // Forward existing write requests to incoming read requests
+      req.arrive = m_clk;
+      if (req.type_id == Request::Type::Read) {
+        if (m_write_addrs.contains(req.addr)) {
+          // The request will depart at the next cycle
+          req.depart = m_clk + 1;
+          pending.enqueue(req);
+          track_pending_depart();
+          return true;
+        }
+      }
+
+      // Plugins see the request before it is buffered and may serve it without DRAM access (e.g., a read of a
+      // codeword the ECC decoder still holds)
+      if (serve_by_plugins(req)) {
+        return true;
+      }
+
+      // Else, enqueue them to corresponding buffer based on request type id
+      bool is_success = false;
+      int bank_id = flat_bank_id(req.addr_vec);
+      if (bank_id == -1) {
+        throw std::runtime_error("BankPartitioned controller: request without a bank address!");
+      }
+      if        (req.type_id == Request::Type::Read) {
+        is_success = m_read_buffer.enqueue(req, bank_id);
+      } else if (req.type_id == Request::Type::Write) {
+        is_success = m_write_buffer.enqueue(req, bank_id);
+        if (is_success) {
+          m_write_addrs.insert(req.addr);
+        }
+      } else {
+        throw std::runtime_error("Invalid request type!");
+      }
+      if (!is_success) {
+        // We could not enqueue the request
+        req.arrive = -1;
+        return false;
+      }
+
+      return true;
+    };
+
+    bool priority_send(Request& req) override {
+      req.final_command = m_dram->m_request_translations(req.type_id);
+
+      bool is_success = false;
+      is_success = m_priority_buffer.enqueue(req);
+      return is_success;
+    }
+
+    bool is_demand_idle() override {
+      return m_read_buffer.size() == 0 && m_write_buffer.size() == 0;
+    }
+
+    void complete_read(Request& req) override {
+      if (m_decoder.enabled()) {
+        m_decoder.push(req, m_clk);
+      } else if (req.callback) {
+        req.callback(req);
+      }
+    }
+
+    int num_active_requests(const AddrVec_t& addr_vec) override {
+      if (m_num_wildcard_active_reqs > 0) {
+        // Wildcard entries do not belong to a single bank, so fall back to matching every entry
+        int num_reqs = 0;
+        for (auto _it = m_active_buffer.begin(); _it != m_active_buffer.end(); _it++) {
+          auto& _it_rowgroup = _it->addr_vec;
+          bool is_matching = true;
+          for (int i = 0; i < m_bank_addr_idx + 1 ; i++) {
+            if (_it_rowgroup[i] != addr_vec[i] && _it_rowgroup[i] != -1 && addr_vec[i] != -1) {
+              is_matching = false;
+              break;
+            }
+          }
+          num_reqs += is_matching;
+        }
+        return num_reqs;
+      }
+      return count_active_requests(addr_vec, 0, 0);
+    }
+
+    int num_row_requests(const AddrVec_t& addr_vec) override {
+      // Requests to a row all sit in the queue of its bank
+      int bank_id = flat_bank_id(addr_vec);
+      if (bank_id == -1) {
+        return 0;
+      }
+      int row_level = m_dram->m_levels("row");
+      int num_reqs = 0;
+      for (BankQueueSet* queues : {&m_read_buffer, &m_write_buffer}) {
+        for (auto& req : queues->bank(bank_id)) {
+          num_reqs += std::equal(addr_vec.begin(), addr_vec.begin() + row_level + 1, req.addr_vec.begin());
+        }
+      }
+      return num_reqs;
+    }
+
+    void tick() override {
+      m_clk++;
+
+      // Update statistics
+      s_queue_len += m_read_buffer.size() + m_write_buffer.size() + m_priority_buffer.size() + pending.size();
+      s_read_queue_len += m_read_buffer.size() + pending.size();
+      s_write_queue_len += m_write_buffer.size();
+      s_priority_queue_len += m_priority_buffer.size();
+
+      // 1. Serve completed reads
+      serve_completed_reads();
+      if (m_decoder.enabled()) {
+        m_decoder.tick(m_clk);
+      }
+
+      m_refresh->tick();
+
+      // 2. Try to find a request to serve.
+      ReqBuffer::iterator req_it;
+      ReqBuffer* buffer = nullptr;
+      BankQueueSet* bank_queues = nullptr;
+      bool request_found = schedule_request(req_it, buffer, bank_queues);
+
+      // 2.1 Take row policy action
+      m_rowpolicy->update(request_found, req_it);
+
+      // 3. Update the plugins that subscribed to this cycle
+      if (!m_plugin_dispatch_ready) {
+        build_plugin_dispatch();
+      }
+      if (request_found) {
+        decode_command(*req_it);
+      }
+      auto& plugins = request_found ? m_command_plugins[req_it->command] : m_tick_plugins;
+      for (auto plugin : plugins) {
+        if (request_found && !accepts_request_type(plugin, req_it->type_id)) {
+          continue;
+        }
+        RAMULATOR_PROFILE_CALL(plugin, update(request_found, req_it));
+      }
+
+      // 4. Finally, issue the commands to serve the request
+      if (request_found) {
+        // If we find a real request to serve
+        if (req_it->is_stat_updated == false) {
+          update_request_stats(req_it);
+        }
+        RAMULATOR_PROFILE_CALL(m_dram, issue_command(req_it->command, req_it->addr_vec));
+
+        // Writes that leave the write buffer no longer forward their data to reads
+        Addr_t addr = req_it->addr;
+        bool from_write_buffer = (bank_queues == &m_write_buffer);
+        bool from_active_buffer = (buffer == &m_active_buffer);
+        int bank_id = flat_bank_id(req_it->addr_vec);
+
+        // If we are issuing the last command, set depart clock cycle and move the request to the pending queue
+        if (req_it->command == req_it->final_command) {
+          if (req_it->type_id == Request::Type::Read) {
+            req_it->depart = m_clk + m_dram->m_read_latency;
+            if (m_dram->m_link_retry) {
+              // The data arrives after its link ECC and any replays of its burst
+              req_it->depart += m_dram->m_link_retry->last_delay(m_channel_id);
+            }
+            buffer->transfer(req_it, pending);
+            track_pending_depart();
+          } else {
+            // TODO: Add code to update statistics of writes
+            buffer->remove(req_it);
+          }
+          if (from_write_buffer) {
+            m_write_addrs.erase(addr);
+          }
+          if (from_active_buffer) {
+            update_active_count(bank_id, -1);
+          }
+          if (bank_queues) {
+            bank_queues->notify_dequeued(bank_id);
+          }
+        } else {
+          if (m_dram->m_command_meta(req_it->command).is_opening) {
+            if (buffer->transfer(req_it, m_active_buffer) && !from_active_buffer) {
+              update_active_count(bank_id, 1);
+              if (from_write_buffer) {
+                m_write_addrs.erase(addr);
+              }
+              if (bank_queues) {
+                bank_queues->notify_dequeued(bank_id);
+              }
+            }
+          }
+        }
+
+      }
+
+    };
+
+    Clk_t get_idle_cycles() override {
+      // Any buffered request may become ready, and the decoder finishes reads on its own schedule
+      if (m_active_buffer.size() || m_priority_buffer.size() || m_read_buffer.size() || m_write_buffer.size()) {
+        return 0;
+      }
+      if (m_decoder.enabled() && m_decoder.size() != 0) {
+        return 0;
+      }
+
+      Clk_t idle_cycles = std::numeric_limits<Clk_t>::max();
+      if (!m_pending_departs.empty()) {
+        idle_cycles = std::max<Clk_t>(m_pending_departs.top().depart - m_clk - 1, 0);
+      }
+      idle_cycles = std::min(idle_cycles, m_refresh->get_idle_cycles());
+      idle_cycles = std::min(idle_cycles, m_rowpolicy->get_idle_cycles());
+      for (auto plugin : m_plugins) {
+        if (plugin->get_subscription().per_cycle) {
+          idle_cycles = std::min(idle_cycles, plugin->get_idle_cycles());
+        }
+      }
+      return idle_cycles;
+    };
+
+    void skip_cycles(Clk_t num_cycles) override {
+      if (num_cycles <= 0) {
+        return;
+      }
+      m_clk += num_cycles;
+
+      // The same statistics tick() collects with only the pending queue occupied
+      s_queue_len += num_cycles * pending.size();
+      s_read_queue_len += num_cycles * pending.size();
+
+      m_refresh->skip_cycles(num_cycles);
+      m_rowpolicy->skip_cycles(num_cycles);
+      for (auto plugin : m_plugins) {
+        if (plugin->get_subscription().per_cycle) {
+          plugin->skip_cycles(num_cycles);
+        }
+      }
+
+      // An idle tick finds the read buffer empty and switches to write mode
+      set_write_mode();
+    };
+
+
+  private:
+    /**
+     * @brief    Sorts the plugins into dispatch lists from the subscriptions they declared in setup()
+     * @details
+     * Called on the first tick, as the plugins are set up after the controller.
+     * 
+     */
+    void build_plugin_dispatch() {
+      m_command_plugins.assign(m_dram->m_commands.size(), {});
+      for (auto plugin : m_plugins) {
+        const IControllerPlugin::Subscription& subscription = plugin->get_subscription();
+        if (subscription.per_cycle) {
+          m_tick_plugins.push_back(plugin);
+        }
+        for (int command = 0; command < (int) m_command_plugins.size(); command++) {
+          if (subscription.per_cycle || subscription.commands.empty() ||
+              std::find(subscription.commands.begin(), subscription.commands.end(), command) != subscription.commands.end()) {
+            m_command_plugins[command].push_back(plugin);
+          }
+        }
+      }
+      m_plugin_dispatch_ready = true;
+    };
+
+    bool accepts_request_type(IControllerPlugin* plugin, int type_id) const {
+      const IControllerPlugin::Subscription& subscription = plugin->get_subscription();
+      return subscription.per_cycle || subscription.request_types.empty() ||
+             std::find(subscription.request_types.begin(), subscription.request_types.end(), type_id) != subscription.request_types.end();
+    };
+
+    /**
+     * @brief    Flat id of the bank of addr_vec, or -1 if it has a wildcard down to the bank level
+     * 
+     */
+    int flat_bank_id(const AddrVec_t& addr_vec) const {
+      int id = 0;
+      for (int level = 0; level <= m_bank_addr_idx; level++) {
+        if (addr_vec[level] < 0) {
+          return -1;
+        }
+        id = id * m_level_sizes[level] + addr_vec[level];
+      }
+      return id;
+    }
+
+    void update_active_count(int bank_id, int delta) {
+      if (bank_id == -1) {
+        m_num_wildcard_active_reqs += delta;
+      } else {
+        m_active_bank_reqs[bank_id] += delta;
+      }
+    }
+
+    /**
+     * @brief    Sums the active-buffer counts of the banks under addr_vec, expanding wildcards level by level
+     * 
+     */
+    int count_active_requests(const AddrVec_t& addr_vec, int level, int id) const {
+      if (level > m_bank_addr_idx) {
+        return m_active_bank_reqs[id];
+      }
+      if (addr_vec[level] >= 0) {
+        return count_active_requests(addr_vec, level + 1, id * m_level_sizes[level] + addr_vec[level]);
+      }
+      int num_reqs = 0;
+      for (int node = 0; node < m_level_sizes[level]; node++) {
+        num_reqs += count_active_requests(addr_vec, level + 1, id * m_level_sizes[level] + node);
+      }
+      return num_reqs;
+    }
+
+    /**
+     * @brief    Helper function to check if a request is hitting an open row
+     * @details
+     * 
+     */
+    bool is_row_hit(ReqBuffer::iterator& req)
+    {
+        return m_dram->check_rowbuffer_hit(req->final_command, req->addr_vec);
+    }
+    /**
+     * @brief    Helper function to check if a request is opening a row
+     * @details
+     * 
+    */
+    bool is_row_open(ReqBuffer::iterator& req)
+    {
+        return m_dram->check_node_open(req->final_command, req->addr_vec);
+    }
+
+    /**
+     * @brief    
+     * @details
+     * 
+     */
+    void update_request_stats(ReqBuffer::iterator& req)
+    {
+      req->is_stat_updated = true;
+
+      if (req->type_id == Request::Type::Read) 
+      {
+        if (is_row_hit(req)) {
+          s_read_row_hits++;
+          s_row_hits++;
+          m_rowpolicy->on_row_access(*req, IRowPolicy::RowAccess::Hit);
+          if (req->source_id != -1)
+            s_read_row_hits_per_core[req->source_id]++;
+        } else if (is_row_open(req)) {
+          s_read_row_conflicts++;
+          s_row_conflicts++;
+          m_rowpolicy->on_row_access(*req, IRowPolicy::RowAccess::Conflict);
+          if (req->source_id != -1)
+            s_read_row_conflicts_per_core[req->source_id]++;
+        } else {
+          s_read_row_misses++;
+          s_row_misses++;
+          m_rowpolicy->on_row_access(*req, IRowPolicy::RowAccess::Miss);
+          if (req->source_id != -1)
+            s_read_row_misses_per_core[req->source_id]++;
+        } 
+      } 
+      else if (req->type_id == Request::Type::Write) 
+      {
+        if (is_row_hit(req)) {
+          s_write_row_hits++;
+          s_row_hits++;
+          m_rowpolicy->on_row_access(*req, IRowPolicy::RowAccess::Hit);
+        } else if (is_row_open(req)) {
+          s_write_row_conflicts++;
+          s_row_conflicts++;
+          m_rowpolicy->on_row_access(*req, IRowPolicy::RowAccess::Conflict);
+        } else {
+          s_write_row_misses++;
+          s_row_misses++;
+          m_rowpolicy->on_row_access(*req, IRowPolicy::RowAccess::Miss);
+        }
+      }
+    }
+
+    /**
+     * @brief    Adds the request just moved to the back of the pending queue to the depart-ordered heap
+     * 
+     */
+    void track_pending_depart() {
+      auto req_it = std::prev(pending.end());
+      m_pending_departs.push({req_it->depart, m_pending_seq++, req_it});
+    };
+
+    /**
+     * @brief    Helper function to serve the completed read requests
+     * @details
+     * This function is called at the beginning of the tick() function.
+     * It retires every pending request that has received its data from DRAM (depart <= m_clk), earliest depart first,
+     * by calling its callback and removing it from the pending queue. Forwarded reads (depart = arrive + 1) thus do not
+     * wait behind DRAM reads that were issued before them.
+     */
+    void serve_completed_reads() {
+      while (!m_pending_departs.empty() && m_pending_departs.top().depart <= m_clk) {
+        ReqBuffer::iterator req_it = m_pending_departs.top().req_it;
+        m_pending_departs.pop();
+
+        auto& req = *req_it;
+        // Request received data from dram
+        if (req.depart - req.arrive > 1) {
+          // Check if this requests accesses the DRAM or is being forwarded.
+          // TODO add the stats back
+          s_read_latency += req.depart - req.arrive;
+        }
+
+        if (m_decoder.enabled() && req.depart - req.arrive > 1) {
+          // Read data from DRAM goes through the ECC decoder, which calls the callback when it is done
+          m_decoder.push(req, m_clk);
+        } else if (req.callback) {
+          // If the request comes from outside (e.g., processor), call its callback
+          req.callback(req);
+        }
+        // Finally, remove this request from the pending queue
+        pending.remove(req_it);
+      }
+    };
+
+
+    /**
+     * @brief    Checks if we need to switch to write mode
+     * 
+     */
+    void set_write_mode() {
+      if (!m_is_write_mode) {
+        if ((m_write_buffer.size() > m_wr_high_watermark * m_write_buffer.max_size) || m_read_buffer.size() == 0) {
+          m_is_write_mode = true;
+        }
+      } else {
+        if ((m_write_buffer.size() < m_wr_low_watermark * m_write_buffer.max_size) && m_read_buffer.size() != 0) {
+          m_is_write_mode = false;
+        }
+      }
+    };
+
+
+    /**
+     * @brief    Helper function to find a request to schedule from the buffers.
+     * 
+     */
+    bool schedule_request(ReqBuffer::iterator& req_it, ReqBuffer*& req_buffer, BankQueueSet*& bank_queues) {
+      bool request_found = false;
+      // 2.1    First, check the act buffer to serve requests that are already activating (avoid useless ACTs)
+      if (req_it= RAMULATOR_PROFILE_CALL(m_scheduler, get_best_request(m_active_buffer)); req_it != m_active_buffer.end()) {
+        if (m_dram->check_ready(req_it->command, req_it->addr_vec)) {
+          request_found = true;
+          req_buffer = &m_active_buffer;
+        }
+      }
+
+      // 2.2    If no requests can be scheduled from the act buffer, check the rest of the buffers
+      if (!request_found) {
+        // 2.2.1    We first check the priority buffer to prioritize e.g., maintenance requests
+        if (m_priority_buffer.size() != 0) {
+          req_buffer = &m_priority_buffer;
+          req_it = m_priority_buffer.begin();
+          req_it->command = m_dram->get_preq_command(req_it->final_command, req_it->addr_vec);
+          
+          request_found = m_dram->check_ready(req_it->command, req_it->addr_vec);
+          if (!request_found & m_priority_buffer.size() != 0) {
+            if (!is_demand_idle()) {
+              s_refresh_stall_cycles++;
+            }
+            return false;
+          }
+        }
+
+        // 2.2.1    If no request to be scheduled in the priority buffer, check the read and write buffers.
+        if (!request_found) {
+          // Query the write policy to decide which buffer to serve
+          set_write_mode();
+          auto& queues = m_is_write_mode ? m_write_buffer : m_read_buffer;
+          int bank_id = -1;
+          if (req_it = queues.get_best_request(m_dram, m_clk, bank_id); bank_id != -1) {
+            // The bank queues only return ready requests
+            request_found = true;
+            req_buffer = &queues.bank(bank_id);
+            bank_queues = &queues;
+          }
+        }
+      }
+
+      // 2.3 If we find a request to schedule, we need to check if it will close an opened row in the active buffer.
+      if (request_found) {
+        if (m_dram->m_command_meta(req_it->command).is_closing) {
+          request_found = num_active_requests(req_it->addr_vec) == 0;
+        }
+      }
+
+      return request_found;
+    }
+
+    void finalize() override {
+      s_avg_read_latency = (float) s_read_latency / (float) s_num_read_reqs;
+
+      s_queue_len_avg = (float) s_queue_len / (float) m_clk;
+      s_read_queue_len_avg = (float) s_read_queue_len / (float) m_clk;
+      s_write_queue_len_avg = (float) s_write_queue_len / (float) m_clk;
+      s_priority_queue_len_avg = (float) s_priority_queue_len / (float) m_clk;
+
+      if (m_decoder.enabled()) {
+        size_t decoded_reads = m_decoder.s_fast_path_reads + m_decoder.s_slow_path_reads - m_decoder.size();
+        s_avg_decoder_latency = decoded_reads ? (float) m_decoder.s_added_latency / (float) decoded_reads : 0.0f;
+        s_decoder_latency_p99 = m_decoder.latency_quantile(0.99);
+        s_decoder_latency_p999 = m_decoder.latency_quantile(0.999);
+        s_decoder_occupancy = m_decoder.occupancy(m_clk);
+        s_decoder_queue_len_avg = (float) m_decoder.s_queue_len / (float) m_clk;
+      }
+
+      return;
+    }
+
+};
+  
+}   // namespace Ramulator
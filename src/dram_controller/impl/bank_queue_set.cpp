@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include "dram/dram.h"
+#include "dram_controller/impl/bank_queue_set.h"
+
+namespace Ramulator {
+
+void BankQueueSet::init(int num_banks, size_t bank_depth, Arbiter arbiter) {
+  m_banks = std::vector<Bank>(num_banks);
+  for (Bank& bank : m_banks) {
+    bank.buffer.max_size = std::numeric_limits<size_t>::max();
+  }
+  m_nonempty.assign((num_banks + 63) / 64, 0);
+  m_bank_depth = bank_depth;
+  m_arbiter = arbiter;
+}
+
+bool BankQueueSet::enqueue(const Request& req, int bank_id) {
+  Bank& bank = m_banks[bank_id];
+  if (m_size > max_size || (m_bank_depth != 0 && bank.buffer.size() >= m_bank_depth)) {
+    return false;
+  }
+  bank.buffer.enqueue(req);
+  bank.dirty = true;
+  m_nonempty[bank_id / 64] |= uint64_t(1) << (bank_id % 64);
+  m_size++;
+  return true;
+}
+
+void BankQueueSet::notify_dequeued(int bank_id) {
+  Bank& bank = m_banks[bank_id];
+  bank.dirty = true;
+  if (bank.buffer.size() == 0) {
+    m_nonempty[bank_id / 64] &= ~(uint64_t(1) << (bank_id % 64));
+  }
+  m_size--;
+}
+
+int BankQueueSet::next_nonempty(int from) const {
+  for (int word = from / 64; word < (int) m_nonempty.size(); word++) {
+    uint64_t bits = m_nonempty[word];
+    if (word == from / 64) {
+      bits &= ~uint64_t(0) << (from % 64);
+    }
+    if (bits) {
+      return word * 64 + std::countr_zero(bits);
+    }
+  }
+  return -1;
+}
+
+ReqBuffer::iterator BankQueueSet::find_ready(IDRAM* dram, Clk_t clk, int bank_id) {
+  Bank& bank = m_banks[bank_id];
+  ReqBuffer& buffer = bank.buffer;
+  // Every request of a bank shares the nodes its prerequisite depends on, so one version covers all of them
+  int64_t version = dram->get_state_version(buffer.begin()->addr_vec);
+  if (!bank.dirty && version != -1 && version == bank.version && clk < bank.ready_bound) {
+    return buffer.end();
+  }
+
+  auto best = buffer.end();
+  Clk_t ready_bound = std::numeric_limits<Clk_t>::max();
+  for (auto it = buffer.begin(); it != buffer.end(); it++) {
+    if (version == -1 || version != it->preq_version) {
+      it->command = dram->get_preq_command(it->final_command, it->addr_vec);
+      it->preq_version = version;
+    }
+    Clk_t ready_clk = dram->get_ready_clk(it->command, it->addr_vec);
+    if (ready_clk <= clk && (best == buffer.end() || it->arrive < best->arrive)) {
+      best = it;
+    }
+    ready_bound = std::min(ready_bound, ready_clk);
+  }
+  bank.ready_bound = ready_bound;
+  bank.version = version;
+  bank.dirty = false;
+  return best;
+}
+
+ReqBuffer::iterator BankQueueSet::get_best_request(IDRAM* dram, Clk_t clk, int& bank_id) {
+  bank_id = -1;
+  ReqBuffer::iterator best;
+  if (m_size == 0) {
+    return best;
+  }
+
+  if (m_arbiter == Arbiter::Age) {
+    for (int id = next_nonempty(0); id != -1; id = next_nonempty(id + 1)) {
+      auto it = find_ready(dram, clk, id);
+      if (it != m_banks[id].buffer.end() && (bank_id == -1 || it->arrive < best->arrive)) {
+        best = it;
+        bank_id = id;
+      }
+    }
+    return best;
+  }
+
+  // Round robin: the first bank with a ready request, starting after the one served last
+  int start = (m_last_bank + 1) % (int) m_banks.size();
+  for (int pass = 0; pass < 2; pass++) {
+    int id = next_nonempty(pass == 0 ? start : 0);
+    for (; id != -1 && (pass == 0 || id < start); id = next_nonempty(id + 1)) {
+      auto it = find_ready(dram, clk, id);
+      if (it != m_banks[id].buffer.end()) {
+        bank_id = id;
+        m_last_bank = id;
+        return it;
+      }
+    }
+  }
+  return best;
+}
+
+}        // namespace Ramulator
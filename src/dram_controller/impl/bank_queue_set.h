@@ -0,0 +1,70 @@
+#ifndef RAMULATOR_CONTROLLER_BANK_QUEUE_SET_H
+#define RAMULATOR_CONTROLLER_BANK_QUEUE_SET_H
+
+#include <cstdint>
+#include <vector>
+
+#include "base/type.h"
+#include "base/request.h"
+
+namespace Ramulator {
+
+class IDRAM;
+
+/**
+ * @brief    A request buffer split into one sub-queue per bank, with an arbiter over the banks that have a ready request.
+ *
+ * @details
+ * A bitmask tracks the non-empty banks. Each bank caches the earliest cycle any of its requests can become ready
+ * (IDRAM::get_ready_clk() of their prerequisites) together with the IDRAM::get_state_version() those prerequisites
+ * were computed at. Until that cycle is reached, the bank state changes or a request joins the bank, the bank is
+ * skipped without looking at its requests, so a scheduling pass costs one check per non-empty bank plus a walk
+ * over the banks that may be ready.
+ * Within a bank, the earliest ready request wins. Across banks, the "age" arbiter picks the earliest of them (ties go
+ * to the lower bank id), and the "round_robin" arbiter takes the first bank with a ready request after the bank it
+ * picked last.
+ *
+ */
+class BankQueueSet {
+  public:
+    enum class Arbiter { Age, RoundRobin };
+
+    size_t max_size = 32;         // Same semantics as ReqBuffer::max_size, over all banks
+
+    void init(int num_banks, size_t bank_depth, Arbiter arbiter);
+
+    size_t size() const { return m_size; };
+    ReqBuffer& bank(int bank_id) { return m_banks[bank_id].buffer; };
+
+    bool enqueue(const Request& req, int bank_id);
+    void notify_dequeued(int bank_id);      // A request left bank(bank_id) through ReqBuffer::remove() or transfer()
+
+    /**
+     * @brief    Picks a ready request, updating the prerequisite commands it looks at
+     * @details
+     * Returns an iterator into bank(bank_id), or sets bank_id to -1 (and returns an end iterator) if no request is ready.
+     * 
+     */
+    ReqBuffer::iterator get_best_request(IDRAM* dram, Clk_t clk, int& bank_id);
+
+  private:
+    struct Bank {
+      ReqBuffer buffer;
+      Clk_t ready_bound = -1;       // No request of this bank is ready before this cycle
+      int64_t version = -1;         // IDRAM::get_state_version() ready_bound was computed at
+      bool dirty = true;            // ready_bound is stale
+    };
+    std::vector<Bank> m_banks;
+    std::vector<uint64_t> m_nonempty;   // Bitmask of the banks with at least one request
+    size_t m_size = 0;
+    size_t m_bank_depth = 0;            // 0 = only bounded by max_size
+    Arbiter m_arbiter = Arbiter::Age;
+    int m_last_bank = -1;               // Bank picked last by the round-robin arbiter
+
+    int next_nonempty(int from) const;  // First non-empty bank id >= from, or -1
+    ReqBuffer::iterator find_ready(IDRAM* dram, Clk_t clk, int bank_id);
+};
+
+}        // namespace Ramulator
+
+#endif   // RAMULATOR_CONTROLLER_BANK_QUEUE_SET_H
@@ -3,34 +3,26 @@
 #include "frontend/frontend.h"
 #include "frontend/impl/processor/bhO3/bhllc.h"
 #include "frontend/impl/processor/bhO3/bhO3.h"
+#include "dram_controller/impl/controller_core.h"
 
 namespace Ramulator {
 
 DECLARE_DEBUG_FLAG(DBHCTRL);
 ENABLE_DEBUG_FLAG(DBHCTRL);
 
-class BHDRAMController final : public IBHDRAMController, public Implementation {
+class BHDRAMController final : public IBHDRAMController, public Implementation, private ControllerCore<> {
   RAMULATOR_REGISTER_IMPLEMENTATION(IBHDRAMController, BHDRAMController, "BHDRAMController", "BHammer DRAM controller.");
   
   private:
     Logger_t m_logger;
-    std::deque<Request> pending;          // A queue for read requests that are about to finish (callback after RL)
+    ReqBuffer pending;                    // A queue for read requests that are about to finish (callback after RL)
     BHO3LLC* m_llc;
 
-    ReqBuffer m_active_buffer;            // Buffer for requests being served. This has the highest priority 
-    ReqBuffer m_priority_buffer;          // Buffer for high-priority requests (e.g., maintenance like refresh).
-    ReqBuffer m_read_buffer;              // Read request buffer
-    ReqBuffer m_write_buffer;             // Write request buffer
-
     int m_rank_addr_idx = -1;
     int m_bankgroup_addr_idx = -1;
     int m_bank_addr_idx = -1;
     int m_row_addr_idx = -1;
 
-    float m_wr_low_watermark;
-    float m_wr_high_watermark;
-    bool  m_is_write_mode = false;
-
     std::vector<int> s_core_row_hits;
     std::vector<int> s_core_row_misses;
     std::vector<int> s_core_row_conflicts;
@@ -45,8 +37,8 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
   public:
     void init() override {
       m_invalidate_ctr = 0;
-      m_wr_low_watermark =  param<float>("wr_low_watermark").desc("Threshold for switching back to read mode.").default_val(0.2f);
-      m_wr_high_watermark = param<float>("wr_high_watermark").desc("Threshold for switching to write mode.").default_val(0.8f);
+      m_write_drain.low_watermark =  param<float>("wr_low_watermark").desc("Threshold for switching back to read mode.").default_val(0.2f);
+      m_write_drain.high_watermark = param<float>("wr_high_watermark").desc("Threshold for switching to write mode.").default_val(0.8f);
 
       m_scheduler = create_child_ifce<IBHScheduler>();
       m_refresh = create_child_ifce<IRefreshManager>();
@@ -68,7 +60,9 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
       m_bankgroup_addr_idx = m_dram->m_levels("bankgroup");
       m_bank_addr_idx = m_dram->m_levels("bank");
       m_row_addr_idx = m_dram->m_levels("row");
+      setup_core(m_dram);
       m_priority_buffer.max_size = 512*3 + 32;
+      pending.max_size = std::numeric_limits<size_t>::max();
       
       int num_cores = static_cast<BHO3*>(frontend)->get_num_cores();
       s_core_row_hits.resize(num_cores);
@@ -99,7 +93,7 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
         if (std::find_if(m_write_buffer.begin(), m_write_buffer.end(), compare_addr) != m_write_buffer.end()) {
           // The request will depart at the next cycle
           req.depart = m_clk + 1;
-          pending.push_back(req);
+          pending.enqueue(req);
           return true;
         }
       }
@@ -131,6 +125,14 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
       return is_success;
     }
 
+    bool is_demand_idle() override {
+      return m_read_buffer.size() == 0 && m_write_buffer.size() == 0;
+    }
+
+    int num_active_requests(const AddrVec_t& addr_vec) override {
+      return num_active_bank_requests(addr_vec);
+    }
+
     void tick() override {
       m_clk++;
       // 1. Serve completed reads
@@ -148,28 +150,35 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
       m_rowpolicy->update(request_found, req_it);
 
       // 3. Update all plugins
+      if (request_found) {
+        decode_command(*req_it);
+      }
       for (auto plugin : m_plugins) {
-        plugin->update(request_found, req_it);
+        RAMULATOR_PROFILE_CALL(plugin, update(request_found, req_it));
       }
 
       // 4. Finally, issue the commands to serve the request
       if (request_found) {
         // If we find a real request to serve
-        m_dram->issue_command(req_it->command, req_it->addr_vec);
+        RAMULATOR_PROFILE_CALL(m_dram, issue_command(req_it->command, req_it->addr_vec));
 
         // If we are issuing the last command, set depart clock cycle and move the request to the pending queue
         if (req_it->command == req_it->final_command) {
+          if (buffer == &m_active_buffer) {
+            update_active_count(flat_bank_id(req_it->addr_vec), -1);
+          }
           if (req_it->type_id == Request::Type::Read) {
             req_it->depart = m_clk + m_dram->m_read_latency;
-            pending.push_back(*req_it);
-          } else if (req_it->type_id == Request::Type::Write) {
-            // TODO: Add code to update statistics
+            buffer->transfer(req_it, pending);
+          } else {
+            // TODO: Add code to update statistics of writes
+            buffer->remove(req_it);
           }
-          buffer->remove(req_it);
         } else {
           if (m_dram->m_command_meta(req_it->command).is_opening) {
-            if (m_active_buffer.enqueue(*req_it)) {
-              buffer->remove(req_it);
+            int bank_id = flat_bank_id(req_it->addr_vec);
+            if (buffer->transfer(req_it, m_active_buffer) && buffer != &m_active_buffer) {
+              update_active_count(bank_id, 1);
             }
           }
         }
@@ -188,7 +197,7 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
     void serve_completed_reads() {
       if (pending.size()) {
         // Check the first pending request
-        auto& req = pending[0];
+        auto& req = *pending.begin();
         if (req.depart <= m_clk) {
           // Request received data from dram
           if (req.depart - req.arrive > 1) {
@@ -201,86 +210,18 @@ class BHDRAMController final : public IBHDRAMController, public Implementation {
             req.callback(req);
           }
           // Finally, remove this request from the pending queue
-          pending.pop_front();
+          pending.remove(pending.begin());
         }
       };
     };
 
 
     /**
-     * @brief    Checks if we need to switch to write mode
-     * 
-     */
-    void set_write_mode() {
-      if (!m_is_write_mode) {
-        if ((m_write_buffer.size() > m_wr_high_watermark * m_write_buffer.max_size) || m_read_buffer.size() == 0) {
-          m_is_write_mode = true;
-        }
-      } else {
-        if ((m_write_buffer.size() < m_wr_low_watermark * m_write_buffer.max_size) && m_read_buffer.size() != 0) {
-          m_is_write_mode = false;
-        }
-      }
-    };
-
-    /**
-     * @brief    Helper function to find a request to schedule from the buffers.
+     * @brief    Helper function to find a request to schedule from the buffers (see ControllerCore::schedule()).
      * 
      */
     bool schedule_request(ReqBuffer::iterator& req_it, ReqBuffer*& req_buffer) {
-      bool request_found = false;
-      // 2.1    First, check the act buffer to serve requests that are already activating (avoid useless ACTs)
-      if (req_it = m_scheduler->get_best_request(m_active_buffer); req_it != m_active_buffer.end()) { 
-        if (m_dram->check_ready(req_it->command, req_it->addr_vec)) {
-          request_found = true;
-          req_buffer = &m_active_buffer;
-        }
-      }
-      // 2.2    If no requests can be scheduled from the act buffer, check the rest of the buffers
-      if (!request_found) {
-        // 2.2.1    We first check the priority buffer to prioritize e.g., maintenance requests
-        if (m_priority_buffer.size() != 0) {
-          req_buffer = &m_priority_buffer;
-          req_it = m_priority_buffer.begin();
-          req_it->command = m_dram->get_preq_command(req_it->final_command, req_it->addr_vec);
-          
-          request_found = m_dram->check_ready(req_it->command, req_it->addr_vec);
-          if (!request_found & m_priority_buffer.size() != 0) {
-            return false;
-          }
-        }
-
-        // 2.2.1    If no request to be scheduled in the priority buffer, check the read and write buffers.
-        if (!request_found) {
-          // Query the write policy to decide which buffer to serve
-          set_write_mode();
-          auto& buffer = m_is_write_mode ? m_write_buffer : m_read_buffer;
-          if (req_it = m_scheduler->get_best_request(buffer); req_it != buffer.end()) {
-            request_found = m_dram->check_ready(req_it->command, req_it->addr_vec);
-            req_buffer = &buffer;
-          }
-        }
-      }
-
-      if (request_found) {
-        if (m_dram->m_command_meta(req_it->command).is_closing) {
-          auto& rowgroup = req_it->addr_vec;
-          for (auto _it = m_active_buffer.begin(); _it != m_active_buffer.end(); _it++) {
-            auto& _it_rowgroup = _it->addr_vec;
-            bool is_matching = true;
-            for (int i = 0; i < m_bank_addr_idx + 1 ; i++) {
-              if (_it_rowgroup[i] != rowgroup[i] && _it_rowgroup[i] != -1 && rowgroup[i] != -1) {
-                is_matching = false;
-                break;
-              }
-            }
-            if (is_matching) {
-              request_found = false;
-              break;
-            }
-          }
-        }
-      }
+      bool request_found = schedule(m_scheduler, req_it, req_buffer) == Pick::Found;
 
       if (request_found && req_buffer != &m_active_buffer) {
         if (req_it->type_id == Request::Type::Read
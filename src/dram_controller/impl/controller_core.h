@@ -0,0 +1,269 @@
+#ifndef RAMULATOR_CONTROLLER_CONTROLLER_CORE_H_
+#define RAMULATOR_CONTROLLER_CONTROLLER_CORE_H_
+
+#include <vector>
+
+#include "base/base.h"
+#include "dram/dram.h"
+#include "dram_controller/write_drain.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Switches between serving reads and draining writes at two watermarks of the write buffer.
+ *
+ */
+struct WatermarkWriteDrain {
+  float low_watermark = 0.2f;     // Back to reads below this fill of the write buffer (and with reads waiting)
+  float high_watermark = 0.8f;    // Drain writes above this fill (or without reads waiting)
+  bool write_mode = false;
+
+  bool is_write_mode() const { return write_mode; };
+
+  /// Whether to serve the write buffer in this cycle
+  bool update(const ReqBuffer& read_buffer, const ReqBuffer& write_buffer) {
+    if (!write_mode) {
+      if ((write_buffer.size() > high_watermark * write_buffer.max_size) || read_buffer.size() == 0) {
+        write_mode = true;
+      }
+    } else {
+      if ((write_buffer.size() < low_watermark * write_buffer.max_size) && read_buffer.size() != 0) {
+        write_mode = false;
+      }
+    }
+    return write_mode;
+  };
+
+  /// Writes are drained in the order of the scheduler
+  ReqBuffer::iterator get_best_write(ReqBuffer& write_buffer) { return write_buffer.end(); };
+  void on_write_issued(const Request& req) { };
+};
+
+/**
+ * @brief    The IWriteDrainPolicy of the controller config if it has one, else the watermarks.
+ *
+ */
+struct ConfigurableWriteDrain {
+  WatermarkWriteDrain watermark;
+  IWriteDrainPolicy* policy = nullptr;
+  const Clk_t* clk = nullptr;           // Clock of the controller, passed on to the policy
+
+  bool is_write_mode() const { return policy ? policy->is_write_mode() : watermark.is_write_mode(); };
+
+  bool update(const ReqBuffer& read_buffer, ReqBuffer& write_buffer) {
+    return policy ? policy->update(*clk, read_buffer, write_buffer) : watermark.update(read_buffer, write_buffer);
+  };
+
+  ReqBuffer::iterator get_best_write(ReqBuffer& write_buffer) {
+    return policy ? policy->get_best_write(write_buffer) : write_buffer.end();
+  };
+
+  void on_write_issued(const Request& req) {
+    if (policy) {
+      policy->on_write_issued(req);
+    }
+  };
+};
+
+/**
+ * @brief    The policy types a controller core is instantiated with.
+ * @details
+ * With a final implementation class (e.g., FRFCFS, OpenRowPolicy, AllBankRefresh), the calls to it are direct and can be
+ * inlined. With the interface itself (IScheduler, IRowPolicy, IRefreshManager), they stay virtual, which is the fallback
+ * for any combination of implementations from the config.
+ *
+ */
+template <class SchedulerT, class RowPolicyT, class RefreshT>
+struct ControllerPolicies {
+  using Scheduler = SchedulerT;
+  using RowPolicy = RowPolicyT;
+  using Refresh = RefreshT;
+};
+
+/**
+ * @brief    The request buffers and the scheduling pass shared by the Generic, BH and PRAC controllers.
+ * @details
+ * A controller derives from the core and keeps its own issue path and statistics. schedule() picks a request in the order
+ * all of them use:
+ *   1. The best request of the active buffer (requests whose row is being opened), if it is ready.
+ *   2. The head of the priority buffer (e.g., refreshes). While it is not ready, no other request is served.
+ *   3. The best request of the read or the write buffer, as the write-drain policy selects.
+ * A command that closes a row is held back while requests in the active buffer still wait for its bank. The active
+ * requests are counted per bank, so this check does not scan the active buffer. The scheduler type is a template
+ * parameter of each call (see ControllerPolicies), and admit(req_it) lets the controller veto any candidate.
+ *
+ */
+template <class WriteDrainT = WatermarkWriteDrain>
+class ControllerCore {
+  protected:
+    enum class Pick { Found, None, Blocked };   // Blocked: the head of a priority buffer is waiting and holds back the rest
+
+    struct AdmitAll {
+      bool operator()(const ReqBuffer::iterator&) const { return true; };
+    };
+
+    ReqBuffer m_active_buffer;            // Buffer for requests being served. This has the highest priority
+    ReqBuffer m_priority_buffer;          // Buffer for high-priority requests (e.g., maintenance like refresh).
+    ReqBuffer m_read_buffer;              // Read request buffer
+    ReqBuffer m_write_buffer;             // Write request buffer
+    WriteDrainT m_write_drain;            // When to serve the write buffer instead of the read buffer
+
+  private:
+    IDRAM* m_core_dram = nullptr;
+    int m_core_bank_level = -1;
+    std::vector<int> m_core_level_sizes;  // Organization counts from the channel down to the bank level
+    std::vector<int> m_active_bank_reqs;  // Number of requests in m_active_buffer per flat bank id
+    int m_num_wildcard_active_reqs = 0;   // Requests in m_active_buffer with a wildcard down to the bank level
+
+  protected:
+    void setup_core(IDRAM* dram) {
+      m_core_dram = dram;
+      m_core_bank_level = dram->m_levels("bank");
+      size_t num_banks = 1;
+      for (int level = 0; level <= m_core_bank_level; level++) {
+        m_core_level_sizes.push_back(dram->m_organization.count[level]);
+        num_banks *= m_core_level_sizes.back();
+      }
+      m_active_bank_reqs.assign(num_banks, 0);
+    };
+
+    bool is_write_mode() const { return m_write_drain.is_write_mode(); };
+
+    /**
+     * @brief    Picks the request to serve in this cycle into req_it and req_buffer (if the result is Pick::Found).
+     *
+     */
+    template <class SchedulerT>
+    Pick schedule(SchedulerT* scheduler, ReqBuffer::iterator& req_it, ReqBuffer*& req_buffer) {
+      return schedule(scheduler, req_it, req_buffer, AdmitAll{});
+    };
+
+    template <class SchedulerT, class AdmitT>
+    Pick schedule(SchedulerT* scheduler, ReqBuffer::iterator& req_it, ReqBuffer*& req_buffer, AdmitT&& admit) {
+      Pick pick = pick_best(scheduler, m_active_buffer, req_it, req_buffer, admit) ? Pick::Found : Pick::None;
+      if (pick == Pick::None) {
+        pick = pick_head(m_priority_buffer, req_it, req_buffer, admit);
+      }
+      if (pick == Pick::None) {
+        pick = pick_demand(scheduler, req_it, req_buffer, admit);
+      }
+      return check_close(pick, req_it);
+    };
+
+    /// The ready best request of buffer, as the scheduler ranks them
+    template <class SchedulerT, class AdmitT>
+    bool pick_best(SchedulerT* scheduler, ReqBuffer& buffer, ReqBuffer::iterator& req_it, ReqBuffer*& req_buffer, AdmitT&& admit) {
+      req_it = RAMULATOR_PROFILE_CALL(scheduler, get_best_request(buffer));
+      if (req_it == buffer.end()) {
+        return false;
+      }
+      req_buffer = &buffer;
+      return admit(req_it) && m_core_dram->check_ready(req_it->command, req_it->addr_vec);
+    };
+
+    /// The head of a first-come first-served buffer (e.g., maintenance requests), which blocks the others until ready
+    template <class AdmitT>
+    Pick pick_head(ReqBuffer& buffer, ReqBuffer::iterator& req_it, ReqBuffer*& req_buffer, AdmitT&& admit) {
+      if (buffer.size() == 0) {
+        return Pick::None;
+      }
+      req_buffer = &buffer;
+      req_it = buffer.begin();
+      req_it->command = m_core_dram->get_preq_command(req_it->final_command, req_it->addr_vec);
+      return admit(req_it) && m_core_dram->check_ready(req_it->command, req_it->addr_vec) ? Pick::Found : Pick::Blocked;
+    };
+
+    /// The ready best request of the read or write buffer, as the write-drain policy selects
+    template <class SchedulerT, class AdmitT>
+    Pick pick_demand(SchedulerT* scheduler, ReqBuffer::iterator& req_it, ReqBuffer*& req_buffer, AdmitT&& admit) {
+      if (!m_write_drain.update(m_read_buffer, m_write_buffer)) {
+        return pick_best(scheduler, m_read_buffer, req_it, req_buffer, admit) ? Pick::Found : Pick::None;
+      }
+      // The write-drain policy may pick the write itself
+      if (auto it = m_write_drain.get_best_write(m_write_buffer); it != m_write_buffer.end()) {
+        req_it = it;
+        req_buffer = &m_write_buffer;
+        return admit(req_it) && m_core_dram->check_ready(req_it->command, req_it->addr_vec) ? Pick::Found : Pick::None;
+      }
+      return pick_best(scheduler, m_write_buffer, req_it, req_buffer, admit) ? Pick::Found : Pick::None;
+    };
+
+    /// Holds back a command that would close a row the active buffer still waits for
+    Pick check_close(Pick pick, const ReqBuffer::iterator& req_it) {
+      if (pick == Pick::Found && m_core_dram->m_command_meta(req_it->command).is_closing &&
+          num_active_bank_requests(req_it->addr_vec) != 0) {
+        return Pick::None;
+      }
+      return pick;
+    };
+
+    /**
+     * @brief    Number of requests in the active buffer to the banks of addr_vec (wildcards match any bank)
+     *
+     */
+    int num_active_bank_requests(const AddrVec_t& addr_vec) {
+      if (m_num_wildcard_active_reqs > 0) {
+        // Wildcard entries do not belong to a single bank, so fall back to matching every entry
+        int num_reqs = 0;
+        for (const Request& req : m_active_buffer) {
+          bool is_matching = true;
+          for (int i = 0; i <= m_core_bank_level; i++) {
+            if (req.addr_vec[i] != addr_vec[i] && req.addr_vec[i] != -1 && addr_vec[i] != -1) {
+              is_matching = false;
+              break;
+            }
+          }
+          num_reqs += is_matching;
+        }
+        return num_reqs;
+      }
+      return count_active_requests(addr_vec, 0, 0);
+    };
+
+    /**
+     * @brief    Flat id of the bank of addr_vec, or -1 if it has a wildcard down to the bank level
+     *
+     */
+    int flat_bank_id(const AddrVec_t& addr_vec) const {
+      int id = 0;
+      for (int level = 0; level <= m_core_bank_level; level++) {
+        if (addr_vec[level] < 0) {
+          return -1;
+        }
+        id = id * m_core_level_sizes[level] + addr_vec[level];
+      }
+      return id;
+    };
+
+    /// Counts a request (of flat bank_id) entering (+1) or leaving (-1) the active buffer
+    void update_active_count(int bank_id, int delta) {
+      if (bank_id == -1) {
+        m_num_wildcard_active_reqs += delta;
+      } else {
+        m_active_bank_reqs[bank_id] += delta;
+      }
+    };
+
+  private:
+    /**
+     * @brief    Sums the active-buffer counts of the banks under addr_vec, expanding wildcards level by level
+     *
+     */
+    int count_active_requests(const AddrVec_t& addr_vec, int level, int id) const {
+      if (level > m_core_bank_level) {
+        return m_active_bank_reqs[id];
+      }
+      if (addr_vec[level] >= 0) {
+        return count_active_requests(addr_vec, level + 1, id * m_core_level_sizes[level] + addr_vec[level]);
+      }
+      int num_reqs = 0;
+      for (int node = 0; node < m_core_level_sizes[level]; node++) {
+        num_reqs += count_active_requests(addr_vec, level + 1, id * m_core_level_sizes[level] + node);
+      }
+      return num_reqs;
+    };
+};
+
+}        // namespace Ramulator
+
+#endif   // RAMULATOR_CONTROLLER_CONTROLLER_CORE_H_
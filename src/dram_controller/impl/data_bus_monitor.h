@@ -0,0 +1,123 @@
+#ifndef RAMULATOR_CONTROLLER_DATA_BUS_MONITOR_H
+#define RAMULATOR_CONTROLLER_DATA_BUS_MONITOR_H
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <string_view>
+
+#include "base/type.h"
+#include "dram/dram.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Classifies every cycle of the data bus of a channel as busy or as the reason it idles.
+ *
+ * @details
+ * A column command issued at clk puts a burst on the data bus from clk + nCL (reads) or clk + nCWL (writes) for the
+ * burst length. The bursts are recorded when the controller issues the commands, in issue order, which the timing
+ * constraints keep in the order of their bursts. Every controller cycle is then:
+ *   - Busy:          a burst is on the bus,
+ *   - Empty:         idle with no demand request buffered,
+ *   - Refresh:       idle while a refresh waits in the priority buffer or is within nRFC of being issued,
+ *   - Turnaround:    idle after the controller switched between reads and writes, until its first burst in the new
+ *                    direction (tRTW / tWTR),
+ *   - BankConflict:  idle with requests that are not ready (precharges, activations, tCCD_L and other bank timings).
+ *
+ */
+class DataBusMonitor {
+  public:
+    enum State : int { Busy = 0, Turnaround, Refresh, BankConflict, Empty, NUM_STATES };
+    static constexpr std::array<std::string_view, NUM_STATES> STATE_NAMES = {"busy", "turnaround", "refresh", "bank_conflict", "empty"};
+
+  private:
+    struct Burst {
+      Clk_t start;
+      Clk_t end;
+    };
+    std::deque<Burst> m_bursts;        // Bursts that have not finished, in bus order
+
+    Clk_t m_burst_cycles = 0;
+    Clk_t m_read_delay = 0;
+    Clk_t m_write_delay = 0;
+    Clk_t m_refresh_cycles = 0;
+    Clk_t m_refresh_until = -1;        // Cycle the last refresh issued finishes
+    bool m_last_is_write = false;      // Direction of the last burst
+
+  public:
+    std::array<size_t, NUM_STATES> s_cycles = {};
+
+  public:
+    void setup(IDRAM* dram) {
+      m_read_delay = dram->m_timing_vals("nCL");
+      m_burst_cycles = dram->m_read_latency - m_read_delay;
+      m_write_delay = dram->m_timings.contains("nCWL") ? dram->m_timing_vals("nCWL") : m_read_delay;
+      for (std::string_view name : {"nRFC", "nRFC1", "nRFCab"}) {
+        if (dram->m_timings.contains(name)) {
+          m_refresh_cycles = dram->m_timing_vals(name);
+          break;
+        }
+      }
+    };
+
+    Clk_t get_burst_cycles() const { return m_burst_cycles; };
+
+    /**
+     * @brief    Records the burst of a column command (or the refresh window of a refresh) issued at clk.
+     *
+     */
+    void on_command(Clk_t clk, const DRAMCommandMeta& meta, bool is_write) {
+      if (meta.is_accessing) {
+        Clk_t start = clk + (is_write ? m_write_delay : m_read_delay);
+        m_bursts.push_back({start, start + m_burst_cycles});
+        m_last_is_write = is_write;
+      } else if (meta.is_refreshing) {
+        m_refresh_until = std::max(m_refresh_until, clk + m_refresh_cycles);
+      }
+    };
+
+    /**
+     * @brief    Classifies cycle clk from the buffered requests of the controller.
+     *
+     */
+    void tick(Clk_t clk, bool has_demand, bool has_priority, bool is_write_mode) {
+      while (!m_bursts.empty() && m_bursts.front().end <= clk) {
+        m_bursts.pop_front();
+      }
+      State state;
+      if (!m_bursts.empty() && m_bursts.front().start <= clk) {
+        state = Busy;
+      } else if (!has_demand) {
+        state = Empty;
+      } else if (has_priority || clk < m_refresh_until) {
+        state = Refresh;
+      } else if (is_write_mode != m_last_is_write) {
+        state = Turnaround;
+      } else {
+        state = BankConflict;
+      }
+      s_cycles[state]++;
+    };
+
+    /**
+     * @brief    Classifies the cycles after clk up to clk + num_cycles, in which the controller has no demand requests.
+     *
+     */
+    void skip_cycles(Clk_t clk, Clk_t num_cycles) {
+      Clk_t last = clk + num_cycles;
+      size_t busy = 0;
+      for (const Burst& burst : m_bursts) {
+        busy += std::max<Clk_t>(std::min(burst.end, last + 1) - std::max(burst.start, clk + 1), 0);
+      }
+      while (!m_bursts.empty() && m_bursts.front().end <= last + 1) {
+        m_bursts.pop_front();
+      }
+      s_cycles[Busy] += busy;
+      s_cycles[Empty] += num_cycles - busy;
+    };
+};
+
+}        // namespace Ramulator
+
+#endif   // RAMULATOR_CONTROLLER_DATA_BUS_MONITOR_H
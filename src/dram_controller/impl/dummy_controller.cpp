@@ -24,6 +24,14 @@ class DummyController final : public IDRAMController, public Implementation {
       return true; 
     };
 
+    bool is_demand_idle() override {
+      return true;
+    }
+
+    int num_active_requests(const AddrVec_t& addr_vec) override {
+      return 0;
+    }
+
     void tick() override {
       return;
     }
@@ -1,23 +1,59 @@
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <vector>
+
 #include "dram_controller/controller.h"
 #include "memory_system/memory_system.h"
+#include "dram_controller/impl/addr_count_table.h"
+#include "dram_controller/impl/controller_core.h"
+#include "dram_controller/impl/data_bus_monitor.h"
+#include "dram_controller/impl/latency_histogram.h"
+#include "dram_controller/impl/request_lifecycle.h"
+#include "dram_controller/impl/plugin/ecc/decoder_pipeline.h"
+#include "dram_controller/impl/plugin/qos/qos.h"
+#include "dram_controller/impl/scheduler/generic_scheduler.h"
+#include "dram_controller/impl/rowpolicy/basic_rowpolicies.h"
+#include "dram_controller/impl/refresh/all_bank_refresh.h"
 
 namespace Ramulator {
 
-class GenericDRAMController final : public IDRAMController, public Implementation {
+class GenericDRAMController final : public IDRAMController, public Implementation, private ControllerCore<ConfigurableWriteDrain> {
   RAMULATOR_REGISTER_IMPLEMENTATION(IDRAMController, GenericDRAMController, "Generic", "A generic DRAM controller.");
   private:
-    std::deque<Request> pending;          // A queue for read requests that are about to finish (callback after RL)
+    ReqBuffer pending;                    // A queue for read requests that are about to finish (callback after RL)
+
+    struct PendingDepart {
+      Clk_t depart;
+      uint64_t seq;                       // Arrival order in pending, breaks ties between equal departs
+      ReqBuffer::iterator req_it;
+      bool operator>(const PendingDepart& other) const { return std::tie(depart, seq) > std::tie(other.depart, other.seq); };
+    };
+    std::priority_queue<PendingDepart, std::vector<PendingDepart>, std::greater<PendingDepart>> m_pending_departs;   // Min-heap over pending
+    uint64_t m_pending_seq = 0;
+    DecoderPipeline m_decoder;            // ECC decoder stage between the read data and the callback (disabled if decoder_lanes is 0)
+    IQoS* m_qos = nullptr;                // Bandwidth regulation at send(), if the QoS plugin is configured
+
+    int m_lifecycle_interval = 0;
+    std::string m_lifecycle_path;
+    RequestLifecycleSampler m_lifecycle;  // Latency breakdown of 1 in m_lifecycle_interval requests (disabled if 0)
+    Clk_t m_write_mode_cycles = 0;        // Cycles spent draining writes, while the sampler is enabled
+
+    DataBusMonitor m_data_bus;            // What the data bus does in every cycle
 
-    ReqBuffer m_active_buffer;            // Buffer for requests being served. This has the highest priority 
-    ReqBuffer m_priority_buffer;          // Buffer for high-priority requests (e.g., maintenance like refresh).
-    ReqBuffer m_read_buffer;              // Read request buffer
-    ReqBuffer m_write_buffer;             // Write request buffer
+    AddrCountTable m_write_addrs;         // Addresses in m_write_buffer, for write-to-read forwarding
 
-    int m_bank_addr_idx = -1;
+    bool m_plugin_dispatch_ready = false;
+    std::vector<IControllerPlugin*> m_tick_plugins;                   // Plugins updated every cycle
+    std::vector<std::vector<IControllerPlugin*>> m_command_plugins;   // Plugins updated per issued command id, in configuration order
 
-    float m_wr_low_watermark;
-    float m_wr_high_watermark;
-    bool  m_is_write_mode = false;
+    using TickFunc = void (GenericDRAMController::*)();
+    TickFunc m_tick = nullptr;            // tick_with() instantiated for the scheduler, row policy and refresh types (see select_tick())
+    bool m_devirtualize = true;
+
+    bool m_dual_issue = false;            // Issue a row and a column command in one cycle (devices with a dual command bus)
+    bool m_partial_writes = false;        // The device has a masked write for Request::Type::PartialWrite (DDR5 WRP)
 
     size_t s_row_hits = 0;
     size_t s_row_misses = 0;
@@ -33,6 +69,12 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
     std::vector<size_t> s_read_row_hits_per_core;
     std::vector<size_t> s_read_row_misses_per_core;
     std::vector<size_t> s_read_row_conflicts_per_core;
+    std::vector<size_t> s_dram_reads_per_core;
+    std::vector<size_t> s_dram_writes_per_core;
+    std::vector<size_t> s_read_latency_per_core;
+    std::vector<float> s_avg_read_latency_per_core;
+    std::vector<float> s_bandwidth_per_core;         // GB/s of reads and writes served by the DRAM
+    std::vector<float> s_read_slowdown_per_core;     // Average read latency over the latency of an immediate row hit
 
     size_t s_num_read_reqs = 0;
     size_t s_num_write_reqs = 0;
@@ -45,19 +87,85 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
     float s_read_queue_len_avg = 0;
     float s_write_queue_len_avg = 0;
     float s_priority_queue_len_avg = 0;
+    size_t s_refresh_stall_cycles = 0;    // Cycles demand requests waited behind a priority (e.g., refresh) request that was not ready
 
     size_t s_read_latency = 0;
     float s_avg_read_latency = 0;
+    size_t s_write_latency = 0;           // From arrival to the final write command
+    float s_avg_write_latency = 0;
+    size_t s_num_forwarded_reads = 0;
+
+    // Latency distributions: DRAM reads, writes, and reads served from the write buffer
+    LatencyHistogram m_read_latency_histogram;
+    LatencyHistogram m_write_latency_histogram;
+    LatencyHistogram m_forwarded_read_latency_histogram;
+    struct LatencyQuantiles {
+      size_t p50 = 0;
+      size_t p99 = 0;
+      size_t p999 = 0;
+      size_t max = 0;
+    };
+    LatencyQuantiles s_read_latency_quantiles;
+    LatencyQuantiles s_write_latency_quantiles;
+    LatencyQuantiles s_forwarded_read_latency_quantiles;
+
+    float s_decoder_occupancy = 0;
+    float s_decoder_queue_len_avg = 0;
+    float s_avg_decoder_latency = 0;
+    size_t s_decoder_latency_p99 = 0;
+    size_t s_decoder_latency_p999 = 0;
+
+    // Average cycles per step of the sampled requests (see RequestLifecycleSampler)
+    struct LifecycleBreakdown {
+      float queueing = 0;
+      float write_drain = 0;
+      float row = 0;
+      float cas = 0;
+      float ecc = 0;
+    };
+    LifecycleBreakdown s_read_lifecycle;
+    LifecycleBreakdown s_write_lifecycle;
+
+    size_t s_row_bus_commands = 0;
+    size_t s_column_bus_commands = 0;
+    size_t s_dual_issue_cycles = 0;       // Cycles with a command on both buses
+    float s_row_bus_utilization = 0;
+    float s_column_bus_utilization = 0;
+
+    float s_data_bus_utilization = 0;     // Fraction of the cycles the data bus transferred data
+    float s_bandwidth = 0;                // GB/s of reads and writes served by the DRAM
+    float s_peak_bandwidth = 0;           // GB/s with a burst on the data bus in every cycle
+    float s_bandwidth_efficiency = 0;     // Achieved over peak bandwidth
 
 
   public:
     void init() override {
-      m_wr_low_watermark =  param<float>("wr_low_watermark").desc("Threshold for switching back to read mode.").default_val(0.2f);
-      m_wr_high_watermark = param<float>("wr_high_watermark").desc("Threshold for switching to write mode.").default_val(0.8f);
+      m_write_drain.watermark.low_watermark =  param<float>("wr_low_watermark").desc("Threshold for switching back to read mode.").default_val(0.2f);
+      m_write_drain.watermark.high_watermark = param<float>("wr_high_watermark").desc("Threshold for switching to write mode.").default_val(0.8f);
+      m_devirtualize = param<bool>("devirtualize").desc("Call the common scheduler, row policy and refresh implementations directly instead of through their interfaces.").default_val(true);
+      m_dual_issue = param<bool>("dual_issue").desc("Issue a row and a column command in the same cycle if the device has separate command buses.").default_val(true);
 
       m_scheduler = create_child_ifce<IScheduler>();
       m_refresh = create_child_ifce<IRefreshManager>();    
       m_rowpolicy = create_child_ifce<IRowPolicy>();    
+      if (m_config["WriteDrainPolicy"]) {
+        m_write_drain.policy = create_child_ifce<IWriteDrainPolicy>();
+        m_write_drain.clk = &m_clk;
+      }
+
+      int decoder_lanes = param<int>("decoder_lanes").desc("Number of parallel ECC decoder lanes (0 = no decoder stage).").default_val(0);
+      if (decoder_lanes > 0) {
+        Clk_t decoder_depth = param<Clk_t>("decoder_depth").desc("Cycles a full ECC decode takes.").default_val(8);
+        Clk_t decoder_ii = param<Clk_t>("decoder_initiation_interval").desc("Cycles between two codewords entering one decoder lane.").default_val(1);
+        Clk_t decoder_edc_latency = param<Clk_t>("decoder_edc_latency").desc("Cycles of the EDC check of reads that need no correction.").default_val(1);
+        m_decoder = DecoderPipeline(decoder_lanes, decoder_depth, decoder_ii, decoder_edc_latency);
+      }
+
+      m_lifecycle_interval = param<int>("lifecycle_sample_interval").desc("Trace the lifecycle of 1 in this many requests (0 = none).").default_val(0);
+      m_lifecycle_path = param<std::string>("lifecycle_trace_path").desc("Path prefix of the binary trace of the sampled lifecycles (empty = stats only).").default_val("");
+      if (m_lifecycle_interval < 0) {
+        throw ConfigurationError("lifecycle_sample_interval cannot be negative (got {})!", m_lifecycle_interval);
+      }
 
       if (m_config["plugins"]) {
         YAML::Node plugin_configs = m_config["plugins"];
@@ -69,14 +177,26 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
 
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
       m_dram = memory_system->get_ifce<IDRAM>();
-      m_bank_addr_idx = m_dram->m_levels("bank");
+      m_dual_issue = m_dual_issue && m_dram->m_dual_command_bus;
+      m_partial_writes = m_dram->m_requests.contains("partial-write");
+      m_qos = get_plugin<IQoS>();
+      setup_core(m_dram);
+      m_data_bus.setup(m_dram);
+      m_tick = select_tick();
       m_priority_buffer.max_size = 512*3 + 32;
+      pending.max_size = std::numeric_limits<size_t>::max();
 
       m_num_cores = frontend->get_num_cores();
 
       s_read_row_hits_per_core.resize(m_num_cores, 0);
       s_read_row_misses_per_core.resize(m_num_cores, 0);
       s_read_row_conflicts_per_core.resize(m_num_cores, 0);
+      s_dram_reads_per_core.resize(m_num_cores, 0);
+      s_dram_writes_per_core.resize(m_num_cores, 0);
+      s_read_latency_per_core.resize(m_num_cores, 0);
+      s_avg_read_latency_per_core.resize(m_num_cores, 0);
+      s_bandwidth_per_core.resize(m_num_cores, 0);
+      s_read_slowdown_per_core.resize(m_num_cores, 0);
 
       register_stat(s_row_hits).name("row_hits_{}", m_channel_id);
       register_stat(s_row_misses).name("row_misses_{}", m_channel_id);
@@ -92,6 +212,12 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
         register_stat(s_read_row_hits_per_core[core_id]).name("read_row_hits_core_{}", core_id);
         register_stat(s_read_row_misses_per_core[core_id]).name("read_row_misses_core_{}", core_id);
         register_stat(s_read_row_conflicts_per_core[core_id]).name("read_row_conflicts_core_{}", core_id);
+        register_stat(s_dram_reads_per_core[core_id]).name("dram_reads_core_{}", core_id);
+        register_stat(s_dram_writes_per_core[core_id]).name("dram_writes_core_{}", core_id);
+        register_stat(s_read_latency_per_core[core_id]).name("read_latency_core_{}", core_id);
+        register_stat(s_avg_read_latency_per_core[core_id]).name("avg_read_latency_core_{}", core_id);
+        register_stat(s_bandwidth_per_core[core_id]).name("bandwidth_GBs_core_{}", core_id);
+        register_stat(s_read_slowdown_per_core[core_id]).name("read_slowdown_core_{}", core_id);
       }
 
       register_stat(s_num_read_reqs).name("num_read_reqs_{}", m_channel_id);
@@ -105,9 +231,66 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
       register_stat(s_read_queue_len_avg).name("read_queue_len_avg_{}", m_channel_id);
       register_stat(s_write_queue_len_avg).name("write_queue_len_avg_{}", m_channel_id);
       register_stat(s_priority_queue_len_avg).name("priority_queue_len_avg_{}", m_channel_id);
+      register_stat(s_refresh_stall_cycles).name("refresh_stall_cycles_{}", m_channel_id);
 
       register_stat(s_read_latency).name("read_latency_{}", m_channel_id);
       register_stat(s_avg_read_latency).name("avg_read_latency_{}", m_channel_id);
+      register_stat(s_write_latency).name("write_latency_{}", m_channel_id);
+      register_stat(s_avg_write_latency).name("avg_write_latency_{}", m_channel_id);
+      register_stat(s_num_forwarded_reads).name("num_forwarded_reads_{}", m_channel_id);
+      register_latency_quantiles(s_read_latency_quantiles, "read_latency");
+      register_latency_quantiles(s_write_latency_quantiles, "write_latency");
+      register_latency_quantiles(s_forwarded_read_latency_quantiles, "forwarded_read_latency");
+
+      for (int state = 0; state < DataBusMonitor::NUM_STATES; state++) {
+        register_stat(m_data_bus.s_cycles[state]).name("data_bus_{}_cycles_{}", DataBusMonitor::STATE_NAMES[state], m_channel_id);
+      }
+      register_stat(s_data_bus_utilization).name("data_bus_utilization_{}", m_channel_id);
+      register_stat(s_bandwidth).name("bandwidth_GBs_{}", m_channel_id);
+      register_stat(s_peak_bandwidth).name("peak_bandwidth_GBs_{}", m_channel_id);
+      register_stat(s_bandwidth_efficiency).name("bandwidth_efficiency_{}", m_channel_id);
+
+      if (m_decoder.enabled()) {
+        register_stat(m_decoder.s_fast_path_reads).name("decoder_fast_path_reads_{}", m_channel_id);
+        register_stat(m_decoder.s_slow_path_reads).name("decoder_slow_path_reads_{}", m_channel_id);
+        register_stat(m_decoder.s_stall_cycles).name("decoder_stall_cycles_{}", m_channel_id);
+        register_stat(m_decoder.s_added_latency).name("decoder_latency_{}", m_channel_id);
+        register_stat(m_decoder.s_max_added_latency).name("decoder_latency_max_{}", m_channel_id);
+        register_stat(s_avg_decoder_latency).name("avg_decoder_latency_{}", m_channel_id);
+        register_stat(s_decoder_latency_p99).name("decoder_latency_p99_{}", m_channel_id);
+        register_stat(s_decoder_latency_p999).name("decoder_latency_p999_{}", m_channel_id);
+        register_stat(s_decoder_occupancy).name("decoder_occupancy_{}", m_channel_id);
+        register_stat(s_decoder_queue_len_avg).name("decoder_queue_len_avg_{}", m_channel_id);
+      }
+
+      if (m_lifecycle_interval > 0) {
+        std::string path = m_lifecycle_path.empty() ? "" : fmt::format("{}.ch{}", m_lifecycle_path, m_channel_id);
+        m_lifecycle = RequestLifecycleSampler(m_lifecycle_interval, path);
+        if (m_decoder.enabled()) {
+          m_decoder.on_finish = [this](Request& req) {
+            if (req.lifecycle_id >= 0) {
+              m_lifecycle.on_decoded(req, m_clk);
+            }
+          };
+        }
+        register_stat(m_lifecycle.s_reads.num_requests).name("lifecycle_sampled_reads_{}", m_channel_id);
+        register_stat(m_lifecycle.s_writes.num_requests).name("lifecycle_sampled_writes_{}", m_channel_id);
+        register_stat(s_read_lifecycle.queueing).name("lifecycle_read_queueing_{}", m_channel_id);
+        register_stat(s_read_lifecycle.write_drain).name("lifecycle_read_write_drain_{}", m_channel_id);
+        register_stat(s_read_lifecycle.row).name("lifecycle_read_row_{}", m_channel_id);
+        register_stat(s_read_lifecycle.cas).name("lifecycle_read_cas_{}", m_channel_id);
+        register_stat(s_read_lifecycle.ecc).name("lifecycle_read_ecc_{}", m_channel_id);
+        register_stat(s_write_lifecycle.queueing).name("lifecycle_write_queueing_{}", m_channel_id);
+        register_stat(s_write_lifecycle.row).name("lifecycle_write_row_{}", m_channel_id);
+      }
+
+      if (m_dual_issue) {
+        register_stat(s_row_bus_commands).name("row_bus_commands_{}", m_channel_id);
+        register_stat(s_column_bus_commands).name("column_bus_commands_{}", m_channel_id);
+        register_stat(s_dual_issue_cycles).name("dual_issue_cycles_{}", m_channel_id);
+        register_stat(s_row_bus_utilization).name("row_bus_utilization_{}", m_channel_id);
+        register_stat(s_column_bus_utilization).name("column_bus_utilization_{}", m_channel_id);
+      }
     };
 
     bool send(Request& req) override {
@@ -118,7 +301,8 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
           s_num_read_reqs++;
           break;
         }
-        case Request::Type::Write: {
+        case Request::Type::Write:
+        case Request::Type::PartialWrite: {
           s_num_write_reqs++;
           break;
         }
@@ -129,33 +313,60 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
       }
 
       // Forward existing write requests to incoming read requests
+      req.arrive = m_clk;
       if (req.type_id == Request::Type::Read) {
-        auto compare_addr = [req](const Request& wreq) {
-          return wreq.addr == req.addr;
-        };
-        if (std::find_if(m_write_buffer.begin(), m_write_buffer.end(), compare_addr) != m_write_buffer.end()) {
+        if (m_write_addrs.contains(req.addr)) {
           // The request will depart at the next cycle
           req.depart = m_clk + 1;
-          pending.push_back(req);
+          pending.enqueue(req);
+          track_pending_depart();
           return true;
         }
       }
 
+      // Plugins see the request before it is buffered and may serve it without DRAM access (e.g., a read of a
+      // codeword the ECC decoder still holds)
+      if (serve_by_plugins(req)) {
+        return true;
+      }
+
+      // A source out of bandwidth tokens is refused until they refill, and the frontend retries the request
+      if (m_qos && m_qos->is_throttled(req)) {
+        req.arrive = -1;
+        return false;
+      }
+
+      // The buffered copy of a sampled request carries its lifecycle slot
+      int lifecycle_id = m_lifecycle.sample(req, m_clk, m_write_mode_cycles);
+      req.lifecycle_id = lifecycle_id;
+
       // Else, enqueue them to corresponding buffer based on request type id
       bool is_success = false;
-      req.arrive = m_clk;
       if        (req.type_id == Request::Type::Read) {
         is_success = m_read_buffer.enqueue(req);
       } else if (req.type_id == Request::Type::Write) {
         is_success = m_write_buffer.enqueue(req);
+        if (is_success) {
+          m_write_addrs.insert(req.addr);
+        }
+      } else if (req.type_id == Request::Type::PartialWrite && m_partial_writes) {
+        // Masked writes are drained with the writes, but cannot forward their data to reads
+        is_success = m_write_buffer.enqueue(req);
       } else {
         throw std::runtime_error("Invalid request type!");
       }
+      req.lifecycle_id = -1;
       if (!is_success) {
         // We could not enqueue the request
+        if (lifecycle_id >= 0) {
+          m_lifecycle.cancel(lifecycle_id);
+        }
         req.arrive = -1;
         return false;
       }
+      if (m_qos) {
+        m_qos->on_admitted(req);
+      }
 
       return true;
     };
@@ -168,7 +379,95 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
       return is_success;
     }
 
+    bool is_demand_idle() override {
+      return m_read_buffer.size() == 0 && m_write_buffer.size() == 0;
+    }
+
+    void complete_read(Request& req) override {
+      if (m_decoder.enabled()) {
+        m_decoder.push(req, m_clk);
+      } else if (req.callback) {
+        req.callback(req);
+      }
+    }
+
+    int num_active_requests(const AddrVec_t& addr_vec) override {
+      return num_active_bank_requests(addr_vec);
+    }
+
+    int num_row_requests(const AddrVec_t& addr_vec) override {
+      int row_level = m_dram->m_levels("row");
+      int num_reqs = 0;
+      for (ReqBuffer* buffer : {&m_read_buffer, &m_write_buffer}) {
+        for (auto& req : *buffer) {
+          num_reqs += std::equal(addr_vec.begin(), addr_vec.begin() + row_level + 1, req.addr_vec.begin());
+        }
+      }
+      return num_reqs;
+    }
+
     void tick() override {
+      (this->*m_tick)();
+    };
+
+    Clk_t get_idle_cycles() override {
+      // Any buffered request may become ready, and the decoder finishes reads on its own schedule
+      if (m_active_buffer.size() || m_priority_buffer.size() || m_read_buffer.size() || m_write_buffer.size()) {
+        return 0;
+      }
+      if (m_decoder.enabled() && m_decoder.size() != 0) {
+        return 0;
+      }
+
+      Clk_t idle_cycles = std::numeric_limits<Clk_t>::max();
+      if (!m_pending_departs.empty()) {
+        idle_cycles = std::max<Clk_t>(m_pending_departs.top().depart - m_clk - 1, 0);
+      }
+      idle_cycles = std::min(idle_cycles, m_refresh->get_idle_cycles());
+      idle_cycles = std::min(idle_cycles, m_rowpolicy->get_idle_cycles());
+      for (auto plugin : m_plugins) {
+        if (plugin->get_subscription().per_cycle) {
+          idle_cycles = std::min(idle_cycles, plugin->get_idle_cycles());
+        }
+      }
+      return idle_cycles;
+    };
+
+    void skip_cycles(Clk_t num_cycles) override {
+      if (num_cycles <= 0) {
+        return;
+      }
+      m_clk += num_cycles;
+
+      // The same statistics tick() collects with only the pending queue occupied
+      s_queue_len += num_cycles * pending.size();
+      s_read_queue_len += num_cycles * pending.size();
+      m_data_bus.skip_cycles(m_clk - num_cycles, num_cycles);
+
+      m_refresh->skip_cycles(num_cycles);
+      m_rowpolicy->skip_cycles(num_cycles);
+      for (auto plugin : m_plugins) {
+        if (plugin->get_subscription().per_cycle) {
+          plugin->skip_cycles(num_cycles);
+        }
+      }
+
+      // An idle tick finds the read buffer empty and switches to write mode
+      m_write_drain.update(m_read_buffer, m_write_buffer);
+    };
+
+
+  private:
+    /**
+     * @brief    One controller cycle, with the scheduler, row policy and refresh manager called as the types of P
+     * 
+     */
+    template <class P>
+    void tick_with() {
+      auto* scheduler = static_cast<typename P::Scheduler*>(m_scheduler);
+      auto* rowpolicy = static_cast<typename P::RowPolicy*>(m_rowpolicy);
+      auto* refresh = static_cast<typename P::Refresh*>(m_refresh);
+
       m_clk++;
 
       // Update statistics
@@ -176,56 +475,143 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
       s_read_queue_len += m_read_buffer.size() + pending.size();
       s_write_queue_len += m_write_buffer.size();
       s_priority_queue_len += m_priority_buffer.size();
+      m_data_bus.tick(m_clk, !is_demand_idle() || m_active_buffer.size() != 0, m_priority_buffer.size() != 0, is_write_mode());
 
       // 1. Serve completed reads
       serve_completed_reads();
+      if (m_decoder.enabled()) {
+        m_decoder.tick(m_clk);
+      }
 
-      m_refresh->tick();
+      RAMULATOR_PROFILE_CALL(refresh, tick());
 
       // 2. Try to find a request to serve.
       ReqBuffer::iterator req_it;
       ReqBuffer* buffer = nullptr;
-      bool request_found = schedule_request(req_it, buffer);
+      bool request_found = schedule_request(scheduler, req_it, buffer);
+      if (m_lifecycle.enabled()) {
+        m_write_mode_cycles += is_write_mode();
+      }
+      if (request_found) {
+        decode_command(*req_it);
+        scheduler->on_command_issued(*req_it);
+      }
 
       // 2.1 Take row policy action
-      m_rowpolicy->update(request_found, req_it);
+      rowpolicy->update(request_found, req_it);
 
-      // 3. Update all plugins
-      for (auto plugin : m_plugins) {
-        plugin->update(request_found, req_it);
+      // 3. Update the plugins that subscribed to this cycle
+      if (!m_plugin_dispatch_ready) {
+        build_plugin_dispatch();
+      }
+      auto& plugins = request_found ? m_command_plugins[req_it->command] : m_tick_plugins;
+      for (auto plugin : plugins) {
+        if (request_found && !accepts_request_type(plugin, req_it->type_id)) {
+          continue;
+        }
+        RAMULATOR_PROFILE_CALL(plugin, update(request_found, req_it));
       }
 
       // 4. Finally, issue the commands to serve the request
-      if (request_found) {
-        // If we find a real request to serve
-        if (req_it->is_stat_updated == false) {
-          update_request_stats(req_it);
+      if (!request_found) {
+        return;
+      }
+      bool is_column_command = m_dram->m_command_meta(req_it->command).is_accessing;
+      issue_request(req_it, buffer);
+
+      // 5. With a dual command bus, the other bus can take a command of another request in the same cycle. The row
+      //    policy and the plugins see it as a second command of the cycle (CommandEvent::is_same_cycle).
+      if (m_dual_issue && schedule_request_on_bus(scheduler, !is_column_command, req_it, buffer)) {
+        s_dual_issue_cycles++;
+        decode_command(*req_it, true);
+        scheduler->on_command_issued(*req_it);
+        rowpolicy->update(true, req_it);
+        for (auto plugin : m_command_plugins[req_it->command]) {
+          if (accepts_request_type(plugin, req_it->type_id)) {
+            RAMULATOR_PROFILE_CALL(plugin, update(true, req_it));
+          }
         }
-        m_dram->issue_command(req_it->command, req_it->addr_vec);
+        issue_request(req_it, buffer);
+      }
+    };
 
-        // If we are issuing the last command, set depart clock cycle and move the request to the pending queue
-        if (req_it->command == req_it->final_command) {
-          if (req_it->type_id == Request::Type::Read) {
-            req_it->depart = m_clk + m_dram->m_read_latency;
-            pending.push_back(*req_it);
-          } else if (req_it->type_id == Request::Type::Write) {
-            // TODO: Add code to update statistics
-          }
-          buffer->remove(req_it);
-        } else {
-          if (m_dram->m_command_meta(req_it->command).is_opening) {
-            if (m_active_buffer.enqueue(*req_it)) {
-              buffer->remove(req_it);
-            }
+
+    /**
+     * @brief    Picks the tick_with() instantiation for the configured implementations. The common combinations are
+     *           called directly; any other falls back to the interfaces.
+     * 
+     */
+    TickFunc select_tick() {
+      if (m_devirtualize && dynamic_cast<FRFCFS*>(m_scheduler) && dynamic_cast<AllBankRefresh*>(m_refresh)) {
+        if (dynamic_cast<OpenRowPolicy*>(m_rowpolicy)) {
+          return &GenericDRAMController::tick_with<ControllerPolicies<FRFCFS, OpenRowPolicy, AllBankRefresh>>;
+        }
+        if (dynamic_cast<ClosedRowPolicy*>(m_rowpolicy)) {
+          return &GenericDRAMController::tick_with<ControllerPolicies<FRFCFS, ClosedRowPolicy, AllBankRefresh>>;
+        }
+      }
+      return &GenericDRAMController::tick_with<ControllerPolicies<IScheduler, IRowPolicy, IRefreshManager>>;
+    };
+
+    /**
+     * @brief    Sorts the plugins into dispatch lists from the subscriptions they declared in setup()
+     * @details
+     * Called on the first tick, as the plugins are set up after the controller.
+     * 
+     */
+    void build_plugin_dispatch() {
+      m_command_plugins.assign(m_dram->m_commands.size(), {});
+      for (auto plugin : m_plugins) {
+        const IControllerPlugin::Subscription& subscription = plugin->get_subscription();
+        if (subscription.per_cycle) {
+          m_tick_plugins.push_back(plugin);
+        }
+        for (int command = 0; command < (int) m_command_plugins.size(); command++) {
+          if (subscription.per_cycle || subscription.commands.empty() ||
+              std::find(subscription.commands.begin(), subscription.commands.end(), command) != subscription.commands.end()) {
+            m_command_plugins[command].push_back(plugin);
           }
         }
+      }
+      m_plugin_dispatch_ready = true;
+    };
+
+    void register_latency_quantiles(LatencyQuantiles& quantiles, std::string_view name) {
+      register_stat(quantiles.p50).name("{}_p50_{}", name, m_channel_id);
+      register_stat(quantiles.p99).name("{}_p99_{}", name, m_channel_id);
+      register_stat(quantiles.p999).name("{}_p999_{}", name, m_channel_id);
+      register_stat(quantiles.max).name("{}_max_{}", name, m_channel_id);
+    };
+
+    void compute_latency_quantiles(const LatencyHistogram& histogram, LatencyQuantiles& quantiles) {
+      quantiles.p50 = histogram.quantile(0.5);
+      quantiles.p99 = histogram.quantile(0.99);
+      quantiles.p999 = histogram.quantile(0.999);
+      quantiles.max = histogram.max();
+    };
 
+    void compute_lifecycle_breakdown(const RequestLifecycleSampler::Breakdown& totals, LifecycleBreakdown& averages) {
+      if (totals.num_requests == 0) {
+        return;
       }
+      float num_requests = (float) totals.num_requests;
+      averages.queueing = totals.queueing / num_requests;
+      averages.write_drain = totals.write_drain / num_requests;
+      averages.row = totals.row / num_requests;
+      averages.cas = totals.cas / num_requests;
+      averages.ecc = totals.ecc / num_requests;
+    };
 
+    bool is_core_source(int source_id) const {
+      return source_id >= 0 && source_id < (int) m_num_cores;
     };
 
+    bool accepts_request_type(IControllerPlugin* plugin, int type_id) const {
+      const IControllerPlugin::Subscription& subscription = plugin->get_subscription();
+      return subscription.per_cycle || subscription.request_types.empty() ||
+             std::find(subscription.request_types.begin(), subscription.request_types.end(), type_id) != subscription.request_types.end();
+    };
 
-  private:
     /**
      * @brief    Helper function to check if a request is hitting an open row
      * @details
@@ -245,6 +631,12 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
         return m_dram->check_node_open(req->final_command, req->addr_vec);
     }
 
+    /// Writes and, on a device with a masked write, partial writes (the other device request ids are maintenance)
+    bool is_write(const Request& req) const
+    {
+        return req.type_id == Request::Type::Write || (m_partial_writes && req.type_id == Request::Type::PartialWrite);
+    }
+
     /**
      * @brief    
      * @details
@@ -259,154 +651,267 @@ class GenericDRAMController final : public IDRAMController, public Implementatio
         if (is_row_hit(req)) {
           s_read_row_hits++;
           s_row_hits++;
+          m_rowpolicy->on_row_access(*req, IRowPolicy::RowAccess::Hit);
           if (req->source_id != -1)
             s_read_row_hits_per_core[req->source_id]++;
         } else if (is_row_open(req)) {
           s_read_row_conflicts++;
           s_row_conflicts++;
+          m_rowpolicy->on_row_access(*req, IRowPolicy::RowAccess::Conflict);
           if (req->source_id != -1)
             s_read_row_conflicts_per_core[req->source_id]++;
         } else {
           s_read_row_misses++;
           s_row_misses++;
+          m_rowpolicy->on_row_access(*req, IRowPolicy::RowAccess::Miss);
           if (req->source_id != -1)
             s_read_row_misses_per_core[req->source_id]++;
         } 
       } 
-      else if (req->type_id == Request::Type::Write) 
+      else if (is_write(*req)) 
       {
         if (is_row_hit(req)) {
           s_write_row_hits++;
           s_row_hits++;
+          m_rowpolicy->on_row_access(*req, IRowPolicy::RowAccess::Hit);
         } else if (is_row_open(req)) {
           s_write_row_conflicts++;
           s_row_conflicts++;
+          m_rowpolicy->on_row_access(*req, IRowPolicy::RowAccess::Conflict);
         } else {
           s_write_row_misses++;
           s_row_misses++;
+          m_rowpolicy->on_row_access(*req, IRowPolicy::RowAccess::Miss);
         }
       }
     }
 
+    /**
+     * @brief    Adds the request just moved to the back of the pending queue to the depart-ordered heap
+     * 
+     */
+    void track_pending_depart() {
+      auto req_it = std::prev(pending.end());
+      m_pending_departs.push({req_it->depart, m_pending_seq++, req_it});
+    };
+
     /**
      * @brief    Helper function to serve the completed read requests
      * @details
      * This function is called at the beginning of the tick() function.
-     * It checks the pending queue to see if the top request has received data from DRAM.
-     * If so, it finishes this request by calling its callback and poping it from the pending queue.
+     * It retires every pending request that has received its data from DRAM (depart <= m_clk), earliest depart first,
+     * by calling its callback and removing it from the pending queue. Forwarded reads (depart = arrive + 1) thus do not
+     * wait behind DRAM reads that were issued before them.
      */
     void serve_completed_reads() {
-      if (pending.size()) {
-        // Check the first pending request
-        auto& req = pending[0];
-        if (req.depart <= m_clk) {
-          // Request received data from dram
-          if (req.depart - req.arrive > 1) {
-            // Check if this requests accesses the DRAM or is being forwarded.
-            // TODO add the stats back
-            s_read_latency += req.depart - req.arrive;
+      while (!m_pending_departs.empty() && m_pending_departs.top().depart <= m_clk) {
+        ReqBuffer::iterator req_it = m_pending_departs.top().req_it;
+        m_pending_departs.pop();
+
+        auto& req = *req_it;
+        // Request received data from dram
+        if (req.depart - req.arrive > 1) {
+          // Check if this requests accesses the DRAM or is being forwarded.
+          // TODO add the stats back
+          s_read_latency += req.depart - req.arrive;
+          m_read_latency_histogram.record(req.depart - req.arrive);
+          if (is_core_source(req.source_id)) {
+            s_read_latency_per_core[req.source_id] += req.depart - req.arrive;
           }
+        } else {
+          s_num_forwarded_reads++;
+          m_forwarded_read_latency_histogram.record(req.depart - req.arrive);
+        }
 
-          if (req.callback) {
-            // If the request comes from outside (e.g., processor), call its callback
-            req.callback(req);
-          }
-          // Finally, remove this request from the pending queue
-          pending.pop_front();
+        if (req.lifecycle_id >= 0) {
+          m_lifecycle.on_data(req, m_clk, m_decoder.enabled());
         }
-      };
+        if (m_decoder.enabled() && req.depart - req.arrive > 1) {
+          // Read data from DRAM goes through the ECC decoder, which calls the callback when it is done
+          m_decoder.push(req, m_clk);
+        } else if (req.callback) {
+          // If the request comes from outside (e.g., processor), call its callback
+          req.callback(req);
+        }
+        // Finally, remove this request from the pending queue
+        pending.remove(req_it);
+      }
     };
 
 
     /**
-     * @brief    Checks if we need to switch to write mode
+     * @brief    Helper function to find a request to schedule from the buffers (see ControllerCore::schedule()).
      * 
      */
-    void set_write_mode() {
-      if (!m_is_write_mode) {
-        if ((m_write_buffer.size() > m_wr_high_watermark * m_write_buffer.max_size) || m_read_buffer.size() == 0) {
-          m_is_write_mode = true;
-        }
-      } else {
-        if ((m_write_buffer.size() < m_wr_low_watermark * m_write_buffer.max_size) && m_read_buffer.size() != 0) {
-          m_is_write_mode = false;
-        }
+    template <class SchedulerT>
+    bool schedule_request(SchedulerT* scheduler, ReqBuffer::iterator& req_it, ReqBuffer*& req_buffer) {
+      Pick pick = schedule(scheduler, req_it, req_buffer);
+      if (pick == Pick::Blocked && !is_demand_idle()) {
+        s_refresh_stall_cycles++;
       }
-    };
-
+      return pick == Pick::Found;
+    }
 
     /**
-     * @brief    Helper function to find a request to schedule from the buffers.
+     * @brief    Issues the command of req_it, taken from buffer, and moves the request on to the buffer of its next step
      * 
      */
-    bool schedule_request(ReqBuffer::iterator& req_it, ReqBuffer*& req_buffer) {
-      bool request_found = false;
-      // 2.1    First, check the act buffer to serve requests that are already activating (avoid useless ACTs)
-      if (req_it= m_scheduler->get_best_request(m_active_buffer); req_it != m_active_buffer.end()) {
-        if (m_dram->check_ready(req_it->command, req_it->addr_vec)) {
-          request_found = true;
-          req_buffer = &m_active_buffer;
+    void issue_request(ReqBuffer::iterator& req_it, ReqBuffer* buffer) {
+      if (m_dual_issue) {
+        if (m_dram->m_command_meta(req_it->command).is_accessing) {
+          s_column_bus_commands++;
+        } else {
+          s_row_bus_commands++;
         }
       }
-
-      // 2.2    If no requests can be scheduled from the act buffer, check the rest of the buffers
-      if (!request_found) {
-        // 2.2.1    We first check the priority buffer to prioritize e.g., maintenance requests
-        if (m_priority_buffer.size() != 0) {
-          req_buffer = &m_priority_buffer;
-          req_it = m_priority_buffer.begin();
-          req_it->command = m_dram->get_preq_command(req_it->final_command, req_it->addr_vec);
-          
-          request_found = m_dram->check_ready(req_it->command, req_it->addr_vec);
-          if (!request_found & m_priority_buffer.size() != 0) {
-            return false;
+      if (req_it->is_stat_updated == false) {
+        update_request_stats(req_it);
+      }
+      if (req_it->lifecycle_id >= 0) {
+        m_lifecycle.on_command(*req_it, m_clk, m_write_mode_cycles);
+      }
+      RAMULATOR_PROFILE_CALL(m_dram, issue_command(req_it->command, req_it->addr_vec));
+      m_data_bus.on_command(m_clk, m_dram->m_command_meta(req_it->command), is_write(*req_it));
+
+      // Writes that leave the write buffer no longer forward their data to reads
+      Addr_t addr = req_it->addr;
+      bool is_forwarding = (buffer == &m_write_buffer) && req_it->type_id == Request::Type::Write;
+      bool from_active_buffer = (buffer == &m_active_buffer);
+      int bank_id = flat_bank_id(req_it->addr_vec);
+
+      // If we are issuing the last command, set depart clock cycle and move the request to the pending queue
+      if (req_it->command == req_it->final_command) {
+        if (is_core_source(req_it->source_id)) {
+          if (req_it->type_id == Request::Type::Read) {
+            s_dram_reads_per_core[req_it->source_id]++;
+          } else {
+            s_dram_writes_per_core[req_it->source_id]++;
           }
         }
-
-        // 2.2.1    If no request to be scheduled in the priority buffer, check the read and write buffers.
-        if (!request_found) {
-          // Query the write policy to decide which buffer to serve
-          set_write_mode();
-          auto& buffer = m_is_write_mode ? m_write_buffer : m_read_buffer;
-          if (req_it = m_scheduler->get_best_request(buffer); req_it != buffer.end()) {
-            request_found = m_dram->check_ready(req_it->command, req_it->addr_vec);
-            req_buffer = &buffer;
+        if (req_it->type_id == Request::Type::Read) {
+          req_it->depart = m_clk + m_dram->m_read_latency;
+          if (m_dram->m_link_retry) {
+            // The data arrives after its link ECC and any replays of its burst
+            req_it->depart += m_dram->m_link_retry->last_delay(m_channel_id);
+          }
+          buffer->transfer(req_it, pending);
+          track_pending_depart();
+        } else {
+          if (is_write(*req_it)) {
+            m_write_drain.on_write_issued(*req_it);
+            s_write_latency += m_clk - req_it->arrive;
+            m_write_latency_histogram.record(m_clk - req_it->arrive);
           }
+          buffer->remove(req_it);
         }
-      }
-
-      // 2.3 If we find a request to schedule, we need to check if it will close an opened row in the active buffer.
-      if (request_found) {
-        if (m_dram->m_command_meta(req_it->command).is_closing) {
-          auto& rowgroup = req_it->addr_vec;
-          for (auto _it = m_active_buffer.begin(); _it != m_active_buffer.end(); _it++) {
-            auto& _it_rowgroup = _it->addr_vec;
-            bool is_matching = true;
-            for (int i = 0; i < m_bank_addr_idx + 1 ; i++) {
-              if (_it_rowgroup[i] != rowgroup[i] && _it_rowgroup[i] != -1 && rowgroup[i] != -1) {
-                is_matching = false;
-                break;
-              }
-            }
-            if (is_matching) {
-              request_found = false;
-              break;
+        if (is_forwarding) {
+          m_write_addrs.erase(addr);
+        }
+        if (from_active_buffer) {
+          update_active_count(bank_id, -1);
+        }
+      } else {
+        if (m_dram->m_command_meta(req_it->command).is_opening) {
+          if (buffer->transfer(req_it, m_active_buffer) && !from_active_buffer) {
+            update_active_count(bank_id, 1);
+            if (is_forwarding) {
+              m_write_addrs.erase(addr);
             }
           }
         }
       }
+    };
 
-      return request_found;
-    }
+    /**
+     * @brief    Finds a request whose command goes on the row bus (or the column bus) and is ready in this cycle
+     * @details
+     * Called after a command was issued on the other bus. A waiting priority request (e.g., a refresh) still comes
+     * first: if it is not ready on this bus, no demand request is scheduled. Otherwise, the scheduler picks among the
+     * ready requests on this bus in the active buffer, then in the buffer of the current read/write mode.
+     * 
+     */
+    template <class SchedulerT>
+    bool schedule_request_on_bus(SchedulerT* scheduler, bool is_column_bus, ReqBuffer::iterator& req_it, ReqBuffer*& req_buffer) {
+      auto is_schedulable = [&](ReqBuffer::iterator it) {
+        it->command = m_dram->get_preq_command(it->final_command, it->addr_vec);
+        if (m_dram->m_command_meta(it->command).is_accessing != is_column_bus || !m_dram->check_ready(it->command, it->addr_vec)) {
+          return false;
+        }
+        return !m_dram->m_command_meta(it->command).is_closing || num_active_bank_requests(it->addr_vec) == 0;
+      };
+
+      if (m_priority_buffer.size() != 0) {
+        req_it = m_priority_buffer.begin();
+        req_buffer = &m_priority_buffer;
+        return is_schedulable(req_it);
+      }
+
+      for (ReqBuffer* buffer : {&m_active_buffer, is_write_mode() ? &m_write_buffer : &m_read_buffer}) {
+        ReqBuffer::iterator best = buffer->end();
+        for (auto it = buffer->begin(); it != buffer->end(); it++) {
+          if (is_schedulable(it)) {
+            best = (best == buffer->end()) ? it : scheduler->compare(best, it);
+          }
+        }
+        if (best != buffer->end()) {
+          req_it = best;
+          req_buffer = buffer;
+          return true;
+        }
+      }
+      return false;
+    };
 
     void finalize() override {
       s_avg_read_latency = (float) s_read_latency / (float) s_num_read_reqs;
+      s_avg_write_latency = m_write_latency_histogram.count() ? (float) s_write_latency / (float) m_write_latency_histogram.count() : 0.0f;
+      compute_latency_quantiles(m_read_latency_histogram, s_read_latency_quantiles);
+      compute_latency_quantiles(m_write_latency_histogram, s_write_latency_quantiles);
+      compute_latency_quantiles(m_forwarded_read_latency_histogram, s_forwarded_read_latency_quantiles);
 
       s_queue_len_avg = (float) s_queue_len / (float) m_clk;
       s_read_queue_len_avg = (float) s_read_queue_len / (float) m_clk;
       s_write_queue_len_avg = (float) s_write_queue_len / (float) m_clk;
       s_priority_queue_len_avg = (float) s_priority_queue_len / (float) m_clk;
 
+      // Bytes per request as the address mapper defines them, over the elapsed time
+      size_t tx_bytes = m_dram->m_internal_prefetch_size * m_dram->m_channel_width / 8;
+      double elapsed_ps = (double) m_clk * m_dram->m_timing_vals("tCK_ps");
+      for (size_t core_id = 0; core_id < m_num_cores; core_id++) {
+        size_t reads = s_dram_reads_per_core[core_id];
+        s_avg_read_latency_per_core[core_id] = reads ? (float) s_read_latency_per_core[core_id] / (float) reads : 0.0f;
+        s_read_slowdown_per_core[core_id] = s_avg_read_latency_per_core[core_id] / (float) m_dram->m_read_latency;
+        s_bandwidth_per_core[core_id] = elapsed_ps > 0 ? (float) ((reads + s_dram_writes_per_core[core_id]) * tx_bytes * 1e3 / elapsed_ps) : 0.0f;
+      }
+
+      // The channel bandwidth counts every burst, also of requests without a core (e.g., from plugins)
+      s_data_bus_utilization = m_clk ? (float) m_data_bus.s_cycles[DataBusMonitor::Busy] / (float) m_clk : 0.0f;
+      if (m_data_bus.get_burst_cycles() > 0) {
+        s_peak_bandwidth = (float) (tx_bytes * 1e3 / (m_data_bus.get_burst_cycles() * m_dram->m_timing_vals("tCK_ps")));
+      }
+      s_bandwidth = s_data_bus_utilization * s_peak_bandwidth;
+      s_bandwidth_efficiency = s_data_bus_utilization;
+
+      if (m_decoder.enabled()) {
+        size_t decoded_reads = m_decoder.s_fast_path_reads + m_decoder.s_slow_path_reads - m_decoder.size();
+        s_avg_decoder_latency = decoded_reads ? (float) m_decoder.s_added_latency / (float) decoded_reads : 0.0f;
+        s_decoder_latency_p99 = m_decoder.latency_quantile(0.99);
+        s_decoder_latency_p999 = m_decoder.latency_quantile(0.999);
+        s_decoder_occupancy = m_decoder.occupancy(m_clk);
+        s_decoder_queue_len_avg = (float) m_decoder.s_queue_len / (float) m_clk;
+      }
+
+      if (m_lifecycle.enabled()) {
+        compute_lifecycle_breakdown(m_lifecycle.s_reads, s_read_lifecycle);
+        compute_lifecycle_breakdown(m_lifecycle.s_writes, s_write_lifecycle);
+        m_lifecycle.close();
+      }
+
+      if (m_dual_issue) {
+        s_row_bus_utilization = (float) s_row_bus_commands / (float) m_clk;
+        s_column_bus_utilization = (float) s_column_bus_commands / (float) m_clk;
+      }
+
       return;
     }
 
@@ -0,0 +1,86 @@
+#ifndef RAMULATOR_CONTROLLER_LATENCY_HISTOGRAM_H
+#define RAMULATOR_CONTROLLER_LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+#include "base/type.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Log-bucketed (HDR-style) histogram of latencies in cycles.
+ *
+ * @details
+ * Latencies below 2^SUB_BUCKET_BITS get a bucket each. Above that, every power of two is split into
+ * 2^SUB_BUCKET_BITS linear sub-buckets, so a quantile is at most 1/32 above the exact value. Latencies of
+ * 2^MAX_BITS cycles and more share the last bucket. The counts live in a fixed array, so record() is a few
+ * integer operations and never allocates.
+ *
+ */
+class LatencyHistogram {
+  public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr int MAX_BITS = 32;
+    static constexpr size_t NUM_BUCKETS = size_t(MAX_BITS - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS;
+
+    void record(Clk_t latency) {
+      uint64_t value = std::min<uint64_t>(std::max<Clk_t>(latency, 0), (uint64_t(1) << MAX_BITS) - 1);
+      m_counts[bucket(value)]++;
+      m_count++;
+      m_max = std::max(m_max, (Clk_t) value);
+    };
+
+    size_t count() const { return m_count; };
+    Clk_t max() const { return m_max; };
+
+    /**
+     * @brief    The q-quantile (e.g., 0.99): the highest latency of the bucket holding it, capped at the maximum.
+     *
+     */
+    Clk_t quantile(double q) const {
+      if (m_count == 0) {
+        return 0;
+      }
+      size_t rank = std::max<size_t>((size_t) std::ceil(q * m_count), 1);
+      size_t seen = 0;
+      for (size_t idx = 0; idx < NUM_BUCKETS; idx++) {
+        seen += m_counts[idx];
+        if (seen >= rank) {
+          return std::min(bucket_high(idx), m_max);
+        }
+      }
+      return m_max;
+    };
+
+  private:
+    static constexpr uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BUCKET_BITS;
+
+    std::array<uint64_t, NUM_BUCKETS> m_counts {};
+    size_t m_count = 0;
+    Clk_t m_max = 0;
+
+    static size_t bucket(uint64_t value) {
+      if (value < SUB_BUCKETS) {
+        return value;
+      }
+      int shift = std::bit_width(value) - 1 - SUB_BUCKET_BITS;
+      return (size_t(shift + 1) << SUB_BUCKET_BITS) + ((value >> shift) - SUB_BUCKETS);
+    };
+
+    static Clk_t bucket_high(size_t idx) {
+      if (idx < SUB_BUCKETS) {
+        return idx;
+      }
+      int shift = (idx >> SUB_BUCKET_BITS) - 1;
+      uint64_t mantissa = SUB_BUCKETS + (idx & (SUB_BUCKETS - 1));
+      return (Clk_t) (((mantissa + 1) << shift) - 1);
+    };
+};
+
+}        // namespace Ramulator
+
+#endif   // RAMULATOR_CONTROLLER_LATENCY_HISTOGRAM_H
@@ -1,5 +1,4 @@
 #include <vector>
-#include <unordered_map>
 #include <limits>
 #include <random>
 
@@ -9,6 +8,7 @@
 #include "translation/translation.h"
 #include "addr_mapper/impl/rit.h"
 #include "dram_controller/impl/plugin/device_config/device_config.h"
+#include "dram_controller/impl/plugin/row_count_table.h"
 
 namespace Ramulator {
 
@@ -50,20 +50,23 @@ class AQUA : public IControllerPlugin, public Implementation {
     // indexed using flattened <rank id, bank id>
     // e.g., if rank 0, bank 4, index is 4
     // if rank 1, bank 5, index is 16 (assuming 16 banks/rank) + 5
-    std::vector<std::unordered_map<int, int>> m_aggressor_row_tracker;
+    std::vector<RowCountTable> m_aggressor_row_tracker;
     // spillover counter per bank
     std::vector<int> m_spillover_counter;
     // per bank row indirection table is implemented in 'src/addr_mapper/impl/linear_mappers_with_rit.cpp'
 
-    std::vector<std::unordered_map<int, int>> m_reverse_pointer_table;
+    // per bank, the original row of each quarantine row, or -1
+    std::vector<std::vector<int>> m_reverse_pointer_table;
 
     // rng
-    std::mt19937 generator;
+    RandomStream generator;
     std::uniform_int_distribution<int> distribution;
 
     // statistics
     int s_num_migrations = 0;
     int s_num_r_migrations = 0;
+    size_t s_art_bytes = 0;
+    size_t s_rpt_bytes = 0;
 
   public:
     void init() override { 
@@ -102,11 +105,11 @@ class AQUA : public IControllerPlugin, public Implementation {
 
       // Initialize hot-row tracker
       for (int i = 0; i < m_num_banks_per_rank * m_num_ranks; i++) {
-        std::unordered_map<int, int> table;
-        m_aggressor_row_tracker.push_back(table);
+        m_aggressor_row_tracker.emplace_back(m_num_art_entries, m_num_rows_per_bank);
+        s_art_bytes += m_aggressor_row_tracker.back().footprint_bytes();
 
-        std::unordered_map<int, int> rpt;
-        m_reverse_pointer_table.push_back(rpt);
+        m_reverse_pointer_table.emplace_back(m_num_qrows_per_bank, -1);
+        s_rpt_bytes += m_num_qrows_per_bank * sizeof(int);
       }
       // Initialize spillover counter
       m_spillover_counter = std::vector<int>(m_num_banks_per_rank * m_num_ranks, 0);
@@ -116,14 +119,16 @@ class AQUA : public IControllerPlugin, public Implementation {
       reserve_rows_for_aqua();
       
       // setup random number generator
-      generator = std::mt19937(1337);
+      generator = random_stream(1337);
       distribution = std::uniform_int_distribution<int>(0, m_num_rows_per_bank-1);
 
       // Register statistics
       register_stat(s_num_migrations).name("aqua_migrations");
       register_stat(s_num_r_migrations).name("aqua_r_migrations");
+      register_stat(s_art_bytes).name("aqua_art_bytes");
+      register_stat(s_rpt_bytes).name("aqua_rpt_bytes");
 
-      if (m_is_debug) {
+      RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
         std::cout << "AQUA is implemented." << std::endl
                   << "ART size: " << m_num_art_entries << std::endl
                   << "FPT size: " << m_num_fpt_entries << std::endl
@@ -134,11 +139,15 @@ class AQUA : public IControllerPlugin, public Implementation {
       }
     }
 
+    // The ART and the RPT
+    size_t memory_footprint() const override { return s_art_bytes + s_rpt_bytes; };
+
     void update(bool request_found, ReqBuffer::iterator& req_it) override {
       // Tick myself
-      m_clk++;
+      bool is_new = is_new_cycle(request_found);
+      m_clk += is_new;
 
-      if (m_clk % m_reset_period_clk == 0) {
+      if (is_new && m_clk % m_reset_period_clk == 0) {
         // Reset hrt and unlock rit
         for (int i = 0; i < m_num_banks_per_rank * m_num_ranks; i++) {
           m_aggressor_row_tracker[i].clear();
@@ -148,69 +157,61 @@ class AQUA : public IControllerPlugin, public Implementation {
       }
 
       if (request_found) {
-        if (m_dram->m_command_meta(req_it->command).is_opening && m_dram->m_command_scopes(req_it->command) == m_row_level) {
-          int flat_bank_id = req_it->addr_vec[m_bank_level];
-          int accumulated_dimension = 1;
-          for (int i = m_bank_level - 1; i >= m_rank_level; i--) {
-            accumulated_dimension *= m_dram->m_organization.count[i + 1];
-            flat_bank_id += req_it->addr_vec[i] * accumulated_dimension;
-          }
+        if (m_ctrl->m_command_event.is_activation) {
+          int flat_bank_id = m_ctrl->m_command_event.flat_bank;
           
-          int row_id = req_it->addr_vec[m_row_level];
+          int row_id = m_ctrl->m_command_event.row;
 
-          if (m_is_debug) {
+          RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
             std::cout << "----------------------------" << std::endl;
             std::cout << "AQUA: ACT on row " << row_id << "         " << m_clk << std::endl;
             std::cout << "  └  " << "bank: " << flat_bank_id << std::endl;
           }
 
+          RowCountTable& art = m_aggressor_row_tracker[flat_bank_id];
+          std::vector<int>& rpt = m_reverse_pointer_table[flat_bank_id];
           // Check HRT
-          if (m_aggressor_row_tracker[flat_bank_id].find(row_id) == m_aggressor_row_tracker[flat_bank_id].end()) {
-            if (m_is_debug) {
+          int art_entry = art.find(row_id);
+          if (art_entry == -1) {
+            RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
               std::cout << "  └  " << "row " << row_id << " not in HRT." << std::endl;
             }
             // if row is not in the table, check if the table is full 
-            if (m_aggressor_row_tracker[flat_bank_id].size() < m_num_art_entries) {
-              if (m_is_debug) {
+            if (!art.is_full()) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "  └  " << "HRT is not full, inserting with count 1." << std::endl;
               }
               // if table is not full, insert the row
-              m_aggressor_row_tracker[flat_bank_id][row_id] = 1;
+              art_entry = art.insert(row_id, 1);
             } else {
-              if (m_is_debug) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "  └  " << "HRT is full, searching for a row to evict." << std::endl;
               }
               // if table is full, find a row to evict
-              bool found = false;
               int to_remove = -1;
-              int spillover_value = -1;
-
-              for (auto it = m_aggressor_row_tracker[flat_bank_id].begin(); it != m_aggressor_row_tracker[flat_bank_id].end(); it++) {
+              for (int i = 0; i < art.size(); i++) {
                 // if we find an entry with spillover counter value, evict it
-                if (it->second == m_spillover_counter[flat_bank_id]) {
-                  if (m_is_debug) {
-                    std::cout << "  └  " << "found a row to evict: " << it->first << std::endl;
+                if (art.entry(i).count == m_spillover_counter[flat_bank_id]) {
+                  RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
+                    std::cout << "  └  " << "found a row to evict: " << art.entry(i).row << std::endl;
                   }
-                  // if we find an entry, record it
-                  spillover_value = it->second;
-                  to_remove = it->first;
-                  found = true;
+                  to_remove = i;
                   break;
                 }
               }
 
-              if (found) {
-                if (m_is_debug) {
-                  std::cout << "Removing row " << to_remove << " from HRT." << std::endl;
+              if (to_remove != -1) {
+                RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
+                  std::cout << "Removing row " << art.entry(to_remove).row << " from HRT." << std::endl;
                   std::cout << "Adding row " << row_id << " to HRT." << std::endl;
                 }
-                // remove to_remove from the table
-                m_aggressor_row_tracker[flat_bank_id].erase(to_remove);
-                // add row_id to the table
-                m_aggressor_row_tracker[flat_bank_id][row_id] = spillover_value + 1;
+                // replace to_remove with row_id in the table
+                int spillover_value = art.entry(to_remove).count;
+                art.erase(to_remove);
+                art_entry = art.insert(row_id, spillover_value + 1);
               }
               else {
-                if (m_is_debug) {
+                RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                   std::cout << "  └  " << "no row to evict, incrementing spillover counter." << std::endl;
                 }
                 m_spillover_counter[flat_bank_id] += 1;
@@ -218,11 +219,11 @@ class AQUA : public IControllerPlugin, public Implementation {
               }
             }
           } else {
-            if (m_is_debug) { 
+            RAMULATOR_TRACE_IF(Plugin, m_is_debug) { 
               std::cout << "  └  " << "row " << row_id << " in HRT. Incrementing its counter." << std::endl;
             }
             // if row in table, increment its activation count
-            m_aggressor_row_tracker[flat_bank_id][row_id] += 1;
+            art.entry(art_entry).count += 1;
           }
           // dump HRT for debug
           // if (m_is_debug) {
@@ -236,29 +237,29 @@ class AQUA : public IControllerPlugin, public Implementation {
           // }
 
           // row is now in the table, check if the count exceeds the threshold
-          if (m_is_debug) {
+          RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
             std::cout << "Row " << row_id << " in ART" << std::endl;
             std::cout << "  └  " << "threshold: " << m_art_threshold << std::endl;
-            std::cout << "  └  " << "count: " << m_aggressor_row_tracker[flat_bank_id][row_id] << std::endl;
+            std::cout << "  └  " << "count: " << art.entry(art_entry).count << std::endl;
           }
-          if (m_aggressor_row_tracker[flat_bank_id][row_id] % m_art_threshold == 0) {
-            if (m_is_debug) {
+          if (art.entry(art_entry).count % m_art_threshold == 0) {
+            RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
               std::cout << "Row " << row_id << " needs quarantine!" << std::endl;
               std::cout << "  └  " << "RQA head: " << m_rqa_head << std::endl;
             }
             // issue migration
 
             // check if the rqa head is already stores another row
-            if (m_reverse_pointer_table[flat_bank_id].find(m_rqa_head) != m_reverse_pointer_table[flat_bank_id].end()) {
+            if (rpt[m_rqa_head] != -1) {
               // head is valid, it is from the previous epoch (guaranteed by AQUA)
               // evict it than issue the new migration
-              if (m_is_debug) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "RQA head is valid, evicting row " << m_rqa_head << std::endl;
               }
               int prev_q_row = m_rqa_head;
-              int prev_org_row = m_reverse_pointer_table[flat_bank_id][m_rqa_head];
+              int prev_org_row = rpt[m_rqa_head];
               // remove the entry from the RPT
-              m_reverse_pointer_table[flat_bank_id].erase(m_rqa_head);
+              rpt[m_rqa_head] = -1;
               // remove from FPT
               m_addr_mapper->rit_remove_entry(flat_bank_id, prev_q_row, prev_org_row);
 
@@ -267,7 +268,7 @@ class AQUA : public IControllerPlugin, public Implementation {
               s_num_r_migrations++;
             } else {
               // quarantine row is empty, issue migration
-              if (m_is_debug) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "RQA head is empty, issuing migration." << std::endl;
               }
             }
@@ -275,19 +276,19 @@ class AQUA : public IControllerPlugin, public Implementation {
             issue_migration(req_it, row_id, m_rqa_head);
 
             // update RPT and FPT
-            if (row_id < m_num_qrows_per_bank){ // row is migrated in this epoch
+            if (row_id < m_num_qrows_per_bank && rpt[row_id] != -1){ // row is migrated in this epoch
               // find the original row id
-              int org_row_id = m_reverse_pointer_table[flat_bank_id][row_id];
+              int org_row_id = rpt[row_id];
               // remove the entry from the RPT and FPT
-              m_reverse_pointer_table[flat_bank_id].erase(row_id);
+              rpt[row_id] = -1;
               m_addr_mapper->rit_remove_entry(flat_bank_id, row_id, org_row_id);
               // insert the entry into the RPT and FPT
-              m_reverse_pointer_table[flat_bank_id][m_rqa_head] = org_row_id;
+              rpt[m_rqa_head] = org_row_id;
               m_addr_mapper->rit_insert_entry(flat_bank_id, m_rqa_head, org_row_id);
             }
             else{ // row is not migrated in this epoch
               // insert the entry into the RPT and FPT
-              m_reverse_pointer_table[flat_bank_id][m_rqa_head] = row_id;
+              rpt[m_rqa_head] = row_id;
               m_addr_mapper->rit_insert_entry(flat_bank_id, row_id, m_rqa_head);
             }
             
@@ -301,7 +302,7 @@ class AQUA : public IControllerPlugin, public Implementation {
 
     void issue_migration(ReqBuffer::iterator& req_it, int src_row, int dst_row) {
       // load addr_vec
-      std::vector<int> addr_vec;
+      AddrVec_t addr_vec;
       for (int i = 0; i < req_it->addr_vec.size(); i++){
         addr_vec.push_back(req_it->addr_vec[i]);
       }
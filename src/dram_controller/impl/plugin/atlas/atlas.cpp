@@ -0,0 +1,122 @@
+#include "base/base.h"
+#include "dram_controller/controller.h"
+#include "dram_controller/plugin.h"
+#include "frontend/frontend.h"
+#include "dram_controller/impl/plugin/atlas/atlas.h"
+
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+namespace Ramulator {
+
+/**
+ * @brief    Attained-service bookkeeping of ATLAS (Kim et al., HPCA 2010) for the ATLAS scheduler.
+ *
+ * @details
+ * The service a source attains in a quantum is the number of commands the controller issues for its requests.
+ * At the end of every quantum, the total attained service of each source becomes
+ * alpha * total + (1 - alpha) * service of the quantum, and sources are ranked by it, least attained first.
+ * Ranks are kept per channel.
+ *
+ */
+class ATLAS : public IControllerPlugin, public Implementation, public IATLAS {
+    RAMULATOR_REGISTER_IMPLEMENTATION(IControllerPlugin, ATLAS, "ATLAS", "ATLAS least-attained-service ranking.")
+
+private:
+    Clk_t m_clk = 0;
+
+    Clk_t m_quantum = -1;
+    double m_alpha = 0.0;
+    Clk_t m_starvation_threshold = -1;
+
+    std::vector<size_t> m_quantum_service;    // Commands issued per source in the running quantum
+    std::vector<double> m_total_service;      // Exponentially averaged attained service per source
+    std::vector<int> m_ranks;
+
+    size_t s_num_quanta = 0;
+    std::vector<size_t> s_attained_service_per_core;
+
+public:
+    void init() override {
+        m_quantum = param<Clk_t>("quantum").desc("Cycles between two rankings.").default_val(1000000);
+        m_alpha = param<double>("alpha").desc("Weight of the past quanta in the attained service.").default_val(0.875);
+        m_starvation_threshold = param<Clk_t>("starvation_threshold").desc("Cycles after which a request goes ahead of the ranking.").default_val(100000);
+
+        if (m_quantum <= 0) {
+            throw ConfigurationError("ATLAS: quantum must be positive!");
+        }
+        if (m_alpha < 0.0 || m_alpha >= 1.0) {
+            throw ConfigurationError("ATLAS: alpha must be in [0, 1)!");
+        }
+    }
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+        m_ctrl = cast_parent<IDRAMController>();
+
+        size_t num_cores = frontend->get_num_cores();
+        m_quantum_service.resize(num_cores, 0);
+        m_total_service.resize(num_cores, 0.0);
+        m_ranks.resize(num_cores, 0);
+        s_attained_service_per_core.resize(num_cores, 0);
+
+        register_stat(s_num_quanta).name("atlas_num_quanta");
+        for (size_t core_id = 0; core_id < num_cores; core_id++) {
+            register_stat(s_attained_service_per_core[core_id]).name("atlas_attained_service_core_{}", core_id);
+        }
+    }
+
+    void update(bool request_found, ReqBuffer::iterator& req_it) override {
+        bool is_new = is_new_cycle(request_found);
+        m_clk += is_new;
+
+        if (request_found && req_it->source_id >= 0 && req_it->source_id < (int) m_quantum_service.size()) {
+            m_quantum_service[req_it->source_id]++;
+            s_attained_service_per_core[req_it->source_id]++;
+        }
+
+        if (is_new && m_clk % m_quantum == 0) {
+            rank_sources();
+        }
+    }
+
+    Clk_t get_idle_cycles() override {
+        // Nothing but the clock changes until the end of the quantum
+        return m_quantum - m_clk % m_quantum - 1;
+    }
+
+    void skip_cycles(Clk_t num_cycles) override {
+        m_clk += num_cycles;
+    }
+
+    int get_rank(int source_id) override {
+        if (source_id < 0 || source_id >= (int) m_ranks.size()) {
+            return 0;
+        }
+        return m_ranks[source_id];
+    }
+
+    bool is_starving(const Request& req) override {
+        return m_clk - req.arrive > m_starvation_threshold;
+    }
+
+private:
+    void rank_sources() {
+        s_num_quanta++;
+
+        size_t num_sources = m_total_service.size();
+        for (size_t i = 0; i < num_sources; i++) {
+            m_total_service[i] = m_alpha * m_total_service[i] + (1.0 - m_alpha) * m_quantum_service[i];
+            m_quantum_service[i] = 0;
+        }
+
+        std::vector<int> order(num_sources);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return m_total_service[a] < m_total_service[b]; });
+        for (size_t rank = 0; rank < num_sources; rank++) {
+            m_ranks[order[rank]] = rank;
+        }
+    }
+};      // class ATLAS
+
+}       // namespace Ramulator
@@ -0,0 +1,18 @@
+#ifndef RAMULATOR_PLUGIN_ATLAS_H_
+#define RAMULATOR_PLUGIN_ATLAS_H_
+
+#include "base/request.h"
+
+namespace Ramulator {
+
+class IATLAS {
+public:
+    // Least-attained-service rank of the source (0 = served least, highest priority). Requests without a source get 0
+    virtual int get_rank(int source_id) = 0;
+    // Whether the request has waited longer than the starvation threshold
+    virtual bool is_starving(const Request& req) = 0;
+};
+
+}
+
+#endif  // RAMULATOR_PLUGIN_ATLAS_H_
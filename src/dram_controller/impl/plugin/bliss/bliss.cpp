@@ -16,7 +16,6 @@ class BLISS : public IControllerPlugin, public Implementation, public IBLISS {
 
 private:
     DeviceConfig m_cfg;
-    std::vector<bool> m_blacklist_info;
 
     int m_prev_src_id = -1;
     int m_consequtive_src_id = -1;
@@ -40,7 +39,9 @@ public:
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
         m_cfg.set_device(cast_parent<IDRAMController>());
 
-        m_blacklist_info.resize(frontend->get_num_cores());
+        size_t num_words = (frontend->get_num_cores() + 63) / 64;
+        m_blacklist_words.resize(num_words, 0);
+        m_blacklist_stamps.resize(num_words, 0);
 
         m_consequtive_src_id = 0;
 
@@ -51,12 +52,12 @@ public:
     }
 
     void update(bool request_found, ReqBuffer::iterator& req_it) override {
-        m_clk++;
+        bool is_new = is_new_cycle(request_found);
+        m_clk += is_new;
 
-        if (m_clk % m_unblacklist_cycles == 0) {
-            for (int i = 0; i < m_blacklist_info.size(); i++) {
-                m_blacklist_info[i] = false;
-            }
+        if (is_new && m_clk % m_unblacklist_cycles == 0) {
+            // The words of the previous interval become stale
+            m_blacklist_interval++;
         }
 
         if (!request_found) {
@@ -81,13 +82,19 @@ public:
         // s_blacklist_count += (m_consequtive_src_id >= m_blacklist_thresh);
 
         if (m_consequtive_src_id >= m_blacklist_thresh) {
-            m_blacklist_info[req_it->source_id] = true;
+            blacklist(req_it->source_id);
             s_blacklist_count++;
         }
     }
 
-    virtual bool is_blacklisted(int source_id) override {
-        return source_id < 0 || m_blacklist_info[source_id];
+private:
+    void blacklist(int source_id) {
+        int word = source_id >> 6;
+        if (m_blacklist_stamps[word] != m_blacklist_interval) {
+            m_blacklist_stamps[word] = m_blacklist_interval;
+            m_blacklist_words[word] = 0;
+        }
+        m_blacklist_words[word] |= uint64_t(1) << (source_id & 63);
     }
 };      // class BLISS
 
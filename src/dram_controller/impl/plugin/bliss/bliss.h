@@ -1,13 +1,35 @@
 #ifndef RAMULATOR_PLUGIN_BLISS_H_
 #define RAMULATOR_PLUGIN_BLISS_H_
 
+#include <vector>
+#include <cstdint>
+
 namespace Ramulator {
 
+/**
+ * @brief    The blacklist of the BLISS plugin, packed one bit per source.
+ * @details
+ * Every word of 64 sources is stamped with the clearing interval it was written in, so clearing the blacklist only
+ * starts a new interval, and a word from a past interval reads as empty.
+ *
+ */
 class IBLISS {
+protected:
+    std::vector<uint64_t> m_blacklist_words;
+    std::vector<uint64_t> m_blacklist_stamps;   // Interval each word was last written in
+    uint64_t m_blacklist_interval = 0;
+
 public:
-    virtual bool is_blacklisted(int source_id) = 0;
+    /// The blacklist bits of sources 64 * word to 64 * word + 63
+    uint64_t get_blacklist_word(int word) const {
+        return m_blacklist_stamps[word] == m_blacklist_interval ? m_blacklist_words[word] : 0;
+    }
+
+    bool is_blacklisted(int source_id) const {
+        return source_id < 0 || (get_blacklist_word(source_id >> 6) & (uint64_t(1) << (source_id & 63)));
+    }
 };
 
 }
 
-#endif  // RAMULATOR_PLUGIN_BLISS_H_ 
\ No newline at end of file
+#endif  // RAMULATOR_PLUGIN_BLISS_H_ 
@@ -76,22 +76,16 @@ class BlockHammer : public IControllerPlugin, public Implementation, public IBlo
     bool m_is_debug;
 
     BaseFilter* get_bank_filter(Request& req) {
-      int flat_bank_id = req.addr_vec[m_bank_level];
-      int accumulated_dimension = 1;
-      for (int i = m_bank_level - 1; i >= m_rank_level; i--) {
-        accumulated_dimension *= m_dram->m_organization.count[i + 1];
-        flat_bank_id += req.addr_vec[i] * accumulated_dimension;
-      }
-      return m_filters[flat_bank_id];
+      return m_filters[m_dram->flat_bank_id(req.addr_vec)];
     }
   
   public:
     void init() override {
       m_bf_num_filters = param<int>("bf_num_filters").default_val(2);
       m_bf_len_epoch = param<int>("bf_len_epoch").default_val(64000000);
-      m_bf_ctr_count = param<int>("bf_ctr_count").default_val(1024);
+      m_bf_ctr_count = param<int>("bf_ctr_count").desc("Counters per bloom filter (a power of two).").default_val(1024);
       m_bf_ctr_thresh = param<int>("bf_ctr_thresh").default_val(128);
-      m_bf_ctr_saturate = param<bool>("bf_ctr_saturate").default_val(false);
+      m_bf_ctr_saturate = param<bool>("bf_ctr_saturate").desc("Kept for compatibility: the counters always stop at bf_ctr_thresh, which gives the same results.").default_val(false);
       m_bf_num_hashes = param<int>("bf_num_hashes").default_val(4);
       m_bf_num_rh = param<int>("bf_num_rh").default_val(16384);
       m_bf_trefw = param<int>("bf_trefw").default_val(64000000);
@@ -132,23 +126,14 @@ class BlockHammer : public IControllerPlugin, public Implementation, public IBlo
         exit(0);
       }
 
-      auto* hash_functions = new std::vector<bloom_hash_fn>();
-      uint32_t size = m_bf_ctr_count;
-      for (int i = 0; i < m_bf_num_hashes; i++)  {
-        hash_functions->push_back([i, size](uint32_t key) {
-          uint32_t hash1 = key * 2654435761;
-          uint32_t hash2 = hash1 + i * ((key * 2246822519 % (size - 1)) + 1);
-          return hash2;
-        });
-      }
+      auto* hash = new BloomHash(m_bf_ctr_count, m_bf_num_hashes);
 
       // TODO: These pointers are currently never deleted.
       for (int i = 0; i < m_num_ranks * m_num_banks_per_rank; i++) {
         auto* sub_filters = new std::vector<SubFilter*>();
         for (int j = 0; j < m_bf_num_filters; j++) {
           sub_filters->push_back(new SubFilter(
-            m_bf_ctr_count, m_bf_ctr_thresh,
-            m_bf_ctr_saturate, *hash_functions
+            m_bf_ctr_count, m_bf_ctr_thresh, *hash
           ));
         }
         m_filters.push_back(new BaseFilter(*sub_filters, m_bf_len_epoch_clk, m_llc));
@@ -158,13 +143,13 @@ class BlockHammer : public IControllerPlugin, public Implementation, public IBlo
       m_filters[m_num_ranks * m_num_banks_per_rank - 1]->reset();
 
       for (int i = 0; i < m_num_ranks; i++) {
-        m_histbufs.push_back(new HistoryBuffer<elem_t>(m_bf_hist_size, m_bf_hist_max_freq));
+        m_histbufs.push_back(new HistoryBuffer<elem_t>(m_bf_hist_size, m_bf_hist_max_freq, m_num_rows_per_bank));
       }
 
       m_attack_throttler = new AttackThrottler(m_llc, m_bf_num_rh, m_bf_ctr_thresh, m_bf_len_epoch_clk,
                                                 m_bf_trefw, m_bf_num_filters);
 
-      if (m_is_debug) {
+      RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
         std::cout << "------------------------------------" << std::endl
                   << "BlockHammer: Initialized" << std::endl;
         std::cout << "num_ranks:                  " << m_num_ranks << std::endl;
@@ -186,43 +171,38 @@ class BlockHammer : public IControllerPlugin, public Implementation, public IBlo
     }
 
     void update(bool request_found, ReqBuffer::iterator& req_it) override {
-      m_clk++;
+      if (is_new_cycle(request_found)) {
+        m_clk++;
 
-      for (int i = 0; i < m_num_ranks; i++) {
-        m_histbufs[i]->update();
-      }
-      for (int i = 0; i < m_num_ranks * m_num_banks_per_rank; i++) {
-        m_filters[i]->update();
+        for (int i = 0; i < m_num_ranks; i++) {
+          m_histbufs[i]->update();
+        }
+        for (int i = 0; i < m_num_ranks * m_num_banks_per_rank; i++) {
+          m_filters[i]->update();
+        }
+        m_attack_throttler->update();
       }
-      m_attack_throttler->update();
 
       // Nothing to do if we don't have a request.
       if (!request_found) {
         return;
       }
 
-      bool is_opening = m_dram->m_command_meta(req_it->command).is_opening;
-      bool is_row = m_dram->m_command_scopes(req_it->command) == m_row_level; 
+      const CommandEvent& event = m_ctrl->m_command_event;
 
       // Nothing to do if the request isn't activating a row.
-      if (!is_opening || !is_row) {
+      if (!event.is_activation) {
         return;
       }
 
       // Update bloom filters and history buffer.
-      auto rank_idx = req_it->addr_vec[m_rank_level];
-      auto row_addr = req_it->addr_vec[m_row_level];
-      m_histbufs[rank_idx]->insert(row_addr);
-      auto* filter = get_bank_filter(*req_it);
+      auto row_addr = event.row;
+      m_histbufs[event.flat_rank]->insert(row_addr);
+      auto* filter = m_filters[event.flat_bank];
       filter->insert(row_addr);
 
       // Update AttackThrottler and Bank Activation Counts
-      int flat_bank_id = req_it->addr_vec[m_bank_level];
-      int accumulated_dimension = 1;
-      for (int i = m_bank_level - 1; i >= m_rank_level; i--) {
-        accumulated_dimension *= m_dram->m_organization.count[i + 1];
-        flat_bank_id += req_it->addr_vec[i] * accumulated_dimension;
-      }
+      int flat_bank_id = event.flat_bank;
       
       if (filter->test(row_addr)) {
         if (req_it->source_id >= 0) {
@@ -1,12 +1,59 @@
 #ifndef RAMULATOR_PLUGIN_BLOCKHAMMER_FILTER_
 #define RAMULATOR_PLUGIN_BLOCKHAMMER_FILTER_
 
-#include <functional>
+#include <array>
+#include <vector>
 #include <cstdint>
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include "base/exception.h"
 
 namespace Ramulator {
 
-typedef std::function<uint32_t(uint32_t)> bloom_hash_fn;
+/**
+ * @brief    The k hashes of a bloom filter of a power-of-two size, as multiply-shift hashes
+ * @details
+ * Hash i multiplies the element by its own odd constant and keeps the top bits of the 32-bit product. The hashes are
+ * computed over a fixed-size array in one loop without calls, which the compiler vectorizes.
+ *
+ */
+class BloomHash {
+public:
+  static constexpr int MAX_HASHES = 8;
+  using Indices = std::array<uint32_t, MAX_HASHES>;
+
+  BloomHash(int num_counters, int num_hashes) : m_num_hashes(num_hashes) {
+    if (num_counters < 2 || (num_counters & (num_counters - 1)) != 0) {
+      throw ConfigurationError("Bloom filters need a power-of-two number of counters, got {}!", num_counters);
+    }
+    if (num_hashes <= 0 || num_hashes > MAX_HASHES) {
+      throw ConfigurationError("Bloom filters support 1 to {} hashes, got {}!", MAX_HASHES, num_hashes);
+    }
+    m_shift = 32 - std::countr_zero(uint32_t(num_counters));
+    // Odd multipliers from the golden ratio sequence
+    uint32_t multiplier = 2654435761u;
+    for (int i = 0; i < MAX_HASHES; i++) {
+      m_multipliers[i] = multiplier | 1;
+      multiplier += 0x9E3779B9u;
+    }
+  }
+
+  int num_hashes() const { return m_num_hashes; }
+
+  // Computes all hashes of elem; only the first num_hashes() are meaningful
+  void indices(uint32_t elem, Indices& idx) const {
+    for (int i = 0; i < MAX_HASHES; i++) {
+      idx[i] = (elem * m_multipliers[i]) >> m_shift;
+    }
+  }
+
+private:
+  int m_num_hashes;
+  int m_shift;
+  std::array<uint32_t, MAX_HASHES> m_multipliers;
+};      // class BloomHash
 
 template <typename elem_t>
 struct HistoryEntry {
@@ -22,51 +69,56 @@ public:
   virtual void reset() = 0;
 };      // class IBloomFilter
 
+// The counters saturate at the threshold: the test only compares them against it and they only grow until the
+// reset, so counting further never changes a result. The counters only need to hold the threshold, e.g., 8 bits for
+// thresholds up to 255.
 template <typename elem_t, typename ctr_t>
 class CountingBloomFilter : public IBloomFilter<elem_t> {
 public:
-  CountingBloomFilter(int num_counters, int ctr_thresh, bool saturate,
-        std::vector<bloom_hash_fn>& hash_functions) : m_hash_functions(hash_functions) {
-      // Initializers looks ugly here, opting for manual assignment
-      this->m_num_counters = num_counters;
-      this->m_ctr_thresh = ctr_thresh;
-      this->m_saturate = m_saturate;
-      m_counters.resize(m_num_counters);
+  CountingBloomFilter(int num_counters, int ctr_thresh, const BloomHash& hash) : m_hash(hash) {
+      if (ctr_thresh <= 0 || ctr_thresh > std::numeric_limits<ctr_t>::max()) {
+        throw ConfigurationError("Bloom filter counter threshold must be between 1 and {}, got {}!",
+                                 std::numeric_limits<ctr_t>::max(), ctr_thresh);
+      }
+      m_ctr_thresh = ctr_thresh;
+      m_counters.resize(num_counters);
       reset();
   }
 
-  ~CountingBloomFilter() {
-    m_counters.clear();
-  }
+  const BloomHash& hash() const { return m_hash; }
 
   virtual void insert(elem_t elem) override {
-    for (int i = 0; i < m_hash_functions.size(); i++) {
-      uint32_t idx = m_hash_functions[i](elem) % m_num_counters;
-      if (!m_saturate || m_counters[idx] < m_ctr_thresh) {
-        m_counters[idx]++;
-      }
+    typename BloomHash::Indices idx;
+    m_hash.indices(elem, idx);
+    insert(idx);
+  }
+
+  // Inserts the element with the precomputed hashes idx
+  void insert(const typename BloomHash::Indices& idx) {
+    for (int i = 0; i < m_hash.num_hashes(); i++) {
+      ctr_t& counter = m_counters[idx[i]];
+      counter += counter < m_ctr_thresh;
     }
   }
 
   virtual bool test(elem_t elem) override {
-    bool pass = true;
-    for (int i = 0; i < m_hash_functions.size(); i++) {
-      uint32_t idx = m_hash_functions[i](elem) % m_num_counters;
-      pass &= m_counters[idx] >= m_ctr_thresh;
+    typename BloomHash::Indices idx;
+    m_hash.indices(elem, idx);
+    ctr_t min_count = m_ctr_thresh;
+    for (int i = 0; i < m_hash.num_hashes(); i++) {
+      min_count = std::min(min_count, m_counters[idx[i]]);
     }
-    return pass;
+    return min_count >= m_ctr_thresh;
   }
 
   virtual void reset() override {
-    std::fill(m_counters.begin(), m_counters.end(), (ctr_t) 0);
+    std::fill(m_counters.begin(), m_counters.end(), 0);
   }
 
 private:
-  int m_num_counters;
-  int m_ctr_thresh;
-  bool m_saturate;
+  ctr_t m_ctr_thresh;
   std::vector<ctr_t> m_counters;
-  std::vector<bloom_hash_fn>& m_hash_functions;
+  const BloomHash& m_hash;
 };      // class CountingBloomFilter
 
 template <typename elem_t, class T>
@@ -94,8 +146,11 @@ public:
   }
 
   virtual void insert(elem_t elem) override {
+    // The filters share their hashes, so they are computed once
+    typename BloomHash::Indices idx;
+    m_filters[0]->hash().indices(elem, idx);
     for (T* filter : m_filters) {
-      filter->insert(elem);
+      filter->insert(idx);
     }
   }
 
@@ -117,24 +172,21 @@ private:
   BHO3LLC* m_llc;
 };      // class UnifiedBloomFilter
 
+// The last 'size' activations in a ring, with a count per element, so elements must be in [0, num_elems)
 template <typename elem_t>
 class HistoryBuffer {
 public:
   // Slight modification, we allow 'max_freq' activations within 'size' ticks
-  HistoryBuffer(uint32_t size, uint32_t max_freq) {
+  HistoryBuffer(uint32_t size, uint32_t max_freq, uint32_t num_elems) {
     this->m_size = size;
     this->m_max_freq = max_freq;
     this->m_tick = 0;
     history = std::vector<HistoryEntry<elem_t>>(size, {-1, (uint64_t) -1});
-  }
-
-  ~HistoryBuffer() {
-    history.clear();
-    elem_counter.clear();
+    elem_counter = std::vector<uint32_t>(num_elems, 0);
   }
 
   inline bool exists(elem_t elem) {
-    return elem_counter.find(elem) != elem_counter.end();
+    return elem >= 0 && elem_counter[elem] > 0;
   }
 
   inline bool exceeds(elem_t elem) {
@@ -147,9 +199,6 @@ public:
 
   void insert(elem_t elem) {
     history[m_tick % m_size] = {elem, m_tick};
-    if (!exists(elem)) {
-      elem_counter[elem] = 0;
-    }
     elem_counter[elem]++;
   }
 
@@ -159,9 +208,7 @@ public:
     if (!exists(elem)) {
       return;
     }
-    if (--elem_counter[elem] == 0) {
-      elem_counter.erase(elem);
-    }
+    elem_counter[elem]--;
   }
 
 private:
@@ -169,7 +216,7 @@ private:
   uint32_t m_size;
   uint32_t m_max_freq;
   std::vector<HistoryEntry<elem_t>> history;
-  std::unordered_map<elem_t, uint32_t> elem_counter;
+  std::vector<uint32_t> elem_counter;
 };      // class HistoryBuffer
 };  // namespace Ramulator
 
@@ -1,7 +1,5 @@
 #include <vector>
-#include <unordered_map>
 #include <limits>
-#include <random>
 #include <filesystem>
 #include <fstream>
 
@@ -18,7 +16,14 @@ class CommandCounter : public IControllerPlugin, public Implementation {
     IDRAM* m_dram = nullptr;
 
     std::vector<std::string> m_commands_to_count;
-    std::unordered_map<int, int> m_command_counters;
+    std::vector<int> m_command_slots;                   // Per command id, its index in m_commands_to_count or -1
+    std::vector<uint64_t> m_command_counters;           // Per counted command
+    std::vector<std::vector<uint64_t>> m_rank_counters; // Per counted command, per rank (if per_rank)
+    std::vector<std::vector<uint64_t>> m_bank_counters; // Per counted command, per flat bank (if per_bank)
+
+    bool m_per_rank = false;
+    bool m_per_bank = false;
+    bool m_register_stats = false;
 
     std::filesystem::path m_save_path; 
 
@@ -33,30 +38,94 @@ class CommandCounter : public IControllerPlugin, public Implementation {
       if (!(std::filesystem::exists(parent_path) && std::filesystem::is_directory(parent_path))) {
         throw ConfigurationError("Invalid path to trace file: {}", parent_path.string());
       }
+
+      m_per_rank = param<bool>("per_rank").desc("Also count the commands of each rank").default_val(false);
+      m_per_bank = param<bool>("per_bank").desc("Also count the commands of each bank (only those that address one bank)").default_val(false);
+      m_register_stats = param<bool>("register_stats").desc("Register the counts as statistics, e.g., for a StatsStream to record per epoch").default_val(false);
     };
 
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
       m_ctrl = cast_parent<IDRAMController>();
       m_dram = m_ctrl->m_dram;
 
-      for (const auto& command_name : m_commands_to_count) {
+      // The ranks and flat banks as numbered in the controller's command events
+      int rank_level = m_dram->m_levels.contains("rank") ? m_dram->m_levels("rank") : 1;
+      int bank_level = m_dram->m_levels("bank");
+      int num_ranks = m_dram->m_organization.count[rank_level];
+      int num_banks = 1;
+      for (int level = rank_level; level <= bank_level; level++) {
+        num_banks *= m_dram->m_organization.count[level];
+      }
+
+      m_command_slots.assign(m_dram->m_commands.size(), -1);
+      m_command_counters.assign(m_commands_to_count.size(), 0);
+      m_rank_counters.assign(m_commands_to_count.size(), std::vector<uint64_t>(m_per_rank ? num_ranks : 0, 0));
+      m_bank_counters.assign(m_commands_to_count.size(), std::vector<uint64_t>(m_per_bank ? num_banks : 0, 0));
+      for (int slot = 0; slot < m_commands_to_count.size(); slot++) {
+        const auto& command_name = m_commands_to_count[slot];
         if (!m_dram->m_commands.contains(command_name)) {
           throw ConfigurationError("Command {} does not exist in the DRAM standard {}!", command_name, m_dram->get_name());
         }
-        m_command_counters[m_dram->m_commands(command_name)] = 0;
+        if (m_command_slots[m_dram->m_commands(command_name)] != -1) {
+          throw ConfigurationError("Command {} is listed twice in commands_to_count!", command_name);
+        }
+        m_command_slots[m_dram->m_commands(command_name)] = slot;
+
+        if (m_register_stats) {
+          register_stat(m_command_counters[slot]).name("{}_count", command_name);
+          if (m_per_rank) {
+            register_stat(m_rank_counters[slot]).name("{}_count_per_rank", command_name);
+          }
+          if (m_per_bank) {
+            register_stat(m_bank_counters[slot]).name("{}_count_per_bank", command_name);
+          }
+        }
+      }
+
+      // Only the counted commands matter, nothing happens on the other cycles
+      m_subscription.per_cycle = false;
+      for (int command = 0; command < m_command_slots.size(); command++) {
+        if (m_command_slots[command] != -1) {
+          m_subscription.commands.push_back(command);
+        }
       }
     };
 
     void update(bool request_found, ReqBuffer::iterator& req_it) override {
       if (request_found) {
-        m_command_counters[req_it->command]++;
+        int slot = m_command_slots[req_it->command];
+        if (slot == -1) {
+          return;
+        }
+        m_command_counters[slot]++;
+
+        const CommandEvent& event = m_ctrl->m_command_event;
+        if (m_per_rank && event.flat_rank >= 0) {
+          m_rank_counters[slot][event.flat_rank]++;
+        }
+        if (m_per_bank && event.flat_bank >= 0) {
+          m_bank_counters[slot][event.flat_bank]++;
+        }
       }
     };
 
+    Clk_t get_idle_cycles() override {
+      return std::numeric_limits<Clk_t>::max();
+    };
+
     void finalize() override {
       std::ofstream output(m_save_path);
-      for (const auto& [cmd_id, count] : m_command_counters) {
-        output << fmt::format("{}, {}", m_dram->m_commands(cmd_id), count) << std::endl;
+      for (int slot = 0; slot < m_commands_to_count.size(); slot++) {
+        output << fmt::format("{}, {}", m_commands_to_count[slot], m_command_counters[slot]) << std::endl;
+      }
+      // The breakdowns follow as "<command>, rank <id>, <count>" and "<command>, bank <flat id>, <count>"
+      for (int slot = 0; slot < m_commands_to_count.size(); slot++) {
+        for (int rank = 0; rank < m_rank_counters[slot].size(); rank++) {
+          output << fmt::format("{}, rank {}, {}", m_commands_to_count[slot], rank, m_rank_counters[slot][rank]) << std::endl;
+        }
+        for (int bank = 0; bank < m_bank_counters[slot].size(); bank++) {
+          output << fmt::format("{}, bank {}, {}", m_commands_to_count[slot], bank, m_bank_counters[slot][bank]) << std::endl;
+        }
       }
       output.close();
     }
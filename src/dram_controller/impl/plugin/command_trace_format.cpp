@@ -0,0 +1,227 @@
+#include <cstring>
+
+#include "dram_controller/impl/plugin/command_trace_format.h"
+
+namespace Ramulator {
+
+namespace CommandTrace {
+
+namespace {
+
+constexpr size_t RECORD_HEAD_SIZE = 8;        // Clock delta, command, reserved
+constexpr uint32_t MAX_CLOCK_DELTA = UINT32_MAX;
+
+template<typename T>
+void put_le(uint8_t* dst, T value) {
+  for (size_t i = 0; i < sizeof(T); i++) {
+    dst[i] = uint8_t(uint64_t(value) >> (8 * i));
+  }
+}
+
+template<typename T>
+T get_le(const uint8_t* src) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < sizeof(T); i++) {
+    value |= uint64_t(src[i]) << (8 * i);
+  }
+  return T(value);
+}
+
+}        // namespace
+
+
+bool is_command_trace(const std::string& path) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  char magic[sizeof(MAGIC)];
+  return file.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+
+Writer::Writer(const std::string& path, int levels, const std::vector<std::string>& command_names):
+m_path(path), m_file(path, std::ios::out | std::ios::binary | std::ios::trunc), m_levels(levels),
+m_record_size(RECORD_HEAD_SIZE + levels * sizeof(int32_t)) {
+  if (!m_file) {
+    throw ConfigurationError("Command trace {} cannot be opened for writing!", path);
+  }
+  if (levels <= 0 || levels > int(AddrVec_t::capacity())) {
+    throw ConfigurationError("Command trace address vectors must have 1 to {} levels (got {})!", AddrVec_t::capacity(), levels);
+  }
+  if (command_names.size() >= CLOCK_ADVANCE) {
+    throw ConfigurationError("Command traces hold at most {} commands (got {})!", CLOCK_ADVANCE, command_names.size());
+  }
+
+  // The record count is filled in by close()
+  uint8_t header[HEADER_SIZE] = {};
+  std::memcpy(header, MAGIC, sizeof(MAGIC));
+  put_le<uint16_t>(header + 4, VERSION);
+  header[6] = uint8_t(levels);
+  put_le<uint16_t>(header + 16, command_names.size());
+  m_file.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+  for (const std::string& name : command_names) {
+    m_file.write(name.c_str(), name.size() + 1);
+  }
+
+  for (auto& buffer : m_buffers) {
+    buffer.reserve(BUFFER_SIZE);
+  }
+  m_writer = std::thread([this] { write_buffers(); });
+}
+
+Writer::~Writer() {
+  try {
+    close();
+  } catch (...) {}
+}
+
+void Writer::record(Clk_t clk, int command, const AddrVec_t& addr_vec) {
+  if (addr_vec.size() > m_levels) {
+    throw ConfigurationError("Command trace address vectors have {} levels, not {}!", m_levels, addr_vec.size());
+  }
+  uint64_t delta = clk - m_prev_clk;
+  while (delta >= MAX_CLOCK_DELTA) {
+    put_record(MAX_CLOCK_DELTA, CLOCK_ADVANCE, nullptr);
+    delta -= MAX_CLOCK_DELTA;
+  }
+  put_record(delta, command, &addr_vec);
+  m_prev_clk = clk;
+}
+
+void Writer::put_record(uint32_t delta, uint16_t command, const AddrVec_t* addr_vec) {
+  std::vector<uint8_t>& buffer = m_buffers[m_buffer];
+  size_t offset = buffer.size();
+  buffer.resize(offset + m_record_size);
+  uint8_t* dst = buffer.data() + offset;
+  put_le<uint32_t>(dst, delta);
+  put_le<uint16_t>(dst + 4, command);
+  put_le<uint16_t>(dst + 6, 0);
+  for (int level = 0; level < m_levels; level++) {
+    int32_t addr = 0;
+    if (addr_vec) {
+      addr = level < addr_vec->size() ? (*addr_vec)[level] : -1;
+    }
+    put_le<int32_t>(dst + RECORD_HEAD_SIZE + level * sizeof(int32_t), addr);
+  }
+  m_num_records++;
+
+  if (buffer.size() + m_record_size > BUFFER_SIZE) {
+    hand_off();
+  }
+}
+
+void Writer::hand_off() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cv.wait(lock, [this] { return !m_pending; });
+  if (m_failed) {
+    throw ConfigurationError("Failed to write command trace {}!", m_path);
+  }
+  m_pending = true;
+  m_buffer ^= 1;
+  lock.unlock();
+  m_cv.notify_all();
+}
+
+void Writer::write_buffers() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cv.wait(lock, [this] { return m_pending || m_stop; });
+    if (!m_pending) {
+      return;
+    }
+    // The filling thread only touches the other buffer until this one is released
+    std::vector<uint8_t>& buffer = m_buffers[m_buffer ^ 1];
+    lock.unlock();
+    m_file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    buffer.clear();
+    lock.lock();
+    m_failed |= !m_file;
+    m_pending = false;
+    m_cv.notify_all();
+  }
+}
+
+void Writer::close() {
+  if (m_closed) {
+    return;
+  }
+  m_closed = true;
+  if (!m_buffers[m_buffer].empty()) {
+    hand_off();
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  m_writer.join();
+
+  uint8_t num_records[sizeof(uint64_t)];
+  put_le<uint64_t>(num_records, m_num_records);
+  m_file.seekp(8);
+  m_file.write(reinterpret_cast<const char*>(num_records), sizeof(num_records));
+  m_file.close();
+  if (m_failed || !m_file) {
+    throw ConfigurationError("Failed to write command trace {}!", m_path);
+  }
+}
+
+
+Reader::Reader(const std::string& path): m_path(path), m_file(path) {
+  const uint8_t* begin = reinterpret_cast<const uint8_t*>(m_file.begin());
+  const uint8_t* end = reinterpret_cast<const uint8_t*>(m_file.end());
+  if (m_file.size() < HEADER_SIZE || std::memcmp(begin, MAGIC, sizeof(MAGIC)) != 0) {
+    throw ConfigurationError("{} is not a command trace!", path);
+  }
+  uint16_t version = get_le<uint16_t>(begin + 4);
+  if (version != VERSION) {
+    throw ConfigurationError("Command trace {} has format version {}, expected {}!", path, version, VERSION);
+  }
+  m_levels = begin[6];
+  if (m_levels <= 0 || m_levels > int(AddrVec_t::capacity())) {
+    throw ConfigurationError("Command trace {} has address vectors of {} levels!", path, m_levels);
+  }
+  m_num_records = get_le<uint64_t>(begin + 8);
+  int num_names = get_le<uint16_t>(begin + 16);
+
+  m_cursor = begin + HEADER_SIZE;
+  for (int i = 0; i < num_names; i++) {
+    const uint8_t* name_end = static_cast<const uint8_t*>(std::memchr(m_cursor, '\0', end - m_cursor));
+    if (name_end == nullptr) {
+      throw ConfigurationError("Command trace {} is truncated!", path);
+    }
+    m_command_names.emplace_back(reinterpret_cast<const char*>(m_cursor), name_end - m_cursor);
+    m_cursor = name_end + 1;
+  }
+
+  m_record_size = RECORD_HEAD_SIZE + m_levels * sizeof(int32_t);
+  if (size_t(end - m_cursor) != m_num_records * m_record_size) {
+    throw ConfigurationError("Command trace {} should hold {} records, but has {} bytes of them!", path, m_num_records, end - m_cursor);
+  }
+}
+
+bool Reader::next(Record& record) {
+  const uint8_t* end = reinterpret_cast<const uint8_t*>(m_file.end());
+  while (m_cursor != end) {
+    const uint8_t* src = m_cursor;
+    m_cursor += m_record_size;
+    m_clk += get_le<uint32_t>(src);
+    uint16_t command = get_le<uint16_t>(src + 4);
+    if (command == CLOCK_ADVANCE) {
+      continue;
+    }
+    if (command >= m_command_names.size()) {
+      throw ConfigurationError("Command trace {} holds an unknown command id {}!", m_path, command);
+    }
+    record.clk = m_clk;
+    record.command = command;
+    record.addr_vec.resize(m_levels);
+    for (int level = 0; level < m_levels; level++) {
+      record.addr_vec[level] = get_le<int32_t>(src + RECORD_HEAD_SIZE + level * sizeof(int32_t));
+    }
+    return true;
+  }
+  return false;
+}
+
+}        // namespace CommandTrace
+
+}        // namespace Ramulator
@@ -0,0 +1,136 @@
+#ifndef     RAMULATOR_CONTROLLER_PLUGIN_COMMAND_TRACE_FORMAT_H
+#define     RAMULATOR_CONTROLLER_PLUGIN_COMMAND_TRACE_FORMAT_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <fstream>
+#include <cstdint>
+#include <condition_variable>
+
+#include "base/type.h"
+#include "base/exception.h"
+#include "frontend/impl/memory_trace/mapped_trace.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    The binary format of the DRAM command traces of TraceRecorder
+ * @details
+ * A command trace starts with a fixed 32-byte little-endian header:
+ *   "RCTR", the format version (uint16_t), the address vector levels (uint8_t), a reserved zero byte, the number of
+ *   records (uint64_t), the number of command names (uint16_t) and 14 reserved zero bytes,
+ * followed by the NUL-terminated command names, indexed by command id. Every record then has the same width:
+ *   the cycles since the previous record (uint32_t), the command id (uint16_t), 2 reserved zero bytes and the address
+ *   vector (int32_t per level).
+ * A gap of more than UINT32_MAX - 1 cycles is bridged by records with the command id CLOCK_ADVANCE, which only move the
+ * clock forward.
+ *
+ */
+namespace CommandTrace {
+
+inline constexpr char MAGIC[4] = {'R', 'C', 'T', 'R'};
+inline constexpr uint16_t VERSION = 1;
+inline constexpr size_t HEADER_SIZE = 32;
+inline constexpr uint16_t CLOCK_ADVANCE = 0xFFFF;
+
+struct Record {
+  Clk_t clk = 0;
+  int command = -1;
+  AddrVec_t addr_vec;
+};
+
+/**
+ * @brief    Returns whether the file at path starts with the command trace magic.
+ *
+ */
+bool is_command_trace(const std::string& path);
+
+
+/**
+ * @brief    Appends the records to a buffer, which a background thread writes to the file with large sequential
+ *           writes while the other buffer fills. The record count in the header is written by close().
+ *
+ */
+class Writer {
+  public:
+    static constexpr size_t BUFFER_SIZE = 1 << 22;
+
+  private:
+    std::string m_path;
+    std::ofstream m_file;
+    int m_levels;
+    size_t m_record_size;
+    uint64_t m_num_records = 0;
+    Clk_t m_prev_clk = 0;
+    bool m_closed = false;
+
+    std::array<std::vector<uint8_t>, 2> m_buffers;
+    int m_buffer = 0;                 // The buffer being filled
+    bool m_pending = false;           // Whether the other buffer is being written
+    bool m_stop = false;
+    bool m_failed = false;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::thread m_writer;
+
+  public:
+    Writer(const std::string& path, int levels, const std::vector<std::string>& command_names);
+    ~Writer();
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    /**
+     * @brief    Appends a command issued at clk (not before the previous one). Missing levels are recorded as -1.
+     *
+     */
+    void record(Clk_t clk, int command, const AddrVec_t& addr_vec);
+
+    void close();
+
+  private:
+    void put_record(uint32_t delta, uint16_t command, const AddrVec_t* addr_vec);
+    // Hands the filled buffer to the writer thread, once it is done with the other one
+    void hand_off();
+    void write_buffers();
+};
+
+
+/**
+ * @brief    Decodes the records of a memory-mapped command trace in order.
+ *
+ */
+class Reader {
+  private:
+    std::string m_path;
+    MappedFile m_file;
+    int m_levels = 0;
+    uint64_t m_num_records = 0;
+    std::vector<std::string> m_command_names;
+
+    const uint8_t* m_cursor;
+    size_t m_record_size;
+    Clk_t m_clk = 0;
+
+  public:
+    explicit Reader(const std::string& path);
+
+    int levels() const { return m_levels; };
+    uint64_t num_records() const { return m_num_records; };
+    const std::vector<std::string>& command_names() const { return m_command_names; };
+
+    /**
+     * @brief    Decodes the next command into record. Returns false at the end of the trace.
+     *
+     */
+    bool next(Record& record);
+};
+
+}        // namespace CommandTrace
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_CONTROLLER_PLUGIN_COMMAND_TRACE_FORMAT_H
@@ -0,0 +1,230 @@
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include "base/base.h"
+#include "dram_controller/controller.h"
+#include "dram_controller/plugin.h"
+#include "dram_controller/impl/plugin/ecc/ecc.h"
+#include "dram_controller/impl/plugin/compression/line_compressor.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Models line compression of the data bus on top of the functional ECCPlugin
+ *
+ * @details
+ * Every read and write line (one RD/WR burst) is compressed with BDI, FPC or the better of both, using the data
+ * the ECCPlugin of the controller stores. A compressed line moves in ceil(size / beat bytes) beats instead of the
+ * full burst; the beats saved are reported, the DRAM timings are left as they are. Reads complete after the
+ * decompression latency of their scheme. The plugin should come after the ECCPlugin in the plugin list, so that
+ * writes are compressed with their new data.
+ *
+ */
+class CompressionPlugin : public IControllerPlugin, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IControllerPlugin, CompressionPlugin, "CompressionPlugin", "Models BDI/FPC line compression of the data moved by the ECCPlugin.")
+
+  private:
+    enum class Scheme { BDI, FPC, Best };
+
+    struct HeldRead {
+      RequestCallback callback;     // Callback of the read, called once its line is decompressed
+      Clk_t latency = 0;
+    };
+
+    IDRAM* m_dram = nullptr;
+    IECCPlugin* m_ecc = nullptr;
+
+    Scheme m_scheme = Scheme::Best;
+    Clk_t m_bdi_latency = 1;
+    Clk_t m_fpc_latency = 5;
+
+    size_t m_line_bytes = 64;
+    size_t m_beat_bytes = 8;
+    int m_beats_per_burst = 8;
+    std::vector<uint8_t> m_line;                    // Scratch buffer for the line of a request
+
+    Clk_t m_clk = 0;
+    std::vector<HeldRead> m_held;                   // Reads waiting for their data, indexed by slot
+    std::vector<int> m_free_held;                   // Unused slots of m_held
+    std::vector<std::pair<Clk_t, Request>> m_decompressing;   // Reads with their completion cycle
+
+    size_t s_lines = 0;
+    size_t s_uncompressed_bytes = 0;
+    size_t s_compressed_bytes = 0;
+    size_t s_beats_saved = 0;
+    size_t s_bdi_lines = 0;              // Lines BDI compressed best
+    size_t s_fpc_lines = 0;              // Lines FPC compressed best
+    size_t s_uncompressible_lines = 0;
+    size_t s_decompression_latency = 0;  // Cycles reads spent in decompression
+    size_t s_decompressed_reads = 0;
+    float s_compression_ratio = 0;
+    float s_bursts_saved = 0;
+    float s_avg_decompression_latency = 0;
+
+  public:
+    void init() override {
+      std::string scheme = param<std::string>("scheme").desc("Compression scheme: bdi, fpc or best (the smaller of both per line).").default_val("best");
+      m_bdi_latency = param<Clk_t>("bdi_latency").desc("Cycles to decompress a BDI line.").default_val(1);
+      m_fpc_latency = param<Clk_t>("fpc_latency").desc("Cycles to decompress an FPC line.").default_val(5);
+
+      if (scheme == "bdi") {
+        m_scheme = Scheme::BDI;
+      } else if (scheme == "fpc") {
+        m_scheme = Scheme::FPC;
+      } else if (scheme == "best") {
+        m_scheme = Scheme::Best;
+      } else {
+        throw ConfigurationError("Compression: Unsupported scheme \"{}\" (expected bdi, fpc or best)!", scheme);
+      }
+      if (m_bdi_latency < 0 || m_fpc_latency < 0) {
+        throw ConfigurationError("Compression: Decompression latencies cannot be negative!");
+      }
+    };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      m_ctrl = cast_parent<IDRAMController>();
+      m_dram = m_ctrl->m_dram;
+      m_ecc = m_ctrl->get_plugin<IECCPlugin>();
+      if (!m_ecc || !m_ecc->keeps_data()) {
+        throw ConfigurationError("Compression: The controller needs an ECCPlugin in functional mode to provide the data!");
+      }
+
+      m_beat_bytes = std::max(1, m_dram->m_channel_width / 8);
+      m_beats_per_burst = m_dram->m_internal_prefetch_size;
+      m_line_bytes = m_beat_bytes * m_beats_per_burst;
+      if (m_line_bytes % 8 != 0) {
+        throw ConfigurationError("Compression: Lines of {}B are not a multiple of 8B!", m_line_bytes);
+      }
+      m_line.resize(m_line_bytes);
+
+      register_stat(s_lines).name("compression_lines");
+      register_stat(s_uncompressed_bytes).name("compression_uncompressed_bytes");
+      register_stat(s_compressed_bytes).name("compression_compressed_bytes");
+      register_stat(s_compression_ratio).name("compression_ratio");
+      register_stat(s_beats_saved).name("compression_beats_saved");
+      register_stat(s_bursts_saved).name("compression_bursts_saved");
+      register_stat(s_bdi_lines).name("compression_bdi_lines");
+      register_stat(s_fpc_lines).name("compression_fpc_lines");
+      register_stat(s_uncompressible_lines).name("compression_uncompressible_lines");
+      register_stat(s_decompression_latency).name("decompression_latency");
+      register_stat(s_avg_decompression_latency).name("avg_decompression_latency");
+    };
+
+    void update(bool request_found, ReqBuffer::iterator& req_it) override {
+      if (is_new_cycle(request_found)) {
+        m_clk++;
+      }
+      if (!m_decompressing.empty()) {
+        complete_reads();
+      }
+
+      if (!request_found || req_it->command != req_it->final_command || req_it->addr < 0 || m_ecc->is_own_request(*req_it)) {
+        return;
+      }
+      bool is_read = req_it->type_id == Request::Type::Read;
+      if (!is_read && req_it->type_id != Request::Type::Write) {
+        return;
+      }
+
+      Addr_t line_addr = req_it->addr - req_it->addr % (Addr_t) m_line_bytes;
+      if (!m_ecc->read_data(line_addr, m_line)) {
+        return;
+      }
+
+      Clk_t latency = 0;
+      size_t size = compress(latency);
+      size_t beats = std::max<size_t>(1, (size + m_beat_bytes - 1) / m_beat_bytes);
+      s_lines++;
+      s_uncompressed_bytes += m_line_bytes;
+      s_compressed_bytes += size;
+      s_beats_saved += m_beats_per_burst - std::min<size_t>(beats, m_beats_per_burst);
+
+      if (is_read && latency > 0) {
+        hold_read(*req_it, latency);
+      }
+    };
+
+    Clk_t get_idle_cycles() override {
+      if (m_decompressing.empty()) {
+        return std::numeric_limits<Clk_t>::max();
+      }
+      Clk_t due = std::numeric_limits<Clk_t>::max();
+      for (const auto& [clk, req] : m_decompressing) {
+        due = std::min(due, clk);
+      }
+      return std::max<Clk_t>(due - m_clk - 1, 0);
+    };
+
+    void skip_cycles(Clk_t num_cycles) override {
+      m_clk += num_cycles;
+    };
+
+    void finalize() override {
+      s_compression_ratio = s_compressed_bytes > 0 ? (float) s_uncompressed_bytes / (float) s_compressed_bytes : 0.0f;
+      s_bursts_saved = (float) s_beats_saved / (float) m_beats_per_burst;
+      s_avg_decompression_latency = s_decompressed_reads > 0 ? (float) s_decompression_latency / (float) s_decompressed_reads : 0.0f;
+    };
+
+  private:
+    // Compressed size of m_line under the configured scheme, and the latency to decompress it
+    size_t compress(Clk_t& latency) {
+      size_t bdi = m_scheme != Scheme::FPC ? LineCompressor::bdi_size(m_line) : m_line_bytes;
+      size_t fpc = m_scheme != Scheme::BDI ? LineCompressor::fpc_size(m_line) : m_line_bytes;
+      if (bdi >= m_line_bytes && fpc >= m_line_bytes) {
+        s_uncompressible_lines++;
+        latency = 0;
+        return m_line_bytes;
+      }
+      if (bdi <= fpc) {
+        s_bdi_lines++;
+        latency = m_bdi_latency;
+        return bdi;
+      }
+      s_fpc_lines++;
+      latency = m_fpc_latency;
+      return fpc;
+    };
+
+    // Delays the callback of a read by the decompression of its line, after everything else the read waits for
+    void hold_read(Request& req, Clk_t latency) {
+      int slot;
+      if (m_free_held.empty()) {
+        slot = m_held.size();
+        m_held.emplace_back();
+      } else {
+        slot = m_free_held.back();
+        m_free_held.pop_back();
+      }
+      m_held[slot].callback = req.callback;
+      m_held[slot].latency = latency;
+
+      req.callback = [this, slot](Request& req) {
+        Request done = req;
+        done.callback = m_held[slot].callback;
+        done.depart = m_clk + m_held[slot].latency;
+        m_decompressing.push_back({done.depart, done});
+        m_free_held.push_back(slot);
+        s_decompression_latency += m_held[slot].latency;
+      };
+    };
+
+    void complete_reads() {
+      for (size_t i = 0; i < m_decompressing.size();) {
+        if (m_decompressing[i].first > m_clk) {
+          i++;
+          continue;
+        }
+        Request req = m_decompressing[i].second;
+        m_decompressing[i] = m_decompressing.back();
+        m_decompressing.pop_back();
+
+        s_decompressed_reads++;
+        if (req.callback) {
+          req.callback(req);
+        }
+      }
+    };
+};
+
+}        // namespace Ramulator
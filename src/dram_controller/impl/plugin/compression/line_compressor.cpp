@@ -0,0 +1,120 @@
+#include "dram_controller/impl/plugin/compression/line_compressor.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Ramulator {
+
+namespace {
+
+// Little-endian k-byte element i of line, sign-extended to 64 bits
+inline int64_t element(std::span<const uint8_t> line, size_t i, int k) {
+  uint64_t v = 0;
+  std::memcpy(&v, line.data() + i * k, k);
+  int shift = 64 - 8 * k;
+  return shift > 0 ? (int64_t) (v << shift) >> shift : (int64_t) v;
+}
+
+inline bool fits_signed(int64_t v, int bytes) {
+  if (bytes >= 8) {
+    return true;
+  }
+  int64_t limit = (int64_t) 1 << (8 * bytes - 1);
+  return v >= -limit && v < limit;
+}
+
+inline bool fits_signed_bits(int32_t v, int bits) {
+  int32_t limit = 1 << (bits - 1);
+  return v >= -limit && v < limit;
+}
+
+}       // namespace
+
+size_t LineCompressor::bdi_size(std::span<const uint8_t> line) {
+  const size_t size = line.size();
+  if (std::all_of(line.begin(), line.end(), [](uint8_t b) { return b == 0; })) {
+    return 1;
+  }
+  bool repeated = true;
+  for (size_t i = 8; i < size && repeated; i += 8) {
+    repeated = std::memcmp(line.data(), line.data() + i, 8) == 0;
+  }
+  if (repeated) {
+    return 8;
+  }
+
+  static constexpr int ENCODINGS[][2] = {{8, 1}, {8, 2}, {8, 4}, {4, 1}, {4, 2}, {2, 1}};
+  size_t best = size;
+  for (const auto& [k, d] : ENCODINGS) {
+    const size_t n = size / k;
+    const size_t compressed = k + n * d + (n + 7) / 8;
+    if (compressed >= best) {
+      continue;
+    }
+    bool has_base = false;
+    int64_t base = 0;
+    bool fits = true;
+    for (size_t i = 0; i < n && fits; i++) {
+      int64_t v = element(line, i, k);
+      if (fits_signed(v, d)) {
+        continue;   // Delta from the implicit zero base
+      }
+      if (!has_base) {
+        has_base = true;
+        base = v;
+      }
+      fits = fits_signed((int64_t) ((uint64_t) v - (uint64_t) base), d);
+    }
+    if (fits) {
+      best = compressed;
+    }
+  }
+  return best;
+}
+
+size_t LineCompressor::fpc_size(std::span<const uint8_t> line) {
+  const size_t words = line.size() / 4;
+  size_t bits = 0;
+  size_t i = 0;
+  while (i < words) {
+    uint32_t w;
+    std::memcpy(&w, line.data() + 4 * i, 4);
+    int32_t s = (int32_t) w;
+    bits += 3;
+
+    if (w == 0) {
+      // Zero run of up to 8 words
+      size_t run = 1;
+      uint32_t next = 0;
+      while (run < 8 && i + run < words && (std::memcpy(&next, line.data() + 4 * (i + run), 4), next == 0)) {
+        run++;
+      }
+      bits += 3;
+      i += run;
+      continue;
+    }
+
+    int16_t low = (int16_t) (w & 0xFFFF);
+    int16_t high = (int16_t) (w >> 16);
+    uint8_t byte = w & 0xFF;
+    if (fits_signed_bits(s, 4)) {
+      bits += 4;
+    } else if (fits_signed_bits(s, 8)) {
+      bits += 8;
+    } else if (fits_signed_bits(s, 16)) {
+      bits += 16;
+    } else if ((w & 0xFFFF) == 0) {
+      bits += 16;   // Halfword padded with a zero halfword
+    } else if (fits_signed_bits(low, 8) && fits_signed_bits(high, 8)) {
+      bits += 16;   // Two halfwords, each a sign-extended byte
+    } else if (w == byte * 0x01010101u) {
+      bits += 8;    // Repeated byte
+    } else {
+      bits += 32;
+    }
+    i++;
+  }
+  return std::min(line.size(), (bits + 7) / 8);
+}
+
+}       // namespace Ramulator
@@ -0,0 +1,30 @@
+#ifndef RAMULATOR_PLUGIN_COMPRESSION_LINE_COMPRESSOR_H_
+#define RAMULATOR_PLUGIN_COMPRESSION_LINE_COMPRESSOR_H_
+
+#include <cstdint>
+#include <span>
+
+namespace Ramulator {
+
+/**
+ * @brief    Compressed sizes of one memory line under the BDI and FPC schemes (sizes only, nothing is encoded).
+ *
+ * @details
+ *  - BDI (Base-Delta-Immediate, Pekhimenko et al., PACT'12): an all-zero line, a line of one repeated 8-byte
+ *    value, or a line of k-byte elements that are each within a d-byte signed delta of either zero or one base
+ *    (the first element not close to zero), for (k, d) in {(8,1), (8,2), (8,4), (4,1), (4,2), (2,1)}. The size
+ *    counts the base, the deltas and one base-select bit per element.
+ *  - FPC (Frequent Pattern Compression, Alameldeen and Wood, 2004): every 32-bit word gets a 3-bit prefix and
+ *    the data of its pattern (zero run of up to 8 words, 4/8/16-bit sign-extended, halfword padded with a zero
+ *    halfword, two sign-extended bytes, repeated byte, or uncompressed).
+ * Both return the line size if the line does not compress. Lines must be a multiple of 8 bytes.
+ *
+ */
+struct LineCompressor {
+  static size_t bdi_size(std::span<const uint8_t> line);
+  static size_t fpc_size(std::span<const uint8_t> line);
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_COMPRESSION_LINE_COMPRESSOR_H_
@@ -32,14 +32,7 @@ void DeviceConfig::set_device(IDRAMController* ctrl) {
 }
 
 int DeviceConfig::get_flat_bank_id(const Request& req) {
-    auto rank_id = req.addr_vec[m_rank_level];
-    auto flat_bank_id = req.addr_vec[m_bank_level];
-    auto accumulated_dimension = 1;
-    for (int i = m_bank_level - 1; i >= m_rank_level; i--) {
-        accumulated_dimension *= m_dram->m_organization.count[i + 1];
-        flat_bank_id += req.addr_vec[i] * accumulated_dimension;
-    }
-    return flat_bank_id;
+    return m_dram->flat_bank_id(req.addr_vec);
 }
 
 }
@@ -0,0 +1,76 @@
+#include "dram_controller/impl/plugin/ecc/adaptive_strength.h"
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+AdaptiveStrength::AdaptiveStrength(const Config& config): m_config(config) {
+  if (m_config.region_size <= 0) {
+    throw ConfigurationError("ECCPlugin: adaptive_region_size must be positive (got {})!", m_config.region_size);
+  }
+  if (m_config.window < 1) {
+    throw ConfigurationError("ECCPlugin: adaptive_window must be at least one cycle (got {})!", m_config.window);
+  }
+  if (m_config.downgrade_rate < 0.0 || m_config.upgrade_rate <= m_config.downgrade_rate) {
+    throw ConfigurationError("ECCPlugin: adaptive_upgrade_rate ({}) must be above adaptive_downgrade_rate ({}) and both non-negative!",
+                             m_config.upgrade_rate, m_config.downgrade_rate);
+  }
+  m_window_end = m_config.window;
+  m_enabled = true;
+}
+
+AdaptiveStrength::Level AdaptiveStrength::level(Addr_t addr) const {
+  auto it = m_regions.find(addr / m_config.region_size);
+  return it == m_regions.end() ? Level::Strong : it->second.level;
+}
+
+void AdaptiveStrength::record_read(Addr_t addr, bool edc_failed, bool uncorrectable) {
+  Region& region = m_regions[addr / m_config.region_size];
+  region.reads[1]++;
+  region.failures[1] += edc_failed;
+  region.uncorrectable += uncorrectable;
+}
+
+void AdaptiveStrength::tick(Clk_t clk) {
+  while (clk >= m_window_end) {
+    close_window();
+    m_window_end += m_config.window;
+    if (m_regions.empty() && clk >= m_window_end) {
+      // Nothing to age: jump to the window holding clk
+      m_window_end += (clk - m_window_end) / m_config.window * m_config.window;
+    }
+  }
+}
+
+void AdaptiveStrength::close_window() {
+  s_weak_regions = 0;
+  for (auto it = m_regions.begin(); it != m_regions.end();) {
+    Region& region = it->second;
+    size_t reads = region.reads[0] + region.reads[1];
+    double rate = reads > 0 ? (double) (region.failures[0] + region.failures[1]) / (double) reads : 0.0;
+
+    if (region.level == Level::Weak && (region.uncorrectable > 0 || rate >= m_config.upgrade_rate)) {
+      region.level = Level::Strong;
+      s_upgrades++;
+    } else if (region.level == Level::Strong && reads >= m_config.min_reads && rate <= m_config.downgrade_rate) {
+      region.level = Level::Weak;
+      s_downgrades++;
+    }
+
+    region.reads[0] = region.reads[1];
+    region.failures[0] = region.failures[1];
+    region.reads[1] = 0;
+    region.failures[1] = 0;
+    region.uncorrectable = 0;
+
+    // A strong region without reads in the sliding window is the same as an untracked one
+    if (region.level == Level::Strong && region.reads[0] == 0) {
+      it = m_regions.erase(it);
+      continue;
+    }
+    s_weak_regions += region.level == Level::Weak;
+    it++;
+  }
+}
+
+}       // namespace Ramulator
@@ -0,0 +1,87 @@
+#ifndef RAMULATOR_PLUGIN_ECC_ADAPTIVE_STRENGTH_H_
+#define RAMULATOR_PLUGIN_ECC_ADAPTIVE_STRENGTH_H_
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "base/type.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Picks weak or strong ECC per address region from the EDC failure rate its reads observe.
+ *
+ * @details
+ * Every region of region_size bytes counts its reads, EDC failures and uncorrectable reads in windows of
+ * window cycles. At the end of a window, the failure rate over the last two windows (a sliding window of two
+ * halves) moves the region:
+ *  - to strong protection if it reaches upgrade_rate or a read was uncorrectable;
+ *  - to weak protection if it is at most downgrade_rate over at least min_reads reads.
+ * Regions start strong. Only regions that were read or left the initial level are kept, so the table stays sparse.
+ * The level only applies to codewords encoded afterwards: the owner re-encodes lazily, on the next write.
+ *
+ */
+class AdaptiveStrength {
+  public:
+    enum class Level : uint8_t {
+      Weak,
+      Strong,
+    };
+
+    struct Config {
+      Addr_t region_size = 1 << 20;
+      Clk_t window = 100000;
+      double upgrade_rate = 1e-3;
+      double downgrade_rate = 1e-5;
+      size_t min_reads = 64;
+    };
+
+  private:
+    struct Region {
+      Level level = Level::Strong;
+      size_t reads[2] = {0, 0};       // Previous and current window
+      size_t failures[2] = {0, 0};    // EDC failures
+      size_t uncorrectable = 0;       // Uncorrectable reads of the current window
+    };
+
+    Config m_config;
+    std::unordered_map<Addr_t, Region> m_regions;
+    Clk_t m_window_end = 0;
+    bool m_enabled = false;
+
+  public:
+    size_t s_upgrades = 0;
+    size_t s_downgrades = 0;
+    size_t s_weak_regions = 0;        // Regions at the weak level after the last window
+
+  public:
+    AdaptiveStrength() {};
+    explicit AdaptiveStrength(const Config& config);
+
+    bool enabled() const { return m_enabled; };
+
+    /**
+     * @brief    Level of the region holding addr.
+     *
+     */
+    Level level(Addr_t addr) const;
+
+    /**
+     * @brief    Counts a read of addr and its outcome in the current window.
+     *
+     */
+    void record_read(Addr_t addr, bool edc_failed, bool uncorrectable);
+
+    /**
+     * @brief    Closes every window that ended by clk, moving the regions between the levels.
+     *
+     */
+    void tick(Clk_t clk);
+
+  private:
+    void close_window();
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_ADAPTIVE_STRENGTH_H_
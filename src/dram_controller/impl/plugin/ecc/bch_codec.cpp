@@ -0,0 +1,362 @@
+#include "dram_controller/impl/plugin/ecc/bch_codec.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+namespace {
+
+// Per-thread scratch space so that encode/decode do not allocate once warmed up
+thread_local std::vector<uint64_t> t_remainder;
+thread_local std::vector<int> t_scratch;
+
+// Bit p of a left-aligned register (p = 0 is the MSB of the first word)
+inline void set_bit(uint64_t* words, int p) {
+  words[p / 64] |= 1ull << (63 - p % 64);
+}
+
+inline uint64_t load_be64(const uint8_t* p) {
+  uint64_t v;
+  std::memcpy(&v, p, 8);
+  return __builtin_bswap64(v);
+}
+
+}       // namespace
+
+
+BCHCodec::BCHCodec(const GaloisField& gf, int t, bool specialized): m_gf(gf), m_t(t) {
+  const int n = gf.n();
+  if (t < 0 || 2 * t - 1 >= n) {
+    throw ConfigurationError("BCH code with t = {} does not fit in GF(2^{})!", t, gf.m());
+  }
+
+  // g(x) = lcm of the minimal polynomials of alpha^1, alpha^3, ..., alpha^(2t-1), one cyclotomic coset at a time.
+  // The even powers are roots as well since alpha^2i belongs to the coset of alpha^i
+  std::vector<uint8_t> generator = {1};            // Binary coefficients, generator[i] of x^i
+  std::vector<bool> covered(n, false);
+  for (int i = 1; i < 2 * t; i += 2) {
+    if (covered[i]) {
+      continue;
+    }
+
+    std::vector<uint16_t> minimal = {1};           // prod (x - alpha^e) over the coset of i, its coefficients are 0 or 1
+    int e = i;
+    do {
+      covered[e] = true;
+      minimal.push_back(0);
+      for (size_t j = minimal.size() - 1; j > 0; j--) {
+        minimal[j] = minimal[j - 1] ^ m_gf.mul_exp(minimal[j], e);
+      }
+      minimal[0] = m_gf.mul_exp(minimal[0], e);
+      e = (2 * e) % n;
+    } while (e != i);
+
+    std::vector<uint8_t> product(generator.size() + minimal.size() - 1, 0);
+    for (size_t a = 0; a < generator.size(); a++) {
+      if (generator[a] == 0) continue;
+      for (size_t b = 0; b < minimal.size(); b++) {
+        product[a + b] ^= (minimal[b] != 0);
+      }
+    }
+    generator = std::move(product);
+  }
+  m_parity_bits = generator.size() - 1;
+  m_words = (m_parity_bits + 63) / 64;
+  if (specialized) {
+    m_kernel = BCHKernel::find(m_words);
+  }
+
+  // g(x) without its leading term, left-aligned: the coefficient of x^(r-1) is the MSB of the first word
+  std::vector<uint64_t> low(m_words, 0);
+  for (int d = 0; d < m_parity_bits; d++) {
+    if (generator[d]) {
+      set_bit(low.data(), m_parity_bits - 1 - d);
+    }
+  }
+
+  // Byte table 0: feed the 8 bits of b (MSB first) into a bit-serial LFSR that starts from zero
+  m_table.assign(TABLES * 256 * (size_t) m_words, 0);
+  for (int b = 0; b < 256 && m_words > 0; b++) {
+    uint64_t* rem = row(0, b);
+    for (int bit = 7; bit >= 0; bit--) {
+      bool feedback = ((b >> bit) & 1) ^ (rem[0] >> 63);
+      for (int w = 0; w + 1 < m_words; w++) {
+        rem[w] = (rem[w] << 1) | (rem[w + 1] >> 63);
+      }
+      rem[m_words - 1] <<= 1;
+      if (feedback) {
+        for (int w = 0; w < m_words; w++) {
+          rem[w] ^= low[w];
+        }
+      }
+    }
+  }
+
+  // Table k holds x^(r + 8k) * b(x) mod g(x): table k-1 shifted by one more zero byte
+  for (int k = 1; k < TABLES; k++) {
+    for (int b = 0; b < 256 && m_words > 0; b++) {
+      const uint64_t* src = row(k - 1, b);
+      uint64_t* dst = row(k, b);
+      std::copy(src, src + m_words, dst);
+      byte_step(dst, 0);
+    }
+  }
+}
+
+void BCHCodec::byte_step(uint64_t* rem, uint8_t byte) const {
+  const uint64_t* t = row(0, (rem[0] >> 56) ^ byte);
+  for (int w = 0; w + 1 < m_words; w++) {
+    rem[w] = ((rem[w] << 8) | (rem[w + 1] >> 56)) ^ t[w];
+  }
+  rem[m_words - 1] = (rem[m_words - 1] << 8) ^ t[m_words - 1];
+}
+
+std::string BCHCodec::kernel_name() const {
+  return std::string("bch/") + (m_kernel ? m_kernel->name : "generic");
+}
+
+void BCHCodec::remainder(std::span<const uint8_t> data, uint64_t* rem) const {
+  if (m_kernel) {
+    m_kernel->remainder(m_table.data(), data, rem);
+    return;
+  }
+
+  // Every step consumes 64 data bits: they meet the first remainder word (rem(x) * x^64 lines up with them, even
+  // for r < 64), the eight bytes of the sum go through their own table and the other words move up by one word
+  const size_t size = data.size();
+  const size_t W = m_words;
+  size_t i = 0;
+  if (W == 1) {
+    const uint64_t* t = m_table.data();
+    uint64_t r = 0;
+    for (; i + 8 <= size; i += 8) {
+      uint64_t v = r ^ load_be64(data.data() + i);
+      r = t[7 * 256 + (v >> 56)] ^ t[6 * 256 + ((v >> 48) & 0xFF)] ^ t[5 * 256 + ((v >> 40) & 0xFF)] ^ t[4 * 256 + ((v >> 32) & 0xFF)]
+        ^ t[3 * 256 + ((v >> 24) & 0xFF)] ^ t[2 * 256 + ((v >> 16) & 0xFF)] ^ t[1 * 256 + ((v >> 8) & 0xFF)] ^ t[v & 0xFF];
+    }
+    for (; i < size; i++) {
+      r = (r << 8) ^ t[(r >> 56) ^ data[i]];
+    }
+    rem[0] = r;
+    return;
+  }
+
+  std::fill(rem, rem + W, 0);
+  for (; i + 8 <= size; i += 8) {
+    uint64_t v = rem[0] ^ load_be64(data.data() + i);
+    std::copy(rem + 1, rem + W, rem);
+    rem[W - 1] = 0;
+    for (int k = 0; k < TABLES; k++) {
+      const uint64_t* t = row(k, (v >> (8 * k)) & 0xFF);
+      for (size_t w = 0; w < W; w++) {
+        rem[w] ^= t[w];
+      }
+    }
+  }
+  for (; i < size; i++) {
+    byte_step(rem, data[i]);
+  }
+}
+
+void BCHCodec::encode(std::span<const uint8_t> data, std::span<uint8_t> parity) const {
+  if (m_parity_bits == 0) {
+    return;
+  }
+
+  t_remainder.resize(m_words);
+  uint64_t* rem = t_remainder.data();
+  remainder(data, rem);
+  store_parity(rem, parity);
+}
+
+void BCHCodec::store_parity(const uint64_t* rem, std::span<uint8_t> parity) const {
+  for (size_t i = 0; i < parity_bytes(); i++) {
+    parity[i] = (rem[i / 8] >> (56 - 8 * (i % 8))) & 0xFF;
+  }
+}
+
+void BCHCodec::encode_batch(std::span<const std::span<const uint8_t>> data, std::span<const std::span<uint8_t>> parity) const {
+  if (m_parity_bits == 0) {
+    return;
+  }
+  t_remainder.resize((size_t) m_words * BCHKernel::MAX_BATCH);
+  uint64_t* rems = t_remainder.data();
+  size_t i = 0;
+  while (i < data.size()) {
+    size_t count = 1;
+    while (m_kernel && count < BCHKernel::MAX_BATCH && i + count < data.size() && data[i + count].size() == data[i].size()) {
+      count++;
+    }
+    if (count == 1) {
+      remainder(data[i], rems);
+      store_parity(rems, parity[i]);
+    } else {
+      m_kernel->remainder_batch(m_table.data(), &data[i], rems, count);
+      for (size_t b = 0; b < count; b++) {
+        store_parity(rems + b * m_words, parity[i + b]);
+      }
+    }
+    i += count;
+  }
+}
+
+int BCHCodec::decode(std::span<uint8_t> data, std::span<uint8_t> parity) const {
+  if (m_parity_bits == 0) {
+    return 0;
+  }
+
+  // 1. c(x) mod g(x): the remainder of the received data, plus the received parity (without its padding bits)
+  t_remainder.resize(m_words);
+  uint64_t* rem = t_remainder.data();
+  remainder(data, rem);
+  const size_t nbytes = parity_bytes();
+  const uint8_t last_mask = 0xFF << (8 * nbytes - m_parity_bits);
+  for (size_t i = 0; i < nbytes; i++) {
+    uint8_t byte = (i + 1 == nbytes) ? (parity[i] & last_mask) : parity[i];
+    rem[i / 8] ^= (uint64_t) byte << (56 - 8 * (i % 8));
+  }
+  if (std::all_of(rem, rem + m_words, [](uint64_t w) { return w == 0; })) {
+    return 0;
+  }
+
+  const int n = m_gf.n();
+  const int nsym = 2 * m_t;
+  const int n_used = (int) data.size() * 8 + m_parity_bits;
+
+  // Scratch layout: syndromes [2t] | lambda [2t+1] | prev [2t+1] | tmp [2t+1] | chien logs [2t+1] | error positions [t]
+  t_scratch.assign(nsym + 4 * (nsym + 1) + m_t, 0);
+  int* syn     = t_scratch.data();
+  int* lambda  = syn + nsym;
+  int* prev    = lambda + nsym + 1;
+  int* tmp     = prev + nsym + 1;
+  int* logs    = tmp + nsym + 1;
+  int* err_pos = logs + nsym + 1;
+
+  // 2. Odd syndromes S_j = rem(alpha^j), one remainder word at a time: only its set bits (degree d) contribute.
+  // g(alpha^j) = 0, so the remainder has the same syndromes as the received codeword
+  for (int w = 0; w < m_words; w++) {
+    uint64_t bits = rem[w];
+    while (bits != 0) {
+      int p = w * 64 + std::countl_zero(bits);
+      bits &= ~(1ull << (63 - p % 64));
+      int d = m_parity_bits - 1 - p;
+
+      int e = d;
+      int step = (2 * d) % n;
+      for (int k = 0; k < m_t; k++) {
+        syn[2 * k] ^= m_gf.exp(e);
+        e += step;
+        if (e >= n) e -= n;
+      }
+    }
+  }
+  // Even syndromes of a binary code: S_2j = S_j^2
+  for (int j = 2; j <= nsym; j += 2) {
+    syn[j - 1] = m_gf.mul(syn[j / 2 - 1], syn[j / 2 - 1]);
+  }
+
+  // 3. Berlekamp-Massey for the error locator polynomial lambda(x)
+  lambda[0] = 1;
+  prev[0] = 1;
+  int L = 0;
+  int shift = 1;
+  uint16_t b = 1;
+  for (int r = 0; r < nsym; r++) {
+    uint16_t d = syn[r];
+    for (int i = 1; i <= L; i++) {
+      d ^= m_gf.mul(lambda[i], syn[r - i]);
+    }
+
+    if (d == 0) {
+      shift++;
+      continue;
+    }
+
+    uint16_t coef = m_gf.div(d, b);
+    if (2 * L <= r) {
+      std::copy(lambda, lambda + nsym + 1, tmp);
+      for (int i = 0; i + shift <= nsym; i++) {
+        lambda[i + shift] ^= m_gf.mul(coef, prev[i]);
+      }
+      L = r + 1 - L;
+      std::copy(tmp, tmp + nsym + 1, prev);
+      b = d;
+      shift = 1;
+    } else {
+      for (int i = 0; i + shift <= nsym; i++) {
+        lambda[i + shift] ^= m_gf.mul(coef, prev[i]);
+      }
+      shift++;
+    }
+  }
+  if (L > m_t || lambda[L] == 0) {
+    return -1;
+  }
+
+  // 4. Chien search over the positions of the shortened codeword: d is an error position if lambda(alpha^-d) = 0.
+  // logs[k] tracks log(lambda_k * alpha^(-d * k)), so every step is one table lookup and one add per term
+  for (int k = 1; k <= L; k++) {
+    logs[k] = (lambda[k] != 0) ? m_gf.log(lambda[k]) : -1;
+  }
+  int num_errors = 0;
+  for (int d = 0; d < n_used && num_errors < L; d++) {
+    uint16_t v = lambda[0];
+    for (int k = 1; k <= L; k++) {
+      if (logs[k] < 0) continue;
+      v ^= m_gf.exp(logs[k]);
+      logs[k] -= k;
+      if (logs[k] < 0) logs[k] += n;
+    }
+    if (v == 0) {
+      err_pos[num_errors++] = d;
+    }
+  }
+  // lambda(x) has at most L roots; fewer inside the codeword means more than t errors
+  if (num_errors != L) {
+    return -1;
+  }
+
+  // 5. Only flip the bits once the whole codeword is known to be decodable
+  for (int e = 0; e < num_errors; e++) {
+    int d = err_pos[e];
+    if (d < m_parity_bits) {
+      int p = m_parity_bits - 1 - d;
+      parity[p / 8] ^= 0x80 >> (p % 8);
+    } else {
+      int j = n_used - 1 - d;
+      data[j / 8] ^= 0x80 >> (j % 8);
+    }
+  }
+  return num_errors;
+}
+
+
+const BCHCodec& BCHCodecCache::get(int m, int t) {
+  auto key = std::make_pair(m, t);
+  if (auto it = m_codecs.find(key); it != m_codecs.end()) {
+    return *it->second;
+  }
+
+  auto& gf = m_fields[m];
+  if (!gf) {
+    gf = std::make_unique<GaloisField>(m);
+  }
+  auto [it, _] = m_codecs.emplace(key, std::make_unique<BCHCodec>(*gf, t, m_specialized));
+  return *it->second;
+}
+
+int BCHCodecCache::min_field_bits(size_t num_data_bits, int t) {
+  for (int m = GaloisField::MIN_SYMBOL_BITS; m <= GaloisField::MAX_SYMBOL_BITS; m++) {
+    size_t n = (size_t) ((1 << m) - 1);
+    if (num_data_bits + (size_t) m * t <= n && 2 * (size_t) t <= n) {
+      return m;
+    }
+  }
+  return -1;
+}
+
+}       // namespace Ramulator
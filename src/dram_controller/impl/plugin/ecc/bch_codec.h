@@ -0,0 +1,140 @@
+#ifndef RAMULATOR_PLUGIN_ECC_BCH_CODEC_H_
+#define RAMULATOR_PLUGIN_ECC_BCH_CODEC_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "dram_controller/impl/plugin/ecc/codec_kernels.h"
+#include "dram_controller/impl/plugin/ecc/rs_codec.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Systematic, narrow-sense binary BCH codec correcting t bit errors, shortened to the data size.
+ *
+ * @details
+ * The generator polynomial g(x) is the product of the minimal polynomials of alpha^1, alpha^3, ..., alpha^(2t-1)
+ * over GF(2^m), so the parity has r <= m * t bits, serialized MSB first into parity_bytes() bytes. Data bytes are
+ * taken MSB first with the first byte holding the highest degree coefficients.
+ *
+ * The encoder is an LFSR that consumes 64 data bits per step through eight byte tables (slicing-by-8): table k
+ * holds x^(r + 8k) * b(x) mod g(x) for every byte b, and the remainder is held left-aligned in 64-bit words.
+ * The decoder reuses it to compute c(x) mod g(x): a zero remainder means a clean codeword, otherwise the 2t
+ * syndromes are evaluated on the r-bit remainder one 64-bit word at a time (only its set bits contribute),
+ * followed by Berlekamp-Massey and a Chien search over the positions of the shortened codeword.
+ *
+ * The codec holds no per-call state, so one instance can be shared by every request with the same (m, t).
+ * Remainders of up to 8 words go through a BCHKernel specialized for their size.
+ *
+ */
+class BCHCodec {
+  private:
+    static constexpr int TABLES = 8;        // Byte tables of the slicing-by-8 LFSR
+
+    const GaloisField& m_gf;
+    int m_t;                                // Number of correctable bit errors
+    int m_parity_bits;                      // r, the degree of g(x)
+    int m_words;                            // 64-bit words of the LFSR remainder
+    std::vector<uint64_t> m_table;          // TABLES x 256 entries of m_words words
+    const BCHKernel* m_kernel = nullptr;    // Specialized remainder for m_words, if any
+
+  public:
+    /**
+     * @param    specialized    Use the specialized remainder kernel when the registry has one.
+     */
+    BCHCodec(const GaloisField& gf, int t, bool specialized = false);
+
+    int t() const { return m_t; };
+    int m() const { return m_gf.m(); };
+    int parity_bits() const { return m_parity_bits; };
+    size_t parity_bytes() const { return (size_t) (m_parity_bits + 7) / 8; };
+    size_t max_data_bits() const { return (size_t) (m_gf.n() - m_parity_bits); };
+
+    /**
+     * @brief    Name of the kernel in use (e.g., "bch/w1" or "bch/generic"), for reporting.
+     *
+     */
+    std::string kernel_name() const;
+
+    /**
+     * @brief    Computes the parity of data into the caller-provided parity span (parity_bytes() long).
+     *
+     */
+    void encode(std::span<const uint8_t> data, std::span<uint8_t> parity) const;
+
+    /**
+     * @brief    encode() of every data[i] into parity[i]. Runs of codewords with the same data size go through the
+     *           interleaved batch kernel, up to BCHKernel::MAX_BATCH at a time, if the codec has a specialized kernel.
+     *
+     */
+    void encode_batch(std::span<const std::span<const uint8_t>> data, std::span<const std::span<uint8_t>> parity) const;
+
+    /**
+     * @brief    Corrects data and parity in place.
+     *
+     * @return   int      Number of corrected bits, or -1 if the codeword is uncorrectable.
+     *                    On failure neither span is modified.
+     */
+    int decode(std::span<uint8_t> data, std::span<uint8_t> parity) const;
+
+  private:
+    const uint64_t* row(int k, int b) const { return &m_table[(k * 256 + b) * (size_t) m_words]; };
+    uint64_t* row(int k, int b) { return &m_table[(k * 256 + b) * (size_t) m_words]; };
+
+    /**
+     * @brief    Shifts one data byte into a left-aligned remainder.
+     *
+     */
+    void byte_step(uint64_t* rem, uint8_t byte) const;
+
+    /**
+     * @brief    Leaves data(x) * x^r mod g(x) in rem (m_words words, left-aligned).
+     *
+     */
+    void remainder(std::span<const uint8_t> data, uint64_t* rem) const;
+
+    /**
+     * @brief    Serializes a left-aligned remainder into parity_bytes() bytes of parity, MSB first.
+     *
+     */
+    void store_parity(const uint64_t* rem, std::span<uint8_t> parity) const;
+};
+
+
+/**
+ * @brief    Owns the GaloisFields and BCHCodecs used by a plugin, keyed by (m, t).
+ *
+ */
+class BCHCodecCache {
+  private:
+    std::map<int, std::unique_ptr<GaloisField>> m_fields;
+    std::map<std::pair<int, int>, std::unique_ptr<BCHCodec>> m_codecs;
+    bool m_specialized = true;
+
+  public:
+    /**
+     * @param    specialized    Build the codecs with the specialized kernels where available.
+     */
+    BCHCodecCache(bool specialized = true): m_specialized(specialized) {};
+
+    /**
+     * @brief    Returns the codec for (m, t), building its tables on first use.
+     *
+     */
+    const BCHCodec& get(int m, int t);
+
+    /**
+     * @brief    Smallest field width whose code length can hold num_data_bits plus the (at most m * t) parity bits.
+     *
+     * @return   int      The width in bits, or -1 if no supported field is large enough.
+     */
+    static int min_field_bits(size_t num_data_bits, int t);
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_BCH_CODEC_H_
@@ -0,0 +1,286 @@
+#include "dram_controller/impl/plugin/ecc/codec_kernels.h"
+
+#include <array>
+#include <cstring>
+
+#include "dram_controller/impl/plugin/ecc/rs_codec.h"
+
+namespace Ramulator {
+
+namespace {
+
+/**
+ * @brief    GF(2^M) log/antilog tables built at compile time from the same primitive polynomial as GaloisField.
+ *
+ * @details
+ * log(0) is ZERO_LOG = 2N and the antilog table is zero from 2N up to 4N, so exp[log(a) + log(b)] is a * b for
+ * every a, b (including 0) without a branch.
+ *
+ */
+template<int M>
+struct StaticField {
+  static constexpr int N = (1 << M) - 1;
+  static constexpr int ZERO_LOG = 2 * N;
+
+  struct Tables {
+    std::array<uint16_t, 4 * N + 1> exp{};
+    std::array<uint16_t, N + 1> log{};
+  };
+
+  static constexpr Tables build() {
+    Tables tables{};
+    uint32_t x = 1;
+    for (int i = 0; i < N; i++) {
+      tables.exp[i] = x;
+      tables.exp[i + N] = x;
+      tables.log[x] = i;
+      x <<= 1;
+      if (x & (1u << M)) {
+        x ^= GaloisField::PRIMITIVE_POLYS[M];
+      }
+    }
+    tables.log[0] = ZERO_LOG;
+    return tables;
+  }
+
+  static constexpr Tables tables = build();
+};
+
+
+/**
+ * @brief    Logs of the coefficients g_0 .. g_2t-1 of the RS generator polynomial (g_2t = 1), as built by RSCodec.
+ *
+ */
+template<int M, int T>
+struct RSGenerator {
+  static constexpr int NSYM = 2 * T;
+
+  static constexpr std::array<uint16_t, NSYM> build() {
+    const auto& gf = StaticField<M>::tables;
+    std::array<uint16_t, NSYM + 1> g{};
+    g[0] = 1;
+    for (int i = 1; i <= NSYM; i++) {
+      for (int j = i; j > 0; j--) {
+        g[j] = g[j - 1] ^ gf.exp[gf.log[g[j]] + i];
+      }
+      g[0] = gf.exp[gf.log[g[0]] + i];
+    }
+
+    std::array<uint16_t, NSYM> logs{};
+    for (int j = 0; j < NSYM; j++) {
+      logs[j] = gf.log[g[j]];
+    }
+    return logs;
+  }
+
+  static constexpr std::array<uint16_t, NSYM> log = build();
+};
+
+
+template<int M, int T>
+void rs_encode(std::span<const uint8_t> data, std::span<uint8_t> parity) {
+  constexpr int NSYM = 2 * T;
+  constexpr int SYMBOL_BYTES = (M + 7) / 8;
+  const auto& gf = StaticField<M>::tables;
+  const auto& glog = RSGenerator<M, T>::log;
+
+  // LFSR division of data(x) * x^2t by g(x); data[i] is the coefficient of x^(2t + i)
+  uint16_t r[NSYM] = {};
+  for (size_t i = data.size(); i-- > 0;) {
+    int log_fb = gf.log[data[i] ^ r[NSYM - 1]];
+    for (int j = NSYM - 1; j > 0; j--) {
+      r[j] = r[j - 1] ^ gf.exp[log_fb + glog[j]];
+    }
+    r[0] = gf.exp[log_fb + glog[0]];
+  }
+
+  for (int j = 0; j < NSYM; j++) {
+    parity[j * SYMBOL_BYTES] = r[j] & 0xFF;
+    if constexpr (SYMBOL_BYTES > 1) {
+      parity[j * SYMBOL_BYTES + 1] = r[j] >> 8;
+    }
+  }
+}
+
+template<int M, int T>
+void rs_encode_batch(const std::span<const uint8_t>* data, const std::span<uint8_t>* parity, int count) {
+  constexpr int NSYM = 2 * T;
+  constexpr int SYMBOL_BYTES = (M + 7) / 8;
+  const auto& gf = StaticField<M>::tables;
+  const auto& glog = RSGenerator<M, T>::log;
+
+  uint16_t r[RSKernel::MAX_BATCH][NSYM] = {};
+  for (size_t i = data[0].size(); i-- > 0;) {
+    for (int b = 0; b < count; b++) {
+      int log_fb = gf.log[data[b][i] ^ r[b][NSYM - 1]];
+      for (int j = NSYM - 1; j > 0; j--) {
+        r[b][j] = r[b][j - 1] ^ gf.exp[log_fb + glog[j]];
+      }
+      r[b][0] = gf.exp[log_fb + glog[0]];
+    }
+  }
+
+  for (int b = 0; b < count; b++) {
+    for (int j = 0; j < NSYM; j++) {
+      parity[b][j * SYMBOL_BYTES] = r[b][j] & 0xFF;
+      if constexpr (SYMBOL_BYTES > 1) {
+        parity[b][j * SYMBOL_BYTES + 1] = r[b][j] >> 8;
+      }
+    }
+  }
+}
+
+template<int M, int T>
+bool rs_is_clean(std::span<const uint8_t> data, std::span<const uint8_t> parity) {
+  constexpr int NSYM = 2 * T;
+  constexpr int SYMBOL_BYTES = (M + 7) / 8;
+  const auto& gf = StaticField<M>::tables;
+
+  // S_j = r(alpha^j) by Horner's rule, all 2t syndromes advanced together from the highest degree
+  uint16_t s[NSYM] = {};
+  for (size_t i = data.size(); i-- > 0;) {
+    uint16_t d = data[i];
+    for (int j = 0; j < NSYM; j++) {
+      s[j] = gf.exp[gf.log[s[j]] + j + 1] ^ d;
+    }
+  }
+  for (int i = NSYM - 1; i >= 0; i--) {
+    uint16_t d = parity[i * SYMBOL_BYTES];
+    if constexpr (SYMBOL_BYTES > 1) {
+      d |= (uint16_t) parity[i * SYMBOL_BYTES + 1] << 8;
+    }
+    for (int j = 0; j < NSYM; j++) {
+      s[j] = gf.exp[gf.log[s[j]] + j + 1] ^ d;
+    }
+  }
+
+  uint16_t any = 0;
+  for (int j = 0; j < NSYM; j++) {
+    any |= s[j];
+  }
+  return any == 0;
+}
+
+
+inline uint64_t load_be64(const uint8_t* p) {
+  uint64_t v;
+  std::memcpy(&v, p, 8);
+  return __builtin_bswap64(v);
+}
+
+template<int W>
+void bch_remainder(const uint64_t* tables, std::span<const uint8_t> data, uint64_t* out) {
+  const size_t size = data.size();
+  uint64_t rem[W] = {};
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t v = rem[0] ^ load_be64(data.data() + i);
+    for (int w = 0; w + 1 < W; w++) {
+      rem[w] = rem[w + 1];
+    }
+    rem[W - 1] = 0;
+    for (int k = 0; k < 8; k++) {
+      const uint64_t* row = tables + (k * 256 + ((v >> (8 * k)) & 0xFF)) * W;
+      for (int w = 0; w < W; w++) {
+        rem[w] ^= row[w];
+      }
+    }
+  }
+  for (; i < size; i++) {
+    const uint64_t* row = tables + ((rem[0] >> 56) ^ data[i]) * W;
+    for (int w = 0; w + 1 < W; w++) {
+      rem[w] = ((rem[w] << 8) | (rem[w + 1] >> 56)) ^ row[w];
+    }
+    rem[W - 1] = (rem[W - 1] << 8) ^ row[W - 1];
+  }
+  std::memcpy(out, rem, sizeof(rem));
+}
+
+template<int W>
+void bch_remainder_batch(const uint64_t* tables, const std::span<const uint8_t>* data, uint64_t* rems, int count) {
+  const size_t size = data[0].size();
+  uint64_t rem[BCHKernel::MAX_BATCH][W] = {};
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    for (int b = 0; b < count; b++) {
+      uint64_t v = rem[b][0] ^ load_be64(data[b].data() + i);
+      for (int w = 0; w + 1 < W; w++) {
+        rem[b][w] = rem[b][w + 1];
+      }
+      rem[b][W - 1] = 0;
+      for (int k = 0; k < 8; k++) {
+        const uint64_t* row = tables + (k * 256 + ((v >> (8 * k)) & 0xFF)) * W;
+        for (int w = 0; w < W; w++) {
+          rem[b][w] ^= row[w];
+        }
+      }
+    }
+  }
+  for (; i < size; i++) {
+    for (int b = 0; b < count; b++) {
+      const uint64_t* row = tables + ((rem[b][0] >> 56) ^ data[b][i]) * W;
+      for (int w = 0; w + 1 < W; w++) {
+        rem[b][w] = ((rem[b][w] << 8) | (rem[b][w + 1] >> 56)) ^ row[w];
+      }
+      rem[b][W - 1] = (rem[b][W - 1] << 8) ^ row[W - 1];
+    }
+  }
+  for (int b = 0; b < count; b++) {
+    std::memcpy(rems + b * W, rem[b], sizeof(rem[b]));
+  }
+}
+
+
+struct RSEntry {
+  int m;
+  int t;
+  RSKernel kernel;
+};
+
+#define RS_KERNEL(m, t) {m, t, {"m" #m "_t" #t, &rs_encode<m, t>, &rs_encode_batch<m, t>, &rs_is_clean<m, t>}}
+#define RS_KERNELS_FOR(m) RS_KERNEL(m, 1), RS_KERNEL(m, 2), RS_KERNEL(m, 3), RS_KERNEL(m, 4), RS_KERNEL(m, 5), \
+                          RS_KERNEL(m, 6), RS_KERNEL(m, 7), RS_KERNEL(m, 8), RS_KERNEL(m, 16)
+
+// RS symbol widths of 128B (m = 8), 256B (9), 512B (10), 1KB (11) and 4KB (13) blocks plus their EDC
+const RSEntry RS_REGISTRY[] = {
+  RS_KERNELS_FOR(8),
+  RS_KERNELS_FOR(9),
+  RS_KERNELS_FOR(10),
+  RS_KERNELS_FOR(11),
+  RS_KERNELS_FOR(13),
+};
+
+#undef RS_KERNELS_FOR
+#undef RS_KERNEL
+
+const BCHKernel BCH_REGISTRY[] = {
+  {"w1", &bch_remainder<1>, &bch_remainder_batch<1>},
+  {"w2", &bch_remainder<2>, &bch_remainder_batch<2>},
+  {"w3", &bch_remainder<3>, &bch_remainder_batch<3>},
+  {"w4", &bch_remainder<4>, &bch_remainder_batch<4>},
+  {"w5", &bch_remainder<5>, &bch_remainder_batch<5>},
+  {"w6", &bch_remainder<6>, &bch_remainder_batch<6>},
+  {"w7", &bch_remainder<7>, &bch_remainder_batch<7>},
+  {"w8", &bch_remainder<8>, &bch_remainder_batch<8>},
+};
+
+}       // namespace
+
+
+const RSKernel* RSKernel::find(int m, int t) {
+  for (const RSEntry& entry : RS_REGISTRY) {
+    if (entry.m == m && entry.t == t) {
+      return &entry.kernel;
+    }
+  }
+  return nullptr;
+}
+
+const BCHKernel* BCHKernel::find(int words) {
+  if (words < 1 || words > (int) std::size(BCH_REGISTRY)) {
+    return nullptr;
+  }
+  return &BCH_REGISTRY[words - 1];
+}
+
+}       // namespace Ramulator
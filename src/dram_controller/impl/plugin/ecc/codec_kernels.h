@@ -0,0 +1,89 @@
+#ifndef RAMULATOR_PLUGIN_ECC_CODEC_KERNELS_H_
+#define RAMULATOR_PLUGIN_ECC_CODEC_KERNELS_H_
+
+#include <cstdint>
+#include <span>
+
+namespace Ramulator {
+
+/**
+ * @brief    RS kernels specialized at compile time for one (m, t).
+ *
+ * @details
+ * The GF(2^m) tables and the generator polynomial are constexpr, the 2t parity/syndrome registers are stack arrays
+ * and every loop over them has a constant trip count. The tables map log(0) to a run of zeros past the antilog
+ * table, so multiplications need no zero test. Both kernels produce exactly what the generic RSCodec computes.
+ *
+ */
+struct RSKernel {
+  static constexpr int MAX_BATCH = 8;   // Codewords one encode_batch() call advances together
+
+  const char* name;     // e.g., "m10_t4"
+
+  /**
+   * @brief    Same contract as RSCodec::encode().
+   *
+   */
+  void (*encode)(std::span<const uint8_t> data, std::span<uint8_t> parity);
+
+  /**
+   * @brief    encode() of count (1 to MAX_BATCH) codewords of the same data size, interleaved.
+   *
+   * @details
+   * The LFSRs of the codewords advance in lockstep, one data symbol of every codeword per step, so the table
+   * lookups of independent codewords overlap instead of waiting on the single dependency chain of one LFSR.
+   */
+  void (*encode_batch)(const std::span<const uint8_t>* data, const std::span<uint8_t>* parity, int count);
+
+  /**
+   * @brief    Whether all 2t syndromes of the codeword are zero, evaluated in a single pass over the data.
+   *
+   */
+  bool (*is_clean)(std::span<const uint8_t> data, std::span<const uint8_t> parity);
+
+  /**
+   * @brief    Kernel for (m, t) from the registry of common geometries, or nullptr if there is none.
+   *
+   * @details
+   * The registry covers the RS symbol widths of 128B, 256B, 512B, 1KB and 4KB blocks (m = 8, 9, 10, 11, 13) with
+   * t = 1..8 and 16.
+   */
+  static const RSKernel* find(int m, int t);
+};
+
+
+/**
+ * @brief    BCH LFSR remainder specialized at compile time for a remainder of a fixed number of 64-bit words.
+ *
+ * @details
+ * Same slicing-by-8 division as BCHCodec, with the remainder in a stack array and the word loops unrolled.
+ *
+ */
+struct BCHKernel {
+  static constexpr int MAX_BATCH = 8;   // Codewords one remainder_batch() call advances together
+
+  const char* name;     // e.g., "w2"
+
+  /**
+   * @brief    Same contract as BCHCodec::remainder(), over the codec's byte tables (8 x 256 rows of words words).
+   *
+   */
+  void (*remainder)(const uint64_t* tables, std::span<const uint8_t> data, uint64_t* rem);
+
+  /**
+   * @brief    remainder() of count (1 to MAX_BATCH) codewords of the same data size, interleaved as in
+   *           RSKernel::encode_batch(). The remainder of codeword i is left at rems + i * words.
+   *
+   */
+  void (*remainder_batch)(const uint64_t* tables, const std::span<const uint8_t>* data, uint64_t* rems, int count);
+
+  /**
+   * @brief    Kernel for remainders of the given number of words (1 to 8, i.e., up to 512 parity bits) or nullptr.
+   *
+   */
+  static const BCHKernel* find(int words);
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_CODEC_KERNELS_H_
@@ -0,0 +1,132 @@
+#include "dram_controller/impl/plugin/ecc/codec_worker_pool.h"
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+CodecWorkerPool::CodecWorkerPool(int num_threads, size_t queue_size, int max_batch, Handler handler):
+m_handler(std::move(handler)), m_max_batch(max_batch) {
+  if (num_threads < 1) {
+    throw ConfigurationError("ECCPlugin: The codec worker pool needs at least one thread (got {})!", num_threads);
+  }
+  if (queue_size < 2 || (queue_size & (queue_size - 1)) != 0) {
+    throw ConfigurationError("ECCPlugin: The codec queue size must be a power of two (got {})!", queue_size);
+  }
+  if (max_batch < 1) {
+    throw ConfigurationError("ECCPlugin: Codec workers need to take at least one job at a time (got {})!", max_batch);
+  }
+
+  m_cells = std::make_unique<Cell[]>(queue_size);
+  m_mask = queue_size - 1;
+  for (size_t i = 0; i < queue_size; i++) {
+    m_cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  m_workers.reserve(num_threads);
+  for (int i = 0; i < num_threads; i++) {
+    m_workers.emplace_back(&CodecWorkerPool::worker_loop, this);
+  }
+}
+
+CodecWorkerPool::~CodecWorkerPool() {
+  drain();
+  m_stop.store(true);
+  m_epoch.fetch_add(1);
+  m_epoch.notify_all();
+  for (std::thread& worker : m_workers) {
+    worker.join();
+  }
+}
+
+bool CodecWorkerPool::submit(CodecJob& job) {
+  Cell& cell = m_cells[m_enqueue_pos & m_mask];
+  if (cell.sequence.load(std::memory_order_acquire) != m_enqueue_pos) {
+    // The cell still holds a job that no worker has picked up yet
+    return false;
+  }
+
+  job.cw.header->flags |= PENDING;
+  cell.job = std::move(job);
+  cell.sequence.store(m_enqueue_pos + 1, std::memory_order_release);
+  m_enqueue_pos++;
+  m_submitted++;
+
+  m_epoch.fetch_add(1, std::memory_order_release);
+  m_epoch.notify_one();
+  return true;
+}
+
+void CodecWorkerPool::drain() {
+  uint32_t completed = m_completed.load(std::memory_order_acquire);
+  while (completed != m_submitted) {
+    m_completed.wait(completed, std::memory_order_acquire);
+    completed = m_completed.load(std::memory_order_acquire);
+  }
+}
+
+bool CodecWorkerPool::wait_for(const CodewordStore::Codeword& cw) {
+  std::atomic_ref<uint16_t> flags(cw.header->flags);
+  uint16_t value = flags.load(std::memory_order_acquire);
+  if (!(value & PENDING)) {
+    return false;
+  }
+  while (value & PENDING) {
+    flags.wait(value, std::memory_order_acquire);
+    value = flags.load(std::memory_order_acquire);
+  }
+  return true;
+}
+
+bool CodecWorkerPool::try_pop(CodecJob& job) {
+  size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+  while (true) {
+    Cell& cell = m_cells[pos & m_mask];
+    size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    intptr_t diff = (intptr_t) sequence - (intptr_t) (pos + 1);
+    if (diff == 0) {
+      if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        job = std::move(cell.job);
+        // Hand the cell back to the producer for its next lap around the ring
+        cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = m_dequeue_pos.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void CodecWorkerPool::worker_loop() {
+  std::vector<CodecJob> jobs(m_max_batch);
+  while (true) {
+    // Read the epoch before looking at the ring: a submit after the look changes it and wait() returns at once
+    uint32_t epoch = m_epoch.load(std::memory_order_acquire);
+    if (!try_pop(jobs[0])) {
+      if (m_stop.load()) {
+        return;
+      }
+      m_epoch.wait(epoch, std::memory_order_acquire);
+      continue;
+    }
+    // Take what else is queued right now, without waiting for more
+    int count = 1;
+    while (count < m_max_batch && try_pop(jobs[count])) {
+      count++;
+    }
+
+    m_handler(std::span<CodecJob>(jobs.data(), count));
+
+    for (int i = 0; i < count; i++) {
+      std::atomic_ref<uint16_t> flags(jobs[i].cw.header->flags);
+      flags.fetch_and((uint16_t) ~PENDING, std::memory_order_release);
+      flags.notify_all();
+    }
+
+    m_completed.fetch_add(count, std::memory_order_release);
+    m_completed.notify_all();
+  }
+}
+
+}       // namespace Ramulator
@@ -0,0 +1,107 @@
+#ifndef RAMULATOR_PLUGIN_ECC_CODEC_WORKER_POOL_H_
+#define RAMULATOR_PLUGIN_ECC_CODEC_WORKER_POOL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "dram_controller/impl/plugin/ecc/codeword_store.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    One functional ECC computation on a stored codeword.
+ *
+ */
+struct CodecJob {
+  enum class Kind {
+    Encode,     // Compute the ECC of [Data + EDC], then flip error_bits (errors hitting the stored codeword)
+    Decode,     // Correct the codeword and re-encode it on success, flip error_bits back on failure (faults of this read)
+  };
+
+  Kind kind = Kind::Encode;
+  CodewordStore::Codeword cw;
+  int policy = 0;                      // Protection policy of the codeword (an index of the owner's)
+  int ecc_size = 0;                    // ECC size picked for the codeword
+  std::vector<uint32_t> error_bits;    // Bit positions in [Data + EDC]
+};
+
+
+/**
+ * @brief    Worker threads that run codec jobs off the simulation thread.
+ *
+ * @details
+ * Jobs are handed over through a bounded lock-free ring (Vyukov's sequence-numbered queue) with a single
+ * producer, the simulation thread, and the workers as consumers. Idle workers sleep on an atomic counter
+ * (C++20 wait/notify). While a job is in flight its codeword carries the PENDING header flag; the producer
+ * calls wait_for() before touching a codeword again, so the jobs of one codeword run in submission order.
+ * A worker takes up to max_batch queued jobs at once and hands them to the handler together (e.g., to encode
+ * them with a batch kernel); a batch never holds two jobs of one codeword since those are never queued together.
+ *
+ */
+class CodecWorkerPool {
+  public:
+    using Handler = std::function<void(std::span<CodecJob>)>;
+
+    static constexpr uint16_t PENDING = 1 << 15;   // CodewordStore::Header flag of codewords with a job in flight
+
+  private:
+    struct alignas(64) Cell {
+      std::atomic<size_t> sequence;
+      CodecJob job;
+    };
+
+    Handler m_handler;
+    int m_max_batch = 1;
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask = 0;
+
+    alignas(64) size_t m_enqueue_pos = 0;          // Only touched by the producer
+    alignas(64) std::atomic<size_t> m_dequeue_pos = 0;
+    alignas(64) std::atomic<uint32_t> m_epoch = 0;         // Bumped on every submit, workers sleep on it
+    alignas(64) std::atomic<uint32_t> m_completed = 0;     // Jobs finished (modulo 2^32)
+    uint32_t m_submitted = 0;
+    std::atomic<bool> m_stop = false;
+
+    std::vector<std::thread> m_workers;
+
+  public:
+    /**
+     * @param    queue_size     Capacity of the ring, must be a power of two.
+     * @param    max_batch      Jobs a worker takes from the ring at once.
+     */
+    CodecWorkerPool(int num_threads, size_t queue_size, int max_batch, Handler handler);
+    ~CodecWorkerPool();
+
+    /**
+     * @brief    Queues job (moving it out) and marks its codeword PENDING. Returns false if the ring is full.
+     *
+     */
+    bool submit(CodecJob& job);
+
+    /**
+     * @brief    Blocks until every submitted job has finished.
+     *
+     */
+    void drain();
+
+    /**
+     * @brief    Blocks until cw has no job in flight. Returns whether it had to wait.
+     *
+     */
+    static bool wait_for(const CodewordStore::Codeword& cw);
+
+    int num_threads() const { return m_workers.size(); };
+
+  private:
+    bool try_pop(CodecJob& job);
+    void worker_loop();
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_CODEC_WORKER_POOL_H_
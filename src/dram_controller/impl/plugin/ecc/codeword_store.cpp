@@ -0,0 +1,372 @@
+#include "dram_controller/impl/plugin/ecc/codeword_store.h"
+
+#include <cstring>
+#include <istream>
+#include <new>
+#include <ostream>
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+CodewordStore::CodewordStore(size_t data_size, size_t parity_capacity, size_t slab_size, bool dedup):
+m_data_size(data_size), m_parity_capacity(parity_capacity), m_dedup(dedup) {
+  size_t record_size = sizeof(Header) + data_size + parity_capacity;
+  size_t alignment = (data_size + parity_capacity == 0) ? alignof(Header) : RECORD_ALIGNMENT;
+  m_stride = (record_size + alignment - 1) / alignment * alignment;
+  m_records_per_slab = std::max<size_t>(1, slab_size / m_stride);
+
+  m_index.assign(1024, {0, EMPTY_SLOT});
+  m_index_mask = m_index.size() - 1;
+  if (m_dedup) {
+    m_content.assign(1024, {0, EMPTY_SLOT});
+    m_content_mask = m_content.size() - 1;
+  }
+}
+
+uint64_t CodewordStore::hash(Addr_t addr) {
+  // splitmix64 finalizer, cheap and scatters the low bits of aligned addresses well
+  uint64_t z = (uint64_t) addr;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+uint8_t* CodewordStore::record_ptr(uint32_t record) const {
+  return m_slabs[record / m_records_per_slab].get() + (record % m_records_per_slab) * m_stride;
+}
+
+CodewordStore::Codeword CodewordStore::make_view(uint32_t record) const {
+  uint8_t* p = record_ptr(record);
+  Codeword cw;
+  cw.header = reinterpret_cast<Header*>(p);
+  cw.data = p + sizeof(Header);
+  cw.parity = cw.data + m_data_size;
+  cw.data_size = m_data_size;
+  cw.parity_capacity = m_parity_capacity;
+  return cw;
+}
+
+size_t CodewordStore::find_slot(Addr_t addr) const {
+  for (size_t i = hash(addr) & m_index_mask;; i = (i + 1) & m_index_mask) {
+    const IndexEntry& e = m_index[i];
+    if (e.record == EMPTY_SLOT) {
+      return SIZE_MAX;
+    } else if (e.addr == addr) {
+      return i;
+    }
+  }
+}
+
+CodewordStore::Codeword CodewordStore::find(Addr_t addr) const {
+  size_t slot = find_slot(addr);
+  return (slot == SIZE_MAX) ? Codeword{} : make_view(m_index[slot].record);
+}
+
+CodewordStore::Codeword CodewordStore::find_mutable(Addr_t addr) {
+  size_t slot = find_slot(addr);
+  if (slot == SIZE_MAX) {
+    return {};
+  }
+  return make_view(m_dedup ? make_private(slot) : m_index[slot].record);
+}
+
+CodewordStore::Codeword CodewordStore::find_or_insert(Addr_t addr, bool& inserted) {
+  // Keep the load factor at or below 1/2 so that probe sequences stay short
+  if (2 * (m_num_addrs + 1) > m_index.size()) {
+    grow_index();
+  }
+
+  size_t i = hash(addr) & m_index_mask;
+  for (;; i = (i + 1) & m_index_mask) {
+    IndexEntry& e = m_index[i];
+    if (e.record == EMPTY_SLOT) {
+      break;
+    } else if (e.addr == addr) {
+      inserted = false;
+      return make_view(m_dedup ? make_private(i) : e.record);
+    }
+  }
+
+  uint32_t record = allocate_record();
+  m_index[i] = {addr, record};
+  m_num_addrs++;
+  inserted = true;
+  return make_view(record);
+}
+
+uint32_t CodewordStore::allocate_record() {
+  uint32_t record;
+  if (!m_free_records.empty()) {
+    record = m_free_records.back();
+    m_free_records.pop_back();
+  } else {
+    if (m_num_records >= EMPTY_SLOT) {
+      throw std::runtime_error("CodewordStore is full!");
+    }
+    record = m_num_records++;
+    if (record / m_records_per_slab >= m_slabs.size()) {
+      // aligned_alloc() needs a size that is a multiple of the alignment
+      size_t slab_bytes = (m_records_per_slab * m_stride + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+      void* slab = std::aligned_alloc(RECORD_ALIGNMENT, slab_bytes);
+      if (slab == nullptr) {
+        throw std::bad_alloc();
+      }
+      m_slabs.emplace_back(static_cast<uint8_t*>(slab));
+    }
+    if (m_dedup) {
+      m_refs.push_back(0);
+      m_sealed.push_back(0);
+    }
+  }
+  std::memset(record_ptr(record), 0, m_stride);
+  if (m_dedup) {
+    m_refs[record] = 1;
+  }
+  return record;
+}
+
+uint32_t CodewordStore::make_private(size_t slot) {
+  uint32_t record = m_index[slot].record;
+  if (!m_sealed[record]) {
+    return record;
+  }
+  if (m_refs[record] == 1) {
+    unlist(record);
+    return record;
+  }
+
+  // Copy-on-write: the other addresses keep the sealed record
+  uint32_t copy = allocate_record();
+  std::memcpy(record_ptr(copy), record_ptr(record), m_stride);
+  m_refs[record]--;
+  m_index[slot].record = copy;
+  return copy;
+}
+
+void CodewordStore::seal(Addr_t addr) {
+  if (!m_dedup) {
+    return;
+  }
+  size_t slot = find_slot(addr);
+  if (slot == SIZE_MAX || m_sealed[m_index[slot].record]) {
+    return;
+  }
+
+  uint32_t record = m_index[slot].record;
+  uint32_t shared = intern(record);
+  if (shared != record) {
+    // Share the identical record and recycle this one
+    m_refs[shared]++;
+    m_index[slot].record = shared;
+    m_refs[record] = 0;
+    m_free_records.push_back(record);
+    m_merges++;
+  }
+}
+
+uint32_t CodewordStore::intern(uint32_t record) {
+  // Returns the sealed record identical to record, or seals record itself
+  uint64_t h = content_hash(record);
+  size_t i = h & m_content_mask;
+  for (; m_content[i].record != EMPTY_SLOT; i = (i + 1) & m_content_mask) {
+    const ContentEntry& e = m_content[i];
+    if (e.hash == h && std::memcmp(record_ptr(e.record), record_ptr(record), m_stride) == 0) {
+      return e.record;
+    }
+  }
+
+  m_content[i] = {h, record};
+  m_sealed[record] = 1;
+  if (2 * ++m_num_sealed > m_content.size()) {
+    grow_content();
+  }
+  return record;
+}
+
+uint64_t CodewordStore::content_hash(uint32_t record) const {
+  // Records are zero-padded to a multiple of 8 bytes (RECORD_ALIGNMENT)
+  const uint8_t* p = record_ptr(record);
+  uint64_t h = 0x243F6A8885A308D3ull;
+  for (size_t i = 0; i < m_stride; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, p + i, 8);
+    h = (h ^ word) * 0x9E3779B97F4A7C15ull;
+    h ^= h >> 29;
+  }
+  return hash((Addr_t) h);
+}
+
+void CodewordStore::unlist(uint32_t record) {
+  // Backward-shift deletion keeps the linear probe sequences intact without tombstones
+  size_t i = content_hash(record) & m_content_mask;
+  while (m_content[i].record != record) {
+    i = (i + 1) & m_content_mask;
+  }
+  for (size_t j = (i + 1) & m_content_mask; m_content[j].record != EMPTY_SLOT; j = (j + 1) & m_content_mask) {
+    size_t home = m_content[j].hash & m_content_mask;
+    // Move entry j into the hole at i unless its home slot lies cyclically in (i, j]
+    bool stays = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+    if (!stays) {
+      m_content[i] = m_content[j];
+      i = j;
+    }
+  }
+  m_content[i] = {0, EMPTY_SLOT};
+  m_sealed[record] = 0;
+  m_num_sealed--;
+}
+
+void CodewordStore::grow_content() {
+  std::vector<ContentEntry> old_content(m_content.size() * 2, {0, EMPTY_SLOT});
+  old_content.swap(m_content);
+  m_content_mask = m_content.size() - 1;
+
+  for (const ContentEntry& e : old_content) {
+    if (e.record == EMPTY_SLOT) {
+      continue;
+    }
+    size_t i = e.hash & m_content_mask;
+    while (m_content[i].record != EMPTY_SLOT) {
+      i = (i + 1) & m_content_mask;
+    }
+    m_content[i] = e;
+  }
+}
+
+bool CodewordStore::next_addr(size_t& cursor, Addr_t& addr) const {
+  for (; cursor < m_index.size(); cursor++) {
+    if (m_index[cursor].record != EMPTY_SLOT) {
+      addr = m_index[cursor++].addr;
+      return true;
+    }
+  }
+  return false;
+}
+
+void CodewordStore::grow_index() {
+  std::vector<IndexEntry> old_index(m_index.size() * 2, {0, EMPTY_SLOT});
+  old_index.swap(m_index);
+  m_index_mask = m_index.size() - 1;
+
+  for (const IndexEntry& e : old_index) {
+    if (e.record == EMPTY_SLOT) {
+      continue;
+    }
+    size_t i = hash(e.addr) & m_index_mask;
+    while (m_index[i].record != EMPTY_SLOT) {
+      i = (i + 1) & m_index_mask;
+    }
+    m_index[i] = e;
+  }
+}
+
+void CodewordStore::save(std::ostream& out) const {
+  // Records are renumbered in the order the index first refers to them, so that shared ones are written once
+  std::vector<uint32_t> position(m_num_records, EMPTY_SLOT);
+  std::vector<uint32_t> order;
+  std::vector<ImageEntry> entries;
+  entries.reserve(m_num_addrs);
+  for (const IndexEntry& e : m_index) {
+    if (e.record == EMPTY_SLOT) {
+      continue;
+    }
+    if (position[e.record] == EMPTY_SLOT) {
+      position[e.record] = order.size();
+      order.push_back(e.record);
+    }
+    entries.push_back({(uint64_t) e.addr, position[e.record]});
+  }
+
+  ImageHeader header = {m_data_size, m_parity_capacity, m_stride, entries.size(), order.size()};
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(ImageEntry));
+
+  static const char padding[RECORD_ALIGNMENT] = {};
+  out.write(padding, (RECORD_ALIGNMENT - (size_t) out.tellp() % RECORD_ALIGNMENT) % RECORD_ALIGNMENT);
+  for (uint32_t record : order) {
+    out.write(reinterpret_cast<const char*>(record_ptr(record)), m_stride);
+  }
+}
+
+bool CodewordStore::load(std::istream& in) {
+  ImageHeader header;
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+      || header.data_size != m_data_size || header.parity_capacity != m_parity_capacity || header.stride != m_stride
+      || header.num_records > header.num_addrs || header.num_records >= EMPTY_SLOT) {
+    return false;
+  }
+  std::vector<ImageEntry> entries(header.num_addrs);
+  if (!in.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(ImageEntry))) {
+    return false;
+  }
+  in.ignore((RECORD_ALIGNMENT - (size_t) in.tellg() % RECORD_ALIGNMENT) % RECORD_ALIGNMENT);
+
+  release();
+  for (size_t i = 0; i < header.num_records; i++) {
+    uint32_t record = allocate_record();
+    if (!in.read(reinterpret_cast<char*>(record_ptr(record)), m_stride)) {
+      release();
+      return false;
+    }
+  }
+
+  // Records of a section are distinct if a deduplicating store wrote it, but any store may load it
+  std::vector<uint32_t> shared(m_num_records);
+  for (uint32_t record = 0; record < m_num_records; record++) {
+    shared[record] = m_dedup ? intern(record) : record;
+    if (shared[record] != record) {
+      m_free_records.push_back(record);
+      m_merges++;
+    }
+  }
+  if (m_dedup) {
+    std::fill(m_refs.begin(), m_refs.end(), 0);
+  }
+
+  for (const ImageEntry& entry : entries) {
+    if (entry.record >= m_num_records) {
+      release();
+      return false;
+    }
+    if (2 * (m_num_addrs + 1) > m_index.size()) {
+      grow_index();
+    }
+    size_t i = hash(entry.addr) & m_index_mask;
+    while (m_index[i].record != EMPTY_SLOT) {
+      i = (i + 1) & m_index_mask;
+    }
+    m_index[i] = {(Addr_t) entry.addr, shared[entry.record]};
+    m_num_addrs++;
+    if (m_dedup) {
+      m_refs[shared[entry.record]]++;
+    }
+  }
+  return true;
+}
+
+size_t CodewordStore::memory_footprint() const {
+  return m_slabs.size() * m_records_per_slab * m_stride + m_index.size() * sizeof(IndexEntry)
+       + m_refs.size() * sizeof(uint32_t) + m_sealed.size() + m_content.size() * sizeof(ContentEntry) + m_free_records.size() * sizeof(uint32_t);
+}
+
+void CodewordStore::release() {
+  m_slabs.clear();
+  m_slabs.shrink_to_fit();
+  m_num_records = 0;
+  m_num_addrs = 0;
+  std::vector<uint32_t>().swap(m_free_records);
+
+  std::vector<IndexEntry>(1024, {0, EMPTY_SLOT}).swap(m_index);
+  m_index_mask = m_index.size() - 1;
+
+  if (m_dedup) {
+    std::vector<uint32_t>().swap(m_refs);
+    std::vector<uint8_t>().swap(m_sealed);
+    std::vector<ContentEntry>(1024, {0, EMPTY_SLOT}).swap(m_content);
+    m_content_mask = m_content.size() - 1;
+    m_num_sealed = 0;
+  }
+}
+
+}       // namespace Ramulator
@@ -0,0 +1,213 @@
+#ifndef RAMULATOR_PLUGIN_ECC_CODEWORD_STORE_H_
+#define RAMULATOR_PLUGIN_ECC_CODEWORD_STORE_H_
+
+#include <cstdint>
+#include <cstdlib>
+#include <iosfwd>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "base/type.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Fixed-stride, arena-backed storage of ECC codewords.
+ *
+ * @details
+ * Every codeword is one cache-line-aligned record holding [header | Data + EDC | parity], so the data
+ * and parity of an address share a single allocation instead of two hash-map nodes and two vectors.
+ * Records are carved out of large slabs and located through an open-addressing (linear probing) index
+ * from address to record number. Records are never freed individually; release() drops all slabs at once.
+ * A store with neither data nor parity keeps only the headers, packed back to back (metadata-only use).
+ *
+ * A deduplicating store lets addresses with identical records share one refcounted record. The owner seals a
+ * record once it is final: its bytes are hashed (64 bits, one multiply per word) into a content table and, if an
+ * identical sealed record exists, the address is pointed at it and its own record is recycled. Sealed records are
+ * read-only; find_mutable() and find_or_insert() hand out a private copy (copy-on-write). Zero-filled blocks all
+ * encode to the same record, so any number of them costs one record.
+ *
+ * save() and load() write and read the whole store as one section of a binary image: a geometry header, the
+ * (address, record) index and the records in native byte order at their stride, from a 64-byte aligned offset
+ * of the file, so that the section can also be memory-mapped as it is.
+ *
+ */
+class CodewordStore {
+  public:
+    static constexpr size_t RECORD_ALIGNMENT = 64;
+
+    struct Header {
+      uint32_t parity_size = 0;   // Bytes of parity currently stored
+      uint16_t flags = 0;         // Free for the owner of the store
+      uint16_t error_count = 0;   // Free for the owner of the store
+    };
+
+    /**
+     * @brief    A view of one record. Evaluates to false if no record was found.
+     *
+     */
+    struct Codeword {
+      Header* header = nullptr;
+      uint8_t* data = nullptr;      // [Data + EDC], data_size() bytes
+      uint8_t* parity = nullptr;    // parity_capacity() bytes
+
+      size_t data_size = 0;
+      size_t parity_capacity = 0;
+
+      explicit operator bool() const { return header != nullptr; };
+
+      std::span<uint8_t> data_span() const { return {data, data_size}; };
+      std::span<uint8_t> parity_span() const { return {parity, header->parity_size}; };
+      std::span<uint8_t> parity_buffer() const { return {parity, parity_capacity}; };
+    };
+
+  private:
+    struct SlabDeleter {
+      void operator()(uint8_t* p) const { std::free(p); };
+    };
+
+    static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+    struct IndexEntry {
+      Addr_t addr;
+      uint32_t record;
+    };
+
+    struct ContentEntry {
+      uint64_t hash;
+      uint32_t record;
+    };
+
+    struct ImageHeader {
+      uint64_t data_size;
+      uint64_t parity_capacity;
+      uint64_t stride;
+      uint64_t num_addrs;
+      uint64_t num_records;
+    };
+
+    struct ImageEntry {
+      uint64_t addr;
+      uint64_t record;    // Position of the record in the section
+    };
+
+    size_t m_data_size;
+    size_t m_parity_capacity;
+    size_t m_stride;
+    size_t m_records_per_slab;
+
+    std::vector<std::unique_ptr<uint8_t, SlabDeleter>> m_slabs;
+    size_t m_num_records = 0;             // Records carved out of the slabs so far
+    size_t m_num_addrs = 0;
+    std::vector<uint32_t> m_free_records;   // Records released by deduplication, reused first
+
+    std::vector<IndexEntry> m_index;    // Power-of-two sized open-addressing table
+    size_t m_index_mask = 0;
+
+    bool m_dedup = false;
+    std::vector<uint32_t> m_refs;           // Addresses pointing at every record
+    std::vector<uint8_t> m_sealed;          // Whether every record is listed in the content table
+    std::vector<ContentEntry> m_content;    // Power-of-two sized open-addressing table from hash to sealed record
+    size_t m_content_mask = 0;
+    size_t m_num_sealed = 0;
+    size_t m_merges = 0;                    // Seals that found an identical record
+
+  public:
+    /**
+     * @param    data_size          Bytes of [Data + EDC] per codeword.
+     * @param    parity_capacity    Maximum bytes of parity per codeword.
+     * @param    slab_size          Approximate size of one arena slab in bytes.
+     * @param    dedup              Share records with identical contents between addresses.
+     */
+    CodewordStore(size_t data_size, size_t parity_capacity, size_t slab_size = 4 << 20, bool dedup = false);
+
+    /**
+     * @brief    Returns the record of addr, or an empty Codeword if it is not stored.
+     *
+     * @details  In a deduplicating store the record may be shared and must not be modified, see find_mutable().
+     */
+    Codeword find(Addr_t addr) const;
+
+    /**
+     * @brief    Returns a record of addr that may be modified, or an empty Codeword if it is not stored.
+     *
+     * @details  A sealed record is unsealed first, and copied if other addresses share it.
+     */
+    Codeword find_mutable(Addr_t addr);
+
+    /**
+     * @brief    Returns a record of addr that may be modified, creating a zero-filled one if needed.
+     *
+     * @param    inserted     Set to whether a new record was created.
+     */
+    Codeword find_or_insert(Addr_t addr, bool& inserted);
+
+    /**
+     * @brief    Marks the record of addr final: a deduplicating store shares it with an identical sealed record.
+     *           No-op in other stores.
+     *
+     */
+    void seal(Addr_t addr);
+
+    /**
+     * @brief    Walks the stored addresses in index order: finds the first record at or after the index slot cursor.
+     *
+     * @return   false    No record at or after cursor. Otherwise addr is set and cursor points past its slot.
+     *                    The order changes when the index grows, so a walk may visit a record twice or skip it.
+     */
+    bool next_addr(size_t& cursor, Addr_t& addr) const;
+
+    /**
+     * @brief    Writes every stored codeword as one image section. Shared records are written once.
+     *
+     */
+    void save(std::ostream& out) const;
+
+    /**
+     * @brief    Replaces the contents of the store with an image section written by save().
+     *
+     * @details  A deduplicating store shares the identical records of the section, whichever store wrote it.
+     * @return   false    The section was written by a store of another geometry, or is truncated.
+     */
+    bool load(std::istream& in);
+
+    bool contains(Addr_t addr) const { return (bool) find(addr); };
+    size_t size() const { return m_num_addrs; };
+    size_t records() const { return m_num_records - m_free_records.size(); };   // Distinct records in use
+    size_t merges() const { return m_merges; };
+    bool dedup() const { return m_dedup; };
+    size_t stride() const { return m_stride; };
+    size_t data_size() const { return m_data_size; };
+    size_t parity_capacity() const { return m_parity_capacity; };
+
+    /**
+     * @brief    Bytes currently held by the slabs and the index.
+     *
+     */
+    size_t memory_footprint() const;
+
+    /**
+     * @brief    Drops every record and returns all memory at once.
+     *
+     */
+    void release();
+
+  private:
+    static uint64_t hash(Addr_t addr);
+    uint8_t* record_ptr(uint32_t record) const;
+    Codeword make_view(uint32_t record) const;
+    size_t find_slot(Addr_t addr) const;
+    void grow_index();
+
+    uint32_t allocate_record();
+    uint32_t make_private(size_t slot);
+    uint32_t intern(uint32_t record);
+    uint64_t content_hash(uint32_t record) const;
+    void unlist(uint32_t record);
+    void grow_content();
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_CODEWORD_STORE_H_
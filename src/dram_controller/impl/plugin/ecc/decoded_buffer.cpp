@@ -0,0 +1,47 @@
+#include "dram_controller/impl/plugin/ecc/decoded_buffer.h"
+
+#include <algorithm>
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+DecodedBuffer::DecodedBuffer(int num_entries) {
+  if (num_entries < 1) {
+    throw ConfigurationError("ECCPlugin: The decoded codeword buffer needs at least one entry (got {})!", num_entries);
+  }
+  m_capacity = num_entries;
+  m_entries.reserve(m_capacity);
+}
+
+bool DecodedBuffer::lookup(Addr_t codeword) {
+  auto it = std::find(m_entries.begin(), m_entries.end(), codeword);
+  if (it == m_entries.end()) {
+    return false;
+  }
+  // Move the entry to the most-recently-used position
+  std::move(it + 1, m_entries.end(), it);
+  m_entries.back() = codeword;
+  return true;
+}
+
+void DecodedBuffer::insert(Addr_t codeword) {
+  if (lookup(codeword)) {
+    return;
+  }
+  if (m_entries.size() == m_capacity) {
+    m_entries.erase(m_entries.begin());
+  }
+  m_entries.push_back(codeword);
+}
+
+bool DecodedBuffer::invalidate(Addr_t codeword) {
+  auto it = std::find(m_entries.begin(), m_entries.end(), codeword);
+  if (it == m_entries.end()) {
+    return false;
+  }
+  m_entries.erase(it);
+  return true;
+}
+
+}       // namespace Ramulator
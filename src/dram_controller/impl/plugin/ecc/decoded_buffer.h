@@ -0,0 +1,52 @@
+#ifndef RAMULATOR_PLUGIN_ECC_DECODED_BUFFER_H_
+#define RAMULATOR_PLUGIN_ECC_DECODED_BUFFER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "base/type.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Fully-associative, LRU buffer of the codewords the ECC decoder has just assembled and corrected.
+ *
+ * @details
+ * Tags only (no data). The entries are kept in recency order with the least-recently-used one first, as in
+ * ParityCache; the buffer is small, so lookups scan all of them. Writes to a codeword invalidate its entry.
+ *
+ */
+class DecodedBuffer {
+  private:
+    std::vector<Addr_t> m_entries;    // Valid codeword addresses, LRU first
+    size_t m_capacity = 0;
+
+  public:
+    DecodedBuffer() {};
+    explicit DecodedBuffer(int num_entries);
+
+    bool enabled() const { return m_capacity > 0; };
+    size_t size() const { return m_entries.size(); };
+
+    /**
+     * @brief    Returns whether codeword is buffered and makes it the most-recently-used entry if it is.
+     *
+     */
+    bool lookup(Addr_t codeword);
+
+    /**
+     * @brief    Buffers codeword as the most-recently-used entry, evicting the LRU entry of a full buffer.
+     *
+     */
+    void insert(Addr_t codeword);
+
+    /**
+     * @brief    Drops codeword. Returns whether it was buffered.
+     *
+     */
+    bool invalidate(Addr_t codeword);
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_DECODED_BUFFER_H_
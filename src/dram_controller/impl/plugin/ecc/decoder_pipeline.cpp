@@ -0,0 +1,96 @@
+#include "dram_controller/impl/plugin/ecc/decoder_pipeline.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+DecoderPipeline::DecoderPipeline(int num_lanes, Clk_t depth, Clk_t initiation_interval, Clk_t edc_latency):
+m_num_lanes(num_lanes), m_depth(depth), m_initiation_interval(initiation_interval), m_edc_latency(edc_latency) {
+  if (num_lanes < 1 || depth < 1 || initiation_interval < 1 || edc_latency < 0) {
+    throw ConfigurationError("Invalid ECC decoder pipeline ({} lanes, depth {}, initiation interval {}, EDC latency {})!",
+                             num_lanes, depth, initiation_interval, edc_latency);
+  }
+  m_lane_next_issue.resize(num_lanes, 0);
+  m_latency_histogram.resize(4096 + 1, 0);
+}
+
+void DecoderPipeline::push(const Request& req, Clk_t clk) {
+  if (req.scratchpad[SCRATCHPAD_IDX] == FULL_DECODE) {
+    s_slow_path_reads++;
+    m_waiting.push_back({clk, 0, req});
+  } else {
+    s_fast_path_reads++;
+    m_fast_path.push_back({clk, clk + m_edc_latency, req});
+  }
+}
+
+void DecoderPipeline::tick(Clk_t clk) {
+  // Start waiting codewords on the lanes that can accept one this cycle
+  for (int lane = 0; lane < m_num_lanes && !m_waiting.empty(); lane++) {
+    if (m_lane_next_issue[lane] <= clk) {
+      Job& job = m_waiting.front();
+      job.done = clk + m_depth;
+      m_lane_next_issue[lane] = clk + m_initiation_interval;
+      m_slow_path.push_back(std::move(job));
+      m_waiting.pop_front();
+    }
+  }
+
+  s_stall_cycles += !m_waiting.empty();
+  s_queue_len += m_waiting.size();
+  s_busy_slots += m_slow_path.size();
+
+  while (!m_fast_path.empty() && m_fast_path.front().done <= clk) {
+    finish(m_fast_path.front(), clk);
+    m_fast_path.pop_front();
+  }
+  while (!m_slow_path.empty() && m_slow_path.front().done <= clk) {
+    finish(m_slow_path.front(), clk);
+    m_slow_path.pop_front();
+  }
+}
+
+void DecoderPipeline::finish(Job& job, Clk_t clk) {
+  size_t added = clk - job.enter;
+  s_added_latency += added;
+  s_max_added_latency = std::max(s_max_added_latency, added);
+  m_latency_histogram[std::min(added, m_latency_histogram.size() - 1)]++;
+
+  if (on_finish) {
+    on_finish(job.req);
+  }
+  if (job.req.callback) {
+    job.req.callback(job.req);
+  }
+}
+
+float DecoderPipeline::occupancy(Clk_t num_cycles) const {
+  // Every lane holds up to ceil(depth / initiation_interval) codewords at once
+  size_t slots_per_lane = (m_depth + m_initiation_interval - 1) / m_initiation_interval;
+  if (num_cycles <= 0 || m_num_lanes == 0) {
+    return 0.0f;
+  }
+  return (float) s_busy_slots / ((float) num_cycles * m_num_lanes * slots_per_lane);
+}
+
+size_t DecoderPipeline::latency_quantile(double q) const {
+  size_t total = s_fast_path_reads + s_slow_path_reads - size();
+  if (total == 0) {
+    return 0;
+  }
+  // Smallest latency with at least q of the finished reads at or below it
+  size_t rank = (size_t) std::ceil(q * total);
+  size_t seen = 0;
+  for (size_t latency = 0; latency < m_latency_histogram.size(); latency++) {
+    seen += m_latency_histogram[latency];
+    if (seen >= rank) {
+      return (latency == m_latency_histogram.size() - 1) ? s_max_added_latency : latency;
+    }
+  }
+  return s_max_added_latency;
+}
+
+}       // namespace Ramulator
@@ -0,0 +1,95 @@
+#ifndef RAMULATOR_PLUGIN_ECC_DECODER_PIPELINE_H_
+#define RAMULATOR_PLUGIN_ECC_DECODER_PIPELINE_H_
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "base/request.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Latency model of the ECC decoder that sits between the DRAM read data and the requester.
+ *
+ * @details
+ * Reads whose EDC check passes take the fast path (a fixed EDC latency). Reads that need a full decode are
+ * marked in their scratchpad (see FULL_DECODE, set by ECCPlugin) and take the slow path: they wait for one of
+ * the pipelined decoder lanes, which accepts a new codeword every initiation_interval cycles and finishes it
+ * depth cycles later. The callback of a request is called when it leaves the decoder.
+ *
+ */
+class DecoderPipeline {
+  public:
+    static constexpr int SCRATCHPAD_IDX = 2;   // Request::scratchpad slot holding the decode path of a read
+    static constexpr int FULL_DECODE = 1;      // The read failed its EDC check and needs the full decoder
+
+  private:
+    struct Job {
+      Clk_t enter = 0;       // Cycle the read data reached the decoder
+      Clk_t done = 0;        // Cycle the decoder finishes the request
+      Request req;
+    };
+
+    int m_num_lanes = 0;
+    Clk_t m_depth = 0;
+    Clk_t m_initiation_interval = 1;
+    Clk_t m_edc_latency = 0;
+
+    std::vector<Clk_t> m_lane_next_issue;   // First cycle every lane can accept a new codeword
+    std::deque<Job> m_waiting;              // Slow-path reads waiting for a lane
+    std::deque<Job> m_fast_path;            // Both paths finish in the order they started (fixed latencies)
+    std::deque<Job> m_slow_path;
+
+    std::vector<size_t> m_latency_histogram;   // Added latency in cycles, the last bucket collects the overflow
+
+  public:
+    RequestCallback on_finish;               // Called with every request that leaves the decoder, before its callback
+
+    size_t s_fast_path_reads = 0;
+    size_t s_slow_path_reads = 0;
+    size_t s_stall_cycles = 0;               // Cycles with slow-path reads waiting for a lane
+    size_t s_busy_slots = 0;                 // Sum over cycles of in-flight slow-path codewords
+    size_t s_queue_len = 0;                  // Sum over cycles of waiting slow-path reads
+    size_t s_added_latency = 0;              // Total latency added by the decoder
+    size_t s_max_added_latency = 0;
+
+  public:
+    DecoderPipeline() {};
+    DecoderPipeline(int num_lanes, Clk_t depth, Clk_t initiation_interval, Clk_t edc_latency);
+
+    bool enabled() const { return m_num_lanes > 0; };
+
+    /**
+     * @brief    Hands the read data of req to the decoder at clk.
+     *
+     */
+    void push(const Request& req, Clk_t clk);
+
+    /**
+     * @brief    Starts waiting reads on free lanes and calls the callbacks of the reads that finished by clk.
+     *
+     */
+    void tick(Clk_t clk);
+
+    /**
+     * @brief    Average fraction of the slow-path pipeline slots in use over num_cycles cycles.
+     *
+     */
+    float occupancy(Clk_t num_cycles) const;
+
+    /**
+     * @brief    The q-quantile (e.g., 0.99) of the latency added by the decoder, in cycles.
+     *
+     */
+    size_t latency_quantile(double q) const;
+
+    size_t size() const { return m_waiting.size() + m_fast_path.size() + m_slow_path.size(); };
+
+  private:
+    void finish(Job& job, Clk_t clk);
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_DECODER_PIPELINE_H_
@@ -0,0 +1,2704 @@
+#include <vector>
+#include <unordered_map>
+#include <limits>
+#include <random>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <deque>
+#include <atomic>
+#include <bit>
+
+#include "base/base.h"
+#include "base/serialization.h"
+#include "addr_mapper/addr_mapper.h"
+#include "dram_controller/controller.h"
+#include "dram_controller/plugin.h"
+#include "dram_controller/impl/plugin/ecc/ecc.h"
+#include "dram/odecc.h"
+#include "memory_system/memory_system.h"
+
+// For EDC computation (CRC/checksum kernels selected at runtime)
+#include "dram_controller/impl/plugin/ecc/edc_engine.h"
+
+// For RS ECC computation 
+#include "dram_controller/impl/plugin/ecc/rs_codec.h"
+
+// For BCH ECC computation
+#include "dram_controller/impl/plugin/ecc/bch_codec.h"
+
+// For bit error injection
+#include "dram_controller/impl/plugin/ecc/error_injector.h"
+#include "dram_controller/impl/plugin/ecc/fault_map.h"
+
+// For codeword storage
+#include "dram_controller/impl/plugin/ecc/codeword_store.h"
+
+// For parity traffic
+#include "dram_controller/impl/plugin/ecc/parity_layout.h"
+#include "dram_controller/impl/plugin/ecc/parity_cache.h"
+
+// For write combining
+#include "dram_controller/impl/plugin/ecc/write_combiner.h"
+
+// For the decode path of reads in the controller's decoder stage
+#include "dram_controller/impl/plugin/ecc/decoder_pipeline.h"
+
+// For running the functional codecs off the simulation thread
+#include "dram_controller/impl/plugin/ecc/codec_worker_pool.h"
+
+// For per-address-range protection
+#include "dram_controller/impl/plugin/ecc/protection_policy.h"
+
+// For serving reads from the codewords the decoder just assembled
+#include "dram_controller/impl/plugin/ecc/decoded_buffer.h"
+
+// For idle-cycle patrol scrubbing
+#include "dram_controller/impl/plugin/ecc/patrol_scrubber.h"
+
+// For the binomial error model and the access histograms of the reliability estimator
+#include "dram_controller/impl/plugin/ecc/reliability_estimator.h"
+#include "dram_controller/impl/plugin/ecc/adaptive_strength.h"
+#include "dram_controller/impl/plugin/ecc/error_event_log.h"
+
+namespace Ramulator
+{
+
+  class ECCPlugin : public IControllerPlugin, public Implementation, public IECCPlugin, public Serializable<ECCPlugin>, public Checkpointable
+  {
+    RAMULATOR_REGISTER_IMPLEMENTATION(IControllerPlugin, ECCPlugin, "ECCPlugin", "This plugin adds large-size ECC/EDC emulation to Ramulator2 to evaluate memory reliability, bandwidth, and latency trade-offs in AI and HPC workloads.")
+  
+
+  private:
+    std::string ecc_type;  // ECC type
+    std::string edc_type;  // EDC type
+
+    // ECC/EDC library configuration
+    std::string m_edc_kernel;                  // Name of the kernel picked for the host CPU (default policy)
+    std::string m_ecc_kernel;                  // Name of the ECC codec kernel (default policy)
+    RSCodecCache m_rs_codecs;  // RS codecs keyed by (m, t), shared by all requests
+    BCHCodecCache m_bch_codecs;  // BCH codecs keyed by (m, t), shared by all requests
+
+    // Everything that depends on how an address is protected: the default policy (top-level parameters) and one
+    // policy per range of protection_policies, each with its own codeword geometry, codecs and storage
+    struct Protection
+    {
+      ProtectionPolicy policy;
+      std::unique_ptr<IEDCEngine> edc_engine;   // EDC engine for policy.edc_type
+      int rs_symbol_bits = 8;                   // RS symbol width m, sized so one codeword covers [Data + EDC]
+      int bch_field_bits = 0;                   // BCH field width m, sized so one codeword covers [Data + EDC]
+      int codeword_symbols = 0;                 // Number of 8-bit symbols in [Data + EDC]
+      int codeword_t = 0;                       // Number of symbol errors the ECC corrects
+      int dynamic_ecc_size = 0;                 // ECC size picked for the codeword, computed once
+      size_t codeword_parity_size = 0;          // Bytes of parity of one codeword
+      int weak_t = 0;                           // codeword_t of weak codewords, adaptive ecc_strength only
+      size_t weak_parity_size = 0;              // codeword_parity_size of weak codewords (0: EDC only)
+      double failure_prob = 0.0;                // P(more than codeword_t symbol errors)
+      std::vector<double> error_cdf;            // P(at most k symbol errors), timing mode only
+      int sectors_per_codeword = 1;             // RD/WR bursts per codeword
+      std::unique_ptr<CodewordStore> storage;   // [Data + EDC | ECC] records, one per address (metadata only in timing mode)
+      ParityLayout parity_layout;
+      AccessHistogram histogram;                // Reads per error epoch, access_histogram only
+      size_t saturated_reads = 0;               // Reads past CODEWORD_MAX_READS of one epoch
+
+      size_t s_reads = 0;
+      size_t s_writes = 0;
+      size_t s_edc_failures = 0;
+      size_t s_ecc_failures = 0;                // Updated by the codec workers
+      size_t s_ecc_size = 0;                    // Parity bytes written
+    };
+    std::vector<Protection> m_protections;      // The default policy comes first
+    ProtectionPolicyTable m_protection_table;
+    
+  protected:
+    IDRAM *m_dram = nullptr;
+
+    // Timing-only ("shadow") mode: codewords are reduced to metadata, errors are drawn from the binomial model
+    static constexpr uint16_t CODEWORD_VALID = 1 << 0;  // Codeword exists (written or materialized)
+    static constexpr uint16_t CODEWORD_DIRTY = 1 << 1;  // Codeword was written by a request
+    static constexpr int CODEWORD_READS_SHIFT = 2;      // The other flag bits count the reads since the errors were drawn
+    static constexpr uint16_t CODEWORD_MAX_READS = UINT16_MAX >> CODEWORD_READS_SHIFT;
+    std::string m_mode;                // functional or timing
+    bool m_timing_mode = false;
+    double m_symbol_error_prob = 0.0;  // Probability that an 8-bit symbol is corrupted
+    RandomStream m_timing_rng;         // Generator for the number of symbol errors per codeword
+
+    // Parity traffic: ECC reads/writes are issued to the controller so that they compete with demand requests
+    static constexpr int PARITY_TAG_IDX = 3;          // Request::scratchpad slot marking the plugin's own parity requests
+    static constexpr int PARITY_TAG = 0x45434350;     // "ECCP"
+    static constexpr int SCRUB_TAG = 0x45434353;      // "ECCS", same slot: the plugin's own scrub requests
+    bool m_parity_traffic = false;
+    bool m_parity_read_always = false;    // Fetch the parity on every read instead of only on EDC failures
+    bool m_parity_shared_queue = false;   // Use the read/write buffers instead of the priority buffer
+    int m_parity_region_rows = 0;
+    int m_parity_bank_offset = 0;
+    ParityCache m_parity_cache;             // Parity lines held in the controller, disabled if parity_cache_size is 0
+    size_t m_parity_cache_size = 0;
+    int m_parity_cache_ways = 8;
+    bool m_parity_cache_write_back = true;
+    std::deque<Request> m_parity_queue;     // Side-band queue of parity and scrub requests not yet accepted by the controller
+    std::vector<AddrVec_t> m_parity_lines;  // Scratch buffer for the parity lines of one codeword
+    std::vector<uint8_t> m_partial_parity;  // Scratch buffer for the parity deltas of a partial write
+    Clk_t m_clk = 0;
+    int m_RD_req_id = -1;
+    int m_WR_req_id = -1;
+    std::vector<bool> m_odecc_rmw_writes;   // Per command, the writes the on-die ECC read-modify-writes (empty without it)
+    int m_odecc_ecs_command = -1;
+    int m_odecc_rmw_latency = 0;
+
+    // Codeword fetches (codeword_fetch: edc_first): a read whose sector passes its EDC check returns right away. If it
+    // fails, the other sectors of the codeword are read from the same row and the read completes once the whole
+    // codeword is decoded
+    static constexpr int FETCH_TAG = 0x45434346;      // "ECCF", same slot: the plugin's own codeword fetch reads
+    struct CodewordFetch
+    {
+      Request demand{(Addr_t) -1, -1};  // The demand read, once its own data arrived
+      RequestCallback callback;         // Callback of the demand read, called after the codeword is decoded
+      Clk_t demand_done = 0;            // Cycle the data of the demand read arrived
+      int outstanding = 0;              // Reads of the codeword (the demand read included) still waiting for data
+    };
+    bool m_codeword_fetch = false;
+    int m_column_level = -1;
+    std::vector<CodewordFetch> m_fetches;   // Codewords being assembled, indexed by slot
+    std::vector<int> m_free_fetches;        // Unused slots of m_fetches
+
+    // Cross-channel redundancy: the memory system rebuilds the uncorrectable demand reads from the other channels
+    UncorrectableHandler m_uncorrectable_handler;   // Empty without redundancy
+    std::vector<RequestCallback> m_held_callbacks;  // Callbacks of the reads handed to it, indexed by slot
+    std::vector<int> m_free_held_callbacks;
+
+    // Decoded codeword buffer: reads of a codeword assembled by a codeword fetch are served from the controller
+    DecodedBuffer m_decoded_buffer;         // Disabled if decoded_buffer_entries is 0
+    Clk_t m_decoded_buffer_latency = 2;
+    std::deque<std::pair<Clk_t, Request>> m_served_reads;   // Reads served by the buffer, with their completion cycle
+
+    // Write combining: sector writes of a codeword are coalesced and encoded once when their entry is flushed
+    WriteCombiner m_write_combiner;         // Disabled if wc_entries is 0
+    std::vector<WriteCombiner::Flush> m_wc_flushes;
+    int m_wc_entries = 0;
+    Clk_t m_wc_timeout = 0;
+    float m_wc_watermark = 1.0f;
+    size_t m_access_bytes = 64;             // Bytes per RD/WR burst, the sector size of a codeword
+
+    // Patrol scrubbing: codewords are read back and corrected while the demand buffers are empty
+    PatrolScrubber m_scrubber;              // Disabled if scrub_interval is 0
+    IAddrMapper* m_addr_mapper = nullptr;
+    std::vector<const CodewordStore*> m_scrub_stores;   // Store of every policy, in policy order
+    size_t s_scrub_read_reqs = 0;        // Scrub reads issued to the controller
+    size_t s_scrub_write_reqs = 0;       // Write-backs of codewords corrected by the scrubber
+    size_t s_scrub_clean = 0;            // Scrubbed codewords that passed their EDC check
+    size_t s_scrub_corrected = 0;        // Scrubbed codewords whose errors were corrected before a demand read
+    size_t s_scrub_uncorrectable = 0;    // Scrubbed codewords the ECC could not correct
+
+    // Fault map: permanent row/column/bank/pin faults, sampled from FIT rates at setup. Unlike the random errors,
+    // they are not stored in the codewords but hit every read of the cells they cover, corrected or not
+    FaultMap::Config m_fault_config;
+    FaultMap m_fault_map;                   // Disabled if no fault_map is configured
+    int m_row_level = -1;
+    int m_bank_level = -1;
+    std::vector<uint32_t> m_fault_bits;     // Scratch buffer for the faulty bits of one codeword
+    size_t s_fault_map_bytes = 0;        // Memory held by the fault map
+    size_t s_fault_reads = 0;            // Reads of codewords with faulty cells
+    size_t s_fault_symbols = 0;          // Symbols corrupted by faults, over all these reads
+
+    // Error event log: every read (demand or scrub) that failed its EDC check, with where and when it happened and
+    // whether the ECC corrected it, as fixed-size binary records written by a background thread
+    std::string m_error_log_path;           // Empty if there is no log
+    size_t m_error_log_buffer_size = 0;
+    std::unique_ptr<ErrorEventLog::Writer> m_error_log;
+    size_t s_error_log_events = 0;
+    size_t s_error_log_stalls = 0;       // Times the log writer was behind by the whole ring
+
+    // Adaptive ECC strength (timing mode): regions whose reads rarely fail their EDC check get weak codewords,
+    // the others the strength of their policy. A codeword keeps the strength it was encoded with until its next
+    // write; its parity size tells which one it is
+    AdaptiveStrength m_adaptive;            // Disabled with ecc_strength: static
+    int m_adaptive_weak_ecc_size = 0;
+    size_t s_adaptive_weak_writes = 0;       // Codewords encoded with weak protection
+    size_t s_adaptive_strong_writes = 0;     // Codewords encoded with the strength of their policy
+    size_t s_adaptive_saved_ecc_bytes = 0;   // Parity bytes not written compared to the static policy
+    size_t s_adaptive_saved_parity_traffic = 0;  // Parity DRAM traffic not issued compared to the static policy
+
+    // Asynchronous codecs (functional mode): ECC encodes/decodes run on worker threads, the EDC stays inline
+    std::unique_ptr<CodecWorkerPool> m_codec_pool;  // Disabled if codec_threads is 0
+    CodecJob m_codec_job;                   // Scratch job of the simulation thread
+    int m_codec_threads = 0;
+    size_t m_codec_queue_size = 4096;
+
+    // Batch encodes (functional mode): the encodes of one write-combining flush, and the jobs a codec worker takes
+    // from its queue at once, go through the interleaved RS/BCH batch kernels
+    int m_codec_batch = 8;                  // Codewords per batch (1 = one at a time)
+    bool m_batch_encodes = false;           // store_codeword() queues its job in m_codec_batch_jobs
+    std::vector<CodecJob> m_codec_batch_jobs;
+    size_t m_num_batch_jobs = 0;
+    std::vector<std::pair<Protection*, Addr_t>> m_batch_seals;  // Codewords to seal once their batch is encoded
+
+    bool m_dedup_storage = false;           // Share the records of identical codewords (functional mode)
+    double m_zero_block_fraction = 0.0;     // Fraction of generated data blocks that are all zero
+
+    // Codeword image: saved at the end of a (warmup) run, restored at init() by the runs it seeds
+    static constexpr uint64_t IMAGE_MAGIC = 0x31304547414D4945;    // "EIMAGE01"
+    bool m_serialize = false;
+    std::string m_serialization_filename;
+    bool m_deserialize = false;
+    std::string m_deserialization_filename;
+
+    // Access histogram (timing mode): one run gives the expected counters of any BER to the reliability estimator
+    bool m_access_histogram = false;
+    std::string m_access_histogram_filename;
+
+    // Configuration parameters
+    size_t DATA_BLOCK_SIZE;  // Data block size
+    size_t EDC_SIZE;         // EDC size
+    size_t ECC_SIZE;         // ECC size
+    double bit_error_rate;   // Bit Error Rate (BER)
+    double max_failure_prob; // Maximum allowed failure probability
+    bool m_act_prefetch;     // Whether to run the ACT-time prefetch hook
+    uint64_t m_error_seed;   // Seed of the error injection and payload generators
+    // The streams of the random number generator I draw from
+    static constexpr uint64_t RNG_STREAM_ERRORS = 0;
+    static constexpr uint64_t RNG_STREAM_PAYLOADS = 1;
+    static constexpr uint64_t RNG_STREAM_TIMING = 2;
+    static constexpr uint64_t RNG_STREAM_FAULTS = 3;
+
+    BitErrorInjector m_error_injector;  // Geometric skip-sampling bit error injector
+    RandomStream m_data_rng;            // Generator for payloads of requests without data
+
+    // Performance parameters
+    // TODO: Needs more accurate estimation
+    double BUS_BW_GBs = 512.0;     // 512 GB/s HBM
+    double MEM_RD_BW_GBs = 512.0;  // 512 GB/s
+    double MEM_WR_BW_GBs = 512.0;  // 512 GB/s
+    double EDC_COMPUTE_PER_BYTE_NS = 0.01;
+    double ECC_COMPUTE_PER_BYTE_NS = 0.02;
+
+    // Statistics variables
+    size_t total_ecc_size = 0;      // Total ECC memory usage (in bytes)
+    size_t total_edc_size = 0;      // Total EDC memory usage (in bytes)
+    size_t edc_success_count = 0;   // Number of successful EDC checks
+    size_t edc_failure_count = 0;   // Number of failed EDC checks
+    size_t ecc_success_count = 0;   // Number of successful ECC corrections
+    size_t ecc_failure_count = 0;   // Number of failed ECC corrections
+    float s_ecc_failures_per_gb = 0;       // ECC failures per GB of demand reads
+    float s_parity_bytes_per_request = 0;  // Parity DRAM traffic per demand request
+    size_t injected_bit_errors = 0;   // Number of bits flipped by the error injector
+    size_t storage_footprint_bytes = 0;  // Memory held by the codeword store at the end of the simulation
+    size_t storage_codewords = 0;        // Codewords stored at the end of the simulation
+    size_t storage_records = 0;          // Distinct records holding them (fewer than the codewords with dedup_storage)
+    size_t storage_dedup_merges = 0;     // Codewords that found an identical record to share
+    size_t s_restored_codewords = 0;     // Codewords loaded from the codeword image at init()
+    size_t act_prefetch_count = 0;       // Number of read ACTs seen by the ACT-time prefetch hook
+    size_t act_prefetch_fill_count = 0;  // Number of codewords staged by the ACT-time prefetch hook
+    size_t s_parity_read_reqs = 0;       // Number of parity reads issued to the controller
+    size_t s_parity_write_reqs = 0;      // Number of parity writes issued to the controller
+    size_t s_parity_read_latency = 0;    // Total latency of the parity reads (in cycles)
+    float s_avg_parity_read_latency = 0;
+    size_t s_parity_queue_max_len = 0;   // Peak occupancy of the side-band parity queue
+    size_t s_parity_dram_accesses = 0;   // Parity reads/writes that reached their RD/WR command
+    size_t s_parity_activations = 0;     // Rows opened for parity requests
+    float s_parity_row_hit_rate = 0;     // Parity accesses that found their row open
+    size_t s_parity_cache_read_hits = 0;
+    size_t s_parity_cache_read_misses = 0;
+    size_t s_parity_cache_write_hits = 0;
+    size_t s_parity_cache_write_misses = 0;
+    size_t s_parity_cache_evictions = 0;
+    size_t s_parity_cache_writebacks = 0;
+    float s_parity_cache_hit_rate = 0;
+    size_t s_wc_writes = 0;              // Writes absorbed by the write-combining buffer
+    size_t s_wc_flushes = 0;             // Codeword encodes caused by write-combining flushes
+    size_t s_wc_full_flushes = 0;        // Flushes that wrote a whole codeword
+    size_t s_wc_rmw_count = 0;           // Flushes that needed a read-modify-write of the codeword
+    size_t s_wc_eviction_flushes = 0;
+    size_t s_wc_timeout_flushes = 0;
+    size_t s_wc_watermark_flushes = 0;
+    float s_wc_coalescing_ratio = 0;     // Writes per flush
+    size_t s_parity_cache_saved_bytes = 0;  // DRAM traffic the parity cache absorbed, net of write-backs
+    size_t s_codec_async_jobs = 0;       // Codec jobs run by the worker threads
+    size_t s_codec_inline_jobs = 0;      // Codec jobs run on the simulation thread (full queue or data needed at once)
+    size_t s_codec_waits = 0;            // Accesses that had to wait for the job of their codeword to finish
+    size_t s_codec_batches = 0;          // Batch kernel calls encoding several codewords (updated by the codec workers)
+    size_t s_codec_batched_codewords = 0;   // Codewords encoded by these calls
+    size_t s_codeword_fetches = 0;       // Reads held until the rest of their codeword was read and decoded
+    size_t s_codeword_fetch_reads = 0;   // Sector reads issued to assemble these codewords
+    size_t s_codeword_fetch_latency = 0; // Cycles from the data of a held read to the last sector of its codeword
+    float s_avg_codeword_fetch_latency = 0;
+    float s_read_amplification = 0;      // DRAM reads per demand read, the codeword fetches included
+    size_t s_decoded_buffer_hits = 0;    // Reads served by the decoded codeword buffer
+    size_t s_decoded_buffer_misses = 0;  // Demand reads that went to DRAM while the buffer was enabled
+    size_t s_decoded_buffer_invalidations = 0;   // Buffered codewords dropped by writes
+    size_t s_decoded_buffer_saved_bytes = 0;     // DRAM read traffic the buffer absorbed
+    float s_decoded_buffer_hit_rate = 0;
+    size_t s_odecc_demand_rmw_writes = 0;   // Demand writes the on-die ECC of the device read-modify-wrote
+    size_t s_odecc_ecc_rmw_writes = 0;      // Parity, scrub and fetch writes of this plugin it read-modify-wrote
+    size_t s_odecc_ecs_commands = 0;        // ECS (on-die scrub) commands issued to the channel
+    size_t s_odecc_rmw_cycles = 0;          // nRMW cycles these read-modify-writes held their bank group for
+    // int total_corrected_bits = 0;
+    // int total_write_latency_ns = 0;
+    // int total_read_latency_ns = 0;
+    // int total_raw_write_latency_ns = 0;
+    // int total_raw_read_latency_ns = 0;
+    // int total_ecc_write_latency_ns = 0;
+    // int total_ecc_read_latency_ns = 0;
+    // int total_transmission_latency_ns = 0;
+    // int total_memory_write_latency_ns = 0;
+    // int total_memory_read_latency_ns = 0;
+    // int total_edc_check_latency_ns = 0;
+    // int total_ecc_check_latency_ns = 0;
+    // int total_edc_compute_latency_ns = 0;
+    // int total_ecc_compute_latency_ns = 0;
+
+  public:
+    // Initialize plugin parameters
+    void init() override
+    {
+      // Read configuration parameters
+      // VariableName = param<VariableType>("ParameterName").desc("Description").default_val(DefaultValue);
+
+      // Load parameters from configuration file
+      DATA_BLOCK_SIZE = param<size_t>("data_block_size").desc("Size of each data block in bytes.").default_val(128);
+      EDC_SIZE = param<size_t>("edc_size").desc("Size of EDC in bytes.").default_val(4);
+      ECC_SIZE = param<size_t>("ecc_size").desc("Size of ECC in bytes.").default_val(8);
+
+      m_mode = param<std::string>("mode").desc("Simulation mode: functional (encode/decode real data) or timing (metadata only).").default_val("functional");
+      ecc_type = param<std::string>("ecc_type").desc("ECC type to use: hamming, rs, bch.").default_val("bch");
+      edc_type = param<std::string>("edc_type").desc("EDC type to use: checksum, crc32, crc32c, crc64.").default_val("crc32");
+      std::string error_model = param<std::string>("error_model").desc("Bit error model: random, burst, multibit.").default_val("random");
+      int burst_length = param<int>("error_burst_length").desc("Number of consecutive bits flipped by one burst error.").default_val(8);
+      int multibit_width = param<int>("error_multibit_width").desc("Number of bits flipped inside one byte by one multi-bit error.").default_val(2);
+      m_error_seed = param<uint64_t>("error_seed").desc("Seed for error injection and generated payloads.").default_val(0);
+
+      m_act_prefetch = param<bool>("act_prefetch").desc("Stage the codeword of a read when its row is activated (ACT-time prefetch model).").default_val(false);
+      bool edc_simd = param<bool>("edc_simd").desc("Allow SIMD/CRC instruction kernels for EDC (results are identical either way).").default_val(true);
+      std::string codec_kernels = param<std::string>("codec_kernels").desc("RS/BCH kernels: auto (compile-time specialized for common geometries, generic otherwise) or generic.").default_val("auto");
+      m_parity_traffic = param<bool>("parity_traffic").desc("Issue parity reads/writes to the controller.").default_val(false);
+      std::string parity_read_policy = param<std::string>("parity_read_policy").desc("When reads fetch their parity: on_demand (EDC failure) or always.").default_val("on_demand");
+      std::string parity_queue = param<std::string>("parity_queue").desc("Where parity requests are enqueued: priority or shared (read/write buffers).").default_val("priority");
+      m_parity_region_rows = param<int>("parity_region_rows").desc("Rows at the end of every bank reserved for parity (0 = as many as needed).").default_val(0);
+      m_parity_bank_offset = param<int>("parity_bank_offset").desc("Distance (in banks) between a codeword and the bank holding its parity.").default_val(0);
+      m_parity_cache_size = param<size_t>("parity_cache_size").desc("Size of the parity cache in bytes (0 = no parity cache).").default_val(0);
+      m_parity_cache_ways = param<int>("parity_cache_ways").desc("Associativity of the parity cache.").default_val(8);
+      std::string codeword_fetch = param<std::string>("codeword_fetch").desc("Reads of multi-sector codewords: none (one burst per read) or edc_first (fetch the rest of the codeword when the sector fails its EDC check).").default_val("none");
+      int decoded_buffer_entries = param<int>("decoded_buffer_entries").desc("Codewords held by the decoded codeword buffer after a codeword fetch (0 = no buffer).").default_val(0);
+      m_decoded_buffer_latency = param<Clk_t>("decoded_buffer_latency").desc("Cycles a read served by the decoded codeword buffer takes.").default_val(2);
+      std::string parity_cache_policy = param<std::string>("parity_cache_policy").desc("Write policy of the parity cache: write_back or write_through.").default_val("write_back");
+      m_wc_entries = param<int>("wc_entries").desc("Entries of the write-combining buffer (0 = encode every write).").default_val(0);
+      m_wc_timeout = param<Clk_t>("wc_timeout").desc("Cycles a write-combining entry may wait before it is flushed (0 = no timeout).").default_val(1000);
+      m_wc_watermark = param<float>("wc_watermark").desc("Occupancy (fraction of the entries) above which the oldest write-combining entries are flushed.").default_val(0.75f);
+      m_dedup_storage = param<bool>("dedup_storage").desc("Store identical [Data + EDC | ECC] codewords (e.g., zero blocks) once, refcounted (functional mode).").default_val(false);
+      m_zero_block_fraction = param<double>("zero_block_fraction").desc("Fraction of generated (payload-less) data blocks that are all zero, e.g., sparse activations.").default_val(0.0);
+      m_serialize = param<bool>("serialize").desc("Whether to save the codeword image at the end of the simulation.").default_val(false);
+      m_serialization_filename = param<std::string>("serialization_filename").desc("Filename to save the codeword image to.").default_val("ecc_serialization");
+      m_deserialize = param<bool>("deserialize").desc("Whether to restore the codeword image at initialization.").default_val(false);
+      m_deserialization_filename = param<std::string>("deserialization_filename").desc("Filename to restore the codeword image from.").default_val("ecc_serialization");
+      m_access_histogram = param<bool>("access_histogram").desc("Whether to save the reads per error epoch of every codeword for the reliability estimator (timing mode).").default_val(false);
+      m_access_histogram_filename = param<std::string>("access_histogram_filename").desc("Filename to save the access histogram to.").default_val("ecc_access_histogram.yaml");
+      m_codec_threads = param<int>("codec_threads").desc("Worker threads running the functional ECC encode/decode (0 = inline).").default_val(0);
+      m_codec_queue_size = param<size_t>("codec_queue_size").desc("Capacity of the codec job queue (power of two).").default_val(4096);
+      m_codec_batch = param<int>("codec_batch").desc("Codewords encoded together by the batch RS/BCH kernels, per write-combining flush or codec worker (1 = one at a time).").default_val(8);
+      Clk_t scrub_interval = param<Clk_t>("scrub_interval").desc("Minimum cycles between two patrol scrub reads (0 = no scrubbing).").default_val(0);
+      Clk_t scrub_idle_cycles = param<Clk_t>("scrub_idle_cycles").desc("Cycles the read and write buffers must stay empty before scrubbing starts.").default_val(16);
+      int scrub_max_outstanding = param<int>("scrub_max_outstanding").desc("Patrol scrub reads in flight at the same time.").default_val(2);
+      bit_error_rate = param<double>("bit_error_rate").desc("Raw bit error rate (BER)").default_val(1e-6);
+      max_failure_prob = param<double>("max_failure_prob").desc("Maximum allowed failure probability").default_val(1e-14);
+      m_fault_config = FaultMap::Config::parse(m_config["fault_map"]);
+      std::string ecc_strength = param<std::string>("ecc_strength").desc("ECC strength: static (from bit_error_rate) or adaptive (weak or strong per region, from the observed EDC failures).").default_val("static");
+      AdaptiveStrength::Config adaptive;
+      adaptive.region_size = param<Addr_t>("adaptive_region_size").desc("Bytes of a region whose ECC strength is switched as a whole.").default_val(1 << 20);
+      adaptive.window = param<Clk_t>("adaptive_window").desc("Cycles of one half of the sliding window the EDC failure rates are measured over.").default_val(100000);
+      adaptive.upgrade_rate = param<double>("adaptive_upgrade_rate").desc("EDC failures per read at which a weak region switches to strong protection.").default_val(1e-3);
+      adaptive.downgrade_rate = param<double>("adaptive_downgrade_rate").desc("EDC failures per read at or below which a strong region switches to weak protection.").default_val(1e-5);
+      adaptive.min_reads = param<size_t>("adaptive_min_reads").desc("Reads a region needs in the sliding window before it can switch to weak protection.").default_val(64);
+      m_adaptive_weak_ecc_size = param<int>("adaptive_weak_ecc_size").desc("ECC size of weak codewords (0 = EDC only).").default_val(0);
+      m_error_log_path = param<std::string>("error_log").desc("Path of the binary ECC error event log, one file per channel (<path>.ch<channel>; empty = no log).").default_val("");
+      m_error_log_buffer_size = param<size_t>("error_log_buffer_size").desc("Bytes of the ring buffer the error events are written from.").default_val(1 << 20);
+
+      if (m_mode == "timing")
+      {
+        m_timing_mode = true;
+      }
+      else if (m_mode != "functional")
+      {
+        throw ConfigurationError("ECCPlugin: Unsupported mode \"{}\" (expected functional or timing)!", m_mode);
+      }
+
+      if (parity_read_policy != "on_demand" && parity_read_policy != "always")
+      {
+        throw ConfigurationError("ECCPlugin: Unsupported parity_read_policy \"{}\" (expected on_demand or always)!", parity_read_policy);
+      }
+      m_parity_read_always = (parity_read_policy == "always");
+      if (parity_queue != "priority" && parity_queue != "shared")
+      {
+        throw ConfigurationError("ECCPlugin: Unsupported parity_queue \"{}\" (expected priority or shared)!", parity_queue);
+      }
+      m_parity_shared_queue = (parity_queue == "shared");
+      if (parity_cache_policy != "write_back" && parity_cache_policy != "write_through")
+      {
+        throw ConfigurationError("ECCPlugin: Unsupported parity_cache_policy \"{}\" (expected write_back or write_through)!", parity_cache_policy);
+      }
+      m_parity_cache_write_back = (parity_cache_policy == "write_back");
+      if (codeword_fetch != "none" && codeword_fetch != "edc_first")
+      {
+        throw ConfigurationError("ECCPlugin: Unsupported codeword_fetch \"{}\" (expected none or edc_first)!", codeword_fetch);
+      }
+      m_codeword_fetch = (codeword_fetch == "edc_first");
+      if (decoded_buffer_entries > 0)
+      {
+        if (!m_codeword_fetch)
+        {
+          throw ConfigurationError("ECCPlugin: decoded_buffer_entries needs codeword_fetch: edc_first!");
+        }
+        if (m_decoded_buffer_latency < 1)
+        {
+          throw ConfigurationError("ECCPlugin: decoded_buffer_latency must be at least 1 (got {})!", m_decoded_buffer_latency);
+        }
+        m_decoded_buffer = DecodedBuffer(decoded_buffer_entries);
+        m_subscription.requests = true;
+      }
+      if (m_zero_block_fraction < 0.0 || m_zero_block_fraction > 1.0)
+      {
+        throw ConfigurationError("ECCPlugin: zero_block_fraction must be in [0, 1] (got {})!", m_zero_block_fraction);
+      }
+      if (codec_kernels != "auto" && codec_kernels != "generic")
+      {
+        throw ConfigurationError("ECCPlugin: Unsupported codec_kernels \"{}\" (expected auto or generic)!", codec_kernels);
+      }
+      if (m_access_histogram && (!m_timing_mode || scrub_interval > 0))
+      {
+        throw ConfigurationError("ECCPlugin: access_histogram needs the timing mode, without scrubbing!");
+      }
+      if (ecc_strength != "static" && ecc_strength != "adaptive")
+      {
+        throw ConfigurationError("ECCPlugin: Unsupported ecc_strength \"{}\" (expected static or adaptive)!", ecc_strength);
+      }
+      if (ecc_strength == "adaptive")
+      {
+        // The functional codecs are built for the one t of their policy
+        if (!m_timing_mode || m_access_histogram)
+        {
+          throw ConfigurationError("ECCPlugin: ecc_strength: adaptive needs the timing mode, without access_histogram!");
+        }
+        if (m_adaptive_weak_ecc_size < 0)
+        {
+          throw ConfigurationError("ECCPlugin: adaptive_weak_ecc_size cannot be negative (got {})!", m_adaptive_weak_ecc_size);
+        }
+        m_adaptive = AdaptiveStrength(adaptive);
+      }
+      if (scrub_interval > 0)
+      {
+        m_scrubber = PatrolScrubber(scrub_interval, scrub_idle_cycles, scrub_max_outstanding);
+      }
+      m_rs_codecs = RSCodecCache(codec_kernels == "auto");
+      m_bch_codecs = BCHCodecCache(codec_kernels == "auto");
+
+      m_error_injector = BitErrorInjector(bit_error_rate, BitErrorInjector::parse_mode(error_model), burst_length, multibit_width);
+      m_symbol_error_prob = 1.0 - pow(1.0 - bit_error_rate, 8);
+
+      // The top-level parameters form the default policy, protection_policies override them per address range
+      ProtectionPolicy default_policy;
+      default_policy.data_block_size = DATA_BLOCK_SIZE;
+      default_policy.edc_size = EDC_SIZE;
+      default_policy.ecc_size = ECC_SIZE;
+      default_policy.ecc_type = ecc_type;
+      default_policy.edc_type = edc_type;
+      default_policy.max_failure_prob = max_failure_prob;
+
+      std::vector<ProtectionPolicy> policies = ProtectionPolicy::parse(m_config["protection_policies"], default_policy);
+      policies.insert(policies.begin(), default_policy);
+      m_protection_table = ProtectionPolicyTable(policies, 0);
+
+      m_protections.resize(policies.size());
+      for (size_t i = 0; i < policies.size(); i++)
+      {
+        m_protections[i].policy = policies[i];
+        init_protection(m_protections[i], edc_simd);
+      }
+      m_edc_kernel = m_protections.front().edc_engine->name();
+      m_ecc_kernel = ecc_kernel_name(m_protections.front());
+
+      if (m_timing_mode)
+      {
+        m_codec_threads = 0;  // No codecs to offload
+        m_dedup_storage = false;  // Only metadata is stored
+      }
+      if (m_codec_batch < 1)
+      {
+        throw ConfigurationError("ECCPlugin: codec_batch must be at least 1 (got {})!", m_codec_batch);
+      }
+      if (m_dedup_storage && m_codec_threads > 0)
+      {
+        throw ConfigurationError("ECCPlugin: dedup_storage needs the codecs to run inline (codec_threads: 0)!");
+      }
+
+      if (m_deserialize)
+      {
+        deserialize();
+      }
+
+      // Workers only look up codecs primed by init_protection(), so the RS/BCH caches are read-only once they start
+      if (m_codec_threads > 0)
+      {
+        m_codec_pool = std::make_unique<CodecWorkerPool>(m_codec_threads, m_codec_queue_size, m_codec_batch, [this](std::span<CodecJob> jobs) { execute_codec_jobs(jobs); });
+      }
+      
+      // Register runtime statistics
+      // register_stat(VariableName).name("OutputStatName");
+      register_stat(total_ecc_size).name("ecc_total_size_bytes");
+      register_stat(total_edc_size).name("edc_total_size_bytes");
+      register_stat(edc_success_count).name("edc_success_count");
+      register_stat(edc_failure_count).name("edc_failure_count");
+      register_stat(ecc_success_count).name("ecc_success_count");
+      register_stat(ecc_failure_count).name("ecc_failure_count");
+      register_stat(s_ecc_failures_per_gb).name("ecc_failures_per_gb");
+      register_stat(s_parity_bytes_per_request).name("parity_bytes_per_request");
+      register_stat(injected_bit_errors).name("injected_bit_errors");
+      register_stat(storage_footprint_bytes).name("storage_footprint_bytes");
+      if (m_dedup_storage)
+      {
+        register_stat(storage_codewords).name("storage_codewords");
+        register_stat(storage_records).name("storage_records");
+        register_stat(storage_dedup_merges).name("storage_dedup_merges");
+      }
+      if (m_deserialize)
+      {
+        register_stat(s_restored_codewords).name("restored_codewords");
+      }
+      register_stat(act_prefetch_count).name("act_prefetch_count");
+      register_stat(act_prefetch_fill_count).name("act_prefetch_fill_count");
+      register_stat(s_parity_read_reqs).name("parity_read_requests");
+      register_stat(s_parity_write_reqs).name("parity_write_requests");
+      register_stat(s_parity_read_latency).name("parity_read_latency");
+      register_stat(s_avg_parity_read_latency).name("avg_parity_read_latency");
+      register_stat(s_parity_queue_max_len).name("parity_queue_max_len");
+      register_stat(s_parity_activations).name("parity_activations");
+      register_stat(s_parity_row_hit_rate).name("parity_row_hit_rate");
+      register_stat(s_wc_writes).name("wc_writes");
+      register_stat(s_wc_flushes).name("wc_flushes");
+      register_stat(s_wc_full_flushes).name("wc_full_flushes");
+      register_stat(s_wc_rmw_count).name("wc_rmw_count");
+      register_stat(s_wc_eviction_flushes).name("wc_eviction_flushes");
+      register_stat(s_wc_timeout_flushes).name("wc_timeout_flushes");
+      register_stat(s_wc_watermark_flushes).name("wc_watermark_flushes");
+      register_stat(s_wc_coalescing_ratio).name("wc_coalescing_ratio");
+      register_stat(s_parity_cache_read_hits).name("parity_cache_read_hits");
+      register_stat(s_parity_cache_read_misses).name("parity_cache_read_misses");
+      register_stat(s_parity_cache_write_hits).name("parity_cache_write_hits");
+      register_stat(s_parity_cache_write_misses).name("parity_cache_write_misses");
+      register_stat(s_parity_cache_evictions).name("parity_cache_evictions");
+      register_stat(s_parity_cache_writebacks).name("parity_cache_writebacks");
+      register_stat(s_parity_cache_hit_rate).name("parity_cache_hit_rate");
+      register_stat(s_parity_cache_saved_bytes).name("parity_cache_saved_bytes");
+      register_stat(s_codec_async_jobs).name("codec_async_jobs");
+      register_stat(s_codec_inline_jobs).name("codec_inline_jobs");
+      register_stat(s_codec_waits).name("codec_waits");
+      register_stat(s_codec_batches).name("codec_batches");
+      register_stat(s_codec_batched_codewords).name("codec_batched_codewords");
+      if (m_scrubber.enabled())
+      {
+        register_stat(s_scrub_read_reqs).name("scrub_read_requests");
+        register_stat(s_scrub_write_reqs).name("scrub_write_requests");
+        register_stat(s_scrub_clean).name("scrub_clean_codewords");
+        register_stat(s_scrub_corrected).name("scrub_corrected_codewords");
+        register_stat(s_scrub_uncorrectable).name("scrub_uncorrectable_codewords");
+        register_stat(m_scrubber.s_idle_cycles).name("scrub_idle_cycles");
+        register_stat(m_scrubber.s_passes).name("scrub_passes");
+      }
+      if (m_codeword_fetch)
+      {
+        register_stat(s_codeword_fetches).name("codeword_fetches");
+        register_stat(s_codeword_fetch_reads).name("codeword_fetch_reads");
+        register_stat(s_codeword_fetch_latency).name("codeword_fetch_latency");
+        register_stat(s_avg_codeword_fetch_latency).name("avg_codeword_fetch_latency");
+        register_stat(s_read_amplification).name("read_amplification");
+      }
+      if (m_fault_config.enabled())
+      {
+        for (int t = 0; t < FaultMap::NUM_TYPES; t++)
+        {
+          register_stat(m_fault_map.s_faults[t]).name("fault_map_{}_faults", FaultMap::TYPE_NAMES[t]);
+        }
+        register_stat(s_fault_map_bytes).name("fault_map_bytes");
+        register_stat(s_fault_reads).name("fault_reads");
+        register_stat(s_fault_symbols).name("fault_symbols");
+      }
+      if (!m_error_log_path.empty())
+      {
+        register_stat(s_error_log_events).name("error_log_events");
+        register_stat(s_error_log_stalls).name("error_log_stalls");
+      }
+      if (m_adaptive.enabled())
+      {
+        register_stat(m_adaptive.s_upgrades).name("adaptive_upgrades");
+        register_stat(m_adaptive.s_downgrades).name("adaptive_downgrades");
+        register_stat(m_adaptive.s_weak_regions).name("adaptive_weak_regions");
+        register_stat(s_adaptive_weak_writes).name("adaptive_weak_writes");
+        register_stat(s_adaptive_strong_writes).name("adaptive_strong_writes");
+        register_stat(s_adaptive_saved_ecc_bytes).name("adaptive_saved_ecc_bytes");
+        register_stat(s_adaptive_saved_parity_traffic).name("adaptive_saved_parity_traffic");
+      }
+      if (m_decoded_buffer.enabled())
+      {
+        register_stat(s_decoded_buffer_hits).name("decoded_buffer_hits");
+        register_stat(s_decoded_buffer_misses).name("decoded_buffer_misses");
+        register_stat(s_decoded_buffer_hit_rate).name("decoded_buffer_hit_rate");
+        register_stat(s_decoded_buffer_invalidations).name("decoded_buffer_invalidations");
+        register_stat(s_decoded_buffer_saved_bytes).name("decoded_buffer_saved_bytes");
+      }
+      // register_stat(total_corrected_bits).name("total_corrected_bits");
+      // register_stat(total_write_latency_ns).name("total_write_latency_ns");
+      // register_stat(total_read_latency_ns).name("total_read_latency_ns");
+      // register_stat(total_raw_write_latency_ns).name("total_raw_write_latency_ns");
+      // register_stat(total_raw_read_latency_ns).name("total_raw_read_latency_ns");
+      // register_stat(total_ecc_write_latency_ns).name("total_ecc_write_latency_ns");
+      // register_stat(total_ecc_read_latency_ns).name("total_ecc_read_latency_ns");
+      // register_stat(total_transmission_latency_ns).name("total_transmission_latency_ns");
+      // register_stat(total_memory_write_latency_ns).name("total_memory_write_latency_ns");
+      // register_stat(total_memory_read_latency_ns).name("total_memory_read_latency_ns");
+      // register_stat(total_edc_check_latency_ns).name("total_edc_check_latency_ns");
+      // register_stat(total_ecc_check_latency_ns).name("total_ecc_check_latency_ns");
+      // register_stat(total_edc_compute_latency_ns).name("total_edc_compute_latency_ns");
+      // register_stat(total_ecc_compute_latency_ns).name("total_ecc_compute_latency_ns");
+
+      // Input parameters
+      register_stat(DATA_BLOCK_SIZE).name("config_data_block_size");
+      register_stat(EDC_SIZE).name("config_edc_size");
+      register_stat(ECC_SIZE).name("config_ecc_size");
+      register_stat(bit_error_rate).name("config_bit_error_rate");
+      register_stat(max_failure_prob).name("config_max_failure_prob");
+      register_stat(m_edc_kernel).name("config_edc_kernel");
+      register_stat(m_ecc_kernel).name("config_ecc_kernel");
+      register_stat(m_mode).name("config_mode");
+      register_stat(m_codec_threads).name("config_codec_threads");
+      register_stat(m_protections.front().codeword_t).name("config_ecc_t");
+      register_stat(m_protections.front().codeword_parity_size).name("config_ecc_parity_bytes");
+      register_stat(m_protections.front().failure_prob).name("config_ecc_failure_prob");
+
+      // Per-policy statistics, only when the address space is split
+      if (m_protections.size() > 1)
+      {
+        for (Protection& p : m_protections)
+        {
+          register_stat(p.s_reads).name("protection_{}_reads", p.policy.name);
+          register_stat(p.s_writes).name("protection_{}_writes", p.policy.name);
+          register_stat(p.s_edc_failures).name("protection_{}_edc_failures", p.policy.name);
+          register_stat(p.s_ecc_failures).name("protection_{}_ecc_failures", p.policy.name);
+          register_stat(p.s_ecc_size).name("protection_{}_ecc_size_bytes", p.policy.name);
+          register_stat(p.codeword_t).name("protection_{}_ecc_t", p.policy.name);
+          register_stat(p.codeword_parity_size).name("protection_{}_ecc_parity_bytes", p.policy.name);
+          register_stat(p.failure_prob).name("protection_{}_ecc_failure_prob", p.policy.name);
+        }
+      }
+          
+      // Bandwidth parameters
+      register_stat(BUS_BW_GBs).name("param_bus_bw_GBs");
+      register_stat(MEM_RD_BW_GBs).name("param_mem_read_bw_GBs");
+      register_stat(MEM_WR_BW_GBs).name("param_mem_write_bw_GBs");
+      register_stat(EDC_COMPUTE_PER_BYTE_NS).name("param_edc_compute_ns_per_byte");
+      register_stat(ECC_COMPUTE_PER_BYTE_NS).name("param_ecc_compute_ns_per_byte");
+    };
+
+    // Derive the codecs, codeword geometry and storage of a protection policy
+    void init_protection(Protection& p, bool edc_simd)
+    {
+      const ProtectionPolicy& policy = p.policy;
+      if (policy.ecc_type != "hamming" && policy.ecc_type != "rs" && policy.ecc_type != "bch")
+      {
+        throw ConfigurationError("ECCPlugin: Unsupported ecc_type \"{}\" (expected hamming, rs or bch)!", policy.ecc_type);
+      }
+      p.edc_engine = IEDCEngine::create(policy.edc_type, edc_simd);
+
+      // The ECC size only depends on the codeword geometry and the error model, so it is computed once here
+      size_t codeword_data_size = policy.data_block_size + policy.edc_size;
+      p.dynamic_ecc_size = calculate_dynamic_ecc_size(p, codeword_data_size);
+
+      // Build the RS tables once for the codeword geometry used by every request of the policy
+      if (policy.ecc_type == "rs")
+      {
+        int t = p.dynamic_ecc_size / 2;
+        p.rs_symbol_bits = RSCodecCache::min_symbol_bits(codeword_data_size, t);
+        if (p.rs_symbol_bits < 0)
+        {
+          throw ConfigurationError("ECCPlugin: No supported RS symbol width can hold a {}B codeword with t = {}!", codeword_data_size, t);
+        }
+        m_rs_codecs.get(p.rs_symbol_bits, t);
+      }
+      // Binary BCH corrects t bit errors with the same t: at the BERs of interest a corrupted symbol has one flipped bit
+      else if (policy.ecc_type == "bch")
+      {
+        int t = p.dynamic_ecc_size / 2;
+        p.bch_field_bits = BCHCodecCache::min_field_bits(codeword_data_size * 8, t);
+        if (p.bch_field_bits < 0)
+        {
+          throw ConfigurationError("ECCPlugin: No supported BCH field can hold a {}B codeword with t = {}!", codeword_data_size, t);
+        }
+        m_bch_codecs.get(p.bch_field_bits, t);
+      }
+
+      // Codeword geometry as seen by the error model
+      p.codeword_symbols = codeword_data_size;
+      p.codeword_t = p.dynamic_ecc_size / 2;
+      p.codeword_parity_size = ecc_parity_size(p, p.dynamic_ecc_size);
+      if (m_adaptive.enabled())
+      {
+        // Weak codewords never get more ECC than the static policy would give them
+        int weak_ecc_size = std::min(m_adaptive_weak_ecc_size, p.dynamic_ecc_size);
+        p.weak_t = weak_ecc_size / 2;
+        p.weak_parity_size = (policy.ecc_type == "hamming" || p.weak_t > 0) ? ecc_parity_size(p, weak_ecc_size) : 0;
+      }
+      p.histogram.policy = policy.name;
+      p.histogram.codeword_symbols = p.codeword_symbols;
+      p.histogram.ecc_size = policy.ecc_size;
+      p.histogram.ecc_type = policy.ecc_type;
+      p.histogram.max_failure_prob = policy.max_failure_prob;
+      p.failure_prob = std::exp(ReliabilityEstimator::binomial_log_tail(p.codeword_symbols, m_symbol_error_prob)[p.codeword_t]);
+
+      if (m_timing_mode)
+      {
+        // Only the per-codeword metadata (header) is kept
+        p.storage = std::make_unique<CodewordStore>(0, 0);
+        p.error_cdf = ReliabilityEstimator::binomial_cdf_table(p.codeword_symbols, m_symbol_error_prob);
+      }
+      else
+      {
+        // Every record reserves room for the largest ECC the configuration can produce (BCH needs at most 2 bytes per t)
+        size_t parity_capacity = policy.ecc_size * ((policy.ecc_type == "rs") ? (p.rs_symbol_bits + 7) / 8 : 1);
+        p.storage = std::make_unique<CodewordStore>(codeword_data_size, parity_capacity, 4 << 20, m_dedup_storage);
+      }
+    }
+
+    // Name of the codec kernel that encodes/decodes the codewords of a policy
+    std::string ecc_kernel_name(const Protection& p)
+    {
+      if (p.policy.ecc_type == "rs")
+      {
+        return m_rs_codecs.get(p.rs_symbol_bits, p.codeword_t).kernel_name();
+      }
+      if (p.policy.ecc_type == "bch")
+      {
+        return m_bch_codecs.get(p.bch_field_bits, p.codeword_t).kernel_name();
+      }
+      return p.policy.ecc_type + "/generic";
+    }
+
+    // Protection of the codeword holding a byte address
+    Protection& protection_of(Addr_t addr)
+    {
+      return m_protections[m_protection_table.lookup(addr)];
+    }
+
+    // Set up the connection between the plugin, memory controller, and frontend interface
+    void setup(IFrontEnd *frontend, IMemorySystem *memory_system) override
+    {
+      m_ctrl = cast_parent<IDRAMController>();
+      m_dram = m_ctrl->m_dram;
+
+      // Every channel draws its own reproducible error and payload streams (keyed by my path)
+      m_error_injector.set_rng(random_stream(m_error_seed, RNG_STREAM_ERRORS));
+      m_data_rng = random_stream(m_error_seed, RNG_STREAM_PAYLOADS);
+      m_timing_rng = random_stream(m_error_seed, RNG_STREAM_TIMING);
+
+      m_access_bytes = (size_t) m_dram->m_channel_width / 8 * m_dram->m_internal_prefetch_size;
+      int max_sectors_per_codeword = 1;
+      for (Protection& p : m_protections)
+      {
+        p.sectors_per_codeword = std::max<size_t>(1, (p.policy.data_block_size + m_access_bytes - 1) / m_access_bytes);
+        max_sectors_per_codeword = std::max(max_sectors_per_codeword, p.sectors_per_codeword);
+      }
+      if (m_codeword_fetch || m_fault_config.enabled())
+      {
+        // The sectors of a codeword are stored in aligned, consecutive columns of one row
+        m_column_level = m_dram->m_levels("column");
+        int row_sectors = m_dram->m_organization.count[m_column_level] / m_dram->m_internal_prefetch_size;
+        if (max_sectors_per_codeword > row_sectors)
+        {
+          throw ConfigurationError("ECCPlugin: codeword_fetch and fault_map need codewords of at most one row ({} sectors, got {})!", row_sectors, max_sectors_per_codeword);
+        }
+      }
+      // Banks are numbered across all levels between the channel and the row (see flat_bank())
+      m_row_level = m_dram->m_levels("row");
+      m_bank_level = m_row_level - 1;
+      if (m_fault_config.enabled())
+      {
+        // Every channel has its own faults
+        FaultMap::Geometry geometry;
+        geometry.num_banks = 1;
+        for (int level = 1; level <= m_bank_level; level++)
+        {
+          geometry.num_banks *= m_dram->m_organization.count[level];
+        }
+        geometry.num_rows = m_dram->m_organization.count[m_row_level];
+        geometry.num_columns = m_dram->m_organization.count[m_column_level] / m_dram->m_internal_prefetch_size;
+        geometry.num_pins = m_dram->m_channel_width;
+        geometry.num_beats = m_dram->m_internal_prefetch_size;
+        m_fault_map = FaultMap(m_fault_config, geometry, random_stream(m_error_seed, RNG_STREAM_FAULTS));
+        s_fault_map_bytes = m_fault_map.memory_footprint();
+      }
+      if (!m_error_log_path.empty())
+      {
+        ErrorEventLog::ErrorUnit unit = m_timing_mode ? ErrorEventLog::ErrorUnit::Symbols : ErrorEventLog::ErrorUnit::Bits;
+        std::string path = fmt::format("{}.ch{}", m_error_log_path, m_ctrl->m_channel_id);
+        m_error_log = std::make_unique<ErrorEventLog::Writer>(path, m_ctrl->m_channel_id, unit, m_error_log_buffer_size);
+      }
+      if (m_wc_entries > 0)
+      {
+        m_write_combiner = WriteCombiner(m_wc_entries, max_sectors_per_codeword, m_wc_timeout, m_wc_watermark);
+      }
+
+      if (m_parity_traffic)
+      {
+        int inline_lines = memory_system->get_ifce<IAddrMapper>()->inline_parity_lines();
+        if (inline_lines > 0)
+        {
+          // The address mapper keeps the tail of every row free: parity goes to the row of its codeword
+          m_parity_region_rows = 0;
+          for (Protection& p : m_protections)
+          {
+            p.parity_layout = ParityLayout::in_row(m_dram, p.codeword_parity_size, p.policy.data_block_size, inline_lines);
+          }
+        }
+        else
+        {
+          // All policies share one parity region, sized for the policy that needs the most rows
+          if (m_parity_region_rows == 0)
+          {
+            for (Protection& p : m_protections)
+            {
+              ParityLayout layout(m_dram, p.codeword_parity_size, p.policy.data_block_size, 0, m_parity_bank_offset);
+              m_parity_region_rows = std::max(m_parity_region_rows, layout.region_rows());
+            }
+          }
+          for (Protection& p : m_protections)
+          {
+            p.parity_layout = ParityLayout(m_dram, p.codeword_parity_size, p.policy.data_block_size, m_parity_region_rows, m_parity_bank_offset);
+          }
+        }
+        if (m_parity_cache_size > 0)
+        {
+          m_parity_cache = ParityCache(m_parity_cache_size, parity_lines().line_bytes(), m_parity_cache_ways, m_parity_cache_write_back);
+        }
+      }
+      m_RD_req_id = m_dram->m_requests("read");
+      m_WR_req_id = m_dram->m_requests("write");
+
+      if (m_scrubber.enabled())
+      {
+        m_addr_mapper = memory_system->get_ifce<IAddrMapper>();
+        for (Protection& p : m_protections)
+        {
+          m_scrub_stores.push_back(p.storage.get());
+        }
+      }
+      if (OnDieECC::is_enabled(m_dram))
+      {
+        // The on-die ECC of the device works under this plugin: report how the two interact
+        m_odecc_rmw_writes = OnDieECC::rmw_writes(m_dram);
+        m_odecc_ecs_command = m_dram->m_commands("ECS");
+        m_odecc_rmw_latency = m_dram->m_timing_vals("nRMW");
+        register_stat(s_odecc_demand_rmw_writes).name("odecc_demand_rmw_writes");
+        register_stat(s_odecc_ecc_rmw_writes).name("odecc_ecc_rmw_writes");
+        register_stat(s_odecc_ecs_commands).name("odecc_ecs_commands");
+        register_stat(s_odecc_rmw_cycles).name("odecc_rmw_cycles");
+      }
+      register_stat(m_parity_region_rows).name("config_parity_region_rows");
+    };
+
+    // Called every time a memory request is scheduled
+    void update(bool request_found, ReqBuffer::iterator &req_it) override  // "base/request.h"类
+    {
+      // The second command of a cycle (dual command bus) only goes through the request handling below
+      bool is_new = is_new_cycle(request_found);
+      m_clk += is_new;
+
+      if (is_new && m_adaptive.enabled())
+      {
+        m_adaptive.tick(m_clk);
+      }
+
+      if (!m_served_reads.empty())
+      {
+        complete_served_reads();
+      }
+
+      if (is_new && m_write_combiner.enabled())
+      {
+        m_write_combiner.tick(m_clk, m_wc_flushes);
+        flush_combined_writes();
+      }
+
+      drain_parity_queue();
+
+      if (is_new && m_scrubber.enabled())
+      {
+        scrub();
+      }
+
+      if (request_found)
+      {
+        int tag = req_it->scratchpad[PARITY_TAG_IDX];
+        if (!m_odecc_rmw_writes.empty())
+        {
+          count_odecc(*req_it, tag);
+        }
+
+        // Parity, scrub and codeword fetch requests issued by this plugin are plain DRAM traffic
+        if (tag == PARITY_TAG)
+        {
+            // Parity accesses are row hits unless a row had to be opened for them
+            s_parity_activations += m_dram->m_command_meta(req_it->command).is_opening;
+            s_parity_dram_accesses += req_it->command == req_it->final_command;
+            return;
+        }
+        if (tag == SCRUB_TAG || tag == FETCH_TAG || tag == REDUNDANCY_TAG)
+        {
+            return;
+        }
+
+        // Maintenance requests (refresh, RFM, ...) carry no data. Their device-defined type ids start at 2 and
+        // would otherwise be taken for Request::Type::PartialWrite
+        if (req_it->addr < 0)
+        {
+            return;
+        }
+        Protection& p = protection_of(req_it->addr);
+
+        // The controller calls plugins for every command of a request (e.g., ACT, PRE and the final RD/WR).
+        // The functional ECC pipeline runs exactly once per request, on the command that finishes it.
+        if (req_it->command != req_it->final_command)
+        {
+            if (m_act_prefetch && m_dram->m_command_meta(req_it->command).is_opening)
+            {
+                prefetch_on_activate(p, req_it);
+            }
+            return;
+        }
+
+        if (m_write_combiner.enabled() && req_it->type_id == Request::Type::Write)
+        {
+            combine_write(p, req_it);
+            return;
+        }
+
+        size_t edc_failures = edc_failure_count;
+        size_t ecc_failures = ecc_failure_count;
+        if (m_timing_mode)
+        {
+            update_timing(p, req_it);
+        }
+        else
+        {
+            update_functional(p, req_it);
+        }
+
+        if (m_uncorrectable_handler && req_it->type_id == Request::Type::Read && ecc_failure_count != ecc_failures)
+        {
+            hold_uncorrectable_read(req_it);
+        }
+
+        // Reads that failed their EDC check take the slow (full decode) path of the controller's decoder stage
+        bool edc_failed = edc_failure_count != edc_failures;
+        if (req_it->type_id == Request::Type::Read)
+        {
+            p.s_reads++;
+            p.s_edc_failures += edc_failed;
+            s_decoded_buffer_misses += m_decoded_buffer.enabled();
+            if (m_adaptive.enabled())
+            {
+                m_adaptive.record_read(req_it->addr, edc_failed, ecc_failure_count != ecc_failures);
+            }
+        }
+        else
+        {
+            p.s_writes++;
+        }
+        if (edc_failed && req_it->type_id == Request::Type::Read)
+        {
+            // With codeword fetches, the decode waits for the whole codeword instead of this sector
+            if (m_codeword_fetch && p.sectors_per_codeword > 1)
+            {
+                fetch_codeword(p, req_it);
+            }
+            else
+            {
+                req_it->scratchpad[DecoderPipeline::SCRATCHPAD_IDX] = DecoderPipeline::FULL_DECODE;
+            }
+        }
+
+        // Put the parity accesses of the request on the bus; reads only need the ECC when the EDC fails
+        if (m_parity_traffic)
+        {
+            issue_parity_requests(p, req_it, edc_failed);
+        }
+      }
+    };
+
+    Clk_t get_idle_cycles() override
+    {
+      // The scrubber works on idle cycles and queued side-band requests retry every cycle
+      if (m_scrubber.enabled() || !m_parity_queue.empty())
+      {
+        return 0;
+      }
+      Clk_t idle_cycles = std::numeric_limits<Clk_t>::max();
+      if (m_write_combiner.enabled() && m_write_combiner.next_deadline() >= 0)
+      {
+        idle_cycles = std::max<Clk_t>(m_write_combiner.next_deadline() - m_clk - 1, 0);
+      }
+      if (!m_served_reads.empty())
+      {
+        idle_cycles = std::min(idle_cycles, std::max<Clk_t>(m_served_reads.front().first - m_clk - 1, 0));
+      }
+      return idle_cycles;
+    };
+
+    bool keeps_data() const override
+    {
+        return !m_timing_mode;
+    }
+
+    // The codeword stores and the fault map
+    size_t memory_footprint() const override
+    {
+        size_t bytes = m_fault_map.memory_footprint();
+        for (const Protection& p : m_protections)
+        {
+            bytes += p.storage ? p.storage->memory_footprint() : 0;
+        }
+        return bytes;
+    }
+
+    // Data of other plugins (e.g., line compression): the data block of the codeword holding addr, as stored
+    bool read_data(Addr_t addr, std::span<uint8_t> data) override
+    {
+        if (m_timing_mode || addr < 0)
+        {
+            return false;
+        }
+        Protection& p = protection_of(addr);
+        Addr_t block = codeword_addr(p, addr);
+        if (addr + (Addr_t) data.size() > block + (Addr_t) p.policy.data_block_size)
+        {
+            return false;
+        }
+        materialize_data_block(p, block);
+        CodewordStore::Codeword cw = p.storage->find(block);
+        wait_for_codeword(cw);
+        std::span<const uint8_t> data_block = cw.data_span().subspan(addr - block, data.size());
+        std::copy(data_block.begin(), data_block.end(), data.begin());
+        return true;
+    }
+
+    // The commands of a request that the on-die ECC of the device turns into internal work
+    void count_odecc(const Request& req, int tag)
+    {
+        if (req.command == m_odecc_ecs_command)
+        {
+            s_odecc_ecs_commands++;
+            return;
+        }
+        if (req.command != req.final_command || !m_odecc_rmw_writes[req.command])
+        {
+            return;
+        }
+        if (tag == PARITY_TAG || tag == SCRUB_TAG || tag == FETCH_TAG)
+        {
+            s_odecc_ecc_rmw_writes++;
+        }
+        else
+        {
+            s_odecc_demand_rmw_writes++;
+        }
+        s_odecc_rmw_cycles += m_odecc_rmw_latency;
+    }
+
+    bool is_own_request(const Request& req) override
+    {
+        int tag = req.scratchpad[PARITY_TAG_IDX];
+        return tag == PARITY_TAG || tag == SCRUB_TAG || tag == FETCH_TAG || tag == REDUNDANCY_TAG;
+    }
+
+    void set_uncorrectable_handler(UncorrectableHandler handler) override
+    {
+        m_uncorrectable_handler = std::move(handler);
+    }
+
+    Totals get_totals() const override
+    {
+        Totals totals;
+        for (const Protection& p : m_protections)
+        {
+            totals.reads += p.s_reads;
+            totals.writes += p.s_writes;
+        }
+        totals.read_bytes = totals.reads * m_access_bytes;
+        totals.edc_failures = edc_failure_count;
+        totals.ecc_corrections = ecc_success_count;
+        totals.ecc_failures = ecc_failure_count;
+        totals.parity_bytes = total_ecc_size;
+        totals.parity_traffic_bytes = (s_parity_read_reqs + s_parity_write_reqs) * m_access_bytes;
+        return totals;
+    }
+
+    // Reads of a buffered decoded codeword complete without DRAM access, writes make the codeword stale
+    bool serve_request(Request& req) override
+    {
+        if (req.addr < 0 || is_own_request(req))
+        {
+            return false;
+        }
+        Addr_t addr = codeword_addr(protection_of(req.addr), req.addr);
+        if (req.type_id != Request::Type::Read)
+        {
+            s_decoded_buffer_invalidations += m_decoded_buffer.invalidate(addr);
+            return false;
+        }
+        if (!m_decoded_buffer.lookup(addr))
+        {
+            return false;
+        }
+
+        s_decoded_buffer_hits++;
+        s_decoded_buffer_saved_bytes += m_access_bytes;
+        req.depart = req.arrive + m_decoded_buffer_latency;
+        m_served_reads.push_back({m_clk + m_decoded_buffer_latency, req});
+        return true;
+    }
+
+    // All served reads take the same latency, so they complete in the order they were served
+    void complete_served_reads()
+    {
+        while (!m_served_reads.empty() && m_served_reads.front().first <= m_clk)
+        {
+            Request& req = m_served_reads.front().second;
+            if (req.callback)
+            {
+                req.callback(req);
+            }
+            m_served_reads.pop_front();
+        }
+    }
+
+    void skip_cycles(Clk_t num_cycles) override
+    {
+      m_clk += num_cycles;
+    };
+
+    // Enqueue the parity reads (ECC fetch) and writes (ECC update) of the codeword of a finished request
+    void issue_parity_requests(Protection& p, ReqBuffer::iterator &req_it, bool edc_failed)
+    {
+        bool needs_read = false;
+        bool needs_write = false;
+        if (req_it->type_id == Request::Type::Read)
+        {
+            needs_read = m_parity_read_always || edc_failed;
+            needs_write = edc_failed;   // A corrected codeword is written back
+        }
+        else if (req_it->type_id == Request::Type::Write)
+        {
+            needs_write = true;
+        }
+        else if (req_it->type_id == Request::Type::PartialWrite)
+        {
+            // The incremental ECC update needs the old parity
+            needs_read = true;
+            needs_write = true;
+        }
+
+        issue_parity_accesses(p, req_it->addr, req_it->addr_vec, needs_read, needs_write);
+    }
+
+    // Enqueue parity reads and/or writes of every parity line of the codeword of addr (at addr_vec)
+    void issue_parity_accesses(Protection& p, Addr_t addr, const AddrVec_t& addr_vec, bool needs_read, bool needs_write)
+    {
+        m_parity_lines.clear();
+        p.parity_layout.map(addr_vec, m_parity_lines);
+        if (m_adaptive.enabled())
+        {
+            // Weak codewords only have the lines their parity fills
+            size_t parity_size = codeword_parity_size(p, codeword_addr(p, addr));
+            size_t num_lines = std::min(m_parity_lines.size(), (parity_size + parity_lines().line_bytes() - 1) / parity_lines().line_bytes());
+            s_adaptive_saved_parity_traffic += (m_parity_lines.size() - num_lines) * parity_lines().line_bytes() * (needs_read + needs_write);
+            m_parity_lines.resize(num_lines);
+        }
+        for (const AddrVec_t& line : m_parity_lines)
+        {
+            if (needs_read)
+            {
+                access_parity_line(line, false);
+            }
+            if (needs_write)
+            {
+                access_parity_line(line, true);
+            }
+        }
+        drain_parity_queue();
+    }
+
+    // Route one parity line access through the parity cache (if any) and enqueue the DRAM traffic it causes
+    void access_parity_line(const AddrVec_t& addr_vec, bool is_write)
+    {
+        int type_id = is_write ? m_WR_req_id : m_RD_req_id;
+        if (!m_parity_cache.enabled())
+        {
+            enqueue_parity_request(addr_vec, type_id);
+            return;
+        }
+
+        Addr_t line = parity_lines().line_id(addr_vec);
+        ParityCache::Result result = m_parity_cache.access(line, is_write);
+        if (is_write)
+        {
+            result.hit ? s_parity_cache_write_hits++ : s_parity_cache_write_misses++;
+        }
+        else
+        {
+            result.hit ? s_parity_cache_read_hits++ : s_parity_cache_read_misses++;
+        }
+
+        if (result.evicted)
+        {
+            s_parity_cache_evictions++;
+            if (result.writeback)
+            {
+                s_parity_cache_writebacks++;
+                s_parity_cache_saved_bytes -= parity_lines().line_bytes();  // Every write-back pays for one absorbed write
+                enqueue_parity_request(parity_lines().line_addr_vec(result.victim), m_WR_req_id);
+            }
+        }
+
+        // Reads only go to DRAM on a miss, writes go to DRAM only in write-through caches
+        bool goes_to_dram = is_write ? !m_parity_cache_write_back : !result.hit;
+        if (goes_to_dram)
+        {
+            enqueue_parity_request(addr_vec, type_id);
+        }
+        else
+        {
+            s_parity_cache_saved_bytes += parity_lines().line_bytes();
+        }
+    }
+
+    // Parity line ids only depend on the DRAM organization, so the layout of any policy converts them
+    const ParityLayout& parity_lines()
+    {
+        return m_protections.front().parity_layout;
+    }
+
+    void enqueue_parity_request(const AddrVec_t& addr_vec, int type_id)
+    {
+        Request req(addr_vec, type_id);
+        req.addr = parity_lines().line_id(addr_vec);
+        req.scratchpad[PARITY_TAG_IDX] = PARITY_TAG;
+        req.arrive = m_clk;
+        if (type_id == m_RD_req_id)
+        {
+            req.callback = [this](Request& req) { s_parity_read_latency += req.depart - req.arrive; };
+            s_parity_read_reqs++;
+        }
+        else
+        {
+            s_parity_write_reqs++;
+        }
+
+        m_parity_queue.push_back(req);
+        s_parity_queue_max_len = std::max(s_parity_queue_max_len, m_parity_queue.size());
+    }
+
+    // Hand queued parity requests to the controller until it stops accepting them
+    void drain_parity_queue()
+    {
+        while (!m_parity_queue.empty())
+        {
+            bool is_success = m_parity_shared_queue ? m_ctrl->send(m_parity_queue.front()) : m_ctrl->priority_send(m_parity_queue.front());
+            if (!is_success)
+            {
+                break;
+            }
+            m_parity_queue.pop_front();
+        }
+    }
+
+    // Hold a read that failed its EDC check until the other sectors of its codeword, in the aligned columns around its
+    // own in the same row, have been read. The fetch reads are routed like parity requests (parity_queue)
+    void fetch_codeword(Protection& p, ReqBuffer::iterator &req_it)
+    {
+        int slot = 0;
+        if (m_free_fetches.empty())
+        {
+            slot = m_fetches.size();
+            m_fetches.emplace_back();
+        }
+        else
+        {
+            slot = m_free_fetches.back();
+            m_free_fetches.pop_back();
+        }
+        CodewordFetch& fetch = m_fetches[slot];
+        fetch.callback = req_it->callback;
+        fetch.outstanding = p.sectors_per_codeword;
+        s_codeword_fetches++;
+
+        req_it->callback = [this, slot](Request& req)
+        {
+            m_fetches[slot].demand = req;
+            m_fetches[slot].demand_done = m_clk;
+            codeword_read_done(slot);
+        };
+
+        int column = req_it->addr_vec[m_column_level];
+        int first_column = column - column % p.sectors_per_codeword;
+        for (int c = first_column; c < first_column + p.sectors_per_codeword; c++)
+        {
+            if (c == column)
+            {
+                continue;
+            }
+            Request req(req_it->addr_vec, m_RD_req_id);
+            req.addr_vec[m_column_level] = c;
+            req.addr = req_it->addr + (Addr_t) (c - column) * (Addr_t) m_access_bytes;
+            req.scratchpad[PARITY_TAG_IDX] = FETCH_TAG;
+            req.arrive = m_clk;
+            req.callback = [this, slot](Request& req) { codeword_read_done(slot); };
+            s_codeword_fetch_reads++;
+            m_parity_queue.push_back(req);
+        }
+        s_parity_queue_max_len = std::max(s_parity_queue_max_len, m_parity_queue.size());
+        drain_parity_queue();
+    }
+
+    // Hand an uncorrectable demand read to the redundancy of the memory system once it is decoded, with its own callback
+    void hold_uncorrectable_read(ReqBuffer::iterator &req_it)
+    {
+        int slot = 0;
+        if (m_free_held_callbacks.empty())
+        {
+            slot = m_held_callbacks.size();
+            m_held_callbacks.emplace_back();
+        }
+        else
+        {
+            slot = m_free_held_callbacks.back();
+            m_free_held_callbacks.pop_back();
+        }
+        m_held_callbacks[slot] = req_it->callback;
+        req_it->callback = [this, slot](Request& req)
+        {
+            req.callback = m_held_callbacks[slot];
+            m_free_held_callbacks.push_back(slot);
+            m_uncorrectable_handler(req);
+        };
+    }
+
+    // One read of a held codeword returned its data. The last one hands the codeword to the controller's decoder,
+    // which completes the demand read
+    void codeword_read_done(int slot)
+    {
+        CodewordFetch& fetch = m_fetches[slot];
+        if (--fetch.outstanding > 0)
+        {
+            return;
+        }
+        s_codeword_fetch_latency += m_clk - fetch.demand_done;
+
+        Request req = fetch.demand;
+        req.callback = fetch.callback;
+        req.scratchpad[DecoderPipeline::SCRATCHPAD_IDX] = DecoderPipeline::FULL_DECODE;
+        m_free_fetches.push_back(slot);
+        if (m_decoded_buffer.enabled())
+        {
+            m_decoded_buffer.insert(codeword_addr(protection_of(req.addr), req.addr));
+        }
+        m_ctrl->complete_read(req);
+    }
+
+    // Issue the next patrol scrub read if the demand buffers have been idle long enough and the rate allows it
+    void scrub()
+    {
+        if (!m_scrubber.tick(m_clk, m_ctrl->is_demand_idle() && m_parity_queue.empty()))
+        {
+            return;
+        }
+
+        size_t policy = 0;
+        Addr_t addr = -1;
+        if (!m_scrubber.next(m_scrub_stores, policy, addr))
+        {
+            return;
+        }
+
+        // One burst per codeword, as for demand requests. The channel of the codeword address may differ from
+        // this controller's (codewords are per channel), so the read is kept on this channel
+        Request req(addr, m_RD_req_id);
+        m_addr_mapper->apply(req);
+        req.addr_vec[m_dram->m_levels("channel")] = m_ctrl->m_channel_id;
+        req.scratchpad[PARITY_TAG_IDX] = SCRUB_TAG;
+        req.arrive = m_clk;
+        req.callback = [this, policy](Request& req) { check_scrubbed_codeword(m_protections[policy], req); };
+
+        m_scrubber.issued(m_clk);
+        s_scrub_read_reqs++;
+        m_parity_queue.push_back(req);
+        s_parity_queue_max_len = std::max(s_parity_queue_max_len, m_parity_queue.size());
+        drain_parity_queue();
+    }
+
+    // Scrub read data returned: check the codeword, correct it in place and write it back if it had errors
+    void check_scrubbed_codeword(Protection& p, const Request& req)
+    {
+        m_scrubber.completed();
+
+        CodewordStore::Codeword cw = p.storage->find(req.addr);
+        if (!cw)
+        {
+            return;
+        }
+
+        bool edc_failed = false;
+        bool corrected = false;
+        int error_count = 0;
+        if (m_timing_mode)
+        {
+            error_count = cw.header->error_count;
+            edc_failed = cw.header->error_count > 0;
+            if (edc_failed && timing_correctable(p, cw, cw.header->error_count))
+            {
+                corrected = true;
+                cw.header->error_count = 0;
+            }
+        }
+        else
+        {
+            wait_for_codeword(cw);
+            error_count = cw.header->error_count;
+            edc_failed = !check_edc(p, cw.data_span());
+            if (edc_failed)
+            {
+                cw = p.storage->find_mutable(req.addr);
+                std::span<uint8_t> data_block_with_edc = cw.data_span();
+                if (decodeECC(p, data_block_with_edc, cw.parity_span()))
+                {
+                    corrected = true;
+                    cw.header->error_count = 0;
+                    calculateEDC(p, data_block_with_edc.first(p.policy.data_block_size), data_block_with_edc.subspan(p.policy.data_block_size, p.policy.edc_size));
+                    cw.header->parity_size = calculateECC(p, data_block_with_edc, p.dynamic_ecc_size, cw.parity_buffer());
+                }
+                p.storage->seal(req.addr);
+            }
+        }
+
+        if (!edc_failed)
+        {
+            s_scrub_clean++;
+            if (m_parity_traffic && m_parity_read_always)
+            {
+                issue_parity_accesses(p, req.addr, req.addr_vec, true, false);
+            }
+            return;
+        }
+        corrected ? s_scrub_corrected++ : s_scrub_uncorrectable++;
+        if (m_error_log)
+        {
+            log_error_event(req, error_count, corrected, ErrorEventLog::Source::Scrub, false);
+        }
+
+        // The parity is needed for the correction, the corrected codeword and its parity are written back
+        if (corrected)
+        {
+            Request wb(req.addr_vec, m_WR_req_id);
+            wb.addr = req.addr;
+            wb.scratchpad[PARITY_TAG_IDX] = SCRUB_TAG;
+            wb.arrive = m_clk;
+            s_scrub_write_reqs++;
+            m_parity_queue.push_back(wb);
+        }
+        if (m_parity_traffic)
+        {
+            issue_parity_accesses(p, req.addr, req.addr_vec, true, corrected);
+        }
+        drain_parity_queue();
+    }
+
+    // Hand a write to the write-combining buffer instead of encoding its codeword right away
+    void combine_write(Protection& p, ReqBuffer::iterator &req_it)
+    {
+        Addr_t addr = codeword_addr(p, req_it->addr);
+        int sector = (req_it->addr - addr) / m_access_bytes;
+
+        s_wc_writes++;
+        p.s_writes++;
+        m_write_combiner.write(addr, sector, p.sectors_per_codeword, req_it->addr_vec, m_clk, m_wc_flushes);
+        flush_combined_writes();
+    }
+
+    // Encode the codewords of the flushed write-combining entries, once per entry
+    void flush_combined_writes()
+    {
+        for (const WriteCombiner::Flush& flush : m_wc_flushes)
+        {
+            Protection& p = protection_of(flush.codeword);
+            s_wc_flushes++;
+            switch (flush.reason)
+            {
+                case WriteCombiner::Reason::Eviction:  s_wc_eviction_flushes++; break;
+                case WriteCombiner::Reason::Timeout:   s_wc_timeout_flushes++; break;
+                case WriteCombiner::Reason::Watermark: s_wc_watermark_flushes++; break;
+                default: break;
+            }
+
+            if (flush.full)
+            {
+                s_wc_full_flushes++;
+            }
+            else
+            {
+                // The sectors that were not written come from the old codeword
+                s_wc_rmw_count++;
+                materialize_data_block(p, flush.codeword);
+            }
+
+            // Generated data stands in for the merged sectors (writes carry no payload)
+            if (m_timing_mode)
+            {
+                write_codeword_timing(p, flush.codeword, false);
+            }
+            else
+            {
+                // The old codeword (materialized above) is final, only the new one waits for the batch
+                m_batch_encodes = m_codec_batch > 1;
+                write_codeword_functional(p, flush.codeword, nullptr);
+                m_batch_encodes = false;
+            }
+
+            // A full-codeword write only updates the parity, a read-modify-write also needs the old one
+            if (m_parity_traffic)
+            {
+                issue_parity_accesses(p, flush.codeword, flush.addr_vec, !flush.full, true);
+            }
+        }
+        m_wc_flushes.clear();
+        run_codec_batch();
+    }
+
+    // Functional pipeline: real data blocks are encoded, corrupted, checked and corrected
+    void update_functional(Protection& p, ReqBuffer::iterator &req_it)
+    {
+        // Geometry of the policy (shadows the parameters of the default policy)
+        const size_t DATA_BLOCK_SIZE = p.policy.data_block_size;
+        const size_t EDC_SIZE = p.policy.edc_size;
+
+        // Only perform ECC when a valid request is found
+
+        // Handle write requests (WRITE)
+        if (req_it->type_id == Request::Type::Write)
+        {
+            
+            // 1. WRITE request: memory controller receives a write request (WRITE command), preparing to store a new data block from the high-speed parallel bus
+            
+            // Get the codeword address of the command
+            Addr_t addr = codeword_addr(p, req_it->addr);
+            write_codeword_functional(p, addr, req_it->m_payload);
+        }
+
+        // Handle read requests (READ)
+        if (req_it->type_id == Request::Type::Read)
+        {
+            // Get the codeword address of the command
+            Addr_t addr = codeword_addr(p, req_it->addr);
+
+            // Check if data block exists, if not, create one
+            materialize_data_block(p, addr);
+
+            /// Read existing data block (with EDC) and its ECC
+            CodewordStore::Codeword cw = p.storage->find(addr);
+            wait_for_codeword(cw);
+
+            // Faulty cells are read inverted. They are flipped in the stored codeword for this read only: a correction
+            // removes them, otherwise they are flipped back
+            bool fault_in_sector = false;
+            bool faulty = m_fault_map.enabled() && collect_fault_bits(p, req_it->addr_vec, fault_in_sector) > 0;
+            if (faulty)
+            {
+                cw = p.storage->find_mutable(addr);
+                BitErrorInjector::apply(cw.data_span(), m_fault_bits);
+            }
+            std::span<uint8_t> data_block_with_edc = cw.data_span();
+            std::span<uint8_t> data_block = data_block_with_edc.first(DATA_BLOCK_SIZE);
+            
+            // EDC verification: controller reads the data block and its corresponding EDC, then performs EDC check
+            bool edc_pass = check_edc(p, data_block_with_edc);
+
+            if (edc_pass)
+            {
+                edc_success_count++;
+
+                // If EDC passes, return data directly
+                if (req_it->m_payload != nullptr)
+                {
+                    std::memcpy(req_it->m_payload, data_block.data(), DATA_BLOCK_SIZE);
+                }
+                if (faulty)
+                {
+                    // Faults the EDC missed reach the requester but are not stored
+                    BitErrorInjector::apply(data_block_with_edc, m_fault_bits);
+                    p.storage->seal(addr);
+                }
+            }
+
+            // EDC failure: if EDC check fails, data may be corrupted, trigger ECC correction process
+            else
+            {   
+                edc_failure_count++;
+
+                // Read ECC codeword: memory controller retrieves full ECC codeword
+                // std::cerr << "[ECCPlugin] Warning: EDC failed. Attempting ECC correction..." << std::endl;
+
+                // The correction rewrites the record, which must not be shared with other addresses
+                cw = p.storage->find_mutable(addr);
+                data_block = cw.data_span().first(DATA_BLOCK_SIZE);
+
+                // Perform ECC correction using ECC algorithm over the protected [Data + EDC], in place.
+                // Only a requester that takes the data needs the correction before the request completes
+                CodecJob& job = m_codec_job;
+                job.kind = CodecJob::Kind::Decode;
+                job.cw = cw;
+                job.policy = &p - m_protections.data();
+                job.ecc_size = p.dynamic_ecc_size;
+                job.error_bits.clear();
+                if (faulty)
+                {
+                    job.error_bits = m_fault_bits;
+                }
+                bool has_payload = (req_it->m_payload != nullptr);
+                // The stored errors, before a correction clears them
+                int error_count = cw.header->error_count + (faulty ? m_fault_bits.size() : 0);
+                // The redundancy of the memory system and the error log need to know at once whether the read is correctable
+                bool corrected = run_codec_job(job, !has_payload && !m_uncorrectable_handler && !m_error_log);
+                p.storage->seal(addr);
+                if (m_error_log)
+                {
+                    log_error_event(*req_it, error_count, corrected, ErrorEventLog::Source::Demand, faulty);
+                }
+
+                // Return corrected data
+                if (corrected && has_payload)
+                {
+                    std::memcpy(req_it->m_payload, data_block.data(), DATA_BLOCK_SIZE);
+                }
+            }
+
+            // If EDC passes, data is verified and returned directly over the high-speed bus
+        }
+
+        // Handle partial write request (Partial WRITE)
+        if (req_it->type_id == Request::Type::PartialWrite) // Extended request type
+        {
+            // TODO: Handle partial write logic
+
+            // Get the codeword address of the command
+            Addr_t addr = codeword_addr(p, req_it->addr);
+            
+            // Read the old [Data + EDC]
+            materialize_data_block(p, addr);
+            CodewordStore::Codeword cw = p.storage->find_mutable(addr);
+            wait_for_codeword(cw);
+            std::span<uint8_t> old_data = cw.data_span().first(DATA_BLOCK_SIZE);
+
+            // Verify EDC
+            if (!check_edc(p, cw.data_span())) 
+            {
+                // EDC verification failed -> full ECC decode is needed first
+                // std::cerr << "[ECCPlugin] Partial Write: EDC check failed, need full ECC decoding!" << std::endl;
+                // TODO: Call ECCDecode to repair old data
+                // ECCDecode(old_data, m_ecc_storage[addr]);
+            }
+
+            // Update partial region of the data block
+            // TODO: Extend Request structure to support offset and length
+            // size_t offset = req_it->m_offset;  
+            // size_t length = req_it->m_length;    
+            size_t offset = 0;  
+            size_t length = 0;  
+
+            // Old data chunk (in place) and new chunk to write
+            std::span<uint8_t> old_chunk = old_data.subspan(offset, length);
+            std::span<const uint8_t> new_chunk(static_cast<uint8_t*>(req_it->m_payload), length);
+
+            // Partial write command: update only the modified region and incrementally update ECC to reduce computation.
+            // RS is linear, so the parity changes by the parity of the old chunk plus the parity of the new chunk
+            if (length > 0 && p.policy.ecc_type == "rs")
+            {
+                std::span<uint8_t> old_ecc = cw.parity_span();
+
+                int old_t = rs_t_from_parity_size(p, old_ecc.size());
+                m_partial_parity.resize(2 * old_ecc.size());
+                std::span<uint8_t> enc_old_chunk(m_partial_parity.data(), old_ecc.size());
+                std::span<uint8_t> enc_new_chunk(m_partial_parity.data() + old_ecc.size(), old_ecc.size());
+                ReedSolomonEncode(p, old_chunk, old_t, enc_old_chunk);
+                ReedSolomonEncode(p, new_chunk, old_t, enc_new_chunk);
+
+                for (size_t i = 0; i < old_ecc.size(); i++) {
+                    old_ecc[i] ^= enc_old_chunk[i] ^ enc_new_chunk[i];
+                }
+            }
+
+            // Update the old data
+            std::copy(new_chunk.begin(), new_chunk.end(), old_chunk.begin());
+
+            // Recalculate EDC and write back updated [Data + EDC]
+            calculateEDC(p, old_data, cw.data_span().subspan(DATA_BLOCK_SIZE, EDC_SIZE));
+            p.storage->seal(addr);
+        }  
+    };
+
+    // Store a new data block at a codeword address: [Data + EDC] and its ECC are computed once, in place
+    void write_codeword_functional(Protection& p, Addr_t addr, void* payload)
+    {
+        const size_t DATA_BLOCK_SIZE = p.policy.data_block_size;
+
+        // The record holding [Data + EDC | ECC] of this address
+        bool inserted = false;
+        CodewordStore::Codeword cw = p.storage->find_or_insert(addr, inserted);
+        wait_for_codeword(cw);
+        std::span<uint8_t> data_block = cw.data_span().first(DATA_BLOCK_SIZE);
+
+        // Check if the payload is availabl
+        bool has_payload = (payload != nullptr);
+        if (has_payload)
+        {
+            // TODO: Process user-provided data (m_payload already exists)
+
+            // You may need to cast m_payload to uint8_t* or std::vector<uint8_t> depending on your use case
+            // Here assuming m_payload is a uint8_t* type and size is DATA_BLOCK_SIZE
+            std::memcpy(data_block.data(), payload, DATA_BLOCK_SIZE);
+        }
+        else
+        {
+            // m_payload not present, generate a data block using generateRandomDataBlock()
+            generateRandomDataBlock(data_block);
+        }
+
+        // EDC computation: compute EDC value for the new data block and append it to the end
+        // ECC computation: compute ECC codeword for [Data + EDC] and store it next to it
+        // Errors hit the stored codeword after it has been encoded
+        size_t parity_size = store_codeword(p, cw, !has_payload, true);
+        if (m_batch_encodes)
+        {
+            m_batch_seals.push_back({&p, addr});
+        }
+        else
+        {
+            p.storage->seal(addr);
+        }
+
+        total_edc_size += p.policy.edc_size;
+        total_ecc_size += parity_size;
+        p.s_ecc_size += parity_size;
+    }
+
+    // Timing-only counterpart of write_codeword_functional()
+    void write_codeword_timing(Protection& p, Addr_t addr, bool has_payload)
+    {
+        bool inserted = false;
+        CodewordStore::Codeword cw = p.storage->find_or_insert(addr, inserted);
+        if (m_access_histogram)
+        {
+            close_error_epoch(p, cw);
+        }
+        cw.header->flags = CODEWORD_VALID | CODEWORD_DIRTY;
+        cw.header->parity_size = encoded_parity_size(p, addr);
+        // Only generated (payload-less) data is hit by errors, as in the functional write path
+        cw.header->error_count = has_payload ? 0 : sample_symbol_errors(p);
+
+        total_edc_size += p.policy.edc_size;
+        total_ecc_size += cw.header->parity_size;
+        p.s_ecc_size += cw.header->parity_size;
+    }
+
+    // Parity size a codeword written now is encoded with: the region's strength with adaptive ecc_strength
+    size_t encoded_parity_size(const Protection& p, Addr_t addr)
+    {
+        if (!m_adaptive.enabled())
+        {
+            return p.codeword_parity_size;
+        }
+        if (m_adaptive.level(addr) == AdaptiveStrength::Level::Weak)
+        {
+            s_adaptive_weak_writes++;
+            s_adaptive_saved_ecc_bytes += p.codeword_parity_size - p.weak_parity_size;
+            return p.weak_parity_size;
+        }
+        s_adaptive_strong_writes++;
+        return p.codeword_parity_size;
+    }
+
+    // Parity size of a stored codeword (timing mode), that of the static policy if it was never written
+    size_t codeword_parity_size(const Protection& p, Addr_t addr)
+    {
+        CodewordStore::Codeword cw = p.storage->find(addr);
+        return cw ? cw.header->parity_size : p.codeword_parity_size;
+    }
+
+    // Whether the ECC of a codeword corrects error_count corrupted symbols (timing mode). RS and BCH correct up to t
+    // errors, the mock Hamming decoder always succeeds like its functional version. Weak codewords of adaptive
+    // ecc_strength use their own t, or only have the EDC
+    bool timing_correctable(const Protection& p, const CodewordStore::Codeword& cw, int error_count)
+    {
+        bool weak = m_adaptive.enabled() && cw.header->parity_size != p.codeword_parity_size;
+        if (weak && p.weak_parity_size == 0)
+        {
+            return false;
+        }
+        return p.policy.ecc_type == "hamming" || error_count <= (weak ? p.weak_t : p.codeword_t);
+    }
+
+    // Codeword that holds a byte address (codewords are aligned to the start of the range of their policy)
+    Addr_t codeword_addr(const Protection& p, Addr_t addr)
+    {
+        return addr - (addr - p.policy.start) % (Addr_t) p.policy.data_block_size;
+    }
+
+    // Timing-only counterpart of the functional pipeline: same outcomes and statistics, without payloads
+    void update_timing(Protection& p, ReqBuffer::iterator &req_it)
+    {
+        Addr_t addr = codeword_addr(p, req_it->addr);
+
+        if (req_it->type_id == Request::Type::Write)
+        {
+            write_codeword_timing(p, addr, req_it->m_payload != nullptr);
+        }
+        else if (req_it->type_id == Request::Type::Read)
+        {
+            materialize_data_block(p, addr);
+            CodewordStore::Codeword cw = p.storage->find(addr);
+            if (m_access_histogram)
+            {
+                count_epoch_read(p, cw);
+            }
+
+            // Faults add to the stored errors on every read, at the positions the fault map gives
+            int fault_symbols = 0;
+            bool fault_in_sector = false;
+            if (m_fault_map.enabled())
+            {
+                fault_symbols = collect_fault_bits(p, req_it->addr_vec, fault_in_sector);
+            }
+            int error_count = cw.header->error_count + fault_symbols;
+
+            // Any corrupted symbol is assumed to be caught by the EDC. With codeword fetches, only the EDC of the sector
+            // read by the request is checked
+            bool edc_failed = error_count > 0;
+            if (edc_failed && m_codeword_fetch && p.sectors_per_codeword > 1)
+            {
+                edc_failed = fault_in_sector || (cw.header->error_count > 0 && sector_has_errors(p, cw.header->error_count));
+            }
+            if (!edc_failed)
+            {
+                edc_success_count++;
+            }
+            else
+            {
+                edc_failure_count++;
+
+                // A correction only clears the stored errors: the faulty cells stay faulty
+                bool corrected = timing_correctable(p, cw, error_count);
+                if (corrected)
+                {
+                    ecc_success_count++;
+                    cw.header->error_count = 0;
+                }
+                else
+                {
+                    ecc_failure_count++;
+                    p.s_ecc_failures++;
+                }
+                if (m_error_log)
+                {
+                    log_error_event(*req_it, error_count, corrected, ErrorEventLog::Source::Demand, fault_symbols > 0);
+                }
+            }
+        }
+        else if (req_it->type_id == Request::Type::PartialWrite)
+        {
+            materialize_data_block(p, addr);
+            p.storage->find(addr).header->flags |= CODEWORD_DIRTY;
+        }
+    }
+
+    // The bank of addr_vec, numbered across all the levels between the channel and the row
+    int flat_bank(const AddrVec_t& addr_vec) const
+    {
+        int bank = 0;
+        for (int level = 1; level <= m_bank_level; level++)
+        {
+            bank = bank * m_dram->m_organization.count[level] + addr_vec[level];
+        }
+        return bank;
+    }
+
+    // Error count of a functional codeword header: the bits injected into it (saturated)
+    static uint16_t saturated_error_count(size_t num_bits)
+    {
+        return (uint16_t) std::min<size_t>(num_bits, std::numeric_limits<uint16_t>::max());
+    }
+
+    // Append a read that failed its EDC check to the error event log
+    void log_error_event(const Request& req, int error_count, bool corrected, ErrorEventLog::Source source, bool fault)
+    {
+        ErrorEventLog::Record record;
+        record.clk = m_clk;
+        record.addr = req.addr;
+        record.bank = flat_bank(req.addr_vec);
+        record.row = req.addr_vec[m_row_level];
+        record.channel = m_ctrl->m_channel_id;
+        record.errors = saturated_error_count(error_count);
+        record.outcome = corrected ? ErrorEventLog::Outcome::Corrected : ErrorEventLog::Outcome::Uncorrectable;
+        record.source = source;
+        record.flags = fault ? ErrorEventLog::FLAG_FAULT : 0;
+        m_error_log->record(record);
+        s_error_log_events++;
+    }
+
+    // Collect the faulty bits of [Data + EDC] of the codeword whose sector addr_vec reads into m_fault_bits, counted from
+    // the first bit of the codeword. Returns the number of corrupted symbols (bytes) and sets demand_hit if one of them
+    // lies in the sector of addr_vec
+    int collect_fault_bits(const Protection& p, const AddrVec_t& addr_vec, bool& demand_hit)
+    {
+        m_fault_bits.clear();
+        demand_hit = false;
+
+        int bank = flat_bank(addr_vec);
+        int column = addr_vec[m_column_level];
+        int first_column = column - column % p.sectors_per_codeword;
+        m_fault_map.query(bank, addr_vec[m_row_level], first_column, first_column + p.sectors_per_codeword - 1, m_fault_bits);
+        if (m_fault_bits.empty())
+        {
+            return 0;
+        }
+
+        // Faults may hit the padding of the last sector, and overlapping faults the same bit
+        const uint32_t codeword_bits = (p.policy.data_block_size + p.policy.edc_size) * 8;
+        std::erase_if(m_fault_bits, [codeword_bits](uint32_t bit) { return bit >= codeword_bits; });
+        std::sort(m_fault_bits.begin(), m_fault_bits.end());
+        m_fault_bits.erase(std::unique(m_fault_bits.begin(), m_fault_bits.end()), m_fault_bits.end());
+
+        const uint32_t sector_bits = m_access_bytes * 8;
+        const uint32_t demand_sector = column - first_column;
+        int symbols = 0;
+        for (size_t i = 0; i < m_fault_bits.size(); i++)
+        {
+            symbols += (i == 0 || m_fault_bits[i] / 8 != m_fault_bits[i - 1] / 8);
+            demand_hit |= m_fault_bits[i] / sector_bits == demand_sector;
+        }
+        if (symbols > 0)
+        {
+            s_fault_reads++;
+            s_fault_symbols += symbols;
+        }
+        return symbols;
+    }
+
+    // Whether one of the error_count corrupted symbols of a codeword, at distinct uniformly drawn positions, lies in the
+    // sector of a read
+    bool sector_has_errors(const Protection& p, int error_count)
+    {
+        int n = p.codeword_symbols;
+        int s = std::min<int>(m_access_bytes, n);
+        double clean_prob = 1.0;
+        for (int i = 0; i < error_count; i++)
+        {
+            if (n - s - i <= 0)
+            {
+                return true;
+            }
+            clean_prob *= (double) (n - s - i) / (double) (n - i);
+        }
+        return m_timing_rng.next_open_unit() > clean_prob;
+    }
+
+    // Error epochs (timing mode): the errors drawn by a write or materialization are seen by every read up to the next write
+    void count_epoch_read(Protection& p, const CodewordStore::Codeword& cw)
+    {
+        if ((cw.header->flags >> CODEWORD_READS_SHIFT) < CODEWORD_MAX_READS)
+        {
+            cw.header->flags += 1 << CODEWORD_READS_SHIFT;
+        }
+        else
+        {
+            p.saturated_reads++;
+        }
+    }
+
+    void close_error_epoch(Protection& p, const CodewordStore::Codeword& cw)
+    {
+        p.histogram.add_epoch(cw.header->flags >> CODEWORD_READS_SHIFT);
+    }
+
+    // Draw the number of corrupted symbols of one codeword from Binomial(n, q) by inverting its CDF
+    int sample_symbol_errors(const Protection& p)
+    {
+        double u = m_timing_rng.next_open_unit();
+
+        int k = 0;
+        while (k < p.codeword_symbols && p.error_cdf[k] < u)
+        {
+            k++;
+        }
+
+        // At the BERs of interest a corrupted symbol almost always has exactly one flipped bit
+        injected_bit_errors += k;
+        return std::min(k, (int) std::numeric_limits<uint16_t>::max());
+    }
+
+    // Compute the EDC of the data part of cw and the ECC over its [Data + EDC], both stored in place, then flip the
+    // bits of the errors that hit the stored codeword. The EDC and the error sampling run here, in request order;
+    // the ECC and the flips may be left to a codec worker. Returns the parity size of the codeword.
+    size_t store_codeword(Protection& p, CodewordStore::Codeword& cw, bool inject_errors, bool allow_async)
+    {
+        std::span<uint8_t> data_block_with_edc = cw.data_span();
+        calculateEDC(p, data_block_with_edc.first(p.policy.data_block_size), data_block_with_edc.subspan(p.policy.data_block_size, p.policy.edc_size));
+
+        // Dynamically calculated required ECC size
+        int dynamic_ecc_size = p.dynamic_ecc_size;
+
+        CodecJob& job = m_codec_job;
+        job.kind = CodecJob::Kind::Encode;
+        job.cw = cw;
+        job.policy = &p - m_protections.data();
+        job.ecc_size = dynamic_ecc_size;
+        job.error_bits.clear();
+        if (inject_errors)
+        {
+            m_error_injector.sample(data_block_with_edc.size(), job.error_bits);
+            injected_bit_errors += job.error_bits.size();
+        }
+        if (m_batch_encodes)
+        {
+            if (m_num_batch_jobs == m_codec_batch_jobs.size())
+            {
+                m_codec_batch_jobs.emplace_back();
+            }
+            m_codec_batch_jobs[m_num_batch_jobs++] = job;
+        }
+        else
+        {
+            run_codec_job(job, allow_async);
+        }
+
+        return ecc_parity_size(p, dynamic_ecc_size);
+    }
+
+    // Run the encodes store_codeword() queued while m_batch_encodes was set: on the codec workers if there are
+    // any (which batch what they take from the queue), otherwise here, then seal their codewords
+    void run_codec_batch()
+    {
+        std::span<CodecJob> jobs(m_codec_batch_jobs.data(), m_num_batch_jobs);
+        if (m_codec_pool)
+        {
+            for (CodecJob& job : jobs)
+            {
+                run_codec_job(job, true);
+            }
+        }
+        else if (!jobs.empty())
+        {
+            execute_codec_jobs(jobs);
+        }
+        m_num_batch_jobs = 0;
+
+        for (auto [p, addr] : m_batch_seals)
+        {
+            p->storage->seal(addr);
+        }
+        m_batch_seals.clear();
+    }
+
+    // Run codec jobs in order. Consecutive encodes of one policy and ECC size share the RS/BCH batch kernels.
+    // Called from the codec workers like execute_codec_job()
+    void execute_codec_jobs(std::span<CodecJob> jobs)
+    {
+        size_t i = 0;
+        while (i < jobs.size())
+        {
+            size_t count = 1;
+            if (jobs[i].kind == CodecJob::Kind::Encode)
+            {
+                while (i + count < jobs.size() && jobs[i + count].kind == CodecJob::Kind::Encode
+                       && jobs[i + count].policy == jobs[i].policy && jobs[i + count].ecc_size == jobs[i].ecc_size)
+                {
+                    count++;
+                }
+            }
+            if (count == 1)
+            {
+                execute_codec_job(jobs[i]);
+            }
+            else
+            {
+                encode_batch(jobs.subspan(i, count));
+            }
+            i += count;
+        }
+    }
+
+    // Encode jobs of one policy and ECC size, RSKernel::MAX_BATCH codewords per batch kernel call
+    void encode_batch(std::span<CodecJob> jobs)
+    {
+        Protection& p = m_protections[jobs.front().policy];
+        int t = jobs.front().ecc_size / 2;
+        if (p.policy.ecc_type != "rs" && p.policy.ecc_type != "bch")
+        {
+            for (CodecJob& job : jobs)
+            {
+                execute_codec_job(job);
+            }
+            return;
+        }
+
+        const RSCodec* rs = p.policy.ecc_type == "rs" ? &m_rs_codecs.get(p.rs_symbol_bits, t) : nullptr;
+        const BCHCodec* bch = rs ? nullptr : &m_bch_codecs.get(p.bch_field_bits, t);
+        size_t parity_size = rs ? rs->parity_bytes() : bch->parity_bytes();
+
+        std::array<std::span<const uint8_t>, RSKernel::MAX_BATCH> data;
+        std::array<std::span<uint8_t>, RSKernel::MAX_BATCH> parity;
+        for (size_t first = 0; first < jobs.size(); first += RSKernel::MAX_BATCH)
+        {
+            size_t count = std::min<size_t>(RSKernel::MAX_BATCH, jobs.size() - first);
+            for (size_t k = 0; k < count; k++)
+            {
+                data[k] = jobs[first + k].cw.data_span();
+                parity[k] = jobs[first + k].cw.parity_buffer().first(parity_size);
+            }
+            if (rs)
+            {
+                rs->encode_batch(std::span(data).first(count), std::span(parity).first(count));
+            }
+            else
+            {
+                bch->encode_batch(std::span(data).first(count), std::span(parity).first(count));
+            }
+            if (count > 1)
+            {
+                std::atomic_ref<size_t>(s_codec_batches).fetch_add(1, std::memory_order_relaxed);
+                std::atomic_ref<size_t>(s_codec_batched_codewords).fetch_add(count, std::memory_order_relaxed);
+            }
+        }
+
+        // Errors hit the stored codewords after they have been encoded
+        for (CodecJob& job : jobs)
+        {
+            job.cw.header->parity_size = parity_size;
+            BitErrorInjector::apply(job.cw.data_span(), job.error_bits);
+            job.cw.header->error_count = saturated_error_count(job.error_bits.size());
+        }
+    }
+
+    // Hand a codec job to the workers if there are any and the caller does not need the result right away,
+    // otherwise run it here. Returns the result of a job run here, true for a queued job.
+    bool run_codec_job(CodecJob& job, bool allow_async)
+    {
+        if (!m_codec_pool)
+        {
+            return execute_codec_job(job);
+        }
+        if (allow_async && m_codec_pool->submit(job))
+        {
+            s_codec_async_jobs++;
+            return true;
+        }
+        s_codec_inline_jobs++;
+        return execute_codec_job(job);
+    }
+
+    // Wait until the codec job in flight for cw (if any) has finished, so that its data and parity are final
+    void wait_for_codeword(const CodewordStore::Codeword& cw)
+    {
+        if (m_codec_pool && CodecWorkerPool::wait_for(cw))
+        {
+            s_codec_waits++;
+        }
+    }
+
+    // Run a codec job. Called from the codec workers: only touches the codeword of the job, the (stateless) EDC
+    // engine and RS/BCH codecs, and adds to the ECC counters atomically. Returns false on an uncorrectable codeword.
+    bool execute_codec_job(CodecJob& job)
+    {
+        Protection& p = m_protections[job.policy];
+        std::span<uint8_t> data_block_with_edc = job.cw.data_span();
+        if (job.kind == CodecJob::Kind::Encode)
+        {
+            job.cw.header->parity_size = calculateECC(p, data_block_with_edc, job.ecc_size, job.cw.parity_buffer());
+            BitErrorInjector::apply(data_block_with_edc, job.error_bits);
+            job.cw.header->error_count = saturated_error_count(job.error_bits.size());
+            return true;
+        }
+
+        bool corrected = decodeECC(p, data_block_with_edc, job.cw.parity_span());
+
+        // The fault bits a decode job carries were flipped for this read only: a failed correction flips them back
+        if (!corrected)
+        {
+            BitErrorInjector::apply(data_block_with_edc, job.error_bits);
+        }
+
+        // Correction succeeded: if number of errors ≤ t, ECC successfully repairs data and writes updated ECC/EDC
+        if (corrected)
+        {
+            std::atomic_ref<size_t>(ecc_success_count).fetch_add(1, std::memory_order_relaxed);
+            job.cw.header->error_count = 0;
+
+            // std::cerr << "[ECCPlugin] ECC Correction Success." << std::endl;
+
+            // Recalculate EDC and ECC
+            calculateEDC(p, data_block_with_edc.first(p.policy.data_block_size), data_block_with_edc.subspan(p.policy.data_block_size, p.policy.edc_size));
+            job.cw.header->parity_size = calculateECC(p, data_block_with_edc, job.ecc_size, job.cw.parity_buffer());
+        }
+        // Correction failed: if ECC fails, mark as uncorrectable error (UE)
+        else
+        {
+            std::atomic_ref<size_t>(ecc_failure_count).fetch_add(1, std::memory_order_relaxed);
+            std::atomic_ref<size_t>(p.s_ecc_failures).fetch_add(1, std::memory_order_relaxed);
+
+            // ECC correction failed, mark as UE
+            // std::cerr << "[ECCPlugin] UE: Uncorrectable error during read!" << std::endl;
+
+            // Retry logic: controller may attempt a retry to re-read data and ECC
+            bool retry_success = false;
+
+            // Simulate retry logic
+            if (retry_success)
+            {
+                // TODO: Retry read
+                // std::cerr << "[ECCPlugin] Retry succeeded!" << std::endl;
+            }
+            else
+            {
+                // RAID/mirroring: with cross-channel redundancy, update() hands the read to the memory system, which
+                // rebuilds it from the other channels (see ChannelRedundancy)
+                bool raid_recovery_success = static_cast<bool>(m_uncorrectable_handler);
+                if (raid_recovery_success)
+                {
+                    // std::cerr << "[ECCPlugin] Recovery from RAID redundancy success." << std::endl;
+                }
+                else
+                {
+                    // Cannot recover, report fatal UE to CPU/system
+                    // std::cerr << "[ECCPlugin] Fatal UE reported to CPU." << std::endl;
+                    // TODO: Notify upper-level system / terminate simulation / trigger error handling logic
+                }
+            }
+        }
+        return corrected;
+    }
+
+    // Bytes of parity calculateECC() produces for an ECC size
+    size_t ecc_parity_size(const Protection& p, int ecc_size)
+    {
+        if (p.policy.ecc_type == "rs")
+        {
+            return m_rs_codecs.get(p.rs_symbol_bits, ecc_size / 2).parity_bytes();
+        }
+        if (p.policy.ecc_type == "bch")
+        {
+            return m_bch_codecs.get(p.bch_field_bits, ecc_size / 2).parity_bytes();
+        }
+        return ecc_size;
+    }
+
+    // Check the stored EDC of a [Data + EDC] block against its data
+    bool check_edc(const Protection& p, std::span<const uint8_t> data_block_with_edc)
+    {
+        const size_t DATA_BLOCK_SIZE = p.policy.data_block_size;
+        uint8_t expected_edc[8] = {0};
+        std::span<uint8_t> expected(expected_edc, std::min<size_t>(p.policy.edc_size, sizeof(expected_edc)));
+        calculateEDC(p, data_block_with_edc.first(DATA_BLOCK_SIZE), expected);
+        return std::equal(expected.begin(), expected.end(), data_block_with_edc.begin() + DATA_BLOCK_SIZE)
+            && std::all_of(data_block_with_edc.begin() + DATA_BLOCK_SIZE + expected.size(), data_block_with_edc.end(), [](uint8_t b) { return b == 0; });
+    }
+
+    // Create a fake [Data + EDC | ECC] codeword (with injected errors) for an address that was never written
+    // Returns true if a new codeword had to be created. allow_async: nobody reads the codeword right away
+    bool materialize_data_block(Protection& p, Addr_t addr, bool allow_async = false)
+    {
+        // Look up first: find_or_insert() would unshare an existing deduplicated record
+        if (p.storage->contains(addr))
+        {
+            return false;
+        }
+        bool inserted = false;
+        CodewordStore::Codeword cw = p.storage->find_or_insert(addr, inserted);
+
+        if (m_timing_mode)
+        {
+            cw.header->flags |= CODEWORD_VALID;
+            cw.header->parity_size = encoded_parity_size(p, addr);
+            cw.header->error_count = sample_symbol_errors(p);
+            return true;
+        }
+
+        // std::cerr << "[ECCPlugin] Data block not found! Generating fake data block..." << std::endl;
+        generateRandomDataBlock(cw.data_span().first(p.policy.data_block_size));
+        store_codeword(p, cw, true, allow_async);   // Inject random bit errors
+        p.storage->seal(addr);
+        return true;
+    }
+
+    // Opt-in ACT-time hook: model the controller fetching the codeword of a read while its row is being opened,
+    // so that the final RD finds [Data + EDC] already staged instead of materializing it on the critical path
+    void prefetch_on_activate(Protection& p, ReqBuffer::iterator &req_it)
+    {
+        if (req_it->type_id != Request::Type::Read)
+        {
+            return;
+        }
+
+        act_prefetch_count++;
+        if (materialize_data_block(p, codeword_addr(p, req_it->addr), true))
+        {
+            act_prefetch_fill_count++;
+        }
+    }
+
+    // Function to fill a data block with random bytes (or zeros, for a zero_block_fraction of the blocks)
+    void generateRandomDataBlock(std::span<uint8_t> data_block)
+    {
+        if (m_zero_block_fraction > 0.0 && m_data_rng.next_open_unit() < m_zero_block_fraction)
+        {
+            std::fill(data_block.begin(), data_block.end(), 0);
+            return;
+        }
+
+        // Fill it 8 bytes at a time from the persistent, seeded payload generator
+        const size_t size = data_block.size();
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t word = m_data_rng();
+            std::memcpy(data_block.data() + i, &word, 8);
+        }
+        if (i < size)
+        {
+            uint64_t word = m_data_rng();
+            std::memcpy(data_block.data() + i, &word, size - i);
+        }
+    }
+
+    // Supported EDC calculation methods (checksum, crc32, crc32c, crc64), stored little-endian into edc
+    void calculateEDC(const Protection& p, std::span<const uint8_t> data_block, std::span<uint8_t> edc)
+    {
+        uint64_t edc_value = p.edc_engine->compute(data_block);
+        size_t edc_bytes = p.edc_engine->width() / 8;
+        for (size_t i = 0; i < edc.size(); ++i)
+        {
+            edc[i] = (i < edc_bytes) ? (edc_value >> (i * 8)) & 0xFF : 0;
+        }
+    }
+
+    // Supported ECC methods, the ECC is written to the front of ecc. Returns the number of bytes written.
+    size_t calculateECC(const Protection& p, std::span<const uint8_t> data_block, size_t ecc_size, std::span<uint8_t> ecc)
+    {
+        // TODO: Replace with more robust ECC libraries if needed
+        const std::string& ecc_type = p.policy.ecc_type;
+
+        if (ecc_type == "hamming")
+        {
+            return HammingEncode(data_block, ecc.first(ecc_size));
+        }
+        else if (ecc_type == "rs")
+        {
+            const RSCodec& rs = m_rs_codecs.get(p.rs_symbol_bits, ecc_size / 2);
+            rs.encode(data_block, ecc.first(rs.parity_bytes()));
+            return rs.parity_bytes();
+        }
+        else if (ecc_type == "bch")
+        {
+            const BCHCodec& bch = m_bch_codecs.get(p.bch_field_bits, ecc_size / 2);
+            bch.encode(data_block, ecc.first(bch.parity_bytes()));
+            return bch.parity_bytes();
+        }
+        else
+        {
+            // std::cerr << "[ECCPlugin] Error: Unsupported ECC type!" << std::endl;
+            exit(1);
+        }
+    }
+
+    // Simplified Hamming encoder (parity-based)
+    size_t HammingEncode(std::span<const uint8_t> data_block, std::span<uint8_t> ecc)
+    {
+        for (size_t i = 0; i < ecc.size(); i++)
+        {
+            uint8_t parity = 0;
+            for (size_t j = 0; j < data_block.size(); j++)
+            {
+                parity ^= data_block[j];
+            }
+            ecc[i] = parity;  // Repeat parity for all ECC bytes
+        }
+
+        return ecc.size();
+    }
+
+    // RS Encoder: writes the 2t parity symbols of data_block to the front of parity
+    void ReedSolomonEncode(const Protection& p, std::span<const uint8_t> data_block, int t, std::span<uint8_t> parity)
+    {
+        const RSCodec& rs = m_rs_codecs.get(p.rs_symbol_bits, t);
+        rs.encode(data_block, parity.first(rs.parity_bytes()));
+    }
+
+    // RS Decoder: corrects data_block and ecc_codeword in place, returns false on an uncorrectable codeword
+    bool ReedSolomonDecode(const Protection& p, std::span<uint8_t> data_block, std::span<uint8_t> ecc_codeword)
+    {
+        const RSCodec& rs = m_rs_codecs.get(p.rs_symbol_bits, rs_t_from_parity_size(p, ecc_codeword.size()));
+        return rs.decode(data_block, ecc_codeword) >= 0;
+    }
+
+    // Number of correctable symbols of an RS parity region of the given size in bytes
+    int rs_t_from_parity_size(const Protection& p, size_t parity_size)
+    {
+        return parity_size / (2 * ((p.rs_symbol_bits + 7) / 8));
+    }
+    
+    // BCH Decoder: corrects data_block and ecc_codeword in place, returns false on an uncorrectable codeword.
+    // Every codeword of a policy is encoded with its memoized t, which the parity size alone does not identify
+    bool BCHDecode(const Protection& p, std::span<uint8_t> data_block, std::span<uint8_t> ecc_codeword)
+    {
+        const BCHCodec& bch = m_bch_codecs.get(p.bch_field_bits, p.codeword_t);
+        return bch.decode(data_block, ecc_codeword.first(bch.parity_bytes())) >= 0;
+    }
+
+    
+
+    // Simplified ECC decoder interface
+    bool decodeECC(const Protection& p, std::span<uint8_t> data_block, std::span<uint8_t> ecc_codeword)
+    {
+        // TODO: Implement real decoding logic for each ECC type
+        const std::string& ecc_type = p.policy.ecc_type;
+
+        if (ecc_type == "hamming")
+        {
+            // Hamming decoding not implemented
+        }
+        else if (ecc_type == "rs")
+        {
+            return ReedSolomonDecode(p, data_block, ecc_codeword);  // Use RS decoder
+        }
+        else if (ecc_type == "bch")
+        {
+            return BCHDecode(p, data_block, ecc_codeword);  // Use BCH decoder
+        }
+
+        // For demonstration purposes, always assume correction succeeded
+        return true;
+    }
+
+    // Calculate the dynamically required ECC size based on current data block size and error target.
+    // Only called from init_protection(), requests use the memoized Protection::dynamic_ecc_size
+    int calculate_dynamic_ecc_size(const Protection& p, size_t data_block_size)
+    {
+        return ReliabilityEstimator::dynamic_ecc_size(data_block_size, bit_error_rate, p.policy.ecc_size, p.policy.max_failure_prob);
+    }
+
+    // TODO: Add more variable calculations if needed
+
+    // Close the epochs still open and save the histograms of every policy for the reliability estimator
+    void save_access_histogram()
+    {
+        std::vector<AccessHistogram> histograms;
+        for (Protection& p : m_protections)
+        {
+            size_t cursor = 0;
+            Addr_t addr;
+            while (p.storage->next_addr(cursor, addr))
+            {
+                close_error_epoch(p, p.storage->find(addr));
+            }
+            // Saturated epochs are counted in the top bin they reached, with all of their reads
+            p.histogram.reads[std::bit_width(CODEWORD_MAX_READS) - 1] += p.saturated_reads;
+            histograms.push_back(p.histogram);
+        }
+        ReliabilityEstimator::save(m_access_histogram_filename, histograms);
+        std::cout << "[ECCPlugin] Access histogram saved to " << m_access_histogram_filename << "." << std::endl;
+    }
+
+    // Codeword image: a header naming the protection policies, then one CodewordStore section per policy
+    struct ImageHeader
+    {
+        uint64_t magic;
+        uint64_t timing_mode;
+        uint64_t num_policies;
+    };
+
+    struct ImagePolicy
+    {
+        uint64_t start;
+        uint64_t end;
+        uint64_t data_block_size;
+        uint64_t edc_size;
+    };
+
+    // Save [Data + EDC | ECC] of every stored codeword (with the errors injected so far)
+    void serialize() override
+    {
+        std::ofstream image(m_serialization_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!image)
+        {
+            throw ConfigurationError("ECCPlugin: Cannot open the codeword image \"{}\" for writing!", m_serialization_filename);
+        }
+        write_image(image);
+        if (!image)
+        {
+            throw ConfigurationError("ECCPlugin: Failed to write the codeword image \"{}\"!", m_serialization_filename);
+        }
+        std::cout << "[ECCPlugin] Codeword image saved to " << m_serialization_filename << "." << std::endl;
+    }
+
+    // Restore the codewords saved by serialize() into the (empty) stores of the same protection policies
+    void deserialize() override
+    {
+        if (!std::filesystem::exists(m_deserialization_filename))
+        {
+            throw ConfigurationError("ECCPlugin: Codeword image \"{}\" not found!", m_deserialization_filename);
+        }
+        std::ifstream image(m_deserialization_filename, std::ios::in | std::ios::binary);
+        read_image(image, m_deserialization_filename);
+        std::cout << "[ECCPlugin] Restored " << s_restored_codewords << " codewords from " << m_deserialization_filename << "." << std::endl;
+    }
+
+    // The simulator checkpoint holds the codeword image, with the pending writes encoded first
+    void save_checkpoint(std::ostream& out) override
+    {
+        if (m_write_combiner.enabled())
+        {
+            m_write_combiner.drain(m_wc_flushes);
+            flush_combined_writes();
+        }
+        if (m_codec_pool)
+        {
+            m_codec_pool->drain();
+        }
+        write_image(out);
+    }
+
+    void load_checkpoint(std::istream& in) override
+    {
+        read_image(in, "checkpoint");
+    }
+
+    void write_image(std::ostream& image)
+    {
+        ImageHeader header = {IMAGE_MAGIC, m_timing_mode, m_protections.size()};
+        image.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const Protection& p : m_protections)
+        {
+            ImagePolicy policy = {(uint64_t) p.policy.start, (uint64_t) p.policy.end, p.policy.data_block_size, p.policy.edc_size};
+            image.write(reinterpret_cast<const char*>(&policy), sizeof(policy));
+        }
+        for (const Protection& p : m_protections)
+        {
+            p.storage->save(image);
+        }
+    }
+
+    void read_image(std::istream& image, const std::string& source)
+    {
+        ImageHeader header;
+        if (!image.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != IMAGE_MAGIC)
+        {
+            throw ConfigurationError("ECCPlugin: \"{}\" is not a codeword image!", source);
+        }
+        if (header.timing_mode != m_timing_mode || header.num_policies != m_protections.size())
+        {
+            throw ConfigurationError("ECCPlugin: Codeword image \"{}\" was saved with another mode or protection policies!", source);
+        }
+        for (const Protection& p : m_protections)
+        {
+            ImagePolicy policy;
+            image.read(reinterpret_cast<char*>(&policy), sizeof(policy));
+            if (!image || policy.start != (uint64_t) p.policy.start || policy.end != (uint64_t) p.policy.end
+                || policy.data_block_size != p.policy.data_block_size || policy.edc_size != p.policy.edc_size)
+            {
+                throw ConfigurationError("ECCPlugin: Codeword image \"{}\" was saved with another protection policy {}!", source, p.policy.name);
+            }
+        }
+
+        // Same ranges and block sizes: a section only loads into a store of the same record geometry (ECC type and size)
+        for (Protection& p : m_protections)
+        {
+            if (!p.storage->load(image))
+            {
+                throw ConfigurationError("ECCPlugin: Codeword image \"{}\" does not match the ECC of protection policy {}!", source, p.policy.name);
+            }
+            s_restored_codewords += p.storage->size();
+        }
+    }
+
+    // Called at the end of simulation — used to output final logs and clean up data
+    void finalize() override
+    {
+        std::cout << "[ECCPlugin] Finalizing, clearing memory storage..." << std::endl;
+
+        // Encode whatever is left in the write-combining buffer
+        if (m_write_combiner.enabled())
+        {
+            m_write_combiner.drain(m_wc_flushes);
+            flush_combined_writes();
+        }
+        s_wc_coalescing_ratio = s_wc_flushes ? (float) s_wc_writes / (float) s_wc_flushes : 0.0f;
+
+        // Fold in the results of the codec jobs still in flight and stop the workers
+        if (m_codec_pool)
+        {
+            m_codec_pool.reset();
+        }
+
+        if (m_error_log)
+        {
+            m_error_log->close();
+            s_error_log_stalls = m_error_log->s_stalls;
+        }
+
+        if (m_serialize)
+        {
+            serialize();
+        }
+        if (m_access_histogram)
+        {
+            save_access_histogram();
+        }
+
+        // Release all stored data blocks and ECC codewords at once
+        storage_footprint_bytes = 0;
+        for (Protection& p : m_protections)
+        {
+            storage_footprint_bytes += p.storage->memory_footprint();
+            storage_codewords += p.storage->size();
+            storage_records += p.storage->records();
+            storage_dedup_merges += p.storage->merges();
+        }
+        size_t parity_cache_accesses = s_parity_cache_read_hits + s_parity_cache_read_misses + s_parity_cache_write_hits + s_parity_cache_write_misses;
+        s_parity_cache_hit_rate = parity_cache_accesses ? (float) (s_parity_cache_read_hits + s_parity_cache_write_hits) / (float) parity_cache_accesses : 0.0f;
+        s_avg_parity_read_latency = s_parity_read_reqs ? (float) s_parity_read_latency / (float) s_parity_read_reqs : 0.0f;
+        s_parity_row_hit_rate = s_parity_dram_accesses ? 1.0f - std::min(1.0f, (float) s_parity_activations / (float) s_parity_dram_accesses) : 0.0f;
+        if (m_codeword_fetch)
+        {
+            size_t demand_reads = 0;
+            for (const Protection& p : m_protections)
+            {
+                demand_reads += p.s_reads;
+            }
+            s_avg_codeword_fetch_latency = s_codeword_fetches ? (float) s_codeword_fetch_latency / (float) s_codeword_fetches : 0.0f;
+            s_read_amplification = demand_reads ? (float) (demand_reads + s_codeword_fetch_reads) / (float) demand_reads : 0.0f;
+        }
+        Totals totals = get_totals();
+        s_ecc_failures_per_gb = totals.read_bytes ? (float) ((double) totals.ecc_failures * 1e9 / (double) totals.read_bytes) : 0.0f;
+        s_parity_bytes_per_request = totals.reads + totals.writes ? (float) totals.parity_traffic_bytes / (float) (totals.reads + totals.writes) : 0.0f;
+        size_t decoded_buffer_lookups = s_decoded_buffer_hits + s_decoded_buffer_misses;
+        s_decoded_buffer_hit_rate = decoded_buffer_lookups ? (float) s_decoded_buffer_hits / (float) decoded_buffer_lookups : 0.0f;
+        for (Protection& p : m_protections)
+        {
+            p.storage->release();
+        }
+
+        std::cout << "[ECCPlugin] Storage cleared." << std::endl;
+    }
+  };
+
+} // namespace Ramulator
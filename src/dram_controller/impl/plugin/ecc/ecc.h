@@ -0,0 +1,51 @@
+#ifndef RAMULATOR_PLUGIN_ECC_H_
+#define RAMULATOR_PLUGIN_ECC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <functional>
+
+#include "base/request.h"
+
+namespace Ramulator {
+
+class IECCPlugin {
+public:
+    // Request::scratchpad slot and tag of the requests of the memory system's cross-channel redundancy (see
+    // ChannelRedundancy), which the plugin passes through like its own requests
+    static constexpr int REDUNDANCY_TAG_IDX = 3;
+    static constexpr int REDUNDANCY_TAG = 0x45434352;     // "ECCR"
+
+    // Called with a demand read whose codeword the ECC could not correct, once its data arrived. The handler takes
+    // the read over and calls its callback once the data is recovered
+    using UncorrectableHandler = std::function<void(Request& req)>;
+
+    // Counters of one channel that the memory system sums over all channels
+    struct Totals {
+        size_t reads = 0;                   // Demand reads
+        size_t writes = 0;                  // Demand writes
+        size_t read_bytes = 0;              // Data bytes of the demand reads
+        size_t edc_failures = 0;
+        size_t ecc_corrections = 0;
+        size_t ecc_failures = 0;
+        size_t parity_bytes = 0;            // Parity bytes encoded
+        size_t parity_traffic_bytes = 0;    // Bytes of the parity reads and writes issued to the DRAM
+    };
+
+    // Whether the plugin keeps the data of the codewords (functional mode)
+    virtual bool keeps_data() const = 0;
+    // Copies the stored data at addr (within one data block, materialized if it was never written) into data.
+    // Returns false if the plugin keeps no data (timing mode) or the range crosses a data block
+    virtual bool read_data(Addr_t addr, std::span<uint8_t> data) = 0;
+    // Whether the request is one of the plugin's own parity, scrub or codeword fetch requests, or a redundancy request
+    virtual bool is_own_request(const Request& req) = 0;
+    // Hands the uncorrectable demand reads to handler instead of completing them
+    virtual void set_uncorrectable_handler(UncorrectableHandler handler) = 0;
+    // Counters of the plugin, final once it is finalized
+    virtual Totals get_totals() const = 0;
+};
+
+}
+
+#endif  // RAMULATOR_PLUGIN_ECC_H_
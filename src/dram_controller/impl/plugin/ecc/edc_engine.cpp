@@ -0,0 +1,341 @@
+#include "dram_controller/impl/plugin/ecc/edc_engine.h"
+
+#include <cstring>
+
+#include "base/exception.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RAMULATOR_EDC_X86 1
+#include <immintrin.h>
+#else
+#define RAMULATOR_EDC_X86 0
+#endif
+
+namespace Ramulator {
+
+namespace {
+
+// The same parameters boost::crc_32_type and boost::crc_optimal<64, 0x42F0E1EBA9EA3693> use
+constexpr CRCSpec CRC32_SPEC  = {32, 0x04C11DB7,         0xFFFFFFFF, 0xFFFFFFFF, true};
+constexpr CRCSpec CRC32C_SPEC = {32, 0x1EDC6F41,         0xFFFFFFFF, 0xFFFFFFFF, true};
+constexpr CRCSpec CRC64_SPEC  = {64, 0x42F0E1EBA9EA3693, 0,          0,          false};
+
+uint64_t reflect(uint64_t val, int width) {
+  uint64_t out = 0;
+  for (int i = 0; i < width; i++) {
+    if (val & (1ull << i)) {
+      out |= 1ull << (width - 1 - i);
+    }
+  }
+  return out;
+}
+
+uint64_t load_le64(const uint8_t* p) {
+  uint64_t v;
+  std::memcpy(&v, p, 8);
+  return v;
+}
+
+uint64_t load_be64(const uint8_t* p) {
+  return __builtin_bswap64(load_le64(p));
+}
+
+uint64_t width_mask(int width) {
+  return width == 64 ? ~0ull : ((1ull << width) - 1);
+}
+
+struct CPUFeatures {
+  bool sse42 = false;
+  bool pclmul = false;
+  bool avx2 = false;
+
+  CPUFeatures() {
+#if RAMULATOR_EDC_X86
+    __builtin_cpu_init();
+    sse42  = __builtin_cpu_supports("sse4.2");
+    pclmul = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+    avx2   = __builtin_cpu_supports("avx2");
+#endif
+  }
+};
+
+const CPUFeatures& cpu_features() {
+  static const CPUFeatures features;
+  return features;
+}
+
+#if RAMULATOR_EDC_X86
+__attribute__((target("pclmul,ssse3")))
+inline __m128i fold(__m128i x, __m128i k) {
+  return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11));
+}
+
+__attribute__((target("pclmul,ssse3")))
+inline __m128i load_chunk(const uint8_t* p, bool reflected) {
+  __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  if (!reflected) {
+    // Byte-reverse so that bit i of the 128-bit lane is the coefficient of x^i
+    x = _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+  }
+  return x;
+}
+
+__attribute__((target("pclmul,ssse3")))
+inline void store_chunk(uint8_t* p, __m128i x, bool reflected) {
+  if (!reflected) {
+    x = _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x);
+}
+#endif
+
+}       // namespace
+
+
+std::unique_ptr<IEDCEngine> IEDCEngine::create(const std::string& edc_type, bool allow_simd) {
+  const CPUFeatures& cpu = cpu_features();
+
+  if (edc_type == "checksum") {
+    return std::make_unique<ChecksumEngine>(allow_simd && cpu.avx2);
+  }
+
+  CRCEngine::Kernel kernel = CRCEngine::Kernel::Slicing8;
+  if (edc_type == "crc32") {
+    if (allow_simd && cpu.pclmul) kernel = CRCEngine::Kernel::PCLMUL;
+    return std::make_unique<CRCEngine>(edc_type, CRC32_SPEC, kernel);
+  } else if (edc_type == "crc32c") {
+    if (allow_simd && cpu.sse42) kernel = CRCEngine::Kernel::SSE42;
+    return std::make_unique<CRCEngine>(edc_type, CRC32C_SPEC, kernel);
+  } else if (edc_type == "crc64") {
+    if (allow_simd && cpu.pclmul) kernel = CRCEngine::Kernel::PCLMUL;
+    return std::make_unique<CRCEngine>(edc_type, CRC64_SPEC, kernel);
+  }
+
+  throw ConfigurationError("Unsupported EDC type \"{}\" (expected checksum, crc32, crc32c or crc64)!", edc_type);
+}
+
+
+CRCEngine::CRCEngine(std::string type, const CRCSpec& spec, Kernel kernel):
+m_type(type), m_spec(spec), m_kernel(kernel) {
+  if (m_spec.width != 32 && m_spec.width != 64) {
+    throw ConfigurationError("CRC width {} is not supported!", m_spec.width);
+  }
+
+  // Byte-at-a-time table, then derive the slicing tables from it
+  if (m_spec.reflected) {
+    uint64_t rpoly = reflect(m_spec.poly, m_spec.width);
+    for (int b = 0; b < 256; b++) {
+      uint64_t c = b;
+      for (int i = 0; i < 8; i++) {
+        c = (c & 1) ? (c >> 1) ^ rpoly : (c >> 1);
+      }
+      m_tables[0][b] = c;
+    }
+    for (int k = 1; k < 8; k++) {
+      for (int b = 0; b < 256; b++) {
+        uint64_t prev = m_tables[k - 1][b];
+        m_tables[k][b] = (prev >> 8) ^ m_tables[0][prev & 0xFF];
+      }
+    }
+  } else {
+    uint64_t apoly = m_spec.poly << (64 - m_spec.width);
+    for (int b = 0; b < 256; b++) {
+      uint64_t c = (uint64_t) b << 56;
+      for (int i = 0; i < 8; i++) {
+        c = (c >> 63) ? (c << 1) ^ apoly : (c << 1);
+      }
+      m_tables[0][b] = c;
+    }
+    for (int k = 1; k < 8; k++) {
+      for (int b = 0; b < 256; b++) {
+        uint64_t prev = m_tables[k - 1][b];
+        m_tables[k][b] = (prev << 8) ^ m_tables[0][prev >> 56];
+      }
+    }
+  }
+
+  m_fold16 = fold_constants(128);
+  m_fold64 = fold_constants(512);
+}
+
+uint64_t CRCEngine::xpow_mod(int k) const {
+  const int w = m_spec.width;
+  const uint64_t mask = width_mask(w);
+  uint64_t v = 1;
+  for (int i = 0; i < k; i++) {
+    bool carry = (v >> (w - 1)) & 1;
+    v = (v << 1) & mask;
+    if (carry) {
+      v ^= m_spec.poly;
+    }
+  }
+  return v;
+}
+
+std::array<uint64_t, 2> CRCEngine::fold_constants(int distance_bits) const {
+  // A residue H * x^64 + L folded over d bits becomes H * (x^(d+64) mod P) + L * (x^d mod P).
+  // With bit-reflected operands the carry-less product comes out shifted by one, hence the x^-1.
+  if (m_spec.reflected) {
+    return {reflect(xpow_mod(distance_bits + 63), 64), reflect(xpow_mod(distance_bits - 1), 64)};
+  } else {
+    return {xpow_mod(distance_bits), xpow_mod(distance_bits + 64)};
+  }
+}
+
+std::string CRCEngine::name() const {
+  switch (m_kernel) {
+    case Kernel::SSE42:  return m_type + "/sse4.2";
+    case Kernel::PCLMUL: return m_type + "/pclmul";
+    default:             return m_type + "/slicing8";
+  }
+}
+
+uint64_t CRCEngine::compute(std::span<const uint8_t> data) const {
+  uint64_t crc = m_spec.reflected ? m_spec.init : (m_spec.init << (64 - m_spec.width));
+
+  switch (m_kernel) {
+    case Kernel::SSE42:  crc = update_sse42(crc, data.data(), data.size()); break;
+    case Kernel::PCLMUL: crc = update_pclmul(crc, data.data(), data.size()); break;
+    default:             crc = update_tables(crc, data.data(), data.size()); break;
+  }
+
+  if (!m_spec.reflected) {
+    crc >>= (64 - m_spec.width);
+  }
+  return (crc ^ m_spec.xorout) & width_mask(m_spec.width);
+}
+
+uint64_t CRCEngine::update_tables(uint64_t crc, const uint8_t* p, size_t len) const {
+  const auto& t = m_tables;
+  if (m_spec.reflected) {
+    for (; len >= 8; p += 8, len -= 8) {
+      crc ^= load_le64(p);
+      crc = t[7][crc & 0xFF]         ^ t[6][(crc >> 8) & 0xFF]  ^
+            t[5][(crc >> 16) & 0xFF] ^ t[4][(crc >> 24) & 0xFF] ^
+            t[3][(crc >> 32) & 0xFF] ^ t[2][(crc >> 40) & 0xFF] ^
+            t[1][(crc >> 48) & 0xFF] ^ t[0][crc >> 56];
+    }
+    for (; len > 0; p++, len--) {
+      crc = t[0][(crc ^ *p) & 0xFF] ^ (crc >> 8);
+    }
+  } else {
+    for (; len >= 8; p += 8, len -= 8) {
+      crc ^= load_be64(p);
+      crc = t[7][crc >> 56]          ^ t[6][(crc >> 48) & 0xFF] ^
+            t[5][(crc >> 40) & 0xFF] ^ t[4][(crc >> 32) & 0xFF] ^
+            t[3][(crc >> 24) & 0xFF] ^ t[2][(crc >> 16) & 0xFF] ^
+            t[1][(crc >> 8) & 0xFF]  ^ t[0][crc & 0xFF];
+    }
+    for (; len > 0; p++, len--) {
+      crc = (crc << 8) ^ t[0][(crc >> 56) ^ *p];
+    }
+  }
+  return crc;
+}
+
+#if RAMULATOR_EDC_X86
+__attribute__((target("sse4.2")))
+uint64_t CRCEngine::update_sse42(uint64_t crc, const uint8_t* p, size_t len) const {
+  for (; len >= 8; p += 8, len -= 8) {
+    crc = _mm_crc32_u64(crc, load_le64(p));
+  }
+  uint32_t crc32 = crc;
+  for (; len > 0; p++, len--) {
+    crc32 = _mm_crc32_u8(crc32, *p);
+  }
+  return crc32;
+}
+
+__attribute__((target("pclmul,ssse3")))
+uint64_t CRCEngine::update_pclmul(uint64_t crc, const uint8_t* p, size_t len) const {
+  if (len < 32) {
+    return update_tables(crc, p, len);
+  }
+  const bool reflected = m_spec.reflected;
+
+  // The register is XORed into the leading bits of the message, after which the residue starts at zero
+  __m128i reg = reflected ? _mm_cvtsi64_si128(crc) : _mm_set_epi64x(crc, 0);
+  __m128i x0 = _mm_xor_si128(load_chunk(p, reflected), reg);
+  p += 16;
+  len -= 16;
+
+  // 1. Four independent folding chains over 64-byte strides
+  if (len >= 64) {
+    __m128i k64 = _mm_set_epi64x(m_fold64[1], m_fold64[0]);
+    __m128i x1 = load_chunk(p, reflected);
+    __m128i x2 = load_chunk(p + 16, reflected);
+    __m128i x3 = load_chunk(p + 32, reflected);
+    p += 48;
+    len -= 48;
+    while (len >= 64) {
+      x0 = _mm_xor_si128(fold(x0, k64), load_chunk(p, reflected));
+      x1 = _mm_xor_si128(fold(x1, k64), load_chunk(p + 16, reflected));
+      x2 = _mm_xor_si128(fold(x2, k64), load_chunk(p + 32, reflected));
+      x3 = _mm_xor_si128(fold(x3, k64), load_chunk(p + 48, reflected));
+      p += 64;
+      len -= 64;
+    }
+    __m128i k16 = _mm_set_epi64x(m_fold16[1], m_fold16[0]);
+    x0 = _mm_xor_si128(fold(x0, k16), x1);
+    x0 = _mm_xor_si128(fold(x0, k16), x2);
+    x0 = _mm_xor_si128(fold(x0, k16), x3);
+  }
+
+  // 2. Single chain over the remaining 16-byte chunks
+  __m128i k16 = _mm_set_epi64x(m_fold16[1], m_fold16[0]);
+  for (; len >= 16; p += 16, len -= 16) {
+    x0 = _mm_xor_si128(fold(x0, k16), load_chunk(p, reflected));
+  }
+
+  // 3. The residue is congruent to the message so far: finish it and the tail with the tables
+  alignas(16) uint8_t residue[16];
+  store_chunk(residue, x0, reflected);
+  crc = update_tables(0, residue, 16);
+  return update_tables(crc, p, len);
+}
+#else
+uint64_t CRCEngine::update_sse42(uint64_t crc, const uint8_t* p, size_t len) const {
+  return update_tables(crc, p, len);
+}
+
+uint64_t CRCEngine::update_pclmul(uint64_t crc, const uint8_t* p, size_t len) const {
+  return update_tables(crc, p, len);
+}
+#endif
+
+
+#if RAMULATOR_EDC_X86
+__attribute__((target("avx2")))
+static uint64_t checksum_avx2(const uint8_t* p, size_t len) {
+  __m256i acc = _mm256_setzero_si256();
+  const __m256i zero = _mm256_setzero_si256();
+  for (; len >= 32; p += 32, len -= 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(v, zero));
+  }
+  alignas(32) uint64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+  uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  for (; len > 0; p++, len--) {
+    sum += *p;
+  }
+  return sum;
+}
+#endif
+
+uint64_t ChecksumEngine::compute(std::span<const uint8_t> data) const {
+  uint64_t sum = 0;
+#if RAMULATOR_EDC_X86
+  if (m_use_avx2) {
+    sum = checksum_avx2(data.data(), data.size());
+  } else
+#endif
+  {
+    for (auto byte : data) {
+      sum += byte;
+    }
+  }
+  return (uint32_t) sum;
+}
+
+}       // namespace Ramulator
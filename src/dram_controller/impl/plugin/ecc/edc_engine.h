@@ -0,0 +1,129 @@
+#ifndef RAMULATOR_PLUGIN_ECC_EDC_ENGINE_H_
+#define RAMULATOR_PLUGIN_ECC_EDC_ENGINE_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace Ramulator {
+
+/**
+ * @brief    Error detection code engine used by the ECC plugin.
+ *
+ * @details
+ * The engine for an edc_type ("checksum", "crc32", "crc32c", "crc64") is picked once via create(),
+ * which also selects the fastest kernel the host CPU supports (checked through CPUID at runtime).
+ * Every kernel of an edc_type produces the same value as the portable one.
+ *
+ */
+class IEDCEngine {
+  public:
+    virtual ~IEDCEngine() = default;
+
+    /**
+     * @brief    Computes the EDC value of data. Only the lowest width() bits are meaningful.
+     *
+     */
+    virtual uint64_t compute(std::span<const uint8_t> data) const = 0;
+
+    /**
+     * @brief    Width of the EDC value in bits.
+     *
+     */
+    virtual int width() const = 0;
+
+    /**
+     * @brief    Name of the selected kernel (e.g., "crc32/pclmul"), for reporting.
+     *
+     */
+    virtual std::string name() const = 0;
+
+    /**
+     * @brief    Creates the engine for edc_type. Throws ConfigurationError for unknown types.
+     *
+     * @param    allow_simd     If false, always use the portable kernel.
+     */
+    static std::unique_ptr<IEDCEngine> create(const std::string& edc_type, bool allow_simd = true);
+};
+
+
+/**
+ * @brief    Parameters of a CRC in the Rocksoft model (as used by boost::crc_optimal).
+ *
+ */
+struct CRCSpec {
+  int width;            // 32 or 64
+  uint64_t poly;        // Normal (MSB-first) representation without the leading term
+  uint64_t init;
+  uint64_t xorout;
+  bool reflected;       // Input and output reflection (always equal for the supported CRCs)
+};
+
+
+/**
+ * @brief    Table-driven (slicing-by-8) CRC with an optional PCLMULQDQ folding kernel for long inputs.
+ *
+ * @details
+ * Folding reduces the input 16 bytes at a time to a 128-bit residue congruent to the message modulo
+ * the CRC polynomial, which is then finished with the tables. All folding constants are derived from
+ * the polynomial at construction, so any CRCSpec gets the accelerated path.
+ *
+ */
+class CRCEngine : public IEDCEngine {
+  public:
+    enum class Kernel {
+      Slicing8,     // Portable slicing-by-8
+      SSE42,        // SSE4.2 crc32 instruction, only valid for CRC32C
+      PCLMUL,       // Carry-less multiplication folding + slicing-by-8 tail
+    };
+
+  private:
+    std::string m_type;
+    CRCSpec m_spec;
+    Kernel m_kernel;
+
+    // Slicing-by-8 tables. Registers of non-reflected CRCs are kept left-aligned in 64 bits.
+    std::array<std::array<uint64_t, 256>, 8> m_tables;
+
+    // Folding constants {low lane, high lane} for folding a 128-bit residue over 16 and 64 bytes
+    std::array<uint64_t, 2> m_fold16 = {0, 0};
+    std::array<uint64_t, 2> m_fold64 = {0, 0};
+
+  public:
+    CRCEngine(std::string type, const CRCSpec& spec, Kernel kernel);
+
+    uint64_t compute(std::span<const uint8_t> data) const override;
+    int width() const override { return m_spec.width; };
+    std::string name() const override;
+
+  private:
+    uint64_t xpow_mod(int k) const;
+    std::array<uint64_t, 2> fold_constants(int distance_bits) const;
+
+    uint64_t update_tables(uint64_t crc, const uint8_t* p, size_t len) const;
+    uint64_t update_sse42(uint64_t crc, const uint8_t* p, size_t len) const;
+    uint64_t update_pclmul(uint64_t crc, const uint8_t* p, size_t len) const;
+};
+
+
+/**
+ * @brief    Sum of all bytes modulo 2^32, with an AVX2 kernel.
+ *
+ */
+class ChecksumEngine : public IEDCEngine {
+  private:
+    bool m_use_avx2;
+
+  public:
+    ChecksumEngine(bool use_avx2): m_use_avx2(use_avx2) {};
+
+    uint64_t compute(std::span<const uint8_t> data) const override;
+    int width() const override { return 32; };
+    std::string name() const override { return m_use_avx2 ? "checksum/avx2" : "checksum/scalar"; };
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_EDC_ENGINE_H_
@@ -0,0 +1,194 @@
+#include <cstring>
+
+#include "dram_controller/impl/plugin/ecc/error_event_log.h"
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+namespace ErrorEventLog {
+
+namespace {
+
+template<typename T>
+void put_le(uint8_t* dst, T value) {
+  for (size_t i = 0; i < sizeof(T); i++) {
+    dst[i] = uint8_t(uint64_t(value) >> (8 * i));
+  }
+}
+
+template<typename T>
+T get_le(const uint8_t* src) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < sizeof(T); i++) {
+    value |= uint64_t(src[i]) << (8 * i);
+  }
+  return T(value);
+}
+
+}        // namespace
+
+
+const char* outcome_name(Outcome outcome) {
+  return outcome == Outcome::Corrected ? "corrected" : "uncorrectable";
+}
+
+const char* source_name(Source source) {
+  return source == Source::Demand ? "demand" : "scrub";
+}
+
+
+Writer::Writer(const std::string& path, int channel, ErrorUnit unit, size_t ring_size):
+m_path(path), m_file(path, std::ios::out | std::ios::binary | std::ios::trunc),
+m_block_size(ring_size / NUM_BLOCKS / RECORD_SIZE * RECORD_SIZE) {
+  if (!m_file) {
+    throw ConfigurationError("ECC error event log {} cannot be opened for writing!", path);
+  }
+  if (m_block_size == 0) {
+    throw ConfigurationError("The ECC error event log ring needs at least {} bytes (got {})!", NUM_BLOCKS * RECORD_SIZE, ring_size);
+  }
+
+  // The record count is filled in by close()
+  uint8_t header[HEADER_SIZE] = {};
+  std::memcpy(header, MAGIC, sizeof(MAGIC));
+  put_le<uint16_t>(header + 4, VERSION);
+  put_le<uint16_t>(header + 16, channel);
+  header[18] = uint8_t(unit);
+  m_file.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+
+  m_blocks.resize(NUM_BLOCKS);
+  for (auto& block : m_blocks) {
+    block.reserve(m_block_size);
+  }
+  m_writer = std::thread([this] { write_blocks(); });
+}
+
+Writer::~Writer() {
+  try {
+    close();
+  } catch (...) {}
+}
+
+void Writer::record(const Record& record) {
+  std::vector<uint8_t>& block = m_blocks[m_head];
+  size_t offset = block.size();
+  block.resize(offset + RECORD_SIZE);
+  uint8_t* dst = block.data() + offset;
+  put_le<uint64_t>(dst, record.clk);
+  put_le<int64_t>(dst + 8, record.addr);
+  put_le<uint32_t>(dst + 16, record.bank);
+  put_le<int32_t>(dst + 20, record.row);
+  put_le<uint16_t>(dst + 24, record.channel);
+  put_le<uint16_t>(dst + 26, record.errors);
+  dst[28] = uint8_t(record.outcome);
+  dst[29] = uint8_t(record.source);
+  dst[30] = record.flags;
+  dst[31] = 0;
+  m_num_records++;
+
+  if (block.size() == m_block_size) {
+    hand_off();
+  }
+}
+
+void Writer::hand_off() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_failed) {
+    throw ConfigurationError("Failed to write ECC error event log {}!", m_path);
+  }
+  m_num_full++;
+  m_head = (m_head + 1) % NUM_BLOCKS;
+  m_cv.notify_all();
+  // The next block is free once fewer than all the blocks wait for the writer
+  if (m_num_full == NUM_BLOCKS) {
+    s_stalls++;
+    m_cv.wait(lock, [this] { return m_num_full < NUM_BLOCKS; });
+  }
+}
+
+void Writer::write_blocks() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cv.wait(lock, [this] { return m_num_full > 0 || m_stop; });
+    if (m_num_full == 0) {
+      return;
+    }
+    // The filling thread does not touch a full block until it is released
+    std::vector<uint8_t>& block = m_blocks[m_tail];
+    lock.unlock();
+    m_file.write(reinterpret_cast<const char*>(block.data()), block.size());
+    block.clear();
+    lock.lock();
+    m_failed |= !m_file;
+    m_tail = (m_tail + 1) % NUM_BLOCKS;
+    m_num_full--;
+    m_cv.notify_all();
+  }
+}
+
+void Writer::close() {
+  if (m_closed) {
+    return;
+  }
+  m_closed = true;
+  if (!m_blocks[m_head].empty()) {
+    hand_off();
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  m_writer.join();
+
+  uint8_t num_records[sizeof(uint64_t)];
+  put_le<uint64_t>(num_records, m_num_records);
+  m_file.seekp(8);
+  m_file.write(reinterpret_cast<const char*>(num_records), sizeof(num_records));
+  m_file.close();
+  if (m_failed || !m_file) {
+    throw ConfigurationError("Failed to write ECC error event log {}!", m_path);
+  }
+}
+
+
+Reader::Reader(const std::string& path): m_path(path), m_file(path) {
+  const uint8_t* begin = reinterpret_cast<const uint8_t*>(m_file.begin());
+  m_end = reinterpret_cast<const uint8_t*>(m_file.end());
+  if (m_file.size() < HEADER_SIZE || std::memcmp(begin, MAGIC, sizeof(MAGIC)) != 0) {
+    throw ConfigurationError("{} is not an ECC error event log!", path);
+  }
+  uint16_t version = get_le<uint16_t>(begin + 4);
+  if (version != VERSION) {
+    throw ConfigurationError("ECC error event log {} has format version {}, expected {}!", path, version, VERSION);
+  }
+  m_num_records = get_le<uint64_t>(begin + 8);
+  m_channel = get_le<uint16_t>(begin + 16);
+  m_unit = ErrorUnit(begin[18]);
+
+  m_cursor = begin + HEADER_SIZE;
+  if (size_t(m_end - m_cursor) != m_num_records * RECORD_SIZE) {
+    throw ConfigurationError("ECC error event log {} should hold {} records, but has {} bytes of them (was the simulation interrupted?)!", path, m_num_records, m_end - m_cursor);
+  }
+}
+
+bool Reader::next(Record& record) {
+  if (m_cursor == m_end) {
+    return false;
+  }
+  record.clk = get_le<uint64_t>(m_cursor);
+  record.addr = get_le<int64_t>(m_cursor + 8);
+  record.bank = get_le<uint32_t>(m_cursor + 16);
+  record.row = get_le<int32_t>(m_cursor + 20);
+  record.channel = get_le<uint16_t>(m_cursor + 24);
+  record.errors = get_le<uint16_t>(m_cursor + 26);
+  record.outcome = Outcome(m_cursor[28]);
+  record.source = Source(m_cursor[29]);
+  record.flags = m_cursor[30];
+  m_cursor += RECORD_SIZE;
+  return true;
+}
+
+}        // namespace ErrorEventLog
+
+}        // namespace Ramulator
@@ -0,0 +1,142 @@
+#ifndef RAMULATOR_PLUGIN_ECC_ERROR_EVENT_LOG_H_
+#define RAMULATOR_PLUGIN_ECC_ERROR_EVENT_LOG_H_
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <fstream>
+#include <cstdint>
+#include <condition_variable>
+
+#include "base/type.h"
+#include "frontend/impl/memory_trace/mapped_trace.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    The binary log of the ECC error events of one channel (ECCPlugin error_log), read by ramulator_ecc_events
+ * @details
+ * A log starts with a fixed 32-byte little-endian header:
+ *   "REEV", the format version (uint16_t), 2 reserved zero bytes, the number of records (uint64_t), the channel
+ *   (uint16_t), the unit of the error counts (uint8_t, see ErrorUnit) and 13 reserved zero bytes,
+ * followed by one 32-byte record per event:
+ *   the cycle (uint64_t), the address (int64_t), the bank, numbered across the levels down to the bank (uint32_t), the
+ *   row (int32_t), the channel (uint16_t), the error count (uint16_t, saturated), the outcome (uint8_t), the source
+ *   (uint8_t), the flags (uint8_t) and a reserved zero byte.
+ *
+ */
+namespace ErrorEventLog {
+
+inline constexpr char MAGIC[4] = {'R', 'E', 'E', 'V'};
+inline constexpr uint16_t VERSION = 1;
+inline constexpr size_t HEADER_SIZE = 32;
+inline constexpr size_t RECORD_SIZE = 32;
+
+enum class ErrorUnit : uint8_t { Bits = 0, Symbols = 1 };       // Functional and timing ECC modes
+enum class Outcome : uint8_t { Corrected = 0, Uncorrectable = 1 };
+enum class Source : uint8_t { Demand = 0, Scrub = 1 };
+
+inline constexpr uint8_t FLAG_FAULT = 1 << 0;      // The errors include faulty cells of the fault map
+
+struct Record {
+  Clk_t clk = 0;
+  Addr_t addr = -1;
+  uint32_t bank = 0;
+  int32_t row = -1;
+  uint16_t channel = 0;
+  uint16_t errors = 0;
+  Outcome outcome = Outcome::Corrected;
+  Source source = Source::Demand;
+  uint8_t flags = 0;
+};
+
+const char* outcome_name(Outcome outcome);
+const char* source_name(Source source);
+
+
+/**
+ * @brief    Appends the records to a ring of blocks. A background thread writes every full block while the next ones
+ *           fill, so the simulation only waits (and counts a stall) when the whole ring is waiting to be written. The
+ *           record count in the header is written by close().
+ *
+ */
+class Writer {
+  public:
+    static constexpr size_t NUM_BLOCKS = 4;
+
+  private:
+    std::string m_path;
+    std::ofstream m_file;
+    size_t m_block_size;                            // Bytes of a block, a multiple of RECORD_SIZE
+    uint64_t m_num_records = 0;
+    bool m_closed = false;
+
+    std::vector<std::vector<uint8_t>> m_blocks;     // The ring
+    size_t m_head = 0;                              // The block being filled
+    size_t m_tail = 0;                              // The next block to write
+    size_t m_num_full = 0;                          // Blocks handed to the writer thread and not written yet
+    bool m_stop = false;
+    bool m_failed = false;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::thread m_writer;
+
+  public:
+    size_t s_stalls = 0;                            // Times the ring was full when a block was handed off
+
+  public:
+    /**
+     * @param    ring_size    Bytes of the ring, split into NUM_BLOCKS blocks.
+     */
+    Writer(const std::string& path, int channel, ErrorUnit unit, size_t ring_size);
+    ~Writer();
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    void record(const Record& record);
+
+    uint64_t num_records() const { return m_num_records; };
+
+    void close();
+
+  private:
+    void hand_off();
+    void write_blocks();
+};
+
+
+/**
+ * @brief    Decodes the records of a memory-mapped error event log in order.
+ *
+ */
+class Reader {
+  private:
+    std::string m_path;
+    MappedFile m_file;
+    uint64_t m_num_records = 0;
+    int m_channel = 0;
+    ErrorUnit m_unit = ErrorUnit::Bits;
+
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+
+  public:
+    explicit Reader(const std::string& path);
+
+    uint64_t num_records() const { return m_num_records; };
+    int channel() const { return m_channel; };
+    ErrorUnit unit() const { return m_unit; };
+
+    /**
+     * @brief    Decodes the next event into record. Returns false at the end of the log.
+     *
+     */
+    bool next(Record& record);
+};
+
+}        // namespace ErrorEventLog
+
+}        // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_ERROR_EVENT_LOG_H_
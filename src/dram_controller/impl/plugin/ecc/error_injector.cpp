@@ -0,0 +1,91 @@
+#include "dram_controller/impl/plugin/ecc/error_injector.h"
+
+#include <algorithm>
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+BitErrorInjector::BitErrorInjector(double ber, Mode mode, int burst_length, int multibit_width):
+m_mode(mode), m_ber(ber), m_burst_length(burst_length), m_multibit_width(multibit_width) {
+  if (ber < 0.0 || ber > 1.0) {
+    throw ConfigurationError("Bit error rate {} is not a probability!", ber);
+  }
+  if (burst_length < 1) {
+    throw ConfigurationError("Burst length must be at least 1 (got {})!", burst_length);
+  }
+  if (multibit_width < 1 || multibit_width > 8) {
+    throw ConfigurationError("Multi-bit error width must be in [1, 8] (got {})!", multibit_width);
+  }
+
+  switch (m_mode) {
+    case Mode::Random:   m_event_prob = ber; break;
+    case Mode::Burst:    m_event_prob = ber / burst_length; break;
+    case Mode::MultiBit: m_event_prob = std::min(1.0, ber * 8 / multibit_width); break;
+  }
+
+  m_gap = GeometricSampler(m_event_prob);
+}
+
+BitErrorInjector::Mode BitErrorInjector::parse_mode(const std::string& name) {
+  if (name == "random") {
+    return Mode::Random;
+  } else if (name == "burst") {
+    return Mode::Burst;
+  } else if (name == "multibit") {
+    return Mode::MultiBit;
+  }
+  throw ConfigurationError("Unsupported error model \"{}\" (expected random, burst or multibit)!", name);
+}
+
+size_t BitErrorInjector::next_gap(size_t limit) {
+  return m_gap.next(m_rng, limit);
+}
+
+size_t BitErrorInjector::inject(std::span<uint8_t> data) {
+  m_bits.clear();
+  sample(data.size(), m_bits);
+  apply(data, m_bits);
+  return m_bits.size();
+}
+
+void BitErrorInjector::sample(size_t num_bytes, std::vector<uint32_t>& bits) {
+  if (m_event_prob <= 0.0 || num_bytes == 0) {
+    return;
+  }
+
+  if (m_mode == Mode::MultiBit) {
+    // Events are placed per byte, each flips multibit_width distinct bits of that byte
+    for (size_t pos = next_gap(num_bytes); pos < num_bytes; pos += 1 + next_gap(num_bytes)) {
+      uint8_t mask = 0;
+      while (__builtin_popcount(mask) < m_multibit_width) {
+        mask |= 1u << (m_rng() & 0x7);
+      }
+      for (int bit = 0; bit < 8; bit++) {
+        if (mask & (1u << bit)) {
+          bits.push_back(pos * 8 + bit);
+        }
+      }
+    }
+    return;
+  }
+
+  const size_t num_bits = num_bytes * 8;
+  const size_t event_bits = (m_mode == Mode::Burst) ? m_burst_length : 1;
+  for (size_t pos = next_gap(num_bits); pos < num_bits; pos += 1 + next_gap(num_bits)) {
+    // A burst that runs past the end of the block is truncated
+    size_t end = std::min(num_bits, pos + event_bits);
+    for (size_t bit = pos; bit < end; bit++) {
+      bits.push_back(bit);
+    }
+    pos = end - 1;
+  }
+}
+
+void BitErrorInjector::apply(std::span<uint8_t> data, std::span<const uint32_t> bits) {
+  for (uint32_t bit : bits) {
+    data[bit >> 3] ^= (uint8_t) (1u << (bit & 0x7));
+  }
+}
+
+}       // namespace Ramulator
@@ -0,0 +1,89 @@
+#ifndef RAMULATOR_PLUGIN_ECC_ERROR_INJECTOR_H_
+#define RAMULATOR_PLUGIN_ECC_ERROR_INJECTOR_H_
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "base/random.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Injects bit errors into a block at a configured bit error rate.
+ *
+ * @details
+ * Instead of drawing one random number per bit, the distance to the next error event is drawn from a
+ * geometric distribution, so the cost of inject() is proportional to the number of errors rather than
+ * the block size. Error models:
+ *  - random:   independent single-bit flips, each bit flipped with probability BER.
+ *  - burst:    events flip burst_length consecutive bits.
+ *  - multibit: events flip multibit_width distinct bits inside one byte (symbol).
+ * Event rates of the burst and multibit models are scaled so that the average raw BER stays the configured one.
+ *
+ */
+class BitErrorInjector {
+  public:
+    enum class Mode {
+      Random,
+      Burst,
+      MultiBit,
+    };
+
+  private:
+    Mode m_mode = Mode::Random;
+    double m_ber = 0.0;
+    int m_burst_length = 1;
+    int m_multibit_width = 1;
+
+    double m_event_prob = 0.0;         // Probability that an error event starts at a given bit (byte for multibit)
+    GeometricSampler m_gap;            // Trials before the next error event
+
+    RandomStream m_rng;
+    std::vector<uint32_t> m_bits;      // Scratch buffer of inject()
+
+  public:
+    BitErrorInjector() {};
+    BitErrorInjector(double ber, Mode mode, int burst_length, int multibit_width);
+
+    /**
+     * @brief    Flips bits of data according to the error model. Returns the number of bits flipped.
+     *
+     */
+    size_t inject(std::span<uint8_t> data);
+
+    /**
+     * @brief    Draws the errors of a num_bytes block without touching it, appending the flipped bit positions to bits.
+     *
+     * @details  Consumes the generator exactly like inject(), so sample() + apply() flips the same bits.
+     */
+    void sample(size_t num_bytes, std::vector<uint32_t>& bits);
+
+    /**
+     * @brief    Flips the given bit positions of data.
+     *
+     */
+    static void apply(std::span<uint8_t> data, std::span<const uint32_t> bits);
+
+    void set_rng(const RandomStream& rng) { m_rng = rng; };
+    RandomStream& rng() { return m_rng; };
+
+    /**
+     * @brief    Parses an error model name ("random", "burst", "multibit"). Throws ConfigurationError otherwise.
+     *
+     */
+    static Mode parse_mode(const std::string& name);
+
+  private:
+    /**
+     * @brief    Number of trials before the next error event, saturated to limit.
+     *
+     */
+    size_t next_gap(size_t limit);
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_ERROR_INJECTOR_H_
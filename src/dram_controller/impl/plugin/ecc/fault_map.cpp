@@ -0,0 +1,174 @@
+#include "dram_controller/impl/plugin/ecc/fault_map.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+#include "base/exception.h"
+#include "base/random.h"
+
+namespace Ramulator {
+
+FaultMap::Config FaultMap::Config::parse(const YAML::Node& node) {
+  Config config;
+  if (!node) {
+    return config;
+  }
+  if (!node.IsMap()) {
+    throw ConfigurationError("ECCPlugin: fault_map must be a map with the FIT rates, hours and device_width!");
+  }
+
+  config.hours = node["hours"].as<double>(0.0);
+  config.device_width = node["device_width"].as<int>(config.device_width);
+  if (config.hours < 0.0) {
+    throw ConfigurationError("ECCPlugin: The fault map cannot span {} hours!", config.hours);
+  }
+  if (config.device_width < 1) {
+    throw ConfigurationError("ECCPlugin: The fault map needs a device width of at least one pin (got {})!", config.device_width);
+  }
+
+  if (const YAML::Node& fit = node["fit"]) {
+    if (!fit.IsMap()) {
+      throw ConfigurationError("ECCPlugin: fault_map.fit must map fault types to FIT rates!");
+    }
+    for (const auto& entry : fit) {
+      const std::string name = entry.first.as<std::string>();
+      auto it = std::find(TYPE_NAMES.begin(), TYPE_NAMES.end(), name);
+      if (it == TYPE_NAMES.end()) {
+        throw ConfigurationError("ECCPlugin: Unknown fault type \"{}\" in fault_map.fit (bit, row, column, bank or pin)!", name);
+      }
+      double rate = entry.second.as<double>();
+      if (rate < 0.0) {
+        throw ConfigurationError("ECCPlugin: The FIT rate of {} faults cannot be negative (got {})!", name, rate);
+      }
+      config.fit[it - TYPE_NAMES.begin()] = rate;
+    }
+  }
+  return config;
+}
+
+bool FaultMap::Config::enabled() const {
+  return hours > 0.0 && std::any_of(fit.begin(), fit.end(), [](double rate) { return rate > 0.0; });
+}
+
+FaultMap::FaultMap(const Config& config, const Geometry& geometry, RandomStream rng): m_geometry(geometry) {
+  m_banks.resize(m_geometry.num_banks);
+  auto uniform = [&rng](int n) { return (int) (rng() % (uint64_t) n); };
+
+  int device_width = std::min(config.device_width, m_geometry.num_pins);
+  int num_devices = m_geometry.num_pins / device_width;
+  for (int t = 0; t < NUM_TYPES; t++) {
+    double mean = config.fit[t] * config.hours / 1e9;
+    if (mean <= 0.0) {
+      continue;
+    }
+    std::poisson_distribution<int> count(mean);
+    int num_faults = count(rng);
+    s_faults[t] = num_faults;
+
+    Type type = (Type) t;
+    for (int i = 0; i < num_faults; i++) {
+      int bank = uniform(m_geometry.num_banks);
+      int row = uniform(m_geometry.num_rows);
+      int col = uniform(m_geometry.num_columns);
+      int pin = uniform(m_geometry.num_pins);
+      int beat = uniform(m_geometry.num_beats);
+      int device_pin = uniform(num_devices) * device_width;
+
+      Fault fault = {type, row, row, col, col, pin, pin, beat, beat};
+      switch (type) {
+        case Type::Bit:
+          break;
+        case Type::Row:
+          fault.col_first = 0; fault.col_last = m_geometry.num_columns - 1;
+          fault.pin_first = device_pin; fault.pin_last = device_pin + device_width - 1;
+          fault.beat_first = 0; fault.beat_last = m_geometry.num_beats - 1;
+          break;
+        case Type::Column:
+          fault.row_first = 0; fault.row_last = m_geometry.num_rows - 1;
+          fault.beat_first = 0; fault.beat_last = m_geometry.num_beats - 1;
+          break;
+        case Type::Bank:
+          fault.row_first = 0; fault.row_last = m_geometry.num_rows - 1;
+          fault.col_first = 0; fault.col_last = m_geometry.num_columns - 1;
+          fault.pin_first = device_pin; fault.pin_last = device_pin + device_width - 1;
+          fault.beat_first = 0; fault.beat_last = m_geometry.num_beats - 1;
+          break;
+        case Type::Pin:
+          fault.row_first = 0; fault.row_last = m_geometry.num_rows - 1;
+          fault.col_first = 0; fault.col_last = m_geometry.num_columns - 1;
+          fault.beat_first = 0; fault.beat_last = m_geometry.num_beats - 1;
+          break;
+      }
+
+      if (type == Type::Pin) {
+        m_pin_faults.push_back(fault);
+      } else if (fault.row_first == fault.row_last) {
+        m_banks[bank].row_faults.push_back(fault);
+      } else {
+        m_banks[bank].span_faults.push_back(fault);
+      }
+    }
+  }
+
+  for (Bank& bank : m_banks) {
+    std::sort(bank.row_faults.begin(), bank.row_faults.end(), [](const Fault& a, const Fault& b) { return a.row_first < b.row_first; });
+  }
+}
+
+size_t FaultMap::num_faults() const {
+  size_t num_faults = m_pin_faults.size();
+  for (const Bank& bank : m_banks) {
+    num_faults += bank.row_faults.size() + bank.span_faults.size();
+  }
+  return num_faults;
+}
+
+size_t FaultMap::memory_footprint() const {
+  size_t bytes = m_banks.capacity() * sizeof(Bank) + m_pin_faults.capacity() * sizeof(Fault);
+  for (const Bank& bank : m_banks) {
+    bytes += (bank.row_faults.capacity() + bank.span_faults.capacity()) * sizeof(Fault);
+  }
+  return bytes;
+}
+
+void FaultMap::query(int bank, int row, int col_first, int col_last, std::vector<uint32_t>& bits) const {
+  if (bank < 0 || bank >= (int) m_banks.size()) {
+    return;
+  }
+  auto overlaps = [row, col_first, col_last](const Fault& fault) {
+    return fault.row_first <= row && row <= fault.row_last && fault.col_first <= col_last && col_first <= fault.col_last;
+  };
+
+  const Bank& faults = m_banks[bank];
+  auto [first, last] = std::equal_range(faults.row_faults.begin(), faults.row_faults.end(), Fault{Type::Bit, row, row},
+                                        [](const Fault& a, const Fault& b) { return a.row_first < b.row_first; });
+  for (auto it = first; it != last; it++) {
+    if (overlaps(*it)) {
+      add_bits(*it, col_first, col_last, bits);
+    }
+  }
+  for (const Fault& fault : faults.span_faults) {
+    if (overlaps(fault)) {
+      add_bits(fault, col_first, col_last, bits);
+    }
+  }
+  for (const Fault& fault : m_pin_faults) {
+    if (overlaps(fault)) {
+      add_bits(fault, col_first, col_last, bits);
+    }
+  }
+}
+
+void FaultMap::add_bits(const Fault& fault, int col_first, int col_last, std::vector<uint32_t>& bits) const {
+  const uint32_t line_bits = m_geometry.num_beats * m_geometry.num_pins;
+  for (int col = std::max(col_first, fault.col_first); col <= std::min(col_last, fault.col_last); col++) {
+    for (int beat = fault.beat_first; beat <= fault.beat_last; beat++) {
+      for (int pin = fault.pin_first; pin <= fault.pin_last; pin++) {
+        bits.push_back((col - col_first) * line_bits + beat * m_geometry.num_pins + pin);
+      }
+    }
+  }
+}
+
+}       // namespace Ramulator
@@ -0,0 +1,107 @@
+#ifndef RAMULATOR_PLUGIN_ECC_FAULT_MAP_H_
+#define RAMULATOR_PLUGIN_ECC_FAULT_MAP_H_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "base/type.h"
+#include "base/random.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Permanent DRAM faults of one channel, sampled once from FIT rates and kept as sparse per-bank interval sets.
+ *
+ * @details
+ * The number of faults of every type is drawn from Poisson(FIT * hours / 10^9) at construction. A fault covers a
+ * range of rows, columns (lines of one RD/WR burst), DQ pins and beats of the burst:
+ *  - bit:    one cell (one row, column, pin and beat);
+ *  - row:    every column of one row, on the pins of one device;
+ *  - column: one column of every row, on one pin;
+ *  - bank:   the whole bank, on the pins of one device;
+ *  - pin:    one pin of every bank.
+ * Faults limited to one row are kept sorted by row, the others (few) in a list per bank, and pin faults once for the
+ * channel, so a lookup costs a binary search plus a scan of the faults that span rows, and the memory held is
+ * proportional to the number of faults. Cells under a fault are read inverted (the worst case of a stuck-at cell).
+ *
+ */
+class FaultMap {
+  public:
+    enum class Type {
+      Bit,
+      Row,
+      Column,
+      Bank,
+      Pin,
+    };
+    static constexpr int NUM_TYPES = 5;
+    static constexpr std::array<const char*, NUM_TYPES> TYPE_NAMES = {"bit", "row", "column", "bank", "pin"};
+
+    struct Config {
+      std::array<double, NUM_TYPES> fit = {};   // Faults per 10^9 hours of one channel, by type
+      double hours = 0.0;                       // Operating time the faults accumulate over
+      int device_width = 4;                     // DQ pins of one device (hit together by row and bank faults)
+
+      /**
+       * @brief    Parses a fault_map node (absent: no faults). Throws ConfigurationError on unknown fault types.
+       *
+       */
+      static Config parse(const YAML::Node& node);
+
+      bool enabled() const;
+    };
+
+    struct Geometry {
+      int num_banks = 0;      // Banks of the channel
+      int num_rows = 0;
+      int num_columns = 0;    // Lines (RD/WR bursts) per row
+      int num_pins = 0;       // DQ pins of the channel
+      int num_beats = 0;      // Beats per burst
+    };
+
+    struct Fault {
+      Type type;
+      int row_first, row_last;
+      int col_first, col_last;
+      int pin_first, pin_last;
+      int beat_first, beat_last;
+    };
+
+  private:
+    struct Bank {
+      std::vector<Fault> row_faults;    // Faults within one row, sorted by row
+      std::vector<Fault> span_faults;   // Faults spanning rows
+    };
+
+    Geometry m_geometry;
+    std::vector<Bank> m_banks;
+    std::vector<Fault> m_pin_faults;    // Faults of every bank
+
+  public:
+    std::array<size_t, NUM_TYPES> s_faults = {};
+
+  public:
+    FaultMap() {};
+    FaultMap(const Config& config, const Geometry& geometry, RandomStream rng);
+
+    bool enabled() const { return !m_banks.empty(); };
+    size_t num_faults() const;
+    size_t memory_footprint() const;
+
+    /**
+     * @brief    Appends the corrupted bits of the lines [col_first, col_last] of a row to bits, counted from the first
+     *           bit of line col_first (each line holds num_beats beats of num_pins bits, beat-major).
+     *
+     */
+    void query(int bank, int row, int col_first, int col_last, std::vector<uint32_t>& bits) const;
+
+  private:
+    void add_bits(const Fault& fault, int col_first, int col_last, std::vector<uint32_t>& bits) const;
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_FAULT_MAP_H_
@@ -0,0 +1,54 @@
+#include "dram_controller/impl/plugin/ecc/parity_cache.h"
+
+#include <algorithm>
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+ParityCache::ParityCache(size_t size_bytes, size_t line_bytes, int ways, bool write_back):
+m_ways(ways), m_write_back(write_back) {
+  if (ways < 1 || line_bytes == 0) {
+    throw ConfigurationError("ECCPlugin: Invalid parity cache geometry ({} ways, {}B lines)!", ways, line_bytes);
+  }
+  size_t num_sets = size_bytes / (line_bytes * ways);
+  if (num_sets == 0 || (num_sets & (num_sets - 1)) != 0) {
+    throw ConfigurationError("ECCPlugin: The parity cache must have a power-of-two number of sets (got {})!", num_sets);
+  }
+  m_index_mask = num_sets - 1;
+  m_lines.resize(num_sets * ways);
+}
+
+ParityCache::Result ParityCache::access(Addr_t line, bool is_write) {
+  Result result;
+  Line* set = get_set(line);
+  Line* end = set + m_ways;
+
+  Line* it = std::find_if(set, end, [line](const Line& l) { return l.valid && l.line == line; });
+  if (it != end) {
+    result.hit = true;
+    // Move the line to the most-recently-used position
+    Line hit_line = *it;
+    hit_line.dirty |= is_write && m_write_back;
+    std::move(it + 1, end, it);
+    *(end - 1) = hit_line;
+    return result;
+  }
+
+  if (is_write && !m_write_back) {
+    // Write-through, no write-allocate
+    return result;
+  }
+
+  // Invalid ways are always kept in front of the LRU way, so the victim is the first way
+  if (set->valid) {
+    result.evicted = true;
+    result.writeback = set->dirty;
+    result.victim = set->line;
+  }
+  std::move(set + 1, end, set);
+  *(end - 1) = {line, true, is_write};
+  return result;
+}
+
+}       // namespace Ramulator
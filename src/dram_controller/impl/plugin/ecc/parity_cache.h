@@ -0,0 +1,65 @@
+#ifndef RAMULATOR_PLUGIN_ECC_PARITY_CACHE_H_
+#define RAMULATOR_PLUGIN_ECC_PARITY_CACHE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "base/type.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Set-associative, LRU cache of parity lines kept in the controller.
+ *
+ * @details
+ * Tags only (no data). As in SimpleO3LLC, every set is kept in recency order with the least-recently-used
+ * way first, but the sets are slices of one flat array instead of linked lists in a map. Write-back caches
+ * allocate on writes, write-through caches do not.
+ *
+ */
+class ParityCache {
+  public:
+    struct Result {
+      bool hit = false;
+      bool evicted = false;        // A valid line was evicted to make room
+      bool writeback = false;      // The evicted line was dirty and must be written to DRAM
+      Addr_t victim = -1;          // Line id of the evicted line
+    };
+
+  private:
+    struct Line {
+      Addr_t line = -1;
+      bool valid = false;
+      bool dirty = false;
+    };
+
+    std::vector<Line> m_lines;    // num_sets * ways lines, set-major, LRU way first in every set
+    int m_ways = 0;
+    uint64_t m_index_mask = 0;
+    bool m_write_back = true;
+
+  public:
+    ParityCache() {};
+
+    /**
+     * @param    size_bytes      Capacity in bytes, size_bytes / (line_bytes * ways) must be a power of two.
+     */
+    ParityCache(size_t size_bytes, size_t line_bytes, int ways, bool write_back);
+
+    /**
+     * @brief    Looks up line, updates the LRU order and allocates it on a miss if the policy says so.
+     *
+     */
+    Result access(Addr_t line, bool is_write);
+
+    bool enabled() const { return !m_lines.empty(); };
+    bool write_back() const { return m_write_back; };
+
+  private:
+    // Line ids are sparse (the column bits below the burst size are constant), so they are hashed (Fibonacci) first
+    Line* get_set(Addr_t line) { return m_lines.data() + ((((uint64_t) line * 0x9E3779B97F4A7C15ull) >> 32) & m_index_mask) * m_ways; };
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_PARITY_CACHE_H_
@@ -0,0 +1,111 @@
+#include "dram_controller/impl/plugin/ecc/parity_layout.h"
+
+#include <algorithm>
+
+#include "base/exception.h"
+#include "dram/dram.h"
+
+namespace Ramulator {
+
+ParityLayout::ParityLayout(IDRAM* dram, size_t parity_bytes, size_t codeword_bytes, int region_rows, int bank_offset):
+m_parity_bytes(parity_bytes), m_bank_offset(bank_offset) {
+  m_bank_level = dram->m_levels("bank");
+  m_row_level = dram->m_levels("row");
+  m_col_level = dram->m_levels("column");
+  m_level_sizes = dram->m_organization.count;
+
+  m_num_banks = dram->get_level_size("bank");
+  m_num_rows = dram->get_level_size("row");
+  m_prefetch_size = dram->m_internal_prefetch_size;
+  m_lines_per_row = dram->get_level_size("column") / m_prefetch_size;
+  m_line_bytes = (size_t) dram->m_channel_width / 8 * m_prefetch_size;
+
+  if (m_parity_bytes == 0 || m_line_bytes == 0) {
+    throw ConfigurationError("ECCPlugin: Cannot lay out {}B of parity in {}B lines!", m_parity_bytes, m_line_bytes);
+  }
+
+  m_lines_per_codeword = std::clamp<int>((codeword_bytes + m_line_bytes - 1) / m_line_bytes, 1, m_lines_per_row);
+
+  if (region_rows <= 0) {
+    // The parity of every codeword of the bank: rows * (codewords per row) * parity_bytes / (bytes per row)
+    size_t codewords_per_row = (m_lines_per_row + m_lines_per_codeword - 1) / m_lines_per_codeword;
+    size_t row_bytes = m_line_bytes * m_lines_per_row;
+    region_rows = (int) (((size_t) m_num_rows * codewords_per_row * m_parity_bytes + row_bytes - 1) / row_bytes);
+  }
+  if (region_rows > m_num_rows) {
+    throw ConfigurationError("ECCPlugin: The parity region ({} rows) does not fit in a bank of {} rows!", region_rows, m_num_rows);
+  }
+  m_region_rows = region_rows;
+  m_region_base_row = m_num_rows - m_region_rows;
+}
+
+ParityLayout ParityLayout::in_row(IDRAM* dram, size_t parity_bytes, size_t codeword_bytes, int inline_lines) {
+  ParityLayout layout(dram, parity_bytes, codeword_bytes, 1, 0);
+  int data_lines = layout.m_lines_per_row - inline_lines;
+  if (inline_lines <= 0 || data_lines <= 0) {
+    throw ConfigurationError("ECCPlugin: Invalid inline parity of {} lines in rows of {} lines!", inline_lines, layout.m_lines_per_row);
+  }
+  layout.m_lines_per_codeword = std::clamp(layout.m_lines_per_codeword, 1, data_lines);
+  size_t codewords_per_row = (data_lines + layout.m_lines_per_codeword - 1) / layout.m_lines_per_codeword;
+  size_t needed_lines = (codewords_per_row * parity_bytes + layout.m_line_bytes - 1) / layout.m_line_bytes;
+  if (needed_lines > (size_t) inline_lines) {
+    throw ConfigurationError("ECCPlugin: The parity of a row ({} codewords of {}B) needs {} inline parity lines, the address mapper reserves {}!",
+                             codewords_per_row, parity_bytes, needed_lines, inline_lines);
+  }
+  layout.m_inline_lines = inline_lines;
+  layout.m_region_rows = 0;
+  layout.m_region_base_row = layout.m_num_rows;
+  return layout;
+}
+
+void ParityLayout::map(const AddrVec_t& data_addr_vec, std::vector<AddrVec_t>& lines) const {
+  if (m_inline_lines > 0) {
+    // Packed from the first parity line of the codeword's own row
+    int data_lines = m_lines_per_row - m_inline_lines;
+    size_t first_byte = (size_t) (data_addr_vec[m_col_level] / m_lines_per_codeword) * m_parity_bytes;
+    AddrVec_t addr_vec = data_addr_vec;
+    for (size_t line = first_byte / m_line_bytes; line <= (first_byte + m_parity_bytes - 1) / m_line_bytes; line++) {
+      addr_vec[m_col_level] = data_lines + line;
+      lines.push_back(addr_vec);
+    }
+    return;
+  }
+
+  size_t codewords_per_row = (m_lines_per_row + m_lines_per_codeword - 1) / m_lines_per_codeword;
+  size_t codeword = (size_t) data_addr_vec[m_row_level] * codewords_per_row + data_addr_vec[m_col_level] / m_lines_per_codeword;
+  size_t first_byte = codeword * m_parity_bytes;
+  size_t first_line = first_byte / m_line_bytes;
+  size_t last_line = (first_byte + m_parity_bytes - 1) / m_line_bytes;
+
+  // A region smaller than needed wraps around, so codewords far apart share parity lines
+  size_t region_lines = (size_t) m_region_rows * m_lines_per_row;
+
+  AddrVec_t addr_vec = data_addr_vec;
+  addr_vec[m_bank_level] = (data_addr_vec[m_bank_level] + m_bank_offset) % m_num_banks;
+  for (size_t line = first_line; line <= last_line; line++) {
+    size_t region_line = line % region_lines;
+    addr_vec[m_row_level] = m_region_base_row + region_line / m_lines_per_row;
+    addr_vec[m_col_level] = region_line % m_lines_per_row;
+    lines.push_back(addr_vec);
+  }
+}
+
+Addr_t ParityLayout::line_id(const AddrVec_t& addr_vec) const {
+  Addr_t flat = 0;
+  for (size_t level = 0; level < addr_vec.size(); level++) {
+    flat = flat * m_level_sizes[level] + addr_vec[level];
+  }
+  return -2 - flat;
+}
+
+AddrVec_t ParityLayout::line_addr_vec(Addr_t line_id) const {
+  Addr_t flat = -2 - line_id;
+  AddrVec_t addr_vec(m_level_sizes.size());
+  for (int level = (int) m_level_sizes.size() - 1; level >= 0; level--) {
+    addr_vec[level] = flat % m_level_sizes[level];
+    flat /= m_level_sizes[level];
+  }
+  return addr_vec;
+}
+
+}       // namespace Ramulator
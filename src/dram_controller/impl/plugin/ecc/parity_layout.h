@@ -0,0 +1,89 @@
+#ifndef RAMULATOR_PLUGIN_ECC_PARITY_LAYOUT_H_
+#define RAMULATOR_PLUGIN_ECC_PARITY_LAYOUT_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "base/type.h"
+
+namespace Ramulator {
+
+class IDRAM;
+
+/**
+ * @brief    Maps the parity of a codeword to the DRAM lines that hold it.
+ *
+ * @details
+ * Parity lives in a reserved region made of the last region_rows rows of every bank. A codeword covers
+ * consecutive lines of a row; the codewords of a bank are numbered by (row, line within the row) and their parity
+ * is packed back to back in the region of the bank that is bank_offset banks away, so one parity line usually
+ * holds the parity of several codewords.
+ * Data that maps into the region aliases with the parity (the region is not removed from the data address space).
+ * With inline parity (in_row()), the address mapper keeps the last lines of every row free instead, and the parity of
+ * the codewords of a row is packed into them, so a parity access goes to the row of its codeword.
+ * Columns are counted in lines, as the address mappers produce them.
+ *
+ */
+class ParityLayout {
+  private:
+    int m_bank_level = -1;
+    int m_row_level = -1;
+    int m_col_level = -1;
+    std::vector<int> m_level_sizes;
+
+    int m_num_banks = -1;
+    int m_num_rows = -1;
+    int m_prefetch_size = -1;     // Columns per line (one RD/WR burst)
+    int m_lines_per_row = -1;
+
+    size_t m_line_bytes = 0;      // Bytes per line (one RD/WR burst)
+    size_t m_parity_bytes = 0;    // Bytes of parity per codeword
+    int m_lines_per_codeword = 1;
+    int m_region_rows = 0;
+    int m_region_base_row = 0;
+    int m_bank_offset = 0;
+    int m_inline_lines = 0;       // Parity lines at the tail of every row, 0 for a parity region
+
+  public:
+    ParityLayout() {};
+
+    /**
+     * @param    parity_bytes    Bytes of parity per codeword.
+     * @param    codeword_bytes  Bytes of data per codeword.
+     * @param    region_rows     Rows per bank reserved for parity, 0 sizes the region to hold the parity of the whole bank.
+     * @param    bank_offset     Distance (in banks) between a codeword and the bank holding its parity.
+     */
+    ParityLayout(IDRAM* dram, size_t parity_bytes, size_t codeword_bytes, int region_rows, int bank_offset);
+
+    /**
+     * @brief    The layout of parity in the last inline_lines lines of the row of its codeword (see
+     *           IAddrMapper::inline_parity_lines()).
+     *
+     */
+    static ParityLayout in_row(IDRAM* dram, size_t parity_bytes, size_t codeword_bytes, int inline_lines);
+
+    /**
+     * @brief    Appends the address vectors of the parity lines of the codeword at data_addr_vec to lines.
+     *
+     */
+    void map(const AddrVec_t& data_addr_vec, std::vector<AddrVec_t>& lines) const;
+
+    /**
+     * @brief    A unique (negative, so never a data address) id of the parity line at addr_vec.
+     *
+     */
+    Addr_t line_id(const AddrVec_t& addr_vec) const;
+
+    /**
+     * @brief    The address vector of the parity line with the given line_id().
+     *
+     */
+    AddrVec_t line_addr_vec(Addr_t line_id) const;
+
+    int region_rows() const { return m_region_rows; };
+    size_t line_bytes() const { return m_line_bytes; };
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_PARITY_LAYOUT_H_
@@ -0,0 +1,47 @@
+#include "dram_controller/impl/plugin/ecc/patrol_scrubber.h"
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+PatrolScrubber::PatrolScrubber(Clk_t interval, Clk_t idle_threshold, int max_outstanding):
+m_interval(interval), m_idle_threshold(idle_threshold), m_max_outstanding(max_outstanding) {
+  if (interval < 0 || idle_threshold < 0 || max_outstanding < 1) {
+    throw ConfigurationError("ECCPlugin: Invalid scrubber (interval {}, idle threshold {}, {} outstanding reads)!", interval, idle_threshold, max_outstanding);
+  }
+}
+
+bool PatrolScrubber::tick(Clk_t clk, bool idle) {
+  if (!idle) {
+    m_idle_cycles = 0;
+    return false;
+  }
+  m_idle_cycles++;
+  s_idle_cycles++;
+  return m_idle_cycles > m_idle_threshold && m_outstanding < m_max_outstanding && clk >= m_next_issue;
+}
+
+bool PatrolScrubber::next(const std::vector<const CodewordStore*>& stores, size_t& store, Addr_t& addr) {
+  // Every store is tried once from the cursor, plus the start of the current one after wrapping around
+  for (size_t tries = 0; tries <= stores.size(); tries++) {
+    if (m_store < stores.size() && stores[m_store]->next_addr(m_slot, addr)) {
+      store = m_store;
+      m_pass_visited = true;
+      return true;
+    }
+    m_slot = 0;
+    if (++m_store >= stores.size()) {
+      m_store = 0;
+      s_passes += m_pass_visited;
+      m_pass_visited = false;
+    }
+  }
+  return false;
+}
+
+void PatrolScrubber::issued(Clk_t clk) {
+  m_outstanding++;
+  m_next_issue = clk + m_interval;
+}
+
+}       // namespace Ramulator
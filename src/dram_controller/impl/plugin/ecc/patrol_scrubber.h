@@ -0,0 +1,81 @@
+#ifndef RAMULATOR_PLUGIN_ECC_PATROL_SCRUBBER_H_
+#define RAMULATOR_PLUGIN_ECC_PATROL_SCRUBBER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "base/type.h"
+#include "dram_controller/impl/plugin/ecc/codeword_store.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Pacing and address walk of the idle-cycle patrol scrubber.
+ *
+ * @details
+ * Scrub reads may only be issued once the controller has had no demand requests in its read and write buffers
+ * for idle_threshold consecutive cycles, at most one every interval cycles and with at most max_outstanding of
+ * them in flight. The walk visits the codewords of every store in turn (in index order) and wraps around.
+ * The owner issues the reads, checks the returned codewords and reports the completions.
+ *
+ */
+class PatrolScrubber {
+  private:
+    Clk_t m_interval = 0;                   // 0 disables the scrubber
+    Clk_t m_idle_threshold = 0;
+    int m_max_outstanding = 1;
+
+    Clk_t m_idle_cycles = 0;                // Current streak of idle cycles
+    Clk_t m_next_issue = 0;                 // First cycle the next scrub read may be issued
+    int m_outstanding = 0;
+
+    size_t m_store = 0;                     // Cursor of the walk: store and index slot
+    size_t m_slot = 0;
+    bool m_pass_visited = false;            // The current walk has visited a codeword
+
+  public:
+    size_t s_idle_cycles = 0;               // Cycles with empty demand buffers
+    size_t s_passes = 0;                    // Completed walks over all stores
+
+  public:
+    PatrolScrubber() {};
+
+    /**
+     * @param    interval           Minimum cycles between two scrub reads.
+     * @param    idle_threshold     Idle cycles before the first scrub read of an idle period.
+     * @param    max_outstanding    Scrub reads in flight at the same time.
+     */
+    PatrolScrubber(Clk_t interval, Clk_t idle_threshold, int max_outstanding);
+
+    bool enabled() const { return m_interval > 0; };
+    int outstanding() const { return m_outstanding; };
+
+    /**
+     * @brief    Advances the idle tracking by one cycle. Returns whether a scrub read may be issued at clk.
+     *
+     */
+    bool tick(Clk_t clk, bool idle);
+
+    /**
+     * @brief    Next codeword of the walk over stores.
+     *
+     * @return   false    Every store is empty. Otherwise store and addr identify the codeword.
+     */
+    bool next(const std::vector<const CodewordStore*>& stores, size_t& store, Addr_t& addr);
+
+    /**
+     * @brief    Records a scrub read issued at clk.
+     *
+     */
+    void issued(Clk_t clk);
+
+    /**
+     * @brief    Records a scrub read whose data has returned.
+     *
+     */
+    void completed() { m_outstanding--; };
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_PATROL_SCRUBBER_H_
@@ -0,0 +1,71 @@
+#include "dram_controller/impl/plugin/ecc/protection_policy.h"
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+std::vector<ProtectionPolicy> ProtectionPolicy::parse(const YAML::Node& node, const ProtectionPolicy& defaults) {
+  std::vector<ProtectionPolicy> policies;
+  if (!node) {
+    return policies;
+  }
+  if (!node.IsSequence()) {
+    throw ConfigurationError("ECCPlugin: protection_policies must be a list of address ranges!");
+  }
+
+  for (const YAML::Node& entry : node) {
+    if (!entry["name"] || !entry["start"] || (!entry["end"] && !entry["size"])) {
+      throw ConfigurationError("ECCPlugin: Every protection policy needs a name, a start and an end or a size!");
+    }
+
+    ProtectionPolicy policy = defaults;
+    policy.name = entry["name"].as<std::string>();
+    policy.start = entry["start"].as<Addr_t>();
+    policy.end = entry["end"] ? entry["end"].as<Addr_t>() : policy.start + entry["size"].as<Addr_t>();
+    policy.data_block_size = entry["data_block_size"].as<size_t>(defaults.data_block_size);
+    policy.edc_size = entry["edc_size"].as<size_t>(defaults.edc_size);
+    policy.ecc_size = entry["ecc_size"].as<size_t>(defaults.ecc_size);
+    policy.ecc_type = entry["ecc_type"].as<std::string>(defaults.ecc_type);
+    policy.edc_type = entry["edc_type"].as<std::string>(defaults.edc_type);
+    policy.max_failure_prob = entry["max_failure_prob"].as<double>(defaults.max_failure_prob);
+
+    if (policy.start < 0 || policy.end <= policy.start) {
+      throw ConfigurationError("ECCPlugin: Protection policy \"{}\" has an empty range [{:#x}, {:#x})!", policy.name, policy.start, policy.end);
+    }
+    if (policy.data_block_size == 0 || (policy.end - policy.start) % (Addr_t) policy.data_block_size != 0) {
+      throw ConfigurationError("ECCPlugin: The range of protection policy \"{}\" is not a whole number of {}B codewords!", policy.name, policy.data_block_size);
+    }
+    if (policy.ecc_type != "hamming" && policy.ecc_type != "rs" && policy.ecc_type != "bch") {
+      throw ConfigurationError("ECCPlugin: Unsupported ecc_type \"{}\" in protection policy \"{}\"!", policy.ecc_type, policy.name);
+    }
+    for (const ProtectionPolicy& other : policies) {
+      if (other.name == policy.name) {
+        throw ConfigurationError("ECCPlugin: Protection policy \"{}\" is defined twice!", policy.name);
+      }
+    }
+    policies.push_back(policy);
+  }
+  return policies;
+}
+
+ProtectionPolicyTable::ProtectionPolicyTable(const std::vector<ProtectionPolicy>& policies, int default_policy):
+m_default_policy(default_policy) {
+  std::vector<int> order;
+  for (int i = 0; i < (int) policies.size(); i++) {
+    if (i != default_policy) {
+      order.push_back(i);
+    }
+  }
+  std::sort(order.begin(), order.end(), [&policies](int a, int b) { return policies[a].start < policies[b].start; });
+
+  for (int i : order) {
+    if (!m_ends.empty() && policies[i].start < m_ends.back()) {
+      throw ConfigurationError("ECCPlugin: Protection policies \"{}\" and \"{}\" overlap!", policies[m_policies.back()].name, policies[i].name);
+    }
+    m_starts.push_back(policies[i].start);
+    m_ends.push_back(policies[i].end);
+    m_policies.push_back(i);
+  }
+}
+
+}       // namespace Ramulator
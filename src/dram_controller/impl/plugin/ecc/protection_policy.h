@@ -0,0 +1,77 @@
+#ifndef RAMULATOR_PLUGIN_ECC_PROTECTION_POLICY_H_
+#define RAMULATOR_PLUGIN_ECC_PROTECTION_POLICY_H_
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "base/type.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Codeword geometry and ECC/EDC of the addresses in [start, end).
+ *
+ */
+struct ProtectionPolicy {
+  std::string name = "default";
+  Addr_t start = 0;
+  Addr_t end = -1;                   // -1: up to the end of the address space (the default policy)
+  size_t data_block_size = 128;
+  size_t edc_size = 4;
+  size_t ecc_size = 8;
+  std::string ecc_type = "bch";
+  std::string edc_type = "crc32";
+  double max_failure_prob = 1e-14;
+
+  /**
+   * @brief    Parses a list of policies. Keys missing from an entry are taken from defaults.
+   *
+   * @details
+   * Every entry needs a name, a start and either an end or a size. Throws ConfigurationError on malformed entries.
+   */
+  static std::vector<ProtectionPolicy> parse(const YAML::Node& node, const ProtectionPolicy& defaults);
+};
+
+
+/**
+ * @brief    Maps addresses to protection policies.
+ *
+ * @details
+ * The ranges are disjoint and sorted by start, so a lookup is a binary search over a few entries followed by one
+ * compare against the end of the range found. Addresses outside every range use the default policy.
+ *
+ */
+class ProtectionPolicyTable {
+  private:
+    std::vector<Addr_t> m_starts;
+    std::vector<Addr_t> m_ends;
+    std::vector<int> m_policies;
+    int m_default_policy = 0;
+
+  public:
+    ProtectionPolicyTable() {};
+
+    /**
+     * @param    policies         Policy of every range, indexed by the value lookup() returns.
+     * @param    default_policy   Index of the policy without a range. Throws ConfigurationError if ranges overlap.
+     */
+    ProtectionPolicyTable(const std::vector<ProtectionPolicy>& policies, int default_policy);
+
+    int lookup(Addr_t addr) const {
+      auto it = std::upper_bound(m_starts.begin(), m_starts.end(), addr);
+      if (it == m_starts.begin()) {
+        return m_default_policy;
+      }
+      size_t range = it - m_starts.begin() - 1;
+      return (addr < m_ends[range]) ? m_policies[range] : m_default_policy;
+    };
+
+    size_t num_ranges() const { return m_starts.size(); };
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_PROTECTION_POLICY_H_
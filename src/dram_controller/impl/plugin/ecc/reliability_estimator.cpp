@@ -0,0 +1,186 @@
+#include "dram_controller/impl/plugin/ecc/reliability_estimator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+#include <yaml-cpp/yaml.h>
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+void AccessHistogram::add_epoch(uint64_t num_reads) {
+  if (num_reads == 0) {
+    return;
+  }
+  int bin = std::min<int>(NUM_BINS - 1, std::bit_width(num_reads) - 1);
+  epochs[bin]++;
+  reads[bin] += num_reads;
+}
+
+uint64_t AccessHistogram::total_epochs() const {
+  uint64_t total = 0;
+  for (uint64_t n : epochs) {
+    total += n;
+  }
+  return total;
+}
+
+uint64_t AccessHistogram::total_reads() const {
+  uint64_t total = 0;
+  for (uint64_t n : reads) {
+    total += n;
+  }
+  return total;
+}
+
+std::vector<double> ReliabilityEstimator::binomial_cdf_table(int n, double q) {
+  std::vector<double> cdf(n, 0.0);
+  if (n == 0) {
+    return cdf;
+  }
+
+  double p_i = std::pow(1.0 - q, n);  // Initial term: probability of zero errors
+  cdf[0] = p_i;
+  for (int i = 1; i < n; ++i) {
+    double multiplier = (n - i + 1) / static_cast<double>(i) * (q / (1.0 - q));
+    p_i *= multiplier;
+    cdf[i] = cdf[i - 1] + p_i;
+  }
+  return cdf;
+}
+
+std::vector<double> ReliabilityEstimator::binomial_log_tail(int n, double q) {
+  const double NEG_INF = -std::numeric_limits<double>::infinity();
+  std::vector<double> log_tail(n + 1, NEG_INF);
+  if (q <= 0.0) {
+    return log_tail;
+  }
+  if (q >= 1.0) {
+    std::fill(log_tail.begin(), log_tail.end() - 1, 0.0);
+    return log_tail;
+  }
+
+  double log_q = std::log(q);
+  double log_1mq = std::log1p(-q);
+  double log_n_fact = std::lgamma(n + 1.0);
+  double acc = NEG_INF;
+  for (int i = n; i >= 1; --i) {
+    double log_pmf = log_n_fact - std::lgamma(i + 1.0) - std::lgamma(n - i + 1.0) + i * log_q + (n - i) * log_1mq;
+    double hi = std::max(acc, log_pmf);
+    acc = hi + std::log(std::exp(acc - hi) + std::exp(log_pmf - hi));
+    log_tail[i - 1] = acc;
+  }
+  return log_tail;
+}
+
+int ReliabilityEstimator::find_minimum_t(int n_total, double bit_error_rate, int symbol_size_bits, double max_failure_prob) {
+  double q = 1.0 - std::pow(1.0 - bit_error_rate, symbol_size_bits);   // Probability that a symbol is corrupted
+  int max_t = n_total / 2;             // Maximum number of symbols that can be corrected (theoretically)
+
+  std::vector<double> log_tail = binomial_log_tail(n_total, q);
+  double log_max_failure_prob = std::log(max_failure_prob);
+  for (int t = 0; t <= max_t; ++t) {
+    // Failure probability (more than t errors)
+    if (log_tail[t] <= log_max_failure_prob) {
+      return t;
+    }
+  }
+  return -1;
+}
+
+int ReliabilityEstimator::dynamic_ecc_size(int codeword_symbols, double bit_error_rate, int ecc_size, double max_failure_prob) {
+  // RS/BCH codes need 2t parity symbols to correct t errors. Past the configured size, the plugin falls back to it
+  int t = find_minimum_t(codeword_symbols, bit_error_rate, 8, max_failure_prob);
+  return (t >= 0 && 2 * t <= ecc_size) ? 2 * t : ecc_size;
+}
+
+std::vector<ReliabilityEstimate> ReliabilityEstimator::estimate(const std::vector<AccessHistogram>& histograms,
+                                                              const std::vector<double>& bit_error_rates, const std::vector<int>& ecc_sizes) {
+  std::vector<ReliabilityEstimate> estimates;
+  for (const AccessHistogram& h : histograms) {
+    double epochs = (double) h.total_epochs();
+    double reads = (double) h.total_reads();
+    int n = h.codeword_symbols;
+
+    for (double ber : bit_error_rates) {
+      // One tail table per BER serves every ECC size
+      double q = 1.0 - std::pow(1.0 - ber, 8);
+      std::vector<double> log_tail = binomial_log_tail(n, q);
+      double p_error = std::exp(log_tail[0]);
+
+      for (int configured : ecc_sizes) {
+        ReliabilityEstimate e;
+        e.policy = h.policy;
+        e.bit_error_rate = ber;
+        e.ecc_size = configured ? configured : h.ecc_size;
+        e.t = std::min(n, dynamic_ecc_size(n, ber, e.ecc_size, h.max_failure_prob) / 2);
+
+        // The mock Hamming decoder corrects any number of errors
+        double p_uncorrectable = (h.ecc_type == "hamming") ? 0.0 : std::exp(log_tail[e.t]);
+        double p_corrected = std::max(0.0, p_error - p_uncorrectable);
+        double p_clean = std::exp(n * std::log1p(-q));
+
+        e.edc_success = reads * p_clean + (reads - epochs) * p_corrected;
+        e.edc_failure = epochs * p_corrected + reads * p_uncorrectable;
+        e.ecc_success = epochs * p_corrected;
+        e.ecc_failure = reads * p_uncorrectable;
+        e.uncorrectable_prob = -std::expm1(epochs * std::log1p(-p_uncorrectable));
+        estimates.push_back(e);
+      }
+    }
+  }
+  return estimates;
+}
+
+void ReliabilityEstimator::save(const std::string& filename, const std::vector<AccessHistogram>& histograms) {
+  YAML::Emitter out;
+  out << YAML::BeginMap << YAML::Key << "access_histograms" << YAML::Value << YAML::BeginSeq;
+  for (const AccessHistogram& h : histograms) {
+    out << YAML::BeginMap;
+    out << YAML::Key << "policy" << YAML::Value << h.policy;
+    out << YAML::Key << "codeword_symbols" << YAML::Value << h.codeword_symbols;
+    out << YAML::Key << "ecc_size" << YAML::Value << h.ecc_size;
+    out << YAML::Key << "ecc_type" << YAML::Value << h.ecc_type;
+    out << YAML::Key << "max_failure_prob" << YAML::Value << h.max_failure_prob;
+    out << YAML::Key << "epochs" << YAML::Value << YAML::Flow << h.epochs;
+    out << YAML::Key << "reads" << YAML::Value << YAML::Flow << h.reads;
+    out << YAML::EndMap;
+  }
+  out << YAML::EndSeq << YAML::EndMap;
+
+  std::ofstream file(filename, std::ios::out | std::ios::trunc);
+  file << out.c_str() << std::endl;
+  if (!file) {
+    throw ConfigurationError("ECCPlugin: Failed to write the access histogram \"{}\"!", filename);
+  }
+}
+
+std::vector<AccessHistogram> ReliabilityEstimator::load(const std::string& filename) {
+  std::vector<AccessHistogram> histograms;
+  try {
+    YAML::Node root = YAML::LoadFile(filename);
+    for (const YAML::Node& entry : root["access_histograms"]) {
+      AccessHistogram h;
+      h.policy = entry["policy"].as<std::string>();
+      h.codeword_symbols = entry["codeword_symbols"].as<int>();
+      h.ecc_size = entry["ecc_size"].as<int>();
+      h.ecc_type = entry["ecc_type"].as<std::string>();
+      h.max_failure_prob = entry["max_failure_prob"].as<double>();
+      h.epochs = entry["epochs"].as<std::vector<uint64_t>>();
+      h.reads = entry["reads"].as<std::vector<uint64_t>>();
+      if (h.codeword_symbols <= 0 || h.epochs.size() != h.reads.size()) {
+        throw ConfigurationError("Malformed histogram of protection policy \"{}\"", h.policy);
+      }
+      histograms.push_back(h);
+    }
+  } catch (const std::exception& e) {
+    throw ConfigurationError("ECCPlugin: Cannot read the access histogram \"{}\": {}!", filename, e.what());
+  }
+  return histograms;
+}
+
+}       // namespace Ramulator
@@ -0,0 +1,109 @@
+#ifndef RAMULATOR_PLUGIN_ECC_RELIABILITY_ESTIMATOR_H_
+#define RAMULATOR_PLUGIN_ECC_RELIABILITY_ESTIMATOR_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Ramulator {
+
+/**
+ * @brief    Reads of the codewords of one protection policy between two writes, binned by powers of two.
+ *
+ * @details
+ * An epoch of a codeword starts when it is written (or materialized by a read) and ends at its next write or at the
+ * end of the simulation. Its symbol errors are drawn once, at the start of the epoch: the first read sees them and
+ * corrects them if it can, so that the later reads see a clean codeword, or fail again. Bin b holds the epochs with
+ * [2^b, 2^(b+1)) reads and their exact total of reads. Epochs without reads are not recorded.
+ *
+ */
+struct AccessHistogram {
+  static constexpr int NUM_BINS = 32;
+
+  std::string policy = "default";
+  int codeword_symbols = 0;         // Bytes of [Data + EDC]: the 8-bit symbols hit by errors, and the input of the dynamic ECC size
+  int ecc_size = 0;                 // Configured ECC size, the upper bound of the dynamic one
+  std::string ecc_type = "bch";
+  double max_failure_prob = 1e-14;
+  std::vector<uint64_t> epochs = std::vector<uint64_t>(NUM_BINS, 0);
+  std::vector<uint64_t> reads = std::vector<uint64_t>(NUM_BINS, 0);
+
+  void add_epoch(uint64_t num_reads);
+  uint64_t total_epochs() const;
+  uint64_t total_reads() const;
+};
+
+/**
+ * @brief    Expected ECCPlugin counters of one access histogram at one raw bit error rate and ECC size.
+ *
+ */
+struct ReliabilityEstimate {
+  std::string policy;
+  double bit_error_rate = 0.0;
+  int ecc_size = 0;                 // Configured ECC size
+  int t = 0;                        // Correctable symbols of the dynamic ECC size
+  double edc_success = 0.0;
+  double edc_failure = 0.0;
+  double ecc_success = 0.0;
+  double ecc_failure = 0.0;
+  double uncorrectable_prob = 0.0;  // Probability that at least one read returns an uncorrectable codeword
+};
+
+/**
+ * @brief    Analytic counterpart of the timing-only mode of ECCPlugin.
+ *
+ * @details
+ * The timing mode draws the symbol errors of every epoch from Binomial(n, q) with q = 1 - (1 - BER)^8, so the
+ * expected counters of a whole run follow from the access histogram of one run, for any BER and ECC size:
+ * with P0, Pc and Pu the probabilities of no error, a correctable and an uncorrectable epoch, E epochs and R reads,
+ * EDC successes are R * P0 + (R - E) * Pc, EDC failures E * Pc + R * Pu, ECC successes E * Pc and failures R * Pu.
+ * The data block size shapes the access stream itself and is fixed by the run.
+ *
+ */
+class ReliabilityEstimator {
+  public:
+    /**
+     * @brief    Binomial CDF for every k < n: cdf[k] = P(number of errors <= k).
+     *
+     */
+    static std::vector<double> binomial_cdf_table(int n, double q);
+
+    /**
+     * @brief    Binomial tail in log space for every t <= n: log_tail[t] = log P(number of errors > t).
+     *
+     * @details  The terms are summed from the top down with log-sum-exp, so tails far below the precision of
+     *           1 - CDF (and codewords where (1 - q)^n underflows, e.g., 4KB) stay accurate.
+     */
+    static std::vector<double> binomial_log_tail(int n, double q);
+
+    /**
+     * @brief    Smallest t such that more than t corrupted symbols out of n_total are at most max_failure_prob
+     *           likely, or -1 if no t <= n_total / 2 is enough.
+     *
+     */
+    static int find_minimum_t(int n_total, double bit_error_rate, int symbol_size_bits, double max_failure_prob);
+
+    /**
+     * @brief    ECC bytes the plugin uses for a data block: 2t for the smallest sufficient t, ecc_size if 2t exceeds it.
+     *
+     */
+    static int dynamic_ecc_size(int codeword_symbols, double bit_error_rate, int ecc_size, double max_failure_prob);
+
+    /**
+     * @brief    Expected counters of every histogram for every BER and ECC size (0: the one of the run).
+     *
+     */
+    static std::vector<ReliabilityEstimate> estimate(const std::vector<AccessHistogram>& histograms,
+                                                     const std::vector<double>& bit_error_rates, const std::vector<int>& ecc_sizes);
+
+    /**
+     * @brief    Writes and reads access histograms as a YAML file. load() throws ConfigurationError on a malformed file.
+     *
+     */
+    static void save(const std::string& filename, const std::vector<AccessHistogram>& histograms);
+    static std::vector<AccessHistogram> load(const std::string& filename);
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_RELIABILITY_ESTIMATOR_H_
@@ -0,0 +1,291 @@
+#include "dram_controller/impl/plugin/ecc/rs_codec.h"
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+namespace {
+
+// Per-thread scratch space so that encode/decode do not allocate once warmed up
+thread_local std::vector<uint16_t> t_scratch;
+
+}       // namespace
+
+
+GaloisField::GaloisField(int m): m_m(m) {
+  if (m < MIN_SYMBOL_BITS || m > MAX_SYMBOL_BITS) {
+    throw ConfigurationError("GF(2^{}) is not supported (symbol width must be in [{}, {}])!", m, MIN_SYMBOL_BITS, MAX_SYMBOL_BITS);
+  }
+  m_n = (1 << m) - 1;
+  m_exp.resize(2 * m_n);
+  m_log.resize(m_n + 1, 0);
+
+  uint32_t x = 1;
+  for (int i = 0; i < m_n; i++) {
+    m_exp[i] = x;
+    m_log[x] = i;
+    x <<= 1;
+    if (x & (1u << m)) {
+      x ^= PRIMITIVE_POLYS[m];
+    }
+  }
+  for (int i = m_n; i < 2 * m_n; i++) {
+    m_exp[i] = m_exp[i - m_n];
+  }
+}
+
+
+RSCodec::RSCodec(const GaloisField& gf, int t, bool specialized): m_gf(gf), m_t(t), m_symbol_bytes((gf.m() + 7) / 8) {
+  if (t < 0 || 2 * t >= gf.n()) {
+    throw ConfigurationError("RS code with t = {} does not fit in GF(2^{})!", t, gf.m());
+  }
+  if (specialized) {
+    m_kernel = RSKernel::find(gf.m(), t);
+  }
+
+  // g(x) = prod_{i=1}^{2t} (x - alpha^i), built up one root at a time
+  m_generator.assign(2 * t + 1, 0);
+  m_generator[0] = 1;
+  for (int i = 1; i <= 2 * t; i++) {
+    for (int j = i; j > 0; j--) {
+      m_generator[j] = m_generator[j - 1] ^ m_gf.mul_exp(m_generator[j], i);
+    }
+    m_generator[0] = m_gf.mul_exp(m_generator[0], i);
+  }
+}
+
+uint16_t RSCodec::get_parity_symbol(std::span<const uint8_t> parity, int i) const {
+  uint16_t val = parity[i * m_symbol_bytes];
+  if (m_symbol_bytes > 1) {
+    val |= (uint16_t) parity[i * m_symbol_bytes + 1] << 8;
+  }
+  return val;
+}
+
+void RSCodec::set_parity_symbol(std::span<uint8_t> parity, int i, uint16_t val) const {
+  parity[i * m_symbol_bytes] = val & 0xFF;
+  if (m_symbol_bytes > 1) {
+    parity[i * m_symbol_bytes + 1] = val >> 8;
+  }
+}
+
+std::string RSCodec::kernel_name() const {
+  return std::string("rs/") + (m_kernel ? m_kernel->name : "generic");
+}
+
+void RSCodec::encode(std::span<const uint8_t> data, std::span<uint8_t> parity) const {
+  const int nsym = num_parity_symbols();
+  if (nsym == 0) {
+    return;
+  }
+  if (m_kernel) {
+    m_kernel->encode(data, parity);
+    return;
+  }
+
+  // LFSR division of data(x) * x^2t by g(x); data[i] is the coefficient of x^(2t + i)
+  t_scratch.assign(nsym, 0);
+  uint16_t* r = t_scratch.data();
+  for (size_t i = data.size(); i-- > 0;) {
+    uint16_t feedback = data[i] ^ r[nsym - 1];
+    if (feedback != 0) {
+      int log_fb = m_gf.log(feedback);
+      for (int j = nsym - 1; j > 0; j--) {
+        r[j] = r[j - 1] ^ m_gf.mul_exp(m_generator[j], log_fb);
+      }
+      r[0] = m_gf.mul_exp(m_generator[0], log_fb);
+    } else {
+      for (int j = nsym - 1; j > 0; j--) {
+        r[j] = r[j - 1];
+      }
+      r[0] = 0;
+    }
+  }
+
+  for (int j = 0; j < nsym; j++) {
+    set_parity_symbol(parity, j, r[j]);
+  }
+}
+
+void RSCodec::encode_batch(std::span<const std::span<const uint8_t>> data, std::span<const std::span<uint8_t>> parity) const {
+  if (num_parity_symbols() == 0) {
+    return;
+  }
+  size_t i = 0;
+  while (i < data.size()) {
+    size_t count = 1;
+    while (m_kernel && count < RSKernel::MAX_BATCH && i + count < data.size() && data[i + count].size() == data[i].size()) {
+      count++;
+    }
+    if (count == 1) {
+      encode(data[i], parity[i]);
+    } else {
+      m_kernel->encode_batch(&data[i], &parity[i], count);
+    }
+    i += count;
+  }
+}
+
+int RSCodec::decode(std::span<uint8_t> data, std::span<uint8_t> parity) const {
+  const int nsym = num_parity_symbols();
+  const int n_used = nsym + (int) data.size();
+  if (nsym == 0) {
+    return 0;
+  }
+  if (m_kernel && m_kernel->is_clean(data, parity)) {
+    return 0;
+  }
+
+  // Scratch layout: syndromes [2t] | lambda [2t+1] | prev [2t+1] | tmp [2t+1] | omega [2t] | error positions [t] | error values [t]
+  t_scratch.assign(nsym + 3 * (nsym + 1) + nsym + 2 * m_t, 0);
+  uint16_t* syn    = t_scratch.data();
+  uint16_t* lambda = syn + nsym;
+  uint16_t* prev   = lambda + nsym + 1;
+  uint16_t* tmp    = prev + nsym + 1;
+  uint16_t* omega  = tmp + nsym + 1;
+  uint16_t* err_pos = omega + nsym;
+  uint16_t* err_val = err_pos + m_t;
+
+  // 1. Syndromes S_j = r(alpha^j), j = 1..2t, evaluated by Horner's rule from the highest degree
+  bool has_error = false;
+  for (int j = 0; j < nsym; j++) {
+    int root = j + 1;
+    uint16_t s = 0;
+    for (size_t i = data.size(); i-- > 0;) {
+      s = m_gf.mul_exp(s, root) ^ data[i];
+    }
+    for (int i = nsym - 1; i >= 0; i--) {
+      s = m_gf.mul_exp(s, root) ^ get_parity_symbol(parity, i);
+    }
+    syn[j] = s;
+    has_error |= (s != 0);
+  }
+  if (!has_error) {
+    return 0;
+  }
+
+  // 2. Berlekamp-Massey for the error locator polynomial lambda(x)
+  lambda[0] = 1;
+  prev[0] = 1;
+  int L = 0;
+  int shift = 1;
+  uint16_t b = 1;
+  for (int r = 0; r < nsym; r++) {
+    uint16_t d = syn[r];
+    for (int i = 1; i <= L; i++) {
+      d ^= m_gf.mul(lambda[i], syn[r - i]);
+    }
+
+    if (d == 0) {
+      shift++;
+      continue;
+    }
+
+    uint16_t coef = m_gf.div(d, b);
+    if (2 * L <= r) {
+      std::copy(lambda, lambda + nsym + 1, tmp);
+      for (int i = 0; i + shift <= nsym; i++) {
+        lambda[i + shift] ^= m_gf.mul(coef, prev[i]);
+      }
+      L = r + 1 - L;
+      std::copy(tmp, tmp + nsym + 1, prev);
+      b = d;
+      shift = 1;
+    } else {
+      for (int i = 0; i + shift <= nsym; i++) {
+        lambda[i + shift] ^= m_gf.mul(coef, prev[i]);
+      }
+      shift++;
+    }
+  }
+  if (L > m_t) {
+    return -1;
+  }
+
+  // 3. Chien search restricted to the positions that exist in the (shortened) codeword
+  int num_errors = 0;
+  for (int i = 0; i < n_used && num_errors <= L; i++) {
+    // Evaluate lambda(alpha^-i)
+    int inv = (m_gf.n() - i) % m_gf.n();
+    uint16_t v = lambda[0];
+    for (int k = 1; k <= L; k++) {
+      v ^= m_gf.mul_exp(lambda[k], (int) (((int64_t) inv * k) % m_gf.n()));
+    }
+    if (v == 0) {
+      if (num_errors == L) {
+        return -1;
+      }
+      err_pos[num_errors++] = i;
+    }
+  }
+  if (num_errors != L) {
+    return -1;
+  }
+
+  // 4. Forney: e = omega(X^-1) / lambda'(X^-1), with omega(x) = S(x) * lambda(x) mod x^2t
+  for (int i = 0; i < nsym; i++) {
+    uint16_t v = 0;
+    for (int k = 0; k <= std::min(i, L); k++) {
+      v ^= m_gf.mul(lambda[k], syn[i - k]);
+    }
+    omega[i] = v;
+  }
+  for (int e = 0; e < num_errors; e++) {
+    int inv = (m_gf.n() - err_pos[e]) % m_gf.n();
+    uint16_t num = 0;
+    for (int i = 0; i < nsym; i++) {
+      num ^= m_gf.mul_exp(omega[i], (int) (((int64_t) inv * i) % m_gf.n()));
+    }
+    // Formal derivative in characteristic 2 keeps only the odd-power terms
+    uint16_t den = 0;
+    for (int k = 1; k <= L; k += 2) {
+      den ^= m_gf.mul_exp(lambda[k], (int) (((int64_t) inv * (k - 1)) % m_gf.n()));
+    }
+    if (den == 0) {
+      return -1;
+    }
+    err_val[e] = m_gf.div(num, den);
+
+    // A correction that leaves the byte range of a data symbol is a miscorrection
+    if (err_pos[e] >= nsym && (data[err_pos[e] - nsym] ^ err_val[e]) > 0xFF) {
+      return -1;
+    }
+  }
+
+  // 5. Only apply the corrections once the whole codeword is known to be decodable
+  for (int e = 0; e < num_errors; e++) {
+    int pos = err_pos[e];
+    if (pos < nsym) {
+      set_parity_symbol(parity, pos, get_parity_symbol(parity, pos) ^ err_val[e]);
+    } else {
+      data[pos - nsym] ^= err_val[e];
+    }
+  }
+  return num_errors;
+}
+
+
+const RSCodec& RSCodecCache::get(int m, int t) {
+  auto key = std::make_pair(m, t);
+  if (auto it = m_codecs.find(key); it != m_codecs.end()) {
+    return *it->second;
+  }
+
+  auto& gf = m_fields[m];
+  if (!gf) {
+    gf = std::make_unique<GaloisField>(m);
+  }
+  auto [it, _] = m_codecs.emplace(key, std::make_unique<RSCodec>(*gf, t, m_specialized));
+  return *it->second;
+}
+
+int RSCodecCache::min_symbol_bits(size_t num_data_symbols, int t) {
+  for (int m = 8; m <= GaloisField::MAX_SYMBOL_BITS; m++) {
+    if (num_data_symbols + 2 * (size_t) t <= (size_t) ((1 << m) - 1)) {
+      return m;
+    }
+  }
+  return -1;
+}
+
+}       // namespace Ramulator
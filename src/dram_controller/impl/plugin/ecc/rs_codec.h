@@ -0,0 +1,170 @@
+#ifndef RAMULATOR_PLUGIN_ECC_RS_CODEC_H_
+#define RAMULATOR_PLUGIN_ECC_RS_CODEC_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "dram_controller/impl/plugin/ecc/codec_kernels.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    GF(2^m) arithmetic backed by precomputed log/antilog tables.
+ *
+ * @details
+ * The antilog (exp) table is stored twice over so that a multiplication is a single
+ * table lookup of log[a] + log[b] without a modulo reduction. Supported field widths are 3 to 16 bits.
+ *
+ */
+class GaloisField {
+  public:
+    static constexpr int MIN_SYMBOL_BITS = 3;
+    static constexpr int MAX_SYMBOL_BITS = 16;
+
+    // Primitive polynomials for GF(2^m), indexed by m
+    static constexpr uint32_t PRIMITIVE_POLYS[MAX_SYMBOL_BITS + 1] = {
+      0, 0, 0,
+      0xB, 0x13, 0x25, 0x43, 0x89, 0x11D,
+      0x211, 0x409, 0x805, 0x1053, 0x201B, 0x4443, 0x8003, 0x1100B,
+    };
+
+  private:
+    int m_m;                      // Symbol width in bits
+    int m_n;                      // Number of nonzero field elements (2^m - 1)
+    std::vector<uint16_t> m_exp;  // alpha^i for i in [0, 2n)
+    std::vector<int> m_log;       // log_alpha(x) for x in [1, 2^m), m_log[0] is unused
+
+  public:
+    GaloisField(int m);
+
+    int m() const { return m_m; };
+    int n() const { return m_n; };
+
+    uint16_t exp(int i) const { return m_exp[i % m_n]; };
+    int log(uint16_t x) const { return m_log[x]; };
+
+    uint16_t mul(uint16_t a, uint16_t b) const {
+      if (a == 0 || b == 0) return 0;
+      return m_exp[m_log[a] + m_log[b]];
+    };
+
+    uint16_t div(uint16_t a, uint16_t b) const {
+      if (a == 0) return 0;
+      return m_exp[m_log[a] + m_n - m_log[b]];
+    };
+
+    /**
+     * @brief    Multiply a by alpha^e (e must be in [0, n)).
+     *
+     */
+    uint16_t mul_exp(uint16_t a, int e) const {
+      if (a == 0) return 0;
+      return m_exp[m_log[a] + e];
+    };
+};
+
+
+/**
+ * @brief    Systematic, narrow-sense Reed-Solomon codec over a shared GaloisField.
+ *
+ * @details
+ * Data bytes are treated as one symbol each, so a field wider than 8 bits yields a shortened code
+ * that can cover long (e.g., 4KB) blocks in a single codeword. Parity symbols are serialized
+ * little-endian using symbol_bytes() bytes each. The codec holds no per-call state, so a single
+ * instance can be shared by every request with the same (m, t).
+ *
+ * If (m, t) is in the RSKernel registry, encoding and the syndrome check of clean codewords go through the
+ * compile-time specialized kernels; correcting a codeword always uses the generic path.
+ *
+ */
+class RSCodec {
+  private:
+    const GaloisField& m_gf;
+    int m_t;                            // Number of correctable symbol errors
+    int m_symbol_bytes;                 // Bytes used to serialize one parity symbol
+    std::vector<uint16_t> m_generator;  // g(x) = (x - alpha^1)...(x - alpha^2t), g[2t] = 1
+    const RSKernel* m_kernel = nullptr; // Specialized kernels for (m, t), if any
+
+  public:
+    /**
+     * @param    specialized    Use the specialized kernels when the registry has them.
+     */
+    RSCodec(const GaloisField& gf, int t, bool specialized = false);
+
+    int t() const { return m_t; };
+    int m() const { return m_gf.m(); };
+    int num_parity_symbols() const { return 2 * m_t; };
+    int symbol_bytes() const { return m_symbol_bytes; };
+    size_t parity_bytes() const { return (size_t) num_parity_symbols() * m_symbol_bytes; };
+    size_t max_data_symbols() const { return (size_t) (m_gf.n() - num_parity_symbols()); };
+
+    /**
+     * @brief    Name of the kernel in use (e.g., "rs/m10_t4" or "rs/generic"), for reporting.
+     *
+     */
+    std::string kernel_name() const;
+
+    /**
+     * @brief    Computes the parity of data into the caller-provided parity span (parity_bytes() long).
+     *
+     */
+    void encode(std::span<const uint8_t> data, std::span<uint8_t> parity) const;
+
+    /**
+     * @brief    encode() of every data[i] into parity[i]. Runs of codewords with the same data size go through the
+     *           interleaved batch kernel, up to RSKernel::MAX_BATCH at a time, if the codec has specialized kernels.
+     *
+     */
+    void encode_batch(std::span<const std::span<const uint8_t>> data, std::span<const std::span<uint8_t>> parity) const;
+
+    /**
+     * @brief    Corrects data and parity in place.
+     *
+     * @return   int      Number of corrected symbols, or -1 if the codeword is uncorrectable.
+     *                    On failure neither span is modified.
+     */
+    int decode(std::span<uint8_t> data, std::span<uint8_t> parity) const;
+
+  private:
+    uint16_t get_parity_symbol(std::span<const uint8_t> parity, int i) const;
+    void set_parity_symbol(std::span<uint8_t> parity, int i, uint16_t val) const;
+};
+
+
+/**
+ * @brief    Owns the GaloisFields and RSCodecs used by a plugin, keyed by (m, t).
+ *
+ */
+class RSCodecCache {
+  private:
+    std::map<int, std::unique_ptr<GaloisField>> m_fields;
+    std::map<std::pair<int, int>, std::unique_ptr<RSCodec>> m_codecs;
+    bool m_specialized = true;
+
+  public:
+    /**
+     * @param    specialized    Build the codecs with the specialized kernels where available.
+     */
+    RSCodecCache(bool specialized = true): m_specialized(specialized) {};
+
+    /**
+     * @brief    Returns the codec for (m, t), building its tables on first use.
+     *
+     */
+    const RSCodec& get(int m, int t);
+
+    /**
+     * @brief    Smallest symbol width (at least 8 bits) whose field can hold num_data_symbols + 2t symbols.
+     *
+     * @return   int      The width in bits, or -1 if no supported field is large enough.
+     */
+    static int min_symbol_bits(size_t num_data_symbols, int t);
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_RS_CODEC_H_
@@ -0,0 +1,109 @@
+#include "dram_controller/impl/plugin/ecc/write_combiner.h"
+
+#include <algorithm>
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+WriteCombiner::WriteCombiner(int num_entries, int max_sectors_per_codeword, Clk_t timeout, float watermark):
+m_timeout(timeout) {
+  if (num_entries < 1 || max_sectors_per_codeword < 1) {
+    throw ConfigurationError("ECCPlugin: Invalid write-combining buffer ({} entries, {} sectors per codeword)!", num_entries, max_sectors_per_codeword);
+  }
+  if (watermark <= 0.0f || watermark > 1.0f) {
+    throw ConfigurationError("ECCPlugin: The write-combining watermark must be in (0, 1] (got {})!", watermark);
+  }
+  m_mask_words = (max_sectors_per_codeword + 63) / 64;
+  m_entries.resize(num_entries);
+  m_sector_masks.resize((size_t) num_entries * m_mask_words, 0);
+  m_watermark_entries = std::max<size_t>(1, (size_t) (watermark * num_entries));
+}
+
+void WriteCombiner::write(Addr_t codeword, int sector, int sectors_per_codeword, const AddrVec_t& addr_vec, Clk_t clk, std::vector<Flush>& flushes) {
+  auto it = std::find_if(m_entries.begin(), m_entries.end(), [codeword](const Entry& e) { return e.valid && e.codeword == codeword; });
+  size_t entry = it - m_entries.begin();
+
+  if (it == m_entries.end()) {
+    // Allocate, evicting the oldest entry if the buffer is full
+    if (m_occupancy == (int) m_entries.size()) {
+      flush_entry(oldest_entry(), Reason::Eviction, flushes);
+    }
+    it = std::find_if(m_entries.begin(), m_entries.end(), [](const Entry& e) { return !e.valid; });
+    entry = it - m_entries.begin();
+
+    *it = {codeword, true, clk, 0, 0, sectors_per_codeword, {}};
+    std::fill_n(mask(entry), m_mask_words, 0);
+    m_occupancy++;
+    if (m_timeout > 0 && (m_next_deadline < 0 || clk + m_timeout < m_next_deadline)) {
+      m_next_deadline = clk + m_timeout;
+    }
+  }
+
+  uint64_t& word = mask(entry)[sector / 64];
+  uint64_t bit = 1ull << (sector % 64);
+  if (!(word & bit)) {
+    word |= bit;
+    it->num_sectors++;
+  }
+  it->num_writes++;
+  it->addr_vec = addr_vec;
+
+  if (it->num_sectors == it->sectors_per_codeword) {
+    flush_entry(entry, Reason::Full, flushes);
+  }
+  while ((size_t) m_occupancy > m_watermark_entries) {
+    flush_entry(oldest_entry(), Reason::Watermark, flushes);
+  }
+}
+
+void WriteCombiner::tick(Clk_t clk, std::vector<Flush>& flushes) {
+  if (m_next_deadline < 0 || clk < m_next_deadline) {
+    return;
+  }
+  for (size_t entry = 0; entry < m_entries.size(); entry++) {
+    if (m_entries[entry].valid && m_entries[entry].first_write + m_timeout <= clk) {
+      flush_entry(entry, Reason::Timeout, flushes);
+    }
+  }
+}
+
+void WriteCombiner::drain(std::vector<Flush>& flushes) {
+  for (size_t entry = 0; entry < m_entries.size(); entry++) {
+    if (m_entries[entry].valid) {
+      flush_entry(entry, Reason::Drain, flushes);
+    }
+  }
+}
+
+size_t WriteCombiner::oldest_entry() const {
+  size_t oldest = m_entries.size();
+  for (size_t entry = 0; entry < m_entries.size(); entry++) {
+    if (m_entries[entry].valid && (oldest == m_entries.size() || m_entries[entry].first_write < m_entries[oldest].first_write)) {
+      oldest = entry;
+    }
+  }
+  return oldest;
+}
+
+void WriteCombiner::flush_entry(size_t entry, Reason reason, std::vector<Flush>& flushes) {
+  Entry& e = m_entries[entry];
+  flushes.push_back({e.codeword, std::move(e.addr_vec), e.num_writes, e.num_sectors, e.num_sectors == e.sectors_per_codeword, reason});
+  e.valid = false;
+  m_occupancy--;
+  update_deadline();
+}
+
+void WriteCombiner::update_deadline() {
+  m_next_deadline = -1;
+  if (m_timeout == 0) {
+    return;
+  }
+  for (const Entry& e : m_entries) {
+    if (e.valid && (m_next_deadline < 0 || e.first_write + m_timeout < m_next_deadline)) {
+      m_next_deadline = e.first_write + m_timeout;
+    }
+  }
+}
+
+}       // namespace Ramulator
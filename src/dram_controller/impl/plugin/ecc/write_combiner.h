@@ -0,0 +1,105 @@
+#ifndef RAMULATOR_PLUGIN_ECC_WRITE_COMBINER_H_
+#define RAMULATOR_PLUGIN_ECC_WRITE_COMBINER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "base/type.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Write-combining buffer that coalesces the sector writes of a codeword before it is re-encoded.
+ *
+ * @details
+ * Entries are keyed by codeword address and record which sectors (one RD/WR burst each) have been written.
+ * An entry is flushed, i.e., handed back to be encoded once, when
+ *  - all of its sectors have been written (full-codeword write),
+ *  - it is the oldest entry and a new codeword needs room (eviction),
+ *  - its first write is older than the timeout, or
+ *  - the occupancy is above the watermark (oldest first).
+ * The buffer is small, so entries live in a flat array and are found by a linear scan.
+ *
+ */
+class WriteCombiner {
+  public:
+    enum class Reason {
+      Full,
+      Eviction,
+      Timeout,
+      Watermark,
+      Drain,
+    };
+
+    struct Flush {
+      Addr_t codeword = -1;
+      AddrVec_t addr_vec;         // Device address of the last write to the codeword
+      int num_writes = 0;         // Writes coalesced into this flush
+      int num_sectors = 0;        // Distinct sectors written
+      bool full = false;          // Every sector was written, no read-modify-write needed
+      Reason reason = Reason::Full;
+    };
+
+  private:
+    struct Entry {
+      Addr_t codeword = -1;
+      bool valid = false;
+      Clk_t first_write = 0;
+      int num_writes = 0;
+      int num_sectors = 0;
+      int sectors_per_codeword = 1;
+      AddrVec_t addr_vec;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<uint64_t> m_sector_masks;   // m_mask_words words per entry
+    int m_mask_words = 0;
+    int m_occupancy = 0;
+    size_t m_watermark_entries = 0;
+
+    Clk_t m_timeout = 0;                    // 0 disables the timeout
+    Clk_t m_next_deadline = -1;             // Earliest timeout among the entries, -1 if none
+
+  public:
+    WriteCombiner() {};
+
+    /**
+     * @param    max_sectors_per_codeword   Sectors of the largest codeword.
+     * @param    timeout                    Cycles an entry may stay in the buffer (0 = no timeout).
+     * @param    watermark                  Fraction of the entries above which the oldest entries are flushed.
+     */
+    WriteCombiner(int num_entries, int max_sectors_per_codeword, Clk_t timeout, float watermark);
+
+    /**
+     * @brief    Records a write of one sector of a codeword (of sectors_per_codeword sectors) and appends the entries
+     *           it forces out to flushes.
+     *
+     */
+    void write(Addr_t codeword, int sector, int sectors_per_codeword, const AddrVec_t& addr_vec, Clk_t clk, std::vector<Flush>& flushes);
+
+    /**
+     * @brief    Appends the entries whose timeout expired at clk to flushes.
+     *
+     */
+    void tick(Clk_t clk, std::vector<Flush>& flushes);
+
+    /**
+     * @brief    Appends every buffered entry to flushes.
+     *
+     */
+    void drain(std::vector<Flush>& flushes);
+
+    bool enabled() const { return !m_entries.empty(); };
+    int occupancy() const { return m_occupancy; };
+    Clk_t next_deadline() const { return m_next_deadline; };
+
+  private:
+    uint64_t* mask(size_t entry) { return m_sector_masks.data() + entry * m_mask_words; };
+    size_t oldest_entry() const;
+    void flush_entry(size_t entry, Reason reason, std::vector<Flush>& flushes);
+    void update_deadline();
+};
+
+}       // namespace Ramulator
+
+#endif  // RAMULATOR_PLUGIN_ECC_WRITE_COMBINER_H_
@@ -1,15 +1,16 @@
 #include <vector>
-#include <unordered_map>
 #include <limits>
 #include <random>
 
 #include "base/base.h"
+#include "base/checkpoint.h"
 #include "dram_controller/controller.h"
 #include "dram_controller/plugin.h"
+#include "dram_controller/impl/plugin/stream_summary.h"
 
 namespace Ramulator {
 
-class Graphene : public IControllerPlugin, public Implementation {
+class Graphene : public IControllerPlugin, public Implementation, public Checkpointable {
   RAMULATOR_REGISTER_IMPLEMENTATION(IControllerPlugin, Graphene, "Graphene", "Graphene.")
 
   private:
@@ -33,11 +34,11 @@ class Graphene : public IControllerPlugin, public Implementation {
     int m_num_banks_per_rank = -1;
     int m_num_rows_per_bank = -1;
 
-    // per bank activation count table
+    // per bank activation count table, keyed by row
     // indexed using flattened <rank id, bank id>
     // e.g., if rank 0, bank 4, index is 4
     // if rank 1, bank 5, index is 16 (assuming 16 banks/rank) + 5
-    std::vector<std::unordered_map<int, int>> m_activation_count_table;
+    std::vector<StreamSummary> m_activation_count_table;
     // spillover counter per bank
     std::vector<int> m_spillover_counter;
 
@@ -72,44 +73,44 @@ class Graphene : public IControllerPlugin, public Implementation {
                              m_dram->get_level_size("bankgroup") * m_dram->get_level_size("bank");
       m_num_rows_per_bank = m_dram->get_level_size("row");
 
-      // Initialize bank act count tables
+      // Initialize bank act count tables (built in place, as a copy would touch every page of their row indices)
+      m_activation_count_table.reserve(m_num_banks_per_rank * m_num_ranks);
       for (int i = 0; i < m_num_banks_per_rank * m_num_ranks; i++) {
-        std::unordered_map<int, int> table;
-        for (int j = -m_num_rows_per_bank; j < -m_num_rows_per_bank + m_num_table_entries; j++) {
-          table.insert(std::make_pair(j, 0));
-        }
-        m_activation_count_table.push_back(table);
+        m_activation_count_table.emplace_back(m_num_table_entries, m_num_rows_per_bank);
       }
 
       // Initialize spillover counter
       m_spillover_counter = std::vector<int>(m_num_banks_per_rank * m_num_ranks, 0);
     };
 
+    size_t memory_footprint() const override {
+      size_t bytes = heap_bytes(m_activation_count_table) + heap_bytes(m_spillover_counter);
+      for (const StreamSummary& table : m_activation_count_table) {
+        bytes += table.footprint_bytes();
+      }
+      return bytes;
+    };
+
     void update(bool request_found, ReqBuffer::iterator& req_it) override {
       // Tick myself
-      m_clk++;
+      bool is_new = is_new_cycle(request_found);
+      m_clk += is_new;
 
-      if (m_clk % m_reset_period_clk == 0) {
+      if (is_new && m_clk % m_reset_period_clk == 0) {
         // Reset
         for (int i = 0; i < m_num_banks_per_rank * m_num_ranks; i++) {
-          for (auto it = m_activation_count_table[i].begin(); it != m_activation_count_table[i].end(); it++)
-            it->second = 0;
+          m_activation_count_table[i].reset();
           m_spillover_counter[i] = 0;
         }
       }
 
       if (request_found) {
-        if (m_dram->m_command_meta(req_it->command).is_opening && m_dram->m_command_scopes(req_it->command) == m_row_level) {
-          int flat_bank_id = req_it->addr_vec[m_bank_level];
-          int accumulated_dimension = 1;
-          for (int i = m_bank_level - 1; i >= m_rank_level; i--) {
-            accumulated_dimension *= m_dram->m_organization.count[i + 1];
-            flat_bank_id += req_it->addr_vec[i] * accumulated_dimension;
-          }
+        if (m_ctrl->m_command_event.is_activation) {
+          int flat_bank_id = m_ctrl->m_command_event.flat_bank;
           
-          int row_id = req_it->addr_vec[m_row_level];
+          int row_id = m_ctrl->m_command_event.row;
 
-          if (m_is_debug) {
+          RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
             std::cout << "Graphene: ACT on row " << row_id << std::endl;
             std::cout << "  └  " << "rank: " << req_it->addr_vec[m_rank_level] << std::endl;
             std::cout << "  └  " << "bank_group: " << req_it->addr_vec[m_rank_level + 1] << std::endl;
@@ -117,38 +118,29 @@ class Graphene : public IControllerPlugin, public Implementation {
             std::cout << "  └  " << "index: " << flat_bank_id << std::endl;
           }
 
-          if (m_activation_count_table[flat_bank_id].find(row_id) == m_activation_count_table[flat_bank_id].end()) {
-            // if row is not in the table, find an entry 
+          StreamSummary& table = m_activation_count_table[flat_bank_id];
+          int entry = table.find(row_id);
+          if (entry == -1) {
+            // if row is not in the table, take an entry 
             // with a count equal to that of the spillover counter
-            bool found = false;
-            int to_remove = -1;
-            int spillover_value = -1;
-
-            for (auto it = m_activation_count_table[flat_bank_id].begin(); it != m_activation_count_table[flat_bank_id].end(); it++) {
-              if (m_is_debug)
-                std::cout << "  └  " << "checking row " << it->first << " with count " << it->second << std::endl;
-
-              if (it->second == m_spillover_counter[flat_bank_id]) {
-                // if we find an entry, record it
-                spillover_value = it->second;
-                to_remove = it->first;
-                found = true;
-                break;
-              }
-            }
-            if (found) {
+            // (no count is below the spillover counter, so only the smallest can be equal)
+            int to_remove = table.min_entry();
+
+            RAMULATOR_TRACE_IF(Plugin, m_is_debug)
+              std::cout << "  └  " << "checking row " << table.key(to_remove) << " with count " << table.count(to_remove) << std::endl;
+
+            if (table.count(to_remove) == m_spillover_counter[flat_bank_id]) {
               // for debug
-              if (m_is_debug) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 // print the row that is being removed
-                std::cout << "Removing row " << to_remove << " from table " << flat_bank_id << std::endl;
+                std::cout << "Removing row " << table.key(to_remove) << " from table " << flat_bank_id << std::endl;
                 // print the row that is being added
                 std::cout << "Adding row " << row_id << " to table " << flat_bank_id << std::endl;
                 std::cout << "  └  " << "spillover counter: " << m_spillover_counter[flat_bank_id] << std::endl;
               }
-              // remove to_remove from the table
-              m_activation_count_table[flat_bank_id].erase(to_remove);
-              // add row_id to the table
-              m_activation_count_table[flat_bank_id][row_id] = spillover_value + 1;
+              // replace to_remove by row_id in the table, with the count one above the spillover counter
+              table.set_key(to_remove, row_id);
+              table.increment(to_remove);
             }
             // if we did not find such an entry, increment spillover counter by one
             else {
@@ -157,28 +149,65 @@ class Graphene : public IControllerPlugin, public Implementation {
           }
           else {
             // if row in table, increment its activation count
-            m_activation_count_table[flat_bank_id][row_id] += 1;
+            table.increment(entry);
             
-            if (m_is_debug) {
+            RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
               std::cout << "Row " << row_id << " in table[" << flat_bank_id << "]" << std::endl;
               std::cout << "  └  " << "threshold: " << m_activation_threshold << std::endl;
-              std::cout << "  └  " << "count: " << m_activation_count_table[flat_bank_id][row_id] << std::endl;
+              std::cout << "  └  " << "count: " << table.count(entry) << std::endl;
             }
 
             // check if the count exceeds the threshold
-            if (m_activation_count_table[flat_bank_id][row_id] >= m_activation_threshold) {
-              if (m_is_debug) {
+            if (table.count(entry) >= m_activation_threshold) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "Row " << row_id << " in table " << flat_bank_id << " has exceeded the threshold!" << std::endl;
               }
               // if yes, schedule preventive refreshes
               Request vrr_req(req_it->addr_vec, m_VRR_req_id);
               m_ctrl->priority_send(vrr_req);
-              m_activation_count_table[flat_bank_id][row_id] = m_spillover_counter[flat_bank_id];
+              table.set_count(entry, m_spillover_counter[flat_bank_id]);
             }
           }
         }
       }
     }
+
+    // The activation count tables, the spillover counters and the position in the reset period
+    void save_checkpoint(std::ostream& out) override {
+      Checkpoint::write<int>(out, m_clk);
+      Checkpoint::write(out, m_spillover_counter);
+      for (const auto& table : m_activation_count_table) {
+        std::vector<int> entries;   // (row, count), the row is negative for an empty entry
+        for (int entry = 0; entry < table.size(); entry++) {
+          entries.insert(entries.end(), {table.key(entry), table.count(entry)});
+        }
+        Checkpoint::write(out, entries);
+      }
+    };
+
+    void load_checkpoint(std::istream& in) override {
+      m_clk = Checkpoint::read<int>(in);
+      std::vector<int> spillover_counter = Checkpoint::read_vector<int>(in);
+      if (spillover_counter.size() != m_spillover_counter.size()) {
+        throw ConfigurationError("Checkpoint was saved with a different number of banks!");
+      }
+      m_spillover_counter = std::move(spillover_counter);
+      for (auto& table : m_activation_count_table) {
+        std::vector<int> entries = Checkpoint::read_vector<int>(in);
+        if (entries.size() != 2 * size_t(table.size())) {
+          throw ConfigurationError("Checkpoint was saved with a different number of table entries!");
+        }
+        table.reset();
+        for (int entry = 0; entry < table.size(); entry++) {
+          int row_id = entries[2 * entry];
+          if (row_id >= m_num_rows_per_bank) {
+            throw ConfigurationError("Checkpoint was saved with a different number of rows!");
+          }
+          table.set_key(entry, row_id < 0 ? -1 : row_id);
+          table.set_count(entry, entries[2 * entry + 1]);
+        }
+      }
+    };
 };
 
 }       // namespace Ramulator
@@ -1,11 +1,12 @@
 #include <vector>
-#include <unordered_map>
 #include <limits>
 #include <bitset>
 #include <iomanip>
 #include <random>
 
 #include "base/base.h"
+#include "base/memory_report.h"
+#include "base/lazy_array.h"
 #include "frontend/frontend.h"
 #include "translation/translation.h"
 #include "addr_mapper/addr_mapper.h"
@@ -22,11 +23,29 @@ class Hydra : public IControllerPlugin, public Implementation {
     ITranslation* m_translation = nullptr;
     IAddrMapper* m_addr_mapper = nullptr;
 
+    // The entries of all tables carry the epoch (reset period) they were last written in, and an entry of an older
+    // epoch reads as reset. Resetting the tables is then a single increment of m_epoch.
     struct GCT_Entry {
       int group_count;
       bool initialized;
+      uint32_t epoch;
     };
 
+    struct Counter {
+      int count;
+      uint32_t epoch;
+    };
+
+    // An RCC way, valid when it is of the current epoch
+    struct RCC_Entry {
+      Addr_t tag;
+      int count;
+      uint32_t epoch;
+    };
+    static constexpr int RCC_WAYS = 16;
+
+    uint32_t m_epoch = 1;
+
     int m_clk = -1;
 
     // input parameters
@@ -70,33 +89,25 @@ class Hydra : public IControllerPlugin, public Implementation {
     int m_rct_per_cl = -1;
     int m_group_rct_cl_size = -1;
 
-    // per bank GCT, 
-    // the first index is the flat bank id
-    // the second index is the row group id
+    // per bank GCT, indexed by flat bank id * m_gct_entries_per_bank + row group id
     // each entry has a group counter and a flag indicating if the group counter has beed initialized
     // the row group id uses the most significant bits of the row id
-    std::vector<std::unordered_map<Addr_t, GCT_Entry>> group_count_table;
-    // per bank RCT,
-    // the first index is the flat bank id
-    // the second index is the row id
+    LazyArray<GCT_Entry> group_count_table;
+    // per bank RCT, indexed by flat bank id * m_num_rows_per_bank + row id
     // each entry has a row counter
-    std::vector<std::unordered_map<Addr_t, int>> row_count_table;
+    LazyArray<Counter> row_count_table;
     // per rank RCC,
-    // a 16-set associative cache
-    // the first index is the rank id
-    // the second index is the rcc set id
+    // a 16-way set associative cache, indexed by (rank id * m_rcc_set_num + rcc set id) * RCC_WAYS + way
     // each entry has an rcc tag and a row counter
     // the rcc set id uses the least significant bits of the row id
     // the rcc tag uses the most significant bits of the row id and the bank id
-    std::vector<std::vector<std::unordered_map<Addr_t, int>>> row_count_cache;
-    // per bank RCT count table,
-    // the first index is the flat bank id
-    // the second index is the row id
+    std::vector<RCC_Entry> row_count_cache;
+    // per bank RCT count table, indexed by flat bank id * m_total_rct_row_size + row id
     // each entry has a row counter
-    std::vector<std::unordered_map<Addr_t, int>> rct_count_table;
+    LazyArray<Counter> rct_count_table;
 
     // rng for random policy
-    std::mt19937 generator;
+    RandomStream generator;
     std::uniform_int_distribution<int> distribution;
 
     // stats
@@ -176,33 +187,15 @@ class Hydra : public IControllerPlugin, public Implementation {
       // how many cache lines are needed to store the RCT for a row group
       m_group_rct_cl_size = m_row_group_size * m_counter_bits / 512;
 
-      // Initialize tables
-      for (int i = 0; i < m_num_ranks * m_num_banks_per_rank; i++) {
-        std::unordered_map<Addr_t, GCT_Entry> gct_bank;
-        group_count_table.push_back(gct_bank);
-      }
+      // Initialize tables (all entries are of epoch 0, i.e., reset). The per-row tables only take memory for the rows
+      // that are counted (see LazyArray)
+      size_t num_banks = m_num_ranks * m_num_banks_per_rank;
+      group_count_table.assign_zero(num_banks * m_gct_entries_per_bank);
+      row_count_table.assign_zero(num_banks * m_num_rows_per_bank);
+      row_count_cache.assign(size_t(m_num_ranks) * m_rcc_set_num * RCC_WAYS, {0, 0, 0});
+      rct_count_table.assign_zero(num_banks * m_total_rct_row_size);
 
-      for (int i = 0; i < m_num_ranks; i++) {
-        std::vector<std::unordered_map<Addr_t, int>> rcc_rank;
-        for (int j = 0 ; j < m_rcc_set_num; j++){
-          std::unordered_map<Addr_t, int> rcc_set;
-          rcc_rank.push_back(rcc_set);
-        }
-        row_count_cache.push_back(rcc_rank);
-      }
-      
-      for (int i = 0; i < m_num_ranks * m_num_banks_per_rank; i++) {
-        std::unordered_map<Addr_t, int> row_count_table_bank;
-        row_count_table.push_back(row_count_table_bank);
-      }
-
-      rct_count_table.resize(m_num_ranks * m_num_banks_per_rank);
-      for (int i = 0; i < m_num_ranks * m_num_banks_per_rank; i++) {
-        std::unordered_map<Addr_t, int> rctct_bank;
-        rct_count_table.push_back(rctct_bank);
-      }
-
-      if (m_is_debug) {
+      RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
         std::cout << "------------------------------------" << std::endl
                   << "Hydra: Initialized" << std::endl;
         std::cout << "num_ranks:                  " << m_num_ranks << std::endl;
@@ -247,52 +240,40 @@ class Hydra : public IControllerPlugin, public Implementation {
       register_stat(s_rctct_check).name("hydra_rctct_check");
 
       // setup random number generator for random policy
-      generator = std::mt19937(1337);
+      generator = random_stream(1337);
       distribution = std::uniform_int_distribution<int>(0, 15);
     };
 
+    // The GCT, RCT, RCC and RCT count table
+    size_t memory_footprint() const override {
+      return heap_bytes(group_count_table) + heap_bytes(row_count_table) + heap_bytes(row_count_cache) + heap_bytes(rct_count_table);
+    };
+
     void update(bool request_found, ReqBuffer::iterator& req_it) override {
 
-      m_clk++;
-      if (m_clk % m_reset_period_clk == 0) {
-        for (int i = 0; i < m_num_ranks * m_num_banks_per_rank; i++) {
-          group_count_table[i].clear();
-        }
-        for (int i = 0; i < m_num_ranks * m_num_banks_per_rank; i++) {
-          row_count_table[i].clear();
-        }
-        for (int i = 0; i < m_num_ranks; i++) {
-          for (int j = 0 ; j < m_rcc_set_num; j++){
-            row_count_cache[i][j].clear();
-          }
-        }
-        for (int i = 0; i < m_num_ranks * m_num_banks_per_rank; i++) {
-          rct_count_table[i].clear();
-        }
-        if (m_is_debug) {
+      bool is_new = is_new_cycle(request_found);
+      m_clk += is_new;
+      if (is_new && m_clk % m_reset_period_clk == 0) {
+        m_epoch++;
+        RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
           std::cout << "----------------------------------" << std::endl;
           std::cout << "Hydra: Reset all tables (" << m_clk << ")" << std::endl;
         }
       }
 
       if (request_found){
-        if (m_dram->m_command_meta(req_it->command).is_opening && m_dram->m_command_scopes(req_it->command) == m_row_level){
-          int flat_bank_id = req_it->addr_vec[m_bank_level];
-          int accumulated_dimension = 1;
-          for (int i = m_bank_level - 1; i >= m_rank_level; i--) {
-            accumulated_dimension *= m_dram->m_organization.count[i + 1];
-            flat_bank_id += req_it->addr_vec[i] * accumulated_dimension;
-          }
+        if (m_ctrl->m_command_event.is_activation){
+          int flat_bank_id = m_ctrl->m_command_event.flat_bank;
           
-          uint rank_id = req_it->addr_vec[m_rank_level];
+          uint rank_id = m_ctrl->m_command_event.flat_rank;
           uint bank_id = flat_bank_id % m_num_banks_per_rank;
-          uint row_id = req_it->addr_vec[m_row_level];
+          uint row_id = m_ctrl->m_command_event.row;
           uint gct_index = row_id >> (m_row_address_bits - m_gct_index_bits); // get most significant bits
           uint rcc_index = row_id & ((1 << m_rcc_index_bits) - 1); // get least significant bits
           uint rcc_tag = row_id >> (m_row_address_bits - m_rcc_tag_row_bits) // most significant bits of row_id 
                           | bank_id << m_rcc_tag_row_bits; // bank_id
 
-          if (m_is_debug) {
+          RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
             std::cout << "----------------------------------" << std::endl
                       << "Hydra: Activation cmd (" << m_clk << ") " << flat_bank_id << "," << gct_index << "," << row_id << std::endl
                       << "        flat_bank_id: " << std::setw(6) << flat_bank_id << " - " << std::bitset<5>(flat_bank_id) << std::endl
@@ -307,18 +288,16 @@ class Hydra : public IControllerPlugin, public Implementation {
           // if the row is in the RCT rows, use RCT_count_table
           if (row_id < m_total_rct_row_size){
             // increment RCT_count_table
-            if (rct_count_table[flat_bank_id].find(row_id) == rct_count_table[flat_bank_id].end()){
-              rct_count_table[flat_bank_id][row_id] = 0;
-            }
-            rct_count_table[flat_bank_id][row_id]++;
-            if (m_is_debug) {
+            int& rctct_count = counter(rct_count_table, size_t(flat_bank_id) * m_total_rct_row_size + row_id);
+            rctct_count++;
+            RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
               std::cout << "Hydra: Row in RCT rows" << std::endl;
-              std::cout << "Hydra: RCT_count_table incremented (" << rct_count_table[flat_bank_id][row_id] << ")" << std::endl;
+              std::cout << "Hydra: RCT_count_table incremented (" << rctct_count << ")" << std::endl;
             }
             // check rct_count_table
             s_rctct_check++;
-            if (rct_count_table[flat_bank_id][row_id] >= m_tracking_threshold){
-              if (m_is_debug) {
+            if (rctct_count >= m_tracking_threshold){
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "Hydra: RCT_count_table above threshold, issue VRR, reset counter" << std::endl;
               }
               // issue VRR
@@ -327,9 +306,9 @@ class Hydra : public IControllerPlugin, public Implementation {
               s_num_vrr_rct++;
               s_num_vrr++;
               // reset rcc
-              rct_count_table[flat_bank_id].erase(row_id);
+              rctct_count = 0;
             } else {
-              if (m_is_debug) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "Hydra: RCT_count_table below threshold, do nothing" << std::endl;
               }
             }
@@ -339,36 +318,31 @@ class Hydra : public IControllerPlugin, public Implementation {
           // check gct
           s_gct_check++;
 
-          if (group_count_table[flat_bank_id].find(gct_index) == group_count_table[flat_bank_id].end()) {
-            GCT_Entry new_group_entry;
-            new_group_entry.group_count = 0;
-            new_group_entry.initialized = false;
-            group_count_table[flat_bank_id][gct_index] = new_group_entry;
-          }
+          GCT_Entry& group_entry = gct_entry(flat_bank_id, gct_index);
 
-          if (group_count_table[flat_bank_id][gct_index].group_count >= m_group_threshold){
-            if (m_is_debug) {
+          if (group_entry.group_count >= m_group_threshold){
+            RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
               std::cout << "Hydra: Checking GCT" << std::endl;
               std::cout << "Hydra: GCT above threshold " 
-                        << group_count_table[flat_bank_id][gct_index].group_count << std::endl;
+                        << group_entry.group_count << std::endl;
             }
 
-            if (!group_count_table[flat_bank_id][gct_index].initialized){
-              if (m_is_debug) {
+            if (!group_entry.initialized){
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "Hydra: Group not initialized" << std::endl;
               }
 
               // initialize rct
-              group_count_table[flat_bank_id][gct_index].initialized = true;
+              group_entry.initialized = true;
               s_num_initialization++;
               int row_group_start_row_id = gct_index * m_row_group_size;
               for (int i = 0; i < m_row_group_size; i++){
                 int row = row_group_start_row_id + i;
-                row_count_table[flat_bank_id][row] = m_group_threshold;
+                row_count_table[size_t(flat_bank_id) * m_num_rows_per_bank + row] = {m_group_threshold, m_epoch};
               }
               // generate write request to DRAM for rct
               for (int i = 0; i < m_group_rct_cl_size; i++){
-                std::vector<int> rct_init_addr_vec;
+                AddrVec_t rct_init_addr_vec;
                 for (int j = 0; j < req_it->addr_vec.size(); j++){
                   rct_init_addr_vec.push_back(req_it->addr_vec[j]);
                 }
@@ -379,7 +353,7 @@ class Hydra : public IControllerPlugin, public Implementation {
                 m_ctrl->priority_send(rct_init_req);
                 s_num_write_req++;
                 
-                if (m_is_debug) {
+                RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                   std::cout << "Hydra: Group initializing, generating write request to DRAM for RCT" << std::endl
                             << "        rct_bank: " << flat_bank_id << std::endl
                             << "        rct_row:  " << rct_init_addr_vec[m_row_level] << std::endl
@@ -387,35 +361,42 @@ class Hydra : public IControllerPlugin, public Implementation {
                 }
               }
             } else {
-              if (m_is_debug) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "Hydra: Group already initialized" << std::endl;
               }
             }
 
-            if (m_is_debug) {
-              std::cout << "Hydra: Checking RCC[" << rank_id << "][" << rcc_index << "].size() = " << row_count_cache[rank_id][rcc_index].size() << std::endl;
-              for (auto it = row_count_cache[rank_id][rcc_index].begin(); it != row_count_cache[rank_id][rcc_index].end(); it++){
-                std::cout << "        tag: " << std::setw(6) << it->first << " counter: " << it->second << std::endl;
+            RCC_Entry* rcc_set = &row_count_cache[(size_t(rank_id) * m_rcc_set_num + rcc_index) * RCC_WAYS];
+            int& row_count = counter(row_count_table, size_t(flat_bank_id) * m_num_rows_per_bank + row_id);
+
+            RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
+              std::cout << "Hydra: Checking RCC[" << rank_id << "][" << rcc_index << "].size() = " << rcc_set_size(rcc_set) << std::endl;
+              for (int way = 0; way < RCC_WAYS; way++){
+                if (rcc_set[way].epoch == m_epoch){
+                  std::cout << "        tag: " << std::setw(6) << rcc_set[way].tag << " counter: " << rcc_set[way].count << std::endl;
+                }
               }
             }
 
             // check rcc
             s_rcc_check++;
-            if (row_count_cache[rank_id][rcc_index].find(rcc_tag) == row_count_cache[rank_id][rcc_index].end()){
+            int rcc_way = rcc_find(rcc_set, rcc_tag);
+            if (rcc_way == -1){
               s_num_rcc_miss++;
-              if (m_is_debug) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "Hydra: RCC miss" << std::endl;
               }
               // check if rcc line is full
-              if (row_count_cache[rank_id][rcc_index].size() == 16){
+              rcc_way = rcc_find_empty(rcc_set);
+              if (rcc_way == -1){
                 // evicting an entry
-                int tag_to_evict = get_tag_to_evict(rank_id, rcc_index);
-                row_count_cache[rank_id][rcc_index].erase(tag_to_evict);
-                if (m_is_debug) {
+                rcc_way = get_way_to_evict(rcc_set);
+                int tag_to_evict = rcc_set[rcc_way].tag;
+                RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                   std::cout << "Hydra: RCC full, evicting " << tag_to_evict << std::endl;
                 }
                 // generate write request to DRAM for evicted entry
-                std::vector<int> evicted_entry_addr_vec;
+                AddrVec_t evicted_entry_addr_vec;
                 for (int i = 0; i < req_it->addr_vec.size(); i++){
                   evicted_entry_addr_vec.push_back(req_it->addr_vec[i]);
                 }
@@ -431,7 +412,7 @@ class Hydra : public IControllerPlugin, public Implementation {
                 s_num_eviction++;
                 s_num_write_req++;
 
-                if (m_is_debug) {
+                RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                   std::cout << "Hydra: Generating write request to DRAM for evicted entry" << std::endl
                             << "        evicted_row_id:  " << std::setw(6) << evicted_row_id  << " -     " << std::bitset<16>(evicted_row_id) << std::endl
                             << "        evicted_bank_id: " << std::setw(6) << evicted_bank_id << " - " << std::bitset<4>(evicted_bank_id) << std::endl
@@ -441,7 +422,7 @@ class Hydra : public IControllerPlugin, public Implementation {
                             << "        rct_col:         " << std::setw(6) << evicted_entry_addr_vec[m_col_level] << std::endl;
                 }
               } else {
-                if (m_is_debug) {
+                RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                   std::cout << "Hydra: RCC not full" << std::endl;
                 }
               }
@@ -461,10 +442,10 @@ class Hydra : public IControllerPlugin, public Implementation {
               s_num_read_req++;
 
               // insert new entry and increment rcc
-              row_count_table[flat_bank_id][row_id]++;
-              row_count_cache[rank_id][rcc_index][rcc_tag] = row_count_table[flat_bank_id][row_id];
+              row_count++;
+              rcc_set[rcc_way] = {rcc_tag, row_count, m_epoch};
               
-              if (m_is_debug) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "Hydra: Generating read request to DRAM for RCT" << std::endl
                           << "        rct_bank: " << flat_bank_id << std::endl
                           << "        rct_row:  " << rct_read_addr_vec[m_row_level] << std::endl
@@ -472,21 +453,21 @@ class Hydra : public IControllerPlugin, public Implementation {
                 std::cout << "Hydra: RCC incrementing" << std::endl;
               }
             } else {
-              row_count_cache[rank_id][rcc_index][rcc_tag]++;
-              row_count_table[flat_bank_id][row_id]++;
-              if (m_is_debug) {
+              rcc_set[rcc_way].count++;
+              row_count++;
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "Hydra: RCC hit" << std::endl;
                 std::cout << "Hydra: RCC incrementing" << std::endl;
               }
             }
 
-            if (m_is_debug) {
-              std::cout << "Hydra: Checking RCC counter (" << row_count_cache[rank_id][rcc_index][rcc_tag] << ")" << std::endl;
+            RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
+              std::cout << "Hydra: Checking RCC counter (" << rcc_set[rcc_way].count << ")" << std::endl;
             }
 
             // check if counter is above threshold
-            if (row_count_cache[rank_id][rcc_index][rcc_tag] >= m_tracking_threshold){
-              if (m_is_debug) {
+            if (rcc_set[rcc_way].count >= m_tracking_threshold){
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "Hydra: RCC above threshold, issue VRR, reset counter" << std::endl;
               }
               // issue VRR
@@ -494,21 +475,21 @@ class Hydra : public IControllerPlugin, public Implementation {
               m_ctrl->priority_send(vrr_req);
               s_num_vrr++;
               // reset rcc
-              row_count_cache[rank_id][rcc_index][rcc_tag] = 0;
-              row_count_table[flat_bank_id][row_id] = 0;
+              rcc_set[rcc_way].count = 0;
+              row_count = 0;
             } else {
-              if (m_is_debug) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "Hydra: RCC below threshold, do nothing" << std::endl;
               }
             }
           }
           else{
-            if (m_is_debug) {
+            RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
               std::cout << "Hydra: Checking GCT" << std::endl;
-              std::cout << "Hydra: GCT below threshold (" << group_count_table[flat_bank_id][gct_index].group_count << ")" << std::endl;
+              std::cout << "Hydra: GCT below threshold (" << group_entry.group_count << ")" << std::endl;
               std::cout << "Hydra: GCT incrementing" << std::endl;
             }
-            group_count_table[flat_bank_id][gct_index].group_count++;
+            group_entry.group_count++;
           }
         }
       }
@@ -521,27 +502,67 @@ class Hydra : public IControllerPlugin, public Implementation {
       return std::make_pair(rct_row_id, rct_col_id);
     };
 
-    int get_tag_to_evict(int rank_id, int rcc_index) {
-      int tag_to_evict = -1;
+    // Picks the way of a full RCC set to evict
+    int get_way_to_evict(const RCC_Entry* rcc_set) {
+      int way_to_evict = -1;
 
       if (m_rcc_policy == "RANDOM") {
-        int tag_index = distribution(generator);
-        auto it = row_count_cache[rank_id][rcc_index].begin();
-        std::advance(it, tag_index);
-        tag_to_evict = it->first;
+        way_to_evict = distribution(generator);
       } else if (m_rcc_policy == "MIN_COUNT") {
         int min_count = INT_MAX;
-        for (auto it = row_count_cache[rank_id][rcc_index].begin(); it != row_count_cache[rank_id][rcc_index].end(); it++) {
-          if (it->second < min_count) {
-            min_count = it->second;
-            tag_to_evict = it->first;
+        for (int way = 0; way < RCC_WAYS; way++) {
+          if (rcc_set[way].count < min_count) {
+            min_count = rcc_set[way].count;
+            way_to_evict = way;
           }
         }
       } else {
         throw ConfigurationError("Undefined RCC eviction policy.");
       }
 
-      return tag_to_evict;
+      return way_to_evict;
+    };
+
+    GCT_Entry& gct_entry(int flat_bank_id, int gct_index) {
+      GCT_Entry& entry = group_count_table[size_t(flat_bank_id) * m_gct_entries_per_bank + gct_index];
+      if (entry.epoch != m_epoch) {
+        entry = {0, false, m_epoch};
+      }
+      return entry;
+    };
+
+    int& counter(LazyArray<Counter>& table, size_t index) {
+      Counter& entry = table[index];
+      if (entry.epoch != m_epoch) {
+        entry = {0, m_epoch};
+      }
+      return entry.count;
+    };
+
+    int rcc_find(const RCC_Entry* rcc_set, Addr_t tag) const {
+      for (int way = 0; way < RCC_WAYS; way++) {
+        if (rcc_set[way].epoch == m_epoch && rcc_set[way].tag == tag) {
+          return way;
+        }
+      }
+      return -1;
+    };
+
+    int rcc_find_empty(const RCC_Entry* rcc_set) const {
+      for (int way = 0; way < RCC_WAYS; way++) {
+        if (rcc_set[way].epoch != m_epoch) {
+          return way;
+        }
+      }
+      return -1;
+    };
+
+    int rcc_set_size(const RCC_Entry* rcc_set) const {
+      int size = 0;
+      for (int way = 0; way < RCC_WAYS; way++) {
+        size += rcc_set[way].epoch == m_epoch;
+      }
+      return size;
     };
 
     void reserve_rows_for_rct() {
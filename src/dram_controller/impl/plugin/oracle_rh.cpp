@@ -1,25 +1,34 @@
 #include <vector>
-#include <deque>
-#include <unordered_map>
 #include <limits>
-#include <random>
 
 #include "base/base.h"
 #include "dram_controller/controller.h"
 #include "dram_controller/plugin.h"
+#include "dram_controller/impl/plugin/row_act_counters.h"
 
 namespace Ramulator {
 
+/**
+ * @brief    Oracle RowHammer defense: counts the activations of every row, and refreshes the victims of a row (VRR) once
+ *           it reaches tRH activations since the last refresh of its rank.
+ *
+ * @details
+ * With a blast_radius, it also tracks the ground truth of the victims: the activations of the rows within the blast
+ * radius of every row, cleared when a VRR refreshes it. The victims that reach victim_threshold (tRH by default) before
+ * being refreshed are counted at every rank refresh.
+ *
+ */
 class OracleRH : public IControllerPlugin, public Implementation {
   RAMULATOR_REGISTER_IMPLEMENTATION(IControllerPlugin, OracleRH, "OracleRH", "Oracle RowHammer defense")
 
   private:
     IDRAM* m_dram = nullptr;
 
-    using BankACTCounter = std::unordered_map<Addr_t, int>;
-    std::vector<BankACTCounter> m_table;
+    RowACTCounters m_counters;      // Per row of every bank, reset at each refresh of the rank
 
     int m_RH_threshold = -1;
+    int m_blast_radius = 0;
+    int m_victim_threshold = -1;
 
     int m_VRR_req_id = -1;
 
@@ -33,10 +42,23 @@ class OracleRH : public IControllerPlugin, public Implementation {
 
     bool m_is_debug = false;
 
+    size_t s_victim_crossings = 0;  // Victims that reached the victim threshold before a refresh
+
   public:
     void init() override { 
       m_is_debug = param<bool>("debug").default_val(false);
       m_RH_threshold = param<int>("tRH").required();
+      m_blast_radius = param<int>("blast_radius").desc("Rows on each side of an activated row whose disturbance is tracked (0 = no victim tracking).").default_val(0);
+      m_victim_threshold = param<int>("victim_threshold").desc("Disturbance at which a victim counts as crossed (-1 = tRH).").default_val(-1);
+      if (m_RH_threshold <= 0 || m_RH_threshold > RowACTCounters::MAX_COUNT) {
+        throw ConfigurationError("OracleRH tRH must be within [1, {}] (got {})!", RowACTCounters::MAX_COUNT, m_RH_threshold);
+      }
+      if (m_victim_threshold == -1) {
+        m_victim_threshold = m_RH_threshold;
+      }
+      if (m_blast_radius > 0) {
+        register_stat(s_victim_crossings).name("oracle_rh_victim_crossings");
+      }
     };
 
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
@@ -59,44 +81,59 @@ class OracleRH : public IControllerPlugin, public Implementation {
                              m_dram->get_level_size("bankgroup") * m_dram->get_level_size("bank");
       m_num_rows_per_bank = m_dram->get_level_size("row");
 
-      m_table.resize(m_num_banks_per_rank * m_num_ranks);
+      m_counters = RowACTCounters(m_num_banks_per_rank * m_num_ranks, m_num_rows_per_bank, m_blast_radius, m_victim_threshold);
+
+      m_subscription.per_cycle = false;
+      for (int command = 0; command < m_dram->m_commands.size(); command++) {
+        if ((m_dram->m_command_meta(command).is_opening && m_dram->m_command_scopes(command) == m_row_level) ||
+            (m_dram->m_command_meta(command).is_refreshing && m_dram->m_command_scopes(command) == m_rank_level)) {
+          m_subscription.commands.push_back(command);
+        }
+      }
     };
 
     void update(bool request_found, ReqBuffer::iterator& req_it) override {
       if (request_found) {
-        if (
-          m_dram->m_command_meta(req_it->command).is_opening && 
-          m_dram->m_command_scopes(req_it->command) == m_row_level
-        ) {
-          int flat_bank_id = req_it->addr_vec[m_bank_level];
-          int accumulated_dimension = 1;
-          for (int i = m_bank_level - 1; i >= m_rank_level; i--) {
-            accumulated_dimension *= m_dram->m_organization.count[i + 1];
-            flat_bank_id += req_it->addr_vec[i] * accumulated_dimension;
-          }
-          
-          int row_id = req_it->addr_vec[m_row_level];
-          if (m_table[flat_bank_id].find(row_id) != m_table[flat_bank_id].end()) {
-            m_table[flat_bank_id][row_id]++;
-            if (m_table[flat_bank_id][row_id] >= m_RH_threshold) {
-              m_table[flat_bank_id][row_id] = 0;
-              Request vrr_req(req_it->addr_vec, m_VRR_req_id);
-              m_ctrl->priority_send(vrr_req);
-            }
-          } else {
-            m_table[flat_bank_id][row_id] = 1;
+        const CommandEvent& event = m_ctrl->m_command_event;
+        if (event.is_activation) {
+          int flat_bank_id = event.flat_bank;
+          int row_id = event.row;
+          if (m_counters.activate(flat_bank_id, row_id) >= m_RH_threshold) {
+            m_counters.reset_acts(flat_bank_id, row_id);
+            m_counters.refresh_victims(flat_bank_id, row_id);
+            Request vrr_req(req_it->addr_vec, m_VRR_req_id);
+            m_ctrl->priority_send(vrr_req);
           }
-        } else if (
-          m_dram->m_command_meta(req_it->command).is_refreshing && 
-          m_dram->m_command_scopes(req_it->command) == m_rank_level) {
-            int rank_id = req_it->addr_vec[m_rank_level];
+        } else if (event.is_refreshing && event.scope == m_rank_level) {
+            int rank_id = event.flat_rank;
             for (int i = rank_id * m_num_banks_per_rank; i < (rank_id + 1) * m_num_banks_per_rank; i++) {
-              m_table[i].clear();
+              take_crossings(i);
+              m_counters.reset(i);
             }
         }
       }
     };
 
+    void finalize() override {
+      for (int i = 0; i < m_num_banks_per_rank * m_num_ranks; i++) {
+        take_crossings(i);
+      }
+    };
+
+    size_t memory_footprint() const override { return m_counters.footprint_bytes(); };
+
+  private:
+    void take_crossings(int flat_bank_id) {
+      if (!m_counters.tracks_victims()) {
+        return;
+      }
+      m_counters.take_crossings(flat_bank_id, [&](int row) {
+        s_victim_crossings++;
+        RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
+          std::cout << "OracleRH: victim row " << row << " of bank " << flat_bank_id << " reached " << m_victim_threshold << " activations" << std::endl;
+        }
+      });
+    };
 };
 
 }       // namespace Ramulator
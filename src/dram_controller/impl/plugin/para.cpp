@@ -1,15 +1,15 @@
 #include <vector>
-#include <unordered_map>
 #include <limits>
-#include <random>
 
 #include "base/base.h"
+#include "base/checkpoint.h"
+#include "base/random.h"
 #include "dram_controller/controller.h"
 #include "dram_controller/plugin.h"
 
 namespace Ramulator {
 
-class PARA : public IControllerPlugin, public Implementation {
+class PARA : public IControllerPlugin, public Implementation, public Checkpointable {
   RAMULATOR_REGISTER_IMPLEMENTATION(IControllerPlugin, PARA, "PARA", "PARA.")
 
   private:
@@ -18,8 +18,10 @@ class PARA : public IControllerPlugin, public Implementation {
     float m_pr_threshold;
 
     int   m_seed;
-    std::mt19937 m_generator;
-    std::uniform_real_distribution<float> m_distribution;
+    RandomStream m_generator;
+    // Each ACT triggers a VRR with probability m_pr_threshold, so the ACTs between two VRRs are drawn at once
+    GeometricSampler m_sampler;
+    uint64_t m_acts_to_vrr = 0;         // ACTs to let pass before the next VRR
     bool m_is_debug = false;
 
     int m_VRR_req_id = -1;
@@ -33,8 +35,7 @@ class PARA : public IControllerPlugin, public Implementation {
         throw ConfigurationError("Invalid probability threshold ({}) for PARA!", m_pr_threshold);
 
       m_seed = param<int>("seed").desc("Seed for the RNG").default_val(123);
-      m_generator = std::mt19937(m_seed);
-      m_distribution = std::uniform_real_distribution<float>(0.0, 1.0);
+      m_sampler = GeometricSampler(m_pr_threshold);
 
       m_is_debug = param<bool>("debug").default_val(false);
     };
@@ -50,22 +51,42 @@ class PARA : public IControllerPlugin, public Implementation {
       m_VRR_req_id = m_dram->m_requests("victim-row-refresh");
       m_bank_level = m_dram->m_levels("bank");
       m_row_level = m_dram->m_levels("row");
+
+      m_generator = random_stream(m_seed);
+      m_acts_to_vrr = m_sampler.next(m_generator);
+
+      m_subscription.per_cycle = false;
+      for (int command = 0; command < m_dram->m_commands.size(); command++) {
+        if (m_dram->m_command_meta(command).is_opening && m_dram->m_command_scopes(command) == m_row_level) {
+          m_subscription.commands.push_back(command);
+        }
+      }
     };
 
     void update(bool request_found, ReqBuffer::iterator& req_it) override {
       if (request_found) {
-        if (
-          m_dram->m_command_meta(req_it->command).is_opening && 
-          m_dram->m_command_scopes(req_it->command) == m_row_level
-        ) {
-          if (m_distribution(m_generator) < m_pr_threshold) {
+        if (m_ctrl->m_command_event.is_activation) {
+          if (m_acts_to_vrr == 0) {
             Request vrr_req(req_it->addr_vec, m_VRR_req_id);
             m_ctrl->priority_send(vrr_req);
+            m_acts_to_vrr = m_sampler.next(m_generator);
+          } else {
+            m_acts_to_vrr--;
           }
         }
       }
     };
 
+    // The position of the RNG stream and the ACTs left to the next VRR, so the restored simulation draws the same sequence
+    void save_checkpoint(std::ostream& out) override {
+      Checkpoint::write<uint64_t>(out, m_generator.position());
+      Checkpoint::write<uint64_t>(out, m_acts_to_vrr);
+    };
+
+    void load_checkpoint(std::istream& in) override {
+      m_generator.seek(Checkpoint::read<uint64_t>(in));
+      m_acts_to_vrr = Checkpoint::read<uint64_t>(in);
+    };
 };
 
 }       // namespace Ramulator
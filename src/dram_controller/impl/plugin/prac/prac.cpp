@@ -6,9 +6,7 @@
 
 #include <limits>
 #include <vector>
-#include <functional>
-#include <unordered_map>
-#include <unordered_set>
+#include <string_view>
 
 namespace Ramulator {
 
@@ -18,10 +16,22 @@ class PRAC : public IControllerPlugin, public Implementation, public IPRAC {
 private:
     class PerBankCounters;
 
+    /// What a command does to the counters
+    enum class CommandKind {
+        NONE,
+        ACTIVATE,       // Opens the row whose counter the next precharge updates
+        PRECHARGE,      // Updates the counter of the open row (PRE, PREA, PREsb, RDA, WRA)
+        MITIGATE        // RFM: resets the counter of the top aggressor
+    };
+
+    static constexpr const char* STATE_NAMES[] = {
+        "ABOState::NORMAL", "ABOState::PRE_RECOVERY", "ABOState::RECOVERY", "ABOState::DELAY"
+    };
+
 private:
     DeviceConfig m_cfg;
     std::vector<PRAC::PerBankCounters> m_bank_counters;
-    std::vector<int> m_same_bank_offsets;
+    std::vector<CommandKind> m_command_kinds;   // Per command
 
     Clk_t m_clk = 0;
 
@@ -42,6 +52,7 @@ private:
     bool m_debug = false;
 
     uint64_t s_num_recovery = 0;
+    uint64_t s_num_counter_updates = 0;
 
 public:
     void init() override { 
@@ -54,10 +65,26 @@ public:
 
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
         m_cfg.set_device(cast_parent<IDRAMController>());
-        init_dram_params(m_cfg.m_dram);
+        IDRAM* dram = m_cfg.m_dram;
+        init_dram_params(dram);
+
+        m_command_kinds.assign(dram->m_commands.size(), CommandKind::NONE);
+        for (std::string_view cmd : {"ACT", "PRE", "RFMab", "RFMsb"}) {
+            if (!dram->m_commands.contains(cmd)) {
+                throw ConfigurationError("PRAC needs the {} command, which {} does not have!", cmd, dram->get_name());
+            }
+        }
+        m_command_kinds[dram->m_commands("ACT")] = CommandKind::ACTIVATE;
+        for (std::string_view cmd : {"PRE", "PREA", "PREsb", "RDA", "WRA"}) {
+            if (dram->m_commands.contains(cmd)) {
+                m_command_kinds[dram->m_commands(cmd)] = CommandKind::PRECHARGE;
+            }
+        }
+        m_command_kinds[dram->m_commands("RFMab")] = CommandKind::MITIGATE;
+        m_command_kinds[dram->m_commands("RFMsb")] = CommandKind::MITIGATE;
 
         m_is_abo_needed = false;
-        m_abo_act_cycles = m_abo_act_ns / ((float) m_cfg.m_dram->m_timing_vals("tCK_ps") / 1000.0f);
+        m_abo_act_cycles = m_abo_act_ns / ((float) dram->m_timing_vals("tCK_ps") / 1000.0f);
 
         m_bank_counters.reserve(m_cfg.m_num_banks);
         for (int i = 0; i < m_cfg.m_num_banks; i++) {
@@ -65,112 +92,53 @@ public:
         }
 
         register_stat(s_num_recovery).name("prac_num_recovery");
+        register_stat(s_num_counter_updates).name("prac_num_counter_updates");
     }
 
     void update(bool request_found, ReqBuffer::iterator& req_it) override {
-        m_clk++;
-
-        update_state_machine(request_found, *req_it);
+        if (is_new_cycle(request_found)) {
+            m_clk++;
+            // The end of the ABO window is the only timed event
+            if (m_clk >= m_abo_recovery_start) {
+                set_state(ABOState::RECOVERY);
+                m_abo_recovery_start = std::numeric_limits<Clk_t>::max();
+                m_abo_recov_rem_refs = m_abo_recovery_refs * m_cfg.m_num_ranks;
+            }
+        }
 
         if (!request_found) {
             return;
         }
 
-        auto& req = *req_it;
-        auto& req_meta = m_cfg.m_dram->m_command_meta(req.command);
-        auto& req_scope = m_cfg.m_dram->m_command_scopes(req.command);
-
-        bool has_bank_wildcard = req.addr_vec[m_cfg.m_bank_level] == -1;
-        bool has_bankgroup_wildcard = req.addr_vec[m_cfg.m_bankgroup_level] == -1;
-        if (has_bankgroup_wildcard && has_bank_wildcard) { // All BG, All Bank
-            int offset = req.addr_vec[m_cfg.m_rank_level] * m_cfg.m_num_banks_per_rank;
-            for (int i = 0; i < m_cfg.m_num_banks_per_rank; i++) {
-                m_bank_counters[offset + i].on_request(req);
-            }
-            req.addr_vec[m_cfg.m_bank_level] = -1;
-        }
-        else if (has_bankgroup_wildcard) { // All BG, Single Bank
-            int rank_offset = req.addr_vec[m_cfg.m_rank_level] * m_cfg.m_num_banks_per_rank;
-            int bank_offset = req.addr_vec[m_cfg.m_bank_level];
-            for (int i = 0; i < m_cfg.m_num_bankgroups; i++) {
-                int bg_offset = i * m_cfg.m_num_banks_per_bankgroup;
-                m_bank_counters[rank_offset + bg_offset + bank_offset].on_request(req);
-            }
-        }
-        else if (has_bank_wildcard) { // Single BG, All Bank
-            int rank_offset = req.addr_vec[m_cfg.m_rank_level] * m_cfg.m_num_banks_per_rank;
-            int bg_offset = req.addr_vec[m_cfg.m_bankgroup_level] * m_cfg.m_num_banks_per_bankgroup; 
-            for (int i = 0; i < m_cfg.m_num_banks_per_bankgroup; i++) {
-                m_bank_counters[rank_offset + bg_offset + i].on_request(req);
-            }
-        }
-        else { // Single BG, Single Bank
-            auto flat_bank_id = m_cfg.get_flat_bank_id(req);
-            m_bank_counters[flat_bank_id].on_request(req);
-        }
-    }
-
-    void update_state_machine(bool request_found, const Request& req) {
-        std::unordered_map<ABOState, std::string> state_names = {
-            {ABOState::NORMAL, "ABOState::NORMAL"},
-            {ABOState::PRE_RECOVERY, "ABOState::PRE_RECOVERY"},
-            {ABOState::RECOVERY, "ABOState::RECOVERY"},
-            {ABOState::DELAY, "ABOState::DELAY"}
-        };
-        auto cmd_prea = m_cfg.m_dram->m_commands("PREA");
-        auto cmd_rfmab = m_cfg.m_dram->m_commands("RFMab");
-        auto cmd_rfmsb = m_cfg.m_dram->m_commands("RFMsb");
-        auto cmd_act = m_cfg.m_dram->m_commands("ACT");
-        auto cur_state = m_state;
-        switch(m_state) {
-        case ABOState::NORMAL:
-            if (m_is_abo_needed) {
-                if (m_debug) {
-                    std::printf("[PRAC] [%lu] <%s> Asserting ALERT_N.\n", m_clk, state_names[cur_state].c_str());
-                }
-                m_state = ABOState::PRE_RECOVERY;
-                m_abo_recovery_start = m_clk + m_abo_act_cycles;
-                s_num_recovery++;
-            }
+        const Request& req = *req_it;
+        switch (m_command_kinds[req.command]) {
+        case CommandKind::NONE:
             break;
-        case ABOState::PRE_RECOVERY:
-            if (request_found && req.command == cmd_prea) {
-                if (m_debug) {
-                    std::printf("[PRAC] [%lu] <%s> Received PREA.\n", m_clk, state_names[cur_state].c_str());
+        case CommandKind::ACTIVATE:
+            m_bank_counters[m_cfg.get_flat_bank_id(req)].on_activate(req.addr_vec[m_cfg.m_row_level]);
+            if (m_state == ABOState::DELAY && --m_abo_delay_rem_acts == 0) {
+                m_is_abo_needed = false;
+                for (auto& counters : m_bank_counters) {
+                    m_is_abo_needed |= counters.is_critical();
                 }
-            }
-            if (m_clk == m_abo_recovery_start) {
-                m_state = ABOState::RECOVERY;
-                m_abo_recovery_start = std::numeric_limits<Clk_t>::max();
-                m_abo_recov_rem_refs = m_abo_recovery_refs * m_cfg.m_num_ranks;
+                set_state(ABOState::NORMAL);
+                assert_alert_if_needed();
             }
             break;
-        case ABOState::RECOVERY:
-            if (request_found && (req.command == cmd_rfmab ||
-                req.command == cmd_rfmsb)) {
-                m_abo_recov_rem_refs--;
-                if (!m_abo_recov_rem_refs) {
-                    m_state = ABOState::DELAY;
-                    m_abo_delay_rem_acts = m_abo_delay_acts;
-                }
-            }
+        case CommandKind::PRECHARGE:
+            for_each_bank(req, [this](PerBankCounters& counters) {
+                s_num_counter_updates += counters.on_precharge();
+            });
+            assert_alert_if_needed();
             break;
-        case ABOState::DELAY:
-            if (request_found && req.command == cmd_act) {
-                m_abo_delay_rem_acts--;
-                if (!m_abo_delay_rem_acts) {
-                    m_is_abo_needed = false;
-                    for (int i = 0; i < m_cfg.m_num_banks; i++) {
-                        m_is_abo_needed |= m_bank_counters[i].is_critical();
-                    }
-                    m_state = ABOState::NORMAL;
-                }
+        case CommandKind::MITIGATE:
+            for_each_bank(req, [](PerBankCounters& counters) { counters.on_rfm(); });
+            if (m_state == ABOState::RECOVERY && --m_abo_recov_rem_refs == 0) {
+                set_state(ABOState::DELAY);
+                m_abo_delay_rem_acts = m_abo_delay_acts;
             }
             break;
         }
-        if (m_debug && cur_state != m_state) {
-            std::printf("[PRAC] [%lu] <%s> -> <%s>\n", m_clk, state_names[cur_state].c_str(), state_names[m_state].c_str());
-        }
     }
 
     Clk_t next_recovery_cycle() override {
@@ -186,100 +154,191 @@ public:
     }
 
 private:
+    /**
+     * Asserts ALERT_N if a counter reached the threshold and no ABO is in progress. The counter is written back
+     * counter_update_cycles into the precharge, and the recovery starts once the ABO window after it ends.
+     */
+    void assert_alert_if_needed() {
+        if (!m_is_abo_needed || m_state != ABOState::NORMAL) {
+            return;
+        }
+        RAMULATOR_TRACE_IF(Plugin, m_debug) {
+            std::printf("[PRAC] [%lu] <%s> Asserting ALERT_N.\n", m_clk, STATE_NAMES[(int) m_state]);
+        }
+        set_state(ABOState::PRE_RECOVERY);
+        m_abo_recovery_start = m_clk + counter_update_cycles + m_abo_act_cycles;
+        s_num_recovery++;
+    }
+
+    void set_state(ABOState state) {
+        RAMULATOR_TRACE_IF(Plugin, m_debug) {
+            std::printf("[PRAC] [%lu] <%s> -> <%s>\n", m_clk, STATE_NAMES[(int) m_state], STATE_NAMES[(int) state]);
+        }
+        m_state = state;
+    }
+
+    /// Calls func with the counters of every bank the (possibly all-bank or same-bank) command addresses
+    template<typename Func>
+    void for_each_bank(const Request& req, Func&& func) {
+        bool has_bank_wildcard = req.addr_vec[m_cfg.m_bank_level] == -1;
+        bool has_bankgroup_wildcard = req.addr_vec[m_cfg.m_bankgroup_level] == -1;
+        int rank_offset = req.addr_vec[m_cfg.m_rank_level] * m_cfg.m_num_banks_per_rank;
+        if (has_bankgroup_wildcard && has_bank_wildcard) { // All BG, All Bank
+            for (int i = 0; i < m_cfg.m_num_banks_per_rank; i++) {
+                func(m_bank_counters[rank_offset + i]);
+            }
+        }
+        else if (has_bankgroup_wildcard) { // All BG, Single Bank
+            int bank_offset = req.addr_vec[m_cfg.m_bank_level];
+            for (int i = 0; i < m_cfg.m_num_bankgroups; i++) {
+                int bg_offset = i * m_cfg.m_num_banks_per_bankgroup;
+                func(m_bank_counters[rank_offset + bg_offset + bank_offset]);
+            }
+        }
+        else if (has_bank_wildcard) { // Single BG, All Bank
+            int bg_offset = req.addr_vec[m_cfg.m_bankgroup_level] * m_cfg.m_num_banks_per_bankgroup; 
+            for (int i = 0; i < m_cfg.m_num_banks_per_bankgroup; i++) {
+                func(m_bank_counters[rank_offset + bg_offset + i]);
+            }
+        }
+        else { // Single BG, Single Bank
+            func(m_bank_counters[m_cfg.get_flat_bank_id(req)]);
+        }
+    }
+
+private:
+    /**
+     * Activation counters of the rows of one bank, in a dense array indexed by row. As in the device, an ACT only
+     * latches its row, and the precharge that closes it increments its counter in place. The rows with a non-zero
+     * count also sit in a max-heap on their counts (with the position of every row in the heap), so an RFM finds the
+     * top aggressor at the root, and a precharge or RFM updates the heap in O(log n).
+     */
     class PerBankCounters {
     public: 
         PerBankCounters(int bank_id, DeviceConfig& cfg, bool& is_abo_needed, int alert_thresh, bool debug)
-        : m_bank_id(bank_id), m_cfg(cfg), m_is_abo_needed(is_abo_needed),
-        m_alert_thresh(alert_thresh), m_debug(debug) {
-            init_dram_params(m_cfg.m_dram);
+        : m_cfg(cfg), m_is_abo_needed(is_abo_needed),
+        m_counters(cfg.m_num_rows_per_bank, 0), m_heap_pos(cfg.m_num_rows_per_bank, -1),
+        m_alert_thresh(alert_thresh), m_debug(debug), m_bank_id(bank_id) {
             reset();
         }
 
-        ~PerBankCounters() {
-            m_counters.clear();
+        void on_activate(int row) {
+            m_open_row = row;
         }
 
-        void on_request(const Request& req) {
-            if (m_handlertable.find(req.command) != m_handlertable.end()) {
-                m_handlertable[req.command].handler(req);
+        void reset() {
+            for (int row : m_heap) {
+                m_counters[row] = 0;
+                m_heap_pos[row] = -1;
             }
+            m_heap.clear();
+            m_num_critical_rows = 0;
+            m_open_row = -1;
         }
 
-        void init_dram_params(IDRAM* dram) {
-            CommandHandler handlers[] = {
-                // TODO: We should process PREs? Doesn't really change the results though.
-                {std::string("ACT"), std::bind(&PerBankCounters::process_act, this, std::placeholders::_1)},
-                {std::string("RFMab"), std::bind(&PerBankCounters::process_rfm, this, std::placeholders::_1)},
-                {std::string("RFMsb"), std::bind(&PerBankCounters::process_rfm, this, std::placeholders::_1)}
-            };
-            for (auto& h : handlers) {
-                if (!dram->m_commands.contains(h.cmd_name)) {
-                    std::cout << "[PRAC] Command " << h.cmd_name << "does not exist." << std::endl;
-                    exit(0);
-                }
-                m_handlertable[dram->m_commands(h.cmd_name)] = h;
-            }
+        bool is_critical() {
+            return m_num_critical_rows > 0;
         }
 
-        void reset() {
-            m_counters.clear();
-            m_critical_rows.clear();
+        /// Increments the counter of the open row, if any, and closes it. Returns whether a counter was updated.
+        bool on_precharge() {
+            if (m_open_row == -1) {
+                return false;
+            }
+            int row_addr = m_open_row;
+            m_open_row = -1;
+            uint32_t count = ++m_counters[row_addr];
+            if (m_heap_pos[row_addr] == -1) {
+                m_heap_pos[row_addr] = m_heap.size();
+                m_heap.push_back(row_addr);
+            }
+            sift_up(m_heap_pos[row_addr]);
+            RAMULATOR_TRACE_IF(Plugin, m_debug) {
+                std::printf("[PRAC] [%d] [PRE] Row: %d Act: %u\n",
+                    m_bank_id, row_addr, count);
+            }
+            if (count >= m_alert_thresh) {
+                m_num_critical_rows += (count == m_alert_thresh);
+                m_is_abo_needed = true;
+            }
+            return true;
         }
 
-        bool is_critical() {
-            return m_critical_rows.size() > 0;
+        void on_rfm() {
+            if (m_heap.empty()) {
+                RAMULATOR_TRACE_IF(Plugin, m_debug) {
+                    std::printf("[PRAC] [%d] [RFM] No critical row.\n", m_bank_id);
+                }
+                return;
+            }
+            int act_max = m_heap[0];
+            RAMULATOR_TRACE_IF(Plugin, m_debug) {
+                std::printf("[PRAC] [%d] [RFM] Row: %d Act: %u\n",
+                    m_bank_id, act_max, m_counters[act_max]);
+            }
+            if (m_counters[act_max] >= m_alert_thresh) {
+                m_num_critical_rows--;
+            }
+            m_counters[act_max] = 0;
+            m_heap_pos[act_max] = -1;
+            int last = m_heap.back();
+            m_heap.pop_back();
+            if (!m_heap.empty()) {
+                m_heap[0] = last;
+                m_heap_pos[last] = 0;
+                sift_down(0);
+            }
         }
 
     private:
-        struct CommandHandler {
-            std::string cmd_name;
-            std::function<void(const Request&)> handler;
-        };
-
         DeviceConfig& m_cfg;
         bool& m_is_abo_needed;
 
-        std::unordered_map<int, uint32_t> m_counters;
-        std::unordered_map<int, uint32_t> m_critical_rows;
-        std::unordered_map<int, CommandHandler> m_handlertable;
+        std::vector<uint32_t> m_counters;       // Per row
+        std::vector<int> m_heap;                // The rows with a non-zero count, a max-heap on their counts
+        std::vector<int> m_heap_pos;            // Per row, its index in m_heap or -1
+        int m_num_critical_rows = 0;            // Rows at or above the alert threshold
+        int m_open_row = -1;                    // Latched by the ACT, counted by the precharge
 
         int m_alert_thresh = -1;
         bool m_debug = false;
         int m_bank_id = -1;
 
-        void process_act(const Request& req) {
-            auto row_addr = req.addr_vec[m_cfg.m_row_level];    
-            if (m_counters.find(row_addr) == m_counters.end()) {
-                m_counters[row_addr] = 0;
-            }
-            m_counters[row_addr]++;
-            if (m_debug) {
-                std::printf("[PRAC] [%d] [ACT] Row: %d Act: %u\n",
-                    m_bank_id, row_addr, m_counters[row_addr]);
-            }
-            if (m_counters[row_addr] >= m_alert_thresh) {
-                m_critical_rows[row_addr] = m_counters[row_addr];
-                m_is_abo_needed = true;
+        void sift_up(int pos) {
+            int row = m_heap[pos];
+            while (pos > 0) {
+                int parent = (pos - 1) / 2;
+                if (m_counters[m_heap[parent]] >= m_counters[row]) {
+                    break;
+                }
+                m_heap[pos] = m_heap[parent];
+                m_heap_pos[m_heap[pos]] = pos;
+                pos = parent;
             }
+            m_heap[pos] = row;
+            m_heap_pos[row] = pos;
         }
 
-        void process_rfm(const Request& req) {
-            auto act_max = std::max_element(m_counters.begin(), m_counters.end(),
-                [] (const std::pair<int, uint32_t>& p1, const std::pair<int, uint32_t>& p2) {
-                    return p1.second < p2.second;
-                });
-            if (act_max == m_counters.end()) {
-                if (m_debug) {
-                    std::printf("[PRAC] [%d] [RFM] No critical row.\n", m_bank_id);
+        void sift_down(int pos) {
+            int row = m_heap[pos];
+            int size = m_heap.size();
+            while (true) {
+                int child = 2 * pos + 1;
+                if (child >= size) {
+                    break;
                 }
-                return;
-            }
-            if (m_debug) {
-                std::printf("[PRAC] [%d] [RFM] Row: %d Act: %u\n",
-                    m_bank_id, act_max->first, m_counters[act_max->first]);
+                if (child + 1 < size && m_counters[m_heap[child + 1]] > m_counters[m_heap[child]]) {
+                    child++;
+                }
+                if (m_counters[m_heap[child]] <= m_counters[row]) {
+                    break;
+                }
+                m_heap[pos] = m_heap[child];
+                m_heap_pos[m_heap[pos]] = pos;
+                pos = child;
             }
-            m_counters[act_max->first] = 0;
-            m_critical_rows.erase(act_max->first);
+            m_heap[pos] = row;
+            m_heap_pos[row] = pos;
         }
     };  // class PerBankCounters
 
@@ -3,7 +3,8 @@
 
 #include "dram/dram.h"
 
-#include <unordered_map>
+#include <limits>
+#include <vector>
 
 #define _CYCLES(timing_name)    dram->m_timing_vals(timing_name)
 #define _COMMAND(command_name)  dram->m_commands(command_name)
@@ -28,6 +29,7 @@ public:
         auto write_to_pre_timing = _CYCLES("nCWL") + _CYCLES("nBL") + _CYCLES("nWR");
         read_cycles = _CYCLES("nRAS") + _CYCLES("nRTP") + _CYCLES("nRP");
         write_cycles = _CYCLES("nRAS") + write_to_pre_timing + _CYCLES("nRP");
+        cmd_to_min_cycles.assign(dram->m_commands.size(), 0);
         cmd_to_min_cycles[_COMMAND("ACT")] = write_cycles; // TODO: Slightly overshooting reads here
         cmd_to_min_cycles[_COMMAND("RD")] = _CYCLES("nRTP") + _CYCLES("nRP");
         cmd_to_min_cycles[_COMMAND("WR")] = write_to_pre_timing + _CYCLES("nRP");
@@ -35,6 +37,8 @@ public:
         cmd_to_min_cycles[_COMMAND("RFMab")] = _CYCLES("nRFM1");
         cmd_to_min_cycles[_COMMAND("REFsb")] = _CYCLES("nRFCsb");
         cmd_to_min_cycles[_COMMAND("REFab")] = _CYCLES("nRFC1");
+        // The part of nRP the precharge spends updating the activation counter (0 if the device does not model it)
+        counter_update_cycles = dram->m_timings.contains("nPRAC") ? _CYCLES("nPRAC") : 0;
     }
 
     // TODO: Get these from m_timing_cons...
@@ -43,14 +47,23 @@ public:
     }
 
     int min_cycles_with_preall(const Request& req) {
-        if (cmd_to_min_cycles.find(req.command) == cmd_to_min_cycles.end()) {
+        if (req.command < 0 || req.command >= (int) cmd_to_min_cycles.size()) {
             return 0;
         }
         return cmd_to_min_cycles[req.command];
     }
 
+    /// Whether req (and the precharge of its bank) completes before the ABO recovery. Always true while no ABO is scheduled.
+    bool fits_before_recovery(const Request& req, Clk_t clk) {
+        Clk_t next_recovery = next_recovery_cycle();
+        return next_recovery == std::numeric_limits<Clk_t>::max() || clk + min_cycles_with_preall(req) < next_recovery;
+    }
+
+protected:
+    int counter_update_cycles = 0;
+
 private:
-    std::unordered_map<int, int> cmd_to_min_cycles;
+    std::vector<int> cmd_to_min_cycles;     // Per command
     int write_cycles = -1;
     int read_cycles = -1;
 
@@ -0,0 +1,208 @@
+#include "base/base.h"
+#include "dram_controller/controller.h"
+#include "dram_controller/plugin.h"
+#include "frontend/frontend.h"
+#include "dram_controller/impl/latency_histogram.h"
+#include "dram_controller/impl/plugin/qos/qos.h"
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+namespace Ramulator {
+
+/**
+ * @brief    Per-source QoS of the controller: priority classes, bandwidth regulation and deadlines, for the QoS scheduler.
+ *
+ * @details
+ * Each source (core) has a priority class, a bandwidth budget and a deadline, given as lists with one entry per core.
+ *  - Bandwidth is regulated as in MemGuard (Yun et al., RTAS 2013), with a token bucket per source: a source may have
+ *    budget requests admitted per period cycles, with bursts of up to budget requests. The controller refuses a request
+ *    of a source without tokens at send(), and the frontend retries it later. A budget of 0 leaves the source unregulated.
+ *  - A read or write of a source with a deadline becomes urgent urgency_slack cycles before arrive + deadline, and the
+ *    QoS scheduler then serves it ahead of the priority classes.
+ * The plugin reports per source the throttled requests and cycles, the read latency distribution and deadline misses.
+ *
+ */
+class QoS : public IControllerPlugin, public Implementation, public IQoS {
+    RAMULATOR_REGISTER_IMPLEMENTATION(IControllerPlugin, QoS, "QoS", "Per-source priority classes, bandwidth regulation and deadlines.")
+
+private:
+    Clk_t m_clk = 0;
+    IDRAM* m_dram = nullptr;
+
+    Clk_t m_period = -1;
+    Clk_t m_urgency_slack = 0;
+
+    std::vector<int> m_classes;            // Priority class per source
+    std::vector<int> m_budgets;            // Requests per period per source (0 = unregulated)
+    std::vector<Clk_t> m_deadlines;        // Cycles from arrival per source (0 = none)
+
+    std::vector<double> m_tokens;          // Token bucket per source
+    std::vector<Clk_t> m_refill_clk;       // Cycle the bucket was last refilled
+    std::vector<Clk_t> m_throttled_clk;    // Last cycle a request of the source was refused
+    std::vector<LatencyHistogram> m_read_latency_histograms;
+
+    std::vector<size_t> s_admitted_per_core;
+    std::vector<size_t> s_throttled_requests_per_core;
+    std::vector<size_t> s_throttled_cycles_per_core;   // Cycles with at least one refused request
+    std::vector<size_t> s_deadline_misses_per_core;    // Reads whose data came after their deadline
+    std::vector<size_t> s_read_latency_p50_per_core;
+    std::vector<size_t> s_read_latency_p99_per_core;
+    std::vector<size_t> s_read_latency_max_per_core;
+
+public:
+    void init() override {
+        m_period = param<Clk_t>("period").desc("Cycles over which a source may use its budget.").default_val(10000);
+        m_urgency_slack = param<Clk_t>("urgency_slack").desc("Cycles before its deadline at which a request goes first.").default_val(100);
+        m_classes = param<std::vector<int>>("classes").desc("Priority class per core (0 = highest).").default_val(std::vector<int>{});
+        m_budgets = param<std::vector<int>>("budgets").desc("Requests per period per core (0 = unregulated).").default_val(std::vector<int>{});
+        m_deadlines = param<std::vector<Clk_t>>("deadlines").desc("Cycles from arrival to the deadline of the requests per core (0 = none).").default_val(std::vector<Clk_t>{});
+
+        if (m_period <= 0) {
+            throw ConfigurationError("QoS: period must be positive!");
+        }
+        if (m_urgency_slack < 0) {
+            throw ConfigurationError("QoS: urgency_slack cannot be negative!");
+        }
+    }
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+        m_ctrl = cast_parent<IDRAMController>();
+        m_dram = m_ctrl->m_dram;
+
+        size_t num_cores = frontend->get_num_cores();
+        fill_per_core(m_classes, "classes", num_cores, 0);
+        fill_per_core(m_budgets, "budgets", num_cores, 0);
+        fill_per_core(m_deadlines, "deadlines", num_cores, Clk_t(0));
+        for (size_t core_id = 0; core_id < num_cores; core_id++) {
+            if (m_classes[core_id] < 0 || m_budgets[core_id] < 0 || m_deadlines[core_id] < 0) {
+                throw ConfigurationError("QoS: The class, budget and deadline of core {} cannot be negative!", core_id);
+            }
+        }
+
+        m_tokens.assign(m_budgets.begin(), m_budgets.end());
+        m_refill_clk.resize(num_cores, 0);
+        m_throttled_clk.resize(num_cores, -1);
+        m_read_latency_histograms.resize(num_cores);
+
+        s_admitted_per_core.resize(num_cores, 0);
+        s_throttled_requests_per_core.resize(num_cores, 0);
+        s_throttled_cycles_per_core.resize(num_cores, 0);
+        s_deadline_misses_per_core.resize(num_cores, 0);
+        s_read_latency_p50_per_core.resize(num_cores, 0);
+        s_read_latency_p99_per_core.resize(num_cores, 0);
+        s_read_latency_max_per_core.resize(num_cores, 0);
+        for (size_t core_id = 0; core_id < num_cores; core_id++) {
+            register_stat(s_admitted_per_core[core_id]).name("qos_admitted_core_{}", core_id);
+            register_stat(s_throttled_requests_per_core[core_id]).name("qos_throttled_requests_core_{}", core_id);
+            register_stat(s_throttled_cycles_per_core[core_id]).name("qos_throttled_cycles_core_{}", core_id);
+            register_stat(s_deadline_misses_per_core[core_id]).name("qos_deadline_misses_core_{}", core_id);
+            register_stat(s_read_latency_p50_per_core[core_id]).name("qos_read_latency_p50_core_{}", core_id);
+            register_stat(s_read_latency_p99_per_core[core_id]).name("qos_read_latency_p99_core_{}", core_id);
+            register_stat(s_read_latency_max_per_core[core_id]).name("qos_read_latency_max_core_{}", core_id);
+        }
+    }
+
+    void update(bool request_found, ReqBuffer::iterator& req_it) override {
+        m_clk += is_new_cycle(request_found);
+
+        if (!request_found || req_it->command != req_it->final_command || !is_source(req_it->source_id)) {
+            return;
+        }
+        if (req_it->type_id == Request::Type::Read) {
+            int source_id = req_it->source_id;
+            Clk_t latency = m_clk + m_dram->m_read_latency - req_it->arrive;
+            m_read_latency_histograms[source_id].record(latency);
+            if (m_deadlines[source_id] > 0 && latency > m_deadlines[source_id]) {
+                s_deadline_misses_per_core[source_id]++;
+            }
+        }
+    }
+
+    Clk_t get_idle_cycles() override {
+        // The buckets refill lazily, so idle cycles only advance the clock
+        return std::numeric_limits<Clk_t>::max();
+    }
+
+    void skip_cycles(Clk_t num_cycles) override {
+        m_clk += num_cycles;
+    }
+
+    bool is_throttled(const Request& req) override {
+        int source_id = req.source_id;
+        if (!is_source(source_id) || m_budgets[source_id] == 0) {
+            return false;
+        }
+        refill(source_id);
+        if (m_tokens[source_id] >= 1.0) {
+            return false;
+        }
+        s_throttled_requests_per_core[source_id]++;
+        if (m_throttled_clk[source_id] != m_clk) {
+            m_throttled_clk[source_id] = m_clk;
+            s_throttled_cycles_per_core[source_id]++;
+        }
+        return true;
+    }
+
+    void on_admitted(const Request& req) override {
+        int source_id = req.source_id;
+        if (!is_source(source_id)) {
+            return;
+        }
+        s_admitted_per_core[source_id]++;
+        if (m_budgets[source_id] > 0) {
+            m_tokens[source_id] -= 1.0;
+        }
+    }
+
+    int get_class(int source_id) override {
+        if (!is_source(source_id)) {
+            return std::numeric_limits<int>::max();
+        }
+        return m_classes[source_id];
+    }
+
+    bool is_urgent(const Request& req) override {
+        return get_deadline(req) - m_urgency_slack <= m_clk;
+    }
+
+    Clk_t get_deadline(const Request& req) override {
+        if (!is_source(req.source_id) || m_deadlines[req.source_id] == 0) {
+            return std::numeric_limits<Clk_t>::max();
+        }
+        return req.arrive + m_deadlines[req.source_id];
+    }
+
+    void finalize() override {
+        for (size_t core_id = 0; core_id < m_read_latency_histograms.size(); core_id++) {
+            const LatencyHistogram& histogram = m_read_latency_histograms[core_id];
+            s_read_latency_p50_per_core[core_id] = histogram.quantile(0.5);
+            s_read_latency_p99_per_core[core_id] = histogram.quantile(0.99);
+            s_read_latency_max_per_core[core_id] = histogram.max();
+        }
+    }
+
+private:
+    bool is_source(int source_id) const {
+        return source_id >= 0 && source_id < (int) m_classes.size();
+    }
+
+    void refill(int source_id) {
+        double rate = (double) m_budgets[source_id] / (double) m_period;
+        m_tokens[source_id] = std::min<double>(m_budgets[source_id], m_tokens[source_id] + rate * (m_clk - m_refill_clk[source_id]));
+        m_refill_clk[source_id] = m_clk;
+    }
+
+    template <typename T>
+    void fill_per_core(std::vector<T>& values, std::string_view name, size_t num_cores, T default_val) {
+        if (values.empty()) {
+            values.resize(num_cores, default_val);
+        } else if (values.size() != num_cores) {
+            throw ConfigurationError("QoS: {} has {} entries for {} cores!", name, values.size(), num_cores);
+        }
+    }
+};      // class QoS
+
+}       // namespace Ramulator
@@ -0,0 +1,24 @@
+#ifndef RAMULATOR_PLUGIN_QOS_H_
+#define RAMULATOR_PLUGIN_QOS_H_
+
+#include "base/request.h"
+
+namespace Ramulator {
+
+class IQoS {
+public:
+    // Whether the source of the request is out of bandwidth tokens, so the controller refuses it for now
+    virtual bool is_throttled(const Request& req) = 0;
+    // Called once the controller has buffered the request, which takes one token of its source
+    virtual void on_admitted(const Request& req) = 0;
+    // Priority class of the source (0 = highest). Requests without a source get the lowest class
+    virtual int get_class(int source_id) = 0;
+    // Whether the request is within urgency_slack cycles of its deadline (or past it)
+    virtual bool is_urgent(const Request& req) = 0;
+    // The cycle the request should be served by (the largest Clk_t if its source has no deadline)
+    virtual Clk_t get_deadline(const Request& req) = 0;
+};
+
+}
+
+#endif  // RAMULATOR_PLUGIN_QOS_H_
@@ -1,15 +1,28 @@
+#include <bit>
+#include <vector>
+#include <cstdint>
+
 #include "base/base.h"
 #include "dram_controller/controller.h"
 #include "dram_controller/plugin.h"
 
 namespace Ramulator {
 
+/**
+ * @brief    Sends a rank-level RFM once a bank of the rank has received rfm_thresh activations since its last RFM.
+ * @details
+ * The banks that reached the threshold are kept in a bitmask by flat bank id, set as their counters are incremented,
+ * so finding the next rank to RFM is a bit scan. An RFM that the controller cannot take is retried in the next cycles.
+ *
+ */
 class RFMManager : public IControllerPlugin, public Implementation {
     RAMULATOR_REGISTER_IMPLEMENTATION(IControllerPlugin, RFMManager, "RFMManager", "RFM Manager.")
 
 private:
     IDRAM* m_dram = nullptr;
     std::vector<int> m_bank_ctrs;
+    std::vector<uint64_t> m_rfm_ready_banks;   // One bit per flat bank id at or over the threshold
+    int m_num_rfm_ready_banks = 0;
 
     Clk_t m_clk = 0;
 
@@ -64,62 +77,80 @@ public:
         m_num_rows_per_bank = m_dram->get_level_size("row");
         m_num_cls = m_dram->get_level_size("column") / 8;
         
-        m_bank_ctrs.resize(m_num_ranks * m_num_banks_per_rank);
-        for (int i = 0; i < m_bank_ctrs.size(); i++) {
-            m_bank_ctrs[i] = 0;
-        }
+        m_bank_ctrs.assign(m_dram->m_num_flat_banks, 0);
+        m_rfm_ready_banks.assign((m_dram->m_num_flat_banks + 63) / 64, 0);
         m_no_send = 0;
 
         register_stat(s_rfm_counter).name("rfm_counter");
     }
 
     void update(bool request_found, ReqBuffer::iterator& req_it) override {
-        m_clk++;
+        if (is_new_cycle(request_found)) {
+          m_clk++;
+        }
+
+        if (m_num_rfm_ready_banks > 0) {
+            send_rfm();
+        }
 
         if (!request_found) {
             return;
         }
 
-        auto& req = *req_it;
-        auto& req_meta = m_dram->m_command_meta(req.command);
-        auto& req_scope = m_dram->m_command_scopes(req.command);
-        if (!(req_meta.is_opening && req_scope == m_row_level)) {
+        if (!m_ctrl->m_command_event.is_activation) {
             return; 
         }
 
-        int flat_bank_id = req_it->addr_vec[m_bank_level];
-        int accumulated_dimension = 1;
-        for (int i = m_bank_level - 1; i >= m_rank_level; i--) {
-            accumulated_dimension *= m_dram->m_organization.count[i + 1];
-            flat_bank_id += req_it->addr_vec[i] * accumulated_dimension;
-        }
+        int flat_bank_id = m_ctrl->m_command_event.flat_bank;
 
         m_bank_ctrs[flat_bank_id]++;
 
-        if (m_debug) {
+        RAMULATOR_TRACE_IF(Plugin, m_debug) {
             std::cout << "Rank     : " << req_it->addr_vec[m_rank_level] << std::endl;
             std::cout << "Bank     : " << req_it->addr_vec[m_bank_level] << std::endl;
             std::cout << "BankGroup: " << req_it->addr_vec[m_bankgroup_level] << std::endl;
             std::cout << "Flat Bank: " << flat_bank_id << std::endl;
         }
 
-        if (m_bank_ctrs[flat_bank_id] < m_rfm_thresh) {
+        if (m_bank_ctrs[flat_bank_id] != m_rfm_thresh) {
             return;
         }
-         
-        for (int i = 0; i < m_bank_ctrs.size(); i++) {
-            m_bank_ctrs[i] = 0;
-        }
+        m_rfm_ready_banks[flat_bank_id / 64] |= uint64_t(1) << (flat_bank_id % 64);
+        m_num_rfm_ready_banks++;
+        send_rfm();
+    }
 
-        Request rfm(req.addr_vec, m_rfm_req_id);
-        rfm.addr_vec[m_bankgroup_level] = -1;
-        rfm.addr_vec[m_bank_level] = -1;
-        // TODO: Add a buffer to retry later
+private:
+    /**
+     * @brief    Sends an RFM to the rank of the lowest ready bank, and resets the counters of the banks of that rank.
+     *
+     */
+    void send_rfm() {
+        size_t word = 0;
+        while (m_rfm_ready_banks[word] == 0) {
+            word++;
+        }
+        int flat_bank_id = word * 64 + std::countr_zero(m_rfm_ready_banks[word]);
+        int banks_per_rank = m_dram->m_flat_bank_strides[0];
+        int rank_id = flat_bank_id / banks_per_rank;
+
+        AddrVec_t addr_vec(m_dram->m_levels.size(), -1);
+        addr_vec[0] = m_ctrl->m_channel_id;
+        addr_vec[m_dram->m_flat_bank_first_level] = rank_id;
+        Request rfm(addr_vec, m_rfm_req_id);
         if (!m_ctrl->priority_send(rfm)) {
-            std::cout << "[Ramulator::RFMManager] [CRITICAL ERROR] Could not send request: rfm" << std::endl; 
-            exit(0);
+            // Retried in the next cycles
+            return;
         }
         s_rfm_counter++;
+
+        for (int bank = rank_id * banks_per_rank; bank < (rank_id + 1) * banks_per_rank; bank++) {
+            if (m_bank_ctrs[bank] >= m_rfm_thresh) {
+                m_rfm_ready_banks[bank / 64] &= ~(uint64_t(1) << (bank % 64));
+                m_num_rfm_ready_banks--;
+            }
+            m_bank_ctrs[bank] = 0;
+        }
     }
 };
 
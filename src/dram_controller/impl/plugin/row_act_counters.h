@@ -0,0 +1,163 @@
+#ifndef     RAMULATOR_CONTROLLER_PLUGIN_ROW_ACT_COUNTERS_H
+#define     RAMULATOR_CONTROLLER_PLUGIN_ROW_ACT_COUNTERS_H
+
+#include <bit>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+
+#include "base/exception.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Dense per-row activation and disturbance counters of every bank of a channel, for OracleRH
+ * @details
+ * Every row of every bank has a 16-bit activation count (as an aggressor) and a 16-bit disturbance count (as a victim:
+ * the activations of the rows within the blast radius), in one flat array. A reset of the counters of a bank (e.g.,
+ * at a refresh) only advances the epoch of the bank: a row whose epoch tag is older counts from 0, so resets cost
+ * nothing however many rows the bank has. The tags are only rewritten when the 16-bit epoch wraps around.
+ *
+ * The disturbance of an activation is added to the contiguous rows on both sides of the aggressor. The victims that
+ * reach the victim threshold in an epoch are marked in a bitmask per bank, which take_crossings() scans a word at a
+ * time.
+ *
+ */
+class RowACTCounters {
+  public:
+    using Count_t = uint16_t;
+    static constexpr int MAX_COUNT = std::numeric_limits<Count_t>::max();
+
+  private:
+    struct Row {
+      uint16_t epoch;
+      Count_t acts;
+      Count_t disturbance;
+    };
+
+    int m_num_rows = 0;
+    int m_blast_radius = 0;
+    int m_victim_threshold = MAX_COUNT;
+    std::vector<Row> m_rows;                    // [bank * num_rows + row]
+    std::vector<uint16_t> m_epochs;             // Per bank
+    std::vector<uint64_t> m_crossed;            // Victims that reached the threshold this epoch, a bit per row
+    std::vector<int> m_num_crossed;             // Per bank, the bits set in m_crossed
+    int m_words_per_bank = 0;
+
+  public:
+    RowACTCounters() = default;
+    RowACTCounters(int num_banks, int num_rows, int blast_radius, int victim_threshold):
+    m_num_rows(num_rows), m_blast_radius(blast_radius), m_victim_threshold(victim_threshold),
+    m_rows(size_t(num_banks) * num_rows, Row{0, 0, 0}), m_epochs(num_banks, 1), m_num_crossed(num_banks, 0) {
+      if (blast_radius < 0 || victim_threshold <= 0 || victim_threshold > MAX_COUNT) {
+        throw ConfigurationError("The victim threshold must be within [1, {}] and the blast radius not negative!", MAX_COUNT);
+      }
+      if (blast_radius > 0) {
+        m_words_per_bank = (num_rows + 63) / 64;
+        m_crossed.resize(size_t(num_banks) * m_words_per_bank, 0);
+      }
+    };
+
+    bool tracks_victims() const { return m_blast_radius > 0; };
+
+    /**
+     * @brief    Counts an activation of row. Returns the activation count of the row in this epoch, 1 for its first
+     *           one.
+     *
+     */
+    int activate(int bank, int row) {
+      Row& r = fresh(bank, row);
+      if (r.acts < MAX_COUNT) {
+        r.acts++;
+      }
+      if (m_blast_radius > 0) {
+        disturb(bank, std::max(0, row - m_blast_radius), row);
+        disturb(bank, row + 1, std::min(m_num_rows, row + 1 + m_blast_radius));
+      }
+      return r.acts;
+    };
+
+    void reset_acts(int bank, int row) { fresh(bank, row).acts = 0; };
+
+    /// Clears the disturbance of the victims within the blast radius of row (e.g., refreshed by a VRR)
+    void refresh_victims(int bank, int row) {
+      int first = std::max(0, row - m_blast_radius);
+      int last = std::min(m_num_rows, row + 1 + m_blast_radius);
+      for (int victim = first; victim < last; victim++) {
+        fresh(bank, victim).disturbance = 0;
+      }
+    };
+
+    int disturbance(int bank, int row) const {
+      const Row& r = m_rows[index(bank, row)];
+      return r.epoch == m_epochs[bank] ? r.disturbance : 0;
+    };
+
+    /// Starts a new epoch of the bank: all its counters read 0
+    void reset(int bank) {
+      if (++m_epochs[bank] == 0) {
+        std::fill_n(m_rows.begin() + index(bank, 0), m_num_rows, Row{0, 0, 0});
+        m_epochs[bank] = 1;
+      }
+    };
+
+    /**
+     * @brief    Calls func(row) for each victim of the bank that reached the victim threshold since the last call, and
+     *           clears them. Only scans the bitmask of a bank with crossings.
+     *
+     */
+    template<typename Func>
+    void take_crossings(int bank, Func&& func) {
+      if (m_num_crossed.empty() || m_num_crossed[bank] == 0) {
+        return;
+      }
+      uint64_t* words = m_crossed.data() + size_t(bank) * m_words_per_bank;
+      for (int w = 0; w < m_words_per_bank && m_num_crossed[bank] > 0; w++) {
+        while (words[w]) {
+          func(w * 64 + std::countr_zero(words[w]));
+          words[w] &= words[w] - 1;
+          m_num_crossed[bank]--;
+        }
+      }
+    };
+
+    size_t footprint_bytes() const {
+      return m_rows.size() * sizeof(Row) + m_crossed.size() * sizeof(uint64_t);
+    };
+
+  private:
+    size_t index(int bank, int row) const { return size_t(bank) * m_num_rows + row; };
+
+    /// The counters of row, reset first if they are from an older epoch
+    Row& fresh(int bank, int row) {
+      Row& r = m_rows[index(bank, row)];
+      if (r.epoch != m_epochs[bank]) {
+        r = Row{m_epochs[bank], 0, 0};
+      }
+      return r;
+    };
+
+    /// Adds one activation of disturbance to the victims [first, last) of the bank
+    void disturb(int bank, int first, int last) {
+      Row* rows = m_rows.data() + index(bank, 0);
+      uint16_t epoch = m_epochs[bank];
+      for (int victim = first; victim < last; victim++) {
+        Row& r = rows[victim];
+        if (r.epoch != epoch) {
+          r = Row{epoch, 0, 0};
+        }
+        if (r.disturbance < MAX_COUNT && ++r.disturbance == m_victim_threshold) {
+          uint64_t& word = m_crossed[size_t(bank) * m_words_per_bank + victim / 64];
+          uint64_t bit = uint64_t(1) << (victim % 64);
+          m_num_crossed[bank] += !(word & bit);
+          word |= bit;
+        }
+      }
+    };
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_CONTROLLER_PLUGIN_ROW_ACT_COUNTERS_H
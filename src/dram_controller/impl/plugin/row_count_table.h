@@ -0,0 +1,80 @@
+#ifndef     RAMULATOR_CONTROLLER_PLUGIN_ROW_COUNT_TABLE_H
+#define     RAMULATOR_CONTROLLER_PLUGIN_ROW_COUNT_TABLE_H
+
+#include <vector>
+
+#include "base/exception.h"
+#include "base/lazy_array.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    A fixed number of (row, count) entries of one bank, for the hot-row trackers of RRS and AQUA
+ * @details
+ * The entries in use are packed at the front, so a scan touches only them and erasing moves the last entry into the
+ * hole, without tombstones. A dense index from row to entry makes lookups one load; an index is only trusted if the
+ * entry it points to is in use and holds that row, so clearing the table just sets its size to 0, and the index starts
+ * zeroed and takes memory only for the rows seen (see LazyArray).
+ *
+ */
+class RowCountTable {
+  public:
+    struct Entry {
+      int row;
+      int count;
+    };
+
+  private:
+    std::vector<Entry> m_entries;
+    LazyArray<int> m_entry_of;      // Per row
+    int m_size = 0;
+
+  public:
+    RowCountTable(int num_entries, int num_rows): m_entries(num_entries), m_entry_of(num_rows) {
+      if (num_entries <= 0) {
+        throw ConfigurationError("A row count table needs at least one entry, got {}!", num_entries);
+      }
+    };
+
+    int size() const { return m_size; };
+    bool is_full() const { return m_size == (int) m_entries.size(); };
+    Entry& entry(int idx) { return m_entries[idx]; };
+    const Entry* begin() const { return m_entries.data(); };
+    const Entry* end() const { return m_entries.data() + m_size; };
+
+    /**
+     * @brief    Returns the entry holding row, or -1.
+     *
+     */
+    int find(int row) const {
+      int idx = m_entry_of[row];
+      return (idx < m_size && m_entries[idx].row == row) ? idx : -1;
+    };
+    bool contains(int row) const { return find(row) != -1; };
+
+    /**
+     * @brief    Adds row, which must not be in the table, with count. The table must not be full.
+     *
+     */
+    int insert(int row, int count) {
+      m_entries[m_size] = {row, count};
+      m_entry_of[row] = m_size;
+      return m_size++;
+    };
+
+    void erase(int idx) {
+      m_entries[idx] = m_entries[--m_size];
+      m_entry_of[m_entries[idx].row] = idx;
+    };
+
+    void clear() { m_size = 0; };
+
+    size_t footprint_bytes() const {
+      return m_entries.size() * sizeof(Entry) + m_entry_of.size() * sizeof(int);
+    };
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_CONTROLLER_PLUGIN_ROW_COUNT_TABLE_H
@@ -1,11 +1,11 @@
 #include <vector>
-#include <unordered_map>
 #include <limits>
 #include <random>
 
 #include "base/base.h"
 #include "dram_controller/controller.h"
 #include "dram_controller/plugin.h"
+#include "dram_controller/impl/plugin/row_count_table.h"
 #include "addr_mapper/impl/rit.h"
 
 namespace Ramulator {
@@ -43,19 +43,20 @@ class RRS : public IControllerPlugin, public Implementation {
     // indexed using flattened <rank id, bank id>
     // e.g., if rank 0, bank 4, index is 4
     // if rank 1, bank 5, index is 16 (assuming 16 banks/rank) + 5
-    std::vector<std::unordered_map<int, int>> m_hot_row_tracker;
+    std::vector<RowCountTable> m_hot_row_tracker;
     // spillover counter per bank
     std::vector<int> m_spillover_counter;
     // per bank row indirection table is implemented in 'src/addr_mapper/impl/linear_mappers_with_rit.cpp'
     
     // rng
-    std::mt19937 generator;
+    RandomStream generator;
     std::uniform_int_distribution<int> distribution;
 
     // statistics
     int s_num_swaps = 0;
     int s_num_unswaps = 0;
     int s_num_reswaps = 0;
+    size_t s_hrt_bytes = 0;
 
   public:
     void init() override { 
@@ -90,8 +91,8 @@ class RRS : public IControllerPlugin, public Implementation {
 
       // Initialize hot-row tracker
       for (int i = 0; i < m_num_banks_per_rank * m_num_ranks; i++) {
-        std::unordered_map<int, int> table;
-        m_hot_row_tracker.push_back(table);
+        m_hot_row_tracker.emplace_back(m_num_hrt_entries, m_num_rows_per_bank);
+        s_hrt_bytes += m_hot_row_tracker.back().footprint_bytes();
       }
       // Initialize spillover counter
       m_spillover_counter = std::vector<int>(m_num_banks_per_rank * m_num_ranks, 0);
@@ -99,15 +100,16 @@ class RRS : public IControllerPlugin, public Implementation {
       m_addr_mapper->init_rit(m_num_banks_per_rank * m_num_ranks, m_num_rit_entries);
       
       // setup random number generator
-      generator = std::mt19937(1337);
-      distribution = std::uniform_int_distribution<int>(0, m_num_rows_per_bank);
+      generator = random_stream(1337);
+      distribution = std::uniform_int_distribution<int>(0, m_num_rows_per_bank - 1);
 
       // Register statistics
       register_stat(s_num_swaps).name("rss_num_swaps");
       register_stat(s_num_unswaps).name("rss_num_unswaps");
       register_stat(s_num_reswaps).name("rss_num_reswaps");
+      register_stat(s_hrt_bytes).name("rss_hrt_bytes");
 
-      if (m_is_debug) {
+      RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
         std::cout << "RRS is implemented." << std::endl
                   << "Number of HRT entries: " << m_num_hrt_entries << std::endl
                   << "Number of RIT entries: " << m_num_rit_entries << std::endl
@@ -118,18 +120,22 @@ class RRS : public IControllerPlugin, public Implementation {
       }
     };
 
+    // The HRT (the RIT is the address mapper's)
+    size_t memory_footprint() const override { return s_hrt_bytes; };
+
     void update(bool request_found, ReqBuffer::iterator& req_it) override {
       // Tick myself
-      m_clk++;
+      bool is_new = is_new_cycle(request_found);
+      m_clk += is_new;
 
-      if (m_clk % m_reset_period_clk == 0) {
+      if (is_new && m_clk % m_reset_period_clk == 0) {
         // Reset hrt and unlock rit
         for (int i = 0; i < m_num_banks_per_rank * m_num_ranks; i++) {
           m_hot_row_tracker[i].clear();
           m_spillover_counter[i] = 0;
           m_addr_mapper->rit_unlock();
         }
-        if (m_is_debug) {
+        RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
           std::cout << "----------------------------" << std::endl;
           std::cout << "RRS is resetting. " << m_clk << std::endl;
           for (int b = 0; b < m_num_banks_per_rank * m_num_ranks; b++)
@@ -138,69 +144,60 @@ class RRS : public IControllerPlugin, public Implementation {
       }
 
       if (request_found) {
-        if (m_dram->m_command_meta(req_it->command).is_opening && m_dram->m_command_scopes(req_it->command) == m_row_level) {
-          int flat_bank_id = req_it->addr_vec[m_bank_level];
-          int accumulated_dimension = 1;
-          for (int i = m_bank_level - 1; i >= m_rank_level; i--) {
-            accumulated_dimension *= m_dram->m_organization.count[i + 1];
-            flat_bank_id += req_it->addr_vec[i] * accumulated_dimension;
-          }
+        if (m_ctrl->m_command_event.is_activation) {
+          int flat_bank_id = m_ctrl->m_command_event.flat_bank;
           
-          int row_id = req_it->addr_vec[m_row_level];
+          int row_id = m_ctrl->m_command_event.row;
 
-          if (m_is_debug) {
+          RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
             std::cout << "----------------------------" << std::endl;
             std::cout << "RRS: ACT on row " << row_id << "         " << m_clk << std::endl;
             std::cout << "  └  " << "bank: " << flat_bank_id << std::endl;
           }
 
+          RowCountTable& hrt = m_hot_row_tracker[flat_bank_id];
           // Check HRT
-          if (m_hot_row_tracker[flat_bank_id].find(row_id) == m_hot_row_tracker[flat_bank_id].end()) {
-            if (m_is_debug) {
+          int hrt_entry = hrt.find(row_id);
+          if (hrt_entry == -1) {
+            RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
               std::cout << "  └  " << "row " << row_id << " not in HRT." << std::endl;
             }
             // if row is not in the table, check if the table is full 
-            if (m_hot_row_tracker[flat_bank_id].size() < m_num_hrt_entries) {
-              if (m_is_debug) {
+            if (!hrt.is_full()) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "  └  " << "HRT is not full, inserting with count 1." << std::endl;
               }
               // if table is not full, insert the row
-              m_hot_row_tracker[flat_bank_id][row_id] = 1;
+              hrt_entry = hrt.insert(row_id, 1);
             } else {
-              if (m_is_debug) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "  └  " << "HRT is full, searching for a row to evict." << std::endl;
               }
               // if table is full, find a row to evict
-              bool found = false;
               int to_remove = -1;
-              int spillover_value = -1;
-
-              for (auto it = m_hot_row_tracker[flat_bank_id].begin(); it != m_hot_row_tracker[flat_bank_id].end(); it++) {
+              for (int i = 0; i < hrt.size(); i++) {
                 // if we find an entry with spillover counter value, evict it
-                if (it->second == m_spillover_counter[flat_bank_id]) {
-                  if (m_is_debug) {
-                    std::cout << "  └  " << "found a row to evict: " << it->first << std::endl;
+                if (hrt.entry(i).count == m_spillover_counter[flat_bank_id]) {
+                  RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
+                    std::cout << "  └  " << "found a row to evict: " << hrt.entry(i).row << std::endl;
                   }
-                  // if we find an entry, record it
-                  spillover_value = it->second;
-                  to_remove = it->first;
-                  found = true;
+                  to_remove = i;
                   break;
                 }
               }
 
-              if (found) {
-                if (m_is_debug) {
-                  std::cout << "Removing row " << to_remove << " from HRT." << std::endl;
+              if (to_remove != -1) {
+                RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
+                  std::cout << "Removing row " << hrt.entry(to_remove).row << " from HRT." << std::endl;
                   std::cout << "Adding row " << row_id << " to HRT." << std::endl;
                 }
-                // remove to_remove from the table
-                m_hot_row_tracker[flat_bank_id].erase(to_remove);
-                // add row_id to the table
-                m_hot_row_tracker[flat_bank_id][row_id] = spillover_value + 1;
+                // replace to_remove with row_id in the table
+                int spillover_value = hrt.entry(to_remove).count;
+                hrt.erase(to_remove);
+                hrt_entry = hrt.insert(row_id, spillover_value + 1);
               }
               else {
-                if (m_is_debug) {
+                RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                   std::cout << "  └  " << "no row to evict, incrementing spillover counter." << std::endl;
                 }
                 m_spillover_counter[flat_bank_id] += 1;
@@ -208,31 +205,31 @@ class RRS : public IControllerPlugin, public Implementation {
               }
             }
           } else {
-            if (m_is_debug) { 
+            RAMULATOR_TRACE_IF(Plugin, m_is_debug) { 
               std::cout << "  └  " << "row " << row_id << " in HRT. Incrementing its counter." << std::endl;
             }
             // if row in table, increment its activation count
-            m_hot_row_tracker[flat_bank_id][row_id] += 1;
+            hrt.entry(hrt_entry).count += 1;
           }
           // dump HRT for debug
-          if (m_is_debug) {
+          RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
             std::cout << "==========================" << std::endl;
-            std::cout << "HRT[" << flat_bank_id << "].size(): " << m_hot_row_tracker[flat_bank_id].size() << std::endl;
-            for (auto entry: m_hot_row_tracker[flat_bank_id]) {
-              std::cout << entry.first << ":\t" << entry.second << std::endl; 
+            std::cout << "HRT[" << flat_bank_id << "].size(): " << hrt.size() << std::endl;
+            for (const auto& entry: hrt) {
+              std::cout << entry.row << ":\t" << entry.count << std::endl; 
             }
             std::cout << "Spillover counter: " << m_spillover_counter[flat_bank_id] << std::endl;
             std::cout << "==========================" << std::endl;
           }
 
           // row is now in the table, check if the count exceeds the threshold
-          if (m_is_debug) {
+          RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
             std::cout << "Row " << row_id << " in HRT" << std::endl;
             std::cout << "  └  " << "threshold: " << m_rss_threshold << std::endl;
-            std::cout << "  └  " << "count: " << m_hot_row_tracker[flat_bank_id][row_id] << std::endl;
+            std::cout << "  └  " << "count: " << hrt.entry(hrt_entry).count << std::endl;
           }
-          if (m_hot_row_tracker[flat_bank_id][row_id] % m_rss_threshold == 0) {
-            if (m_is_debug) {
+          if (hrt.entry(hrt_entry).count % m_rss_threshold == 0) {
+            RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
               std::cout << "Row " << row_id << " needs swapping!" << std::endl;
             }
             // issue swap
@@ -242,15 +239,15 @@ class RRS : public IControllerPlugin, public Implementation {
             if (prev_swapped_row != -1) {
               if (m_addr_mapper->is_rit_locked(flat_bank_id, row_id)) {
                 // we need to swap both of the rows.
-                if (m_is_debug) {
+                RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                   std::cout << "Row " << row_id << " is already swapped with row " << prev_swapped_row << " in the current epoch." << std::endl;
                   std::cout << "We need to swap both rows." << std::endl;
                 }
                 // check if rit has empty slots
                 if (m_addr_mapper->is_rit_full(flat_bank_id)) {
                   // if rit is full, get a pair to unswap
-                  auto unswap_pair = m_addr_mapper->get_unswap_pair(flat_bank_id, m_hot_row_tracker[flat_bank_id]);
-                  if (m_is_debug) {
+                  auto unswap_pair = m_addr_mapper->get_unswap_pair(flat_bank_id, [&hrt](int row) { return hrt.contains(row); });
+                  RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                     std::cout << "RIT is full." << std::endl;
                     std::cout << "Unswapping row " << unswap_pair.first << " with row " << unswap_pair.second << std::endl;
                   }
@@ -264,7 +261,7 @@ class RRS : public IControllerPlugin, public Implementation {
                 // get 2 new rows 
                 int dst_row0 = get_rand_row(flat_bank_id, row_id);
                 int dst_row1 = get_rand_row(flat_bank_id, row_id);
-                if (m_is_debug) {
+                RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                   std::cout << "Swapping row " << row_id << " with row " << dst_row0 << std::endl;
                   std::cout << "Swapping row " << prev_swapped_row << " with row " << dst_row1 << std::endl;
                 }
@@ -286,7 +283,7 @@ class RRS : public IControllerPlugin, public Implementation {
                 // find a row to swap with
                 int dst_row = get_rand_row(flat_bank_id, row_id);
                 
-                if (m_is_debug) {
+                RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                   std::cout << "Row " << row_id << " is already swapped with row " << prev_swapped_row << " in the previous epochs." << std::endl;
                   std::cout << "We need to unswap and reswap the row." << std::endl;
                   std::cout << "Unswapping row " << row_id << " with row " << prev_swapped_row << std::endl;
@@ -312,8 +309,8 @@ class RRS : public IControllerPlugin, public Implementation {
               // check if rit has empty slots
               if (m_addr_mapper->is_rit_full(flat_bank_id)) {
                 // if rit is full, get a pair to unswap
-                auto unswap_pair = m_addr_mapper->get_unswap_pair(flat_bank_id, m_hot_row_tracker[flat_bank_id]);
-                if (m_is_debug) {
+                auto unswap_pair = m_addr_mapper->get_unswap_pair(flat_bank_id, [&hrt](int row) { return hrt.contains(row); });
+                RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                   std::cout << "RIT is full." << std::endl;
                   std::cout << "Unswapping row " << unswap_pair.first << " with row " << unswap_pair.second << std::endl;
                 }
@@ -327,7 +324,7 @@ class RRS : public IControllerPlugin, public Implementation {
 
               // find a row to swap with
               int dst_row = get_rand_row(flat_bank_id, row_id);
-              if (m_is_debug) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "Swapping row " << row_id << " with row " << dst_row << std::endl;
               }
               // swap the pair
@@ -338,7 +335,7 @@ class RRS : public IControllerPlugin, public Implementation {
               s_num_swaps++;
             }
 
-            if (m_is_debug) {
+            RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
               m_addr_mapper->dump_rit(flat_bank_id);
             }
           }
@@ -352,7 +349,7 @@ class RRS : public IControllerPlugin, public Implementation {
       while (dst_row == -1) {
         int rand_row = distribution(generator);
         // check if rand row is in hrt or is in rit or is not row_id 
-        if (m_hot_row_tracker[bank_id].find(rand_row) == m_hot_row_tracker[bank_id].end() 
+        if (!m_hot_row_tracker[bank_id].contains(rand_row)
             && m_addr_mapper->check_rit(bank_id, rand_row) == -1
             && rand_row != row_id) {
           dst_row = rand_row;
@@ -363,7 +360,7 @@ class RRS : public IControllerPlugin, public Implementation {
 
     void issue_swap(ReqBuffer::iterator& req_it, int src_row, int dst_row) {
       // load addr_vec
-      std::vector<int> addr_vec;
+      AddrVec_t addr_vec;
       for (int i = 0; i < req_it->addr_vec.size(); i++){
         addr_vec.push_back(req_it->addr_vec[i]);
       }
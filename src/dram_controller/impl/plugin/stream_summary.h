@@ -0,0 +1,222 @@
+#ifndef     RAMULATOR_CONTROLLER_PLUGIN_STREAM_SUMMARY_H
+#define     RAMULATOR_CONTROLLER_PLUGIN_STREAM_SUMMARY_H
+
+#include <vector>
+
+#include "base/exception.h"
+#include "base/lazy_array.h"
+#include "base/memory_report.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    A fixed number of (key, count) entries kept in count order, for space-saving/Misra-Gries trackers
+ * @details
+ * The entries with the same count are listed in a bucket, and the buckets are linked in ascending count order, so an
+ * increment moves an entry to the next bucket and the entries with the minimum and maximum count are at the ends, all
+ * in constant time. Keys are small integers (e.g., rows) with a dense index from key to entry, only trusted if that
+ * entry holds the key, so the index starts zeroed and takes memory only for the keys seen (see LazyArray). A reset sets
+ * every count to 0 but keeps the keys, also in constant time: the entries are ordered so that those written since the
+ * last reset come first, and every other entry counts 0 without being in any bucket.
+ *
+ */
+class StreamSummary {
+  private:
+    struct Entry {
+      int key = -1;             // -1 for an empty entry
+      int bucket = -1;
+      int prev = -1;            // In the bucket
+      int next = -1;
+    };
+
+    struct Bucket {
+      int count;
+      int first;                // Entry
+      int prev;
+      int next;
+    };
+
+    std::vector<Entry> m_entries;
+    LazyArray<int> m_entry_of;      // Per key, the entry holding it if that entry's key matches (0 until written)
+    std::vector<int> m_order;       // The entries written since the reset, then the others
+    std::vector<int> m_pos;         // Per entry, its position in m_order
+    int m_num_written = 0;
+
+    std::vector<Bucket> m_buckets;
+    std::vector<int> m_free_buckets;
+    int m_num_buckets = 0;          // Buckets handed out since the reset
+    int m_head = -1;                // The bucket of the smallest count
+    int m_tail = -1;
+
+  public:
+    StreamSummary(int num_entries, int num_keys):
+    m_entries(num_entries), m_entry_of(num_keys), m_order(num_entries), m_pos(num_entries), m_buckets(num_entries) {
+      if (num_entries <= 0) {
+        throw ConfigurationError("A stream summary needs at least one entry, got {}!", num_entries);
+      }
+      for (int i = 0; i < num_entries; i++) {
+        m_order[i] = i;
+        m_pos[i] = i;
+      }
+    };
+
+    int size() const { return m_entries.size(); };
+
+    size_t footprint_bytes() const {
+      return heap_bytes(m_entries) + heap_bytes(m_entry_of) + heap_bytes(m_order) + heap_bytes(m_pos) + heap_bytes(m_buckets) + heap_bytes(m_free_buckets);
+    };
+    int key(int entry) const { return m_entries[entry].key; };
+    int count(int entry) const { return is_written(entry) ? m_buckets[m_entries[entry].bucket].count : 0; };
+
+    /**
+     * @brief    Returns the entry holding key, or -1.
+     *
+     */
+    int find(int key) const {
+      int entry = m_entry_of[key];
+      return m_entries[entry].key == key ? entry : -1;
+    };
+
+    /**
+     * @brief    Returns an entry with the smallest count.
+     *
+     */
+    int min_entry() const {
+      if (m_num_written < size()) {
+        return m_order[m_num_written];
+      }
+      return m_buckets[m_head].first;
+    };
+
+    /**
+     * @brief    Returns an entry with the largest count.
+     *
+     */
+    int max_entry() const {
+      if (m_tail == -1) {
+        return m_order[m_num_written];
+      }
+      return m_buckets[m_tail].first;
+    };
+
+    /**
+     * @brief    Makes entry hold key (-1 to empty it), keeping its count.
+     *
+     */
+    void set_key(int entry, int key) {
+      m_entries[entry].key = key;
+      if (key != -1) {
+        m_entry_of[key] = entry;
+      }
+    };
+
+    void increment(int entry) {
+      int count, after;
+      if (is_written(entry)) {
+        int bucket = m_entries[entry].bucket;
+        count = m_buckets[bucket].count + 1;
+        after = unlink(entry) ? m_buckets[bucket].prev : bucket;
+      } else {
+        mark_written(entry);
+        count = 1;
+        after = (m_head != -1 && m_buckets[m_head].count == 0) ? m_head : -1;
+      }
+      link(entry, count, after);
+    };
+
+    /**
+     * @brief    Sets the count of entry. Takes constant time when count is at most the smallest count of the other
+     *           entries, and otherwise walks the buckets from the smallest count.
+     *
+     */
+    void set_count(int entry, int count) {
+      if (is_written(entry)) {
+        unlink(entry);
+      } else {
+        mark_written(entry);
+      }
+      int after = -1;
+      for (int bucket = m_head; bucket != -1 && m_buckets[bucket].count < count; bucket = m_buckets[bucket].next) {
+        after = bucket;
+      }
+      link(entry, count, after);
+    };
+
+    /**
+     * @brief    Sets every count to 0, keeping the keys.
+     *
+     */
+    void reset() {
+      m_num_written = 0;
+      m_num_buckets = 0;
+      m_free_buckets.clear();
+      m_head = -1;
+      m_tail = -1;
+    };
+
+  private:
+    bool is_written(int entry) const { return m_pos[entry] < m_num_written; };
+
+    void mark_written(int entry) {
+      int other = m_order[m_num_written];
+      std::swap(m_order[m_pos[entry]], m_order[m_num_written]);
+      std::swap(m_pos[entry], m_pos[other]);
+      m_num_written++;
+    };
+
+    // Links entry into the bucket of count, which follows the bucket after (or is the head if after is -1)
+    void link(int entry, int count, int after) {
+      int next = (after == -1) ? m_head : m_buckets[after].next;
+      int bucket = next;
+      if (next == -1 || m_buckets[next].count != count) {
+        bucket = new_bucket(count);
+        m_buckets[bucket].prev = after;
+        m_buckets[bucket].next = next;
+        (after == -1 ? m_head : m_buckets[after].next) = bucket;
+        (next == -1 ? m_tail : m_buckets[next].prev) = bucket;
+      }
+
+      Entry& e = m_entries[entry];
+      e.bucket = bucket;
+      e.prev = -1;
+      e.next = m_buckets[bucket].first;
+      if (e.next != -1) {
+        m_entries[e.next].prev = entry;
+      }
+      m_buckets[bucket].first = entry;
+    };
+
+    // Unlinks entry from its bucket, and returns whether that emptied (and freed) the bucket
+    bool unlink(int entry) {
+      Entry& e = m_entries[entry];
+      Bucket& b = m_buckets[e.bucket];
+      (e.prev == -1 ? b.first : m_entries[e.prev].next) = e.next;
+      if (e.next != -1) {
+        m_entries[e.next].prev = e.prev;
+      }
+      if (b.first != -1) {
+        return false;
+      }
+      (b.prev == -1 ? m_head : m_buckets[b.prev].next) = b.next;
+      (b.next == -1 ? m_tail : m_buckets[b.next].prev) = b.prev;
+      m_free_buckets.push_back(e.bucket);
+      return true;
+    };
+
+    int new_bucket(int count) {
+      int bucket;
+      if (!m_free_buckets.empty()) {
+        bucket = m_free_buckets.back();
+        m_free_buckets.pop_back();
+      } else {
+        bucket = m_num_buckets++;
+      }
+      m_buckets[bucket] = {count, -1, -1, -1};
+      return bucket;
+    };
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_CONTROLLER_PLUGIN_STREAM_SUMMARY_H
@@ -0,0 +1,315 @@
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include "base/base.h"
+#include "dram_controller/controller.h"
+#include "dram_controller/plugin.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Checks every issued command against the timing constraints and the row states of the DRAM standard
+ * @details
+ * The device tracks timing forward: a command raises the ready cycles of the commands it constrains. This checker
+ * works backward from the same m_timing_cons instead, so it does not share the device's timing code: it keeps the
+ * recent issue cycles of each command at each node and, when a command is issued, looks up the constraints that end at
+ * it (indexed by the following command) and compares against the histories of their preceding commands. Constraints on
+ * siblings only need the last issue to any other child of the parent, which is kept as the two latest (cycle, child)
+ * pairs per parent. Independently, it tracks the open row of each bank and flags ACTs to open banks, accesses to a
+ * closed bank or another row, and refreshes of banks with an open row.
+ *
+ */
+class TimingChecker : public IControllerPlugin, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IControllerPlugin, TimingChecker, "TimingChecker", "Checks the issued commands against the DRAM timing constraints and row states.")
+
+  private:
+    IDRAM* m_dram = nullptr;
+
+    struct Constraint {
+      int preceding;
+      int val;
+      int window;
+      bool sibling;
+    };
+
+    // Two latest issues of a command to the children of one parent, from different children
+    struct LastIssues {
+      Clk_t clk = -1;
+      int child = -1;
+      Clk_t other_clk = -1;     // The latest issue to any child but child
+    };
+
+    int m_num_levels = 0;                             // Node levels, as in the device (channel to the level above rows)
+    int m_num_cmds = 0;
+    std::vector<int> m_fanouts;                       // Per level, the children of each node of the level above
+    std::vector<std::vector<Constraint>> m_constraints;   // [level * m_num_cmds + following command]
+
+    std::vector<int> m_history_windows;               // [level * m_num_cmds + cmd], issues kept per node (0 = none)
+    std::vector<std::vector<Clk_t>> m_histories;      // [level * m_num_cmds + cmd][node * window + i], i = 0 is the latest
+    std::vector<bool> m_tracks_siblings;              // [level * m_num_cmds + cmd]
+    std::vector<std::vector<LastIssues>> m_last_issues;   // [level * m_num_cmds + cmd][parent node]
+
+    bool m_check_rows = true;
+    int m_bank_level = -1;
+    int m_row_level = -1;
+    static constexpr int ROW_CLOSED = -1;
+    static constexpr int ROW_UNKNOWN = -2;
+    std::vector<int> m_open_rows;                     // Per bank node
+
+    // Scratch: the target nodes of each level, and the banks whose row state a command changes
+    std::vector<std::vector<int>> m_targets;
+    std::vector<int> m_banks;
+    std::vector<int> m_next_banks;
+
+    int m_max_reports = 10;
+    bool m_fail_on_violation = false;
+
+    size_t s_checked_commands = 0;
+    size_t s_timing_violations = 0;
+    size_t s_protocol_violations = 0;
+
+  public:
+    void init() override {
+      m_check_rows = param<bool>("check_row_states").desc("Also check that ACTs go to closed banks, accesses to the open row and refreshes to closed banks").default_val(true);
+      m_max_reports = param<int>("max_reports").desc("Violations to report in detail (the others are only counted)").default_val(10);
+      m_fail_on_violation = param<bool>("fail_on_violation").desc("Stop the simulation at the first violation").default_val(false);
+
+      m_logger = Logging::create_logger("TimingChecker");
+    };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      m_ctrl = cast_parent<IDRAMController>();
+      m_dram = m_ctrl->m_dram;
+      m_num_cmds = m_dram->m_commands.size();
+      m_row_level = m_dram->m_levels("row");
+      m_bank_level = m_dram->m_levels("bank");
+
+      // The device keeps nodes down to the level above the rows, or to the first level without a size
+      const auto& count = m_dram->m_organization.count;
+      m_num_levels = 1;
+      while (m_num_levels < m_row_level && count[m_num_levels] > 0) {
+        m_num_levels++;
+      }
+      m_fanouts.assign(m_num_levels, 1);
+      std::vector<int> num_nodes(m_num_levels, 1);
+      for (int level = 1; level < m_num_levels; level++) {
+        m_fanouts[level] = count[level];
+        num_nodes[level] = num_nodes[level - 1] * count[level];
+      }
+
+      // Index the constraints by the command they constrain
+      m_constraints.assign(m_num_levels * m_num_cmds, {});
+      m_history_windows.assign(m_num_levels * m_num_cmds, 0);
+      m_tracks_siblings.assign(m_num_levels * m_num_cmds, false);
+      for (int level = 0; level < m_num_levels; level++) {
+        for (int preceding = 0; preceding < m_num_cmds; preceding++) {
+          for (const auto& t : m_dram->m_timing_cons[level][preceding]) {
+            if (t.sibling) {
+              // A channel has no siblings within its controller
+              if (level == 0) {
+                continue;
+              }
+              m_tracks_siblings[level * m_num_cmds + preceding] = true;
+            } else {
+              if (t.window <= 0) {
+                continue;
+              }
+              int& window = m_history_windows[level * m_num_cmds + preceding];
+              window = std::max(window, t.window);
+            }
+            m_constraints[level * m_num_cmds + t.cmd].push_back({preceding, t.val, t.window, t.sibling});
+          }
+        }
+      }
+      m_histories.resize(m_num_levels * m_num_cmds);
+      m_last_issues.resize(m_num_levels * m_num_cmds);
+      for (int level = 0; level < m_num_levels; level++) {
+        for (int cmd = 0; cmd < m_num_cmds; cmd++) {
+          int idx = level * m_num_cmds + cmd;
+          m_histories[idx].assign(size_t(num_nodes[level]) * m_history_windows[idx], -1);
+          if (m_tracks_siblings[idx]) {
+            m_last_issues[idx].assign(num_nodes[level - 1], {});
+          }
+        }
+      }
+
+      // The checker may start from a restored checkpoint, so the rows are unknown until a command sets them
+      m_check_rows = m_check_rows && m_bank_level < m_num_levels;
+      if (m_check_rows) {
+        m_open_rows.assign(num_nodes[m_bank_level], ROW_UNKNOWN);
+      }
+      m_targets.resize(m_num_levels);
+
+      // Every command is checked, nothing happens on the other cycles
+      m_subscription.per_cycle = false;
+
+      register_stat(s_checked_commands).name("checked_commands");
+      register_stat(s_timing_violations).name("timing_violations");
+      register_stat(s_protocol_violations).name("protocol_violations");
+    };
+
+    void update(bool request_found, ReqBuffer::iterator& req_it) override {
+      if (!request_found) {
+        return;
+      }
+      const CommandEvent& event = m_ctrl->m_command_event;
+      int command = event.command;
+      const AddrVec_t& addr_vec = req_it->addr_vec;
+      Clk_t clk = event.clk;
+      s_checked_commands++;
+
+      // The nodes the command goes to, with wildcards expanded
+      m_targets[0].assign(1, 0);
+      for (int level = 1; level < m_num_levels; level++) {
+        m_targets[level].clear();
+        for (int parent : m_targets[level - 1]) {
+          int first = parent * m_fanouts[level];
+          if (addr_vec[level] == -1) {
+            for (int node = first; node < first + m_fanouts[level]; node++) {
+              m_targets[level].push_back(node);
+            }
+          } else {
+            m_targets[level].push_back(first + addr_vec[level]);
+          }
+        }
+      }
+
+      // The device only checks the levels down to the scope of the command
+      int last_checked_level = std::min(event.scope, m_num_levels - 1);
+      for (int level = 0; level <= last_checked_level; level++) {
+        for (const Constraint& t : m_constraints[level * m_num_cmds + command]) {
+          int idx = level * m_num_cmds + t.preceding;
+          for (int node : m_targets[level]) {
+            Clk_t past;
+            if (t.sibling) {
+              const LastIssues& last = m_last_issues[idx][node / m_fanouts[level]];
+              past = (last.child != node % m_fanouts[level]) ? last.clk : last.other_clk;
+            } else {
+              past = m_histories[idx][size_t(node) * m_history_windows[idx] + t.window - 1];
+            }
+            if (past >= 0 && clk < past + t.val) {
+              report_timing(command, addr_vec, clk, level, t, past);
+            }
+          }
+        }
+      }
+
+      record(command, addr_vec, clk);
+      if (m_check_rows) {
+        check_rows(event, addr_vec);
+      }
+    };
+
+    Clk_t get_idle_cycles() override {
+      return std::numeric_limits<Clk_t>::max();
+    };
+
+    void finalize() override {
+      if (s_timing_violations + s_protocol_violations > 0) {
+        m_logger->warn("Channel {}: {} timing and {} row state violations in {} commands.",
+                       m_ctrl->m_channel_id, s_timing_violations, s_protocol_violations, s_checked_commands);
+      }
+    };
+
+  private:
+    void record(int command, const AddrVec_t& addr_vec, Clk_t clk) {
+      for (int level = 0; level < m_num_levels; level++) {
+        int idx = level * m_num_cmds + command;
+        if (int window = m_history_windows[idx]; window > 0) {
+          for (int node : m_targets[level]) {
+            Clk_t* history = m_histories[idx].data() + size_t(node) * window;
+            std::copy_backward(history, history + window - 1, history + window);
+            history[0] = clk;
+          }
+        }
+        // A wildcard makes all children targets, so there are no siblings
+        if (m_tracks_siblings[idx] && addr_vec[level] != -1) {
+          for (int parent : m_targets[level - 1]) {
+            LastIssues& last = m_last_issues[idx][parent];
+            if (last.child != addr_vec[level]) {
+              last.other_clk = last.clk;
+              last.child = addr_vec[level];
+            }
+            last.clk = clk;
+          }
+        }
+      }
+    };
+
+    void check_rows(const CommandEvent& event, const AddrVec_t& addr_vec) {
+      const DRAMCommandMeta& meta = m_dram->m_command_meta(event.command);
+      // The device changes the states of all the banks below the scope of a command (e.g., a PREA closes all the banks
+      // of its rank), whatever its address says below the scope
+      m_banks.assign(1, 0);
+      for (int level = 1; level <= m_bank_level; level++) {
+        m_next_banks.clear();
+        for (int parent : m_banks) {
+          int first = parent * m_fanouts[level];
+          if (level > event.scope || addr_vec[level] == -1) {
+            for (int node = first; node < first + m_fanouts[level]; node++) {
+              m_next_banks.push_back(node);
+            }
+          } else {
+            m_next_banks.push_back(first + addr_vec[level]);
+          }
+        }
+        m_banks.swap(m_next_banks);
+      }
+
+      for (int bank : m_banks) {
+        int& open_row = m_open_rows[bank];
+        if (event.is_activation) {
+          if (open_row >= 0) {
+            report_protocol(event.command, addr_vec, event.clk, fmt::format("bank has row {} open", open_row));
+          }
+          open_row = event.row;
+        } else if (meta.is_accessing) {
+          if (open_row == ROW_CLOSED || (open_row >= 0 && event.row >= 0 && open_row != event.row)) {
+            report_protocol(event.command, addr_vec, event.clk, open_row == ROW_CLOSED ? "bank is closed" : fmt::format("bank has row {} open", open_row));
+          }
+          if (meta.is_closing) {
+            open_row = ROW_CLOSED;
+          }
+        } else if (meta.is_closing) {
+          open_row = ROW_CLOSED;
+        } else if (meta.is_refreshing && event.scope < m_row_level) {
+          if (open_row >= 0) {
+            report_protocol(event.command, addr_vec, event.clk, fmt::format("bank has row {} open", open_row));
+          }
+        }
+      }
+    };
+
+    void report_timing(int command, const AddrVec_t& addr_vec, Clk_t clk, int level, const Constraint& t, Clk_t past) {
+      s_timing_violations++;
+      if (s_timing_violations + s_protocol_violations <= m_max_reports || m_fail_on_violation) {
+        std::string message = fmt::format(
+          "Channel {}: {} to [{}] at cycle {} violates {} -> {} of {} cycles{} at the {} level ({} issued at cycle {}, earliest {}).",
+          m_ctrl->m_channel_id, m_dram->m_commands(command), fmt::join(addr_vec, ", "), clk,
+          m_dram->m_commands(t.preceding), m_dram->m_commands(command), t.val,
+          t.sibling ? " on siblings" : (t.window > 1 ? fmt::format(" over {} issues", t.window) : ""),
+          m_dram->m_levels(level), m_dram->m_commands(t.preceding), past, past + t.val
+        );
+        fail_or_warn(message);
+      }
+    };
+
+    void report_protocol(int command, const AddrVec_t& addr_vec, Clk_t clk, const std::string& reason) {
+      s_protocol_violations++;
+      if (s_timing_violations + s_protocol_violations <= m_max_reports || m_fail_on_violation) {
+        std::string message = fmt::format("Channel {}: {} to [{}] at cycle {} while the {}.",
+                                          m_ctrl->m_channel_id, m_dram->m_commands(command), fmt::join(addr_vec, ", "), clk, reason);
+        fail_or_warn(message);
+      }
+    };
+
+    void fail_or_warn(const std::string& message) {
+      if (m_fail_on_violation) {
+        throw std::runtime_error(message);
+      }
+      m_logger->warn(message);
+    };
+};
+
+}       // namespace Ramulator
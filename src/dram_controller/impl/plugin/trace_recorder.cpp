@@ -1,5 +1,5 @@
 #include <vector>
-#include <unordered_map>
+#include <memory>
 #include <limits>
 #include <filesystem>
 
@@ -10,6 +10,7 @@
 #include "base/base.h"
 #include "dram_controller/controller.h"
 #include "dram_controller/plugin.h"
+#include "dram_controller/impl/plugin/command_trace_format.h"
 
 namespace Ramulator {
 
@@ -19,7 +20,9 @@ class TraceRecorder : public IControllerPlugin, public Implementation {
     IDRAM* m_dram;
 
     std::filesystem::path m_trace_path; 
+    bool m_is_binary = false;
     Logger_t m_tracer;
+    std::unique_ptr<CommandTrace::Writer> m_writer;
 
     Clk_t m_clk = 0;
 
@@ -31,22 +34,44 @@ class TraceRecorder : public IControllerPlugin, public Implementation {
       if (!(std::filesystem::exists(parent_path) && std::filesystem::is_directory(parent_path))) {
         throw ConfigurationError("Invalid path to trace file: {}", parent_path.string());
       }
+
+      std::string format = param<std::string>("format").desc("text (one line per command) or binary (fixed-width records, convert with ramulator_trace_convert)").default_val("text");
+      if (format != "text" && format != "binary") {
+        throw ConfigurationError("Unrecognized TraceRecorder format {}!", format);
+      }
+      m_is_binary = format == "binary";
     };
 
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
       m_ctrl = cast_parent<IDRAMController>();
       m_dram = m_ctrl->m_dram;
 
-      auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(fmt::format("{}.ch{}", m_trace_path.string(), m_ctrl->m_channel_id), true);
+      std::string path = fmt::format("{}.ch{}", m_trace_path.string(), m_ctrl->m_channel_id);
+      if (m_is_binary) {
+        std::vector<std::string> command_names;
+        for (int command = 0; command < m_dram->m_commands.size(); command++) {
+          command_names.push_back(std::string(m_dram->m_commands(command)));
+        }
+        m_writer = std::make_unique<CommandTrace::Writer>(path, m_dram->m_levels.size(), command_names);
+        return;
+      }
+
+      auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(path, true);
       m_tracer = std::make_shared<spdlog::logger>(fmt::format("trace_recorder_ch{}", m_ctrl->m_channel_id), sink);
       m_tracer->set_pattern("%v");
       m_tracer->set_level(spdlog::level::trace);      
     };
 
     void update(bool request_found, ReqBuffer::iterator& req_it) override {
-      m_clk++;
+      if (is_new_cycle(request_found)) {
+        m_clk++;
+      }
 
       if (request_found) {
+        if (m_writer) {
+          m_writer->record(m_clk, req_it->command, req_it->addr_vec);
+          return;
+        }
         m_tracer->trace(
           "{}, {}, {}", 
           m_clk,
@@ -57,6 +82,20 @@ class TraceRecorder : public IControllerPlugin, public Implementation {
 
     };
 
+    Clk_t get_idle_cycles() override {
+      return std::numeric_limits<Clk_t>::max();
+    };
+
+    void skip_cycles(Clk_t num_cycles) override {
+      m_clk += num_cycles;
+    };
+
+    void finalize() override {
+      if (m_writer) {
+        m_writer->close();
+      }
+    };
+
 };
 
 }       // namespace Ramulator
@@ -1,10 +1,10 @@
 #include <vector>
-#include <unordered_map>
 #include <limits>
 
 #include "base/base.h"
 #include "dram_controller/controller.h"
 #include "dram_controller/plugin.h"
+#include "dram_controller/impl/plugin/stream_summary.h"
 
 namespace Ramulator {
 
@@ -30,64 +30,35 @@ class CounterBasedTRR : public IControllerPlugin, public Implementation {
     int m_REF_id = -1;
 
     int m_size;
+    int m_num_rows = -1;
 
     struct BankTable {
-      int m_size;
-      std::unordered_map<int, int> m_counters;
+      // Rows and their activation counts, in count order
+      StreamSummary m_counters;
 
-      int m_max_act_row_addr = -1;
-      int m_max_act_count = 0;
-      int m_min_act_row_addr = -1;
-      int m_min_act_count = 0;
-
-      BankTable(int size): m_size(size) {};
+      BankTable(int size, int num_rows): m_counters(size, num_rows) {};
 
       void processACT(int row_addr) {
-        if (auto it = m_counters.find(row_addr); it != m_counters.end()) {
+        if (int entry = m_counters.find(row_addr); entry != -1) {
           // Row is already in the table
-          auto& [addr, count] = *it;
-          count++;
-
-          if (row_addr == m_min_act_row_addr) {
-            // See if we are still the smallest
-            for (auto& [_addr, _count] : m_counters) {
-              if (_count < count) {
-                m_min_act_count = _count;
-                m_min_act_row_addr = _addr;
-                break;
-              }
-            }
-          }
-
-          if (count > m_max_act_count) {
-            m_max_act_count = count;
-            m_max_act_row_addr = row_addr;
-          }
+          m_counters.increment(entry);
         } else {
-          // Row not in the table
-          if (m_counters.size() < m_size) {
+          int min_entry = m_counters.min_entry();
+          if (m_counters.key(min_entry) == -1) {
             // Still have space in the table
-            m_counters[row_addr] = 1;
-            m_min_act_count = 1;
-            m_min_act_row_addr = row_addr;
+            m_counters.set_key(min_entry, row_addr);
+            m_counters.increment(min_entry);
           } else {
             // Need to evict the smallest entry
-            auto min_entry = m_counters.extract(m_min_act_row_addr);
-            min_entry.key() = row_addr;
-            m_counters.insert(std::move(min_entry));
+            m_counters.set_key(min_entry, row_addr);
           }
         }
       }
 
       void processRFM() {
-        m_counters.erase(m_max_act_row_addr);
-        m_max_act_count = 0;
-        for (auto& [addr, count] : m_counters) {
-          if (count > m_max_act_count) {
-            m_max_act_row_addr = addr;
-            m_max_act_count = count;
-          }
-        }
+        int max_entry = m_counters.max_entry();
+        m_counters.set_key(max_entry, -1);
+        m_counters.set_count(max_entry, 0);
       };
     };
 
@@ -118,7 +89,9 @@ class CounterBasedTRR : public IControllerPlugin, public Implementation {
                     m_spec->organization.count[m_bank_level_idx] :
                     m_spec->organization.count[m_bankgroup_level_idx] * m_spec->organization.count[m_bank_level_idx];
 
-      m_bank_tables.resize(m_num_ranks, std::vector<BankTable>(m_num_banks, BankTable(m_size)));
+      m_num_rows = m_spec->organization.count[m_row_level_idx];
+
+      m_bank_tables.resize(m_num_ranks, std::vector<BankTable>(m_num_banks, BankTable(m_size, m_num_rows)));
       m_bank_counters.resize(m_num_ranks, std::vector<int>(m_num_banks, 0));
 
       m_ACT_id = m_spec->get_command_defs().get_id_of("ACT");
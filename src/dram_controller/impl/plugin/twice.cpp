@@ -2,8 +2,10 @@
 #include <unordered_map>
 #include <limits>
 #include <random>
+#include <cmath>
 
 #include "base/base.h"
+#include "base/timing_wheel.h"
 #include "dram_controller/controller.h"
 #include "dram_controller/plugin.h"
 
@@ -15,16 +17,27 @@ class TWiCeIdeal : public IControllerPlugin, public Implementation {
   private:
     IDRAM* m_dram = nullptr;
 
+    // The life of an entry is the number of rank-level refreshes since it was inserted (at refresh number born)
     struct TwiCeEntry {
       int act_count;
-      int life;
+      Clk_t born;
+      uint64_t id;              // Tells a reinserted row from its pruned or refreshed predecessor
       TwiCeEntry():
-        act_count(-1), life(-1) {};
-      TwiCeEntry(int a, int l):
-        act_count(a), life(l) {};
+        act_count(-1), born(-1), id(0) {};
+      TwiCeEntry(int a, Clk_t b, uint64_t i):
+        act_count(a), born(b), id(i) {};
+    };
+
+    // An entry to check at a refresh, where it may be pruned
+    struct PruneCheck {
+      int bank;
+      Addr_t row;
+      uint64_t id;
     };
 
     Clk_t m_clk = 0;
+    Clk_t m_num_refs = 0;
+    uint64_t m_next_id = 0;
 
     int m_twice_rh_threshold = -1;
     float m_twice_pruning_interval_threshold = -1;
@@ -45,6 +58,9 @@ class TWiCeIdeal : public IControllerPlugin, public Implementation {
     // e.g., if rank 0, bank 4, index is 4
     // if rank 1, bank 5, index is 16 (assuming 16 banks/rank) + 5
     std::vector<std::unordered_map<Addr_t, TwiCeEntry>> m_twice_table;
+    // The entries by the refresh number at which they are pruned unless they were activated enough since they were
+    // scheduled. A refresh only checks the entries due at it, and reschedules those activated enough.
+    TimingWheel<PruneCheck> m_prune_checks;
 
   public:
     void init() override { 
@@ -78,52 +94,50 @@ class TWiCeIdeal : public IControllerPlugin, public Implementation {
         std::unordered_map<Addr_t, TwiCeEntry> bank_twice_table;
         m_twice_table.push_back(bank_twice_table);
       }
+      // An entry lives at most about threshold / pruning interval threshold refreshes
+      Clk_t max_life = m_twice_pruning_interval_threshold > 0 ?
+                       Clk_t(std::ceil(m_twice_rh_threshold / m_twice_pruning_interval_threshold)) + 1 : 1;
+      m_prune_checks = TimingWheel<PruneCheck>(std::clamp<Clk_t>(max_life, 1, 4096));
     };
 
     void update(bool request_found, ReqBuffer::iterator& req_it) override {
 
-      m_clk++;
+      if (is_new_cycle(request_found)) {
+        m_clk++;
+      }
 
       if (request_found) {
-        if (m_dram->m_command_meta(req_it->command).is_refreshing && m_dram->m_command_scopes(req_it->command) == m_rank_level) {
+        if (m_ctrl->m_command_event.is_refreshing && m_ctrl->m_command_event.scope == m_rank_level) {
           // Refresh command
           // TODO: we can get pruning interval as a parameter
-          if (m_is_debug) {
+          RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
             std::cout << "TWiCeIdeal: Refresh command" << std::endl;
           }
-          for (int i = 0; i < m_num_ranks * m_num_banks_per_rank; i++) {
-            std::vector<std::unordered_map<Addr_t, TwiCeEntry>::iterator> to_be_pruned;
-            for (auto it = m_twice_table[i].begin(); it != m_twice_table[i].end(); it++) {
-              if (it->second.act_count < it->second.life * m_twice_pruning_interval_threshold) {
-                // Store the entries to be pruned
-                to_be_pruned.emplace_back(it);
-                if (m_is_debug) {
-                  std::cout << "TWiCeIdeal: Pruned entry " << it->first << " from bank " << i << std::endl;
-                }
-              } else {
-                // Increment the life of the entry
-                it->second.life++;
-                if (m_is_debug) {
-                  std::cout << "TWiCeIdeal: Incremented life of entry " << it->first << " in bank " << i << std::endl;
-                }
-              }
+          m_prune_checks.drain(m_num_refs, [this](const PruneCheck& check) {
+            auto it = m_twice_table[check.bank].find(check.row);
+            if (it == m_twice_table[check.bank].end() || it->second.id != check.id) {
+              // Already erased by a VRR
+              return true;
             }
-            for (auto&& it : to_be_pruned) {
-              m_twice_table[i].erase(it);
+            Clk_t life = m_num_refs - it->second.born;
+            if (it->second.act_count < life * m_twice_pruning_interval_threshold) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
+                std::cout << "TWiCeIdeal: Pruned entry " << it->first << " from bank " << check.bank << std::endl;
+              }
+              m_twice_table[check.bank].erase(it);
+            } else {
+              schedule_prune_check(check.bank, it->first, it->second);
             }
-          }
-        } else if (m_dram->m_command_meta(req_it->command).is_opening && m_dram->m_command_scopes(req_it->command) == m_row_level) {
+            return true;
+          });
+          m_num_refs++;
+        } else if (m_ctrl->m_command_event.is_activation) {
           // Activation command
-          int flat_bank_id = req_it->addr_vec[m_bank_level];
-          int accumulated_dimension = 1;
-          for (int i = m_bank_level - 1; i >= m_rank_level; i--) {
-            accumulated_dimension *= m_dram->m_organization.count[i + 1];
-            flat_bank_id += req_it->addr_vec[i] * accumulated_dimension;
-          }
+          int flat_bank_id = m_ctrl->m_command_event.flat_bank;
           
-          int row_id = req_it->addr_vec[m_row_level];
+          int row_id = m_ctrl->m_command_event.row;
 
-          if (m_is_debug) {
+          RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
             std::cout << "TWiCeIdeal: ACT on row " << row_id << std::endl;
             std::cout << "  └  " << "rank: " << req_it->addr_vec[m_rank_level] << std::endl;
             std::cout << "  └  " << "bank_group: " << req_it->addr_vec[m_rank_level + 1] << std::endl;
@@ -133,9 +147,10 @@ class TWiCeIdeal : public IControllerPlugin, public Implementation {
 
           if (m_twice_table[flat_bank_id].find(row_id) == m_twice_table[flat_bank_id].end()){
             // If row is not in the table, insert it
-            m_twice_table[flat_bank_id].insert(std::make_pair(row_id, TwiCeEntry(1, 0)));
+            auto [it, _] = m_twice_table[flat_bank_id].insert(std::make_pair(row_id, TwiCeEntry(1, m_num_refs, m_next_id++)));
+            schedule_prune_check(flat_bank_id, row_id, it->second);
             
-            if (m_is_debug) {
+            RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
               std::cout << "TWiCeIdeal: Inserted row " << row_id << " into bank " << flat_bank_id << std::endl;
             }
           } else {
@@ -150,7 +165,7 @@ class TWiCeIdeal : public IControllerPlugin, public Implementation {
               auto it = m_twice_table[flat_bank_id].find(row_id);
               m_twice_table[flat_bank_id].erase(it);
 
-              if (m_is_debug) {
+              RAMULATOR_TRACE_IF(Plugin, m_is_debug) {
                 std::cout << "TWiCeIdeal: VRR on row " << row_id << std::endl;
                 std::cout << "  └  " << "rank: " << req_it->addr_vec[m_rank_level] << std::endl;
                 std::cout << "  └  " << "bank_group: " << req_it->addr_vec[m_rank_level + 1] << std::endl;
@@ -165,6 +180,22 @@ class TWiCeIdeal : public IControllerPlugin, public Implementation {
       }
     };
 
+  private:
+    // Schedules the check of entry at the first refresh where its activations are below its life times the pruning
+    // interval threshold. Activations only add up, so the entry cannot be pruned earlier.
+    void schedule_prune_check(int bank, Addr_t row, const TwiCeEntry& entry) {
+      if (m_twice_pruning_interval_threshold <= 0) {
+        return;
+      }
+      Clk_t life = Clk_t(entry.act_count / m_twice_pruning_interval_threshold);
+      while (life > 0 && entry.act_count < life * m_twice_pruning_interval_threshold) {
+        life--;
+      }
+      while (!(entry.act_count < life * m_twice_pruning_interval_threshold)) {
+        life++;
+      }
+      m_prune_checks.schedule(std::max(entry.born + life, m_num_refs), {bank, row, entry.id});
+    };
 };
 
 }       // namespace Ramulator
@@ -4,6 +4,7 @@
 #include "frontend/impl/processor/bhO3/bhllc.h"
 #include "frontend/impl/processor/bhO3/bhO3.h"
 
+#include "dram_controller/impl/controller_core.h"
 #include "dram_controller/impl/plugin/prac/prac.h"
 
 namespace Ramulator {
@@ -11,33 +12,27 @@ namespace Ramulator {
 DECLARE_DEBUG_FLAG(DBHCTRL);
 ENABLE_DEBUG_FLAG(DBHCTRL);
 
-class PRACDRAMController final : public IBHDRAMController, public Implementation {
+class PRACDRAMController final : public IBHDRAMController, public Implementation, private ControllerCore<> {
     RAMULATOR_REGISTER_IMPLEMENTATION(IBHDRAMController, PRACDRAMController, "PRACDRAMController", "PRAC DRAM controller.")
 
 private:
     Logger_t m_logger;
-    std::deque<Request> pending;          // A queue for read requests that are about to finish (callback after RL)
+    ReqBuffer pending;                    // A queue for read requests that are about to finish (callback after RL)
     BHO3LLC* m_llc;
     IPRAC* m_prac;
 
-    ReqBuffer m_active_buffer;            // Buffer for requests being served. This has the highest priority 
-    ReqBuffer m_priority_buffer;          // Buffer for high-priority requests (e.g., maintenance like refresh).
-    ReqBuffer m_read_buffer;              // Read request buffer
-    ReqBuffer m_write_buffer;             // Write request buffer
     ReqBuffer m_prac_buffer;              // Custom PRAC buffer
     
     Request* m_prea_template;
     Request* m_rfmab_template;
+    int m_rfmab_id = -1;
+    Clk_t m_recovery_setup_cycles = -1;   // How early before the ABO recovery its PREAs and RFMs are queued
 
     int m_rank_addr_idx = -1;
     int m_bankgroup_addr_idx = -1;
     int m_bank_addr_idx = -1;
     int m_row_addr_idx = -1;
 
-    float m_wr_low_watermark;
-    float m_wr_high_watermark;
-    bool  m_is_write_mode = false;
-
     std::vector<int> s_core_row_hits;
     std::vector<int> s_core_row_misses;
     std::vector<int> s_core_row_conflicts;
@@ -52,8 +47,8 @@ private:
 public:
     void init() override {
         m_invalidate_ctr = 0;
-        m_wr_low_watermark =  param<float>("wr_low_watermark").desc("Threshold for switching back to read mode.").default_val(0.2f);
-        m_wr_high_watermark = param<float>("wr_high_watermark").desc("Threshold for switching to write mode.").default_val(0.8f);
+        m_write_drain.low_watermark =  param<float>("wr_low_watermark").desc("Threshold for switching back to read mode.").default_val(0.2f);
+        m_write_drain.high_watermark = param<float>("wr_high_watermark").desc("Threshold for switching to write mode.").default_val(0.8f);
 
         m_scheduler = create_child_ifce<IBHScheduler>();
         m_refresh = create_child_ifce<IRefreshManager>();
@@ -82,12 +77,15 @@ public:
         m_bankgroup_addr_idx = m_dram->m_levels("bankgroup");
         m_bank_addr_idx = m_dram->m_levels("bank");
         m_row_addr_idx = m_dram->m_levels("row");
+        setup_core(m_dram);
         m_priority_buffer.max_size = 512*3 + 32;
+        pending.max_size = std::numeric_limits<size_t>::max();
 
-        std::vector<int> all_bank_addr_vec(m_dram->m_levels.size(), -1);
+        AddrVec_t all_bank_addr_vec(m_dram->m_levels.size(), -1);
         all_bank_addr_vec[m_dram->m_levels("channel")] = m_channel_id;
         int m_prea_id = m_dram->m_commands("PREA");
-        int m_rfmab_id = m_dram->m_commands("RFMab");
+        m_rfmab_id = m_dram->m_commands("RFMab");
+        m_recovery_setup_cycles = m_dram->m_timing_vals("nRP") + 5;
         
         m_prea_template = new Request(all_bank_addr_vec, m_dram->m_requests("close-all-bank"));
         m_prea_template->command = m_prea_id;
@@ -126,7 +124,7 @@ public:
             if (std::find_if(m_write_buffer.begin(), m_write_buffer.end(), compare_addr) != m_write_buffer.end()) {
                 // The request will depart at the next cycle
                 req.depart = m_clk + 1;
-                pending.push_back(req);
+                pending.enqueue(req);
                 return true;
             }
         }
@@ -158,6 +156,14 @@ public:
         return is_success;
     }
 
+    bool is_demand_idle() override {
+        return m_read_buffer.size() == 0 && m_write_buffer.size() == 0;
+    }
+
+    int num_active_requests(const AddrVec_t& addr_vec) override {
+        return num_active_bank_requests(addr_vec);
+    }
+
     void tick() override {
         m_clk++;
         // Serve completed reads
@@ -167,7 +173,7 @@ public:
         m_scheduler->tick();
 
         // Do we need to setup for the ABO recovery period?
-        bool is_recovery_starting = m_prac->next_recovery_cycle() - m_clk <= m_dram->m_timing_vals("nRP") + 5;
+        bool is_recovery_starting = m_prac->next_recovery_cycle() - m_clk <= m_recovery_setup_cycles;
         bool is_recovery_setup = m_prac_buffer.size() != 0;
         if (is_recovery_starting && !is_recovery_setup) {
             for (int i = 0; i < m_dram->get_level_size("rank"); i++) {
@@ -192,29 +198,36 @@ public:
         m_rowpolicy->update(request_found, req_it);
 
         // Update all plugins
+        if (request_found) {
+            decode_command(*req_it);
+        }
         for (auto plugin : m_plugins) {
-            plugin->update(request_found, req_it);
+            RAMULATOR_PROFILE_CALL(plugin, update(request_found, req_it));
         }
 
         // Issue the commands to serve the request
         if (request_found) {
-            m_dram->issue_command(req_it->command, req_it->addr_vec);
+            RAMULATOR_PROFILE_CALL(m_dram, issue_command(req_it->command, req_it->addr_vec));
 
             // If we are issuing the last command, set depart clock cycle and move the request to the pending queue
             if (req_it->command == req_it->final_command) {
+                if (buffer == &m_active_buffer) {
+                    update_active_count(flat_bank_id(req_it->addr_vec), -1);
+                }
                 if (req_it->type_id == Request::Type::Read) {
                     req_it->depart = m_clk + m_dram->m_read_latency;
-                    pending.push_back(*req_it);
+                    buffer->transfer(req_it, pending);
                 }
-                else if (req_it->type_id == Request::Type::Write) {
-                    // TODO: Add code to update statistics
+                else {
+                    // TODO: Add code to update statistics of writes
+                    buffer->remove(req_it);
                 }
-                buffer->remove(req_it);
             }
             else if (m_dram->m_command_meta(req_it->command).is_opening) {
-              if (m_active_buffer.enqueue(*req_it)) {
-                buffer->remove(req_it);
-              }
+                int bank_id = flat_bank_id(req_it->addr_vec);
+                if (buffer->transfer(req_it, m_active_buffer) && buffer != &m_active_buffer) {
+                    update_active_count(bank_id, 1);
+                }
             }
         }
 
@@ -231,7 +244,7 @@ private:
     void serve_completed_reads() {
         if (pending.size()) {
             // Check the first pending request
-            auto& req = pending[0];
+            auto& req = *pending.begin();
             if (req.depart <= m_clk) {
                 // Request received data from dram
                 if (req.depart - req.arrive > 1) {
@@ -244,103 +257,41 @@ private:
                     req.callback(req);
                 }
                 // Finally, remove this request from the pending queue
-                pending.pop_front();
+                pending.remove(pending.begin());
             }
         };
     };
 
 
-    /**
-        * @brief    Checks if we need to switch to write mode
-        * 
-        */
-    void set_write_mode() {
-        if (!m_is_write_mode) {
-            if ((m_write_buffer.size() > m_wr_high_watermark * m_write_buffer.max_size) || m_read_buffer.size() == 0) {
-                m_is_write_mode = true;
-            }
-        } else {
-            if ((m_write_buffer.size() < m_wr_low_watermark * m_write_buffer.max_size) && m_read_buffer.size() != 0) {
-                m_is_write_mode = false;
-            }
-        }
-    };
-
     /**
         * @brief    Helper function to find a request to schedule from the buffers.
+        * @details
+        * The order of ControllerCore::schedule(), with the critical ABO requests (m_prac_buffer) served before the
+        * priority buffer, and only requests that complete before the next ABO recovery starts.
         * 
         */
     bool schedule_request(ReqBuffer::iterator& req_it, ReqBuffer*& req_buffer) {
-        bool request_found = false;
-        Clk_t next_recovery_clk = m_prac->next_recovery_cycle();
-        // 2.1    First, check the act buffer to serve requests that are already activating (avoid useless ACTs)
-        if (req_it = m_scheduler->get_best_request(m_active_buffer); req_it != m_active_buffer.end()) { 
-            bool fits = m_clk + m_prac->min_cycles_with_preall(req_it) < next_recovery_clk;
-            if (fits && m_dram->check_ready(req_it->command, req_it->addr_vec)) {
-                request_found = true;
-                req_buffer = &m_active_buffer;
-            }
-        }
-        // 2.2    If no requests can be scheduled from the act buffer, check the rest of the buffers
-        if (!request_found) {
-            // 2.2.1    We first check if MC has critical ABO requests
-            if (m_prac_buffer.size() != 0) {
-                req_buffer = &m_prac_buffer;
-                req_it = m_prac_buffer.begin();
-                req_it->command = m_dram->get_preq_command(req_it->final_command, req_it->addr_vec);
-
-                bool is_rfm = req_it->command == m_dram->m_commands("RFMab");
-                bool is_pre_rec = m_prac->get_state() == IPRAC::ABOState::PRE_RECOVERY;
-                bool early_issue = is_rfm && is_pre_rec; // Prevent controller from issuing RFMab before recovery starts
-                request_found = !early_issue && m_dram->check_ready(req_it->command, req_it->addr_vec);
-                if (!request_found & m_prac_buffer.size() != 0) {
-                    return false;
-                }
-            }
-
-            // 2.2.2    We then check the priority buffer to prioritize e.g., maintenance requests
-            if (m_priority_buffer.size() != 0) {
-                req_buffer = &m_priority_buffer;
-                req_it = m_priority_buffer.begin();
-                req_it->command = m_dram->get_preq_command(req_it->final_command, req_it->addr_vec);
-
-                bool fits = m_clk + m_prac->min_cycles_with_preall(req_it) < next_recovery_clk;
-                request_found = fits && m_dram->check_ready(req_it->command, req_it->addr_vec);
-                if (!request_found & m_priority_buffer.size() != 0) {
-                    return false;
-                }
-            }
+        auto fits = [&](const ReqBuffer::iterator& it) {
+            return m_prac->fits_before_recovery(*it, m_clk);
+        };
+        // Prevent controller from issuing RFMab before recovery starts
+        auto not_early = [&](const ReqBuffer::iterator& it) {
+            bool is_rfm = it->command == m_rfmab_id;
+            bool is_pre_rec = m_prac->get_state() == IPRAC::ABOState::PRE_RECOVERY;
+            return !(is_rfm && is_pre_rec);
+        };
 
-            // 2.2.3    If no request to be scheduled in the priority buffer, check the read and write buffers.
-            if (!request_found) {
-                // Query the write policy to decide which buffer to serve
-                set_write_mode();
-                auto& buffer = m_is_write_mode ? m_write_buffer : m_read_buffer;
-                if (req_it = m_scheduler->get_best_request(buffer); req_it != buffer.end()) {
-                    bool fits = m_clk + m_prac->min_cycles_with_preall(req_it) < next_recovery_clk;
-                    request_found = fits && m_dram->check_ready(req_it->command, req_it->addr_vec);
-                    req_buffer = &buffer;
-                }
-            }
+        Pick pick = pick_best(m_scheduler, m_active_buffer, req_it, req_buffer, fits) ? Pick::Found : Pick::None;
+        if (pick == Pick::None) {
+            pick = pick_head(m_prac_buffer, req_it, req_buffer, not_early);
         }
-
-        if (request_found && m_dram->m_command_meta(req_it->command).is_closing) {
-            auto& rowgroup = req_it->addr_vec;
-            for (auto _it = m_active_buffer.begin(); _it != m_active_buffer.end(); _it++) {
-                auto& _it_rowgroup = _it->addr_vec;
-                bool is_matching = true;
-                for (int i = 0; i < m_bank_addr_idx + 1 ; i++) {
-                    if (_it_rowgroup[i] != rowgroup[i] && _it_rowgroup[i] != -1 && rowgroup[i] != -1) {
-                        is_matching = false;
-                        break;
-                    }
-                }
-                if (is_matching) {
-                    request_found = false;
-                    break;
-                }
-            }
+        if (pick == Pick::None) {
+            pick = pick_head(m_priority_buffer, req_it, req_buffer, fits);
+        }
+        if (pick == Pick::None) {
+            pick = pick_demand(m_scheduler, req_it, req_buffer, fits);
         }
+        bool request_found = check_close(pick, req_it) == Pick::Found;
 
         if (request_found && req_buffer != &m_active_buffer) {
             if (req_it->type_id == Request::Type::Read
@@ -1,12 +1,16 @@
+#ifndef RAMULATOR_CONTROLLER_REFRESH_ALL_BANK_REFRESH_H
+#define RAMULATOR_CONTROLLER_REFRESH_ALL_BANK_REFRESH_H
+
 #include <vector>
 
 #include "base/base.h"
 #include "dram_controller/controller.h"
 #include "dram_controller/refresh.h"
+#include "dram_controller/impl/refresh/ecs_scheduler.h"
 
 namespace Ramulator {
 
-class AllBankRefresh : public IRefreshManager, public Implementation {
+class AllBankRefresh final : public IRefreshManager, public Implementation {
   RAMULATOR_REGISTER_IMPLEMENTATION(IRefreshManager, AllBankRefresh, "AllBank", "All-Bank Refresh scheme.")
   private:
     Clk_t m_clk = 0;
@@ -20,6 +24,8 @@ class AllBankRefresh : public IRefreshManager, public Implementation {
     int m_ref_req_id = -1;
     Clk_t m_next_refresh_cycle = -1;
 
+    ECSScheduler m_ecs;
+
   public:
     void init() override { 
       m_ctrl = cast_parent<IDRAMController>();
@@ -35,6 +41,7 @@ class AllBankRefresh : public IRefreshManager, public Implementation {
       m_ref_req_id = m_dram->m_requests("all-bank-refresh");
 
       m_next_refresh_cycle = m_nrefi;
+      m_ecs.setup(m_ctrl, m_dram);
     };
 
     void tick() {
@@ -43,7 +50,7 @@ class AllBankRefresh : public IRefreshManager, public Implementation {
       if (m_clk == m_next_refresh_cycle) {
         m_next_refresh_cycle += m_nrefi;
         for (int r = 0; r < m_num_ranks; r++) {
-          std::vector<int> addr_vec(m_dram_org_levels, -1);
+          AddrVec_t addr_vec(m_dram_org_levels, -1);
           addr_vec[0] = m_ctrl->m_channel_id;
           addr_vec[1] = r;
           Request req(addr_vec, m_ref_req_id);
@@ -54,8 +61,19 @@ class AllBankRefresh : public IRefreshManager, public Implementation {
           }
         }
       }
+      m_ecs.tick(m_clk);
+    };
+
+    Clk_t get_idle_cycles() override {
+      return std::min(m_next_refresh_cycle - m_clk - 1, m_ecs.get_idle_cycles(m_clk));
+    };
+
+    void skip_cycles(Clk_t num_cycles) override {
+      m_clk += num_cycles;
     };
 
 };
 
 }       // namespace Ramulator
+
+#endif   // RAMULATOR_CONTROLLER_REFRESH_ALL_BANK_REFRESH_H
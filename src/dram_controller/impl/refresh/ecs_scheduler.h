@@ -0,0 +1,95 @@
+#ifndef RAMULATOR_CONTROLLER_REFRESH_ECS_SCHEDULER_H
+#define RAMULATOR_CONTROLLER_REFRESH_ECS_SCHEDULER_H
+
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "base/base.h"
+#include "dram/dram.h"
+#include "dram_controller/controller.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Sends the ECS (error check and scrub) operations of the on-die ECC for a refresh manager.
+ *
+ * @details
+ * Every nECSint cycles, one ECS is sent to every rank of the channel through the priority buffer, like a refresh. The
+ * ECS of a rank visits its banks round-robin, alternating the bank groups. Disabled if the device has no "ecs" request
+ * or nECSint is 0 (on-die ECC off, see OnDieECC).
+ *
+ */
+class ECSScheduler {
+  private:
+    IDRAMController* m_ctrl = nullptr;
+    int m_ecs_req_id = -1;
+    Clk_t m_interval = 0;
+    Clk_t m_next_ecs_cycle = -1;
+
+    std::vector<AddrVec_t> m_ranks;       // Addresses of the ranks, wildcards below
+    std::vector<AddrVec_t> m_banks;       // Bankgroup and bank of the slots, wildcards elsewhere
+    size_t m_next_bank = 0;
+
+  public:
+    void setup(IDRAMController* ctrl, IDRAM* dram) {
+      m_ctrl = ctrl;
+      if (!dram->m_requests.contains("ecs") || dram->m_timing_vals("nECSint") <= 0) {
+        return;
+      }
+      m_ecs_req_id = dram->m_requests("ecs");
+      m_interval = dram->m_timing_vals("nECSint");
+      m_next_ecs_cycle = m_interval;
+
+      int num_levels = dram->m_levels.size();
+      int rank_level = dram->m_levels("rank");
+      int bankgroup_level = dram->m_levels("bankgroup");
+      int bank_level = dram->m_levels("bank");
+      for (int rank = 0; rank < dram->get_level_size("rank"); rank++) {
+        m_ranks.emplace_back(num_levels, -1);
+        m_ranks.back()[0] = ctrl->m_channel_id;
+        m_ranks.back()[rank_level] = rank;
+      }
+      int num_bankgroups = dram->get_level_size("bankgroup");
+      for (int bank = 0; bank < dram->get_level_size("bank"); bank++) {
+        for (int bankgroup = 0; bankgroup < num_bankgroups; bankgroup++) {
+          m_banks.emplace_back(num_levels, -1);
+          m_banks.back()[bankgroup_level] = bankgroup;
+          m_banks.back()[bank_level] = bank;
+        }
+      }
+    };
+
+    bool is_enabled() const { return m_interval > 0; };
+
+    void tick(Clk_t clk) {
+      if (!is_enabled() || clk < m_next_ecs_cycle) {
+        return;
+      }
+      m_next_ecs_cycle += m_interval;
+
+      const AddrVec_t& slot = m_banks[m_next_bank];
+      m_next_bank = (m_next_bank + 1) % m_banks.size();
+      for (const AddrVec_t& rank : m_ranks) {
+        AddrVec_t addr_vec = rank;
+        for (int level = 0; level < addr_vec.size(); level++) {
+          if (slot[level] != -1) {
+            addr_vec[level] = slot[level];
+          }
+        }
+        Request req(addr_vec, m_ecs_req_id);
+        if (!m_ctrl->priority_send(req)) {
+          throw std::runtime_error("Failed to send ECS!");
+        }
+      }
+    };
+
+    /// Cycles after clk without an ECS to send
+    Clk_t get_idle_cycles(Clk_t clk) const {
+      return is_enabled() ? m_next_ecs_cycle - clk - 1 : std::numeric_limits<Clk_t>::max();
+    };
+};
+
+}       // namespace Ramulator
+
+#endif   // RAMULATOR_CONTROLLER_REFRESH_ECS_SCHEDULER_H
@@ -0,0 +1,180 @@
+#include <vector>
+
+#include "base/base.h"
+#include "dram_controller/controller.h"
+#include "dram_controller/refresh.h"
+#include "dram_controller/impl/refresh/ecs_scheduler.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Same-bank (DDR5 REFsb) or per-bank (LPDDR5 REFpb, HBM REFsb) refresh, round-robin across the banks.
+ *
+ * @details
+ * A refresh unit (a rank, or the pseudochannel/channel of HBM) is split into bank slots:
+ *   - same-bank-refresh: one bank index across all bankgroups (the bankgroup is a wildcard).
+ *   - per-bank-refresh, bank-scoped (HBM): one bank, bankgroups interleaved.
+ *   - per-bank-refresh, rank-scoped (LPDDR5): a pair of banks, addressed by the flat id of the lower one.
+ * Every slot is refreshed once per nREFI, so each unit receives a refresh every nREFI / (number of slots) cycles, while
+ * its other banks keep serving requests.
+ * With max_postponed > 0, due refreshes wait while the read or write buffer holds demand requests, until more than
+ * max_postponed are owed (JEDEC allows up to 4 for DDR5 and 8 for LPDDR5 and HBM).
+ *
+ */
+class PerBankRefresh : public IRefreshManager, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IRefreshManager, PerBankRefresh, "PerBank", "Same-bank / per-bank round-robin refresh scheme.")
+  private:
+    Clk_t m_clk = 0;
+    IDRAM* m_dram;
+    IDRAMController* m_ctrl;
+
+    int m_dram_org_levels = -1;
+    int m_max_postponed = 0;
+
+    int m_ref_req_id = -1;
+    std::vector<AddrVec_t> m_units;       // Addresses of the refresh units, wildcards below the unit level
+    std::vector<AddrVec_t> m_slots;       // Bank-level addresses of the slots, wildcards at and above the unit level
+    size_t m_next_slot = 0;
+
+    Clk_t m_interval = -1;
+    Clk_t m_next_refresh_cycle = -1;
+    int m_num_owed = 0;                   // Refreshes that are due but not sent yet
+
+    ECSScheduler m_ecs;
+
+    size_t s_num_refreshes = 0;
+    size_t s_num_postponed_refreshes = 0;
+
+  public:
+    void init() override {
+      m_ctrl = cast_parent<IDRAMController>();
+      m_max_postponed = param<int>("max_postponed").desc("Refreshes that may be owed while demand requests are buffered (0 = never postpone).").default_val(0);
+      if (m_max_postponed < 0) {
+        throw ConfigurationError("PerBankRefresh: max_postponed must not be negative!");
+      }
+    };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      m_dram = m_ctrl->m_dram;
+      m_dram_org_levels = m_dram->m_levels.size();
+
+      bool is_same_bank = m_dram->m_requests.contains("same-bank-refresh");
+      if (!is_same_bank && !m_dram->m_requests.contains("per-bank-refresh")) {
+        throw ConfigurationError("PerBankRefresh: the DRAM supports neither same-bank-refresh nor per-bank-refresh!");
+      }
+      m_ref_req_id = m_dram->m_requests(is_same_bank ? "same-bank-refresh" : "per-bank-refresh");
+      build_slots(is_same_bank);
+
+      m_interval = m_dram->m_timing_vals("nREFI") / (Clk_t) m_slots.size();
+      if (m_interval <= 0) {
+        throw ConfigurationError("PerBankRefresh: nREFI is shorter than one cycle per bank slot!");
+      }
+      m_next_refresh_cycle = m_interval;
+      m_ecs.setup(m_ctrl, m_dram);
+
+      register_stat(s_num_refreshes).name("num_bank_refreshes_{}", m_ctrl->m_channel_id);
+      register_stat(s_num_postponed_refreshes).name("num_postponed_refreshes_{}", m_ctrl->m_channel_id);
+    };
+
+    void tick() {
+      m_clk++;
+
+      bool is_due = (m_clk == m_next_refresh_cycle);
+      if (is_due) {
+        m_next_refresh_cycle += m_interval;
+        m_num_owed++;
+      }
+
+      // Send one slot at a time, catching up with postponed refreshes once the demand requests are served
+      if (m_num_owed > 0 && (m_num_owed > m_max_postponed || m_ctrl->is_demand_idle())) {
+        send_refreshes();
+        m_num_owed--;
+      }
+      if (is_due && m_num_owed > 0) {
+        s_num_postponed_refreshes++;
+      }
+      m_ecs.tick(m_clk);
+    };
+
+    Clk_t get_idle_cycles() override {
+      if (m_num_owed > 0) {
+        return 0;
+      }
+      return std::min(m_next_refresh_cycle - m_clk - 1, m_ecs.get_idle_cycles(m_clk));
+    };
+
+    void skip_cycles(Clk_t num_cycles) override {
+      m_clk += num_cycles;
+    };
+
+  private:
+    void send_refreshes() {
+      const AddrVec_t& slot = m_slots[m_next_slot];
+      m_next_slot = (m_next_slot + 1) % m_slots.size();
+
+      for (const AddrVec_t& unit : m_units) {
+        AddrVec_t addr_vec = unit;
+        for (int level = 0; level < m_dram_org_levels; level++) {
+          if (slot[level] != -1) {
+            addr_vec[level] = slot[level];
+          }
+        }
+        Request req(addr_vec, m_ref_req_id);
+
+        bool is_success = m_ctrl->priority_send(req);
+        if (!is_success) {
+          throw std::runtime_error("Failed to send refresh!");
+        }
+        s_num_refreshes++;
+      }
+    };
+
+    void build_slots(bool is_same_bank) {
+      int bank_level = m_dram->m_levels("bank");
+      int bankgroup_level = m_dram->m_levels.contains("bankgroup") ? m_dram->m_levels("bankgroup") : -1;
+      int unit_level = (bankgroup_level == -1 ? bank_level : bankgroup_level) - 1;
+      int num_bankgroups = bankgroup_level == -1 ? 1 : m_dram->get_level_size("bankgroup");
+      int num_banks = m_dram->get_level_size("bank");
+
+      // Every combination of the levels from the channel down to the unit level
+      m_units.assign(1, AddrVec_t(m_dram_org_levels, -1));
+      m_units[0][0] = m_ctrl->m_channel_id;
+      for (int level = 1; level <= unit_level; level++) {
+        std::vector<AddrVec_t> units;
+        for (const AddrVec_t& unit : m_units) {
+          for (int node = 0; node < m_dram->m_organization.count[level]; node++) {
+            units.push_back(unit);
+            units.back()[level] = node;
+          }
+        }
+        m_units = std::move(units);
+      }
+
+      int ref_command = m_dram->m_request_translations(m_ref_req_id);
+      bool is_bank_scoped = m_dram->m_command_scopes(ref_command) == bank_level;
+      if (is_same_bank) {
+        for (int bank = 0; bank < num_banks; bank++) {
+          m_slots.emplace_back(m_dram_org_levels, -1);
+          m_slots.back()[bank_level] = bank;
+        }
+      } else if (is_bank_scoped) {
+        for (int bank = 0; bank < num_banks; bank++) {
+          for (int bankgroup = 0; bankgroup < num_bankgroups; bankgroup++) {
+            m_slots.emplace_back(m_dram_org_levels, -1);
+            if (bankgroup_level != -1) {
+              m_slots.back()[bankgroup_level] = bankgroup;
+            }
+            m_slots.back()[bank_level] = bank;
+          }
+        }
+      } else {
+        for (int bank = 0; bank < num_bankgroups * num_banks / 2; bank++) {
+          m_slots.emplace_back(m_dram_org_levels, -1);
+          m_slots.back()[bank_level] = bank;
+        }
+      }
+    };
+
+};
+
+}       // namespace Ramulator
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "base/exception.h"
+#include "dram_controller/impl/request_lifecycle.h"
+
+namespace Ramulator {
+
+namespace {
+
+constexpr uint32_t NO_CYCLE = std::numeric_limits<uint32_t>::max();
+
+template<typename T>
+void put_le(uint8_t* dst, T value) {
+  for (size_t i = 0; i < sizeof(T); i++) {
+    dst[i] = uint8_t(uint64_t(value) >> (8 * i));
+  }
+}
+
+uint32_t cycles_since(Clk_t from, Clk_t to) {
+  if (from < 0 || to < 0) {
+    return NO_CYCLE;
+  }
+  return uint32_t(std::min<Clk_t>(to - from, NO_CYCLE - 1));
+}
+
+}        // namespace
+
+
+RequestLifecycleSampler::RequestLifecycleSampler(int interval, const std::string& path):
+m_interval(interval), m_countdown(interval), m_path(path) {
+  if (interval < 0) {
+    throw ConfigurationError("The lifecycle sampling interval cannot be negative (got {})!", interval);
+  }
+  if (m_path.empty()) {
+    return;
+  }
+  m_file.open(m_path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_file) {
+    throw ConfigurationError("Request lifecycle trace {} cannot be opened for writing!", m_path);
+  }
+  // The record count is filled in by close()
+  uint8_t header[HEADER_SIZE] = {};
+  std::memcpy(header, MAGIC, sizeof(MAGIC));
+  put_le<uint16_t>(header + 4, VERSION);
+  put_le<uint16_t>(header + 6, RECORD_SIZE);
+  m_file.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+  m_buffer.reserve(BUFFER_SIZE);
+}
+
+int RequestLifecycleSampler::allocate(const Request& req, Clk_t clk, Clk_t write_mode_cycles) {
+  int id;
+  if (m_free_slots.empty()) {
+    id = m_slots.size();
+    m_slots.emplace_back();
+  } else {
+    id = m_free_slots.back();
+    m_free_slots.pop_back();
+  }
+  Slot& slot = m_slots[id];
+  slot = Slot();
+  slot.addr = req.addr;
+  slot.type_id = req.type_id;
+  slot.source_id = req.source_id;
+  slot.arrive = clk;
+  slot.write_mode_cycles = write_mode_cycles;
+  return id;
+}
+
+void RequestLifecycleSampler::on_command(const Request& req, Clk_t clk, Clk_t write_mode_cycles) {
+  Slot& slot = m_slots[req.lifecycle_id];
+  if (slot.first_command == -1) {
+    slot.first_command = clk;
+    if (slot.type_id == Request::Type::Read) {
+      slot.write_drain = write_mode_cycles - slot.write_mode_cycles;
+    }
+  }
+  slot.commands[std::min(slot.num_commands, MAX_COMMANDS - 1)] = {clk, req.command};
+  slot.num_commands++;
+
+  if (req.command == req.final_command) {
+    slot.final_command = clk;
+    if (slot.type_id != Request::Type::Read) {
+      complete(req.lifecycle_id, clk);
+    }
+  }
+}
+
+void RequestLifecycleSampler::on_data(const Request& req, Clk_t clk, bool is_decoding) {
+  m_slots[req.lifecycle_id].data = clk;
+  if (!is_decoding) {
+    complete(req.lifecycle_id, clk);
+  }
+}
+
+void RequestLifecycleSampler::complete(int id, Clk_t clk) {
+  const Slot& slot = m_slots[id];
+  Breakdown& breakdown = slot.type_id == Request::Type::Read ? s_reads : s_writes;
+  breakdown.num_requests++;
+  breakdown.queueing += slot.first_command - slot.arrive - slot.write_drain;
+  breakdown.write_drain += slot.write_drain;
+  breakdown.row += slot.final_command - slot.first_command;
+  if (slot.data != -1) {
+    breakdown.cas += slot.data - slot.final_command;
+    breakdown.ecc += clk - slot.data;
+  }
+
+  if (m_file.is_open()) {
+    put_record(slot, clk);
+  }
+  m_free_slots.push_back(id);
+}
+
+void RequestLifecycleSampler::put_record(const Slot& slot, Clk_t done) {
+  size_t offset = m_buffer.size();
+  m_buffer.resize(offset + RECORD_SIZE);
+  uint8_t* dst = m_buffer.data() + offset;
+  put_le<int64_t>(dst, slot.addr);
+  put_le<int64_t>(dst + 8, slot.arrive);
+  put_le<int32_t>(dst + 16, slot.source_id);
+  put_le<uint8_t>(dst + 20, slot.type_id);
+  put_le<uint8_t>(dst + 21, std::min(slot.num_commands, 255));
+  put_le<uint16_t>(dst + 22, 0);
+  put_le<uint32_t>(dst + 24, cycles_since(slot.arrive, slot.data));
+  put_le<uint32_t>(dst + 28, cycles_since(slot.arrive, done));
+  for (int i = 0; i < MAX_COMMANDS; i++) {
+    bool is_issued = i < slot.num_commands;
+    put_le<uint32_t>(dst + 32 + 8 * i, is_issued ? cycles_since(slot.arrive, slot.commands[i].first) : NO_CYCLE);
+    put_le<uint16_t>(dst + 36 + 8 * i, is_issued ? slot.commands[i].second : 0xFFFF);
+    put_le<uint16_t>(dst + 38 + 8 * i, 0);
+  }
+  m_num_records++;
+
+  if (m_buffer.size() + RECORD_SIZE > BUFFER_SIZE) {
+    flush();
+  }
+}
+
+void RequestLifecycleSampler::flush() {
+  m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+  m_buffer.clear();
+  if (!m_file) {
+    throw ConfigurationError("Failed to write request lifecycle trace {}!", m_path);
+  }
+}
+
+void RequestLifecycleSampler::close() {
+  if (m_closed || !m_file.is_open()) {
+    return;
+  }
+  m_closed = true;
+  flush();
+
+  uint8_t num_records[sizeof(uint64_t)];
+  put_le<uint64_t>(num_records, m_num_records);
+  m_file.seekp(8);
+  m_file.write(reinterpret_cast<const char*>(num_records), sizeof(num_records));
+  m_file.close();
+  if (!m_file) {
+    throw ConfigurationError("Failed to write request lifecycle trace {}!", m_path);
+  }
+}
+
+}        // namespace Ramulator
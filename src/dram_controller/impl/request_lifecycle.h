@@ -0,0 +1,144 @@
+#ifndef RAMULATOR_CONTROLLER_REQUEST_LIFECYCLE_H
+#define RAMULATOR_CONTROLLER_REQUEST_LIFECYCLE_H
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "base/request.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Samples 1 in N requests of a controller and times the steps of their lifecycle.
+ *
+ * @details
+ * A sampled request gets a slot (Request::lifecycle_id) when it is buffered, and the controller reports its commands,
+ * the cycle its read data returns and the cycle it completes (after the ECC decoder, if any). When it completes, its
+ * latency is split into:
+ *   - queueing:     from arrival to its first command, minus the write-drain cycles,
+ *   - write drain:  the cycles a read waited while the controller was draining writes,
+ *   - row:          from its first command to its final command (precharges and activations),
+ *   - CAS:          from its final command to its data (reads),
+ *   - ECC:          from its data to its completion (reads through the ECC decoder).
+ * The averages over the sampled requests are stats of the controller. Unsampled requests only cost a check of their
+ * lifecycle_id, so the sampling interval bounds the overhead.
+ *
+ * With a trace path, every completed sample is also appended as a fixed-width record to a buffer that is written to
+ * the file when it fills up and at close(). The file starts with a 32-byte little-endian header:
+ *   "RLCT", the format version (uint16_t), the record size (uint16_t), the number of records (uint64_t) and 16
+ *   reserved zero bytes.
+ * Every record is RECORD_SIZE bytes: the address (int64_t), the arrival cycle (int64_t), the source (int32_t), the
+ * request type (uint8_t), the number of commands issued (uint8_t), 2 reserved bytes, the cycles from arrival to the data
+ * and to the completion (uint32_t each, UINT32_MAX if none), and MAX_COMMANDS slots of the cycles from arrival to a
+ * command (uint32_t) and its id (uint16_t, then 2 reserved bytes). A request with more commands keeps the latest one in
+ * the last slot.
+ *
+ */
+class RequestLifecycleSampler {
+  public:
+    static constexpr char MAGIC[4] = {'R', 'L', 'C', 'T'};
+    static constexpr uint16_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 32;
+    static constexpr int MAX_COMMANDS = 4;
+    static constexpr size_t RECORD_SIZE = 32 + MAX_COMMANDS * 8;
+    static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+    struct Breakdown {
+      size_t num_requests = 0;
+      size_t queueing = 0;
+      size_t write_drain = 0;
+      size_t row = 0;
+      size_t cas = 0;
+      size_t ecc = 0;
+    };
+
+  private:
+    struct Slot {
+      Addr_t addr = -1;
+      int type_id = -1;
+      int source_id = -1;
+      Clk_t arrive = -1;
+      Clk_t write_mode_cycles = 0;    // The write-mode cycle count of the controller when the request arrived
+      Clk_t write_drain = 0;
+      Clk_t first_command = -1;
+      Clk_t final_command = -1;
+      Clk_t data = -1;
+      int num_commands = 0;
+      std::array<std::pair<Clk_t, int>, MAX_COMMANDS> commands {};
+    };
+
+    int m_interval = 0;               // Sample 1 in m_interval requests (0 = disabled)
+    int m_countdown = 0;
+    std::vector<Slot> m_slots;
+    std::vector<int> m_free_slots;
+
+    std::string m_path;
+    std::ofstream m_file;
+    std::vector<uint8_t> m_buffer;
+    uint64_t m_num_records = 0;
+    bool m_closed = false;
+
+  public:
+    Breakdown s_reads;
+    Breakdown s_writes;
+
+  public:
+    RequestLifecycleSampler() {};
+    RequestLifecycleSampler(int interval, const std::string& path);
+    RequestLifecycleSampler(RequestLifecycleSampler&&) = default;
+    RequestLifecycleSampler& operator=(RequestLifecycleSampler&&) = default;
+
+    bool enabled() const { return m_interval > 0; };
+
+    /**
+     * @brief    Returns the slot of req if it is the one request in interval to sample, else -1.
+     *
+     */
+    int sample(const Request& req, Clk_t clk, Clk_t write_mode_cycles) {
+      if (!enabled() || --m_countdown > 0) {
+        return -1;
+      }
+      m_countdown = m_interval;
+      return allocate(req, clk, write_mode_cycles);
+    };
+
+    /// Releases the slot of a sampled request the controller could not buffer
+    void cancel(int id) { m_free_slots.push_back(id); };
+
+    /**
+     * @brief    Records a command of a sampled request issued at clk. A write completes with its final command.
+     *
+     */
+    void on_command(const Request& req, Clk_t clk, Clk_t write_mode_cycles);
+
+    /**
+     * @brief    Records the read data of a sampled request at clk. The read completes unless it goes to the decoder.
+     *
+     */
+    void on_data(const Request& req, Clk_t clk, bool is_decoding);
+
+    /**
+     * @brief    Completes a sampled read leaving the ECC decoder at clk.
+     *
+     */
+    void on_decoded(const Request& req, Clk_t clk) { complete(req.lifecycle_id, clk); };
+
+    /**
+     * @brief    Writes the buffered records and the record count of the trace, if any.
+     *
+     */
+    void close();
+
+  private:
+    int allocate(const Request& req, Clk_t clk, Clk_t write_mode_cycles);
+    void complete(int id, Clk_t clk);
+    void put_record(const Slot& slot, Clk_t done);
+    void flush();
+};
+
+}        // namespace Ramulator
+
+#endif   // RAMULATOR_CONTROLLER_REQUEST_LIFECYCLE_H
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+#include "base/base.h"
+#include "dram_controller/controller.h"
+#include "dram_controller/rowpolicy.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Timeout-based row closure with a per-bank timeout that adapts to the row-buffer outcomes.
+ *
+ * @details
+ * A bank whose open row has not been accessed for its timeout is closed with a close-row request. The timeout of
+ * every bank starts at timeout and follows the outcomes the controller classifies:
+ *   - A conflict means the row stayed open too long, so the timeout is halved.
+ *   - A miss to the row the policy itself closed means it was closed too early, so the timeout is doubled.
+ * Streaming banks thus keep their rows open for the whole burst, while banks with random accesses close them before
+ * the next request arrives, turning conflicts into misses.
+ * With subarray-level parallelism (see SubarrayTiming), every subarray of a bank has its own open row and timeout.
+ *
+ */
+class AdaptiveRowPolicy : public IRowPolicy, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IRowPolicy, AdaptiveRowPolicy, "AdaptiveRowPolicy", "Adaptive Timeout Row Policy.")
+  private:
+    IDRAM* m_dram;
+
+    Clk_t m_clk = 0;
+    int m_close_req_id = -1;
+    int m_close_command = -1;
+    int m_read_command = -1;              // Command whose row-open check tells whether a bank has an open row
+
+    Clk_t m_init_timeout = -1;
+    Clk_t m_min_timeout = -1;
+    Clk_t m_max_timeout = -1;
+
+    int m_bank_level = -1;
+    int m_row_level = -1;
+    std::vector<int> m_level_sizes;       // Organization counts from below the channel down to the bank level
+    int m_num_subarrays = 1;              // Row buffers per bank (subarray-level parallelism)
+
+    struct BankState {
+      Clk_t timeout = 0;
+      Clk_t deadline = -1;                // Cycle at which the row is closed, -1 if none is scheduled
+      AddrVec_t last_addr_vec;            // Address of the last access, to close its row
+      int closed_row = -1;                // Row the policy closed last, -1 once another request served the bank
+    };
+    std::vector<BankState> m_banks;
+
+    struct Deadline {
+      Clk_t clk;
+      int bank_id;
+      bool operator>(const Deadline& other) const { return clk > other.clk; };
+    };
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> m_deadlines;   // Lazily invalidated
+
+    size_t s_num_close_reqs = 0;
+    size_t s_num_premature_closes = 0;
+    size_t s_num_late_closes = 0;
+
+  public:
+    void init() override {
+      m_init_timeout = param<Clk_t>("timeout").desc("Initial number of idle cycles before an open row is closed.").default_val(64);
+      m_min_timeout = param<Clk_t>("min_timeout").desc("Lower bound of the adapted timeout.").default_val(8);
+      m_max_timeout = param<Clk_t>("max_timeout").desc("Upper bound of the adapted timeout.").default_val(4096);
+
+      if (m_min_timeout <= 0 || m_min_timeout > m_max_timeout) {
+        throw ConfigurationError("AdaptiveRowPolicy: timeouts must satisfy 0 < min_timeout <= max_timeout!");
+      }
+      m_init_timeout = std::clamp(m_init_timeout, m_min_timeout, m_max_timeout);
+    };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      m_ctrl = cast_parent<IDRAMController>();
+      m_dram = m_ctrl->m_dram;
+
+      if (!m_dram->m_requests.contains("close-row")) {
+        throw ConfigurationError("AdaptiveRowPolicy: the DRAM does not support request close-row!");
+      }
+      m_close_req_id = m_dram->m_requests("close-row");
+      m_close_command = m_dram->m_request_translations(m_close_req_id);
+      m_read_command = m_dram->m_request_translations(m_dram->m_requests("read"));
+
+      m_bank_level = m_dram->m_levels("bank");
+      m_row_level = m_dram->m_levels("row");
+      size_t num_banks = 1;
+      for (int level = 1; level <= m_bank_level; level++) {
+        m_level_sizes.push_back(m_dram->m_organization.count[level]);
+        num_banks *= m_level_sizes.back();
+      }
+      if (m_dram->m_subarrays) {
+        m_num_subarrays = m_dram->m_subarrays->num_subarrays();
+      }
+      m_banks.resize(num_banks * m_num_subarrays);
+      for (BankState& bank : m_banks) {
+        bank.timeout = m_init_timeout;
+      }
+
+      register_stat(s_num_close_reqs).name("num_close_reqs");
+      register_stat(s_num_premature_closes).name("num_premature_closes");
+      register_stat(s_num_late_closes).name("num_late_closes");
+    };
+
+    void update(bool request_found, ReqBuffer::iterator& req_it) override {
+      // The second command of a cycle (dual command bus) does not advance the clock
+      if (!request_found || !m_ctrl->m_command_event.is_same_cycle) {
+        m_clk++;
+      }
+
+      if (request_found && m_dram->m_command_meta(req_it->command).is_accessing) {
+        int bank_id = flat_bank_id(req_it->addr_vec);
+        if (bank_id != -1) {
+          BankState& bank = m_banks[bank_id];
+          bank.last_addr_vec = req_it->addr_vec;
+          bank.deadline = m_clk + bank.timeout;
+          m_deadlines.push({bank.deadline, bank_id});
+        }
+      }
+
+      while (!m_deadlines.empty() && m_deadlines.top().clk <= m_clk) {
+        Deadline deadline = m_deadlines.top();
+        m_deadlines.pop();
+        BankState& bank = m_banks[deadline.bank_id];
+        if (bank.deadline != deadline.clk) {
+          continue;       // The bank was accessed again after this deadline was set
+        }
+        bank.deadline = -1;
+        close_row(bank, deadline.bank_id);
+      }
+    };
+
+    void on_row_access(const Request& req, RowAccess access) override {
+      int bank_id = flat_bank_id(req.addr_vec);
+      if (bank_id == -1) {
+        return;
+      }
+      BankState& bank = m_banks[bank_id];
+
+      if (access == RowAccess::Conflict) {
+        bank.timeout = std::max(bank.timeout / 2, m_min_timeout);
+        s_num_late_closes++;
+      } else if (access == RowAccess::Miss && bank.closed_row == req.addr_vec[m_row_level]) {
+        bank.timeout = std::min(bank.timeout * 2, m_max_timeout);
+        s_num_premature_closes++;
+      }
+      bank.closed_row = -1;
+    };
+
+    Clk_t get_idle_cycles() override {
+      // Stale deadlines only make the span shorter
+      if (m_deadlines.empty()) {
+        return std::numeric_limits<Clk_t>::max();
+      }
+      return std::max<Clk_t>(m_deadlines.top().clk - m_clk - 1, 0);
+    };
+
+    void skip_cycles(Clk_t num_cycles) override {
+      m_clk += num_cycles;
+    };
+
+  private:
+    int flat_bank_id(const AddrVec_t& addr_vec) const {
+      int id = 0;
+      for (int level = 1; level <= m_bank_level; level++) {
+        if (addr_vec[level] < 0) {
+          return -1;
+        }
+        id = id * m_level_sizes[level - 1] + addr_vec[level];
+      }
+      if (m_num_subarrays > 1) {
+        int subarray = m_dram->m_subarrays->subarray(addr_vec[m_row_level]);
+        if (subarray == -1) {
+          return -1;
+        }
+        id = id * m_num_subarrays + subarray;
+      }
+      return id;
+    };
+
+    void close_row(BankState& bank, int bank_id) {
+      // Leave rows alone that a refresh or another command already closed, or that requests are still waiting for
+      if (!m_dram->check_node_open(m_read_command, bank.last_addr_vec) || m_ctrl->num_active_requests(bank.last_addr_vec) > 0 ||
+          m_ctrl->num_row_requests(bank.last_addr_vec) > 0) {
+        return;
+      }
+
+      // A close that is not ready yet would hold up the priority buffer, so wait until the device accepts it
+      Clk_t ready_clk = m_dram->get_ready_clk(m_close_command, bank.last_addr_vec);
+      if (ready_clk > m_clk) {
+        bank.deadline = ready_clk;
+        m_deadlines.push({bank.deadline, bank_id});
+        return;
+      }
+
+      Request req(bank.last_addr_vec, m_close_req_id);
+      if (m_ctrl->priority_send(req)) {
+        bank.closed_row = bank.last_addr_vec[m_row_level];
+        s_num_close_reqs++;
+      }
+    };
+};
+
+}       // namespace Ramulator
@@ -1,3 +1,7 @@
+#ifndef RAMULATOR_CONTROLLER_ROWPOLICY_BASIC_ROWPOLICIES_H
+#define RAMULATOR_CONTROLLER_ROWPOLICY_BASIC_ROWPOLICIES_H
+
+#include <limits>
 #include <vector>
 
 #include "base/base.h"
@@ -7,7 +11,7 @@
 
 namespace Ramulator {
 
-class OpenRowPolicy : public IRowPolicy, public Implementation {
+class OpenRowPolicy final : public IRowPolicy, public Implementation {
   RAMULATOR_REGISTER_IMPLEMENTATION(IRowPolicy, OpenRowPolicy, "OpenRowPolicy", "Open Row Policy.")
   private:
     
@@ -20,10 +24,14 @@ class OpenRowPolicy : public IRowPolicy, public Implementation {
       // OpenRowPolicy does not need to take any actions
     };
 
+    Clk_t get_idle_cycles() override {
+      return std::numeric_limits<Clk_t>::max();
+    };
+
 
 };
 
-class ClosedRowPolicy : public IRowPolicy, public Implementation {
+class ClosedRowPolicy final : public IRowPolicy, public Implementation {
   RAMULATOR_REGISTER_IMPLEMENTATION(IRowPolicy, ClosedRowPolicy, "ClosedRowPolicy", "Close Row Policy.")
   private:
     IDRAM* m_dram;
@@ -116,6 +124,13 @@ class ClosedRowPolicy : public IRowPolicy, public Implementation {
         }
       }
     };
+
+    Clk_t get_idle_cycles() override {
+      // Nothing happens without a request
+      return std::numeric_limits<Clk_t>::max();
+    };
 };
 
 }       // namespace Ramulator
+
+#endif   // RAMULATOR_CONTROLLER_ROWPOLICY_BASIC_ROWPOLICIES_H
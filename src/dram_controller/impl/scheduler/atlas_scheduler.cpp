@@ -0,0 +1,104 @@
+#include <vector>
+
+#include "base/base.h"
+#include "dram_controller/controller.h"
+#include "dram_controller/scheduler.h"
+#include "dram_controller/impl/plugin/atlas/atlas.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    ATLAS: least-attained-service first (Kim et al., HPCA 2010).
+ *
+ * @details
+ * Requests are ordered by: 1) requests older than the starvation threshold, 2) the rank of their source (least
+ * attained service first), 3) ready requests, 4) the earliest request. The ranking comes from the ATLAS plugin.
+ *
+ */
+class ATLASScheduler : public IScheduler, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IScheduler, ATLASScheduler, "ATLAS", "ATLAS DRAM Scheduler.")
+  private:
+    IDRAM* m_dram;
+    IATLAS* m_atlas;
+
+    const int STARVING_IDX = 0;
+    const int RANK_IDX = 1;
+    const int READY_IDX = 2;
+
+  public:
+    void init() override { };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      auto* ctrl = cast_parent<IDRAMController>();
+      m_dram = ctrl->m_dram;
+      m_atlas = ctrl->get_plugin<IATLAS>();
+
+      if (!m_atlas) {
+        throw ConfigurationError("[Ramulator::ATLASScheduler] Implementation requires ATLAS plugin to be active.");
+      }
+    };
+
+    ReqBuffer::iterator compare(ReqBuffer::iterator req1, ReqBuffer::iterator req2) override {
+      bool starving1 = req1->scratchpad[STARVING_IDX];
+      bool starving2 = req2->scratchpad[STARVING_IDX];
+
+      if (starving1 ^ starving2) {
+        if (starving1) {
+          return req1;
+        } else {
+          return req2;
+        }
+      }
+
+      int rank1 = req1->scratchpad[RANK_IDX];
+      int rank2 = req2->scratchpad[RANK_IDX];
+
+      if (rank1 != rank2) {
+        if (rank1 < rank2) {
+          return req1;
+        } else {
+          return req2;
+        }
+      }
+
+      bool ready1 = req1->scratchpad[READY_IDX];
+      bool ready2 = req2->scratchpad[READY_IDX];
+
+      if (ready1 ^ ready2) {
+        if (ready1) {
+          return req1;
+        } else {
+          return req2;
+        }
+      }
+
+      // Fallback to FCFS
+      if (req1->arrive <= req2->arrive) {
+        return req1;
+      } else {
+        return req2;
+      }
+    }
+
+    ReqBuffer::iterator get_best_request(ReqBuffer& buffer) override {
+      if (buffer.size() == 0) {
+        return buffer.end();
+      }
+
+      for (auto& req : buffer) {
+        req.command = m_dram->get_preq_command(req.final_command, req.addr_vec);
+
+        req.scratchpad[STARVING_IDX] = m_atlas->is_starving(req);
+        req.scratchpad[RANK_IDX] = m_atlas->get_rank(req.source_id);
+        req.scratchpad[READY_IDX] = m_dram->check_ready(req.command, req.addr_vec);
+      }
+
+      auto candidate = buffer.begin();
+      for (auto next = std::next(buffer.begin(), 1); next != buffer.end(); next++) {
+        candidate = compare(candidate, next);
+      }
+      return candidate;
+    }
+};
+
+}       // namespace Ramulator
@@ -1,3 +1,6 @@
+#ifndef RAMULATOR_CONTROLLER_SCHEDULER_GENERIC_SCHEDULER_H
+#define RAMULATOR_CONTROLLER_SCHEDULER_GENERIC_SCHEDULER_H
+
 #include <vector>
 
 #include "base/base.h"
@@ -6,7 +9,7 @@
 
 namespace Ramulator {
 
-class FRFCFS : public IScheduler, public Implementation {
+class FRFCFS final : public IScheduler, public Implementation {
   RAMULATOR_REGISTER_IMPLEMENTATION(IScheduler, FRFCFS, "FRFCFS", "FRFCFS DRAM Scheduler.")
   private:
     IDRAM* m_dram;
@@ -56,3 +59,5 @@ class FRFCFS : public IScheduler, public Implementation {
 };
 
 }       // namespace Ramulator
+
+#endif   // RAMULATOR_CONTROLLER_SCHEDULER_GENERIC_SCHEDULER_H
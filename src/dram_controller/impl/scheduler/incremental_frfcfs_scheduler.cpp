@@ -0,0 +1,298 @@
+#include <vector>
+#include <algorithm>
+
+#include "base/base.h"
+#include "dram_controller/controller.h"
+#include "dram_controller/scheduler.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    The cached prerequisites and per-bank readiness of IncrementalFRFCFS (see there), shared with FRFCFSCap.
+ *
+ */
+class IncrementalReadiness {
+  private:
+    IDRAM* m_dram = nullptr;
+
+    int m_bank_level = -1;
+    std::vector<int> m_level_sizes;     // Organization counts from the channel down to the bank level
+    int m_num_commands = 0;
+
+    struct ReadyEntry {
+      int64_t stamp = -1;               // The call of get_best_request() that filled this entry
+      bool ready = false;
+    };
+    std::vector<ReadyEntry> m_ready;    // [flat bank id * m_num_commands + command]
+    int64_t m_stamp = 0;
+
+  public:
+    void setup(IDRAM* dram) {
+      m_dram = dram;
+      m_bank_level = m_dram->m_levels("bank");
+      m_num_commands = m_dram->m_commands.size();
+      for (int level = 0; level <= m_bank_level; level++) {
+        m_level_sizes.push_back(m_dram->m_organization.count[level]);
+      }
+      m_ready.resize(num_banks() * m_num_commands);
+    };
+
+    size_t num_banks() const {
+      size_t num_banks = 1;
+      for (int size : m_level_sizes) {
+        num_banks *= size;
+      }
+      return num_banks;
+    };
+
+    /// Starts a call of get_best_request(), which invalidates the readiness of the previous one
+    int64_t start() { return ++m_stamp; };
+
+    void update_command(Request& req) {
+      int64_t version = m_dram->get_state_version(req.addr_vec);
+      if (version == -1 || version != req.preq_version) {
+        req.command = m_dram->get_preq_command(req.final_command, req.addr_vec);
+        req.preq_version = version;
+      }
+    };
+
+    bool check_ready(const Request& req) {
+      int bank_id = flat_bank_id(req.addr_vec);
+      if (bank_id == -1) {
+        return m_dram->check_ready(req.command, req.addr_vec);
+      }
+
+      ReadyEntry& entry = m_ready[bank_id * m_num_commands + req.command];
+      if (entry.stamp != m_stamp) {
+        entry.stamp = m_stamp;
+        entry.ready = m_dram->check_ready(req.command, req.addr_vec);
+      }
+      return entry.ready;
+    };
+
+    // Flat id of the bank of addr_vec, or -1 if it has a wildcard down to the bank level
+    int flat_bank_id(const AddrVec_t& addr_vec) const {
+      int id = 0;
+      for (int level = 0; level <= m_bank_level; level++) {
+        if (addr_vec[level] < 0) {
+          return -1;
+        }
+        id = id * m_level_sizes[level] + addr_vec[level];
+      }
+      return id;
+    };
+};
+
+/**
+ * @brief    FRFCFS that avoids walking the device hierarchy for every request every cycle.
+ *
+ * @details
+ * It picks the same request as FRFCFS: the earliest ready request, else the earliest request (ties go to the
+ * request closer to the front of the buffer). Two observations make this cheaper:
+ * 1. The prerequisite command of a request only changes when an action updates a node on the path of its address.
+ *    Each request caches its command with the IDRAM::get_state_version() it was computed at, and get_preq_command()
+ *    is only called again when a command (or future action) to the same bank, its bankgroup or rank changed the version.
+ * 2. Readiness only depends on the command and the bank it goes to, so check_ready() is called at most once per
+ *    (bank, command) pair per call, however many requests in the buffer share that pair.
+ * Requests with wildcards above the bank level, and devices whose prerequisites also depend on time, fall back to
+ * recomputing everything like FRFCFS.
+ *
+ */
+class IncrementalFRFCFS : public IScheduler, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IScheduler, IncrementalFRFCFS, "IncrementalFRFCFS", "FRFCFS DRAM Scheduler with cached prerequisites and per-bank readiness.")
+  private:
+    IDRAM* m_dram;
+    IncrementalReadiness m_readiness;
+
+  public:
+    void init() override { };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      m_dram = cast_parent<IDRAMController>()->m_dram;
+      m_readiness.setup(m_dram);
+    };
+
+    ReqBuffer::iterator compare(ReqBuffer::iterator req1, ReqBuffer::iterator req2) override {
+      bool ready1 = m_dram->check_ready(req1->command, req1->addr_vec);
+      bool ready2 = m_dram->check_ready(req2->command, req2->addr_vec);
+
+      if (ready1 ^ ready2) {
+        if (ready1) {
+          return req1;
+        } else {
+          return req2;
+        }
+      }
+
+      // Fallback to FCFS
+      if (req1->arrive <= req2->arrive) {
+        return req1;
+      } else {
+        return req2;
+      }
+    }
+
+    ReqBuffer::iterator get_best_request(ReqBuffer& buffer) override {
+      if (buffer.size() == 0) {
+        return buffer.end();
+      }
+      m_readiness.start();
+
+      // One pass keeps the earliest ready request and the earliest request, which is what the pairwise
+      // compare() of FRFCFS reduces to
+      auto best_ready = buffer.end();
+      auto best = buffer.end();
+      for (auto it = buffer.begin(); it != buffer.end(); it++) {
+        m_readiness.update_command(*it);
+        if (best == buffer.end() || it->arrive < best->arrive) {
+          best = it;
+        }
+        if ((best_ready == buffer.end() || it->arrive < best_ready->arrive) && m_readiness.check_ready(*it)) {
+          best_ready = it;
+        }
+      }
+      return (best_ready != buffer.end()) ? best_ready : best;
+    }
+};
+
+/**
+ * @brief    FR-FCFS-Cap: FRFCFS with a cap on consecutive row hits per bank (Mutlu and Moscibroda, MICRO 2007).
+ *
+ * @details
+ * The scheduler counts the column commands each bank serves from its open row since the row was opened. Once a bank
+ * has served cap of them and a request to another row of the bank waits, the row hits to that bank lose the priority
+ * of ready requests and are ordered by age like requests that are not ready. A row-hit stream can then no longer
+ * starve an older conflicting request. It uses the cached prerequisites and per-bank readiness of IncrementalFRFCFS
+ * and needs the controller to report the issued commands (IScheduler::on_command_issued()).
+ *
+ */
+class FRFCFSCap : public IScheduler, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IScheduler, FRFCFSCap, "FRFCFS-Cap", "FRFCFS DRAM Scheduler with a cap on consecutive row hits per bank.")
+  private:
+    IDRAM* m_dram;
+    IncrementalReadiness m_readiness;
+
+    int m_cap = -1;
+
+    std::vector<int> m_hit_streak;          // Column commands served from the open row, per flat bank id
+    std::vector<int64_t> m_conflict_stamp;  // The call of get_best_request() that saw a request to another row, per flat bank id
+    int64_t m_stamp = 0;
+
+    size_t s_cap_triggers = 0;              // Picks that differ from FRFCFS because of the cap
+    size_t s_capped_hits = 0;               // Ready row hits that lost their priority, per scheduling decision
+    int s_max_hit_streak = 0;
+
+  public:
+    void init() override {
+      m_cap = param<int>("cap").desc("Consecutive row hits per bank after which hits no longer go ahead of older conflicting requests.").default_val(4);
+      if (m_cap < 1) {
+        throw ConfigurationError("FRFCFS-Cap: cap must be positive!");
+      }
+    };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      m_dram = cast_parent<IDRAMController>()->m_dram;
+      m_readiness.setup(m_dram);
+      m_hit_streak.resize(m_readiness.num_banks(), 0);
+      m_conflict_stamp.resize(m_readiness.num_banks(), -1);
+
+      register_stat(s_cap_triggers).name("frfcfs_cap_triggers");
+      register_stat(s_capped_hits).name("frfcfs_capped_hits");
+      register_stat(s_max_hit_streak).name("frfcfs_max_hit_streak");
+    };
+
+    ReqBuffer::iterator compare(ReqBuffer::iterator req1, ReqBuffer::iterator req2) override {
+      bool ready1 = m_dram->check_ready(req1->command, req1->addr_vec) && !is_capped(*req1);
+      bool ready2 = m_dram->check_ready(req2->command, req2->addr_vec) && !is_capped(*req2);
+
+      if (ready1 ^ ready2) {
+        if (ready1) {
+          return req1;
+        } else {
+          return req2;
+        }
+      }
+
+      // Fallback to FCFS
+      if (req1->arrive <= req2->arrive) {
+        return req1;
+      } else {
+        return req2;
+      }
+    }
+
+    ReqBuffer::iterator get_best_request(ReqBuffer& buffer) override {
+      if (buffer.size() == 0) {
+        return buffer.end();
+      }
+      m_stamp = m_readiness.start();
+
+      // 1. Find the banks with a request to another row than the open one
+      for (auto it = buffer.begin(); it != buffer.end(); it++) {
+        m_readiness.update_command(*it);
+        int bank_id = m_readiness.flat_bank_id(it->addr_vec);
+        if (bank_id != -1 && !m_dram->m_command_meta(it->command).is_accessing) {
+          m_conflict_stamp[bank_id] = m_stamp;
+        }
+      }
+
+      // 2. The earliest ready request that is not capped, else the earliest request. The earliest ready request is
+      //    kept too, to count the picks the cap changed.
+      auto best_ready = buffer.end();
+      auto best_uncapped = buffer.end();
+      auto best = buffer.end();
+      for (auto it = buffer.begin(); it != buffer.end(); it++) {
+        if (best == buffer.end() || it->arrive < best->arrive) {
+          best = it;
+        }
+        if (!m_readiness.check_ready(*it)) {
+          continue;
+        }
+        if (best_ready == buffer.end() || it->arrive < best_ready->arrive) {
+          best_ready = it;
+        }
+        if (is_capped(*it)) {
+          s_capped_hits++;
+        } else if (best_uncapped == buffer.end() || it->arrive < best_uncapped->arrive) {
+          best_uncapped = it;
+        }
+      }
+
+      auto pick = (best_uncapped != buffer.end()) ? best_uncapped : best;
+      if (best_ready != buffer.end() && pick != best_ready) {
+        s_cap_triggers++;
+      }
+      return pick;
+    }
+
+    void on_command_issued(const Request& req) override {
+      const DRAMCommandMeta& meta = m_dram->m_command_meta(req.command);
+      int bank_id = m_readiness.flat_bank_id(req.addr_vec);
+      if (bank_id == -1) {
+        // Commands to several banks (e.g., PREA, REFab) close their rows
+        if (meta.is_closing || meta.is_refreshing) {
+          std::fill(m_hit_streak.begin(), m_hit_streak.end(), 0);
+        }
+        return;
+      }
+      if (meta.is_accessing) {
+        m_hit_streak[bank_id]++;
+        s_max_hit_streak = std::max(s_max_hit_streak, m_hit_streak[bank_id]);
+      }
+      if (meta.is_opening || meta.is_closing || meta.is_refreshing) {
+        m_hit_streak[bank_id] = 0;
+      }
+    }
+
+  private:
+    // A ready row hit to a bank that has used up its cap while a request to another row waits
+    bool is_capped(const Request& req) const {
+      if (!m_dram->m_command_meta(req.command).is_accessing) {
+        return false;
+      }
+      int bank_id = m_readiness.flat_bank_id(req.addr_vec);
+      return bank_id != -1 && m_hit_streak[bank_id] >= m_cap && m_conflict_stamp[bank_id] == m_stamp;
+    }
+};
+
+}       // namespace Ramulator
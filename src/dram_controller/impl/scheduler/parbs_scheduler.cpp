@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "base/base.h"
+#include "dram_controller/controller.h"
+#include "dram_controller/scheduler.h"
+#include "frontend/frontend.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    PAR-BS: parallelism-aware batch scheduling (Mutlu and Moscibroda, ISCA 2008).
+ *
+ * @details
+ * When a buffer holds no request of its current batch, a new batch marks the marking_cap oldest requests of every
+ * (source, bank) pair in it. Sources are then ranked shortest job first: the fewest marked requests to their most
+ * loaded bank, then the fewest marked requests in total.
+ * A bank with marked requests only serves marked ones, so requests that arrive during a batch cannot delay it.
+ * Among the requests that may be served, the order is: 1) ready requests, 2) marked requests, 3) the rank of their
+ * source, 4) the earliest request.
+ * Every buffer the controller schedules from forms its own batches. Requests without a source are ranked as one more
+ * source.
+ *
+ */
+class PARBS : public IScheduler, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IScheduler, PARBS, "PARBS", "PAR-BS DRAM Scheduler.")
+  private:
+    IDRAM* m_dram;
+
+    int m_marking_cap = -1;
+
+    int m_bank_level = -1;
+    std::vector<int> m_level_sizes;     // Organization counts from the channel down to the bank level
+    int m_num_banks = 0;
+    int m_num_sources = 0;              // Number of cores, plus one for requests without a source
+
+    struct Batch {
+      ReqBuffer* buffer = nullptr;
+      int id = -1;                      // Stored in Request::scratchpad[BATCH_IDX] of the marked requests (ids start at 1)
+      std::vector<int> ranks;           // Per source index
+    };
+    std::vector<Batch> m_batches;       // One per buffer
+    int m_next_batch_id = 1;
+    std::vector<int> m_marked;          // [source index * m_num_banks + bank], scratch for forming a batch
+    std::vector<bool> m_bank_has_marked;
+
+    const int MARK_IDX = 0;
+    const int RANK_IDX = 1;
+    const int READY_IDX = 2;
+    const int BATCH_IDX = 3;
+
+    size_t s_num_batches = 0;
+
+  public:
+    void init() override {
+      m_marking_cap = param<int>("marking_cap").desc("Number of requests of each source to each bank marked in a batch.").default_val(5);
+      if (m_marking_cap <= 0) {
+        throw ConfigurationError("[Ramulator::PARBS] marking_cap must be positive!");
+      }
+    };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      m_dram = cast_parent<IDRAMController>()->m_dram;
+
+      m_bank_level = m_dram->m_levels("bank");
+      m_num_banks = 1;
+      for (int level = 0; level <= m_bank_level; level++) {
+        m_level_sizes.push_back(m_dram->m_organization.count[level]);
+        m_num_banks *= m_level_sizes.back();
+      }
+      m_num_sources = frontend->get_num_cores() + 1;
+      m_marked.resize(m_num_sources * m_num_banks);
+      m_bank_has_marked.resize(m_num_banks);
+
+      register_stat(s_num_batches).name("parbs_num_batches");
+    };
+
+    ReqBuffer::iterator compare(ReqBuffer::iterator req1, ReqBuffer::iterator req2) override {
+      bool ready1 = req1->scratchpad[READY_IDX];
+      bool ready2 = req2->scratchpad[READY_IDX];
+
+      if (ready1 ^ ready2) {
+        if (ready1) {
+          return req1;
+        } else {
+          return req2;
+        }
+      }
+
+      bool marked1 = req1->scratchpad[MARK_IDX];
+      bool marked2 = req2->scratchpad[MARK_IDX];
+
+      if (marked1 ^ marked2) {
+        if (marked1) {
+          return req1;
+        } else {
+          return req2;
+        }
+      }
+
+      int rank1 = req1->scratchpad[RANK_IDX];
+      int rank2 = req2->scratchpad[RANK_IDX];
+
+      if (rank1 != rank2) {
+        if (rank1 < rank2) {
+          return req1;
+        } else {
+          return req2;
+        }
+      }
+
+      // Fallback to FCFS
+      if (req1->arrive <= req2->arrive) {
+        return req1;
+      } else {
+        return req2;
+      }
+    }
+
+    ReqBuffer::iterator get_best_request(ReqBuffer& buffer) override {
+      if (buffer.size() == 0) {
+        return buffer.end();
+      }
+
+      Batch& batch = get_batch(buffer);
+      bool batch_done = std::none_of(buffer.begin(), buffer.end(), [&](const Request& req) { return req.scratchpad[BATCH_IDX] == batch.id; });
+      if (batch_done) {
+        form_batch(batch);
+      }
+
+      std::fill(m_bank_has_marked.begin(), m_bank_has_marked.end(), false);
+      for (auto& req : buffer) {
+        req.command = m_dram->get_preq_command(req.final_command, req.addr_vec);
+
+        req.scratchpad[MARK_IDX] = (req.scratchpad[BATCH_IDX] == batch.id);
+        req.scratchpad[RANK_IDX] = batch.ranks[source_index(req)];
+        if (req.scratchpad[MARK_IDX]) {
+          m_bank_has_marked[flat_bank_id(req.addr_vec)] = true;
+        }
+      }
+      for (auto& req : buffer) {
+        bool may_serve = req.scratchpad[MARK_IDX] || !m_bank_has_marked[flat_bank_id(req.addr_vec)];
+        req.scratchpad[READY_IDX] = may_serve && m_dram->check_ready(req.command, req.addr_vec);
+      }
+
+      auto candidate = buffer.begin();
+      for (auto next = std::next(buffer.begin(), 1); next != buffer.end(); next++) {
+        candidate = compare(candidate, next);
+      }
+      return candidate;
+    }
+
+  private:
+    Batch& get_batch(ReqBuffer& buffer) {
+      for (Batch& batch : m_batches) {
+        if (batch.buffer == &buffer) {
+          return batch;
+        }
+      }
+      m_batches.push_back({&buffer, -1, std::vector<int>(m_num_sources, 0)});
+      return m_batches.back();
+    }
+
+    void form_batch(Batch& batch) {
+      batch.id = m_next_batch_id++;
+      s_num_batches++;
+      std::fill(m_marked.begin(), m_marked.end(), 0);
+
+      // The buffer is in arrival order, so the first requests of a (source, bank) pair are its oldest ones
+      for (auto& req : *batch.buffer) {
+        int& marked = m_marked[source_index(req) * m_num_banks + flat_bank_id(req.addr_vec)];
+        if (marked < m_marking_cap) {
+          marked++;
+          req.scratchpad[BATCH_IDX] = batch.id;
+        }
+      }
+
+      // Shortest job first: the load on the most loaded bank, then the total load
+      std::vector<std::pair<int, int>> loads(m_num_sources, {0, 0});
+      for (int source = 0; source < m_num_sources; source++) {
+        for (int bank = 0; bank < m_num_banks; bank++) {
+          int marked = m_marked[source * m_num_banks + bank];
+          loads[source].first = std::max(loads[source].first, marked);
+          loads[source].second += marked;
+        }
+      }
+      std::vector<int> order(m_num_sources);
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return loads[a] < loads[b]; });
+      for (int rank = 0; rank < m_num_sources; rank++) {
+        batch.ranks[order[rank]] = rank;
+      }
+    }
+
+    // Index of the source of req in the per-source tables (0 = no source)
+    int source_index(const Request& req) const {
+      return (req.source_id >= 0 && req.source_id < m_num_sources - 1) ? req.source_id + 1 : 0;
+    }
+
+    // Flat id of the bank of addr_vec; a wildcard counts as the first node of its level
+    int flat_bank_id(const AddrVec_t& addr_vec) const {
+      int id = 0;
+      for (int level = 0; level <= m_bank_level; level++) {
+        id = id * m_level_sizes[level] + std::max(addr_vec[level], 0);
+      }
+      return id;
+    }
+};
+
+}       // namespace Ramulator
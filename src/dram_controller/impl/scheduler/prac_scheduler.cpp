@@ -15,8 +15,6 @@ private:
     IBHDRAMController* m_ctrl;
     IPRAC* m_prac;
 
-    std::unordered_map<int, int> lut_cycles_needed;
-
     Clk_t m_clk = 0;
 
     bool m_is_debug = false; 
@@ -78,10 +76,9 @@ public:
             return buffer.end();
         }
 
-        Clk_t next_recovery = m_prac->next_recovery_cycle();
         for (auto& req : buffer) {
             req.command = m_dram->get_preq_command(req.final_command, req.addr_vec);
-            req.scratchpad[FITS_IDX] = m_clk + m_prac->min_cycles_with_preall(req) < next_recovery;
+            req.scratchpad[FITS_IDX] = m_prac->fits_before_recovery(req, m_clk);
             req.scratchpad[READY_IDX] = m_dram->check_ready(req.command, req.addr_vec);
         }
 
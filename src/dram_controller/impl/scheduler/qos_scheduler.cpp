@@ -0,0 +1,116 @@
+#include <vector>
+
+#include "base/base.h"
+#include "dram_controller/controller.h"
+#include "dram_controller/scheduler.h"
+#include "dram_controller/impl/plugin/qos/qos.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Deadline-aware scheduling of per-source priority classes.
+ *
+ * @details
+ * Requests are ordered by: 1) urgent requests (close to their deadline), earliest deadline first, 2) the priority class
+ * of their source, 3) ready requests, 4) the earliest request. Classes and deadlines come from the QoS plugin.
+ *
+ */
+class QoSScheduler : public IScheduler, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IScheduler, QoSScheduler, "QoS", "Deadline-aware priority-class DRAM Scheduler.")
+  private:
+    IDRAM* m_dram;
+    IQoS* m_qos;
+
+    const int URGENT_IDX = 0;
+    const int CLASS_IDX = 1;
+    const int READY_IDX = 2;
+
+  public:
+    void init() override { };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      auto* ctrl = cast_parent<IDRAMController>();
+      m_dram = ctrl->m_dram;
+      m_qos = ctrl->get_plugin<IQoS>();
+
+      if (!m_qos) {
+        throw ConfigurationError("[Ramulator::QoSScheduler] Implementation requires QoS plugin to be active.");
+      }
+    };
+
+    ReqBuffer::iterator compare(ReqBuffer::iterator req1, ReqBuffer::iterator req2) override {
+      bool urgent1 = req1->scratchpad[URGENT_IDX];
+      bool urgent2 = req2->scratchpad[URGENT_IDX];
+
+      if (urgent1 ^ urgent2) {
+        if (urgent1) {
+          return req1;
+        } else {
+          return req2;
+        }
+      }
+
+      if (urgent1) {
+        Clk_t deadline1 = m_qos->get_deadline(*req1);
+        Clk_t deadline2 = m_qos->get_deadline(*req2);
+        if (deadline1 != deadline2) {
+          if (deadline1 < deadline2) {
+            return req1;
+          } else {
+            return req2;
+          }
+        }
+      }
+
+      int class1 = req1->scratchpad[CLASS_IDX];
+      int class2 = req2->scratchpad[CLASS_IDX];
+
+      if (class1 != class2) {
+        if (class1 < class2) {
+          return req1;
+        } else {
+          return req2;
+        }
+      }
+
+      bool ready1 = req1->scratchpad[READY_IDX];
+      bool ready2 = req2->scratchpad[READY_IDX];
+
+      if (ready1 ^ ready2) {
+        if (ready1) {
+          return req1;
+        } else {
+          return req2;
+        }
+      }
+
+      // Fallback to FCFS
+      if (req1->arrive <= req2->arrive) {
+        return req1;
+      } else {
+        return req2;
+      }
+    }
+
+    ReqBuffer::iterator get_best_request(ReqBuffer& buffer) override {
+      if (buffer.size() == 0) {
+        return buffer.end();
+      }
+
+      for (auto& req : buffer) {
+        req.command = m_dram->get_preq_command(req.final_command, req.addr_vec);
+
+        req.scratchpad[URGENT_IDX] = m_qos->is_urgent(req);
+        req.scratchpad[CLASS_IDX] = m_qos->get_class(req.source_id);
+        req.scratchpad[READY_IDX] = m_dram->check_ready(req.command, req.addr_vec);
+      }
+
+      auto candidate = buffer.begin();
+      for (auto next = std::next(buffer.begin(), 1); next != buffer.end(); next++) {
+        candidate = compare(candidate, next);
+      }
+      return candidate;
+    }
+};
+
+}       // namespace Ramulator
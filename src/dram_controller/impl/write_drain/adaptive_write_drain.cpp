@@ -0,0 +1,236 @@
+#include <vector>
+#include <algorithm>
+
+#include "base/base.h"
+#include "dram_controller/controller.h"
+#include "dram_controller/write_drain.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Drains writes in bank-parallel batches of row hits, with a bound on how long waiting reads are blocked
+ * @details
+ * A drain starts above the high watermark (or with no reads waiting) and runs in batches. A batch takes, for every bank
+ * with writes, the row with the most writes to it and up to writes_per_bank of its writes, so that the writes of a batch
+ * are spread over the banks and hit their open rows. The policy picks the batch writes to issue (ready row hits first,
+ * then the oldest ready one). After a batch, the drain goes on with another one unless reads are waiting and the write
+ * buffer is back at or below the high watermark. A drain that has blocked waiting reads for max_read_stall cycles ends
+ * early, unless the write buffer is full.
+ *
+ */
+class AdaptiveWriteDrain : public IWriteDrainPolicy, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IWriteDrainPolicy, AdaptiveWriteDrain, "Adaptive", "Bank-aware write drain in row-hit batches with a bounded read stall.")
+
+  private:
+    IDRAM* m_dram = nullptr;
+
+    float m_low_watermark = 0.2f;
+    float m_high_watermark = 0.8f;
+    int m_writes_per_bank = 4;
+    Clk_t m_max_read_stall = 0;
+
+    int m_bank_level = -1;
+    int m_row_level = -1;
+    std::vector<int> m_level_sizes;       // Organization counts from the channel down to the bank level
+
+    std::vector<int> m_batch_row;         // Row of the current batch per flat bank id (-1: none)
+    std::vector<int> m_batch_quota;       // Writes of the current batch left per flat bank id
+    int m_batch_left = 0;
+
+    Clk_t m_last_clk = 0;
+    Clk_t m_stall_start = -1;             // First cycle of this drain with reads waiting (-1: none yet)
+
+    size_t s_drain_episodes = 0;
+    size_t s_drain_batches = 0;
+    size_t s_drained_writes = 0;          // Writes issued in write mode
+    size_t s_batch_writes = 0;            // Writes issued as part of a batch
+    size_t s_read_blocked_cycles = 0;     // Cycles in write mode with reads waiting
+    size_t s_read_stall_exits = 0;        // Drains ended by max_read_stall
+    float s_avg_writes_per_drain = 0;
+
+  public:
+    void init() override {
+      m_low_watermark = param<float>("low_watermark").desc("Fill of the write buffer below which a drain ends once reads wait.").default_val(0.2f);
+      m_high_watermark = param<float>("high_watermark").desc("Fill of the write buffer above which a drain starts.").default_val(0.8f);
+      m_writes_per_bank = param<int>("writes_per_bank").desc("Writes per bank in a drain batch.").default_val(4);
+      m_max_read_stall = param<Clk_t>("max_read_stall").desc("Cycles a drain may block waiting reads before it ends (0 = unbounded).").default_val(200);
+
+      if (m_low_watermark < 0.0f || m_low_watermark > m_high_watermark || m_high_watermark > 1.0f) {
+        throw ConfigurationError("AdaptiveWriteDrain: Watermarks must satisfy 0 <= low_watermark <= high_watermark <= 1!");
+      }
+      if (m_writes_per_bank < 1) {
+        throw ConfigurationError("AdaptiveWriteDrain: writes_per_bank must be positive!");
+      }
+      if (m_max_read_stall < 0) {
+        throw ConfigurationError("AdaptiveWriteDrain: max_read_stall cannot be negative!");
+      }
+    };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override {
+      m_ctrl = cast_parent<IDRAMController>();
+      m_dram = m_ctrl->m_dram;
+
+      m_bank_level = m_dram->m_levels("bank");
+      m_row_level = m_dram->m_levels("row");
+      size_t num_banks = 1;
+      for (int level = 0; level <= m_bank_level; level++) {
+        m_level_sizes.push_back(m_dram->m_organization.count[level]);
+        num_banks *= m_level_sizes.back();
+      }
+      m_batch_row.assign(num_banks, -1);
+      m_batch_quota.assign(num_banks, 0);
+
+      register_stat(s_drain_episodes).name("write_drain_episodes");
+      register_stat(s_drain_batches).name("write_drain_batches");
+      register_stat(s_drained_writes).name("write_drain_writes");
+      register_stat(s_batch_writes).name("write_drain_batch_writes");
+      register_stat(s_read_blocked_cycles).name("write_drain_read_blocked_cycles");
+      register_stat(s_read_stall_exits).name("write_drain_read_stall_exits");
+      register_stat(s_avg_writes_per_drain).name("write_drain_avg_writes_per_drain");
+    };
+
+    bool update(Clk_t clk, const ReqBuffer& read_buffer, ReqBuffer& write_buffer) override {
+      bool reads_waiting = read_buffer.size() != 0;
+      if (m_is_write_mode && reads_waiting) {
+        s_read_blocked_cycles += clk - m_last_clk;
+      }
+      m_last_clk = clk;
+
+      if (!m_is_write_mode) {
+        if (write_buffer.size() != 0 && (write_buffer.size() > m_high_watermark * write_buffer.max_size || !reads_waiting)) {
+          m_is_write_mode = true;
+          m_stall_start = -1;
+          s_drain_episodes++;
+          start_batch(write_buffer);
+        }
+        return m_is_write_mode;
+      }
+
+      if (reads_waiting && m_stall_start < 0) {
+        m_stall_start = clk;
+      }
+      if (write_buffer.size() == 0) {
+        end_drain();
+      } else if (reads_waiting && m_max_read_stall > 0 && clk - m_stall_start >= m_max_read_stall &&
+                 write_buffer.size() < write_buffer.max_size) {
+        s_read_stall_exits++;
+        end_drain();
+      } else if (reads_waiting && write_buffer.size() < m_low_watermark * write_buffer.max_size) {
+        end_drain();
+      } else if (m_batch_left == 0) {
+        if (reads_waiting && write_buffer.size() <= m_high_watermark * write_buffer.max_size) {
+          end_drain();
+        } else {
+          start_batch(write_buffer);
+        }
+      }
+      return m_is_write_mode;
+    };
+
+    ReqBuffer::iterator get_best_write(ReqBuffer& write_buffer) override {
+      auto best = write_buffer.end();
+      bool best_ready = false;
+      bool best_hit = false;
+      for (auto it = write_buffer.begin(); it != write_buffer.end(); it++) {
+        int bank_id = flat_bank_id(it->addr_vec);
+        if (bank_id == -1 || m_batch_quota[bank_id] == 0 || m_batch_row[bank_id] != it->addr_vec[m_row_level]) {
+          continue;
+        }
+        it->command = m_dram->get_preq_command(it->final_command, it->addr_vec);
+        bool ready = m_dram->check_ready(it->command, it->addr_vec);
+        bool hit = it->command == it->final_command;
+        // The buffer is in arrival order, so the first of equal candidates is the oldest
+        if (best == write_buffer.end() || (ready && !best_ready) || (ready == best_ready && hit && !best_hit)) {
+          best = it;
+          best_ready = ready;
+          best_hit = hit;
+        }
+      }
+      if (best == write_buffer.end()) {
+        // The rest of the batch left the write buffer without being issued as a write of this drain (e.g., it was
+        // activated and waits in the active buffer); the next update() starts a new batch
+        clear_batch();
+      }
+      return best;
+    };
+
+    void on_write_issued(const Request& req) override {
+      if (m_is_write_mode) {
+        s_drained_writes++;
+      }
+      int bank_id = flat_bank_id(req.addr_vec);
+      if (bank_id != -1 && m_batch_quota[bank_id] > 0 && m_batch_row[bank_id] == req.addr_vec[m_row_level]) {
+        m_batch_quota[bank_id]--;
+        m_batch_left--;
+        s_batch_writes++;
+      }
+    };
+
+    void finalize() override {
+      s_avg_writes_per_drain = s_drain_episodes > 0 ? (float) s_drained_writes / (float) s_drain_episodes : 0.0f;
+    };
+
+  private:
+    int flat_bank_id(const AddrVec_t& addr_vec) const {
+      int id = 0;
+      for (int level = 0; level <= m_bank_level; level++) {
+        if (addr_vec[level] < 0) {
+          return -1;
+        }
+        id = id * m_level_sizes[level] + addr_vec[level];
+      }
+      return id;
+    };
+
+    /**
+     * @brief    Picks the next batch: per bank, the row with the most writes in the buffer (the older one on ties)
+     *
+     */
+    void start_batch(ReqBuffer& write_buffer) {
+      clear_batch();
+      // Writes per (bank, row) in order of first appearance, few enough for a linear search
+      struct RowWrites { int bank_id; int row; int count; };
+      std::vector<RowWrites> rows;
+      for (const Request& req : write_buffer) {
+        int bank_id = flat_bank_id(req.addr_vec);
+        if (bank_id == -1) {
+          continue;
+        }
+        int row = req.addr_vec[m_row_level];
+        auto it = std::find_if(rows.begin(), rows.end(), [&](const RowWrites& r) { return r.bank_id == bank_id && r.row == row; });
+        if (it == rows.end()) {
+          rows.push_back({bank_id, row, 1});
+        } else {
+          it->count++;
+        }
+      }
+      for (const RowWrites& r : rows) {
+        if (r.count > m_batch_quota[r.bank_id]) {
+          m_batch_row[r.bank_id] = r.row;
+          m_batch_quota[r.bank_id] = r.count;
+        }
+      }
+      for (const RowWrites& r : rows) {
+        if (m_batch_row[r.bank_id] == r.row) {
+          m_batch_quota[r.bank_id] = std::min(r.count, m_writes_per_bank);
+          m_batch_left += m_batch_quota[r.bank_id];
+        }
+      }
+      if (m_batch_left > 0) {
+        s_drain_batches++;
+      }
+    };
+
+    void clear_batch() {
+      std::fill(m_batch_row.begin(), m_batch_row.end(), -1);
+      std::fill(m_batch_quota.begin(), m_batch_quota.end(), 0);
+      m_batch_left = 0;
+    };
+
+    void end_drain() {
+      m_is_write_mode = false;
+      clear_batch();
+    };
+};
+
+}        // namespace Ramulator
@@ -11,13 +11,86 @@ namespace Ramulator {
 
 class IDRAMController;
 
+/**
+ * @brief    A command the controller issues in this cycle, decoded once for all plugins (IDRAMController::m_command_event)
+ * @details
+ * The rank, bank and row are -1 when the command is scoped above them (e.g., a rank-level refresh has no bank). The
+ * bank is flattened over the levels from the rank down to the bank, i.e., it is the bank id within the channel.
+ *
+ */
+struct CommandEvent {
+  int command = -1;
+  int scope = -1;               // The organization level the command acts on
+  bool is_opening = false;
+  bool is_closing = false;
+  bool is_refreshing = false;
+  bool is_activation = false;   // Opens a row (e.g., ACT)
+  int flat_rank = -1;
+  int flat_bank = -1;
+  int row = -1;
+  Clk_t clk = -1;
+  bool is_same_cycle = false;   // A second command in the cycle (a dual command bus issues a row and a column command)
+};
+
 class IControllerPlugin {
   RAMULATOR_REGISTER_INTERFACE(IControllerPlugin, "ControllerPlugin", "Plugins for the memory controller.");
+  public:
+    /**
+     * @brief    Which update() calls the plugin needs, declared in setup().
+     * @details
+     * By default a plugin is updated every cycle. A plugin that only reacts to issued commands clears per_cycle;
+     * the controller may then only call update(true, req_it) when it issues one of the commands (all if empty) for
+     * a request of one of the request types (all if empty). update() must still accept any call, since not every
+     * controller filters.
+     *
+     */
+    struct Subscription {
+      bool per_cycle = true;
+      std::vector<int> commands;        // Command ids of the DRAM
+      std::vector<int> request_types;   // Request::type_id
+      bool requests = false;            // Whether send() offers every incoming request to serve_request()
+    };
+
   protected:
     IDRAMController* m_ctrl = nullptr;
+    Subscription m_subscription;
 
   public:
+    /**
+     * @brief    Called every cycle (see Subscription) with the command the controller issues, if any. With a dual
+     *           command bus, the controller calls it a second time in the same cycle for a second command; plugins
+     *           that advance a clock or do other per-cycle work in update() guard it with is_new_cycle().
+     *
+     */
     virtual void update(bool request_found, ReqBuffer::iterator& req_it) = 0;
+
+    /**
+     * @brief    Whether this update() call starts a new controller cycle (i.e., is not the second command of a cycle).
+     *
+     */
+    bool is_new_cycle(bool request_found) const;
+
+    const Subscription& get_subscription() const { return m_subscription; };
+
+    /**
+     * @brief    Called by send() with an incoming request before it is buffered, if the plugin subscribed to requests.
+     *           Returns true if the plugin serves the request itself, without DRAM access, and calls its callback.
+     *
+     */
+    virtual bool serve_request(Request& req) { return false; };
+
+    /**
+     * @brief    Number of upcoming update(false, ...) calls (i.e., idle controller cycles) that are guaranteed to do
+     *           nothing but advance the plugin. 0 (the default) means the plugin has to be updated every cycle.
+     *
+     */
+    virtual Clk_t get_idle_cycles() { return 0; };
+
+    /**
+     * @brief    Advances the plugin by num_cycles idle cycles (at most get_idle_cycles()) without calling update().
+     *
+     */
+    virtual void skip_cycles(Clk_t num_cycles) { };
 };
 
 }        // namespace Ramulator
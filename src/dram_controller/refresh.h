@@ -14,6 +14,18 @@ class IRefreshManager {
 
   public:
     virtual void tick() = 0;
+
+    /**
+     * @brief    Number of upcoming ticks that are guaranteed not to send a refresh. 0 (the default) means every tick counts.
+     *
+     */
+    virtual Clk_t get_idle_cycles() { return 0; };
+
+    /**
+     * @brief    Advances the refresh manager by num_cycles ticks (at most get_idle_cycles()) without ticking it.
+     *
+     */
+    virtual void skip_cycles(Clk_t num_cycles) { };
 };
 
 }        // namespace Ramulator
@@ -14,8 +14,31 @@ class IRowPolicy {
   protected:
     IDRAMController* m_ctrl = nullptr;
 
+  public:
+    // Row-buffer outcome of the first command of a read or write request
+    enum class RowAccess { Hit, Miss, Conflict };
+
   public:
     virtual void update(bool request_found, ReqBuffer::iterator& req_it) = 0;
+
+    /**
+     * @brief    Called once per read or write request, before its first command is issued, with the outcome the
+     *           controller counts in its row hit/miss/conflict statistics.
+     *
+     */
+    virtual void on_row_access(const Request& req, RowAccess access) { };
+
+    /**
+     * @brief    Number of upcoming update(false, ...) calls that are guaranteed to do nothing (see IControllerPlugin).
+     *
+     */
+    virtual Clk_t get_idle_cycles() { return 0; };
+
+    /**
+     * @brief    Advances the row policy by num_cycles idle cycles (at most get_idle_cycles()) without calling update().
+     *
+     */
+    virtual void skip_cycles(Clk_t num_cycles) { };
 };
 
 }        // namespace Ramulator
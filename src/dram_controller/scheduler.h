@@ -16,6 +16,13 @@ class IScheduler {
     virtual ReqBuffer::iterator compare(ReqBuffer::iterator req1, ReqBuffer::iterator req2) = 0;
 
     virtual ReqBuffer::iterator get_best_request(ReqBuffer& buffer) = 0;
+
+    /**
+     * @brief    Called by the Generic controller with each request whose command (req.command) it issues, for
+     *           schedulers that keep a history of the issued commands.
+     *
+     */
+    virtual void on_command_issued(const Request& req) { };
 };
 
 }       // namespace Ramulator
@@ -0,0 +1,53 @@
+#ifndef     RAMULATOR_CONTROLLER_WRITE_DRAIN_H
+#define     RAMULATOR_CONTROLLER_WRITE_DRAIN_H
+
+#include <vector>
+#include <string>
+
+#include "base/base.h"
+
+
+namespace Ramulator {
+
+class IDRAMController;
+
+/**
+ * @brief    Decides when a controller serves its write buffer instead of its read buffer, and which writes it drains.
+ * @details
+ * Optional: without a WriteDrainPolicy in its config, a controller switches modes at its wr_low_watermark and
+ * wr_high_watermark.
+ *
+ */
+class IWriteDrainPolicy {
+  RAMULATOR_REGISTER_INTERFACE(IWriteDrainPolicy, "WriteDrainPolicy", "Write Drain Policy Interface.");
+  protected:
+    IDRAMController* m_ctrl = nullptr;
+    bool m_is_write_mode = false;
+
+  public:
+    bool is_write_mode() const { return m_is_write_mode; };
+
+    /**
+     * @brief    Called in the cycles the controller schedules from its read or write buffer. Returns whether to serve
+     *           the write buffer.
+     *
+     */
+    virtual bool update(Clk_t clk, const ReqBuffer& read_buffer, ReqBuffer& write_buffer) = 0;
+
+    /**
+     * @brief    The write to serve in write mode, or write_buffer.end() to leave the choice to the scheduler.
+     *
+     */
+    virtual ReqBuffer::iterator get_best_write(ReqBuffer& write_buffer) { return write_buffer.end(); };
+
+    /**
+     * @brief    Called when the last command of a write is issued, from whichever buffer of the controller.
+     *
+     */
+    virtual void on_write_issued(const Request& req) { };
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_CONTROLLER_WRITE_DRAIN_H
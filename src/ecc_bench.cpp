@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <argparse/argparse.hpp>
+#include <spdlog/spdlog.h>
+
+#include "base/exception.h"
+#include "dram_controller/impl/plugin/ecc/bch_codec.h"
+#include "dram_controller/impl/plugin/ecc/edc_engine.h"
+#include "dram_controller/impl/plugin/ecc/rs_codec.h"
+
+// Stand-alone micro-benchmark of the ECCPlugin codecs: EDC engines, RS and BCH encode, and decode with 0..t errors.
+// Every measurement runs warmup batches, then times one batch of codewords per sample.
+
+namespace {
+
+using namespace Ramulator;
+
+struct Options {
+  std::vector<size_t> sizes;
+  std::vector<std::string> codecs;
+  size_t edc_size = 4;
+  int t = 4;
+  int warmup = 3;
+  int samples = 30;
+  int batch = 64;
+  bool simd = true;
+  bool specialized = true;
+  uint64_t seed = 0;
+};
+
+struct Result {
+  std::string codec;
+  std::string kernel;
+  std::string op;
+  size_t bytes = 0;       // Bytes covered by one codeword (the EDC input, or [Data + EDC] for the ECCs)
+  int t = 0;
+  int errors = 0;
+  int failures = 0;       // Decodes that did not return the injected codeword
+  std::vector<double> ns; // ns per codeword of every sample
+
+  double percentile(double p) const {
+    std::vector<double> sorted = ns;
+    std::sort(sorted.begin(), sorted.end());
+    size_t idx = std::min(sorted.size() - 1, (size_t) (p / 100.0 * (sorted.size() - 1) + 0.5));
+    return sorted[idx];
+  };
+  double min() const { return *std::min_element(ns.begin(), ns.end()); };
+  double gbps() const { return bytes / percentile(50); };
+};
+
+volatile uint64_t g_sink = 0;   // Keeps the EDC results alive
+
+// Times run(i) over i in [0, batch) once per sample, after the warmup batches. prepare() runs untimed before every batch
+void measure(const Options& opt, Result& result, const std::function<void()>& prepare, const std::function<void(int)>& run) {
+  for (int s = 0; s < opt.warmup + opt.samples; s++) {
+    prepare();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < opt.batch; i++) {
+      run(i);
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (s >= opt.warmup) {
+      result.ns.push_back(std::chrono::duration<double, std::nano>(end - start).count() / opt.batch);
+    }
+  }
+}
+
+// A batch of random codewords of one size
+struct Pool {
+  size_t bytes;
+  std::vector<uint8_t> data;
+
+  Pool(size_t bytes, int count, std::mt19937_64& rng): bytes(bytes), data(bytes * count) {
+    for (uint8_t& b : data) {
+      b = rng();
+    }
+  };
+
+  std::span<uint8_t> operator[](int i) { return {data.data() + i * bytes, bytes}; };
+};
+
+// Distinct positions in [0, range)
+std::vector<size_t> pick_positions(size_t range, int count, std::mt19937_64& rng) {
+  std::vector<size_t> positions;
+  while ((int) positions.size() < count) {
+    size_t p = rng() % range;
+    if (std::find(positions.begin(), positions.end(), p) == positions.end()) {
+      positions.push_back(p);
+    }
+  }
+  return positions;
+}
+
+void bench_edc(const Options& opt, const std::string& type, std::mt19937_64& rng, std::vector<Result>& results) {
+  std::unique_ptr<IEDCEngine> engine = IEDCEngine::create(type, opt.simd);
+  for (size_t size : opt.sizes) {
+    Pool pool(size, opt.batch, rng);
+    Result r{type, engine->name(), "edc", size};
+    measure(opt, r, [] {}, [&](int i) { g_sink = g_sink + engine->compute(pool[i]); });
+    results.push_back(std::move(r));
+  }
+}
+
+// Encode, then decode with 0..t+1 errors (symbol errors for RS, bit errors for BCH) injected into [Data + EDC]
+template<typename Codec>
+void bench_ecc(const Options& opt, const std::string& type, const Codec& codec, size_t bytes, std::mt19937_64& rng, std::vector<Result>& results) {
+  const size_t parity_bytes = codec.parity_bytes();
+  Pool pool(bytes, opt.batch, rng);
+  std::vector<uint8_t> parity(parity_bytes * opt.batch);
+  auto parity_of = [&](std::vector<uint8_t>& buf, int i) { return std::span<uint8_t>(buf.data() + i * parity_bytes, parity_bytes); };
+
+  Result enc{type, codec.kernel_name(), "encode", bytes, opt.t};
+  measure(opt, enc, [] {}, [&](int i) { codec.encode(pool[i], parity_of(parity, i)); });
+  results.push_back(std::move(enc));
+
+  Pool work(bytes, opt.batch, rng);
+  std::vector<uint8_t> work_parity(parity.size());
+  for (int e = 0; e <= opt.t + 1; e++) {
+    Result dec{type, codec.kernel_name(), "decode", bytes, opt.t, e};
+    int decoded = 0;
+    auto prepare = [&] {
+      work.data = pool.data;
+      work_parity = parity;
+      for (int i = 0; i < opt.batch; i++) {
+        for (size_t p : pick_positions(type == "bch" ? bytes * 8 : bytes, e, rng)) {
+          if (type == "bch") {
+            work[i][p / 8] ^= 0x80 >> (p % 8);
+          } else {
+            work[i][p] ^= 1 + rng() % 255;
+          }
+        }
+      }
+    };
+    auto check = [&] {
+      for (int i = 0; i < opt.batch; i++) {
+        bool restored = std::equal(work[i].begin(), work[i].end(), pool[i].begin());
+        if ((e <= opt.t) != restored) {
+          dec.failures++;
+        }
+      }
+    };
+    measure(opt, dec, [&] { if (decoded++ > 0) check(); prepare(); }, [&](int i) { codec.decode(work[i], parity_of(work_parity, i)); });
+    check();
+    results.push_back(std::move(dec));
+  }
+}
+
+void print_text(const std::vector<Result>& results) {
+  fmt::print("{:<9} {:<16} {:<7} {:>6} {:>3} {:>4} {:>12} {:>12} {:>12} {:>12} {:>9} {:>5}\n",
+             "codec", "kernel", "op", "bytes", "t", "err", "min_ns", "median_ns", "p90_ns", "p99_ns", "GB/s", "fail");
+  for (const Result& r : results) {
+    fmt::print("{:<9} {:<16} {:<7} {:>6} {:>3} {:>4} {:>12.1f} {:>12.1f} {:>12.1f} {:>12.1f} {:>9.3f} {:>5}\n",
+               r.codec, r.kernel, r.op, r.bytes, r.t, r.errors, r.min(), r.percentile(50), r.percentile(90), r.percentile(99), r.gbps(), r.failures);
+  }
+}
+
+void print_json(const Options& opt, const std::vector<Result>& results) {
+  fmt::print("{{\n  \"config\": {{\"warmup\": {}, \"samples\": {}, \"batch\": {}, \"edc_size\": {}, \"t\": {}, \"simd\": {}, \"kernels\": \"{}\", \"seed\": {}}},\n",
+             opt.warmup, opt.samples, opt.batch, opt.edc_size, opt.t, opt.simd, opt.specialized ? "auto" : "generic", opt.seed);
+  fmt::print("  \"results\": [\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result& r = results[i];
+    fmt::print("    {{\"codec\": \"{}\", \"kernel\": \"{}\", \"op\": \"{}\", \"bytes\": {}, \"t\": {}, \"errors\": {}, \"failures\": {}, "
+               "\"ns_per_codeword\": {{\"min\": {:.2f}, \"p50\": {:.2f}, \"p90\": {:.2f}, \"p99\": {:.2f}}}, \"gb_per_s\": {:.4f}}}{}\n",
+               r.codec, r.kernel, r.op, r.bytes, r.t, r.errors, r.failures, r.min(), r.percentile(50), r.percentile(90), r.percentile(99),
+               r.gbps(), (i + 1 < results.size()) ? "," : "");
+  }
+  fmt::print("  ]\n}}\n");
+}
+
+}       // namespace
+
+
+int main(int argc, char* argv[]) {
+  argparse::ArgumentParser program("ramulator_ecc_bench", "2.0");
+  program.add_argument("-s", "--sizes").nargs(argparse::nargs_pattern::at_least_one).scan<'u', size_t>()
+    .default_value(std::vector<size_t>{128, 512, 1024, 4096})
+    .help("Data block sizes in bytes.");
+  program.add_argument("-c", "--codecs").nargs(argparse::nargs_pattern::at_least_one)
+    .default_value(std::vector<std::string>{"checksum", "crc32", "crc32c", "crc64", "rs", "bch"})
+    .help("Codecs to run: checksum, crc32, crc32c, crc64 (EDC), rs, bch (ECC).");
+  program.add_argument("-t").scan<'i', int>().default_value(4)
+    .help("Correctable errors of the ECCs; decodes are measured with 0..t+1 injected errors.");
+  program.add_argument("--edc_size").scan<'u', size_t>().default_value((size_t) 4)
+    .help("EDC bytes appended to every data block before the ECC.");
+  program.add_argument("--warmup").scan<'i', int>().default_value(3)
+    .help("Untimed batches before the samples.");
+  program.add_argument("--samples").scan<'i', int>().default_value(30)
+    .help("Timed batches per measurement.");
+  program.add_argument("--batch").scan<'i', int>().default_value(64)
+    .help("Codewords per batch.");
+  program.add_argument("--kernels").default_value(std::string("auto"))
+    .help("RS/BCH kernels: auto (specialized where available) or generic.");
+  program.add_argument("--no_simd").default_value(false).implicit_value(true)
+    .help("Use the portable EDC kernels.");
+  program.add_argument("--seed").scan<'u', uint64_t>().default_value((uint64_t) 0)
+    .help("Seed of the generated codewords and error positions.");
+  program.add_argument("--json").default_value(false).implicit_value(true)
+    .help("Print the results as JSON.");
+
+  Options opt;
+  try {
+    program.parse_args(argc, argv);
+    opt.sizes = program.get<std::vector<size_t>>("--sizes");
+    opt.codecs = program.get<std::vector<std::string>>("--codecs");
+    opt.t = program.get<int>("-t");
+    opt.edc_size = program.get<size_t>("--edc_size");
+    opt.warmup = program.get<int>("--warmup");
+    opt.samples = program.get<int>("--samples");
+    opt.batch = program.get<int>("--batch");
+    opt.simd = !program.get<bool>("--no_simd");
+    opt.seed = program.get<uint64_t>("--seed");
+    std::string kernels = program.get<std::string>("--kernels");
+    if (kernels != "auto" && kernels != "generic") {
+      throw std::runtime_error(fmt::format("Unsupported kernels \"{}\" (expected auto or generic)!", kernels));
+    }
+    opt.specialized = (kernels == "auto");
+    if (opt.samples < 1 || opt.batch < 1 || opt.warmup < 0 || opt.t < 0) {
+      throw std::runtime_error("samples and batch must be positive, warmup and t non-negative!");
+    }
+  }
+  catch (const std::runtime_error& err) {
+    spdlog::error(err.what());
+    std::cerr << program;
+    std::exit(1);
+  }
+
+  std::mt19937_64 rng(opt.seed);
+  RSCodecCache rs_codecs(opt.specialized);
+  BCHCodecCache bch_codecs(opt.specialized);
+  std::vector<Result> results;
+  try {
+    for (const std::string& codec : opt.codecs) {
+      if (codec == "rs" || codec == "bch") {
+        for (size_t size : opt.sizes) {
+          size_t bytes = size + opt.edc_size;
+          if (codec == "rs") {
+            int m = RSCodecCache::min_symbol_bits(bytes, opt.t);
+            if (m < 0) {
+              throw ConfigurationError("No supported RS symbol width can hold a {}B codeword with t = {}!", bytes, opt.t);
+            }
+            bench_ecc(opt, codec, rs_codecs.get(m, opt.t), bytes, rng, results);
+          } else {
+            int m = BCHCodecCache::min_field_bits(bytes * 8, opt.t);
+            if (m < 0) {
+              throw ConfigurationError("No supported BCH field can hold a {}B codeword with t = {}!", bytes, opt.t);
+            }
+            bench_ecc(opt, codec, bch_codecs.get(m, opt.t), bytes, rng, results);
+          }
+        }
+      } else {
+        bench_edc(opt, codec, rng, results);
+      }
+    }
+  }
+  catch (const std::runtime_error& err) {
+    spdlog::error(err.what());
+    std::exit(1);
+  }
+
+  if (program.get<bool>("--json")) {
+    print_json(opt, results);
+  } else {
+    print_text(results);
+  }
+  return 0;
+}
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <argparse/argparse.hpp>
+#include <spdlog/spdlog.h>
+
+#include "base/exception.h"
+#include "dram_controller/impl/plugin/ecc/error_event_log.h"
+
+// Aggregates the ECC error event logs of a simulation (ECCPlugin error_log, one per channel) by address region, by bank
+// and by time window, to find where and when the errors occurred.
+
+namespace {
+
+using namespace Ramulator;
+
+struct Counts {
+  size_t events = 0;
+  size_t corrected = 0;
+  size_t uncorrectable = 0;
+  size_t scrub = 0;
+  size_t fault = 0;
+  uint64_t errors = 0;
+
+  void add(const ErrorEventLog::Record& record) {
+    events++;
+    corrected += record.outcome == ErrorEventLog::Outcome::Corrected;
+    uncorrectable += record.outcome == ErrorEventLog::Outcome::Uncorrectable;
+    scrub += record.source == ErrorEventLog::Source::Scrub;
+    fault += (record.flags & ErrorEventLog::FLAG_FAULT) != 0;
+    errors += record.errors;
+  };
+};
+
+void print_header(const std::string& key) {
+  fmt::print("{:<28} {:>10} {:>10} {:>10} {:>8} {:>8} {:>12}\n", key, "events", "corrected", "uncorr", "scrub", "fault", "errors");
+}
+
+void print_row(const std::string& key, const Counts& counts) {
+  fmt::print("{:<28} {:>10} {:>10} {:>10} {:>8} {:>8} {:>12}\n", key, counts.events, counts.corrected, counts.uncorrectable,
+             counts.scrub, counts.fault, counts.errors);
+}
+
+// The top entries by uncorrectable events, then by events, then in key order
+template<typename Key>
+std::vector<std::pair<Key, Counts>> top(const std::map<Key, Counts>& groups, size_t num_top) {
+  std::vector<std::pair<Key, Counts>> sorted(groups.begin(), groups.end());
+  std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+    return std::tie(a.second.uncorrectable, a.second.events) > std::tie(b.second.uncorrectable, b.second.events);
+  });
+  if (num_top > 0 && sorted.size() > num_top) {
+    sorted.resize(num_top);
+  }
+  return sorted;
+}
+
+}       // namespace
+
+
+int main(int argc, char* argv[]) {
+  argparse::ArgumentParser program("ramulator_ecc_events", "2.0");
+  program.add_argument("logs").nargs(argparse::nargs_pattern::at_least_one)
+    .help("ECC error event logs (e.g., errors.bin.ch0 errors.bin.ch1).");
+  program.add_argument("--region_bytes").scan<'i', int64_t>().default_value(int64_t(1 << 20))
+    .help("Bytes of the address regions the events are grouped by.");
+  program.add_argument("--window").scan<'i', int64_t>().default_value(int64_t(0))
+    .help("Cycles of the time windows the events are grouped by (0 = no time windows).");
+  program.add_argument("--top").scan<'i', int64_t>().default_value(int64_t(10))
+    .help("Regions and banks listed, most uncorrectable events first (0 = all).");
+
+  std::vector<std::string> paths;
+  int64_t region_bytes, window, num_top;
+  try {
+    program.parse_args(argc, argv);
+    paths = program.get<std::vector<std::string>>("logs");
+    region_bytes = program.get<int64_t>("--region_bytes");
+    window = program.get<int64_t>("--window");
+    num_top = program.get<int64_t>("--top");
+    if (region_bytes <= 0 || window < 0 || num_top < 0) {
+      throw std::runtime_error("region_bytes must be positive, window and top cannot be negative!");
+    }
+  }
+  catch (const std::runtime_error& err) {
+    spdlog::error(err.what());
+    std::cerr << program;
+    std::exit(1);
+  }
+
+  try {
+    Counts total;
+    std::map<int, Counts> channels;
+    std::map<Addr_t, Counts> regions;
+    std::map<std::pair<int, uint32_t>, Counts> banks;
+    std::map<Clk_t, Counts> windows;
+    std::string units;
+    for (const std::string& path : paths) {
+      ErrorEventLog::Reader reader(path);
+      std::string unit = reader.unit() == ErrorEventLog::ErrorUnit::Bits ? "bits" : "symbols";
+      if (!units.empty() && units != unit) {
+        spdlog::warn("{} counts its errors in {}, the logs before it in {}.", path, unit, units);
+      }
+      units = unit;
+
+      ErrorEventLog::Record record;
+      while (reader.next(record)) {
+        total.add(record);
+        channels[record.channel].add(record);
+        regions[record.addr / region_bytes].add(record);
+        banks[{record.channel, record.bank}].add(record);
+        if (window > 0) {
+          windows[record.clk / window].add(record);
+        }
+      }
+      spdlog::info("Read {} events of channel {} from {}.", reader.num_records(), reader.channel(), path);
+    }
+
+    fmt::print("Errors are counted in {}.\n\n", units.empty() ? "bits" : units);
+    print_header("channel");
+    for (const auto& [channel, counts] : channels) {
+      print_row(fmt::format("{}", channel), counts);
+    }
+    print_row("total", total);
+
+    fmt::print("\n");
+    print_header(fmt::format("region ({} B)", region_bytes));
+    for (const auto& [region, counts] : top(regions, num_top)) {
+      print_row(fmt::format("{:#x}", region * region_bytes), counts);
+    }
+
+    fmt::print("\n");
+    print_header("channel/bank");
+    for (const auto& [bank, counts] : top(banks, num_top)) {
+      print_row(fmt::format("{}/{}", bank.first, bank.second), counts);
+    }
+
+    if (window > 0) {
+      fmt::print("\n");
+      print_header(fmt::format("window ({} cycles)", window));
+      for (const auto& [index, counts] : windows) {
+        print_row(fmt::format("{}", index * window), counts);
+      }
+    }
+  }
+  catch (const std::runtime_error& err) {
+    spdlog::error(err.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <argparse/argparse.hpp>
+#include <spdlog/spdlog.h>
+
+#include "base/exception.h"
+#include "dram_controller/impl/plugin/ecc/reliability_estimator.h"
+
+// Stand-alone reliability estimator: expected ECCPlugin counters for a list of raw bit error rates and ECC sizes,
+// from the access histogram saved by one timing-mode run (access_histogram: true).
+
+namespace {
+
+using namespace Ramulator;
+
+void print_text(const std::vector<ReliabilityEstimate>& estimates) {
+  fmt::print("{:<12} {:>10} {:>4} {:>3} {:>14} {:>14} {:>14} {:>14} {:>12}\n",
+             "policy", "ber", "ecc", "t", "edc_success", "edc_failure", "ecc_success", "ecc_failure", "p_uncorr");
+  for (const ReliabilityEstimate& e : estimates) {
+    fmt::print("{:<12} {:>10.3e} {:>4} {:>3} {:>14.2f} {:>14.2f} {:>14.2f} {:>14.4e} {:>12.4e}\n",
+               e.policy, e.bit_error_rate, e.ecc_size, e.t, e.edc_success, e.edc_failure, e.ecc_success, e.ecc_failure, e.uncorrectable_prob);
+  }
+}
+
+void print_json(const std::vector<ReliabilityEstimate>& estimates) {
+  fmt::print("{{\n  \"estimates\": [\n");
+  for (size_t i = 0; i < estimates.size(); i++) {
+    const ReliabilityEstimate& e = estimates[i];
+    fmt::print("    {{\"policy\": \"{}\", \"bit_error_rate\": {:e}, \"ecc_size\": {}, \"t\": {}, \"edc_success_count\": {:.6e}, "
+               "\"edc_failure_count\": {:.6e}, \"ecc_success_count\": {:.6e}, \"ecc_failure_count\": {:.6e}, \"uncorrectable_prob\": {:.6e}}}{}\n",
+               e.policy, e.bit_error_rate, e.ecc_size, e.t, e.edc_success, e.edc_failure, e.ecc_success, e.ecc_failure,
+               e.uncorrectable_prob, (i + 1 < estimates.size()) ? "," : "");
+  }
+  fmt::print("  ]\n}}\n");
+}
+
+}       // namespace
+
+
+int main(int argc, char* argv[]) {
+  argparse::ArgumentParser program("ramulator_ecc_reliability", "2.0");
+  program.add_argument("-f", "--histogram").default_value(std::string("ecc_access_histogram.yaml"))
+    .help("Access histogram saved by ECCPlugin.");
+  program.add_argument("-b", "--bers").nargs(argparse::nargs_pattern::at_least_one).scan<'g', double>()
+    .default_value(std::vector<double>{1e-7, 1e-6, 1e-5, 1e-4})
+    .help("Raw bit error rates.");
+  program.add_argument("-e", "--ecc_sizes").nargs(argparse::nargs_pattern::at_least_one).scan<'i', int>()
+    .default_value(std::vector<int>{0})
+    .help("Configured ECC sizes in bytes (0 = the one of the run).");
+  program.add_argument("--json").default_value(false).implicit_value(true)
+    .help("Print the results as JSON.");
+
+  std::string filename;
+  std::vector<double> bers;
+  std::vector<int> ecc_sizes;
+  try {
+    program.parse_args(argc, argv);
+    filename = program.get<std::string>("--histogram");
+    bers = program.get<std::vector<double>>("--bers");
+    ecc_sizes = program.get<std::vector<int>>("--ecc_sizes");
+    for (double ber : bers) {
+      if (ber < 0.0 || ber >= 1.0) {
+        throw std::runtime_error(fmt::format("Bit error rate {} is not in [0, 1)!", ber));
+      }
+    }
+    for (int ecc_size : ecc_sizes) {
+      if (ecc_size < 0) {
+        throw std::runtime_error("ECC sizes must be non-negative!");
+      }
+    }
+  }
+  catch (const std::runtime_error& err) {
+    spdlog::error(err.what());
+    std::cerr << program;
+    std::exit(1);
+  }
+
+  try {
+    std::vector<ReliabilityEstimate> estimates = ReliabilityEstimator::estimate(ReliabilityEstimator::load(filename), bers, ecc_sizes);
+    if (program.get<bool>("--json")) {
+      print_json(estimates);
+    } else {
+      print_text(estimates);
+    }
+  }
+  catch (const std::runtime_error& err) {
+    spdlog::error(err.what());
+    return 1;
+  }
+  return 0;
+}
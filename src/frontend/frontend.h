@@ -11,6 +11,25 @@
 
 namespace Ramulator {
 
+/**
+ * @brief    A request submitted by an external simulator in a batch. The tag comes back with its completion.
+ *
+ */
+struct ExternalRequest {
+  int type_id = Request::Type::Read;
+  Addr_t addr = -1;
+  int source_id = 0;
+  uint64_t tag = 0;
+};
+
+struct ExternalCompletion {
+  uint64_t tag = 0;
+  int type_id = -1;
+  Addr_t addr = -1;
+  Clk_t arrive = -1;    // As in the Request
+  Clk_t depart = -1;
+};
+
 class IFrontEnd : public Clocked<IFrontEnd>, public TopLevel<IFrontEnd> {
   RAMULATOR_REGISTER_INTERFACE(IFrontEnd, "Frontend", "The frontend that drives the simulation.");
 
@@ -19,6 +38,7 @@ class IFrontEnd : public Clocked<IFrontEnd>, public TopLevel<IFrontEnd> {
   protected:
     IMemorySystem* m_memory_system;
     uint m_clock_ratio = 1;
+    std::ostream* m_stats_out = &std::cout;
 
   public:
     virtual void connect_memory_system(IMemorySystem* memory_system) { 
@@ -40,9 +60,15 @@ class IFrontEnd : public Clocked<IFrontEnd>, public TopLevel<IFrontEnd> {
       emitter << YAML::BeginMap;
       m_impl->print_stats(emitter);
       emitter << YAML::EndMap;
-      std::cout << emitter.c_str() << std::endl;
+      *m_stats_out << emitter.c_str() << std::endl;
     };
 
+    /**
+     * @brief    Sets where finalize() prints the statistics (std::cout by default)
+     * 
+     */
+    void set_stats_output(std::ostream& stats_out) { m_stats_out = &stats_out; };
+
     virtual int get_num_cores() { return 1; };
 
     int get_clock_ratio() { return m_clock_ratio; };
@@ -55,7 +81,20 @@ class IFrontEnd : public Clocked<IFrontEnd>, public TopLevel<IFrontEnd> {
      * (tries to) send to the memory system, and return if this is successful
      * 
      */
-    virtual bool receive_external_requests(int req_type_id, Addr_t addr, int source_id, std::function<void(Request&)> callback) { return false; }
+    virtual bool receive_external_requests(int req_type_id, Addr_t addr, int source_id, RequestCallback callback) { return false; }
+
+    /**
+     * @brief    Sends a batch of external requests to the memory system, in order, and returns how many were accepted
+     *           (the rest, from the first refused one on, should be submitted again later).
+     *
+     */
+    virtual size_t submit_external_requests(const ExternalRequest* requests, size_t num_requests) { return 0; }
+
+    /**
+     * @brief    Copies up to max_completions completions of the submitted requests, oldest first, and returns how many.
+     *
+     */
+    virtual size_t poll_external_completions(ExternalCompletion* completions, size_t max_completions) { return 0; }
 };
 
 }        // namespace Ramulator
@@ -11,16 +11,89 @@ namespace Ramulator {
 class GEM5 : public IFrontEnd, public Implementation {
   RAMULATOR_REGISTER_IMPLEMENTATION(IFrontEnd, GEM5, "GEM5", "GEM5 frontend.")
 
+  private:
+    // Completions of the batched reads, waiting to be polled. Every read in flight has a slot reserved, so the ring
+    // never overflows: a batch stops at the first read that would not have one.
+    std::vector<ExternalCompletion> m_completions;
+    size_t m_completions_head = 0;
+    size_t m_num_completions = 0;
+    size_t m_num_reads_in_flight = 0;     // Including the completions not polled yet
+
+    size_t s_num_batches = 0;
+    size_t s_num_batched_requests = 0;
+    size_t s_num_refused_requests = 0;
+    size_t s_max_reads_in_flight = 0;
+
   public:
-    void init() override { };
-    void tick() override { };
+    void init() override {
+      int ring_size = param<int>("completion_ring_size").desc("Completions buffered between polls of the batched API, which bounds the batched reads in flight.").default_val(4096);
+      if (ring_size <= 0) {
+        throw ConfigurationError("GEM5: completion_ring_size must be positive (got {})!", ring_size);
+      }
+      m_completions.resize(ring_size);
+
+      register_stat(s_num_batches).name("num_batches");
+      register_stat(s_num_batched_requests).name("num_batched_requests");
+      register_stat(s_num_refused_requests).name("num_refused_requests");
+      register_stat(s_max_reads_in_flight).name("max_reads_in_flight");
+    };
+
+    void tick() override {
+      m_clk++;
+    };
 
-    bool receive_external_requests(int req_type_id, Addr_t addr, int source_id, std::function<void(Request&)> callback) override {
+    bool receive_external_requests(int req_type_id, Addr_t addr, int source_id, RequestCallback callback) override {
       return m_memory_system->send({addr, req_type_id, source_id, callback});
     }
 
+    // Reads complete through the ring. The memory system does not report writes, which are done once accepted.
+    size_t submit_external_requests(const ExternalRequest* requests, size_t num_requests) override {
+      s_num_batches++;
+      size_t num_accepted = 0;
+      for (; num_accepted < num_requests; num_accepted++) {
+        const ExternalRequest& request = requests[num_accepted];
+        bool is_read = request.type_id == Request::Type::Read;
+        if (is_read && m_num_reads_in_flight == m_completions.size()) {
+          break;
+        }
+
+        RequestCallback callback = nullptr;
+        if (is_read) {
+          callback = [this, tag = request.tag](Request& req) { complete(tag, req); };
+        }
+        if (!m_memory_system->send({request.addr, request.type_id, request.source_id, callback})) {
+          break;
+        }
+        if (is_read) {
+          m_num_reads_in_flight++;
+          s_max_reads_in_flight = std::max(s_max_reads_in_flight, m_num_reads_in_flight);
+        }
+      }
+      s_num_batched_requests += num_accepted;
+      s_num_refused_requests += num_requests - num_accepted;
+      return num_accepted;
+    };
+
+    size_t poll_external_completions(ExternalCompletion* completions, size_t max_completions) override {
+      size_t num_polled = std::min(max_completions, m_num_completions);
+      for (size_t i = 0; i < num_polled; i++) {
+        completions[i] = m_completions[m_completions_head];
+        m_completions_head = (m_completions_head + 1) % m_completions.size();
+      }
+      m_num_completions -= num_polled;
+      m_num_reads_in_flight -= num_polled;
+      return num_polled;
+    };
+
   private:
-    bool is_finished() override { return true; };
+    void complete(uint64_t tag, const Request& req) {
+      size_t slot = (m_completions_head + m_num_completions) % m_completions.size();
+      m_completions[slot] = {tag, req.type_id, req.addr, req.arrive, req.depart};
+      m_num_completions++;
+    };
+
+    // Finished when every batched read has completed and been polled
+    bool is_finished() override { return m_num_reads_in_flight == 0; };
 };
 
-}        // namespace Ramulator
\ No newline at end of file
+}        // namespace Ramulator
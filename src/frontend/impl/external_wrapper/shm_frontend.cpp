@@ -0,0 +1,164 @@
+#include <new>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "frontend/frontend.h"
+#include "frontend/impl/external_wrapper/shm_ring.h"
+#include "base/exception.h"
+
+namespace Ramulator {
+
+class SharedMemory : public IFrontEnd, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IFrontEnd, SharedMemory, "SharedMemory", "Requests from other processes through shared-memory rings.")
+
+  private:
+    struct Producer {
+      std::string name;
+      ShmRing::ShmChannel* channel = nullptr;
+      size_t size = 0;
+      // Reads sent to the memory system whose completions are not published yet. Together with the completions not
+      // consumed yet, they hold completion slots, so a read is only taken from the ring if a slot is left for it.
+      size_t num_reads_in_flight = 0;
+    };
+    std::vector<Producer> m_producers;
+
+    int m_max_requests_per_tick = 0;
+
+    size_t s_num_read_requests = 0;
+    size_t s_num_write_requests = 0;
+    size_t s_num_send_retries = 0;
+
+    Logger_t m_logger;
+
+  public:
+    void init() override {
+      m_clock_ratio = param<uint>("clock_ratio").default_val(1);
+
+      std::string name = param<std::string>("shm_name").desc("Name of the shared-memory channels; channel i is <shm_name>_<i>.").default_val("/ramulator");
+      int num_producers = param<int>("num_producers").desc("Number of producer processes, each with its own channel.").default_val(1);
+      int num_slots = param<int>("ring_slots").desc("Slots of the request ring and of the completion ring of every channel.").default_val(4096);
+      m_max_requests_per_tick = param<int>("max_requests_per_tick").desc("Requests taken from each channel per frontend cycle.").default_val(16);
+
+      if (num_producers <= 0 || num_slots <= 0 || m_max_requests_per_tick <= 0) {
+        throw ConfigurationError("SharedMemory: num_producers, ring_slots and max_requests_per_tick must be positive!");
+      }
+
+#if defined(_WIN32)
+      throw ConfigurationError("SharedMemory frontend needs POSIX shared memory!");
+#else
+      for (int i = 0; i < num_producers; i++) {
+        Producer& producer = m_producers.emplace_back();
+        producer.name = fmt::format("{}_{}", name, i);
+        producer.size = ShmRing::channel_size(num_slots);
+
+        int fd = shm_open(producer.name.c_str(), O_CREAT | O_RDWR, 0600);
+        if (fd == -1 || ftruncate(fd, producer.size) == -1) {
+          if (fd != -1) {
+            close(fd);
+          }
+          throw ConfigurationError("SharedMemory: cannot create the shared-memory channel {}!", producer.name);
+        }
+        void* data = mmap(nullptr, producer.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+          throw ConfigurationError("SharedMemory: cannot map the shared-memory channel {}!", producer.name);
+        }
+
+        // A stale channel of an earlier run is reset
+        ShmRing::ShmChannel* channel = new (data) ShmRing::ShmChannel{};
+        channel->magic = ShmRing::MAGIC;
+        channel->version = ShmRing::VERSION;
+        channel->num_slots = num_slots;
+        channel->ready.store(1, std::memory_order_release);
+        producer.channel = channel;
+      }
+#endif
+
+      m_logger = Logging::create_logger("SharedMemory");
+      m_logger->info("Serving {} channel(s) {}_0.. of {} slots.", num_producers, name, num_slots);
+
+      register_stat(s_num_read_requests).name("num_read_requests");
+      register_stat(s_num_write_requests).name("num_write_requests");
+      register_stat(s_num_send_retries).name("num_send_retries");
+    };
+
+    ~SharedMemory() {
+#if !defined(_WIN32)
+      for (Producer& producer : m_producers) {
+        munmap(producer.channel, producer.size);
+        shm_unlink(producer.name.c_str());
+      }
+#endif
+    };
+
+    void tick() override {
+      m_clk++;
+      for (size_t i = 0; i < m_producers.size(); i++) {
+        Producer& producer = m_producers[i];
+        ShmRing::ShmChannel* channel = producer.channel;
+        uint64_t tail = channel->requests.tail.load(std::memory_order_relaxed);
+        uint64_t head = channel->requests.head.load(std::memory_order_acquire);
+
+        int num_taken = 0;
+        for (; tail != head && num_taken < m_max_requests_per_tick; tail++, num_taken++) {
+          const ShmRing::ShmRequest& shm_req = channel->request_slots()[tail % channel->num_slots];
+          bool is_read = shm_req.type_id == Request::Type::Read;
+          if (is_read && producer.num_reads_in_flight + num_unconsumed(channel) == channel->num_slots) {
+            break;
+          }
+
+          // The memory system does not report writes, which are done once accepted
+          RequestCallback callback = nullptr;
+          if (is_read) {
+            callback = [this, i, tag = shm_req.tag](Request& req) { complete(i, tag, req); };
+          }
+          if (!m_memory_system->send({shm_req.addr, shm_req.type_id, shm_req.source_id, callback})) {
+            s_num_send_retries++;
+            break;
+          }
+          if (is_read) {
+            producer.num_reads_in_flight++;
+            s_num_read_requests++;
+          } else {
+            s_num_write_requests++;
+          }
+        }
+        channel->requests.tail.store(tail, std::memory_order_release);
+      }
+    };
+
+  private:
+    static uint64_t num_unconsumed(ShmRing::ShmChannel* channel) {
+      return channel->completions.head.load(std::memory_order_relaxed) - channel->completions.tail.load(std::memory_order_acquire);
+    };
+
+    void complete(size_t producer_id, uint64_t tag, const Request& req) {
+      Producer& producer = m_producers[producer_id];
+      ShmRing::ShmChannel* channel = producer.channel;
+      uint64_t head = channel->completions.head.load(std::memory_order_relaxed);
+      channel->completion_slots()[head % channel->num_slots] = {tag, req.addr, req.arrive, req.depart};
+      channel->completions.head.store(head + 1, std::memory_order_release);
+      producer.num_reads_in_flight--;
+    };
+
+    // Finished when every producer has closed its channel and all its requests are served
+    bool is_finished() override {
+      for (const Producer& producer : m_producers) {
+        ShmRing::ShmChannel* channel = producer.channel;
+        if (!channel->closed.load(std::memory_order_acquire) ||
+            channel->requests.tail.load(std::memory_order_relaxed) != channel->requests.head.load(std::memory_order_acquire) ||
+            producer.num_reads_in_flight > 0) {
+          return false;
+        }
+      }
+      return true;
+    };
+};
+
+}        // namespace Ramulator
@@ -0,0 +1,70 @@
+#ifndef     RAMULATOR_FRONTEND_EXTERNAL_WRAPPER_SHM_RING_H
+#define     RAMULATOR_FRONTEND_EXTERNAL_WRAPPER_SHM_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Ramulator {
+
+/**
+ * @brief    The layout of the shared-memory channel between a producer process and the SharedMemory frontend
+ * @details
+ * A channel is one POSIX shared-memory object holding a ShmChannel header, then num_slots ShmRequests and num_slots
+ * ShmCompletions. Both rings are single-producer single-consumer: the producer writes a request at
+ * requests.head % num_slots and then publishes it by incrementing requests.head (release), and the simulator does the
+ * same with the completions of the reads. The consumer of a ring advances its tail once it is done with the entries.
+ * The counters only grow, so head - tail is the number of entries in the ring. This header has no other dependency
+ * so that producers can include it.
+ *
+ */
+namespace ShmRing {
+
+inline constexpr uint32_t MAGIC = 0x52534852;    // "RHSR"
+inline constexpr uint32_t VERSION = 1;
+
+struct ShmRequest {
+  uint64_t tag;          // Returned with the completion of a read
+  int64_t  addr;
+  int32_t  type_id;      // 0 = Read, 1 = Write
+  int32_t  source_id;
+};
+
+struct ShmCompletion {
+  uint64_t tag;
+  int64_t  addr;
+  int64_t  arrive;       // Memory controller cycles, as in the Request
+  int64_t  depart;
+};
+
+struct alignas(64) ShmCursor {
+  alignas(64) std::atomic<uint64_t> head;
+  alignas(64) std::atomic<uint64_t> tail;
+};
+
+struct ShmChannel {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t num_slots;
+  std::atomic<uint32_t> ready;           // Set by the simulator once the channel is initialized
+  std::atomic<uint32_t> closed;          // Set by the producer after its last request
+  ShmCursor requests;
+  ShmCursor completions;
+
+  ShmRequest* request_slots() { return reinterpret_cast<ShmRequest*>(this + 1); };
+  ShmCompletion* completion_slots() { return reinterpret_cast<ShmCompletion*>(request_slots() + num_slots); };
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "The shared-memory rings need lock-free atomics");
+
+inline size_t channel_size(uint64_t num_slots) {
+  return sizeof(ShmChannel) + num_slots * (sizeof(ShmRequest) + sizeof(ShmCompletion));
+}
+
+}        // namespace ShmRing
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_FRONTEND_EXTERNAL_WRAPPER_SHM_RING_H
@@ -0,0 +1,144 @@
+#include <memory>
+
+#include "frontend/frontend.h"
+#include "base/exception.h"
+#include "base/checkpoint.h"
+#include "frontend/impl/memory_trace/binary_trace_format.h"
+#include "frontend/impl/memory_trace/open_loop_replay.h"
+
+namespace Ramulator {
+
+class BinaryMemoryTrace : public IFrontEnd, public Implementation, public Checkpointable {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IFrontEnd, BinaryMemoryTrace, "BinaryTrace", "Load/Store or Read/Write trace in the binary trace format.")
+
+  private:
+    std::unique_ptr<BinaryTrace::Reader> m_trace;
+    bool m_is_addr_vec = false;   // Whether the trace has ReadWrite (address vector) records
+
+    // The record to send next
+    bool m_is_write = false;
+    Addr_t m_addr = -1;
+    AddrVec_t m_addr_vec;
+    int64_t m_timestamp = -1;
+    uint64_t m_index = 0;
+
+    uint64_t m_num_sent = 0;
+
+    OpenLoopReplay m_replay;
+    Clk_t m_arrival = -1;         // Of the record to send next in timed replay (-1 until computed)
+
+    Logger_t m_logger;
+
+  public:
+    void init() override {
+      std::string trace_path_str = param<std::string>("path").desc("Path to the binary trace file (see ramulator_trace_convert).").required();
+      std::string kind_str = param<std::string>("kind").desc("The records of the trace: LoadStore or ReadWrite.").default_val("LoadStore");
+      m_clock_ratio = param<uint>("clock_ratio").required();
+
+      BinaryTrace::Kind kind;
+      if (kind_str == "LoadStore") {
+        kind = BinaryTrace::Kind::LoadStore;
+      } else if (kind_str == "ReadWrite") {
+        kind = BinaryTrace::Kind::ReadWrite;
+        m_is_addr_vec = true;
+      } else {
+        throw ConfigurationError("Unrecognized binary trace kind {}!", kind_str);
+      }
+
+      m_logger = Logging::create_logger("BinaryTrace");
+      m_trace = std::make_unique<BinaryTrace::Reader>(trace_path_str, kind);
+      m_logger->info("Mapped binary trace file {} ({} records in {} bytes).", trace_path_str, m_trace->header().num_records, m_trace->file_size());
+
+      m_replay.configure(
+        param<std::string>("replay").desc("closed: send as fast as the memory system accepts, timed: at the timestamps of the trace.").default_val("closed"),
+        param<double>("replay_speedup").desc("How many times faster than recorded a timed replay runs.").default_val(1.0)
+      );
+      if (m_replay.is_timed()) {
+        if (!m_trace->header().is_timestamped()) {
+          throw ConfigurationError("Binary trace {} has no timestamps to replay at!", trace_path_str);
+        }
+        register_stat(m_replay.s_num_late_requests).name("replay_num_late_requests");
+        register_stat(m_replay.s_total_lag).name("replay_total_lag");
+        register_stat(m_replay.s_avg_lag).name("replay_avg_lag");
+        register_stat(m_replay.s_max_lag).name("replay_max_lag");
+        register_stat(m_replay.s_backlog_cycles).name("replay_backlog_cycles");
+      }
+      next();
+    };
+
+
+    void tick() override {
+      if (m_replay.is_timed()) {
+        tick_timed();
+        return;
+      }
+      int type = m_is_write ? Request::Type::Write : Request::Type::Read;
+      bool request_sent = m_is_addr_vec ? m_memory_system->send({m_addr_vec, type}) : m_memory_system->send({m_addr, type});
+      // Address vector requests are not retried, as in ReadWriteTrace
+      if (request_sent || m_is_addr_vec) {
+        m_num_sent++;
+        next();
+      }
+    };
+
+
+    void finalize() override {
+      m_replay.finalize(m_num_sent);
+      IFrontEnd::finalize();
+    };
+
+
+    // The position in the trace
+    void save_checkpoint(std::ostream& out) override {
+      Checkpoint::write<uint64_t>(out, m_trace->file_size());
+      Checkpoint::write<uint64_t>(out, m_index);
+    };
+
+    void load_checkpoint(std::istream& in) override {
+      Checkpoint::expect<uint64_t>(in, m_trace->file_size(), "trace file size");
+      m_trace->seek(Checkpoint::read<uint64_t>(in));
+      next();
+    };
+
+  private:
+    void next() {
+      m_index = m_trace->index();
+      if (m_is_addr_vec) {
+        m_trace->read_write(m_is_write, m_addr_vec);
+      } else {
+        m_trace->load_store(m_is_write, m_addr);
+      }
+      m_timestamp = m_trace->timestamp();
+    };
+
+    // Sends the records that have arrived, in order, until the memory system rejects one (also retrying address
+    // vector requests, so that the lag and backlog show when the memory system cannot keep up)
+    void tick_timed() {
+      while (!is_finished()) {
+        if (m_arrival == -1) {
+          m_arrival = m_replay.arrival(m_timestamp);
+        }
+        if (!m_replay.has_arrived(m_arrival)) {
+          break;
+        }
+        int type = m_is_write ? Request::Type::Write : Request::Type::Read;
+        bool request_sent = m_is_addr_vec ? m_memory_system->send({m_addr_vec, type}) : m_memory_system->send({m_addr, type});
+        if (!request_sent) {
+          m_replay.on_backlog();
+          break;
+        }
+        m_replay.on_sent(m_arrival);
+        m_num_sent++;
+        m_arrival = -1;
+        next();
+      }
+      m_replay.tick();
+    };
+
+    // Finished when every record of the trace has been sent once
+    bool is_finished() override {
+      return m_num_sent >= m_trace->header().num_records;
+    };
+};
+
+}        // namespace Ramulator
@@ -0,0 +1,358 @@
+#include <cstring>
+#include <algorithm>
+
+#include "frontend/impl/memory_trace/binary_trace_format.h"
+
+namespace Ramulator {
+
+namespace BinaryTrace {
+
+namespace {
+
+constexpr size_t WRITE_BUFFER_SIZE = 1 << 20;
+
+uint64_t zigzag(int64_t value) {
+  return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+  return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+template<typename T>
+void put_le(uint8_t* dst, T value) {
+  for (size_t i = 0; i < sizeof(T); i++) {
+    dst[i] = uint8_t(uint64_t(value) >> (8 * i));
+  }
+}
+
+template<typename T>
+T get_le(const uint8_t* src) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < sizeof(T); i++) {
+    value |= uint64_t(src[i]) << (8 * i);
+  }
+  return T(value);
+}
+
+}        // namespace
+
+
+std::string to_string(Kind kind) {
+  switch (kind) {
+    case Kind::LoadStore: return "LoadStore";
+    case Kind::ReadWrite: return "ReadWrite";
+    case Kind::SimpleO3:  return "SimpleO3";
+    case Kind::LLCMiss:   return "LLCMiss";
+  }
+  return "Unknown";
+}
+
+bool is_binary_trace(const std::string& path) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  char magic[sizeof(MAGIC)];
+  return file.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+
+Writer::Writer(const std::string& path, Kind kind, int levels, bool is_timestamped):
+m_path(path), m_file(path, std::ios::out | std::ios::binary | std::ios::trunc) {
+  if (!m_file) {
+    throw ConfigurationError("Trace {} cannot be opened for writing!", path);
+  }
+  if (kind == Kind::ReadWrite && (levels <= 0 || levels > int(AddrVec_t::capacity()))) {
+    throw ConfigurationError("Binary trace address vectors must have 1 to {} levels (got {})!", AddrVec_t::capacity(), levels);
+  }
+  m_header.kind = kind;
+  m_header.levels = kind == Kind::ReadWrite ? levels : 0;
+  if (is_timestamped) {
+    if (kind == Kind::SimpleO3 || kind == Kind::LLCMiss) {
+      throw ConfigurationError("{} binary traces cannot have timestamps!", to_string(kind));
+    }
+    m_header.flags |= FLAG_TIMESTAMPED;
+  }
+  m_prev_addr_vec.assign(m_header.levels, 0);
+  m_buffer.reserve(WRITE_BUFFER_SIZE + 64);
+
+  // Reserve the header, written by close() once the counts are known
+  char header[HEADER_SIZE] = {};
+  m_file.write(header, HEADER_SIZE);
+}
+
+Writer::~Writer() {
+  try {
+    close();
+  } catch (...) {}
+}
+
+void Writer::load_store(bool is_write, Addr_t addr, int64_t timestamp) {
+  put_timestamp(timestamp);
+  uint64_t delta = zigzag(addr - m_prev_addr);
+  if (delta >> 63) {
+    throw ConfigurationError("Address {} is too far from the previous one to encode!", addr);
+  }
+  put_varint((delta << 1) | is_write);
+  m_prev_addr = addr;
+  m_header.num_records++;
+}
+
+void Writer::read_write(bool is_write, const AddrVec_t& addr_vec, int64_t timestamp) {
+  if (addr_vec.size() != m_header.levels) {
+    throw ConfigurationError("Binary trace address vectors have {} levels, not {}!", m_header.levels, addr_vec.size());
+  }
+  put_timestamp(timestamp);
+  for (size_t i = 0; i < addr_vec.size(); i++) {
+    uint64_t delta = zigzag(addr_vec[i] - m_prev_addr_vec[i]);
+    put_varint(i == 0 ? (delta << 1) | is_write : delta);
+    m_prev_addr_vec[i] = addr_vec[i];
+  }
+  m_header.num_records++;
+}
+
+void Writer::simple_o3(int bubble_count, Addr_t load_addr, Addr_t store_addr) {
+  if (bubble_count < 0) {
+    throw ConfigurationError("Bubble count {} is negative!", bubble_count);
+  }
+  bool has_store = store_addr != -1;
+  put_varint((uint64_t(bubble_count) << 1) | has_store);
+  put_varint(zigzag(load_addr - m_prev_addr));
+  if (has_store) {
+    put_varint(zigzag(store_addr - load_addr));
+  }
+  m_prev_addr = load_addr;
+  m_header.num_records++;
+}
+
+void Writer::llc_miss(const LLCMissRecord& record) {
+  if (record.core_id < 0 || record.core_id >= MAX_CORES) {
+    throw ConfigurationError("Core id {} is out of range [0, {})!", record.core_id, MAX_CORES);
+  }
+  if (size_t(record.core_id) >= m_prev_core_addr.size()) {
+    m_prev_core_addr.resize(record.core_id + 1, 0);
+  }
+  int64_t& prev_addr = m_prev_core_addr[record.core_id];
+  uint64_t delta = zigzag(record.addr - prev_addr);
+  if (delta >> 62 || record.gap >> 63) {
+    throw ConfigurationError("LLC miss record {} cannot be encoded!", m_header.num_records);
+  }
+  put_varint(record.core_id);
+  put_varint((delta << 2) | uint64_t(record.op));
+  put_varint((record.gap << 1) | record.blocked);
+  if (record.blocked) {
+    put_varint(record.reads_in_flight);
+  }
+  prev_addr = record.addr;
+  m_header.num_records++;
+}
+
+void Writer::close() {
+  if (m_closed) {
+    return;
+  }
+  m_closed = true;
+  flush();
+
+  uint8_t header[HEADER_SIZE] = {};
+  std::memcpy(header, MAGIC, sizeof(MAGIC));
+  put_le<uint16_t>(header + 4, VERSION);
+  header[6] = uint8_t(m_header.kind);
+  header[7] = m_header.levels;
+  put_le<uint64_t>(header + 8, m_header.num_records);
+  put_le<uint64_t>(header + 16, m_header.payload_size);
+  header[24] = m_header.flags;
+  m_file.seekp(0);
+  m_file.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+  m_file.close();
+  if (!m_file) {
+    throw ConfigurationError("Failed to write trace {}!", m_path);
+  }
+}
+
+void Writer::put_timestamp(int64_t timestamp) {
+  if (!m_header.is_timestamped()) {
+    return;
+  }
+  if (timestamp < 0) {
+    throw ConfigurationError("Every record of a timestamped trace needs a timestamp (record {})!", m_header.num_records);
+  }
+  put_varint(zigzag(timestamp - m_prev_timestamp));
+  m_prev_timestamp = timestamp;
+}
+
+void Writer::put_varint(uint64_t value) {
+  while (value >= 0x80) {
+    m_buffer.push_back(uint8_t(value) | 0x80);
+    value >>= 7;
+  }
+  m_buffer.push_back(uint8_t(value));
+  if (m_buffer.size() >= WRITE_BUFFER_SIZE) {
+    flush();
+  }
+}
+
+void Writer::flush() {
+  m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+  m_header.payload_size += m_buffer.size();
+  m_buffer.clear();
+}
+
+
+Reader::Reader(const std::string& path, Kind kind): m_path(path), m_file(path) {
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(m_file.begin());
+  if (m_file.size() < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+    throw ConfigurationError("{} is not a binary trace!", path);
+  }
+  if (uint16_t version = get_le<uint16_t>(data + 4); version != VERSION) {
+    throw ConfigurationError("Binary trace {} has format version {}, but version {} is supported!", path, version, VERSION);
+  }
+  m_header.kind = Kind(data[6]);
+  m_header.levels = data[7];
+  m_header.num_records = get_le<uint64_t>(data + 8);
+  m_header.payload_size = get_le<uint64_t>(data + 16);
+  m_header.flags = data[24];
+
+  if (m_header.kind != kind) {
+    throw ConfigurationError("Binary trace {} holds {} records, not {} records!", path, to_string(m_header.kind), to_string(kind));
+  }
+  if (kind == Kind::ReadWrite && (m_header.levels == 0 || m_header.levels > AddrVec_t::capacity())) {
+    throw ConfigurationError("Binary trace {} has address vectors of {} levels!", path, m_header.levels);
+  }
+  if (m_header.is_timestamped() && (kind == Kind::SimpleO3 || kind == Kind::LLCMiss)) {
+    throw ConfigurationError("{} binary trace {} cannot have timestamps!", to_string(kind), path);
+  }
+  if (m_header.payload_size != m_file.size() - HEADER_SIZE) {
+    throw ConfigurationError("Binary trace {} is truncated!", path);
+  }
+  if (m_header.num_records == 0) {
+    throw ConfigurationError("Trace {} is empty!", path);
+  }
+
+  m_payload = data + HEADER_SIZE;
+  m_payload_end = m_payload + m_header.payload_size;
+  m_prev_addr_vec.resize(m_header.levels);
+  rewind();
+  m_num_wraps = 0;
+}
+
+void Reader::load_store(bool& is_write, Addr_t& addr) {
+  get_timestamp();
+  uint64_t encoded = get_varint();
+  is_write = encoded & 1;
+  m_prev_addr += unzigzag(encoded >> 1);
+  addr = m_prev_addr;
+  next_record();
+}
+
+void Reader::read_write(bool& is_write, AddrVec_t& addr_vec) {
+  get_timestamp();
+  addr_vec.resize(m_header.levels);
+  for (size_t i = 0; i < m_header.levels; i++) {
+    uint64_t encoded = get_varint();
+    if (i == 0) {
+      is_write = encoded & 1;
+      encoded >>= 1;
+    }
+    m_prev_addr_vec[i] += unzigzag(encoded);
+    addr_vec[i] = m_prev_addr_vec[i];
+  }
+  next_record();
+}
+
+void Reader::simple_o3(int& bubble_count, Addr_t& load_addr, Addr_t& store_addr) {
+  uint64_t encoded = get_varint();
+  bubble_count = encoded >> 1;
+  m_prev_addr += unzigzag(get_varint());
+  load_addr = m_prev_addr;
+  store_addr = (encoded & 1) ? load_addr + unzigzag(get_varint()) : -1;
+  next_record();
+}
+
+void Reader::llc_miss(LLCMissRecord& record) {
+  uint64_t core_id = get_varint();
+  if (core_id >= uint64_t(MAX_CORES)) {
+    throw ConfigurationError("Binary trace {} is corrupted at record {}!", m_path, m_index);
+  }
+  if (core_id >= m_prev_core_addr.size()) {
+    m_prev_core_addr.resize(core_id + 1, 0);
+  }
+  uint64_t encoded = get_varint();
+  if ((encoded & 3) > uint64_t(LLCOp::Prefetch)) {
+    throw ConfigurationError("Binary trace {} is corrupted at record {}!", m_path, m_index);
+  }
+  record.core_id = core_id;
+  record.op = LLCOp(encoded & 3);
+  m_prev_core_addr[core_id] += unzigzag(encoded >> 2);
+  record.addr = m_prev_core_addr[core_id];
+  encoded = get_varint();
+  record.gap = encoded >> 1;
+  record.blocked = encoded & 1;
+  record.reads_in_flight = record.blocked ? get_varint() : 0;
+  next_record();
+}
+
+void Reader::seek(uint64_t index) {
+  if (index >= m_header.num_records) {
+    throw ConfigurationError("Binary trace {} has no record {}!", m_path, index);
+  }
+  rewind();
+  m_num_wraps = 0;
+  bool is_write;
+  Addr_t addr, store_addr;
+  AddrVec_t addr_vec;
+  int bubble_count;
+  LLCMissRecord record;
+  while (m_index < index) {
+    switch (m_header.kind) {
+      case Kind::LoadStore: load_store(is_write, addr); break;
+      case Kind::ReadWrite: read_write(is_write, addr_vec); break;
+      case Kind::SimpleO3:  simple_o3(bubble_count, addr, store_addr); break;
+      case Kind::LLCMiss:   llc_miss(record); break;
+    }
+  }
+}
+
+void Reader::get_timestamp() {
+  if (m_header.is_timestamped()) {
+    m_prev_timestamp += unzigzag(get_varint());
+    m_timestamp = m_prev_timestamp;
+  }
+}
+
+void Reader::next_record() {
+  m_index++;
+  if (m_index == m_header.num_records) {
+    if (m_cursor != m_payload_end) {
+      throw ConfigurationError("Binary trace {} has data after its last record!", m_path);
+    }
+    rewind();
+    m_num_wraps++;
+  }
+}
+
+void Reader::rewind() {
+  m_cursor = m_payload;
+  m_index = 0;
+  m_prev_addr = 0;
+  m_prev_timestamp = 0;
+  std::fill(m_prev_addr_vec.begin(), m_prev_addr_vec.end(), 0);
+  std::fill(m_prev_core_addr.begin(), m_prev_core_addr.end(), 0);
+}
+
+uint64_t Reader::get_varint() {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (m_cursor == m_payload_end) {
+      throw ConfigurationError("Binary trace {} is truncated at record {}!", m_path, m_index);
+    }
+    uint8_t byte = *m_cursor++;
+    value |= uint64_t(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return value;
+    }
+  }
+  throw ConfigurationError("Binary trace {} is corrupted at record {}!", m_path, m_index);
+}
+
+}        // namespace BinaryTrace
+
+}        // namespace Ramulator
@@ -0,0 +1,196 @@
+#ifndef     RAMULATOR_FRONTEND_MEMORY_TRACE_BINARY_TRACE_FORMAT_H
+#define     RAMULATOR_FRONTEND_MEMORY_TRACE_BINARY_TRACE_FORMAT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+
+#include "base/type.h"
+#include "base/exception.h"
+#include "frontend/impl/memory_trace/mapped_trace.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    The compact binary trace format
+ * @details
+ * A binary trace starts with a fixed 32-byte little-endian header:
+ *   "RBTR", the format version (uint16_t), the record kind (uint8_t), the address vector levels (uint8_t, ReadWrite
+ *   only), the number of records (uint64_t), the size of the payload in bytes (uint64_t), the flags (uint8_t) and 7
+ *   reserved zero bytes. Flag TIMESTAMPED marks a LoadStore or ReadWrite trace whose records carry timestamps.
+ * The payload encodes every address as the zigzag delta to the previous one, in LEB128 varints, so the sequential and
+ * strided streams of the usual traces take one or two bytes per address. Per record kind:
+ *   LoadStore: (delta(addr) << 1 | is_write)
+ *   ReadWrite: (delta(addr_vec[0]) << 1 | is_write), then delta(addr_vec[i]) for the other levels
+ *   SimpleO3:  (bubble_count << 1 | has_store), delta(load_addr), then zigzag(store_addr - load_addr) if has_store
+ *   LLCMiss:   core_id, (delta(addr) << 2 | op), (gap << 1 | blocked), then reads_in_flight if blocked
+ * The deltas are against the same field of the previous record (zero before the first record). The store address of a
+ * SimpleO3 record is relative to its load address instead, as stores usually follow their loads, and the address of an
+ * LLCMiss record is relative to the previous record of the same core. A timestamped record starts with
+ * zigzag(delta(timestamp)), which takes a byte for the short inter-arrival times of the usual traces.
+ *
+ */
+namespace BinaryTrace {
+
+inline constexpr char MAGIC[4] = {'R', 'B', 'T', 'R'};
+inline constexpr uint16_t VERSION = 1;
+inline constexpr size_t HEADER_SIZE = 32;
+inline constexpr uint8_t FLAG_TIMESTAMPED = 1 << 0;
+inline constexpr int MAX_CORES = 1 << 16;      // Of an LLCMiss trace
+
+enum class Kind : uint8_t {
+  LoadStore = 0,
+  ReadWrite = 1,
+  SimpleO3  = 2,
+  LLCMiss   = 3,
+};
+
+/**
+ * @brief    The requests an LLC sends to the memory system, as recorded in an LLCMiss trace
+ *
+ */
+enum class LLCOp : uint8_t {
+  Read      = 0,    // A demand miss
+  Writeback = 1,    // A dirty eviction
+  Prefetch  = 2,
+};
+
+/**
+ * @brief    A record of an LLCMiss trace
+ * @details
+ * gap is the number of cycles the core computed between its previous record and this one, excluding the cycles it was
+ * stalled on memory (its instruction window was full, or the LLC rejected its access). blocked marks a record issued
+ * after such a stall, i.e., one that depends on earlier misses of its core returning: it was issued once no more than
+ * reads_in_flight demand misses of its core were still in flight.
+ *
+ */
+struct LLCMissRecord {
+  int core_id = 0;
+  LLCOp op = LLCOp::Read;
+  Addr_t addr = 0;
+  uint64_t gap = 0;
+  bool blocked = false;
+  uint32_t reads_in_flight = 0;     // Only for a blocked record
+};
+
+std::string to_string(Kind kind);
+
+struct Header {
+  Kind kind = Kind::LoadStore;
+  uint8_t levels = 0;
+  uint64_t num_records = 0;
+  uint64_t payload_size = 0;
+  uint8_t flags = 0;
+
+  bool is_timestamped() const { return flags & FLAG_TIMESTAMPED; };
+};
+
+/**
+ * @brief    Returns whether the file at path starts with the binary trace magic.
+ *
+ */
+bool is_binary_trace(const std::string& path);
+
+
+/**
+ * @brief    Streams records of one kind into a binary trace file. The header is written by close().
+ *
+ */
+class Writer {
+  private:
+    std::string m_path;
+    std::ofstream m_file;
+    Header m_header;
+    std::vector<uint8_t> m_buffer;
+    bool m_closed = false;
+
+    // The previous record
+    int64_t m_prev_addr = 0;
+    std::vector<int64_t> m_prev_addr_vec;
+    std::vector<int64_t> m_prev_core_addr;    // LLCMiss, per core
+    int64_t m_prev_timestamp = 0;
+
+  public:
+    Writer(const std::string& path, Kind kind, int levels = 0, bool is_timestamped = false);
+    ~Writer();
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    // The timestamp is only written to (and required by) a timestamped trace
+    void load_store(bool is_write, Addr_t addr, int64_t timestamp = -1);
+    void read_write(bool is_write, const AddrVec_t& addr_vec, int64_t timestamp = -1);
+    void simple_o3(int bubble_count, Addr_t load_addr, Addr_t store_addr);
+    void llc_miss(const LLCMissRecord& record);
+
+    const Header& header() const { return m_header; };
+
+    void close();
+
+  private:
+    void put_timestamp(int64_t timestamp);
+    void put_varint(uint64_t value);
+    void flush();
+};
+
+
+/**
+ * @brief    Decodes the records of a memory-mapped binary trace in order, wrapping around at the end.
+ *
+ */
+class Reader {
+  private:
+    std::string m_path;
+    MappedFile m_file;
+    Header m_header;
+
+    const uint8_t* m_payload;
+    const uint8_t* m_payload_end;
+    const uint8_t* m_cursor;
+    uint64_t m_index = 0;       // Of the next record
+    size_t m_num_wraps = 0;
+
+    // The previous record
+    int64_t m_prev_addr = 0;
+    std::vector<int64_t> m_prev_addr_vec;
+    std::vector<int64_t> m_prev_core_addr;
+    int64_t m_prev_timestamp = 0;
+    int64_t m_timestamp = -1;   // Of the last record read, -1 if the trace has none
+
+  public:
+    /**
+     * @brief    Opens the binary trace at path and checks that it holds records of the given kind.
+     *
+     */
+    Reader(const std::string& path, Kind kind);
+
+    const Header& header() const { return m_header; };
+    size_t file_size() const { return m_file.size(); };
+    uint64_t index() const { return m_index; };
+    size_t num_wraps() const { return m_num_wraps; };
+    int64_t timestamp() const { return m_timestamp; };
+
+    void load_store(bool& is_write, Addr_t& addr);
+    void read_write(bool& is_write, AddrVec_t& addr_vec);
+    void simple_o3(int& bubble_count, Addr_t& load_addr, Addr_t& store_addr);
+    void llc_miss(LLCMissRecord& record);
+
+    /**
+     * @brief    Skips to record index (decoding the records before it, as the encoding is sequential).
+     *
+     */
+    void seek(uint64_t index);
+
+  private:
+    void get_timestamp();
+    void next_record();
+    void rewind();
+    uint64_t get_varint();
+};
+
+}        // namespace BinaryTrace
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_FRONTEND_MEMORY_TRACE_BINARY_TRACE_FORMAT_H
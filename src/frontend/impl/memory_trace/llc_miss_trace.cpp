@@ -0,0 +1,176 @@
+#include <vector>
+#include <algorithm>
+
+#include "frontend/frontend.h"
+#include "base/exception.h"
+#include "base/memory_report.h"
+#include "frontend/impl/memory_trace/binary_trace_format.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Replays the requests a SimpleO3 LLC sent to the memory system (recorded with its llc_miss_trace), so that
+ *           the configurations that only differ in the memory system do not simulate the cores and the LLC again.
+ *
+ * @details
+ * Each core replays its records in order. A record is sent gap cycles after the previous record of its core was sent,
+ * and a blocked record (its core stalled on memory before it) first waits until no more demand reads of its core are
+ * in flight than when it was recorded, then gap cycles after the last of them returned. So the cores keep the memory
+ * level parallelism of their windows, a slower memory system delays them as their windows would, and a faster one lets
+ * them run ahead. At most max_outstanding_reads reads (demand and prefetch) of a core are
+ * in flight, as in the MSHRs of the LLC, and a record the memory system rejects is retried the next cycle.
+ *
+ * The gaps are in frontend cycles, so the clock_ratio has to be the one of the recording SimpleO3.
+ *
+ */
+class LLCMissTrace : public IFrontEnd, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IFrontEnd, LLCMissTrace, "LLCMissTrace", "Replays the LLC misses, writebacks and prefetches recorded by SimpleO3, with the dependencies of the cores.")
+
+  private:
+    struct Core {
+      std::vector<BinaryTrace::LLCMissRecord> records;
+      size_t next = 0;                  // The record to send next
+      Clk_t ready_clk = -1;             // When the next record can be sent (-1 until its dependencies have returned)
+      Clk_t last_sent_clk = 0;
+      Clk_t last_return_clk = 0;        // Of the last demand read that returned
+      int outstanding_reads = 0;        // Demand reads and prefetches in flight
+      int outstanding_demand_reads = 0;
+      RequestCallback demand_callback;
+      RequestCallback prefetch_callback;
+    };
+    std::vector<Core> m_cores;
+
+    int m_max_outstanding_reads = 0;
+    uint64_t m_num_records = 0;
+    uint64_t m_num_sent = 0;
+
+    size_t s_dependency_stall_cycles = 0;   // Summed over the cores, waiting for their demand reads
+    size_t s_throttled_cycles = 0;          // Summed over the cores, at max_outstanding_reads
+    size_t s_backpressure_cycles = 0;       // Summed over the cores, with a record the memory system rejected
+    std::vector<Clk_t> s_cycles;            // Per core, until its last record was sent and its reads returned
+
+    Logger_t m_logger;
+
+  public:
+    void init() override {
+      std::string trace_path_str = param<std::string>("path").desc("Path to the LLCMiss binary trace (recorded by SimpleO3 with llc_miss_trace).").required();
+      m_clock_ratio = param<uint>("clock_ratio").required();
+      m_max_outstanding_reads = param<int>("max_outstanding_reads").desc("Reads (demand and prefetch) a core can have in flight, as its LLC MSHRs (0 = unlimited).").default_val(16);
+      if (m_max_outstanding_reads < 0) {
+        throw ConfigurationError("LLCMissTrace: max_outstanding_reads cannot be negative (got {})!", m_max_outstanding_reads);
+      }
+
+      m_logger = Logging::create_logger("LLCMissTrace");
+      BinaryTrace::Reader trace(trace_path_str, BinaryTrace::Kind::LLCMiss);
+      m_num_records = trace.header().num_records;
+      BinaryTrace::LLCMissRecord record;
+      for (uint64_t i = 0; i < m_num_records; i++) {
+        trace.llc_miss(record);
+        if (size_t(record.core_id) >= m_cores.size()) {
+          m_cores.resize(record.core_id + 1);
+        }
+        m_cores[record.core_id].records.push_back(record);
+      }
+      m_logger->info("Loaded LLC miss trace {} ({} records of {} cores in {} bytes).", trace_path_str, m_num_records, m_cores.size(), trace.file_size());
+
+      s_cycles.resize(m_cores.size(), 0);
+      for (size_t core_id = 0; core_id < m_cores.size(); core_id++) {
+        Core& core = m_cores[core_id];
+        core.demand_callback = [this, core_id](Request& req) {
+          Core& core = m_cores[core_id];
+          core.outstanding_reads--;
+          core.outstanding_demand_reads--;
+          core.last_return_clk = m_clk;
+        };
+        core.prefetch_callback = [this, core_id](Request& req) { m_cores[core_id].outstanding_reads--; };
+      }
+
+      register_stat(m_num_sent).name("llc_miss_trace_records_sent");
+      register_stat(s_dependency_stall_cycles).name("llc_miss_trace_dependency_stall_cycles");
+      register_stat(s_throttled_cycles).name("llc_miss_trace_throttled_cycles");
+      register_stat(s_backpressure_cycles).name("llc_miss_trace_backpressure_cycles");
+      for (size_t core_id = 0; core_id < m_cores.size(); core_id++) {
+        register_stat(s_cycles[core_id]).name("cycles_core_{}", core_id);
+      }
+    };
+
+
+    void tick() override {
+      m_clk++;
+      for (size_t core_id = 0; core_id < m_cores.size(); core_id++) {
+        tick_core(core_id);
+      }
+    };
+
+
+    int get_num_cores() override {
+      return m_cores.size();
+    };
+
+    // The records of every core
+    size_t memory_footprint() const override {
+      size_t bytes = heap_bytes(m_cores);
+      for (const Core& core : m_cores) {
+        bytes += heap_bytes(core.records);
+      }
+      return bytes;
+    };
+
+    // Finished when every record has been sent and every read has returned
+    bool is_finished() override {
+      for (const Core& core : m_cores) {
+        if (core.next < core.records.size() || core.outstanding_reads > 0) {
+          return false;
+        }
+      }
+      return true;
+    };
+
+  private:
+    // Sends the records of the core that are ready, in order, until one has to wait
+    void tick_core(int core_id) {
+      Core& core = m_cores[core_id];
+      while (core.next < core.records.size()) {
+        const BinaryTrace::LLCMissRecord& record = core.records[core.next];
+        if (core.ready_clk == -1) {
+          if (record.blocked && core.outstanding_demand_reads > int(record.reads_in_flight)) {
+            s_dependency_stall_cycles++;
+            return;
+          }
+          Clk_t start_clk = record.blocked ? std::max(core.last_sent_clk, core.last_return_clk) : core.last_sent_clk;
+          core.ready_clk = start_clk + record.gap;
+        }
+        if (m_clk < core.ready_clk) {
+          return;
+        }
+
+        bool is_write = record.op == BinaryTrace::LLCOp::Writeback;
+        if (!is_write && m_max_outstanding_reads > 0 && core.outstanding_reads >= m_max_outstanding_reads) {
+          s_throttled_cycles++;
+          return;
+        }
+        bool is_demand = record.op == BinaryTrace::LLCOp::Read;
+        RequestCallback callback = nullptr;
+        if (!is_write) {
+          callback = is_demand ? core.demand_callback : core.prefetch_callback;
+        }
+        Request req(record.addr, is_write ? Request::Type::Write : Request::Type::Read, core_id, callback);
+        if (!m_memory_system->send(req)) {
+          s_backpressure_cycles++;
+          return;
+        }
+
+        core.outstanding_reads += !is_write;
+        core.outstanding_demand_reads += is_demand;
+        core.last_sent_clk = m_clk;
+        core.ready_clk = -1;
+        core.next++;
+        m_num_sent++;
+      }
+      if (s_cycles[core_id] == 0 && core.outstanding_reads == 0) {
+        s_cycles[core_id] = m_clk;
+      }
+    };
+};
+
+}        // namespace Ramulator
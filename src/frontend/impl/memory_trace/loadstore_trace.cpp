@@ -1,28 +1,54 @@
-#include <filesystem>
-#include <iostream>
-#include <fstream>
+#include <memory>
 
 #include "frontend/frontend.h"
 #include "base/exception.h"
+#include "base/checkpoint.h"
+#include "frontend/impl/memory_trace/streamed_trace.h"
+#include "frontend/impl/memory_trace/open_loop_replay.h"
 
 namespace Ramulator {
 
-namespace fs = std::filesystem;
-
-class LoadStoreTrace : public IFrontEnd, public Implementation {
+class LoadStoreTrace : public IFrontEnd, public Implementation, public Checkpointable {
   RAMULATOR_REGISTER_IMPLEMENTATION(IFrontEnd, LoadStoreTrace, "LoadStoreTrace", "Load/Store memory address trace.")
 
   private:
     struct Trace {
-      bool is_write;
+      int type_id;
       Addr_t addr;
+      int64_t timestamp;      // -1 if the line has none
+    };
+    struct TraceParser {
+      // "[<timestamp>] LD <addr>" or "[<timestamp>] ST <addr>", the address in decimal or 0x-prefixed hexadecimal.
+      // "PST <addr>" is a partial store (a masked write)
+      static bool parse(TraceLineScanner& line, Trace& t) {
+        if (!line.integer(t.timestamp)) {
+          t.timestamp = -1;
+        }
+        std::string_view type = line.token();
+        if (type == "LD") {
+          t.type_id = Request::Type::Read;
+        } else if (type == "ST") {
+          t.type_id = Request::Type::Write;
+        } else if (type == "PST") {
+          t.type_id = Request::Type::PartialWrite;
+        } else {
+          return false;
+        }
+        int64_t addr;
+        if (!line.integer(addr)) {
+          return false;
+        }
+        t.addr = addr;
+        return true;
+      };
     };
-    std::vector<Trace> m_trace;
+    std::unique_ptr<TraceSource<Trace>> m_trace;   // Streamed if the file is compressed, mapped otherwise
 
-    size_t m_trace_length = 0;
-    size_t m_curr_trace_idx = 0;
+    size_t m_start_position = 0;    // Where the replay started in the trace file
 
-    size_t m_trace_count = 0;
+    OpenLoopReplay m_replay;
+    Clk_t m_arrival = -1;           // Of the current record in timed replay (-1 until computed)
+    size_t m_num_sent = 0;
 
     Logger_t m_logger;
 
@@ -32,70 +58,80 @@ class LoadStoreTrace : public IFrontEnd, public Implementation {
       m_clock_ratio = param<uint>("clock_ratio").required();
 
       m_logger = Logging::create_logger("LoadStoreTrace");
-      m_logger->info("Loading trace file {} ...", trace_path_str);
-      init_trace(trace_path_str);
-      m_logger->info("Loaded {} lines.", m_trace.size());
+      m_trace = open_trace<Trace, TraceParser>(trace_path_str);
+      m_logger->info("Opened trace file {} ({} bytes).", trace_path_str, m_trace->file_size());
+
+      m_replay.configure(
+        param<std::string>("replay").desc("closed: send as fast as the memory system accepts, timed: at the timestamps of the trace.").default_val("closed"),
+        param<double>("replay_speedup").desc("How many times faster than recorded a timed replay runs.").default_val(1.0)
+      );
+      if (m_replay.is_timed()) {
+        register_stat(m_replay.s_num_late_requests).name("replay_num_late_requests");
+        register_stat(m_replay.s_total_lag).name("replay_total_lag");
+        register_stat(m_replay.s_avg_lag).name("replay_avg_lag");
+        register_stat(m_replay.s_max_lag).name("replay_max_lag");
+        register_stat(m_replay.s_backlog_cycles).name("replay_backlog_cycles");
+      }
     };
 
 
     void tick() override {
-      const Trace& t = m_trace[m_curr_trace_idx];
-      bool request_sent = m_memory_system->send({t.addr, t.is_write ? Request::Type::Write : Request::Type::Read});
+      if (m_replay.is_timed()) {
+        tick_timed();
+        return;
+      }
+      const Trace& t = m_trace->current();
+      bool request_sent = m_memory_system->send({t.addr, t.type_id});
       if (request_sent) {
-        m_curr_trace_idx = (m_curr_trace_idx + 1) % m_trace_length;
-        m_trace_count++;
+        m_trace->advance();
       }
     };
 
 
-  private:
-    void init_trace(const std::string& file_path_str) {
-      fs::path trace_path(file_path_str);
-      if (!fs::exists(trace_path)) {
-        throw ConfigurationError("Trace {} does not exist!", file_path_str);
-      }
+    void finalize() override {
+      m_replay.finalize(m_num_sent);
+      IFrontEnd::finalize();
+    };
 
-      std::ifstream trace_file(trace_path);
-      if (!trace_file.is_open()) {
-        throw ConfigurationError("Trace {} cannot be opened!", file_path_str);
-      }
 
-      std::string line;
-      while (std::getline(trace_file, line)) {
-        std::vector<std::string> tokens;
-        tokenize(tokens, line, " ");
+    // The position in the trace
+    void save_checkpoint(std::ostream& out) override {
+      Checkpoint::write<uint64_t>(out, m_trace->file_size());
+      Checkpoint::write<uint64_t>(out, m_trace->position());
+    };
 
-        // TODO: Add line number here for better error messages
-        if (tokens.size() != 2) {
-          throw ConfigurationError("Trace {} format invalid!", file_path_str);
-        }
+    void load_checkpoint(std::istream& in) override {
+      Checkpoint::expect<uint64_t>(in, m_trace->file_size(), "trace file size");
+      m_start_position = Checkpoint::read<uint64_t>(in);
+      m_trace->seek(m_start_position);
+    };
 
-        bool is_write = false; 
-        if (tokens[0] == "LD") {
-          is_write = false;
-        } else if (tokens[0] == "ST") {
-          is_write = true;
-        } else {
-          throw ConfigurationError("Trace {} format invalid!", file_path_str);
+  private:
+    // Sends the records that have arrived, in order, until the memory system rejects one
+    void tick_timed() {
+      while (!is_finished()) {
+        const Trace& t = m_trace->current();
+        if (m_arrival == -1) {
+          m_arrival = m_replay.arrival(t.timestamp);
         }
-
-        Addr_t addr = -1;
-        if (tokens[1].compare(0, 2, "0x") == 0 | tokens[1].compare(0, 2, "0X") == 0) {
-          addr = std::stoll(tokens[1].substr(2), nullptr, 16);
-        } else {
-          addr = std::stoll(tokens[1]);
+        if (!m_replay.has_arrived(m_arrival)) {
+          break;
+        }
+        if (!m_memory_system->send({t.addr, t.type_id})) {
+          m_replay.on_backlog();
+          break;
         }
-        m_trace.push_back({is_write, addr});
+        m_replay.on_sent(m_arrival);
+        m_num_sent++;
+        m_arrival = -1;
+        m_trace->advance();
       }
-
-      trace_file.close();
-
-      m_trace_length = m_trace.size();
+      m_replay.tick();
     };
 
-    // TODO: FIXME
+    // Finished when every line of the trace has been sent once
     bool is_finished() override {
-      return m_trace_count >= m_trace_length; 
+      return m_trace->num_wraps() > 0 && m_trace->position() >= m_start_position;
     };
 };
 
@@ -0,0 +1,66 @@
+#include <filesystem>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "frontend/impl/memory_trace/mapped_trace.h"
+
+namespace Ramulator {
+
+namespace fs = std::filesystem;
+
+MappedFile::MappedFile(const std::string& path) {
+  if (!fs::exists(path)) {
+    throw ConfigurationError("Trace {} does not exist!", path);
+  }
+
+#if !defined(_WIN32)
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw ConfigurationError("Trace {} cannot be opened!", path);
+  }
+  struct stat st;
+  if (fstat(fd, &st) == -1) {
+    close(fd);
+    throw ConfigurationError("Trace {} cannot be opened!", path);
+  }
+  m_size = st.st_size;
+  if (m_size != 0) {
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      // The trace is replayed front to back
+      madvise(data, m_size, MADV_SEQUENTIAL);
+      m_data = static_cast<const char*>(data);
+      m_mapped = true;
+    }
+  }
+  close(fd);
+  if (m_mapped || m_size == 0) {
+    return;
+  }
+#endif
+
+  // Cannot map the file (e.g., a pipe), so read it instead
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file) {
+    throw ConfigurationError("Trace {} cannot be opened!", path);
+  }
+  m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  m_data = m_buffer.data();
+  m_size = m_buffer.size();
+}
+
+MappedFile::~MappedFile() {
+#if !defined(_WIN32)
+  if (m_mapped) {
+    munmap(const_cast<char*>(m_data), m_size);
+  }
+#endif
+}
+
+}        // namespace Ramulator
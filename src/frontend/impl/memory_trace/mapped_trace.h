@@ -0,0 +1,234 @@
+#ifndef     RAMULATOR_FRONTEND_MEMORY_TRACE_MAPPED_TRACE_H
+#define     RAMULATOR_FRONTEND_MEMORY_TRACE_MAPPED_TRACE_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "base/exception.h"
+#include "frontend/impl/memory_trace/trace_source.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    A read-only view of a whole file, memory-mapped where the platform supports it (read into memory otherwise)
+ *
+ */
+class MappedFile {
+  private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false;
+    std::vector<char> m_buffer;   // The contents, if the file could not be mapped
+
+  public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* begin() const { return m_data; };
+    const char* end() const { return m_data + m_size; };
+    size_t size() const { return m_size; };
+};
+
+
+/**
+ * @brief    Scanner for the tokens of one trace line, without allocation
+ *
+ */
+class TraceLineScanner {
+  private:
+    const char* m_pos;
+    const char* m_end;
+
+  public:
+    TraceLineScanner(const char* begin, const char* end): m_pos(begin), m_end(end) {};
+
+    void skip_blanks() {
+      while (m_pos != m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\r')) {
+        m_pos++;
+      }
+    };
+
+    bool at_end() {
+      skip_blanks();
+      return m_pos == m_end;
+    };
+
+    /**
+     * @brief    Reads the next blank-separated token as a view into the line.
+     *
+     */
+    std::string_view token() {
+      skip_blanks();
+      const char* start = m_pos;
+      while (m_pos != m_end && *m_pos != ' ' && *m_pos != '\t' && *m_pos != '\r') {
+        m_pos++;
+      }
+      return {start, size_t(m_pos - start)};
+    };
+
+    /**
+     * @brief    Reads a decimal or 0x-prefixed hexadecimal integer, optionally negative. Returns false if there is none.
+     *
+     */
+    bool integer(int64_t& value) {
+      skip_blanks();
+      bool negative = false;
+      if (m_pos != m_end && *m_pos == '-') {
+        negative = true;
+        m_pos++;
+      }
+      uint64_t magnitude = 0;
+      const char* digits = m_pos;
+      if (m_end - m_pos > 2 && m_pos[0] == '0' && (m_pos[1] == 'x' || m_pos[1] == 'X')) {
+        m_pos += 2;
+        digits = m_pos;
+        for (; m_pos != m_end; m_pos++) {
+          char c = *m_pos;
+          uint64_t digit;
+          if (c >= '0' && c <= '9') {
+            digit = c - '0';
+          } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+            digit = (c | 0x20) - 'a' + 10;
+          } else {
+            break;
+          }
+          magnitude = (magnitude << 4) | digit;
+        }
+      } else {
+        for (; m_pos != m_end && *m_pos >= '0' && *m_pos <= '9'; m_pos++) {
+          magnitude = magnitude * 10 + (*m_pos - '0');
+        }
+      }
+      if (m_pos == digits) {
+        return false;
+      }
+      value = negative ? -int64_t(magnitude) : int64_t(magnitude);
+      return true;
+    };
+
+    bool consume(char c) {
+      if (m_pos != m_end && *m_pos == c) {
+        m_pos++;
+        return true;
+      }
+      return false;
+    };
+};
+
+
+/**
+ * @brief    A trace replayed straight from its memory-mapped file
+ * @details
+ * The records are decoded on demand, a chunk at a time, by Parser::parse(TraceLineScanner&, Record&), which returns
+ * false if the line is malformed. So nothing is parsed up front, and the trace takes no memory besides the chunk and
+ * the pages the OS keeps cached. The trace wraps around at the end of the file.
+ * Blank lines are skipped.
+ *
+ */
+template<typename Record, typename Parser>
+class MappedTrace : public TraceSource<Record> {
+  public:
+    static constexpr size_t CHUNK_SIZE = 1024;
+
+  private:
+    std::string m_path;
+    MappedFile m_file;
+
+    const char* m_cursor;                       // Where the next chunk starts
+    std::array<Record, CHUNK_SIZE> m_chunk;
+    std::array<size_t, CHUNK_SIZE> m_offsets;   // The file offset of every record in the chunk
+    size_t m_chunk_size = 0;
+    size_t m_chunk_pos = 0;
+
+    size_t m_line_number = 0;     // Of the line at m_cursor, for the error messages (0 if unknown after a seek)
+    size_t m_num_wraps = 0;       // How many times the trace wrapped around
+
+  public:
+    explicit MappedTrace(const std::string& path): m_path(path), m_file(path), m_cursor(m_file.begin()) {
+      m_line_number = 1;
+      refill();
+      if (m_chunk_size == 0) {
+        throw ConfigurationError("Trace {} is empty!", m_path);
+      }
+    };
+
+    const Record& current() const override { return m_chunk[m_chunk_pos]; };
+
+    void advance() override {
+      m_chunk_pos++;
+      if (m_chunk_pos == m_chunk_size) {
+        refill();
+      }
+    };
+
+    size_t num_wraps() const override { return m_num_wraps; };
+
+    size_t file_size() const override { return m_file.size(); };
+
+    // The file offset of the current record
+    uint64_t position() const override { return m_offsets[m_chunk_pos]; };
+
+    void seek(uint64_t offset) override {
+      if (offset >= m_file.size()) {
+        throw ConfigurationError("Trace {} has no record at offset {}!", m_path, offset);
+      }
+      m_cursor = m_file.begin() + offset;
+      m_line_number = offset == 0 ? 1 : 0;
+      refill();
+    };
+
+  private:
+    void refill() {
+      m_chunk_size = 0;
+      m_chunk_pos = 0;
+      bool wrapped = false;
+      while (m_chunk_size < CHUNK_SIZE) {
+        if (m_cursor == m_file.end()) {
+          if (m_chunk_size != 0 || wrapped) {
+            // Wrap around with the next chunk (or there is no record at all)
+            return;
+          }
+          m_cursor = m_file.begin();
+          m_line_number = 1;
+          m_num_wraps++;
+          wrapped = true;
+          continue;
+        }
+
+        const char* line_end = static_cast<const char*>(memchr(m_cursor, '\n', m_file.end() - m_cursor));
+        if (line_end == nullptr) {
+          line_end = m_file.end();
+        }
+        TraceLineScanner scanner(m_cursor, line_end);
+        size_t offset = m_cursor - m_file.begin();
+        m_cursor = line_end == m_file.end() ? line_end : line_end + 1;
+        size_t line_number = m_line_number;
+        if (m_line_number != 0) {
+          m_line_number++;
+        }
+
+        if (scanner.at_end()) {
+          continue;
+        }
+        if (!Parser::parse(scanner, m_chunk[m_chunk_size]) || !scanner.at_end()) {
+          if (line_number != 0) {
+            throw ConfigurationError("Trace {} format invalid at line {}!", m_path, line_number);
+          }
+          throw ConfigurationError("Trace {} format invalid at offset {}!", m_path, offset);
+        }
+        m_offsets[m_chunk_size] = offset;
+        m_chunk_size++;
+      }
+    };
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_FRONTEND_MEMORY_TRACE_MAPPED_TRACE_H
@@ -0,0 +1,178 @@
+#include <memory>
+
+#include "frontend/frontend.h"
+#include "base/exception.h"
+#include "base/checkpoint.h"
+#include "frontend/impl/memory_trace/streamed_trace.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Replays one load/store trace per core (or tenant), each with its own cursor and request rate.
+ *
+ * @details
+ * Stream i sends its requests with source_id i, so the per-core statistics of the controllers and the source-aware
+ * schedulers (QoS, BLISS, ATLAS, PAR-BS) see the streams as cores. Every frontend cycle, each stream earns rate
+ * requests worth of credits and sends one request per whole credit. The streams take turns going first (round robin),
+ * and a stream stops for the cycle at the first request the memory system rejects, retrying it the next cycle.
+ *
+ */
+class MultiLoadStoreTrace : public IFrontEnd, public Implementation, public Checkpointable {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IFrontEnd, MultiLoadStoreTrace, "MultiLoadStoreTrace", "Load/Store memory address traces, one per core.")
+
+  private:
+    struct Trace {
+      bool is_write;
+      Addr_t addr;
+    };
+    struct TraceParser {
+      // "[<timestamp>] LD <addr>" or "[<timestamp>] ST <addr>" as in LoadStoreTrace, the timestamp ignored
+      static bool parse(TraceLineScanner& line, Trace& t) {
+        int64_t timestamp;
+        line.integer(timestamp);
+        std::string_view type = line.token();
+        if (type == "LD") {
+          t.is_write = false;
+        } else if (type == "ST") {
+          t.is_write = true;
+        } else {
+          return false;
+        }
+        int64_t addr;
+        if (!line.integer(addr)) {
+          return false;
+        }
+        t.addr = addr;
+        return true;
+      };
+    };
+
+    struct Stream {
+      std::unique_ptr<TraceSource<Trace>> trace;   // Streamed if the file is compressed, mapped otherwise
+      size_t start_position = 0;                   // Where the replay started in the trace file
+      Addr_t offset = 0;                           // Added to the addresses of the trace
+      double rate = 1.0;
+      double credits = 0.0;                        // Requests the stream may send, accumulated at its rate
+
+      size_t s_num_read_requests = 0;
+      size_t s_num_write_requests = 0;
+      size_t s_num_send_retries = 0;
+      size_t s_read_latency = 0;
+      size_t s_num_completed_reads = 0;
+      float s_avg_read_latency = 0;
+    };
+    std::vector<Stream> m_streams;
+    size_t m_first_stream = 0;      // The stream that goes first this cycle
+
+    Logger_t m_logger;
+
+  public:
+    void init() override {
+      std::vector<std::string> trace_paths = param<std::vector<std::string>>("traces").desc("A load store trace per core.").required();
+      std::vector<double> rates = param<std::vector<double>>("rates").desc("Requests per frontend cycle of every stream (one value for all, or one per trace).").default_val(std::vector<double>{1.0});
+      Addr_t stream_offset = param<Addr_t>("stream_offset").desc("Bytes between the address spaces of consecutive streams (0 = shared).").default_val(0);
+      m_clock_ratio = param<uint>("clock_ratio").required();
+
+      if (trace_paths.empty()) {
+        throw ConfigurationError("MultiLoadStoreTrace needs at least one trace!");
+      }
+      if (rates.size() != 1 && rates.size() != trace_paths.size()) {
+        throw ConfigurationError("MultiLoadStoreTrace has {} rates for {} traces!", rates.size(), trace_paths.size());
+      }
+      if (stream_offset < 0) {
+        throw ConfigurationError("MultiLoadStoreTrace stream_offset cannot be negative!");
+      }
+
+      m_logger = Logging::create_logger("MultiLoadStoreTrace");
+      m_streams.resize(trace_paths.size());
+      for (size_t i = 0; i < m_streams.size(); i++) {
+        Stream& stream = m_streams[i];
+        stream.trace = open_trace<Trace, TraceParser>(trace_paths[i]);
+        stream.offset = stream_offset * i;
+        stream.rate = rates.size() == 1 ? rates[0] : rates[i];
+        if (stream.rate <= 0.0) {
+          throw ConfigurationError("MultiLoadStoreTrace rate of stream {} must be positive!", i);
+        }
+        m_logger->info("Stream {}: opened trace file {} ({} bytes) at {} requests per cycle.", i, trace_paths[i], stream.trace->file_size(), stream.rate);
+
+        register_stat(stream.s_num_read_requests).name("num_read_requests_core{}", i);
+        register_stat(stream.s_num_write_requests).name("num_write_requests_core{}", i);
+        register_stat(stream.s_num_send_retries).name("num_send_retries_core{}", i);
+        register_stat(stream.s_avg_read_latency).name("avg_read_latency_core{}", i);
+      }
+    };
+
+
+    void tick() override {
+      for (size_t n = 0; n < m_streams.size(); n++) {
+        size_t stream_id = (m_first_stream + n) % m_streams.size();
+        Stream& stream = m_streams[stream_id];
+        stream.credits = std::min(stream.credits + stream.rate, std::max(stream.rate, 1.0));
+        while (stream.credits >= 1.0) {
+          const Trace& t = stream.trace->current();
+          int type = t.is_write ? Request::Type::Write : Request::Type::Read;
+          if (!m_memory_system->send({t.addr + stream.offset, type, int(stream_id), t.is_write ? nullptr : m_read_callback})) {
+            stream.s_num_send_retries++;
+            break;
+          }
+          stream.credits -= 1.0;
+          if (t.is_write) {
+            stream.s_num_write_requests++;
+          } else {
+            stream.s_num_read_requests++;
+          }
+          stream.trace->advance();
+        }
+      }
+      m_first_stream = (m_first_stream + 1) % m_streams.size();
+    };
+
+
+    void finalize() override {
+      for (Stream& stream : m_streams) {
+        stream.s_avg_read_latency = stream.s_num_completed_reads ? float(stream.s_read_latency) / float(stream.s_num_completed_reads) : 0.0f;
+      }
+      IFrontEnd::finalize();
+    };
+
+
+    int get_num_cores() override { return m_streams.size(); };
+
+
+    // The position in every trace
+    void save_checkpoint(std::ostream& out) override {
+      Checkpoint::write<uint64_t>(out, m_streams.size());
+      for (const Stream& stream : m_streams) {
+        Checkpoint::write<uint64_t>(out, stream.trace->file_size());
+        Checkpoint::write<uint64_t>(out, stream.trace->position());
+      }
+    };
+
+    void load_checkpoint(std::istream& in) override {
+      Checkpoint::expect<uint64_t>(in, m_streams.size(), "number of traces");
+      for (Stream& stream : m_streams) {
+        Checkpoint::expect<uint64_t>(in, stream.trace->file_size(), "trace file size");
+        stream.start_position = Checkpoint::read<uint64_t>(in);
+        stream.trace->seek(stream.start_position);
+      }
+    };
+
+  private:
+    RequestCallback m_read_callback = [this](Request& req) {
+      Stream& stream = m_streams[req.source_id];
+      stream.s_read_latency += req.depart - req.arrive;
+      stream.s_num_completed_reads++;
+    };
+
+    // Finished when every stream has sent every line of its trace once
+    bool is_finished() override {
+      for (const Stream& stream : m_streams) {
+        if (stream.trace->num_wraps() == 0 || stream.trace->position() < stream.start_position) {
+          return false;
+        }
+      }
+      return true;
+    };
+};
+
+}        // namespace Ramulator
@@ -0,0 +1,113 @@
+#ifndef     RAMULATOR_FRONTEND_MEMORY_TRACE_OPEN_LOOP_REPLAY_H
+#define     RAMULATOR_FRONTEND_MEMORY_TRACE_OPEN_LOOP_REPLAY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "base/type.h"
+#include "base/exception.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Holds the requests of a timestamped trace until their arrival cycle (open-loop replay).
+ *
+ * @details
+ * The timestamps are in frontend cycles. A request arrives (ts - ts0) / speedup cycles after the start of the replay,
+ * ts0 being the timestamp of the first request, so a speedup of 2 replays the trace at twice its recorded rate. A
+ * timestamp smaller than the previous one (e.g., when the trace wraps around) continues the timeline from the previous
+ * one instead of going back in time.
+ *
+ * Every cycle, the frontend sends the requests that have arrived, in order, until the memory system rejects one. A
+ * request sent after its arrival cycle is late by the difference (its issue lag), and a cycle that ends with an
+ * arrived request still unsent is a backlog cycle: the memory system cannot keep up with the recorded rate.
+ *
+ */
+class OpenLoopReplay {
+  private:
+    bool m_timed = false;
+    double m_speedup = 1.0;
+
+    Clk_t m_clk = 0;
+    int64_t m_origin = -1;      // The timestamp of the first request
+    int64_t m_offset = 0;       // Added to the timestamps after a wrap around
+    int64_t m_prev = -1;        // The previous timestamp (with the offset)
+
+  public:
+    size_t s_num_late_requests = 0;
+    size_t s_total_lag = 0;
+    size_t s_max_lag = 0;
+    size_t s_backlog_cycles = 0;
+    float s_avg_lag = 0;
+
+  public:
+    /**
+     * @brief    Sets the replay mode: "closed" (send as fast as the memory system accepts) or "timed".
+     *
+     */
+    void configure(const std::string& mode, double speedup) {
+      if (mode == "timed") {
+        m_timed = true;
+      } else if (mode != "closed") {
+        throw ConfigurationError("Unrecognized trace replay mode {} (closed or timed)!", mode);
+      }
+      if (speedup <= 0) {
+        throw ConfigurationError("The trace replay speedup must be positive (got {})!", speedup);
+      }
+      m_speedup = speedup;
+    };
+
+    bool is_timed() const { return m_timed; };
+
+    /**
+     * @brief    Advances the replay clock. Call at the end of every frontend tick, after sending.
+     *
+     */
+    void tick() { m_clk++; };
+
+    /**
+     * @brief    The cycle a request with timestamp arrives at.
+     *
+     */
+    Clk_t arrival(int64_t timestamp) {
+      if (timestamp < 0) {
+        throw ConfigurationError("Timed trace replay needs a timestamp on every trace record!");
+      }
+      if (m_origin == -1) {
+        m_origin = timestamp;
+      }
+      int64_t ts = timestamp + m_offset;
+      if (ts < m_prev) {
+        m_offset += m_prev - ts;
+        ts = m_prev;
+      }
+      m_prev = ts;
+      return Clk_t((ts - m_origin) / m_speedup);
+    };
+
+    /// Whether a request arriving at cycle arrival can be sent this cycle
+    bool has_arrived(Clk_t arrival) const { return arrival <= m_clk; };
+
+    /// Records the issue lag of a request sent this cycle
+    void on_sent(Clk_t arrival) {
+      size_t lag = m_clk - arrival;
+      if (lag > 0) {
+        s_num_late_requests++;
+        s_total_lag += lag;
+        s_max_lag = std::max(s_max_lag, lag);
+      }
+    };
+
+    /// Records a cycle that ends with an arrived request unsent
+    void on_backlog() { s_backlog_cycles++; };
+
+    void finalize(size_t num_sent) {
+      s_avg_lag = num_sent ? float(s_total_lag) / float(num_sent) : 0.0f;
+    };
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_FRONTEND_MEMORY_TRACE_OPEN_LOOP_REPLAY_H
@@ -1,26 +1,52 @@
-#include <filesystem>
-#include <iostream>
-#include <fstream>
+#include <memory>
 
 #include "frontend/frontend.h"
 #include "base/exception.h"
+#include "base/checkpoint.h"
+#include "frontend/impl/memory_trace/streamed_trace.h"
+#include "frontend/impl/memory_trace/open_loop_replay.h"
 
 namespace Ramulator {
 
-namespace fs = std::filesystem;
-
-class ReadWriteTrace : public IFrontEnd, public Implementation {
+class ReadWriteTrace : public IFrontEnd, public Implementation, public Checkpointable {
   RAMULATOR_REGISTER_IMPLEMENTATION(IFrontEnd, ReadWriteTrace, "ReadWriteTrace", "Read/Write DRAM address vector trace.")
 
   private:
     struct Trace {
       bool is_write;
       AddrVec_t addr_vec;
+      int64_t timestamp;      // -1 if the line has none
+    };
+    struct TraceParser {
+      // "[<timestamp>] R <addr_vec>" or "[<timestamp>] W <addr_vec>", the address vector as comma-separated integers
+      static bool parse(TraceLineScanner& line, Trace& t) {
+        if (!line.integer(t.timestamp)) {
+          t.timestamp = -1;
+        }
+        std::string_view type = line.token();
+        if (type == "R") {
+          t.is_write = false;
+        } else if (type == "W") {
+          t.is_write = true;
+        } else {
+          return false;
+        }
+        t.addr_vec.clear();
+        do {
+          int64_t addr;
+          if (t.addr_vec.size() == AddrVec_t::capacity() || !line.integer(addr)) {
+            return false;
+          }
+          t.addr_vec.push_back(addr);
+        } while (line.consume(','));
+        return true;
+      };
     };
-    std::vector<Trace> m_trace;
+    std::unique_ptr<TraceSource<Trace>> m_trace;   // Streamed if the file is compressed, mapped otherwise
 
-    size_t m_trace_length = 0;
-    size_t m_curr_trace_idx = 0;
+    OpenLoopReplay m_replay;
+    Clk_t m_arrival = -1;           // Of the current record in timed replay (-1 until computed)
+    size_t m_num_sent = 0;
 
     Logger_t m_logger;
 
@@ -30,64 +56,73 @@ class ReadWriteTrace : public IFrontEnd, public Implementation {
       m_clock_ratio = param<uint>("clock_ratio").required();
 
       m_logger = Logging::create_logger("ReadWriteTrace");
-      m_logger->info("Loading trace file {} ...", trace_path_str);
-      init_trace(trace_path_str);
-      m_logger->info("Loaded {} lines.", m_trace.size());      
+      m_trace = open_trace<Trace, TraceParser>(trace_path_str);
+      m_logger->info("Opened trace file {} ({} bytes).", trace_path_str, m_trace->file_size());
+
+      m_replay.configure(
+        param<std::string>("replay").desc("closed: send every cycle, timed: at the timestamps of the trace.").default_val("closed"),
+        param<double>("replay_speedup").desc("How many times faster than recorded a timed replay runs.").default_val(1.0)
+      );
+      if (m_replay.is_timed()) {
+        register_stat(m_replay.s_num_late_requests).name("replay_num_late_requests");
+        register_stat(m_replay.s_total_lag).name("replay_total_lag");
+        register_stat(m_replay.s_avg_lag).name("replay_avg_lag");
+        register_stat(m_replay.s_max_lag).name("replay_max_lag");
+        register_stat(m_replay.s_backlog_cycles).name("replay_backlog_cycles");
+      }
     };
 
 
     void tick() override {
-      const Trace& t = m_trace[m_curr_trace_idx];
+      if (m_replay.is_timed()) {
+        tick_timed();
+        return;
+      }
+      const Trace& t = m_trace->current();
       m_memory_system->send({t.addr_vec, t.is_write ? Request::Type::Write : Request::Type::Read});
-      m_curr_trace_idx = (m_curr_trace_idx + 1) % m_trace_length;
+      m_trace->advance();
     };
 
 
-  private:
-    void init_trace(const std::string& file_path_str) {
-      fs::path trace_path(file_path_str);
-      if (!fs::exists(trace_path)) {
-        throw ConfigurationError("Trace {} does not exist!", file_path_str);
-      }
+    void finalize() override {
+      m_replay.finalize(m_num_sent);
+      IFrontEnd::finalize();
+    };
 
-      std::ifstream trace_file(trace_path);
-      if (!trace_file.is_open()) {
-        throw ConfigurationError("Trace {} cannot be opened!", file_path_str);
-      }
 
-      std::string line;
-      while (std::getline(trace_file, line)) {
-        std::vector<std::string> tokens;
-        tokenize(tokens, line, " ");
+    // The position in the trace
+    void save_checkpoint(std::ostream& out) override {
+      Checkpoint::write<uint64_t>(out, m_trace->file_size());
+      Checkpoint::write<uint64_t>(out, m_trace->position());
+    };
 
-        // TODO: Add line number here for better error messages
-        if (tokens.size() != 2) {
-          throw ConfigurationError("Trace {} format invalid!", file_path_str);
-        }
+    void load_checkpoint(std::istream& in) override {
+      Checkpoint::expect<uint64_t>(in, m_trace->file_size(), "trace file size");
+      m_trace->seek(Checkpoint::read<uint64_t>(in));
+    };
 
-        bool is_write = false; 
-        if (tokens[0] == "R") {
-          is_write = false;
-        } else if (tokens[0] == "W") {
-          is_write = true;
-        } else {
-          throw ConfigurationError("Trace {} format invalid!", file_path_str);
+  private:
+    // Sends the records that have arrived, in order, until the memory system rejects one. Unlike the closed replay, a
+    // rejected request is retried, so that the lag and backlog show when the memory system cannot keep up.
+    void tick_timed() {
+      while (true) {
+        const Trace& t = m_trace->current();
+        if (m_arrival == -1) {
+          m_arrival = m_replay.arrival(t.timestamp);
         }
-
-        std::vector<std::string> addr_vec_tokens;
-        tokenize(addr_vec_tokens, tokens[1], ",");
-
-        AddrVec_t addr_vec;
-        for (const auto& token : addr_vec_tokens) {
-          addr_vec.push_back(std::stoll(token));
+        if (!m_replay.has_arrived(m_arrival)) {
+          break;
         }
-
-        m_trace.push_back({is_write, addr_vec});
+        if (!m_memory_system->send({t.addr_vec, t.is_write ? Request::Type::Write : Request::Type::Read})) {
+          m_replay.on_backlog();
+          break;
+        }
+        m_replay.on_sent(m_arrival);
+        m_num_sent++;
+        m_arrival = -1;
+        m_trace->advance();
       }
-
-      trace_file.close();
-
-      m_trace_length = m_trace.size();
+      m_replay.tick();
     };
 
     // TODO: FIXME
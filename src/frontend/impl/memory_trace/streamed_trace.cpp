@@ -0,0 +1,205 @@
+#include <cstdio>
+#include <filesystem>
+
+#ifdef RAMULATOR_ZSTD
+#include <zstd.h>
+#endif
+#ifdef RAMULATOR_LZ4
+#include <lz4frame.h>
+#endif
+
+#include "frontend/impl/memory_trace/streamed_trace.h"
+
+namespace Ramulator {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr unsigned char ZSTD_MAGIC[4] = {0x28, 0xB5, 0x2F, 0xFD};
+constexpr unsigned char LZ4_MAGIC[4]  = {0x04, 0x22, 0x4D, 0x18};
+
+enum class Compression { None, Zstd, Lz4 };
+
+Compression detect(const std::string& path) {
+  unsigned char magic[4] = {};
+  FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return Compression::None;
+  }
+  size_t num_read = std::fread(magic, 1, sizeof(magic), file);
+  std::fclose(file);
+  if (num_read == sizeof(magic) && std::memcmp(magic, ZSTD_MAGIC, sizeof(magic)) == 0) {
+    return Compression::Zstd;
+  }
+  if (num_read == sizeof(magic) && std::memcmp(magic, LZ4_MAGIC, sizeof(magic)) == 0) {
+    return Compression::Lz4;
+  }
+  return Compression::None;
+}
+
+
+class PlainByteStream : public TraceByteStream {
+  protected:
+    std::string m_path;
+    FILE* m_file;
+    size_t m_file_size;
+
+  public:
+    explicit PlainByteStream(const std::string& path): m_path(path) {
+      m_file = std::fopen(path.c_str(), "rb");
+      if (m_file == nullptr) {
+        throw ConfigurationError("Trace {} cannot be opened!", path);
+      }
+      m_file_size = fs::file_size(path);
+    };
+
+    ~PlainByteStream() override { std::fclose(m_file); };
+
+    size_t read(char* dst, size_t size) override {
+      size_t num_read = std::fread(dst, 1, size, m_file);
+      if (num_read == 0 && std::ferror(m_file)) {
+        throw ConfigurationError("Failed to read trace {}!", m_path);
+      }
+      return num_read;
+    };
+
+    void rewind() override { std::rewind(m_file); };
+
+    size_t file_size() const override { return m_file_size; };
+};
+
+
+#ifdef RAMULATOR_ZSTD
+class ZstdByteStream : public PlainByteStream {
+  private:
+    ZSTD_DCtx* m_ctx;
+    std::vector<char> m_in;
+    ZSTD_inBuffer m_in_buffer = {nullptr, 0, 0};
+    size_t m_frame_state = 0;     // The last return of ZSTD_decompressStream (0 at the end of a frame)
+
+  public:
+    explicit ZstdByteStream(const std::string& path): PlainByteStream(path), m_ctx(ZSTD_createDCtx()), m_in(ZSTD_DStreamInSize()) {
+      m_in_buffer.src = m_in.data();
+    };
+
+    ~ZstdByteStream() override { ZSTD_freeDCtx(m_ctx); };
+
+    size_t read(char* dst, size_t size) override {
+      ZSTD_outBuffer out = {dst, size, 0};
+      while (out.pos == 0) {
+        if (m_in_buffer.pos == m_in_buffer.size) {
+          m_in_buffer.size = PlainByteStream::read(m_in.data(), m_in.size());
+          m_in_buffer.pos = 0;
+        }
+        bool at_eof = m_in_buffer.size == 0;
+        if (at_eof && m_frame_state == 0) {
+          break;
+        }
+        // At the end of the file, only flushes what the decompressor holds
+        m_frame_state = ZSTD_decompressStream(m_ctx, &out, &m_in_buffer);
+        if (ZSTD_isError(m_frame_state)) {
+          throw ConfigurationError("Failed to decompress trace {}: {}", m_path, ZSTD_getErrorName(m_frame_state));
+        }
+        if (at_eof && out.pos == 0) {
+          throw ConfigurationError("Trace {} is truncated!", m_path);
+        }
+      }
+      return out.pos;
+    };
+
+    void rewind() override {
+      PlainByteStream::rewind();
+      ZSTD_DCtx_reset(m_ctx, ZSTD_reset_session_only);
+      m_in_buffer.size = m_in_buffer.pos = 0;
+      m_frame_state = 0;
+    };
+};
+#endif
+
+
+#ifdef RAMULATOR_LZ4
+class Lz4ByteStream : public PlainByteStream {
+  private:
+    LZ4F_dctx* m_ctx = nullptr;
+    std::vector<char> m_in = std::vector<char>(1 << 16);
+    size_t m_in_pos = 0;
+    size_t m_in_size = 0;
+    size_t m_frame_state = 0;     // The last return of LZ4F_decompress (0 at the end of a frame)
+
+  public:
+    explicit Lz4ByteStream(const std::string& path): PlainByteStream(path) {
+      if (LZ4F_isError(LZ4F_createDecompressionContext(&m_ctx, LZ4F_VERSION))) {
+        throw ConfigurationError("Failed to create the lz4 decompression context for trace {}!", path);
+      }
+    };
+
+    ~Lz4ByteStream() override { LZ4F_freeDecompressionContext(m_ctx); };
+
+    size_t read(char* dst, size_t size) override {
+      size_t num_out = 0;
+      while (num_out == 0) {
+        if (m_in_pos == m_in_size) {
+          m_in_size = PlainByteStream::read(m_in.data(), m_in.size());
+          m_in_pos = 0;
+        }
+        bool at_eof = m_in_size == 0;
+        if (at_eof && m_frame_state == 0) {
+          break;
+        }
+        // At the end of the file, only flushes what the decompressor holds
+        size_t dst_size = size;
+        size_t src_size = m_in_size - m_in_pos;
+        m_frame_state = LZ4F_decompress(m_ctx, dst, &dst_size, m_in.data() + m_in_pos, &src_size, nullptr);
+        if (LZ4F_isError(m_frame_state)) {
+          throw ConfigurationError("Failed to decompress trace {}: {}", m_path, LZ4F_getErrorName(m_frame_state));
+        }
+        m_in_pos += src_size;
+        num_out = dst_size;
+        if (at_eof && num_out == 0) {
+          throw ConfigurationError("Trace {} is truncated!", m_path);
+        }
+      }
+      return num_out;
+    };
+
+    void rewind() override {
+      PlainByteStream::rewind();
+      LZ4F_resetDecompressionContext(m_ctx);
+      m_in_pos = m_in_size = 0;
+      m_frame_state = 0;
+    };
+};
+#endif
+
+}        // namespace
+
+
+bool TraceByteStream::is_compressed(const std::string& path) {
+  return detect(path) != Compression::None;
+}
+
+std::unique_ptr<TraceByteStream> TraceByteStream::open(const std::string& path) {
+  if (!fs::exists(path)) {
+    throw ConfigurationError("Trace {} does not exist!", path);
+  }
+  switch (detect(path)) {
+    case Compression::Zstd:
+#ifdef RAMULATOR_ZSTD
+      return std::make_unique<ZstdByteStream>(path);
+#else
+      throw ConfigurationError("Trace {} is zstd compressed, but Ramulator was built without zstd!", path);
+#endif
+    case Compression::Lz4:
+#ifdef RAMULATOR_LZ4
+      return std::make_unique<Lz4ByteStream>(path);
+#else
+      throw ConfigurationError("Trace {} is lz4 compressed, but Ramulator was built without lz4!", path);
+#endif
+    case Compression::None:
+      break;
+  }
+  return std::make_unique<PlainByteStream>(path);
+}
+
+}        // namespace Ramulator
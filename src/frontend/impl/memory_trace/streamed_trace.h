@@ -0,0 +1,306 @@
+#ifndef     RAMULATOR_FRONTEND_MEMORY_TRACE_STREAMED_TRACE_H
+#define     RAMULATOR_FRONTEND_MEMORY_TRACE_STREAMED_TRACE_H
+
+#include <array>
+#include <algorithm>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <exception>
+#include <condition_variable>
+
+#include "base/exception.h"
+#include "frontend/impl/memory_trace/trace_source.h"
+#include "frontend/impl/memory_trace/mapped_trace.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Sequential reader of the decompressed bytes of a trace file
+ * @details
+ * zstd and lz4 (frame format) files are recognized by their magic numbers and decompressed on the fly, if the
+ * simulator was built with the library (RAMULATOR_ZSTD, RAMULATOR_LZ4). Other files are read as they are.
+ *
+ */
+class TraceByteStream {
+  public:
+    static std::unique_ptr<TraceByteStream> open(const std::string& path);
+
+    /**
+     * @brief    Returns whether the file at path is zstd or lz4 compressed.
+     *
+     */
+    static bool is_compressed(const std::string& path);
+
+    virtual ~TraceByteStream() = default;
+
+    /**
+     * @brief    Reads up to size decompressed bytes into dst. Returns 0 at the end of the file.
+     *
+     */
+    virtual size_t read(char* dst, size_t size) = 0;
+    virtual void rewind() = 0;
+    virtual size_t file_size() const = 0;
+};
+
+
+/**
+ * @brief    A text trace streamed from its (possibly compressed) file by a background reader thread
+ * @details
+ * The reader thread decompresses the file and decodes its lines with Parser::parse(TraceLineScanner&, Record&) (as
+ * MappedTrace) into two blocks of BLOCK_SIZE records: tick() consumes one block while the reader fills the other. At
+ * the end of the file the reader starts over from the beginning, so the trace loops without ever being held in memory
+ * as a whole. A block never spans the wrap around. The position of a record is its index in the trace.
+ *
+ */
+template<typename Record, typename Parser>
+class StreamedTrace : public TraceSource<Record> {
+  public:
+    static constexpr size_t BLOCK_SIZE = 4096;
+    static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+  private:
+    struct Block {
+      std::vector<Record> records;
+      uint64_t first_index = 0;       // The position of records[0]
+      size_t num_wraps = 0;
+      std::exception_ptr error;       // Why the reader stopped, delivered after the records
+    };
+
+    std::string m_path;
+    std::unique_ptr<TraceByteStream> m_stream;
+
+    std::array<Block, 2> m_blocks;
+    std::array<bool, 2> m_filled = {false, false};
+    bool m_stop = false;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::thread m_reader;
+
+    size_t m_block = 0;     // The block being consumed
+    size_t m_pos = 0;       // The current record in it
+
+  public:
+    explicit StreamedTrace(const std::string& path): m_path(path), m_stream(TraceByteStream::open(path)) {
+      for (Block& block : m_blocks) {
+        block.records.reserve(BLOCK_SIZE);
+      }
+      start(0);
+    };
+
+    ~StreamedTrace() {
+      stop();
+    };
+
+    const Record& current() const override { return m_blocks[m_block].records[m_pos]; };
+
+    void advance() override {
+      m_pos++;
+      if (m_pos == m_blocks[m_block].records.size()) {
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          m_filled[m_block] = false;
+        }
+        m_cv.notify_all();
+        m_block ^= 1;
+        wait_for_block();
+      }
+    };
+
+    size_t num_wraps() const override { return m_blocks[m_block].num_wraps; };
+
+    size_t file_size() const override { return m_stream->file_size(); };
+
+    // The index of the current record in the trace
+    uint64_t position() const override { return m_blocks[m_block].first_index + m_pos; };
+
+    void seek(uint64_t index) override {
+      stop();
+      m_stream->rewind();
+      start(index);
+    };
+
+  private:
+    void start(uint64_t skip) {
+      m_filled = {false, false};
+      m_stop = false;
+      m_block = 0;
+      m_reader = std::thread([this, skip] { read(skip); });
+      try {
+        wait_for_block();
+      } catch (...) {
+        stop();
+        throw;
+      }
+    };
+
+    void stop() {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+      }
+      m_cv.notify_all();
+      if (m_reader.joinable()) {
+        m_reader.join();
+      }
+    };
+
+    void wait_for_block() {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait(lock, [this] { return m_filled[m_block]; });
+      m_pos = 0;
+      if (m_blocks[m_block].records.empty() && m_blocks[m_block].error) {
+        std::rethrow_exception(m_blocks[m_block].error);
+      }
+    };
+
+    // Waits until the consumer is done with the block, returns false if the trace is being stopped
+    bool acquire(size_t block) {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait(lock, [this, block] { return !m_filled[block] || m_stop; });
+      if (m_stop) {
+        return false;
+      }
+      m_blocks[block].records.clear();
+      m_blocks[block].error = nullptr;
+      return true;
+    };
+
+    void publish(size_t block) {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_filled[block] = true;
+      }
+      m_cv.notify_all();
+    };
+
+    /**
+     * @brief    The reader thread: decodes the records after the first skip ones into the blocks, looping forever.
+     *
+     */
+    void read(uint64_t skip) {
+      size_t block = 0;
+      if (!acquire(block)) {
+        return;
+      }
+
+      std::vector<char> buffer(BUFFER_SIZE);
+      size_t begin = 0;               // The unparsed bytes are [begin, end)
+      size_t end = 0;
+      bool at_eof = false;
+      uint64_t index = 0;             // Of the next record in the trace
+      size_t num_wraps = 0;
+      size_t line_number = 1;
+      Record record;
+
+      try {
+        while (true) {
+          char* line_begin = buffer.data() + begin;
+          char* line_end = static_cast<char*>(memchr(line_begin, '\n', end - begin));
+          if (line_end == nullptr) {
+            if (!at_eof) {
+              // Refill the buffer after the partial line, growing it for very long lines
+              std::memmove(buffer.data(), line_begin, end - begin);
+              end -= begin;
+              begin = 0;
+              if (end == buffer.size()) {
+                buffer.resize(2 * buffer.size());
+              }
+              size_t num_read = m_stream->read(buffer.data() + end, buffer.size() - end);
+              at_eof = num_read == 0;
+              end += num_read;
+              continue;
+            }
+            if (begin == end) {
+              // The end of the trace
+              if (index == 0) {
+                throw ConfigurationError("Trace {} is empty!", m_path);
+              }
+              if (skip > 0) {
+                throw ConfigurationError("Trace {} has no record {}!", m_path, index + skip);
+              }
+              if (!m_blocks[block].records.empty()) {
+                publish(block);
+                block ^= 1;
+                if (!acquire(block)) {
+                  return;
+                }
+              }
+              m_stream->rewind();
+              begin = end = 0;
+              at_eof = false;
+              index = 0;
+              num_wraps++;
+              line_number = 1;
+              continue;
+            }
+            // The last line has no newline
+            line_end = buffer.data() + end;
+          }
+
+          TraceLineScanner line(line_begin, line_end);
+          begin = std::min<size_t>(line_end - buffer.data() + 1, end);
+          line_number++;
+          if (line.at_end()) {
+            continue;
+          }
+          if (!Parser::parse(line, record) || !line.at_end()) {
+            throw ConfigurationError("Trace {} format invalid at line {}!", m_path, line_number - 1);
+          }
+          if (skip > 0) {
+            skip--;
+            index++;
+            continue;
+          }
+
+          Block& current = m_blocks[block];
+          if (current.records.empty()) {
+            current.first_index = index;
+            current.num_wraps = num_wraps;
+          }
+          current.records.push_back(record);
+          index++;
+          if (current.records.size() == BLOCK_SIZE) {
+            publish(block);
+            block ^= 1;
+            if (!acquire(block)) {
+              return;
+            }
+          }
+        }
+      } catch (...) {
+        // Deliver the records decoded so far, then the error
+        Block& current = m_blocks[block];
+        current.error = std::current_exception();
+        publish(block);
+        if (!current.records.empty()) {
+          block ^= 1;
+          if (acquire(block)) {
+            m_blocks[block].error = current.error;
+            publish(block);
+          }
+        }
+      }
+    };
+};
+
+
+/**
+ * @brief    Opens a text trace: streamed by a reader thread if it is compressed, memory-mapped otherwise.
+ *
+ */
+template<typename Record, typename Parser>
+std::unique_ptr<TraceSource<Record>> open_trace(const std::string& path) {
+  if (TraceByteStream::is_compressed(path)) {
+    return std::make_unique<StreamedTrace<Record, Parser>>(path);
+  }
+  return std::make_unique<MappedTrace<Record, Parser>>(path);
+}
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_FRONTEND_MEMORY_TRACE_STREAMED_TRACE_H
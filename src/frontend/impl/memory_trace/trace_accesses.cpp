@@ -0,0 +1,98 @@
+#include "frontend/impl/memory_trace/trace_accesses.h"
+#include "frontend/impl/memory_trace/mapped_trace.h"
+#include "frontend/impl/memory_trace/binary_trace_format.h"
+
+namespace Ramulator {
+
+namespace TraceAccesses {
+
+namespace {
+
+void for_each_binary(const std::string& path, const std::string& kind, const Visitor& visit) {
+  if (kind == "LoadStore") {
+    BinaryTrace::Reader reader(path, BinaryTrace::Kind::LoadStore);
+    for (uint64_t i = 0; i < reader.header().num_records; i++) {
+      bool is_write;
+      Addr_t addr;
+      reader.load_store(is_write, addr);
+      visit(addr, is_write);
+    }
+  } else if (kind == "SimpleO3") {
+    BinaryTrace::Reader reader(path, BinaryTrace::Kind::SimpleO3);
+    for (uint64_t i = 0; i < reader.header().num_records; i++) {
+      int bubble_count;
+      Addr_t load_addr, store_addr;
+      reader.simple_o3(bubble_count, load_addr, store_addr);
+      visit(load_addr, false);
+      if (store_addr != -1) {
+        visit(store_addr, true);
+      }
+    }
+  } else {
+    BinaryTrace::Reader reader(path, BinaryTrace::Kind::LLCMiss);
+    BinaryTrace::LLCMissRecord record;
+    for (uint64_t i = 0; i < reader.header().num_records; i++) {
+      reader.llc_miss(record);
+      visit(record.addr, record.op == BinaryTrace::LLCOp::Writeback);
+    }
+  }
+}
+
+}       // namespace
+
+
+void for_each(const std::string& path, const std::string& kind, const Visitor& visit) {
+  if (kind != "LoadStore" && kind != "SimpleO3" && kind != "LLCMiss") {
+    throw ConfigurationError("Unrecognized trace kind {}!", kind);
+  }
+  if (BinaryTrace::is_binary_trace(path)) {
+    for_each_binary(path, kind, visit);
+    return;
+  }
+  if (kind == "LLCMiss") {
+    throw ConfigurationError("Trace {} is not a binary trace (LLCMiss traces only come in the binary format)!", path);
+  }
+
+  bool is_load_store = kind == "LoadStore";
+  MappedFile file(path);
+  const char* cursor = file.begin();
+  size_t line_number = 0;
+  while (cursor != file.end()) {
+    const char* line_end = static_cast<const char*>(memchr(cursor, '\n', file.end() - cursor));
+    if (line_end == nullptr) {
+      line_end = file.end();
+    }
+    TraceLineScanner line(cursor, line_end);
+    cursor = line_end == file.end() ? line_end : line_end + 1;
+    line_number++;
+    if (line.at_end()) {
+      continue;
+    }
+
+    bool valid = true;
+    if (is_load_store) {
+      std::string_view type = line.token();
+      int64_t addr;
+      valid = (type == "LD" || type == "ST") && line.integer(addr);
+      if (valid) {
+        visit(addr, type == "ST");
+      }
+    } else {
+      int64_t bubble_count, load_addr, store_addr = -1;
+      valid = line.integer(bubble_count) && line.integer(load_addr) && (line.at_end() || line.integer(store_addr));
+      if (valid) {
+        visit(load_addr, false);
+        if (store_addr != -1) {
+          visit(store_addr, true);
+        }
+      }
+    }
+    if (!valid || !line.at_end()) {
+      throw ConfigurationError("Trace {} format invalid at line {}!", path, line_number);
+    }
+  }
+}
+
+}        // namespace TraceAccesses
+
+}        // namespace Ramulator
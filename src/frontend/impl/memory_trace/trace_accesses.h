@@ -0,0 +1,33 @@
+#ifndef     RAMULATOR_FRONTEND_MEMORY_TRACE_TRACE_ACCESSES_H
+#define     RAMULATOR_FRONTEND_MEMORY_TRACE_TRACE_ACCESSES_H
+
+#include <string>
+#include <functional>
+
+#include "base/type.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    The memory accesses of a trace, in trace order, for the offline tools
+ * @details
+ * Reads the text or binary trace at path once, from the start to the end, and calls visit(addr, is_write) for every
+ * access. The kinds are:
+ *   LoadStore: one access per LD/ST record
+ *   SimpleO3:  the load of every record, then its store (if any)
+ *   LLCMiss:   one access per demand miss, prefetch (reads) and writeback (write), of all cores (binary traces only)
+ * Nothing is kept in memory besides the mapped file.
+ *
+ */
+namespace TraceAccesses {
+
+using Visitor = std::function<void(Addr_t addr, bool is_write)>;
+
+void for_each(const std::string& path, const std::string& kind, const Visitor& visit);
+
+}        // namespace TraceAccesses
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_FRONTEND_MEMORY_TRACE_TRACE_ACCESSES_H
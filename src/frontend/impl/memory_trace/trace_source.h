@@ -0,0 +1,44 @@
+#ifndef     RAMULATOR_FRONTEND_MEMORY_TRACE_TRACE_SOURCE_H
+#define     RAMULATOR_FRONTEND_MEMORY_TRACE_TRACE_SOURCE_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Ramulator {
+
+/**
+ * @brief    The records of a trace file, replayed in order and wrapping around at the end
+ *
+ */
+template<typename Record>
+class TraceSource {
+  public:
+    virtual ~TraceSource() = default;
+
+    virtual const Record& current() const = 0;
+    virtual void advance() = 0;
+
+    /**
+     * @brief    How many times the trace wrapped around.
+     *
+     */
+    virtual size_t num_wraps() const = 0;
+
+    /**
+     * @brief    The size of the trace file, to check that a checkpoint was saved with the same trace.
+     *
+     */
+    virtual size_t file_size() const = 0;
+
+    /**
+     * @brief    The position of the current record in the file. seek() to it resumes the trace there.
+     *
+     */
+    virtual uint64_t position() const = 0;
+    virtual void seek(uint64_t position) = 0;
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_FRONTEND_MEMORY_TRACE_TRACE_SOURCE_H
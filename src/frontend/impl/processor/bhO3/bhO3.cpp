@@ -19,6 +19,12 @@ void BHO3::init() {
   std::vector<std::string> no_wait_trace_list = param<std::vector<std::string>>("no_wait_traces").desc("Traces that do not block program termination.").default_val(empty_trace);
   m_num_cores = trace_list.size() + no_wait_trace_list.size();
   m_num_blocking_cores = trace_list.size();
+  // Parse the traces in parallel while the rest of the simulation is built
+  for (const auto* list : {&trace_list, &no_wait_trace_list}) {
+    for (const std::string& trace_path : *list) {
+      BHO3Core::Trace::prefetch(trace_path);
+    }
+  }
 
   int ipc   = param<int>("ipc").desc("IPC of the SimpleO3 core.").default_val(4);
   int depth = param<int>("inst_window_depth").desc("Instruction window size of the SimpleO3 core.").default_val(128);
@@ -32,6 +38,7 @@ void BHO3::init() {
   int llc_associativity     = param<int>("llc_associativity").desc("LLC set associativity.").default_val(8);
   int llc_capacity_per_core = parse_capacity_str(param<std::string>("llc_capacity_per_core").desc("LLC capacity per core.").default_val("2MB"));
   int llc_num_mshr_per_core = param<int>("llc_num_mshr_per_core").desc("Number of LLC MSHR entries per core.").default_val(16);
+  int llc_num_mshr_targets  = param<int>("llc_num_mshr_targets").desc("Number of requests that can wait for the line of an LLC MSHR entry.").default_val(8);
   
   llc_serialize = param<bool>("llc_serialize").desc("Whether to serialize the LLC.").default_val(false);
   llc_serialization_filename = param<std::string>("llc_serialization_filename").desc("Filename to serialize the LLC.").default_val("llc_serialization");
@@ -46,7 +53,7 @@ void BHO3::init() {
   m_translation = create_child_ifce<ITranslation>();
 
   // Create the LLC
-  m_llc = new BHO3LLC(llc_latency, llc_capacity_per_core * m_num_cores, llc_linesize_bytes, llc_associativity, llc_num_mshr_per_core * m_num_cores, m_num_cores);
+  m_llc = new BHO3LLC(llc_latency, llc_capacity_per_core * m_num_cores, llc_linesize_bytes, llc_associativity, llc_num_mshr_per_core * m_num_cores, llc_num_mshr_targets, m_num_cores);
   if (llc_deserialize) {
     if (!std::filesystem::exists(llc_deserialization_filename)) {
       throw std::runtime_error("LLC deserialization file not found.");
@@ -67,7 +74,7 @@ void BHO3::init() {
     BHO3Core* core = new BHO3Core(id, ipc, depth,
       m_num_expected_insts, m_num_max_cycles, active_list[active_id],
       cur_translate, m_llc, lat_hist_sensitivity, lat_dump_path, is_attacker);
-    core->m_callback = [this](Request& req){return this->receive(req);} ;
+    core->m_callback = [core](Request& req){return core->receive(req);} ;
     m_cores.push_back(core);
   }
 
@@ -82,6 +89,9 @@ void BHO3::init() {
   register_stat(m_llc->s_llc_write_misses).name("llc_write_misses");
   register_stat(m_llc->s_llc_mshr_unavailable).name("llc_mshr_unavailable");
   register_stat(m_llc->s_llc_mshr_blacklisted).name("llc_mshr_blacklisted");
+  register_stat(m_llc->s_llc_mshr_target_full).name("llc_mshr_target_full");
+  register_stat(m_llc->s_llc_mshr_occupancy_avg).name("llc_mshr_occupancy_avg");
+  register_stat(m_llc->s_llc_mshr_occupancy_max).name("llc_mshr_occupancy_max");
   
   for (int core_id = 0; core_id < m_cores.size(); core_id++) {
     register_stat(m_cores[core_id]->s_cycles_recorded).name("cycles_recorded_core_{}", core_id);
@@ -104,16 +114,9 @@ void BHO3::tick() {
   }
 }
 
-void BHO3::receive(Request& req) {
-  m_llc->receive(req);
-
-  // TODO: LLC latency for the core to receive the request?
-  for (auto r : m_llc->m_receive_requests[req.addr]) {
-    r.arrive = req.arrive;
-    r.depart = req.depart;
-    m_cores[r.source_id]->receive(r);
-  }
-  m_llc->m_receive_requests[req.addr].clear();
+void BHO3::finalize() {
+  m_llc->finalize();
+  IFrontEnd::finalize();
 }
 
 bool BHO3::is_finished() {
@@ -31,7 +31,7 @@ class BHO3 final : public IFrontEnd, public Implementation {
   public:
     void init() override;
     void tick() override;
-    void receive(Request& req);
+    void finalize() override;
     bool is_finished() override;
     void connect_memory_system(IMemorySystem* memory_system) override;
     int get_num_cores() override;
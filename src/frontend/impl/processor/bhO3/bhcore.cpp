@@ -6,6 +6,7 @@
 
 #include "base/exception.h"
 #include "base/utils.h"
+#include "frontend/impl/processor/o3_trace.h"
 #include "frontend/impl/processor/bhO3/bhcore.h"
 #include "frontend/impl/processor/bhO3/bhllc.h"
 
@@ -14,43 +15,16 @@ namespace Ramulator {
 namespace fs = std::filesystem;
 
 BHO3Core::Trace::Trace(std::string file_path_str) {
-  fs::path trace_path(file_path_str);
-  if (!fs::exists(trace_path)) {
-    throw ConfigurationError("Trace {} does not exist!", file_path_str);
-  }
-
-  std::ifstream trace_file(trace_path);
-  if (!trace_file.is_open()) {
-    throw ConfigurationError("Trace {} cannot be opened!", file_path_str);
-  }
-
-  std::string line;
-  while (std::getline(trace_file, line)) {
-    std::vector<std::string> tokens;
-    tokenize(tokens, line, " ");
-
-    int num_tokens = tokens.size();
-    if (num_tokens != 2 & num_tokens != 3) {
-      throw ConfigurationError("Trace {} format invalid!", file_path_str);
-    }
-    int bubble_count = std::stoi(tokens[0]);
-    Addr_t load_addr = std::stoll(tokens[1]);
-
-    bool has_store = num_tokens == 2 ? false : true; 
-    if (has_store) {
-      Addr_t store_addr = std::stoll(tokens[2]);
-      m_trace.push_back({bubble_count, load_addr, store_addr});
-    } else {
-      m_trace.push_back({bubble_count, load_addr, -1});
-    }
-  }
+  m_trace = TraceCache::load<Inst>(file_path_str, [&file_path_str] { return parse_o3_trace<Inst>(file_path_str); });
+  m_trace_length = m_trace->size();
+}
 
-  trace_file.close();
-  m_trace_length = m_trace.size();
+void BHO3Core::Trace::prefetch(const std::string& file_path_str) {
+  TraceCache::prefetch<Inst>(file_path_str, [file_path_str] { return parse_o3_trace<Inst>(file_path_str); });
 }
 
 const BHO3Core::Inst& BHO3Core::Trace::get_next_inst() {
-  const Inst& inst = m_trace[m_curr_trace_idx];
+  const Inst& inst = (*m_trace)[m_curr_trace_idx];
   m_curr_trace_idx = (m_curr_trace_idx + 1) % m_trace_length;
   return inst;
 }
@@ -8,6 +8,7 @@
 #include <fstream>
 
 #include "base/type.h"
+#include "base/trace_cache.h"
 #include "base/request.h"
 #include "translation/translation.h"
 
@@ -26,13 +27,16 @@ class BHO3Core: public Clocked<BHO3Core> {
   class Trace {
     friend class BHO3Core;
 
-    std::vector<Inst> m_trace;
+    TraceCache::Trace_t<Inst> m_trace;   // Shared with every core replaying the same file
     size_t m_trace_length = 0;
     size_t m_curr_trace_idx = 0;
 
     public:
       Trace(std::string file_path_str);
       const Inst& get_next_inst();
+
+      // Starts parsing the trace in the background, so that the cores replaying it wait less for it
+      static void prefetch(const std::string& file_path_str);
   };
 
   /**
@@ -90,7 +94,7 @@ class BHO3Core: public Clocked<BHO3Core> {
     ITranslation* m_translation;
     BHO3LLC* m_llc;
 
-    std::function<void(Request&)> m_callback;
+    RequestCallback m_callback;
 
     int    m_num_bubbles = 0;
     Addr_t m_load_addr = -1;
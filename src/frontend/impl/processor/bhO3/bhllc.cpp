@@ -4,8 +4,10 @@
 
 namespace Ramulator {
 
-BHO3LLC::BHO3LLC(int latency, int size_bytes, int linesize_bytes, int associativity, int num_mshrs, int num_cores):
-m_latency(latency), m_size_bytes(size_bytes), m_linesize_bytes(linesize_bytes), m_associativity(associativity), m_num_mshrs(num_mshrs) {
+BHO3LLC::BHO3LLC(int latency, int size_bytes, int linesize_bytes, int associativity, int num_mshrs, int num_mshr_targets, int num_cores):
+m_lines(size_bytes / (linesize_bytes * associativity), associativity), m_mshrs(num_mshrs, num_mshr_targets), m_miss_list(latency), m_hit_list(latency),
+m_latency(latency), m_size_bytes(size_bytes), m_linesize_bytes(linesize_bytes), m_associativity(associativity) {
+  m_fill_callback = [this](Request& req) { receive(req); };
   m_logger = Logging::create_logger("BHO3LLC");
 
   m_set_size = m_size_bytes / (m_linesize_bytes * m_associativity);
@@ -27,40 +29,21 @@ m_latency(latency), m_size_bytes(size_bytes), m_linesize_bytes(linesize_bytes),
 void BHO3LLC::tick() {
   m_clk++;
 
+  s_llc_mshr_occupancy += m_mshrs.occupancy();
+  s_llc_mshr_occupancy_max = std::max<int>(s_llc_mshr_occupancy_max, m_mshrs.occupancy());
+
   // Send miss requests to the memory system when LLC latency is met
-  // TODO: Optimization by assuming in-order issue?
-  auto it = m_miss_list.begin(); 
-  while (it != m_miss_list.end()) {
-    if (m_clk >= it->first) {
-      if (!m_memory_system->send(it->second)) {
-        it++;
-      }
-      else {
-        it = m_miss_list.erase(it);
-      }
-    } else {
-      it++;
-    }
-  }
+  m_miss_list.drain(m_clk, [this](Request& req) { return m_memory_system->send(req); });
 
   // call hit request callback when LLC latency is met
-  it = m_hit_list.begin();
-  while (it != m_hit_list.end()) {
-    if (m_clk >= it->first) {
-      std::vector<Request> _req_v{it->second};
-      m_receive_requests[it->second.addr] = _req_v;
-
-      it->second.callback(it->second);
-      it = m_hit_list.erase(it);
-    } 
-    else {
-      it++;
-    }
-  }
+  m_hit_list.drain(m_clk, [](Request& req) {
+    req.callback(req);
+    return true;
+  });
 }
 
 bool BHO3LLC::send(Request& req) {
-  CacheSet_t& set = get_set(req.addr);
+  int set = get_index(req.addr);
 
   if (req.type_id == Request::Type::Read) {
     s_llc_read_access++;
@@ -68,7 +51,7 @@ bool BHO3LLC::send(Request& req) {
     s_llc_write_access++;
   }
 
-  if (auto line_it = check_set_hit(set, req.addr); line_it != set.end()) {
+  if (int way = check_set_hit(set, req.addr); way != -1) {
     // Hit in the set
     DEBUG_LOG(DBHO3LLC, m_logger, 
     "[Clk={}] Request Source: {}, Type: {}, Addr: {}, Index: {}, Tag: {}. Hit, will finish at Clk={}", 
@@ -76,11 +59,13 @@ bool BHO3LLC::send(Request& req) {
     );
 
     // Update the LRU status
-    set.push_back({req.addr, get_tag(req.addr), line_it->dirty || (req.type_id == Request::Type::Write), true});
-    set.erase(line_it);
+    m_lines.touch(set, way);
+    if (req.type_id == Request::Type::Write) {
+      m_lines.set_dirty(m_lines.line(set, way));
+    }
 
     // Add to the hit list to callback when finished
-    m_hit_list.push_back(std::make_pair(m_clk + m_latency, req));
+    m_hit_list.schedule(m_clk + m_latency, req);
     return true;
   } else {
     // Miss in the set
@@ -101,13 +86,18 @@ bool BHO3LLC::send(Request& req) {
     }
 
     // MSHR lookup
-    auto mshr_it = check_mshr_hit(req.addr);
-    if (mshr_it != m_mshrs.end()) {
+    if (int mshr = m_mshrs.find(align(req.addr)); mshr != -1) {
       DEBUG_LOG(DBHO3LLC, m_logger,  "MSHR Hit.", m_clk);
-      // Add new req to MSHR_requests
-      m_receive_requests[mshr_it->first].push_back(req);
+      if (m_mshrs.is_target_full(mshr)) {
+        DEBUG_LOG(DBHO3LLC, m_logger,  "No MSHR target available.", m_clk);
+        s_llc_mshr_target_full++;
+        return false;
+      }
+      m_mshrs.add_target(mshr, req);
 
-      mshr_it->second->dirty = dirty || mshr_it->second->dirty;
+      if (dirty) {
+        m_lines.set_dirty(m_mshrs[mshr].line);
+      }
       return true;
     }
 
@@ -123,45 +113,37 @@ bool BHO3LLC::send(Request& req) {
     
     // MSHR miss
     // Check if there is available MSHR entry
-    if (m_mshrs.size() == m_num_mshrs) {
+    if (m_mshrs.is_full()) {
       DEBUG_LOG(DBHO3LLC, m_logger,  "No MSHR entry available.", m_clk);
       s_llc_mshr_unavailable++;
       return false;
     }
 
     // Check if there is available cache line in the set
-    bool line_available = false;
-    if (set.size() < m_associativity) {
-      line_available = true;
-    } else {
-      for (const auto& line : set) {
-        if (line.ready) {
-          line_available = true;
-        }
-      }
-    }
-    if (!line_available) {
+    if (m_lines.find_empty(set) == -1 && m_lines.find_victim(set) == -1) {
       DEBUG_LOG(DBHO3LLC, m_logger,  "No cache line available in the set.", m_clk);
       return false;
     }
 
     // Allocate a new cache line
-    auto newline_it = allocate_line(set, req.addr);
-    if (newline_it == set.end()) {
+    int newline_way = allocate_line(set, req.addr);
+    if (newline_way == -1) {
       // Should this happen?
       throw std::runtime_error("Failed to allocate new line when there is available entry.");
       return false;
     }
-    newline_it->dirty = dirty;
+    size_t newline = m_lines.line(set, newline_way);
+    if (dirty) {
+      m_lines.set_dirty(newline);
+    }
     
-    // Add to MSHR entries
-    m_mshrs.push_back(std::make_pair(req.addr, newline_it));
-    // Add Request to MSHR_requests
-    std::vector<Request> _req_v{req};
-    m_receive_requests[req.addr] = _req_v;
+    // Add to MSHR entries, the LLC fills the line when the memory system responds
+    m_mshrs.allocate(align(req.addr), newline, req);
+    Request miss_req = req;
+    miss_req.callback = m_fill_callback;
 
     // Add to the miss request list
-    m_miss_list.push_back(std::make_pair(m_clk + m_latency, req));
+    m_miss_list.schedule(m_clk + m_latency, miss_req);
 
     // BH Changes Begin
     if (req.source_id >= 0) {
@@ -173,105 +155,86 @@ bool BHO3LLC::send(Request& req) {
 }
 
 void BHO3LLC::receive(Request& req) {
-  auto it = std::find_if(
-    m_mshrs.begin(), m_mshrs.end(),
-    [&req, this](MSHREntry_t mshr_entry) { return (align(mshr_entry.first) == align(req.addr)); }
-  );
-
   DEBUG_LOG(DBHO3LLC, m_logger, "[Clk={}] Request {} received.", m_clk, req.addr);
 
-  if (it != m_mshrs.end()) {
-    it->second->ready = true;
-    m_mshrs.erase(it);
-    // BH Changes Begin
-    if (req.source_id >= 0) {
-      m_allocated_mshrs[req.source_id]--;
-    }
-    // BH Changes End
+  int mshr = m_mshrs.find(align(req.addr));
+  if (mshr == -1) {
+    return;
+  }
+  MSHRFile::Entry& entry = m_mshrs[mshr];
+  m_lines.set_ready(entry.line);
+  // TODO: LLC latency for the core to receive the request?
+  for (Request& target : entry.targets) {
+    target.arrive = req.arrive;
+    target.depart = req.depart;
+    target.callback(target);
+  }
+  m_mshrs.release(mshr);
+  // BH Changes Begin
+  if (req.source_id >= 0) {
+    m_allocated_mshrs[req.source_id]--;
   }
+  // BH Changes End
 }
 
-BHO3LLC::CacheSet_t& BHO3LLC::get_set(Addr_t addr) {
-  int set_index = get_index(addr);
-  if (m_cache_sets.find(set_index) == m_cache_sets.end()) {
-    m_cache_sets.insert(make_pair(set_index, std::list<Line>()));
-  }
-  return m_cache_sets[set_index];
+void BHO3LLC::finalize() {
+  s_llc_mshr_occupancy_avg = m_clk > 0 ? float(s_llc_mshr_occupancy) / m_clk : 0;
 }
 
-BHO3LLC::CacheSet_t::iterator BHO3LLC::allocate_line(CacheSet_t& set, Addr_t addr) {
+int BHO3LLC::allocate_line(int set, Addr_t addr) {
+  // Due to MSHR, the line cannot be in the set already. Just for checking
+  assert(m_lines.find(set, get_tag(addr)) == -1);
+
   // Check if we need to evict any line
-  if (need_eviction(set, addr)) {
+  int way = m_lines.find_empty(set);
+  if (way == -1) {
     // Get a victim to evict
-    auto victim = std::find_if(set.begin(), set.end(), [this](Line line) { return line.ready; });
-    if (victim == set.end())
-      return victim;  // doesn't exist a line that's already unlocked in each level
-    evict_line(set, victim);
+    way = m_lines.find_victim(set);
+    if (way == -1)
+      return way;  // doesn't exist a line that's already unlocked in each level
+    evict_line(set, way);
   }
 
-  // Allocate new cache line and return an iterator to it
-  set.push_back({addr, get_tag(addr)});
-  return --set.end();
+  // Allocate the new cache line as the most-recently-used way
+  m_lines.fill(set, way, get_tag(addr), 0);
+  return way;
 }
 
-bool BHO3LLC::need_eviction(const CacheSet_t& set, Addr_t addr) {
-  if (std::find_if(set.begin(), set.end(), 
-            [addr, this](Line l) { return (get_tag(addr) == l.tag); }) 
-      != set.end()) {
-    // Due to MSHR, the program can't reach here. Just for checking
-    assert(false);
-    return false;
-  } 
-  else {
-    if (set.size() < m_associativity) {
-      return false;
-    } else {
-      return true;
-    }
-  }
-}
-
-void BHO3LLC::evict_line(CacheSet_t& set, CacheSet_t::iterator victim_it) {
-  DEBUG_LOG(DBHO3LLC, m_logger,  "Evicting {}.", victim_it->addr);
+void BHO3LLC::evict_line(int set, int way) {
+  size_t line = m_lines.line(set, way);
+  Addr_t victim_addr = line_addr(set, m_lines.tag(line));
+  DEBUG_LOG(DBHO3LLC, m_logger,  "Evicting {}.", victim_addr);
   s_llc_eviction++;
 
   // Generate writeback request if victim line is dirty
-  if (victim_it->dirty) {
-    Request writeback_req(victim_it->addr, Request::Type::Write);
-    m_miss_list.push_back(std::make_pair(m_clk + m_latency, writeback_req));
+  if (m_lines.is_dirty(line)) {
+    Request writeback_req(victim_addr, Request::Type::Write);
+    m_miss_list.schedule(m_clk + m_latency, writeback_req);
 
     DEBUG_LOG(DBHO3LLC, m_logger,  "Writeback Request will be issued at Clk={}.", m_clk + m_latency);
   }
 
-  set.erase(victim_it);
+  m_lines.invalidate(set, way);
 }
 
-BHO3LLC::CacheSet_t::iterator BHO3LLC::check_set_hit(CacheSet_t& set, Addr_t addr) {
-  auto line_it = std::find_if(set.begin(), set.end(), [addr, this](Line l){return (l.tag == get_tag(addr));});
-  if (line_it == set.end() || !line_it->ready) {
-    return set.end();
+int BHO3LLC::check_set_hit(int set, Addr_t addr) {
+  int way = m_lines.find(set, get_tag(addr));
+  if (way == -1 || !m_lines.is_ready(m_lines.line(set, way))) {
+    return -1;
   } else {
-    return line_it;
+    return way;
   }
 }
 
-BHO3LLC::MSHR_t::iterator BHO3LLC::check_mshr_hit(Addr_t addr) {
-  auto mshr_it =
-    std::find_if(
-      m_mshrs.begin(), m_mshrs.end(),
-      [addr, this](MSHREntry_t mshr_entry) { return (align(mshr_entry.first) == align(addr)); }
-    );
-  return mshr_it;
-}
-
 void BHO3LLC::serialize(std::string serialization_filename) {
   std::ofstream serialization_file;
   serialization_file.open(serialization_filename, std::ios::out);
 
   serialization_file << "index,addr,tag,dirty" << std::endl;
-  for (auto it1 = m_cache_sets.begin(); it1 != m_cache_sets.end(); it1++) {
-    for (auto it2 = it1->second.begin(); it2 != it1->second.end(); it2++) {
-      serialization_file << it1->first << "," << it2->addr << "," << it2->tag << "," << it2->dirty << std::endl;
+  for (int set = 0; set < m_set_size; set++) {
+    for (int way : m_lines.lru_order(set)) {
+      size_t line = m_lines.line(set, way);
+      serialization_file << set << "," << line_addr(set, m_lines.tag(line)) << "," << m_lines.tag(line) << "," << m_lines.is_dirty(line) << std::endl;
     }
   }
   serialization_file.close();
@@ -293,13 +256,13 @@ void BHO3LLC::deserialize(std::string serialization_filename) {
     std::string dirty_str = file_line.substr(0, file_line.find(","));
     
     int index = std::stoi(index_str);
-    Addr_t addr = std::stoll(addr_str);
     Addr_t tag = std::stoll(tag_str);
     bool dirty = std::stoi(dirty_str);
-    if(m_cache_sets.find(index) == m_cache_sets.end()){
-      m_cache_sets.insert({index, std::list<BHO3LLC::Line>()});
+    int way = m_lines.find_empty(index);
+    if (way == -1) {
+      throw std::runtime_error("Serialized LLC set has more lines than the associativity.");
     }
-    m_cache_sets[index].push_back({addr, tag, dirty, 1});
+    m_lines.fill(index, way, tag, SetAssocArray::READY | (dirty ? SetAssocArray::DIRTY : 0));
   }
   serialization_file.close();
 }
@@ -311,9 +274,10 @@ void BHO3LLC::dump_llc() {
    */
   std::cout << "Dumping LLC" << std::endl;
   std::cout << "index,addr,tag,dirty,ready" << std::endl;
-  for (auto it1 = m_cache_sets.begin(); it1 != m_cache_sets.end(); it1++) {
-    for (auto it2 = it1->second.begin(); it2 != it1->second.end(); it2++) {
-      std::cout << it1->first << "," << it2->addr << "," << it2->tag << "," << it2->dirty << "," << it2->ready << std::endl;
+  for (int set = 0; set < m_set_size; set++) {
+    for (int way : m_lines.lru_order(set)) {
+      size_t line = m_lines.line(set, way);
+      std::cout << set << "," << line_addr(set, m_lines.tag(line)) << "," << m_lines.tag(line) << "," << m_lines.is_dirty(line) << "," << m_lines.is_ready(line) << std::endl;
     }
   }
 }
@@ -360,10 +324,9 @@ void BHO3LLC::erase_blacklist(int source_id) {
 // TODO: I'll do some stuff to limit number of clflushes issable in a window (@Oguzhan)
 // Currently everything returns true
 bool BHO3LLC::clflush(Addr_t addr) {
-  CacheSet_t& set = get_set(addr);
-  auto line_it = check_set_hit(set, addr);
-  if (line_it != set.end()) {
-    evict_line(set, line_it);
+  int set = get_index(addr);
+  if (int way = check_set_hit(set, addr); way != -1) {
+    evict_line(set, way);
   }
   return true;
 }
@@ -2,7 +2,6 @@
 #define     RAMULATOR_FRONTEND_PROCESSOR_BH_O3_LLC_H
 
 #include <vector>
-#include <list>
 #include <unordered_map>
 #include <iostream>
 #include <fstream>
@@ -11,6 +10,9 @@
 #include "base/debug.h"
 #include "base/type.h"
 #include "base/request.h"
+#include "base/timing_wheel.h"
+#include "frontend/impl/processor/set_assoc_array.h"
+#include "frontend/impl/processor/mshr_file.h"
 #include "memory_system/bh_memory_system.h"
 
 // BH Changes Begin
@@ -25,29 +27,19 @@ DECLARE_DEBUG_FLAG(DBHO3LLC);
 class BHO3LLC : public Clocked<BHO3LLC> {
   friend class BHO3;
 
-  struct Line {
-    Addr_t addr = -1;
-    Addr_t tag = -1;
-    bool dirty = false;
-    bool ready = false;   // Whether this line is ready (i.e., is still inflight?)
-  };
-
   private:
-    using CacheSet_t = std::list<Line>;   // LRU queue for the set. The head of the list is the least-recently-used way.
-    std::unordered_map<int, CacheSet_t> m_cache_sets;
-    
-    using MSHREntry_t = std::pair<Addr_t, CacheSet_t::iterator>;
-    using MSHR_t = std::vector<MSHREntry_t>;
-    MSHR_t m_mshrs;
-    std::unordered_map<Addr_t, std::vector<Request>> m_receive_requests;
+    SetAssocArray m_lines;
+
+    MSHRFile m_mshrs;
+    RequestCallback m_fill_callback;      // Of the miss requests sent to the memory system
 
-    // Request that miss in the LLC with the clock cycle (current cycle + llc latency) that they 
+    // Request that miss in the LLC, due at the clock cycle (current cycle + llc latency) that they 
     // should be sent to the memory system
-    std::list<std::pair<Clk_t, Request>> m_miss_list;
+    TimingWheel<Request> m_miss_list;
 
-    // Request that hit in the LLC with the clock cycle (current cycle + llc latency) that they 
+    // Request that hit in the LLC, due at the clock cycle (current cycle + llc latency) that they 
     // should be sent back to the core (calls the callback)
-    std::list<std::pair<Clk_t, Request>> m_hit_list;
+    TimingWheel<Request> m_hit_list;
 
     IMemorySystem* m_memory_system;
 
@@ -66,7 +58,6 @@ class BHO3LLC : public Clocked<BHO3LLC> {
     size_t m_linesize_bytes;
     int m_associativity;
     int m_set_size;
-    int m_num_mshrs;
 
     Addr_t m_index_mask;
     int m_index_offset;
@@ -79,6 +70,10 @@ class BHO3LLC : public Clocked<BHO3LLC> {
     int s_llc_write_misses = 0;
     int s_llc_eviction = 0;
     int s_llc_mshr_unavailable = 0;
+    int s_llc_mshr_target_full = 0;
+    uint64_t s_llc_mshr_occupancy = 0;    // Summed over the cycles
+    float s_llc_mshr_occupancy_avg = 0;
+    int s_llc_mshr_occupancy_max = 0;
     int s_llc_mshr_blacklisted = 0;
     
     // BH Changes Begin
@@ -96,13 +91,20 @@ class BHO3LLC : public Clocked<BHO3LLC> {
     // BH Changes End
 
   public:
-    BHO3LLC(int latency, int size_bytes, int linesize_bytes, int associativity, int num_mshrs, int num_cores);
+    BHO3LLC(int latency, int size_bytes, int linesize_bytes, int associativity, int num_mshrs, int num_mshr_targets, int num_cores);
     void connect_memory_system(IMemorySystem* memory_system);
     
     void tick();
     bool send(Request& req);
+    /**
+     * @brief   Fills the line that the memory system served req for, and responds to all the requests waiting for it.
+     * 
+     */
     void receive(Request& req);
 
+    // Computes the average statistics at the end of the simulation
+    void finalize();
+
     void serialize(std::string serialization_filename);
     void deserialize(std::string serialization_filename);
     void dump_llc();
@@ -120,13 +122,13 @@ class BHO3LLC : public Clocked<BHO3LLC> {
     Addr_t get_tag(Addr_t addr) { return (addr >> m_tag_offset); }
     Addr_t align(Addr_t addr)   { return (addr & ~(m_linesize_bytes-1l)); }
 
-    CacheSet_t& get_set(Addr_t addr);
-    CacheSet_t::iterator allocate_line(CacheSet_t& set, Addr_t addr);
-    bool need_eviction(const CacheSet_t& set, Addr_t addr);
-    void evict_line(CacheSet_t& set, CacheSet_t::iterator victim_it);
+    // The address of the line (the tag of the way) of the set
+    Addr_t line_addr(int set, Addr_t tag) { return (tag << m_tag_offset) | (Addr_t(set) << m_index_offset); }
+
+    int allocate_line(int set, Addr_t addr);
+    void evict_line(int set, int way);
 
-    CacheSet_t::iterator check_set_hit(CacheSet_t& set, Addr_t addr);
-    MSHR_t::iterator check_mshr_hit(Addr_t addr);
+    int check_set_hit(int set, Addr_t addr);
     std::unordered_set<uint32_t>& get_bank_blacklist(Request& req);
 };
 
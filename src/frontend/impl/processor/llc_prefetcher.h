@@ -0,0 +1,215 @@
+#ifndef     RAMULATOR_FRONTEND_PROCESSOR_LLC_PREFETCHER_H
+#define     RAMULATOR_FRONTEND_PROCESSOR_LLC_PREFETCHER_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "base/type.h"
+#include "base/exception.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Generates the lines an LLC prefetches from its demand accesses.
+ * @details
+ * Addresses are line numbers (the byte address divided by the line size). The LLC trains the prefetcher with every
+ * demand access it accepts, and filters out the candidates it already has or is filling. An access is a trigger if it
+ * missed or is the first demand access to a prefetched line, so that a prefetched stream keeps running ahead of the
+ * demand accesses after it stops missing.
+ *
+ */
+class LLCPrefetcher {
+  protected:
+    int m_degree;       // Lines prefetched per trigger
+    int m_distance;     // How far ahead of the access the first prefetched line is (in lines, or strides)
+
+  public:
+    LLCPrefetcher(int degree, int distance): m_degree(degree), m_distance(distance) {
+      if (degree < 1 || distance < 1) {
+        throw ConfigurationError("LLC prefetcher needs a positive degree and distance, got {} and {}!", degree, distance);
+      }
+    };
+    virtual ~LLCPrefetcher() = default;
+
+    /**
+     * @brief    Trains on a demand access to line and appends the lines to prefetch to candidates.
+     *
+     */
+    virtual void on_access(Addr_t line, bool is_trigger, std::vector<Addr_t>& candidates) = 0;
+};
+
+
+/**
+ * @brief    Prefetches the degree lines from distance lines after every trigger.
+ *
+ */
+class NextLinePrefetcher : public LLCPrefetcher {
+  public:
+    NextLinePrefetcher(int degree, int distance): LLCPrefetcher(degree, distance) {};
+
+    void on_access(Addr_t line, bool is_trigger, std::vector<Addr_t>& candidates) override {
+      if (!is_trigger) {
+        return;
+      }
+      for (int i = 0; i < m_degree; i++) {
+        candidates.push_back(line + m_distance + i);
+      }
+    };
+};
+
+
+/**
+ * @brief    Follows ascending or descending streams of lines, as in the stream buffers of Jouppi (ISCA 1990).
+ * @details
+ * A miss that is not near a tracked stream starts one (replacing the least-recently-used one). An access within WINDOW
+ * lines of the last line of a stream moves it. After two steps in the same direction, every step prefetches the lines
+ * distance to distance + degree - 1 ahead in that direction, skipping the ones the stream already prefetched.
+ *
+ */
+class StreamPrefetcher : public LLCPrefetcher {
+  public:
+    static constexpr Addr_t WINDOW = 16;
+
+  private:
+    struct Stream {
+      Addr_t last = -1;         // Last line accessed (-1: unused entry)
+      Addr_t next = -1;         // First line the stream has not prefetched yet
+      int direction = 0;        // +1 ascending, -1 descending, 0 unknown
+      bool confirmed = false;   // Two steps in the same direction
+      uint64_t lru = 0;
+    };
+    std::vector<Stream> m_streams;
+    uint64_t m_lru_clk = 0;
+
+  public:
+    StreamPrefetcher(int degree, int distance, int num_streams): LLCPrefetcher(degree, distance), m_streams(num_streams) {
+      if (num_streams < 1) {
+        throw ConfigurationError("Stream prefetcher needs at least one stream, got {}!", num_streams);
+      }
+    };
+
+    void on_access(Addr_t line, bool is_trigger, std::vector<Addr_t>& candidates) override {
+      m_lru_clk++;
+      Stream* stream = nullptr;
+      for (Stream& s : m_streams) {
+        if (s.last != -1 && line >= s.last - WINDOW && line <= s.last + WINDOW) {
+          stream = &s;
+          break;
+        }
+      }
+
+      if (!stream) {
+        if (is_trigger) {
+          // Unused entries have the oldest lru
+          Stream* victim = &m_streams[0];
+          for (Stream& s : m_streams) {
+            victim = s.lru < victim->lru ? &s : victim;
+          }
+          *victim = {line, line, 0, false, m_lru_clk};
+        }
+        return;
+      }
+
+      stream->lru = m_lru_clk;
+      if (line == stream->last) {
+        return;
+      }
+      int direction = line > stream->last ? 1 : -1;
+      stream->confirmed = direction == stream->direction;
+      if (direction != stream->direction) {
+        stream->direction = direction;
+        stream->next = line + direction;
+      }
+      stream->last = line;
+      if (!stream->confirmed) {
+        return;
+      }
+
+      Addr_t first = line + direction * m_distance;
+      Addr_t last = line + direction * (m_distance + m_degree - 1);
+      Addr_t next = direction > 0 ? std::max(stream->next, first) : std::min(stream->next, first);
+      for (; direction * (last - next) >= 0; next += direction) {
+        candidates.push_back(next);
+      }
+      stream->next = next;
+    };
+};
+
+
+/**
+ * @brief    Detects a constant stride between the accesses to each memory region, without program counters.
+ * @details
+ * A table of num_regions regions (least-recently-used replacement, allocated on triggers) keeps the last line accessed
+ * in each region and the last stride seen. An access with the same stride as the previous one prefetches the lines
+ * distance to distance + degree - 1 strides ahead.
+ *
+ */
+class StridePrefetcher : public LLCPrefetcher {
+  private:
+    struct Region {
+      Addr_t region = -1;       // -1: unused entry
+      Addr_t last = -1;
+      Addr_t stride = 0;
+      bool confirmed = false;
+      uint64_t lru = 0;
+    };
+    std::vector<Region> m_regions;
+    int m_region_shift;         // log2 of the lines per region
+    uint64_t m_lru_clk = 0;
+
+  public:
+    StridePrefetcher(int degree, int distance, int num_regions, int lines_per_region):
+    LLCPrefetcher(degree, distance), m_regions(num_regions) {
+      if (num_regions < 1 || lines_per_region < 1 || (lines_per_region & (lines_per_region - 1)) != 0) {
+        throw ConfigurationError("Stride prefetcher needs at least one region of a power-of-two number of lines, got {} regions of {} lines!", num_regions, lines_per_region);
+      }
+      m_region_shift = 0;
+      while ((1 << m_region_shift) < lines_per_region) {
+        m_region_shift++;
+      }
+    };
+
+    void on_access(Addr_t line, bool is_trigger, std::vector<Addr_t>& candidates) override {
+      m_lru_clk++;
+      Addr_t region_id = line >> m_region_shift;
+      Region* region = nullptr;
+      Region* victim = &m_regions[0];
+      for (Region& r : m_regions) {
+        if (r.region == region_id) {
+          region = &r;
+          break;
+        }
+        if (r.lru < victim->lru) {
+          victim = &r;
+        }
+      }
+
+      if (!region) {
+        if (is_trigger) {
+          *victim = {region_id, line, 0, false, m_lru_clk};
+        }
+        return;
+      }
+
+      region->lru = m_lru_clk;
+      Addr_t stride = line - region->last;
+      if (stride == 0) {
+        return;
+      }
+      region->confirmed = stride == region->stride;
+      region->stride = stride;
+      region->last = line;
+      if (!region->confirmed) {
+        return;
+      }
+      for (int i = 0; i < m_degree; i++) {
+        candidates.push_back(line + stride * (m_distance + i));
+      }
+    };
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_FRONTEND_PROCESSOR_LLC_PREFETCHER_H
@@ -0,0 +1,105 @@
+#ifndef     RAMULATOR_FRONTEND_PROCESSOR_MSHR_FILE_H
+#define     RAMULATOR_FRONTEND_PROCESSOR_MSHR_FILE_H
+
+#include <vector>
+#include <cstdint>
+
+#include "base/type.h"
+#include "base/request.h"
+#include "base/exception.h"
+#include "base/memory_report.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    A fixed number of miss status holding registers, each tracking the fill of one cache line
+ * @details
+ * Every entry keeps the requests waiting for its line (its targets, the first being the request that missed) in a
+ * list reserved to the target capacity up front, so the miss path never allocates. A miss stalls when no entry is
+ * free, and a secondary miss stalls when its entry has no free target. Lookups scan the line addresses of the entries,
+ * which are contiguous.
+ *
+ */
+class MSHRFile {
+  public:
+    struct Entry {
+      size_t line = 0;                  // The line being filled (in the tag store of the cache)
+      std::vector<Request> targets;
+    };
+
+  private:
+    std::vector<Addr_t> m_line_addrs;   // -1 for the free entries
+    std::vector<Entry> m_entries;
+    std::vector<int> m_free;            // Stack of the free entries
+    size_t m_num_targets;
+
+  public:
+    MSHRFile(int num_entries, int num_targets):
+    m_line_addrs(num_entries, -1), m_entries(num_entries), m_num_targets(num_targets) {
+      if (num_entries <= 0 || num_targets <= 0) {
+        throw ConfigurationError("MSHRs need at least one entry and one target per entry, got {} entries of {} targets!", num_entries, num_targets);
+      }
+      for (int i = num_entries - 1; i >= 0; i--) {
+        m_entries[i].targets.reserve(num_targets);
+        m_free.push_back(i);
+      }
+    };
+
+    size_t capacity() const { return m_entries.size(); };
+    size_t occupancy() const { return m_entries.size() - m_free.size(); };
+    bool is_full() const { return m_free.empty(); };
+
+    size_t footprint_bytes() const {
+      size_t bytes = heap_bytes(m_line_addrs) + heap_bytes(m_entries) + heap_bytes(m_free);
+      for (const Entry& entry : m_entries) {
+        bytes += heap_bytes(entry.targets);
+      }
+      return bytes;
+    };
+
+    /**
+     * @brief    Returns the entry filling the line at line_addr, or -1.
+     *
+     */
+    int find(Addr_t line_addr) const {
+      int entry = -1;
+      for (size_t i = 0; i < m_line_addrs.size(); i++) {
+        entry = (m_line_addrs[i] == line_addr) ? int(i) : entry;
+      }
+      return entry;
+    };
+
+    Entry& operator[](int entry) { return m_entries[entry]; };
+
+    bool is_target_full(int entry) const { return m_entries[entry].targets.size() == m_num_targets; };
+
+    /**
+     * @brief    Allocates an entry for the fill of line (at line_addr) that req missed on. The MSHRs must not be full.
+     *
+     */
+    int allocate(Addr_t line_addr, size_t line, const Request& req) {
+      int entry = m_free.back();
+      m_free.pop_back();
+      m_line_addrs[entry] = line_addr;
+      m_entries[entry].line = line;
+      m_entries[entry].targets.push_back(req);
+      return entry;
+    };
+
+    /**
+     * @brief    Adds a request waiting for the line of the entry. The entry must not be target-full.
+     *
+     */
+    void add_target(int entry, const Request& req) { m_entries[entry].targets.push_back(req); };
+
+    void release(int entry) {
+      m_line_addrs[entry] = -1;
+      m_entries[entry].targets.clear();
+      m_free.push_back(entry);
+    };
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_FRONTEND_PROCESSOR_MSHR_FILE_H
@@ -0,0 +1,74 @@
+#ifndef     RAMULATOR_FRONTEND_PROCESSOR_O3_TRACE_H
+#define     RAMULATOR_FRONTEND_PROCESSOR_O3_TRACE_H
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include "base/exception.h"
+#include "frontend/impl/memory_trace/mapped_trace.h"
+#include "frontend/impl/memory_trace/binary_trace_format.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Parses "<bubble_count> <load_addr> [store_addr]", a record of the SimpleO3 and BHO3 traces
+ *
+ */
+struct O3InstParser {
+  template<typename Inst>
+  static bool parse(TraceLineScanner& line, Inst& inst) {
+    int64_t bubble_count;
+    if (!line.integer(bubble_count) || !line.integer(inst.load_addr)) {
+      return false;
+    }
+    inst.bubble_count = bubble_count;
+    inst.store_addr = -1;
+    return line.at_end() || line.integer(inst.store_addr);
+  };
+};
+
+/**
+ * @brief    Parses a whole SimpleO3 trace (text or binary) from its memory-mapped file, for TraceCache.
+ *
+ */
+template<typename Inst>
+std::vector<Inst> parse_o3_trace(const std::string& path) {
+  if (BinaryTrace::is_binary_trace(path)) {
+    BinaryTrace::Reader reader(path, BinaryTrace::Kind::SimpleO3);
+    std::vector<Inst> trace(reader.header().num_records);
+    for (Inst& inst : trace) {
+      reader.simple_o3(inst.bubble_count, inst.load_addr, inst.store_addr);
+    }
+    return trace;
+  }
+
+  MappedFile file(path);
+  std::vector<Inst> trace;
+  trace.reserve(std::count(file.begin(), file.end(), '\n') + 1);
+  const char* cursor = file.begin();
+  size_t line_number = 0;
+  while (cursor != file.end()) {
+    const char* line_end = static_cast<const char*>(memchr(cursor, '\n', file.end() - cursor));
+    if (line_end == nullptr) {
+      line_end = file.end();
+    }
+    TraceLineScanner line(cursor, line_end);
+    cursor = line_end == file.end() ? line_end : line_end + 1;
+    line_number++;
+    if (line.at_end()) {
+      continue;
+    }
+    Inst& inst = trace.emplace_back();
+    if (!O3InstParser::parse(line, inst) || !line.at_end()) {
+      throw ConfigurationError("Trace {} format invalid at line {}!", path, line_number);
+    }
+  }
+  return trace;
+}
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_FRONTEND_PROCESSOR_O3_TRACE_H
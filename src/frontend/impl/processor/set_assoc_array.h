@@ -0,0 +1,156 @@
+#ifndef     RAMULATOR_FRONTEND_PROCESSOR_SET_ASSOC_ARRAY_H
+#define     RAMULATOR_FRONTEND_PROCESSOR_SET_ASSOC_ARRAY_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "base/type.h"
+#include "base/exception.h"
+#include "base/memory_report.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    The tag store of a set-associative cache, laid out flat (sets x ways) with LRU age counters
+ * @details
+ * The tags of a set are contiguous, so a lookup is a branch-free scan over the ways that the compiler vectorizes. An
+ * empty way holds INVALID_TAG. The dirty and ready (filled) bits of the lines are packed in one byte per line. Every
+ * valid way of a set has a distinct age in [0, number of valid ways), 0 being the most-recently-used, which gives
+ * exact LRU order. A line is named by its index set * num_ways + way, which stays valid until the line is invalidated.
+ *
+ */
+class SetAssocArray {
+  public:
+    static constexpr Addr_t INVALID_TAG = -1;
+    static constexpr uint8_t DIRTY = 1 << 0;
+    static constexpr uint8_t READY = 1 << 1;
+    static constexpr uint8_t PREFETCHED = 1 << 2;   // Filled by a prefetch and not yet accessed on demand
+
+  private:
+    int m_num_sets;
+    int m_num_ways;
+    std::vector<Addr_t> m_tags;
+    std::vector<uint8_t> m_states;
+    std::vector<uint16_t> m_ages;
+
+  public:
+    SetAssocArray(int num_sets, int num_ways):
+    m_num_sets(num_sets), m_num_ways(num_ways),
+    m_tags(size_t(num_sets) * num_ways, INVALID_TAG), m_states(size_t(num_sets) * num_ways, 0), m_ages(size_t(num_sets) * num_ways, 0) {
+      if (num_sets <= 0 || num_ways <= 0 || num_ways > UINT16_MAX) {
+        throw ConfigurationError("Cache needs at least one set and between 1 and {} ways, got {} sets of {} ways!", UINT16_MAX, num_sets, num_ways);
+      }
+    };
+
+    int num_sets() const { return m_num_sets; };
+    int num_ways() const { return m_num_ways; };
+
+    size_t footprint_bytes() const { return heap_bytes(m_tags) + heap_bytes(m_states) + heap_bytes(m_ages); };
+
+    size_t line(int set, int way) const { return size_t(set) * m_num_ways + way; };
+    int set_of(size_t line) const { return line / m_num_ways; };
+
+    Addr_t tag(size_t line) const { return m_tags[line]; };
+    bool is_valid(size_t line) const { return m_tags[line] != INVALID_TAG; };
+    bool is_dirty(size_t line) const { return m_states[line] & DIRTY; };
+    bool is_ready(size_t line) const { return m_states[line] & READY; };
+    bool is_prefetched(size_t line) const { return m_states[line] & PREFETCHED; };
+    void set_dirty(size_t line) { m_states[line] |= DIRTY; };
+    void set_ready(size_t line) { m_states[line] |= READY; };
+    void set_prefetched(size_t line) { m_states[line] |= PREFETCHED; };
+    void clear_prefetched(size_t line) { m_states[line] &= ~PREFETCHED; };
+
+    /**
+     * @brief    Returns the way of the set holding tag, or -1.
+     *
+     */
+    int find(int set, Addr_t tag) const {
+      const Addr_t* tags = &m_tags[line(set, 0)];
+      int way = -1;
+      for (int w = 0; w < m_num_ways; w++) {
+        way = (tags[w] == tag) ? w : way;
+      }
+      return way;
+    };
+
+    /**
+     * @brief    Returns an empty way of the set, or -1 if the set is full.
+     *
+     */
+    int find_empty(int set) const { return find(set, INVALID_TAG); };
+
+    /**
+     * @brief    Returns the least-recently-used ready way of the set, or -1 if every way is still being filled.
+     *
+     */
+    int find_victim(int set) const {
+      size_t base = line(set, 0);
+      int victim = -1;
+      for (int w = 0; w < m_num_ways; w++) {
+        if (is_valid(base + w) && is_ready(base + w) && (victim == -1 || m_ages[base + w] > m_ages[base + victim])) {
+          victim = w;
+        }
+      }
+      return victim;
+    };
+
+    /**
+     * @brief    Puts tag into the empty way as the most-recently-used line of the set. Returns the line.
+     *
+     */
+    size_t fill(int set, int way, Addr_t tag, uint8_t state) {
+      size_t base = line(set, 0);
+      for (int w = 0; w < m_num_ways; w++) {
+        m_ages[base + w] += is_valid(base + w);
+      }
+      m_tags[base + way] = tag;
+      m_states[base + way] = state;
+      m_ages[base + way] = 0;
+      return base + way;
+    };
+
+    /**
+     * @brief    Makes the way the most-recently-used line of its set.
+     *
+     */
+    void touch(int set, int way) {
+      size_t base = line(set, 0);
+      uint16_t age = m_ages[base + way];
+      for (int w = 0; w < m_num_ways; w++) {
+        m_ages[base + w] += is_valid(base + w) && m_ages[base + w] < age;
+      }
+      m_ages[base + way] = 0;
+    };
+
+    void invalidate(int set, int way) {
+      size_t base = line(set, 0);
+      uint16_t age = m_ages[base + way];
+      m_tags[base + way] = INVALID_TAG;
+      m_states[base + way] = 0;
+      for (int w = 0; w < m_num_ways; w++) {
+        m_ages[base + w] -= is_valid(base + w) && m_ages[base + w] > age;
+      }
+    };
+
+    /**
+     * @brief    Returns the valid ways of the set from the least- to the most-recently-used.
+     *
+     */
+    std::vector<int> lru_order(int set) const {
+      size_t base = line(set, 0);
+      std::vector<int> ways;
+      for (int w = 0; w < m_num_ways; w++) {
+        if (is_valid(base + w)) {
+          ways.push_back(w);
+        }
+      }
+      std::sort(ways.begin(), ways.end(), [this, base](int a, int b) { return m_ages[base + a] > m_ages[base + b]; });
+      return ways;
+    };
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_FRONTEND_PROCESSOR_SET_ASSOC_ARRAY_H
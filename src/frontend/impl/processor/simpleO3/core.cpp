@@ -1,3 +1,4 @@
+#include <bit>
 #include <filesystem>
 #include <iostream>
 #include <fstream>
@@ -6,6 +7,9 @@
 
 #include "base/exception.h"
 #include "base/utils.h"
+#include "base/checkpoint.h"
+#include "frontend/impl/memory_trace/streamed_trace.h"
+#include "frontend/impl/processor/o3_trace.h"
 #include "frontend/impl/processor/simpleO3/core.h"
 #include "frontend/impl/processor/simpleO3/llc.h"
 
@@ -14,96 +18,100 @@ namespace Ramulator {
 namespace fs = std::filesystem;
 
 SimpleO3Core::Trace::Trace(std::string file_path_str) {
-  fs::path trace_path(file_path_str);
-  if (!fs::exists(trace_path)) {
-    throw ConfigurationError("Trace {} does not exist!", file_path_str);
+  if (TraceByteStream::is_compressed(file_path_str)) {
+    m_stream = std::make_unique<StreamedTrace<Inst, O3InstParser>>(file_path_str);
+    return;
   }
 
-  std::ifstream trace_file(trace_path);
-  if (!trace_file.is_open()) {
-    throw ConfigurationError("Trace {} cannot be opened!", file_path_str);
-  }
+  m_trace = TraceCache::load<Inst>(file_path_str, [&file_path_str] { return parse_o3_trace<Inst>(file_path_str); });
+  m_trace_length = m_trace->size();
+}
 
-  std::string line;
-  while (std::getline(trace_file, line)) {
-    std::vector<std::string> tokens;
-    tokenize(tokens, line, " ");
+SimpleO3Core::Trace::Inst SimpleO3Core::Trace::get_next_inst() {
+  if (m_stream) {
+    Inst inst = m_stream->current();
+    m_stream->advance();
+    return inst;
+  }
+  const Inst& inst = (*m_trace)[m_curr_trace_idx];
+  m_curr_trace_idx = (m_curr_trace_idx + 1) % m_trace_length;
+  return inst;
+}
 
-    int num_tokens = tokens.size();
-    if (num_tokens != 2 & num_tokens != 3) {
-      throw ConfigurationError("Trace {} format invalid!", file_path_str);
-    }
-    int bubble_count = std::stoi(tokens[0]);
-    Addr_t load_addr = std::stoll(tokens[1]);
+size_t SimpleO3Core::Trace::position() const {
+  return m_stream ? m_stream->position() : m_curr_trace_idx;
+}
 
-    bool has_store = num_tokens == 2 ? false : true; 
-    if (has_store) {
-      Addr_t store_addr = std::stoll(tokens[2]);
-      m_trace.push_back({bubble_count, load_addr, store_addr});
-    } else {
-      m_trace.push_back({bubble_count, load_addr, -1});
-    }
+void SimpleO3Core::Trace::prefetch(const std::string& file_path_str) {
+  if (!TraceByteStream::is_compressed(file_path_str)) {
+    TraceCache::prefetch<Inst>(file_path_str, [file_path_str] { return parse_o3_trace<Inst>(file_path_str); });
   }
-
-  trace_file.close();
-  m_trace_length = m_trace.size();
 }
 
-const SimpleO3Core::Trace::Inst& SimpleO3Core::Trace::get_next_inst() {
-  const Inst& inst = m_trace[m_curr_trace_idx];
-  m_curr_trace_idx = (m_curr_trace_idx + 1) % m_trace_length;
-  return inst;
+void SimpleO3Core::Trace::seek(size_t position) {
+  if (m_stream) {
+    m_stream->seek(position);
+  } else {
+    m_curr_trace_idx = position;
+  }
 }
 
 
 SimpleO3Core::InstWindow::InstWindow(int ipc, int depth):
-m_ipc(ipc), m_depth(depth),
-m_ready_list(depth, false), m_addr_list(depth, -1) {};
+m_ipc(ipc), m_depth(depth), m_mask(std::bit_ceil<uint32_t>(depth) - 1),
+m_ready_bits((m_mask + 64) / 64, 0), m_addr_list(m_mask + 1, -1) {};
 
 bool SimpleO3Core::InstWindow::is_full() {
   return m_load == m_depth;
 }
 
 void SimpleO3Core::InstWindow::insert(bool ready, Addr_t addr) {
-  m_ready_list.at(m_head_idx) = ready;
-  m_addr_list.at(m_head_idx) = addr;
+  uint64_t bit = uint64_t(1) << (m_head_idx & 63);
+  uint64_t& word = m_ready_bits[m_head_idx >> 6];
+  word = ready ? (word | bit) : (word & ~bit);
+  m_addr_list[m_head_idx] = addr;
 
-  m_head_idx = (m_head_idx + 1) % m_depth;
+  m_head_idx = (m_head_idx + 1) & m_mask;
   m_load++;
 }
 
 int SimpleO3Core::InstWindow::retire() {
-  if (m_load == 0) return 0;
-
+  int max_retired = std::min(m_ipc, m_load);
   int num_retired = 0;
-  while (m_load > 0 && num_retired < m_ipc) {
-    if (!m_ready_list.at(m_tail_idx))
+  while (num_retired < max_retired) {
+    // The ready run from idx to the end of its word (or of the ring, whose bits past the capacity are never set)
+    int idx = (m_tail_idx + num_retired) & m_mask;
+    int num_ready = std::countr_one(m_ready_bits[idx >> 6] >> (idx & 63));
+    if (num_ready == 0) {
       break;
-
-    m_tail_idx = (m_tail_idx + 1) % m_depth;
-    m_load--;
-    num_retired++;
+    }
+    num_retired += num_ready;
   }
+  // The bits past the head are stale
+  num_retired = std::min(num_retired, max_retired);
+
+  m_tail_idx = (m_tail_idx + num_retired) & m_mask;
+  m_load -= num_retired;
   return num_retired;
 }
 
 void SimpleO3Core::InstWindow::set_ready(Addr_t addr) {
-  if (m_load == 0) return;
-
-  int index = m_tail_idx;
-  for (int i = 0; i < m_load; i++) {
-    if (m_addr_list[index] == addr) {
-      m_ready_list[index] = true;
+  // The entries from the tail are contiguous up to the end of the ring, then wrap around to 0
+  int num_first = std::min(m_load, m_mask + 1 - m_tail_idx);
+  for (int i = m_tail_idx; i < m_tail_idx + num_first; i++) {
+    if (m_addr_list[i] == addr) {
+      set_ready_bit(i);
     }
-    index++;
-    if (index == m_depth) {
-      index = 0;
+  }
+  for (int i = 0; i < m_load - num_first; i++) {
+    if (m_addr_list[i] == addr) {
+      set_ready_bit(i);
     }
   }
 }
 
 SimpleO3Core::SimpleO3Core(int id, int ipc, int depth, size_t num_expected_insts, std::string trace_path, ITranslation* translation, SimpleO3LLC* llc):
-m_id(id), m_window(ipc, depth), m_trace(trace_path), m_num_expected_insts(num_expected_insts), m_translation(translation), m_llc(llc) {
+m_id(id), m_window(ipc, depth), m_trace(trace_path), m_num_expected_insts(num_expected_insts), m_num_recording_insts(num_expected_insts), m_translation(translation), m_llc(llc) {
   // Fetch the instructions and addresses for tick 0
   auto inst = m_trace.get_next_inst();
   m_num_bubbles = inst.bubble_count;
@@ -112,36 +120,55 @@ m_id(id), m_window(ipc, depth), m_trace(trace_path), m_num_expected_insts(num_ex
 }
 
 void SimpleO3Core::tick() {
+  tick_local();
+  tick_memory();
+}
+
+void SimpleO3Core::tick_local() {
   m_clk++;
 
   s_insts_retired += m_window.retire();
-  if (!reached_expected_num_insts) {
-    if (s_insts_retired >= m_num_expected_insts) {
-      reached_expected_num_insts = true;
-      s_cycles_recorded = m_clk;
+  if (m_recording) {
+    if (s_insts_retired - m_recording_start_insts >= m_num_recording_insts) {
+      m_recording = false;
+      s_cycles_recorded += m_clk - m_recording_start_clk;
+      s_insts_recorded += s_insts_retired - m_recording_start_insts;
+      if (s_insts_forwarded + s_insts_retired >= m_num_expected_insts) {
+        reached_expected_num_insts = true;
+      }
     }
   }
 
   // First, issue the non-memory instructions
-  int num_inserted_insts = 0;
+  m_issue_memory = false;
+  m_num_inserted_insts = 0;
   while (m_num_bubbles > 0) {
-    if (num_inserted_insts == m_window.m_ipc) {
+    if (m_num_inserted_insts == m_window.m_ipc) {
       return;
     }
     if (m_window.is_full()) {
+      m_stall_cycles++;
       return;
     };
     m_window.insert(true, -1);
-    num_inserted_insts++;
+    m_num_inserted_insts++;
     m_num_bubbles--;
   }
+  m_issue_memory = true;
+}
+
+void SimpleO3Core::tick_memory() {
+  if (!m_issue_memory) {
+    return;
+  }
 
   // Second, try to send the load to the LLC
   if (m_load_addr != -1) {
-    if (num_inserted_insts == m_window.m_ipc) {
+    if (m_num_inserted_insts == m_window.m_ipc) {
       return;
     }
     if (m_window.is_full()) {
+      m_stall_cycles++;
       return;
     };
 
@@ -160,6 +187,7 @@ void SimpleO3Core::tick() {
         return;
       }
     } else {
+      m_stall_cycles++;
       return;
     }
   }
@@ -171,6 +199,7 @@ void SimpleO3Core::tick() {
       return;
     };
     if (!m_llc->send(writeback_request)) {
+      m_stall_cycles++;
       return;
     }
   }
@@ -181,15 +210,90 @@ void SimpleO3Core::tick() {
   m_writeback_addr = inst.store_addr;      
 }
 
+void SimpleO3Core::fast_forward(size_t num_insts) {
+  size_t num_forwarded = 0;
+  while (num_forwarded < num_insts) {
+    if (m_num_bubbles > 0) {
+      int num_skipped = std::min<size_t>(m_num_bubbles, num_insts - num_forwarded);
+      m_num_bubbles -= num_skipped;
+      num_forwarded += num_skipped;
+    } else if (m_load_addr != -1) {
+      Request load_request(m_load_addr, Request::Type::Read, m_id, nullptr);
+      if (m_translation->translate(load_request)) {
+        m_llc->access_functional(load_request.addr, false);
+      }
+      m_load_addr = -1;
+      num_forwarded++;
+    } else {
+      // The writeback is not an instruction of its own, so it goes with the fetch of the next trace line
+      if (m_writeback_addr != -1) {
+        Request writeback_request(m_writeback_addr, Request::Type::Write, m_id, nullptr);
+        if (m_translation->translate(writeback_request)) {
+          m_llc->access_functional(writeback_request.addr, true);
+        }
+      }
+      auto inst = m_trace.get_next_inst();
+      m_num_bubbles = inst.bubble_count;
+      m_load_addr = inst.load_addr;
+      m_writeback_addr = inst.store_addr;
+    }
+  }
+  s_insts_forwarded += num_forwarded;
+}
+
+void SimpleO3Core::start_recording(size_t num_insts) {
+  m_recording = true;
+  m_num_recording_insts = num_insts;
+  m_recording_start_insts = s_insts_retired;
+  m_recording_start_clk = m_clk;
+}
+
 void SimpleO3Core::receive(Request& req) {
   m_window.set_ready(req.addr);
 
   if (req.arrive != -1 && req.depart > m_last_mem_cycle) {
-    if (!reached_expected_num_insts) {
+    if (m_recording) {
       s_mem_access_cycles += (req.depart - std::max(m_last_mem_cycle, req.arrive));
       m_last_mem_cycle = req.depart;
     }
   }
 }
 
+void SimpleO3Core::save_checkpoint(std::ostream& out) {
+  Checkpoint::write<uint64_t>(out, m_trace.m_trace_length);
+  Checkpoint::write<uint64_t>(out, m_trace.position());
+  Checkpoint::write<int>(out, m_num_bubbles);
+  Checkpoint::write<Addr_t>(out, m_load_addr);
+  Checkpoint::write<Addr_t>(out, m_writeback_addr);
+
+  // The window entries from the tail, so that the layout of the ring does not matter
+  std::vector<Addr_t> window_addrs;
+  for (int i = 0; i < m_window.m_load; i++) {
+    window_addrs.push_back(m_window.m_addr_list[(m_window.m_tail_idx + i) & m_window.m_mask]);
+  }
+  Checkpoint::write<int>(out, m_window.m_depth);
+  Checkpoint::write(out, window_addrs);
+}
+
+void SimpleO3Core::load_checkpoint(std::istream& in) {
+  Checkpoint::expect<uint64_t>(in, m_trace.m_trace_length, "trace length");
+  m_trace.seek(Checkpoint::read<uint64_t>(in));
+  m_num_bubbles = Checkpoint::read<int>(in);
+  m_load_addr = Checkpoint::read<Addr_t>(in);
+  m_writeback_addr = Checkpoint::read<Addr_t>(in);
+
+  Checkpoint::expect<int>(in, m_window.m_depth, "instruction window depth");
+  std::vector<Addr_t> window_addrs = Checkpoint::read_vector<Addr_t>(in);
+  if (window_addrs.size() > size_t(m_window.m_depth)) {
+    throw ConfigurationError("Checkpoint has {} instructions in a window of {}!", window_addrs.size(), m_window.m_depth);
+  }
+  m_window.m_load = 0;
+  m_window.m_head_idx = 0;
+  m_window.m_tail_idx = 0;
+  for (Addr_t addr : window_addrs) {
+    // The requests in flight are not checkpointed
+    m_window.insert(true, addr);
+  }
+}
+
 }        // namespace Ramulator
@@ -4,8 +4,12 @@
 #include <vector>
 #include <string>
 #include <functional>
+#include <memory>
 
 #include "base/type.h"
+#include "base/trace_cache.h"
+#include "base/memory_report.h"
+#include "frontend/impl/memory_trace/trace_source.h"
 #include "base/request.h"
 #include "translation/translation.h"
 
@@ -23,32 +27,47 @@ class SimpleO3Core : public Clocked<SimpleO3Core> {
       Addr_t store_addr = -1;
     };
   
-    std::vector<Inst> m_trace;
+    TraceCache::Trace_t<Inst> m_trace;   // Shared with every core replaying the same file
     size_t m_trace_length = 0;
     size_t m_curr_trace_idx = 0;
 
+    std::unique_ptr<TraceSource<Inst>> m_stream;   // Compressed traces are streamed instead
+
     public:
       Trace(std::string file_path_str);
-      const Inst& get_next_inst();
+      Inst get_next_inst();
+
+      // Starts parsing the trace in the background, so that the cores replaying it wait less for it
+      static void prefetch(const std::string& file_path_str);
+
+      // The index of the next instruction, and skipping to it
+      size_t position() const;
+      void seek(size_t position);
+
+      // The parsed trace, shared with every core replaying the same file (0 bytes if it is streamed)
+      const void* parsed_id() const { return m_trace.get(); };
+      size_t parsed_bytes() const { return m_trace ? heap_bytes(*m_trace) : 0; };
   };
 
   /**
    * @brief   Simplified ROB of an O3 processor.
    * @details
-   * We model
+   * A ring of depth entries, rounded up to a power of two, with one packed ready bit per entry. Retirement counts
+   * the run of ready bits at the tail a word at a time, so it does not loop over the retired entries.
    */
   class InstWindow {
     friend class SimpleO3Core;
     private:
       int m_ipc = 4;          // How many instructions we can retire in a cycle
       int m_depth = 128;      // How many inflight instructions we can keep track of
+      int m_mask = 127;       // Ring capacity - 1
 
       int m_load = 0;         // The current load
       int m_head_idx = 0;     // Head index. New instructions are inserted at the head index.
       int m_tail_idx = 0;     // Tail index. The instruction at the tail will be retired first.
 
-      std::vector<bool>   m_ready_list;   // Bitvector to mark whether each instruction is ready to be retired.
-      std::vector<Addr_t> m_addr_list;    // Which address is each LD/ST instruction targeting? TODO: Perf. optimization with unordered map?
+      std::vector<uint64_t> m_ready_bits;   // Bitvector to mark whether each instruction is ready to be retired.
+      std::vector<Addr_t>   m_addr_list;    // Which address is each LD/ST instruction targeting?
 
     public:
       InstWindow(int ipc = 4, int depth = 128);      
@@ -76,6 +95,10 @@ class SimpleO3Core : public Clocked<SimpleO3Core> {
        * 
        */
       void   set_ready(Addr_t addr);
+
+    private:
+      bool   is_ready(int idx) const { return (m_ready_bits[idx >> 6] >> (idx & 63)) & 1; };
+      void   set_ready_bit(int idx)  { m_ready_bits[idx >> 6] |= uint64_t(1) << (idx & 63); };
   };
 
   private:
@@ -86,14 +109,24 @@ class SimpleO3Core : public Clocked<SimpleO3Core> {
     ITranslation* m_translation;
     SimpleO3LLC* m_llc;
 
-    std::function<void(Request&)> m_callback;
+    RequestCallback m_callback;
 
     int    m_num_bubbles = 0;
     Addr_t m_load_addr = -1;
     Addr_t m_writeback_addr = -1;
 
+    bool m_issue_memory = false;      // Whether tick_local() left the rest of the tick to tick_memory()
+    int m_num_inserted_insts = 0;     // Instructions inserted to the window in this tick
+
     size_t m_num_expected_insts = 0;  
     Clk_t m_last_mem_cycle = 0; // The last cycle that a memory request departs from mc
+    Clk_t m_stall_cycles = 0;   // Cycles the window was full or the LLC rejected an access of the core
+
+    // The core records the cycles it takes to retire m_num_recording_insts instructions from the start of the recording
+    bool   m_recording = true;
+    size_t m_num_recording_insts = 0;
+    size_t m_recording_start_insts = 0;
+    Clk_t  m_recording_start_clk = 0;
 
   /************************************************
    *              Core Statistics
@@ -103,21 +136,64 @@ class SimpleO3Core : public Clocked<SimpleO3Core> {
     size_t s_insts_retired = 0; 
     size_t s_cycles_recorded = 0; 
     Clk_t  s_mem_access_cycles = 0; 
+    size_t s_insts_recorded = 0;
+    size_t s_insts_forwarded = 0;
 
   public:
     SimpleO3Core(int id, int ipc, int depth, size_t num_expected_insts, std::string trace_path, ITranslation* translation, SimpleO3LLC* llc);
 
+    /// The bytes of the instruction window (the trace is shared, see Trace::parsed_bytes())
+    size_t footprint_bytes() const { return heap_bytes(m_window.m_ready_bits) + heap_bytes(m_window.m_addr_list); };
+
     /**
-     * @brief   Ticks the core.
+     * @brief   Ticks the core: tick_local(), then tick_memory().
      * 
      */
     void tick() override;
 
+    /**
+     * @brief   The part of a tick that only touches the core: retires instructions and inserts the non-memory ones.
+     *          The cores can run it in parallel.
+     * 
+     */
+    void tick_local();
+
+    /**
+     * @brief   The rest of the tick: translates and sends the memory instructions to the shared LLC, then fetches the
+     *          next trace instruction. The cores must run it one at a time, in core order.
+     * 
+     */
+    void tick_memory();
+
+    /**
+     * @brief   Skips num_insts trace instructions functionally: the loads and writebacks update the LLC tags right away
+     *          and take no time. The instructions already in the window still retire as timed.
+     * 
+     */
+    void fast_forward(size_t num_insts);
+
+    /**
+     * @brief   Starts recording the cycles until num_insts more instructions retire. The core reaches its expected
+     *          number of instructions at the end of a recording after which it has retired or fast-forwarded them all.
+     * 
+     */
+    void start_recording(size_t num_insts);
+    void stop_recording() { m_recording = false; };
+    bool is_recording() const { return m_recording; };
+
     /**
      * @brief   Called when a request is served by the memory.
      * 
      */
     void receive(Request& req);
+
+    /**
+     * @brief   Saves (restores) the trace position and the instruction window. The memory instructions that
+     *          were waiting for a request are restored as served.
+     * 
+     */
+    void save_checkpoint(std::ostream& out);
+    void load_checkpoint(std::istream& in);
 };
 
 }        // namespace Ramulator
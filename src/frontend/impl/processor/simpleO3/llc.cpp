@@ -1,10 +1,13 @@
 #include <iostream>
 #include "frontend/impl/processor/simpleO3/llc.h"
+#include "base/checkpoint.h"
 
 namespace Ramulator {
 
-SimpleO3LLC::SimpleO3LLC(int latency, int size_bytes, int linesize_bytes, int associativity, int num_mshrs):
-m_latency(latency), m_size_bytes(size_bytes), m_linesize_bytes(linesize_bytes), m_associativity(associativity), m_num_mshrs(num_mshrs) {
+SimpleO3LLC::SimpleO3LLC(int latency, int size_bytes, int linesize_bytes, int associativity, int num_mshrs, int num_mshr_targets):
+m_lines(size_bytes / (linesize_bytes * associativity), associativity), m_mshrs(num_mshrs, num_mshr_targets), m_miss_list(latency), m_hit_list(latency),
+m_latency(latency), m_size_bytes(size_bytes), m_linesize_bytes(linesize_bytes), m_associativity(associativity) {
+  m_fill_callback = [this](Request& req) { receive(req); };
   m_logger = Logging::create_logger("SimpleO3LLC");
 
   m_set_size = m_size_bytes / (m_linesize_bytes * m_associativity);
@@ -17,43 +20,42 @@ m_latency(latency), m_size_bytes(size_bytes), m_linesize_bytes(linesize_bytes),
   DEBUG_LOG(DSIMPLEO3LLC, m_logger, "Tag offset: {}",    m_tag_offset);
 };
 
+void SimpleO3LLC::set_prefetcher(std::unique_ptr<LLCPrefetcher> prefetcher, int mshr_reserve, Clk_t backoff) {
+  if (mshr_reserve < 0 || mshr_reserve >= int(m_mshrs.capacity()) || backoff < 0) {
+    throw ConfigurationError("LLC prefetching needs 0 <= MSHR reserve < {} MSHR entries and a non-negative backoff, got {} and {}!", m_mshrs.capacity(), mshr_reserve, backoff);
+  }
+  m_prefetcher = std::move(prefetcher);
+  m_prefetch_mshr_reserve = mshr_reserve;
+  m_prefetch_backoff = backoff;
+  m_prefetch_victims.assign(m_set_size, -1);
+}
+
 void SimpleO3LLC::tick() {
   m_clk++;
 
+  s_llc_mshr_occupancy += m_mshrs.occupancy();
+  s_llc_mshr_occupancy_max = std::max<int>(s_llc_mshr_occupancy_max, m_mshrs.occupancy());
+
   // Send miss requests to the memory system when LLC latency is met
-  // TODO: Optimization by assuming in-order issue?
-  auto it = m_miss_list.begin(); 
-  while (it != m_miss_list.end()) {
-    if (m_clk >= it->first) {
-      if (!m_memory_system->send(it->second)) {
-        it++;
-      }
-      else {
-        it = m_miss_list.erase(it);
-      }
-    } else {
-      it++;
+  m_miss_list.drain(m_clk, [this](Request& req) {
+    if (m_memory_system->send(req)) {
+      return true;
     }
-  }
+    // Back-pressure from the memory system pauses the prefetches
+    m_prefetch_resume_clk = m_clk + m_prefetch_backoff;
+    return false;
+  });
 
   // call hit request callback when LLC latency is met
-  it = m_hit_list.begin();
-  while (it != m_hit_list.end()) {
-    if (m_clk >= it->first) {
-      std::vector<Request> _req_v{it->second};
-      m_receive_requests[it->second.addr] = _req_v;
-
-      it->second.callback(it->second);
-      it = m_hit_list.erase(it);
-    } 
-    else {
-      it++;
-    }
-  }
+  m_hit_list.drain(m_clk, [](Request& req) {
+    req.callback(req);
+    return true;
+  });
 };
 
 bool SimpleO3LLC::send(Request req) {
-  CacheSet_t& set = get_set(req.addr);
+  int set = get_index(req.addr);
+  m_access_source = req.source_id;
 
   if (req.type_id == Request::Type::Read) {
     s_llc_read_access++;
@@ -61,7 +63,7 @@ bool SimpleO3LLC::send(Request req) {
     s_llc_write_access++;
   }
 
-  if (auto line_it = check_set_hit(set, req.addr); line_it != set.end()) {
+  if (int way = check_set_hit(set, req.addr); way != -1) {
     // Hit in the set
     DEBUG_LOG(DSIMPLEO3LLC, m_logger, 
     "[Clk={}] Request Source: {}, Type: {}, Addr: {}, Index: {}, Tag: {}. Hit, will finish at Clk={}", 
@@ -69,11 +71,20 @@ bool SimpleO3LLC::send(Request req) {
     );
 
     // Update the LRU status
-    set.push_back({req.addr, get_tag(req.addr), line_it->dirty || (req.type_id == Request::Type::Write), true});
-    set.erase(line_it);
+    m_lines.touch(set, way);
+    size_t line = m_lines.line(set, way);
+    if (req.type_id == Request::Type::Write) {
+      m_lines.set_dirty(line);
+    }
+    bool is_prefetched = m_lines.is_prefetched(line);
+    if (is_prefetched) {
+      s_llc_prefetch_useful++;
+      m_lines.clear_prefetched(line);
+    }
 
     // Add to the hit list to callback when finished
-    m_hit_list.push_back(std::make_pair(m_clk + m_latency, req));
+    m_hit_list.schedule(m_clk + m_latency, req);
+    prefetch(req.addr, is_prefetched);
     return true;
   } else {
     // Miss in the set
@@ -94,148 +105,285 @@ bool SimpleO3LLC::send(Request req) {
     }
 
     // MSHR lookup
-    auto mshr_it = check_mshr_hit(req.addr);
-    if (mshr_it != m_mshrs.end()) {
+    if (int mshr = m_mshrs.find(align(req.addr)); mshr != -1) {
       DEBUG_LOG(DSIMPLEO3LLC, m_logger,  "MSHR Hit.", m_clk);
-      // Add new req to MSHR_requests
-      m_receive_requests[mshr_it->first].push_back(req);
+      if (m_mshrs.is_target_full(mshr)) {
+        DEBUG_LOG(DSIMPLEO3LLC, m_logger,  "No MSHR target available.", m_clk);
+        s_llc_mshr_target_full++;
+        return false;
+      }
+      m_mshrs.add_target(mshr, req);
 
-      mshr_it->second->dirty = dirty || mshr_it->second->dirty;
+      size_t line = m_mshrs[mshr].line;
+      if (dirty) {
+        m_lines.set_dirty(line);
+      }
+      bool is_prefetched = m_lines.is_prefetched(line);
+      if (is_prefetched) {
+        s_llc_prefetch_useful++;
+        s_llc_prefetch_late++;
+        m_lines.clear_prefetched(line);
+      }
+      prefetch(req.addr, is_prefetched);
       return true;
     }
 
     // MSHR miss
     // Check if there is available MSHR entry
-    if (m_mshrs.size() == m_num_mshrs) {
+    if (m_mshrs.is_full()) {
       DEBUG_LOG(DSIMPLEO3LLC, m_logger,  "No MSHR entry available.", m_clk);
       s_llc_mshr_unavailable++;
       return false;
     }
 
     // Check if there is available cache line in the set
-    bool line_available = false;
-    if (set.size() < m_associativity) {
-      line_available = true;
-    } else {
-      for (const auto& line : set) {
-        if (line.ready) {
-          line_available = true;
-        }
-      }
-    }
-    if (!line_available) {
+    if (m_lines.find_empty(set) == -1 && m_lines.find_victim(set) == -1) {
       DEBUG_LOG(DSIMPLEO3LLC, m_logger,  "No cache line available in the set.", m_clk);
       return false;
     }
 
     // Allocate a new cache line
-    auto newline_it = allocate_line(set, req.addr);
-    if (newline_it == set.end()) {
+    int newline_way = allocate_line(set, req.addr);
+    if (newline_way == -1) {
       // Should this happen?
       throw std::runtime_error("Failed to allocate new line when there is available entry.");
       return false;
     }
-    newline_it->dirty = dirty;
+    size_t newline = m_lines.line(set, newline_way);
+    if (dirty) {
+      m_lines.set_dirty(newline);
+    }
     
-    // Add to MSHR entries
-    m_mshrs.push_back(std::make_pair(req.addr, newline_it));
-    // Add Request to MSHR_requests
-    std::vector<Request> _req_v{req};
-    m_receive_requests[req.addr] = _req_v;
+    // Add to MSHR entries, the LLC fills the line when the memory system responds
+    m_mshrs.allocate(align(req.addr), newline, req);
+    req.callback = m_fill_callback;
 
     // Add to the miss request list
-    m_miss_list.push_back(std::make_pair(m_clk + m_latency, req));
+    m_miss_list.schedule(m_clk + m_latency, req);
+    if (m_traffic_observer) {
+      m_traffic_observer(BinaryTrace::LLCOp::Read, req.addr, m_access_source);
+    }
 
+    if (m_prefetcher && m_prefetch_victims[set] == align(req.addr)) {
+      s_llc_prefetch_pollution++;
+      m_prefetch_victims[set] = -1;
+    }
+    prefetch(req.addr, true);
     return true;
   }
 };
 
 void SimpleO3LLC::receive(Request& req) {
-  auto it = std::find_if(
-    m_mshrs.begin(), m_mshrs.end(),
-    [&req, this](MSHREntry_t mshr_entry) { return (align(mshr_entry.first) == align(req.addr)); }
-  );
-
   DEBUG_LOG(DSIMPLEO3LLC, m_logger, "[Clk={}] Request {} received.", m_clk, req.addr);
 
-  if (it != m_mshrs.end()) {
-    it->second->ready = true;
-    m_mshrs.erase(it);
+  int mshr = m_mshrs.find(align(req.addr));
+  if (mshr == -1) {
+    return;
+  }
+  MSHRFile::Entry& entry = m_mshrs[mshr];
+  m_lines.set_ready(entry.line);
+  if (m_return_observer && req.source_id >= 0) {
+    m_return_observer(req.source_id);
   }
+  // TODO: LLC latency for the core to receive the request?
+  for (Request& target : entry.targets) {
+    target.arrive = req.arrive;
+    target.depart = req.depart;
+    target.callback(target);
+  }
+  m_mshrs.release(mshr);
 };
 
-SimpleO3LLC::CacheSet_t& SimpleO3LLC::get_set(Addr_t addr) {
-  int set_index = get_index(addr);
-  if (m_cache_sets.find(set_index) == m_cache_sets.end()) {
-    m_cache_sets.insert(make_pair(set_index, std::list<Line>()));
+void SimpleO3LLC::access_functional(Addr_t addr, bool is_write) {
+  int set = get_index(addr);
+  int way = m_lines.find(set, get_tag(addr));
+  if (way != -1) {
+    m_lines.touch(set, way);
+  } else {
+    way = m_lines.find_empty(set);
+    if (way == -1) {
+      way = m_lines.find_victim(set);
+      if (way == -1) {
+        // Every way is still being filled by a timed miss
+        return;
+      }
+      m_lines.invalidate(set, way);
+    }
+    m_lines.fill(set, way, get_tag(addr), SetAssocArray::READY);
+  }
+  if (is_write) {
+    m_lines.set_dirty(m_lines.line(set, way));
   }
-  return m_cache_sets[set_index];
 }
 
-SimpleO3LLC::CacheSet_t::iterator SimpleO3LLC::allocate_line(CacheSet_t& set, Addr_t addr) {
-  // Check if we need to evict any line
-  if (need_eviction(set, addr)) {
-    // Get a victim to evict
-    auto victim = std::find_if(set.begin(), set.end(), [this](Line line) { return line.ready; });
-    if (victim == set.end())
-      return victim;  // doesn't exist a line that's already unlocked in each level
-    evict_line(set, victim);
-  }
+void SimpleO3LLC::reset_stats() {
+  s_llc_read_access = 0;
+  s_llc_write_access = 0;
+  s_llc_read_misses = 0;
+  s_llc_write_misses = 0;
+  s_llc_eviction = 0;
+  s_llc_mshr_unavailable = 0;
+  s_llc_mshr_target_full = 0;
+  s_llc_prefetch_issued = 0;
+  s_llc_prefetch_useful = 0;
+  s_llc_prefetch_late = 0;
+  s_llc_prefetch_redundant = 0;
+  s_llc_prefetch_throttled = 0;
+  s_llc_prefetch_unused = 0;
+  s_llc_prefetch_pollution = 0;
+  s_llc_mshr_occupancy = 0;
+  s_llc_mshr_occupancy_max = 0;
+  m_stats_start_clk = m_clk;
+}
 
-  // Allocate new cache line and return an iterator to it
-  set.push_back({addr, get_tag(addr)});
-  return --set.end();
+void SimpleO3LLC::finalize() {
+  Clk_t num_cycles = m_clk - m_stats_start_clk;
+  s_llc_mshr_occupancy_avg = num_cycles > 0 ? float(s_llc_mshr_occupancy) / num_cycles : 0;
+  s_llc_prefetch_accuracy = s_llc_prefetch_issued > 0 ? float(s_llc_prefetch_useful) / s_llc_prefetch_issued : 0;
 }
 
-bool SimpleO3LLC::need_eviction(const CacheSet_t& set, Addr_t addr) {
-  if (std::find_if(set.begin(), set.end(), 
-            [addr, this](Line l) { return (get_tag(addr) == l.tag); }) 
-      != set.end()) {
-    // Due to MSHR, the program can't reach here. Just for checking
-    assert(false);
-    return false;
-  } 
-  else {
-    if (set.size() < m_associativity) {
-      return false;
-    } else {
-      return true;
-    }
+int SimpleO3LLC::allocate_line(int set, Addr_t addr, bool is_prefetch) {
+  // Due to MSHR, the line cannot be in the set already. Just for checking
+  assert(m_lines.find(set, get_tag(addr)) == -1);
+
+  // Check if we need to evict any line
+  int way = m_lines.find_empty(set);
+  if (way == -1) {
+    // Get a victim to evict
+    way = m_lines.find_victim(set);
+    if (way == -1)
+      return way;  // doesn't exist a line that's already unlocked in each level
+    evict_line(set, way, is_prefetch);
   }
+
+  // Allocate the new cache line as the most-recently-used way
+  m_lines.fill(set, way, get_tag(addr), 0);
+  return way;
 }
 
-void SimpleO3LLC::evict_line(CacheSet_t& set, CacheSet_t::iterator victim_it) {
-  DEBUG_LOG(DSIMPLEO3LLC, m_logger,  "Evicting {}.", victim_it->addr);
+void SimpleO3LLC::evict_line(int set, int way, bool is_prefetch) {
+  size_t line = m_lines.line(set, way);
+  Addr_t victim_addr = line_addr(set, m_lines.tag(line));
+  DEBUG_LOG(DSIMPLEO3LLC, m_logger,  "Evicting {}.", victim_addr);
   s_llc_eviction++;
+  if (m_lines.is_prefetched(line)) {
+    s_llc_prefetch_unused++;
+  }
+  if (is_prefetch) {
+    m_prefetch_victims[set] = victim_addr;
+  }
 
   // Generate writeback request if victim line is dirty
-  if (victim_it->dirty) {
-    Request writeback_req(victim_it->addr, Request::Type::Write);
-    m_miss_list.push_back(std::make_pair(m_clk + m_latency, writeback_req));
+  if (m_lines.is_dirty(line)) {
+    Request writeback_req(victim_addr, Request::Type::Write);
+    m_miss_list.schedule(m_clk + m_latency, writeback_req);
+    if (m_traffic_observer) {
+      m_traffic_observer(BinaryTrace::LLCOp::Writeback, victim_addr, m_access_source);
+    }
 
     DEBUG_LOG(DSIMPLEO3LLC, m_logger,  "Writeback Request will be issued at Clk={}.", m_clk + m_latency);
   }
 
-  set.erase(victim_it);
+  m_lines.invalidate(set, way);
 }
 
+void SimpleO3LLC::prefetch(Addr_t addr, bool is_trigger) {
+  if (!m_prefetcher) {
+    return;
+  }
+  m_prefetch_candidates.clear();
+  m_prefetcher->on_access(addr >> m_index_offset, is_trigger, m_prefetch_candidates);
+
+  for (Addr_t candidate : m_prefetch_candidates) {
+    Addr_t prefetch_addr = candidate << m_index_offset;
+    // The addresses are physical, so the prefetches stay in the (smallest) page of the access
+    if (candidate < 0 || (prefetch_addr >> PREFETCH_PAGE_BITS) != (addr >> PREFETCH_PAGE_BITS)) {
+      continue;
+    }
+    int set = get_index(prefetch_addr);
+    if (m_lines.find(set, get_tag(prefetch_addr)) != -1) {
+      s_llc_prefetch_redundant++;
+      continue;
+    }
+    if (m_clk < m_prefetch_resume_clk || m_mshrs.capacity() - m_mshrs.occupancy() <= m_prefetch_mshr_reserve ||
+        (m_lines.find_empty(set) == -1 && m_lines.find_victim(set) == -1)) {
+      s_llc_prefetch_throttled++;
+      continue;
+    }
+
+    size_t newline = m_lines.line(set, allocate_line(set, prefetch_addr, true));
+    m_lines.set_prefetched(newline);
+
+    // The prefetch is the first target of its MSHR entry, with nothing to respond to
+    Request prefetch_req(prefetch_addr, Request::Type::Read);
+    prefetch_req.callback = [](Request& req) { };
+    m_mshrs.allocate(prefetch_addr, newline, prefetch_req);
+    prefetch_req.callback = m_fill_callback;
+    m_miss_list.schedule(m_clk + m_latency, prefetch_req);
+    if (m_traffic_observer) {
+      m_traffic_observer(BinaryTrace::LLCOp::Prefetch, prefetch_addr, m_access_source);
+    }
+    s_llc_prefetch_issued++;
+    DEBUG_LOG(DSIMPLEO3LLC, m_logger, "[Clk={}] Prefetching {}.", m_clk, prefetch_addr);
+  }
+}
 
-SimpleO3LLC::CacheSet_t::iterator SimpleO3LLC::check_set_hit(CacheSet_t& set, Addr_t addr) {
-  auto line_it = std::find_if(set.begin(), set.end(), [addr, this](Line l){return (l.tag == get_tag(addr));});
-  if (!line_it->ready) {
-    return set.end();
+int SimpleO3LLC::check_set_hit(int set, Addr_t addr) {
+  int way = m_lines.find(set, get_tag(addr));
+  if (way == -1 || !m_lines.is_ready(m_lines.line(set, way))) {
+    return -1;
   } else {
-    return line_it;
+    return way;
   }
 }
 
-SimpleO3LLC::MSHR_t::iterator SimpleO3LLC::check_mshr_hit(Addr_t addr) {
-  auto mshr_it =
-    std::find_if(
-      m_mshrs.begin(), m_mshrs.end(),
-      [addr, this](MSHREntry_t mshr_entry) { return (align(mshr_entry.first) == align(addr)); }
-    );
-  return mshr_it;
+void SimpleO3LLC::save_checkpoint(std::ostream& out) {
+  Checkpoint::write<int>(out, m_set_size);
+  Checkpoint::write<int>(out, m_associativity);
+  Checkpoint::write<uint64_t>(out, m_linesize_bytes);
+
+  std::vector<int> sets;
+  for (int set = 0; set < m_set_size; set++) {
+    if (m_lines.find_victim(set) != -1) {
+      sets.push_back(set);
+    }
+  }
+  Checkpoint::write<uint64_t>(out, sets.size());
+  for (int set : sets) {
+    std::vector<Addr_t> addrs;
+    std::vector<uint8_t> dirty;
+    for (int way : m_lines.lru_order(set)) {
+      size_t line = m_lines.line(set, way);
+      if (m_lines.is_ready(line)) {
+        addrs.push_back(line_addr(set, m_lines.tag(line)));
+        dirty.push_back(m_lines.is_dirty(line));
+      }
+    }
+    Checkpoint::write<int>(out, set);
+    Checkpoint::write(out, addrs);
+    Checkpoint::write(out, dirty);
+  }
+}
+
+void SimpleO3LLC::load_checkpoint(std::istream& in) {
+  Checkpoint::expect<int>(in, m_set_size, "number of LLC sets");
+  Checkpoint::expect<int>(in, m_associativity, "LLC associativity");
+  Checkpoint::expect<uint64_t>(in, m_linesize_bytes, "LLC line size");
+
+  m_lines = SetAssocArray(m_set_size, m_associativity);
+  uint64_t num_sets = Checkpoint::read<uint64_t>(in);
+  for (uint64_t i = 0; i < num_sets; i++) {
+    int set = Checkpoint::read<int>(in);
+    std::vector<Addr_t> addrs = Checkpoint::read_vector<Addr_t>(in);
+    std::vector<uint8_t> dirty = Checkpoint::read_vector<uint8_t>(in);
+    if (set < 0 || set >= m_set_size || addrs.size() > m_associativity || dirty.size() != addrs.size()) {
+      throw ConfigurationError("Checkpoint LLC set {} is corrupted!", set);
+    }
+    // In LRU order, so the last line filled is the most-recently-used
+    for (size_t way = 0; way < addrs.size(); way++) {
+      m_lines.fill(set, way, get_tag(addrs[way]), SetAssocArray::READY | (dirty[way] ? SetAssocArray::DIRTY : 0));
+    }
+  }
 }
 
 void SimpleO3LLC::serialize(std::string serialization_filename) {
@@ -243,9 +391,10 @@ void SimpleO3LLC::serialize(std::string serialization_filename) {
   serialization_file.open(serialization_filename, std::ios::out);
 
   serialization_file << "index,addr,tag,dirty" << std::endl;
-  for (auto it1 = m_cache_sets.begin(); it1 != m_cache_sets.end(); it1++) {
-    for (auto it2 = it1->second.begin(); it2 != it1->second.end(); it2++) {
-      serialization_file << it1->first << "," << it2->addr << "," << it2->tag << "," << it2->dirty << std::endl;
+  for (int set = 0; set < m_set_size; set++) {
+    for (int way : m_lines.lru_order(set)) {
+      size_t line = m_lines.line(set, way);
+      serialization_file << set << "," << line_addr(set, m_lines.tag(line)) << "," << m_lines.tag(line) << "," << m_lines.is_dirty(line) << std::endl;
     }
   }
   serialization_file.close();
@@ -267,13 +416,13 @@ void SimpleO3LLC::deserialize(std::string serialization_filename) {
     std::string dirty_str = file_line.substr(0, file_line.find(","));
     
     int index = std::stoi(index_str);
-    Addr_t addr = std::stoll(addr_str);
     Addr_t tag = std::stoll(tag_str);
     bool dirty = std::stoi(dirty_str);
-    if(m_cache_sets.find(index) == m_cache_sets.end()){
-      m_cache_sets.insert({index, std::list<SimpleO3LLC::Line>()});
+    int way = m_lines.find_empty(index);
+    if (way == -1) {
+      throw std::runtime_error("Serialized LLC set has more lines than the associativity.");
     }
-    m_cache_sets[index].push_back({addr, tag, dirty, 1});
+    m_lines.fill(index, way, tag, SetAssocArray::READY | (dirty ? SetAssocArray::DIRTY : 0));
   }
   serialization_file.close();
 }
@@ -285,9 +434,10 @@ void SimpleO3LLC::dump_llc() {
    */
   std::cout << "Dumping LLC" << std::endl;
   std::cout << "index,addr,tag,dirty,ready" << std::endl;
-  for (auto it1 = m_cache_sets.begin(); it1 != m_cache_sets.end(); it1++) {
-    for (auto it2 = it1->second.begin(); it2 != it1->second.end(); it2++) {
-      std::cout << it1->first << "," << it2->addr << "," << it2->tag << "," << it2->dirty << "," << it2->ready << std::endl;
+  for (int set = 0; set < m_set_size; set++) {
+    for (int way : m_lines.lru_order(set)) {
+      size_t line = m_lines.line(set, way);
+      std::cout << set << "," << line_addr(set, m_lines.tag(line)) << "," << m_lines.tag(line) << "," << m_lines.is_dirty(line) << "," << m_lines.is_ready(line) << std::endl;
     }
   }
 }
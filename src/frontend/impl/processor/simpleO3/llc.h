@@ -2,15 +2,21 @@
 #define     RAMULATOR_FRONTEND_PROCESSOR_SIMPLEO3_LLC_H
 
 #include <vector>
-#include <list>
+#include <memory>
 #include <unordered_map>
 #include <iostream>
 #include <fstream>
+#include <functional>
 
 #include "base/clocked.h"
 #include "base/debug.h"
 #include "base/type.h"
 #include "base/request.h"
+#include "base/timing_wheel.h"
+#include "frontend/impl/processor/set_assoc_array.h"
+#include "frontend/impl/processor/mshr_file.h"
+#include "frontend/impl/processor/llc_prefetcher.h"
+#include "frontend/impl/memory_trace/binary_trace_format.h"
 #include "memory_system/memory_system.h"
 
 namespace Ramulator {
@@ -20,43 +26,44 @@ DECLARE_DEBUG_FLAG(DSIMPLEO3LLC);
 
 class SimpleO3LLC : public Clocked<SimpleO3LLC> {
   friend class SimpleO3;
-  struct Line {
-    Addr_t addr = -1;
-    Addr_t tag = -1;
-    bool dirty = false;
-    bool ready = false;   // Whether this line is ready (i.e., is still inflight?)
-  };
-
   private:
-    using CacheSet_t = std::list<Line>;   // LRU queue for the set. The head of the list is the least-recently-used way.
-    std::unordered_map<int, CacheSet_t> m_cache_sets;
-    
-    using MSHREntry_t = std::pair<Addr_t, CacheSet_t::iterator>;
-    using MSHR_t = std::vector<MSHREntry_t>;
-    MSHR_t m_mshrs;
-    std::unordered_map<Addr_t, std::vector<Request>> m_receive_requests;
+    SetAssocArray m_lines;
 
-    // Request that miss in the LLC with the clock cycle (current cycle + llc latency) that they 
+    MSHRFile m_mshrs;
+    RequestCallback m_fill_callback;      // Of the miss requests sent to the memory system
+
+    // Request that miss in the LLC, due at the clock cycle (current cycle + llc latency) that they 
     // should be sent to the memory system
-    std::list<std::pair<Clk_t, Request>> m_miss_list;
+    TimingWheel<Request> m_miss_list;
 
-    // Request that hit in the LLC with the clock cycle (current cycle + llc latency) that they 
+    // Request that hit in the LLC, due at the clock cycle (current cycle + llc latency) that they 
     // should be sent back to the core (calls the callback)
-    std::list<std::pair<Clk_t, Request>> m_hit_list;
+    TimingWheel<Request> m_hit_list;
 
     IMemorySystem* m_memory_system;
 
+    // Optional prefetcher, trained on the demand accesses
+    std::unique_ptr<LLCPrefetcher> m_prefetcher;
+    std::vector<Addr_t> m_prefetch_candidates;
+    size_t m_prefetch_mshr_reserve = 0;   // MSHR entries prefetches leave free for demand misses
+    Clk_t m_prefetch_backoff = 0;         // Cycles without prefetches after the memory system refuses a request
+    Clk_t m_prefetch_resume_clk = 0;
+    std::vector<Addr_t> m_prefetch_victims;   // Per set, the last line a prefetch evicted (-1: none)
+
+    int m_access_source = -1;             // The core of the access send() is serving
+
     Logger_t m_logger;
 
 
   public:
+    static constexpr int PREFETCH_PAGE_BITS = 12;   // Prefetches do not cross 4KB boundaries
+
     int m_latency;
 
     size_t m_size_bytes;
     size_t m_linesize_bytes;
     int m_associativity;
     int m_set_size;
-    int m_num_mshrs;
 
     Addr_t m_index_mask;
     int m_index_offset;
@@ -69,16 +76,65 @@ class SimpleO3LLC : public Clocked<SimpleO3LLC> {
     int s_llc_write_misses = 0;
     int s_llc_eviction = 0;
     int s_llc_mshr_unavailable = 0;
+    int s_llc_mshr_target_full = 0;
+    int s_llc_prefetch_issued = 0;
+    int s_llc_prefetch_useful = 0;        // Prefetched lines accessed on demand (including late ones)
+    int s_llc_prefetch_late = 0;          // Demand accesses to a prefetched line still being filled
+    int s_llc_prefetch_redundant = 0;     // Candidates already in the LLC or being filled
+    int s_llc_prefetch_throttled = 0;     // Candidates dropped for back-pressure, the MSHR reserve or a set being filled
+    int s_llc_prefetch_unused = 0;        // Prefetched lines evicted before a demand access
+    int s_llc_prefetch_pollution = 0;     // Demand misses to a line a prefetch evicted
+    float s_llc_prefetch_accuracy = 0;
+    uint64_t s_llc_mshr_occupancy = 0;    // Summed over the cycles since m_stats_start_clk
+    float s_llc_mshr_occupancy_avg = 0;
+    int s_llc_mshr_occupancy_max = 0;
+    Clk_t m_stats_start_clk = 0;
+
+    // Optional, called with every request the LLC schedules to the memory system and the core whose access caused it
+    std::function<void(BinaryTrace::LLCOp op, Addr_t addr, int core_id)> m_traffic_observer;
+    // Optional, called when the memory system serves a demand miss of core_id
+    std::function<void(int core_id)> m_return_observer;
     
 
   public:
-    SimpleO3LLC(int latency, int size_bytes, int linesize_bytes, int associativity, int num_mshrs);
+    SimpleO3LLC(int latency, int size_bytes, int linesize_bytes, int associativity, int num_mshrs, int num_mshr_targets);
     void connect_memory_system(IMemorySystem* memory_system) { m_memory_system = memory_system; };
+
+    /**
+     * @brief   Prefetches the lines the prefetcher generates, while more than mshr_reserve MSHR entries are free and the
+     *          memory system has not refused a request in the last backoff cycles.
+     * 
+     */
+    void set_prefetcher(std::unique_ptr<LLCPrefetcher> prefetcher, int mshr_reserve, Clk_t backoff);
     
     void tick();
     bool send(Request req);
+    /**
+     * @brief   Fills the line that the memory system served req for, and responds to all the requests waiting for it.
+     * 
+     */
     void receive(Request& req);
 
+    /**
+     * @brief   Functional access during fast-forward: updates the tags and LRU state right away, with no latency, MSHR,
+     *          writeback or statistics.
+     * 
+     */
+    void access_functional(Addr_t addr, bool is_write);
+
+    // Restarts the statistics from the current cycle (e.g., at the end of a warmup)
+    void reset_stats();
+
+    // Computes the average statistics at the end of the simulation
+    void finalize();
+
+    /**
+     * @brief   Saves (restores) the filled lines of all sets in LRU order. The lines still being filled are dropped.
+     * 
+     */
+    void save_checkpoint(std::ostream& out);
+    void load_checkpoint(std::istream& in);
+
     void serialize(std::string serialization_filename);
     void deserialize(std::string serialization_filename);
     void dump_llc();
@@ -88,13 +144,16 @@ class SimpleO3LLC : public Clocked<SimpleO3LLC> {
     Addr_t get_tag(Addr_t addr) { return (addr >> m_tag_offset); };
     Addr_t align(Addr_t addr)   { return (addr & ~(m_linesize_bytes-1l)); };
 
-    CacheSet_t& get_set(Addr_t addr);
-    CacheSet_t::iterator allocate_line(CacheSet_t& set, Addr_t addr);
-    bool need_eviction(const CacheSet_t& set, Addr_t addr);
-    void evict_line(CacheSet_t& set, CacheSet_t::iterator victim_it);
+    // The address of the line (the tag of the way) of the set
+    Addr_t line_addr(int set, Addr_t tag) { return (tag << m_tag_offset) | (Addr_t(set) << m_index_offset); };
+
+    int allocate_line(int set, Addr_t addr, bool is_prefetch = false);
+    void evict_line(int set, int way, bool is_prefetch = false);
+
+    // Trains the prefetcher with an accepted demand access and issues the prefetches it generates
+    void prefetch(Addr_t addr, bool is_trigger);
 
-    CacheSet_t::iterator check_set_hit(CacheSet_t& set, Addr_t addr);
-    MSHR_t::iterator check_mshr_hit(Addr_t addr);
+    int check_set_hit(int set, Addr_t addr);
 };
 
 }        // namespace Ramulator
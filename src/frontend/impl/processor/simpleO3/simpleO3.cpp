@@ -1,6 +1,11 @@
 #include <functional>
+#include <memory>
+#include <set>
 
 #include "base/utils.h"
+#include "base/checkpoint.h"
+#include "base/memory_report.h"
+#include "base/tick_pool.h"
 #include "frontend/frontend.h"
 #include "translation/translation.h"
 #include "frontend/impl/processor/simpleO3/core.h"
@@ -9,7 +14,7 @@
 
 namespace Ramulator {
 
-class SimpleO3 final : public IFrontEnd, public Implementation {
+class SimpleO3 final : public IFrontEnd, public Implementation, public Checkpointable {
   RAMULATOR_REGISTER_IMPLEMENTATION(IFrontEnd, SimpleO3, "SimpleO3", "Simple timing model OoO processor frontend.")
 
   private:
@@ -19,8 +24,28 @@ class SimpleO3 final : public IFrontEnd, public Implementation {
     std::vector<SimpleO3Core*> m_cores;
     SimpleO3LLC* m_llc;
 
+    std::unique_ptr<TickPool> m_tick_pool;    // Only set when the cores are ticked in parallel
+
     size_t m_num_expected_insts = 0;
 
+    // Fast-forward (functional), warmup (timed, not recorded) and measured phases, optionally repeated for sampling
+    enum class Phase { FastForward, Warmup, Measure };
+    Phase m_phase = Phase::Measure;
+    size_t m_fast_forward_insts = 0;
+    size_t m_warmup_insts = 0;
+    size_t m_sampling_period_insts = 0;     // 0: measure once, until every core has retired num_expected_insts
+    size_t m_sampling_detailed_insts = 0;
+    std::vector<size_t> m_warmup_start_insts;
+    int s_num_samples = 0;
+    std::vector<float> s_sampled_ipc;
+
+    // Optional LLCMiss trace of the requests the LLC sends to the memory system, replayed by LLCMissTrace
+    std::unique_ptr<BinaryTrace::Writer> m_miss_trace;
+    std::vector<Clk_t> m_miss_trace_clk;      // Per core, the cycle of its last record
+    std::vector<Clk_t> m_miss_trace_stalls;   // Per core, its stall cycles at its last record
+    std::vector<uint32_t> m_miss_trace_reads; // Per core, its demand misses in flight
+    size_t s_llc_miss_trace_records = 0;
+
     std::string serialization_filename;
 
 
@@ -31,9 +56,17 @@ class SimpleO3 final : public IFrontEnd, public Implementation {
       // Core params
       std::vector<std::string> trace_list = param<std::vector<std::string>>("traces").desc("A list of traces.").required();
       m_num_cores = trace_list.size();
+      // Parse the traces in parallel while the rest of the simulation is built
+      for (const std::string& trace_path : trace_list) {
+        SimpleO3Core::Trace::prefetch(trace_path);
+      }
 
       int ipc   = param<int>("ipc").desc("IPC of the SimpleO3 core.").default_val(4);
       int depth = param<int>("inst_window_depth").desc("Instruction window size of the SimpleO3 core.").default_val(128);
+      int num_threads = param<int>("num_threads").desc("Number of threads that run the core-local part of the core ticks in parallel (1 = tick the cores sequentially).").default_val(1);
+      if (num_threads < 1) {
+        throw ConfigurationError("SimpleO3: num_threads must be at least 1 (got {})!", num_threads);
+      }
 
       // LLC params
       int llc_latency           = param<int>("llc_latency").desc("Aggregated latency of the LLC.").default_val(47);
@@ -41,25 +74,77 @@ class SimpleO3 final : public IFrontEnd, public Implementation {
       int llc_associativity     = param<int>("llc_associativity").desc("LLC set associativity.").default_val(8);
       int llc_capacity_per_core = parse_capacity_str(param<std::string>("llc_capacity_per_core").desc("LLC capacity per core.").default_val("2MB"));
       int llc_num_mshr_per_core = param<int>("llc_num_mshr_per_core").desc("Number of LLC MSHR entries per core.").default_val(16);
+      int llc_num_mshr_targets  = param<int>("llc_num_mshr_targets").desc("Number of requests that can wait for the line of an LLC MSHR entry.").default_val(8);
+
+      // LLC prefetcher params
+      std::string llc_prefetcher = param<std::string>("llc_prefetcher").desc("LLC prefetcher (none, next_line, stream or stride).").default_val("none");
+      int llc_prefetch_degree     = param<int>("llc_prefetch_degree").desc("Lines the LLC prefetches per trigger.").default_val(2);
+      int llc_prefetch_distance   = param<int>("llc_prefetch_distance").desc("Lines (strides for stride) ahead of the access of the first LLC prefetch.").default_val(1);
+      int llc_prefetch_table_size = param<int>("llc_prefetch_table_size").desc("Streams (regions for stride) the LLC prefetcher tracks.").default_val(16);
+      int llc_prefetch_region     = parse_capacity_str(param<std::string>("llc_prefetch_region").desc("Region size of the stride prefetcher.").default_val("4KB"));
+      int llc_prefetch_mshr_reserve_per_core = param<int>("llc_prefetch_mshr_reserve_per_core").desc("LLC MSHR entries per core that prefetches leave to demand misses.").default_val(4);
+      Clk_t llc_prefetch_backoff  = param<Clk_t>("llc_prefetch_backoff").desc("Cycles the LLC stops prefetching after the memory system refuses a request.").default_val(100);
+      std::string llc_miss_trace  = param<std::string>("llc_miss_trace").desc("Records the misses, writebacks and prefetches the LLC sends to the memory system to this binary LLCMiss trace, for the LLCMissTrace frontend.").default_val("");
 
       // Simulation parameters
       m_num_expected_insts = param<int>("num_expected_insts").desc("Number of instructions that the frontend should execute.").required();
+      m_fast_forward_insts = param<size_t>("fast_forward_insts").desc("Number of instructions per core to skip functionally (warming only the LLC tags) before the timed simulation.").default_val(0);
+      m_warmup_insts = param<size_t>("warmup_insts").desc("Number of instructions per core to simulate with timing but without recording before the measurement.").default_val(0);
+      m_sampling_period_insts = param<size_t>("sampling_period_insts").desc("Instructions per core between the starts of the measured samples (0 = measure once).").default_val(0);
+      m_sampling_detailed_insts = param<size_t>("sampling_detailed_insts").desc("Instructions per core measured in every sample.").default_val(10000);
+      if (m_sampling_period_insts > 0 && (m_sampling_detailed_insts == 0 || m_warmup_insts + m_sampling_detailed_insts > m_sampling_period_insts)) {
+        throw ConfigurationError("SimpleO3: sampling needs 0 < sampling_detailed_insts and warmup_insts + sampling_detailed_insts <= sampling_period_insts (got {}, {} and {})!", m_sampling_detailed_insts, m_warmup_insts, m_sampling_period_insts);
+      }
 
       // Create address translation module
       m_translation = create_child_ifce<ITranslation>();
 
       // Create the LLC
-      m_llc = new SimpleO3LLC(llc_latency, llc_capacity_per_core * m_num_cores, llc_linesize_bytes, llc_associativity, llc_num_mshr_per_core * m_num_cores);
+      m_llc = new SimpleO3LLC(llc_latency, llc_capacity_per_core * m_num_cores, llc_linesize_bytes, llc_associativity, llc_num_mshr_per_core * m_num_cores, llc_num_mshr_targets);
+      if (llc_prefetcher != "none") {
+        std::unique_ptr<LLCPrefetcher> prefetcher;
+        if (llc_prefetcher == "next_line") {
+          prefetcher = std::make_unique<NextLinePrefetcher>(llc_prefetch_degree, llc_prefetch_distance);
+        } else if (llc_prefetcher == "stream") {
+          prefetcher = std::make_unique<StreamPrefetcher>(llc_prefetch_degree, llc_prefetch_distance, llc_prefetch_table_size);
+        } else if (llc_prefetcher == "stride") {
+          prefetcher = std::make_unique<StridePrefetcher>(llc_prefetch_degree, llc_prefetch_distance, llc_prefetch_table_size, llc_prefetch_region / llc_linesize_bytes);
+        } else {
+          throw ConfigurationError("SimpleO3: Unknown llc_prefetcher \"{}\" (none, next_line, stream or stride)!", llc_prefetcher);
+        }
+        m_llc->set_prefetcher(std::move(prefetcher), llc_prefetch_mshr_reserve_per_core * m_num_cores, llc_prefetch_backoff);
+      }
       // m_llc->deserialize(serialization_filename);
       // m_llc->serialize(serialization_filename);
 
       // Create the cores
       for (int id = 0; id < m_num_cores; id++) {
         SimpleO3Core* core = new SimpleO3Core(id, ipc, depth, m_num_expected_insts, trace_list[id], m_translation, m_llc);
-        core->m_callback = [this](Request& req){return this->receive(req);} ;
+        core->m_callback = [core](Request& req){return core->receive(req);} ;
         m_cores.push_back(core);
       }
 
+      if (!llc_miss_trace.empty()) {
+        m_miss_trace = std::make_unique<BinaryTrace::Writer>(llc_miss_trace, BinaryTrace::Kind::LLCMiss);
+        m_miss_trace_clk.assign(m_num_cores, 0);
+        m_miss_trace_stalls.assign(m_num_cores, 0);
+        m_miss_trace_reads.assign(m_num_cores, 0);
+        m_llc->m_traffic_observer = [this](BinaryTrace::LLCOp op, Addr_t addr, int core_id) { record_llc_miss(op, addr, core_id); };
+        m_llc->m_return_observer = [this](int core_id) { m_miss_trace_reads[core_id]--; };
+      }
+
+      if (m_fast_forward_insts > 0) {
+        m_phase = Phase::FastForward;
+      } else if (m_warmup_insts > 0) {
+        enter_warmup();
+      } else {
+        enter_measure();
+      }
+
+      if (num_threads > 1 && m_num_cores > 1) {
+        m_tick_pool = std::make_unique<TickPool>(num_threads, m_num_cores, [this](int core_id) { m_cores[core_id]->tick_local(); });
+      }
+
       m_logger = Logging::create_logger("SimpleO3");
 
       // Register the stats
@@ -70,12 +155,37 @@ class SimpleO3 final : public IFrontEnd, public Implementation {
       register_stat(m_llc->s_llc_read_misses).name("llc_read_misses");
       register_stat(m_llc->s_llc_write_misses).name("llc_write_misses");
       register_stat(m_llc->s_llc_mshr_unavailable).name("llc_mshr_unavailable");
+      register_stat(m_llc->s_llc_mshr_target_full).name("llc_mshr_target_full");
+      register_stat(m_llc->s_llc_mshr_occupancy_avg).name("llc_mshr_occupancy_avg");
+      register_stat(m_llc->s_llc_mshr_occupancy_max).name("llc_mshr_occupancy_max");
+      if (llc_prefetcher != "none") {
+        register_stat(m_llc->s_llc_prefetch_issued).name("llc_prefetch_issued");
+        register_stat(m_llc->s_llc_prefetch_useful).name("llc_prefetch_useful");
+        register_stat(m_llc->s_llc_prefetch_late).name("llc_prefetch_late");
+        register_stat(m_llc->s_llc_prefetch_redundant).name("llc_prefetch_redundant");
+        register_stat(m_llc->s_llc_prefetch_throttled).name("llc_prefetch_throttled");
+        register_stat(m_llc->s_llc_prefetch_unused).name("llc_prefetch_unused");
+        register_stat(m_llc->s_llc_prefetch_pollution).name("llc_prefetch_pollution");
+        register_stat(m_llc->s_llc_prefetch_accuracy).name("llc_prefetch_accuracy");
+      }
+      if (m_miss_trace) {
+        register_stat(s_llc_miss_trace_records).name("llc_miss_trace_records");
+      }
       
       for (int core_id = 0; core_id < m_cores.size(); core_id++) {
         // register_stat(m_cores[core_id]->s_insts_retired).name("cycles_retired_core_{}", core_id);
         register_stat(m_cores[core_id]->s_cycles_recorded).name("cycles_recorded_core_{}", core_id);
         register_stat(m_cores[core_id]->s_mem_access_cycles).name("memory_access_cycles_recorded_core_{}", core_id);
       }
+      if (m_fast_forward_insts > 0 || m_sampling_period_insts > 0) {
+        s_sampled_ipc.resize(m_num_cores, 0);
+        register_stat(s_num_samples).name("num_samples");
+        for (int core_id = 0; core_id < m_cores.size(); core_id++) {
+          register_stat(m_cores[core_id]->s_insts_forwarded).name("insts_forwarded_core_{}", core_id);
+          register_stat(m_cores[core_id]->s_insts_recorded).name("insts_recorded_core_{}", core_id);
+          register_stat(s_sampled_ipc[core_id]).name("ipc_recorded_core_{}", core_id);
+        }
+      }
     }
 
     void tick() override {
@@ -85,24 +195,120 @@ class SimpleO3 final : public IFrontEnd, public Implementation {
         m_logger->info("Processor Heartbeat {} cycles.", m_clk);
       }
 
+      advance_phase();
+
       m_llc->tick();
-      for (auto core : m_cores) {
-        core->tick();
+      if (m_tick_pool) {
+        // Nothing a core does before it reaches the LLC affects the other cores, so only the LLC accesses have to
+        // be made in core order
+        m_tick_pool->tick_all();
+        for (auto core : m_cores) {
+          core->tick_memory();
+        }
+      } else {
+        for (auto core : m_cores) {
+          core->tick();
+        }
       }
     }
 
-    void receive(Request& req) {
-      m_llc->receive(req);
-
-      // TODO: LLC latency for the core to receive the request?
-      for (auto r : m_llc->m_receive_requests[req.addr]) {
-        r.arrive = req.arrive;
-        r.depart = req.depart;
-        m_cores[r.source_id]->receive(r);
+    void finalize() override {
+      m_llc->finalize();
+      if (m_miss_trace) {
+        m_miss_trace->close();
+        s_llc_miss_trace_records = m_miss_trace->header().num_records;
+        m_logger->info("Recorded {} LLC misses, writebacks and prefetches ({} bytes) to the LLC miss trace.", s_llc_miss_trace_records, m_miss_trace->header().payload_size);
       }
-      m_llc->m_receive_requests[req.addr].clear();
+      for (size_t core_id = 0; core_id < s_sampled_ipc.size(); core_id++) {
+        SimpleO3Core* core = m_cores[core_id];
+        s_sampled_ipc[core_id] = core->s_cycles_recorded > 0 ? float(core->s_insts_recorded) / core->s_cycles_recorded : 0;
+      }
+      IFrontEnd::finalize();
     };
 
+  private:
+    /**
+     * @brief    Records a request the LLC sent for an access of core_id. The gap to the previous record of the core
+     *           leaves out the cycles the core stalled in between, as the replay stalls on its own memory system: a
+     *           record after a stall waits until as few demand misses of its core are in flight as when it was sent.
+     *
+     */
+    void record_llc_miss(BinaryTrace::LLCOp op, Addr_t addr, int core_id) {
+      Clk_t stall_cycles = m_cores[core_id]->m_stall_cycles - m_miss_trace_stalls[core_id];
+      BinaryTrace::LLCMissRecord record;
+      record.core_id = core_id;
+      record.op = op;
+      record.addr = addr;
+      record.gap = std::max<Clk_t>(m_clk - m_miss_trace_clk[core_id] - stall_cycles, 0);
+      record.blocked = stall_cycles > 0;
+      record.reads_in_flight = m_miss_trace_reads[core_id];
+      m_miss_trace->llc_miss(record);
+      if (op == BinaryTrace::LLCOp::Read) {
+        m_miss_trace_reads[core_id]++;
+      }
+      m_miss_trace_clk[core_id] = m_clk;
+      m_miss_trace_stalls[core_id] = m_cores[core_id]->m_stall_cycles;
+    }
+
+    // Moves to the next phase once every core is through the current one. Fast-forwarding takes no simulated time.
+    void advance_phase() {
+      if (m_phase == Phase::Warmup) {
+        for (int core_id = 0; core_id < m_num_cores; core_id++) {
+          if (m_cores[core_id]->s_insts_retired - m_warmup_start_insts[core_id] < m_warmup_insts) {
+            return;
+          }
+        }
+        enter_measure();
+      } else if (m_phase == Phase::Measure && m_sampling_period_insts > 0) {
+        for (auto core : m_cores) {
+          if (core->is_recording()) {
+            return;
+          }
+        }
+        if (is_finished()) {
+          return;
+        }
+        m_phase = Phase::FastForward;
+      }
+
+      if (m_phase == Phase::FastForward) {
+        size_t num_insts = s_num_samples == 0 ? m_fast_forward_insts : m_sampling_period_insts - m_warmup_insts - m_sampling_detailed_insts;
+        // Interleave the cores so that they share the LLC roughly as they would when timed
+        const size_t chunk_insts = 64;
+        for (size_t num_forwarded = 0; num_forwarded < num_insts; num_forwarded += chunk_insts) {
+          for (auto core : m_cores) {
+            core->fast_forward(std::min(chunk_insts, num_insts - num_forwarded));
+          }
+        }
+        if (m_warmup_insts > 0) {
+          enter_warmup();
+        } else {
+          enter_measure();
+        }
+      }
+    }
+
+    void enter_warmup() {
+      m_phase = Phase::Warmup;
+      m_warmup_start_insts.clear();
+      for (auto core : m_cores) {
+        core->stop_recording();
+        m_warmup_start_insts.push_back(core->s_insts_retired);
+      }
+    }
+
+    void enter_measure() {
+      m_phase = Phase::Measure;
+      if (s_num_samples == 0 && (m_fast_forward_insts > 0 || m_warmup_insts > 0)) {
+        m_llc->reset_stats();
+      }
+      s_num_samples++;
+      for (auto core : m_cores) {
+        core->start_recording(m_sampling_period_insts > 0 ? m_sampling_detailed_insts : m_num_expected_insts);
+      }
+    }
+
+  public:
     bool is_finished() override {
       for (auto core : m_cores) {
         if (!(core->reached_expected_num_insts)){
@@ -119,6 +325,36 @@ class SimpleO3 final : public IFrontEnd, public Implementation {
     int get_num_cores() override {
       return m_num_cores;
     };
+
+    // The LLC, the instruction windows and the parsed traces (once per file)
+    size_t memory_footprint() const override {
+      size_t bytes = m_llc->m_lines.footprint_bytes() + m_llc->m_mshrs.footprint_bytes() + heap_bytes(m_llc->m_prefetch_victims);
+      std::set<const void*> traces;
+      for (const SimpleO3Core* core : m_cores) {
+        bytes += core->footprint_bytes();
+        if (traces.insert(core->m_trace.parsed_id()).second) {
+          bytes += core->m_trace.parsed_bytes();
+        }
+      }
+      return bytes;
+    };
+
+    // The LLC contents and the trace position and instruction window of every core
+    void save_checkpoint(std::ostream& out) override {
+      Checkpoint::write<int>(out, m_num_cores);
+      m_llc->save_checkpoint(out);
+      for (auto core : m_cores) {
+        core->save_checkpoint(out);
+      }
+    };
+
+    void load_checkpoint(std::istream& in) override {
+      Checkpoint::expect<int>(in, m_num_cores, "number of cores");
+      m_llc->load_checkpoint(in);
+      for (auto core : m_cores) {
+        core->load_checkpoint(in);
+      }
+    };
 };
 
 }        // namespace Ramulator
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include <memory>
+#include <vector>
+
+#include "base/exception.h"
+#include "frontend/frontend.h"
+#include "dram/dram.h"
+#include "addr_mapper/addr_mapper.h"
+#include "frontend/impl/memory_trace/streamed_trace.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    A RowHammer attacker generated on the fly, optionally interleaved with a benign load/store trace.
+ *
+ * @details
+ * The attacker reads the aggressor rows of its pattern around victim_row in num_banks banks of a channel, one
+ * aggressor of every bank after the other, so consecutive reads to a bank always conflict in its row buffer:
+ *   - double_sided: rows victim_row - 1 and victim_row + 1.
+ *   - many_sided:   num_aggressors rows victim_row - 1, victim_row + 1, victim_row + 3, ... (TRRespass).
+ *   - half_double:  the far aggressors victim_row - 2 and victim_row + 2, and the near aggressors victim_row - 1 and
+ *                   victim_row + 1 once every half_double_near_period rounds.
+ * The banks are the first num_banks flat banks of the channel (the bank level counting fastest). The physical
+ * addresses of the aggressors are solved once with the inverse of the address mapper, so the attacker follows any
+ * mapper that can invert its mapping (the linear and BitMask ones).
+ *
+ * attack_ratio of the requests are the attacker's (source 1), the others come from the benign trace (source 0),
+ * interleaved evenly. Without a benign trace every request is the attacker's.
+ *
+ */
+class RowHammerMix : public IFrontEnd, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IFrontEnd, RowHammerMix, "RowHammerMix", "RowHammer attack patterns in DRAM address space, mixed with a benign trace.")
+
+  private:
+    struct Trace {
+      int type_id;
+      Addr_t addr;
+    };
+    struct TraceParser {
+      // "[<timestamp>] LD <addr>" or "[<timestamp>] ST <addr>", the timestamp is ignored
+      static bool parse(TraceLineScanner& line, Trace& t) {
+        int64_t timestamp;
+        line.integer(timestamp);
+        std::string_view type = line.token();
+        if (type == "LD") {
+          t.type_id = Request::Type::Read;
+        } else if (type == "ST") {
+          t.type_id = Request::Type::Write;
+        } else {
+          return false;
+        }
+        int64_t addr;
+        if (!line.integer(addr)) {
+          return false;
+        }
+        t.addr = addr;
+        return true;
+      };
+    };
+    std::unique_ptr<TraceSource<Trace>> m_benign;    // nullptr without a benign trace
+
+    static constexpr int BENIGN_SOURCE = 0;
+    static constexpr int ATTACK_SOURCE = 1;
+
+    std::string m_pattern;
+    int m_num_aggressors = 0;
+    int m_near_period = 0;
+    int m_channel = 0;
+    int m_num_banks = 1;
+    int m_victim_row = -1;
+
+    std::vector<Addr_t> m_round;      // The aggressor reads of a round
+    std::vector<Addr_t> m_near;       // The near aggressor reads added to every half_double_near_period-th round
+    size_t m_next = 0;                // Into the current round, then into m_near
+    size_t m_num_rounds = 0;
+
+    double m_attack_ratio = 0.5;
+    double m_attack_credits = 0.0;
+    double m_rate = 1.0;
+    double m_credits = 0.0;
+    size_t m_num_requests = 0;
+    size_t m_num_sent = 0;
+
+    // The request waiting to be sent
+    Addr_t m_addr = -1;
+    int m_type = Request::Type::Read;
+    int m_source = -1;
+    bool m_has_pending = false;
+
+    size_t s_num_attack_requests = 0;
+    size_t s_num_benign_requests = 0;
+    size_t s_num_send_retries = 0;
+
+    Logger_t m_logger;
+
+  public:
+    void init() override {
+      m_clock_ratio = param<uint>("clock_ratio").required();
+
+      m_pattern = param<std::string>("pattern").desc("The hammer pattern: double_sided, many_sided or half_double.").default_val("double_sided");
+      m_num_aggressors = param<int>("num_aggressors").desc("Aggressor rows per bank of the many_sided pattern.").default_val(8);
+      m_near_period = param<int>("half_double_near_period").desc("Rounds of the half_double pattern between two reads of the near aggressors.").default_val(32);
+      m_channel = param<int>("channel").desc("The channel of the hammered banks.").default_val(0);
+      m_num_banks = param<int>("num_banks").desc("Banks hammered at once, the first flat banks of the channel.").default_val(1);
+      m_victim_row = param<int>("victim_row").desc("The victim row of every hammered bank (-1 = the middle row).").default_val(-1);
+      m_attack_ratio = param<double>("attack_ratio").desc("Fraction of the requests that are the attacker's, with a benign trace.").default_val(0.5);
+      std::string benign_path = param<std::string>("benign_trace").desc("Path to a load/store trace of the benign traffic (none by default).").default_val("");
+      m_num_requests = param<size_t>("num_requests").desc("Number of requests (attacker and benign) before the simulation finishes.").required();
+      m_rate = param<double>("rate").desc("Requests per frontend cycle.").default_val(1.0);
+
+      if (m_pattern != "double_sided" && m_pattern != "many_sided" && m_pattern != "half_double") {
+        throw ConfigurationError("Unrecognized RowHammerMix pattern {} (double_sided, many_sided or half_double)!", m_pattern);
+      }
+      if (m_pattern == "many_sided" && m_num_aggressors < 2) {
+        throw ConfigurationError("RowHammerMix many_sided needs at least 2 aggressors (got {})!", m_num_aggressors);
+      }
+      if (m_pattern == "half_double" && m_near_period <= 0) {
+        throw ConfigurationError("RowHammerMix half_double_near_period must be positive (got {})!", m_near_period);
+      }
+      if (m_num_banks <= 0) {
+        throw ConfigurationError("RowHammerMix needs at least one bank to hammer!");
+      }
+      if (m_rate <= 0.0) {
+        throw ConfigurationError("RowHammerMix rate must be positive!");
+      }
+      if (m_attack_ratio < 0.0 || m_attack_ratio > 1.0) {
+        throw ConfigurationError("RowHammerMix attack_ratio must be in [0, 1]!");
+      }
+
+      m_logger = Logging::create_logger("RowHammerMix");
+      if (benign_path.empty()) {
+        m_attack_ratio = 1.0;
+      } else {
+        m_benign = open_trace<Trace, TraceParser>(benign_path);
+        m_logger->info("Opened benign trace file {} ({} bytes).", benign_path, m_benign->file_size());
+      }
+      if (m_attack_ratio == 0.0) {
+        m_logger->warn("attack_ratio is 0, only the benign trace is sent.");
+      }
+
+      register_stat(s_num_attack_requests).name("num_attack_requests");
+      register_stat(s_num_benign_requests).name("num_benign_requests");
+      register_stat(s_num_send_retries).name("num_send_retries");
+    };
+
+
+    void tick() override {
+      // The address mapper is set up after the frontend, so the aggressors are solved at the first cycle
+      if (m_round.empty() && m_attack_ratio > 0.0) {
+        resolve_aggressors();
+      }
+
+      m_credits = std::min(m_credits + m_rate, std::max(m_rate, 1.0));
+      while (m_credits >= 1.0 && m_num_sent < m_num_requests) {
+        if (!m_has_pending) {
+          generate();
+        }
+        if (!m_memory_system->send({m_addr, m_type, m_source, nullptr})) {
+          s_num_send_retries++;
+          break;
+        }
+        m_has_pending = false;
+        m_credits -= 1.0;
+        m_num_sent++;
+        if (m_source == ATTACK_SOURCE) {
+          s_num_attack_requests++;
+        } else {
+          s_num_benign_requests++;
+        }
+      }
+    };
+
+    int get_num_cores() override { return m_benign ? 2 : 1; };
+
+    bool is_finished() override { return m_num_sent == m_num_requests; };
+
+  private:
+    void generate() {
+      m_attack_credits += m_attack_ratio;
+      if (m_attack_credits >= 1.0) {
+        m_attack_credits -= 1.0;
+        m_addr = next_aggressor();
+        m_type = Request::Type::Read;
+        m_source = m_benign ? ATTACK_SOURCE : 0;
+      } else {
+        const Trace& t = m_benign->current();
+        m_addr = t.addr;
+        m_type = t.type_id;
+        m_source = BENIGN_SOURCE;
+        m_benign->advance();
+      }
+      m_has_pending = true;
+    };
+
+    Addr_t next_aggressor() {
+      bool is_near_round = !m_near.empty() && m_num_rounds % m_near_period == m_near_period - 1;
+      if (m_next == m_round.size() + (is_near_round ? m_near.size() : 0)) {
+        m_next = 0;
+        m_num_rounds++;
+      }
+      Addr_t addr = m_next < m_round.size() ? m_round[m_next] : m_near[m_next - m_round.size()];
+      m_next++;
+      return addr;
+    };
+
+    void resolve_aggressors() {
+      IDRAM* dram = m_memory_system->get_ifce<IDRAM>();
+      IAddrMapper* addr_mapper = m_memory_system->get_ifce<IAddrMapper>();
+      int row_level = dram->m_levels("row");
+      int num_rows = dram->m_organization.count[row_level];
+      if (m_victim_row == -1) {
+        m_victim_row = num_rows / 2;
+      }
+
+      std::vector<int> rows;
+      std::vector<int> near_rows;
+      if (m_pattern == "double_sided") {
+        rows = {m_victim_row - 1, m_victim_row + 1};
+      } else if (m_pattern == "many_sided") {
+        for (int i = 0; i < m_num_aggressors; i++) {
+          rows.push_back(m_victim_row - 1 + 2 * i);
+        }
+      } else {
+        rows = {m_victim_row - 2, m_victim_row + 2};
+        near_rows = {m_victim_row - 1, m_victim_row + 1};
+      }
+      for (int row : rows) {
+        if (row < 0 || row >= num_rows) {
+          throw ConfigurationError("RowHammerMix: aggressor row {} of victim row {} is outside the {} rows of a bank!", row, m_victim_row, num_rows);
+        }
+      }
+      if (m_channel < 0 || m_channel >= dram->m_organization.count[0]) {
+        throw ConfigurationError("RowHammerMix: channel {} is not in the organization!", m_channel);
+      }
+      if (m_num_banks > dram->m_num_flat_banks) {
+        throw ConfigurationError("RowHammerMix: cannot hammer {} banks, a channel has {}!", m_num_banks, dram->m_num_flat_banks);
+      }
+
+      auto resolve = [&](const std::vector<int>& rows, std::vector<Addr_t>& addrs) {
+        for (int row : rows) {
+          for (int bank = 0; bank < m_num_banks; bank++) {
+            AddrVec_t addr_vec(dram->m_levels.size(), 0);
+            addr_vec[0] = m_channel;
+            for (int level = dram->m_flat_bank_first_level; level <= dram->m_flat_bank_last_level; level++) {
+              int stride = dram->m_flat_bank_strides[level - dram->m_flat_bank_first_level];
+              addr_vec[level] = bank / stride % dram->m_organization.count[level];
+            }
+            addr_vec[row_level] = row;
+            Addr_t addr = -1;
+            if (!addr_mapper->invert(addr_vec, addr)) {
+              throw ConfigurationError("RowHammerMix: the address mapper cannot find the physical address of row {} of bank {}!", row, bank);
+            }
+            addrs.push_back(addr);
+          }
+        }
+      };
+      resolve(rows, m_round);
+      resolve(near_rows, m_near);
+      m_logger->info("Hammering {} aggressor row(s) around victim row {} in {} bank(s) of channel {} ({}).", rows.size() + near_rows.size(), m_victim_row, m_num_banks, m_channel, m_pattern);
+    };
+};
+
+}        // namespace Ramulator
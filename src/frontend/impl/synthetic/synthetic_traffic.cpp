@@ -0,0 +1,179 @@
+#include <memory>
+#include <random>
+
+#include "base/utils.h"
+#include "base/exception.h"
+#include "frontend/frontend.h"
+#include "frontend/impl/synthetic/traffic_pattern.h"
+
+namespace Ramulator {
+
+class SyntheticTraffic : public IFrontEnd, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IFrontEnd, SyntheticTraffic, "SyntheticTraffic", "Synthetic memory traffic generated on the fly.")
+
+  private:
+    struct Stream {
+      std::unique_ptr<TrafficPattern> pattern;
+      RandomStream rng;
+      Addr_t base;
+      double credits = 0.0;     // Requests the stream may issue, accumulated at the request rate
+
+      // The request waiting to be sent
+      Addr_t addr = -1;
+      int type = Request::Type::Read;
+      bool has_pending = false;
+
+      size_t num_sent = 0;
+    };
+    std::vector<Stream> m_streams;
+
+    double m_write_ratio = 0.0;
+    double m_rate = 1.0;
+    size_t m_num_requests = 0;
+
+    size_t s_num_read_requests = 0;
+    size_t s_num_write_requests = 0;
+    size_t s_num_send_retries = 0;
+
+    Logger_t m_logger;
+
+  public:
+    void init() override {
+      m_clock_ratio = param<uint>("clock_ratio").required();
+
+      std::string pattern = param<std::string>("pattern").desc("The address pattern: stream, stride, random, zipf, gemm or kv_cache.").default_val("stream");
+      int num_streams = param<int>("num_streams").desc("Number of independent streams (e.g., one per core), each in its own region.").default_val(1);
+      m_num_requests = param<size_t>("num_requests").desc("Number of requests per stream before the simulation finishes.").required();
+      m_rate = param<double>("rate").desc("Requests per frontend cycle per stream.").default_val(1.0);
+      m_write_ratio = param<double>("write_ratio").desc("Fraction of writes of the stream, stride, random and zipf patterns.").default_val(0.0);
+      uint64_t seed = param<uint64_t>("seed").desc("Seed of the random patterns and the read/write mix.").default_val(0);
+
+      Addr_t access_size = param<Addr_t>("access_size").desc("Bytes per request (and between consecutive lines).").default_val(64);
+      Addr_t footprint = parse_capacity_str(param<std::string>("footprint").desc("Region of every stream of the stream, stride, random and zipf patterns.").default_val("1GB"));
+      Addr_t stride = param<Addr_t>("stride").desc("Bytes between the accesses of the stride pattern.").default_val(4096);
+      std::string hotset_str = param<std::string>("hotset").desc("Region at the start of the footprint that the zipf pattern accesses (the footprint by default).").default_val("");
+      double zipf_exponent = param<double>("zipf_exponent").desc("Exponent of the zipf pattern.").default_val(0.99);
+
+      Addr_t element_size = param<Addr_t>("gemm_element_size").desc("Bytes per matrix element of the gemm pattern.").default_val(2);
+      int64_t gemm_m = param<int64_t>("gemm_m").desc("Rows of A and C of the gemm pattern.").default_val(1024);
+      int64_t gemm_n = param<int64_t>("gemm_n").desc("Columns of B and C of the gemm pattern.").default_val(1024);
+      int64_t gemm_k = param<int64_t>("gemm_k").desc("Columns of A and rows of B of the gemm pattern.").default_val(1024);
+      int64_t gemm_tile = param<int64_t>("gemm_tile").desc("Square tile size of the gemm pattern, in elements.").default_val(64);
+
+      int64_t kv_layers = param<int64_t>("kv_layers").desc("Layers of the kv_cache pattern.").default_val(32);
+      int64_t kv_max_tokens = param<int64_t>("kv_max_tokens").desc("Context length at which the kv_cache pattern starts the next sequence.").default_val(4096);
+      int64_t kv_prompt_tokens = param<int64_t>("kv_prompt_tokens").desc("Context length at the start of a sequence of the kv_cache pattern.").default_val(512);
+      Addr_t kv_token_bytes = param<Addr_t>("kv_token_bytes").desc("Bytes of the key (and of the value) of one token in one layer.").default_val(1024);
+
+      if (num_streams <= 0) {
+        throw ConfigurationError("SyntheticTraffic needs at least one stream!");
+      }
+      if (m_rate <= 0.0) {
+        throw ConfigurationError("SyntheticTraffic rate must be positive!");
+      }
+      if (m_write_ratio < 0.0 || m_write_ratio > 1.0) {
+        throw ConfigurationError("SyntheticTraffic write_ratio must be in [0, 1]!");
+      }
+      if (access_size <= 0 || footprint < access_size) {
+        throw ConfigurationError("SyntheticTraffic footprint must hold at least one access of access_size bytes!");
+      }
+      Addr_t hotset = hotset_str.empty() ? footprint : parse_capacity_str(hotset_str);
+      if (hotset < access_size || hotset > footprint) {
+        throw ConfigurationError("SyntheticTraffic hotset must be at least access_size and at most the footprint!");
+      }
+      if (pattern == "stride" && stride <= 0) {
+        throw ConfigurationError("SyntheticTraffic stride must be positive!");
+      }
+      if (pattern == "gemm" && (gemm_tile <= 0 || gemm_m % gemm_tile != 0 || gemm_n % gemm_tile != 0 || gemm_k % gemm_tile != 0)) {
+        throw ConfigurationError("SyntheticTraffic gemm_m, gemm_n and gemm_k must be multiples of gemm_tile!");
+      }
+      if (pattern == "kv_cache" && (kv_layers <= 0 || kv_prompt_tokens <= 0 || kv_max_tokens <= kv_prompt_tokens)) {
+        throw ConfigurationError("SyntheticTraffic needs 0 < kv_prompt_tokens < kv_max_tokens and at least one layer!");
+      }
+
+      // Every stream accesses its own region, aligned to 4KB
+      Addr_t base = 0;
+      for (int i = 0; i < num_streams; i++) {
+        Stream& stream = m_streams.emplace_back();
+        if (pattern == "stream") {
+          stream.pattern = std::make_unique<StreamPattern>(footprint, access_size);
+        } else if (pattern == "stride") {
+          stream.pattern = std::make_unique<StridePattern>(footprint, access_size, stride);
+        } else if (pattern == "random") {
+          stream.pattern = std::make_unique<RandomPattern>(footprint, access_size);
+        } else if (pattern == "zipf") {
+          stream.pattern = std::make_unique<ZipfPattern>(footprint, access_size, hotset, zipf_exponent);
+        } else if (pattern == "gemm") {
+          stream.pattern = std::make_unique<GEMMPattern>(access_size, element_size, gemm_m, gemm_n, gemm_k, gemm_tile);
+        } else if (pattern == "kv_cache") {
+          stream.pattern = std::make_unique<KVCachePattern>(access_size, kv_layers, kv_max_tokens, kv_prompt_tokens, kv_token_bytes);
+        } else {
+          throw ConfigurationError("Unrecognized SyntheticTraffic pattern {}!", pattern);
+        }
+        stream.rng = random_stream(seed, i);
+        stream.base = base;
+        base += (stream.pattern->size() + 4095) / 4096 * 4096;
+      }
+
+      m_logger = Logging::create_logger("SyntheticTraffic");
+      m_logger->info("{} {} stream(s) over {} bytes.", num_streams, pattern, base);
+
+      register_stat(s_num_read_requests).name("num_read_requests");
+      register_stat(s_num_write_requests).name("num_write_requests");
+      register_stat(s_num_send_retries).name("num_send_retries");
+    };
+
+
+    void tick() override {
+      for (size_t i = 0; i < m_streams.size(); i++) {
+        Stream& stream = m_streams[i];
+        if (stream.num_sent == m_num_requests) {
+          continue;
+        }
+        stream.credits = std::min(stream.credits + m_rate, std::max(m_rate, 1.0));
+        while (stream.credits >= 1.0 && stream.num_sent < m_num_requests) {
+          if (!stream.has_pending) {
+            generate(stream);
+          }
+          if (!m_memory_system->send({stream.addr, stream.type, int(i), nullptr})) {
+            s_num_send_retries++;
+            break;
+          }
+          stream.has_pending = false;
+          stream.credits -= 1.0;
+          stream.num_sent++;
+          if (stream.type == Request::Type::Write) {
+            s_num_write_requests++;
+          } else {
+            s_num_read_requests++;
+          }
+        }
+      }
+    };
+
+    int get_num_cores() override { return m_streams.size(); };
+
+  private:
+    void generate(Stream& stream) {
+      SyntheticAccess access = stream.pattern->next(stream.rng);
+      stream.addr = stream.base + access.offset;
+      stream.type = access.type;
+      if (stream.type == -1) {
+        bool is_write = m_write_ratio > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(stream.rng) < m_write_ratio;
+        stream.type = is_write ? Request::Type::Write : Request::Type::Read;
+      }
+      stream.has_pending = true;
+    };
+
+    // Finished when every stream has sent its requests
+    bool is_finished() override {
+      for (const Stream& stream : m_streams) {
+        if (stream.num_sent < m_num_requests) {
+          return false;
+        }
+      }
+      return true;
+    };
+};
+
+}        // namespace Ramulator
@@ -0,0 +1,338 @@
+#ifndef     RAMULATOR_FRONTEND_SYNTHETIC_TRAFFIC_PATTERN_H
+#define     RAMULATOR_FRONTEND_SYNTHETIC_TRAFFIC_PATTERN_H
+
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <numeric>
+#include <cstdint>
+
+#include "base/type.h"
+#include "base/request.h"
+#include "base/random.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    One access of a synthetic traffic pattern.
+ *
+ */
+struct SyntheticAccess {
+  Addr_t offset;    // From the start of the region of the stream
+  int type;         // Request::Type::Read or Write, or -1 to draw it from the read/write mix
+};
+
+/**
+ * @brief    An address stream generated on the fly. Every stream of the SyntheticTraffic frontend has its own.
+ *
+ */
+class TrafficPattern {
+  public:
+    virtual ~TrafficPattern() = default;
+
+    /**
+     * @brief    The size of the region the pattern accesses, in bytes.
+     *
+     */
+    virtual Addr_t size() const = 0;
+
+    virtual SyntheticAccess next(RandomStream& rng) = 0;
+};
+
+
+/**
+ * @brief    Sequential lines, wrapping around at the end of the footprint.
+ *
+ */
+class StreamPattern : public TrafficPattern {
+  private:
+    Addr_t m_footprint;
+    Addr_t m_access_size;
+    Addr_t m_offset = 0;
+
+  public:
+    StreamPattern(Addr_t footprint, Addr_t access_size): m_footprint(footprint), m_access_size(access_size) {};
+
+    Addr_t size() const override { return m_footprint; };
+
+    SyntheticAccess next(RandomStream& rng) override {
+      Addr_t offset = m_offset;
+      m_offset += m_access_size;
+      if (m_offset >= m_footprint) {
+        m_offset = 0;
+      }
+      return {offset, -1};
+    };
+};
+
+
+/**
+ * @brief    Lines stride bytes apart. After a pass over the footprint, the next pass starts one line further.
+ *
+ */
+class StridePattern : public TrafficPattern {
+  private:
+    Addr_t m_footprint;
+    Addr_t m_access_size;
+    Addr_t m_stride;
+    Addr_t m_start = 0;
+    Addr_t m_offset = 0;
+
+  public:
+    StridePattern(Addr_t footprint, Addr_t access_size, Addr_t stride):
+    m_footprint(footprint), m_access_size(access_size), m_stride(stride) {};
+
+    Addr_t size() const override { return m_footprint; };
+
+    SyntheticAccess next(RandomStream& rng) override {
+      Addr_t offset = m_offset;
+      m_offset += m_stride;
+      if (m_offset >= m_footprint) {
+        m_start = (m_start + m_access_size) % std::min(m_stride, m_footprint);
+        m_offset = m_start;
+      }
+      return {offset, -1};
+    };
+};
+
+
+/**
+ * @brief    Uniformly random lines of the footprint.
+ *
+ */
+class RandomPattern : public TrafficPattern {
+  private:
+    Addr_t m_footprint;
+    Addr_t m_access_size;
+    std::uniform_int_distribution<Addr_t> m_line;
+
+  public:
+    RandomPattern(Addr_t footprint, Addr_t access_size):
+    m_footprint(footprint), m_access_size(access_size), m_line(0, footprint / access_size - 1) {};
+
+    Addr_t size() const override { return m_footprint; };
+
+    SyntheticAccess next(RandomStream& rng) override {
+      return {m_line(rng) * m_access_size, -1};
+    };
+};
+
+
+/**
+ * @brief    Zipf-distributed lines of a hotset at the start of the footprint
+ * @details
+ * Line ranks are drawn by rejection-inversion sampling (Hormann and Derflinger, 1996), which needs no table of the
+ * distribution, so a hotset of any size costs nothing to set up. The ranks are scattered over the hotset by a
+ * multiplicative permutation, so the hottest lines are not adjacent.
+ *
+ */
+class ZipfPattern : public TrafficPattern {
+  private:
+    Addr_t m_footprint;
+    Addr_t m_access_size;
+    uint64_t m_num_lines;
+    uint64_t m_scatter;     // Coprime to m_num_lines
+    double m_exponent;
+
+    double m_h_integral_x1;
+    double m_h_integral_n;
+    double m_s;
+
+  public:
+    ZipfPattern(Addr_t footprint, Addr_t access_size, Addr_t hotset, double exponent):
+    m_footprint(footprint), m_access_size(access_size), m_num_lines(hotset / access_size), m_exponent(exponent) {
+      m_scatter = 0x9E3779B97F4A7C15ull % m_num_lines;
+      while (std::gcd(m_scatter, m_num_lines) != 1) {
+        m_scatter++;
+      }
+      m_h_integral_x1 = h_integral(1.5) - 1.0;
+      m_h_integral_n = h_integral(m_num_lines + 0.5);
+      m_s = 2.0 - h_integral_inverse(h_integral(2.5) - h(2.0));
+    };
+
+    Addr_t size() const override { return m_footprint; };
+
+    SyntheticAccess next(RandomStream& rng) override {
+      uint64_t rank = sample(rng) - 1;
+      uint64_t line = (unsigned __int128) rank * m_scatter % m_num_lines;
+      return {Addr_t(line) * m_access_size, -1};
+    };
+
+  private:
+    uint64_t sample(RandomStream& rng) {
+      std::uniform_real_distribution<double> uniform(0.0, 1.0);
+      while (true) {
+        double u = m_h_integral_n + uniform(rng) * (m_h_integral_x1 - m_h_integral_n);
+        double x = h_integral_inverse(u);
+        double k = std::floor(x + 0.5);
+        k = std::clamp(k, 1.0, double(m_num_lines));
+        if (k - x <= m_s || u >= h_integral(k + 0.5) - h(k)) {
+          return uint64_t(k);
+        }
+      }
+    };
+
+    double h(double x) const { return std::exp(-m_exponent * std::log(x)); };
+
+    double h_integral(double x) const {
+      double log_x = std::log(x);
+      return expm1_over_x((1.0 - m_exponent) * log_x) * log_x;
+    };
+
+    double h_integral_inverse(double x) const {
+      double t = std::max(x * (1.0 - m_exponent), -1.0);
+      return std::exp(log1p_over_x(t) * x);
+    };
+
+    static double log1p_over_x(double x) {
+      return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+    };
+
+    static double expm1_over_x(double x) {
+      return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x / 3.0 * (1.0 + 0.25 * x));
+    };
+};
+
+
+/**
+ * @brief    The accesses of a tiled GEMM C = A * B of row-major matrices
+ * @details
+ * For every tile of C, the tiles of A and B along K are read row by row, then the tile of C is written.
+ *
+ */
+class GEMMPattern : public TrafficPattern {
+  private:
+    Addr_t m_access_size;
+    Addr_t m_element_size;
+    int64_t m_m, m_n, m_k, m_tile;
+    Addr_t m_a_base, m_b_base, m_c_base;
+
+    // The position in the loop nest
+    int64_t m_ti = 0, m_tj = 0, m_tk = 0;
+    int m_phase = 0;          // 0: read the tile of A, 1: read the tile of B, 2: write the tile of C
+    int64_t m_row = 0;
+    Addr_t m_row_offset = 0;
+
+  public:
+    GEMMPattern(Addr_t access_size, Addr_t element_size, int64_t m, int64_t n, int64_t k, int64_t tile):
+    m_access_size(access_size), m_element_size(element_size), m_m(m), m_n(n), m_k(k), m_tile(tile) {
+      m_a_base = 0;
+      m_b_base = m_a_base + m * k * element_size;
+      m_c_base = m_b_base + k * n * element_size;
+    };
+
+    Addr_t size() const override { return m_c_base + m_m * m_n * m_element_size; };
+
+    SyntheticAccess next(RandomStream& rng) override {
+      Addr_t offset;
+      int type = Request::Type::Read;
+      switch (m_phase) {
+        case 0:  offset = m_a_base + ((m_ti * m_tile + m_row) * m_k + m_tk * m_tile) * m_element_size; break;
+        case 1:  offset = m_b_base + ((m_tk * m_tile + m_row) * m_n + m_tj * m_tile) * m_element_size; break;
+        default: offset = m_c_base + ((m_ti * m_tile + m_row) * m_n + m_tj * m_tile) * m_element_size; type = Request::Type::Write; break;
+      }
+      offset += m_row_offset;
+      advance();
+      return {offset, type};
+    };
+
+  private:
+    void advance() {
+      m_row_offset += m_access_size;
+      if (m_row_offset < m_tile * m_element_size) {
+        return;
+      }
+      m_row_offset = 0;
+      if (++m_row < m_tile) {
+        return;
+      }
+      m_row = 0;
+      if (m_phase == 0) {
+        m_phase = 1;
+        return;
+      }
+      if (m_phase == 1) {
+        if (++m_tk < m_k / m_tile) {
+          m_phase = 0;
+          return;
+        }
+        m_tk = 0;
+        m_phase = 2;
+        return;
+      }
+      // The tile of C is done
+      m_phase = 0;
+      if (++m_tj < m_n / m_tile) {
+        return;
+      }
+      m_tj = 0;
+      if (++m_ti < m_m / m_tile) {
+        return;
+      }
+      m_ti = 0;
+    };
+};
+
+
+/**
+ * @brief    The accesses of autoregressive decoding with a KV cache
+ * @details
+ * Every decoding step reads, per layer, the keys and then the values of all the tokens of the context, and appends
+ * (writes) the key and value of the new token. The context starts at prompt_tokens and grows by one token per step;
+ * at max_tokens the next sequence starts.
+ *
+ */
+class KVCachePattern : public TrafficPattern {
+  private:
+    Addr_t m_access_size;
+    int64_t m_layers, m_max_tokens, m_prompt_tokens;
+    Addr_t m_token_bytes;
+
+    // The position in the step
+    int64_t m_tokens;
+    int64_t m_layer = 0;
+    int m_phase = 0;          // 0: read the keys, 1: read the values, 2: write the key, 3: write the value
+    Addr_t m_offset = 0;
+
+  public:
+    KVCachePattern(Addr_t access_size, int64_t layers, int64_t max_tokens, int64_t prompt_tokens, Addr_t token_bytes):
+    m_access_size(access_size), m_layers(layers), m_max_tokens(max_tokens), m_prompt_tokens(prompt_tokens),
+    m_token_bytes(token_bytes), m_tokens(prompt_tokens) {};
+
+    Addr_t size() const override { return m_layers * 2 * m_max_tokens * m_token_bytes; };
+
+    SyntheticAccess next(RandomStream& rng) override {
+      // The keys and the values of a layer are two contiguous regions
+      Addr_t base = (m_layer * 2 + (m_phase % 2)) * m_max_tokens * m_token_bytes;
+      Addr_t offset = m_phase < 2 ? base + m_offset : base + m_tokens * m_token_bytes + m_offset;
+      int type = m_phase < 2 ? Request::Type::Read : Request::Type::Write;
+      advance();
+      return {offset, type};
+    };
+
+  private:
+    void advance() {
+      m_offset += m_access_size;
+      Addr_t phase_bytes = m_phase < 2 ? m_tokens * m_token_bytes : m_token_bytes;
+      if (m_offset < phase_bytes) {
+        return;
+      }
+      m_offset = 0;
+      if (++m_phase < 4) {
+        return;
+      }
+      m_phase = 0;
+      if (++m_layer < m_layers) {
+        return;
+      }
+      m_layer = 0;
+      if (++m_tokens == m_max_tokens) {
+        m_tokens = m_prompt_tokens;
+      }
+    };
+};
+
+}        // namespace Ramulator
+
+
+#endif   // RAMULATOR_FRONTEND_SYNTHETIC_TRAFFIC_PATTERN_H
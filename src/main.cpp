@@ -1,4 +1,11 @@
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 #include <argparse/argparse.hpp>
 #include <spdlog/spdlog.h>
@@ -6,10 +13,323 @@
 
 #include "base/base.h"
 #include "base/config.h"
+#include "base/checkpoint.h"
+#include "base/memory_report.h"
+#include "base/distributed_sweep.h"
+#include "base/startup.h"
 #include "frontend/frontend.h"
 #include "memory_system/memory_system.h"
 #include "example/example_ifce.h"
 
+/**
+ * @brief    Simulates one configuration to completion, printing its final statistics to stats_out. With table_row, the
+ *           row of its stats table is returned there instead of appended to the table file.
+ *
+ */
+void run_simulation(const YAML::Node& config, std::ostream& stats_out, std::string* table_row = nullptr) {
+  Ramulator::Startup::PhaseTimer startup;
+  startup.phase("build");
+  // Instaniate the frontend of the simulated system, this is one of the top-level objects in Ramulator 2.0.
+  // It also recursively instaniate all components in the frontend.
+  // The frontend is built on a helper thread (from its own copy of the configuration) while this thread builds the
+  // memory system, which pins its channels to the tick threads of the caller.
+  Ramulator::IFrontEnd* frontend = nullptr;
+  std::exception_ptr frontend_error;
+  double frontend_ms = 0;
+  std::thread frontend_builder([&frontend, &frontend_error, &frontend_ms, frontend_config = YAML::Clone(config)] {
+    auto start = Ramulator::Startup::PhaseTimer::now();
+    try {
+      frontend = Ramulator::Factory::create_frontend(frontend_config);
+    } catch (...) {
+      frontend_error = std::current_exception();
+    }
+    frontend_ms = Ramulator::Startup::PhaseTimer::ms_since(start);
+  });
+  // Instaniate the memory system of the simulated system, this is one of the top-level objects in Ramulator 2.0
+  // It also recursively instaniate all components in the memory system.
+  Ramulator::IMemorySystem* memory_system = nullptr;
+  auto memory_system_start = Ramulator::Startup::PhaseTimer::now();
+  try {
+    memory_system = Ramulator::Factory::create_memory_system(config);
+  } catch (...) {
+    frontend_builder.join();
+    throw;
+  }
+  double memory_system_ms = Ramulator::Startup::PhaseTimer::ms_since(memory_system_start);
+  frontend_builder.join();
+  if (frontend_error) {
+    std::rethrow_exception(frontend_error);
+  }
+  startup.phase("setup");
+  startup.add("build_frontend", frontend_ms);
+  startup.add("build_memory_system", memory_system_ms);
+
+  // Optionally append the final statistics as a row of a JSON or binary table, instead of or next to the YAML
+  auto stats_table = Ramulator::StatsTable::from_config(config["StatsTable"]);
+  std::ostream no_stats_out(nullptr);
+  std::ostream& yaml_stats_out = (stats_table && !stats_table->emits_yaml()) ? no_stats_out : stats_out;
+  frontend->set_stats_output(yaml_stats_out);
+  memory_system->set_stats_output(yaml_stats_out);
+
+  // Connect the frontend and the memory system together,
+  // this recursively calls the "setup" function in all instaniated components
+  // so that they can get each other's parameters (if needed) after their initialization
+  frontend->connect_memory_system(memory_system);
+  memory_system->connect_frontend(frontend);
+
+  // Optionally start from (or save) a checkpoint of the warmed-up state
+  auto checkpoint = Ramulator::Checkpoint::Options::from_config(config["Checkpoint"]);
+  std::vector<Ramulator::Implementation*> roots = {frontend->m_impl, memory_system->m_impl};
+  if (!checkpoint.restore_path.empty()) {
+    startup.phase("restore");
+    Ramulator::Checkpoint::restore(checkpoint.restore_path, roots);
+  }
+
+  // Tick the frontend and the memory system in the repeating pattern of their relative clock ratio
+  Ramulator::ClockSchedule schedule({frontend->get_clock_ratio(), memory_system->get_clock_ratio()});
+
+  // Optionally stream snapshots of all statistics every epoch (in memory system cycles)
+  auto stats_stream = Ramulator::StatsStream::from_config(config["StatsStream"]);
+  if (stats_stream) {
+    frontend->m_impl->stream_stats_to(*stats_stream);
+    memory_system->m_impl->stream_stats_to(*stats_stream);
+  }
+  // Optionally stop once the target statistics have converged (in batches of memory system cycles)
+  auto convergence = Ramulator::ConvergenceMonitor::from_config(config["Convergence"]);
+  if (convergence) {
+    frontend->m_impl->stream_stats_to(*convergence);
+    memory_system->m_impl->stream_stats_to(*convergence);
+  }
+  if (stats_table) {
+    frontend->m_impl->stream_stats_to(*stats_table);
+    memory_system->m_impl->stream_stats_to(*stats_table);
+  }
+  // Optionally report the memory every component owns, at the end and every epoch
+  auto memory_report = Ramulator::MemoryReport::from_config(config["MemoryReport"]);
+  if (memory_report) {
+    frontend->m_impl->report_memory_to(*memory_report);
+    memory_system->m_impl->report_memory_to(*memory_report);
+  }
+  uint64_t mem_clk = 0;
+  uint64_t next_sample_clk = stats_stream ? stats_stream->get_epoch() : 0;
+  uint64_t next_memory_clk = memory_report ? memory_report->get_epoch() : 0;
+  uint64_t next_batch_clk = convergence ? convergence->get_batch() : 0;
+
+  startup.finish();
+  YAML::Node simulation_config = config["Simulation"];
+  spdlog::debug("Simulation {} started in {:.1f} ms ({}).", simulation_config ? simulation_config["name"].as<std::string>("") : "", startup.total_ms(), startup.summary());
+
+  schedule.run(
+    [&] {
+      RAMULATOR_PROFILE_CALL(frontend, tick());
+      // The frontend can only finish when it ticks
+      return frontend->is_finished();
+    },
+    [&] {
+      memory_system->tick();
+      mem_clk++;
+      if (mem_clk == next_sample_clk) {
+        stats_stream->sample(mem_clk);
+        next_sample_clk += stats_stream->get_epoch();
+      }
+      if (mem_clk == next_memory_clk) {
+        memory_report->sample(mem_clk);
+        next_memory_clk += memory_report->get_epoch();
+      }
+      if (mem_clk == next_batch_clk) {
+        next_batch_clk += convergence->get_batch();
+        if (convergence->end_batch(mem_clk)) {
+          return true;
+        }
+      }
+      // Stop at the checkpoint
+      return (int64_t) mem_clk == checkpoint.save_at_clk;
+    }
+  );
+
+  if (!checkpoint.save_path.empty()) {
+    Ramulator::Checkpoint::save(checkpoint.save_path, roots);
+  }
+
+  // Finalize the simulation. Recursively print all statistics from all components
+  frontend->finalize();
+  memory_system->finalize();
+
+  // The last record holds the final statistics
+  if (stats_stream) {
+    stats_stream->sample(mem_clk);
+  }
+
+  if (memory_report) {
+    memory_report->sample(mem_clk);
+    YAML::Emitter emitter;
+    memory_report->report(emitter);
+    stats_out << emitter.c_str() << std::endl;
+  }
+
+  // The estimates of the targets and how far they converged
+  if (convergence) {
+    YAML::Emitter emitter;
+    convergence->report(emitter);
+    stats_out << emitter.c_str() << std::endl;
+  }
+
+  // Optionally the time it took to build and set up the simulation
+  if (simulation_config && simulation_config["report_startup"].as<bool>(false)) {
+    YAML::Emitter emitter;
+    startup.report(emitter);
+    stats_out << emitter.c_str() << std::endl;
+  }
+
+  if (stats_table && table_row) {
+    *table_row = stats_table->row(config["Simulation"]["name"].as<std::string>(""), mem_clk);
+  } else if (stats_table) {
+    stats_table->append(config["Simulation"]["name"].as<std::string>(""), mem_clk);
+  }
+}
+
+/**
+ * @brief    Simulates point i of a sweep, the base configuration with the overrides params. With keep_table_row, the row
+ *           of its stats table is returned rather than appended to the table file.
+ *
+ */
+Ramulator::DistributedSweep::PointResult run_sweep_point(const YAML::Node& base_config, const std::vector<std::string>& params, size_t i, bool keep_table_row) {
+  Ramulator::DistributedSweep::PointResult result;
+  std::ostringstream stats;
+  try {
+    YAML::Node config = YAML::Clone(base_config);
+    Ramulator::Config::Details::override_configs(config, params);
+    // Tag the log messages of each configuration with its point
+    if (!config["Simulation"]["name"]) {
+      config["Simulation"]["name"] = fmt::format("sweep_{}", i);
+    }
+    // Label the row of each point in the stats table with its overrides
+    if (config["StatsTable"]) {
+      config["StatsTable"]["labels"] = params;
+    }
+    run_simulation(config, stats, keep_table_row ? &result.table_row : nullptr);
+  } catch (const std::exception& e) {
+    result.error = e.what();
+  }
+  result.stats = stats.str();
+  return result;
+}
+
+/**
+ * @brief    The YAML document of the result of sweep point i.
+ *
+ */
+std::string sweep_document(size_t i, const std::vector<std::string>& params, const Ramulator::DistributedSweep::PointResult& result) {
+  std::ostringstream document;
+  document << "---" << std::endl;
+  document << "sweep_point: " << i << std::endl;
+  document << "sweep_params:" << std::endl;
+  for (const auto& param : params) {
+    document << "  - \"" << param << "\"" << std::endl;
+  }
+  if (result.error.empty()) {
+    document << result.stats;
+  } else {
+    spdlog::error("Sweep point {} failed: {}", i, result.error);
+    document << "sweep_error: \"" << result.error << "\"" << std::endl;
+  }
+  return document.str();
+}
+
+/**
+ * @brief    Simulates all the configurations of a sweep on a pool of threads in this process, or on the workers of many
+ *           nodes (see DistributedSweep).
+ * @details
+ * The sweep file holds a "grid" that maps configuration keys (as in -p/--param) to their lists of values, and optionally
+ * the number of "threads" (defaults to the number of hardware threads) and the "output" file (defaults to stdout).
+ * Every point of the grid is the base configuration with one combination of the values. The final statistics of each
+ * point are written, in the order the points finish, as a YAML document that also records its overrides. The traces
+ * are parsed once and shared by all the points (see TraceCache).
+ *
+ * With a "distributed" section, this process is the coordinator of the sweep and only writes the results, and the
+ * processes started with worker_host (the coordinator's host) simulate the points on their threads.
+ *
+ */
+int run_sweep(const YAML::Node& base_config, const std::string& sweep_path, const std::string& worker_host) {
+  YAML::Node sweep = YAML::LoadFile(sweep_path);
+  std::vector<std::vector<std::string>> points = Ramulator::Config::expand_sweep_grid(sweep["grid"]);
+  auto distributed = Ramulator::DistributedSweep::Options::from_config(sweep["distributed"]);
+
+  size_t num_threads = sweep["threads"] ? sweep["threads"].as<size_t>() : std::thread::hardware_concurrency();
+  num_threads = std::clamp<size_t>(num_threads, 1, std::max<size_t>(points.size(), 1));
+
+  if (!worker_host.empty()) {
+    if (!distributed.enabled) {
+      spdlog::error("--sweep_worker needs a sweep file with a distributed section!");
+      return 1;
+    }
+    uint64_t fingerprint = Ramulator::DistributedSweep::fingerprint(base_config, points);
+    size_t num_failed = Ramulator::DistributedSweep::work(distributed, worker_host, num_threads, fingerprint, [&](size_t i) {
+      return run_sweep_point(base_config, points[i], i, true);
+    });
+    return num_failed == 0 ? 0 : 1;
+  }
+
+  // A resumed coordinator appends to the output that it already has
+  std::set<size_t> done;
+  bool resume = distributed.enabled && distributed.resume && sweep["output"];
+  if (resume) {
+    done = Ramulator::DistributedSweep::completed_points(sweep["output"].as<std::string>());
+  }
+
+  std::ofstream output_file;
+  std::ostream* output = &std::cout;
+  if (sweep["output"]) {
+    output_file.open(sweep["output"].as<std::string>(), resume ? std::ios::app : std::ios::trunc);
+    if (!output_file) {
+      spdlog::error("Cannot open sweep output file {}!", sweep["output"].as<std::string>());
+      return 1;
+    }
+    output = &output_file;
+  }
+
+  if (distributed.enabled) {
+    // The coordinator writes the rows of the workers to the stats table of the base configuration
+    auto stats_table = Ramulator::StatsTable::from_config(base_config["StatsTable"]);
+    uint64_t fingerprint = Ramulator::DistributedSweep::fingerprint(base_config, points);
+    size_t num_failed = Ramulator::DistributedSweep::coordinate(distributed, points.size(), done, fingerprint, [&](size_t i, const Ramulator::DistributedSweep::PointResult& result) {
+      if (stats_table && !result.table_row.empty()) {
+        Ramulator::StatsTable::append_row(stats_table->get_path(), result.table_row);
+      }
+      // The end marker tells a resumed coordinator that the document is complete
+      *output << sweep_document(i, points[i], result) << "..." << std::endl;
+      output->flush();
+    });
+    return num_failed == 0 ? 0 : 1;
+  }
+
+  spdlog::info("Sweeping {} configurations on {} threads.", points.size(), num_threads);
+
+  std::atomic<size_t> next_point = 0;
+  std::atomic<size_t> num_failed = 0;
+  std::mutex output_mutex;
+  auto worker = [&] {
+    for (size_t i = next_point++; i < points.size(); i = next_point++) {
+      auto result = run_sweep_point(base_config, points[i], i, false);
+      num_failed += !result.error.empty();
+
+      std::lock_guard<std::mutex> lock(output_mutex);
+      *output << sweep_document(i, points[i], result);
+      output->flush();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back(worker);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return num_failed == 0 ? 0 : 1;
+}
+
 int main(int argc, char* argv[]) {
   // Parse command line arguments
   argparse::ArgumentParser program("Ramulator", "2.0");
@@ -20,6 +340,12 @@ int main(int argc, char* argv[]) {
   program.add_argument("-p", "--param").metavar("KEY=VALUE")
     .append()
     .help("Specify parameter to override in the configuration file. Repeat this option to change multiple parameters.");
+  program.add_argument("-s", "--sweep").metavar("path-to-sweep-file")
+    .help("Path to a YAML sweep file. Simulates every configuration of its grid in parallel in this process.");
+  program.add_argument("--sweep_worker").metavar("coordinator-host")
+    .help("Simulates the points of the distributed sweep (-s) that the coordinator at this host hands out.");
+  program.add_argument("--emit_llc_miss_trace").metavar("path-to-trace")
+    .help("Records the requests the SimpleO3 LLC sends to the memory system to this LLCMiss trace, for the LLCMissTrace frontend.");
 
   try {
     program.parse_args(argc, argv);
@@ -78,42 +404,37 @@ int main(int argc, char* argv[]) {
     config = Ramulator::Config::parse_config_file(config_file_path, params);
   }
 
-  // Instaniate the frontend of the simulated system, this is one of the top-level objects in Ramulator 2.0.
-  // It also recursively instaniate all components in the frontend.
-  auto frontend = Ramulator::Factory::create_frontend(config);
-  // Instaniate the memory system of the simulated system, this is one of the top-level objects in Ramulator 2.0
-  // It also recursively instaniate all components in the memory system.
-  auto memory_system = Ramulator::Factory::create_memory_system(config);
-
-  // Connect the frontend and the memory system together,
-  // this recursively calls the "setup" function in all instaniated components
-  // so that they can get each other's parameters (if needed) after their initialization
-  frontend->connect_memory_system(memory_system);
-  memory_system->connect_frontend(frontend);
-
-  // Get the relative clock ratio between the frontend and memory system
-  int frontend_tick = frontend->get_clock_ratio();
-  int mem_tick = memory_system->get_clock_ratio();
-
-  int tick_mult = frontend_tick * mem_tick;
-
-  for (uint64_t i = 0;; i++) {
-    if (((i % tick_mult) % mem_tick) == 0) {
-      frontend->tick();
+  // Are we recording the LLC misses for DRAM-only replays?
+  if (auto arg = program.present<std::string>("--emit_llc_miss_trace")) {
+    if (!config["Frontend"] || config["Frontend"]["impl"].as<std::string>("") != "SimpleO3") {
+      spdlog::error("--emit_llc_miss_trace needs the SimpleO3 frontend!");
+      std::exit(1);
     }
+    config["Frontend"]["llc_miss_trace"] = *arg;
+  }
 
-    if (frontend->is_finished()) {
-      break;
+  // Which categories of debug traces to print (all by default, if they are compiled in)
+  if (config["Trace"]) {
+    if (!Ramulator::Debug::trace_compiled) {
+      spdlog::warn("Trace categories are given, but this build has no traces (build with -DRAMULATOR_TRACE=ON)!");
     }
+    Ramulator::Debug::set_trace_categories(config["Trace"].as<std::vector<std::string>>());
+  }
 
-    if ((i % tick_mult) % frontend_tick == 0) {
-      memory_system->tick();
+  // Are we running a sweep of configurations derived from this one?
+  if (auto arg = program.present<std::string>("-s")) {
+    try {
+      return run_sweep(config, *arg, program.present<std::string>("--sweep_worker").value_or(""));
+    } catch (const std::exception& e) {
+      spdlog::error(e.what());
+      return 1;
     }
+  } else if (program.present<std::string>("--sweep_worker")) {
+    spdlog::error("--sweep_worker needs the sweep file (-s)!");
+    std::exit(1);
   }
 
-  // Finalize the simulation. Recursively print all statistics from all components
-  frontend->finalize();
-  memory_system->finalize();
+  run_simulation(config, std::cout);
 
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <cmath>
+
+#include <argparse/argparse.hpp>
+#include <spdlog/spdlog.h>
+
+#include "base/base.h"
+#include "base/config.h"
+#include "base/exception.h"
+#include "dram/dram.h"
+#include "addr_mapper/addr_mapper.h"
+#include "frontend/frontend.h"
+#include "memory_system/memory_system.h"
+#include "frontend/impl/memory_trace/trace_accesses.h"
+
+// Replays the addresses of a trace through candidate address mappings of a simulator configuration and reports how
+// each spreads them over the banks and rows, without simulating the timing.
+
+namespace {
+
+using namespace Ramulator;
+namespace fs = std::filesystem;
+
+struct Access {
+  Addr_t addr;
+  bool is_write;
+};
+
+std::vector<Access> load_trace(const std::string& path, const std::string& kind) {
+  std::vector<Access> accesses;
+  TraceAccesses::for_each(path, kind, [&](Addr_t addr, bool is_write) { accesses.push_back({addr, is_write}); });
+  return accesses;
+}
+
+// A row of a bank
+using BankRow = std::pair<uint64_t, int64_t>;
+struct BankRowHash {
+  size_t operator()(const BankRow& bank_row) const {
+    return std::hash<uint64_t>()(bank_row.first * 0x9E3779B97F4A7C15ull ^ uint64_t(bank_row.second));
+  };
+};
+
+struct Report {
+  std::string mapping;
+  size_t num_banks = 0;
+  size_t num_banks_used = 0;
+  double max_to_mean = 0;           // Accesses of the busiest bank over the mean of all banks
+  double cv = 0;                    // Coefficient of variation of the accesses per bank
+  size_t num_rows_used = 0;
+  double row_hit_rate = 0;          // With one open row per bank, in trace order
+  size_t num_codewords = 0;
+  double codeword_split_rate = 0;   // Codewords whose lines do not all map to one row of one bank
+  double rows_per_codeword = 0;
+};
+
+// A mapping is a YAML file holding an AddrMapper node, or the name of an implementation without parameters
+YAML::Node load_mapping(const std::string& mapping) {
+  if (fs::exists(mapping)) {
+    return YAML::LoadFile(mapping);
+  }
+  YAML::Node node;
+  node["impl"] = mapping;
+  return node;
+}
+
+Report analyze(const YAML::Node& base_config, const std::string& mapping, const std::vector<Access>& accesses,
+               Addr_t codeword_bytes, Addr_t line_bytes) {
+  YAML::Node config = YAML::Clone(base_config);
+  if (!mapping.empty()) {
+    config["MemorySystem"]["AddrMapper"] = load_mapping(mapping);
+  }
+  auto frontend = Factory::create_frontend(config);
+  auto memory_system = Factory::create_memory_system(config);
+  frontend->connect_memory_system(memory_system);
+  memory_system->connect_frontend(frontend);
+
+  IDRAM* dram = memory_system->get_ifce<IDRAM>();
+  IAddrMapper* mapper = memory_system->get_ifce<IAddrMapper>();
+  const auto& count = dram->m_organization.count;
+  int row_level = dram->m_levels("row");
+
+  Report report;
+  report.mapping = mapping.empty() ? config["MemorySystem"]["AddrMapper"]["impl"].as<std::string>() : mapping;
+  report.num_banks = 1;
+  for (int level = 0; level < row_level; level++) {
+    report.num_banks *= count[level];
+  }
+
+  // The flat bank id and the row of an address
+  auto locate = [&](Addr_t addr) {
+    Request req(addr, Request::Type::Read);
+    mapper->apply(req);
+    uint64_t bank = 0;
+    for (int level = 0; level < row_level; level++) {
+      bank = bank * count[level] + std::max(req.addr_vec[level], 0);
+    }
+    return BankRow(bank, req.addr_vec[row_level]);
+  };
+
+  std::unordered_map<uint64_t, size_t> bank_accesses;
+  std::unordered_map<uint64_t, int64_t> open_rows;
+  std::unordered_set<uint64_t> codewords;
+  std::unordered_set<BankRow, BankRowHash> rows;
+  size_t num_row_hits = 0;
+  for (const Access& access : accesses) {
+    auto [bank, row] = locate(access.addr);
+    bank_accesses[bank]++;
+    rows.insert({bank, row});
+    auto open_row = open_rows.find(bank);
+    if (open_row != open_rows.end() && open_row->second == row) {
+      num_row_hits++;
+    }
+    open_rows[bank] = row;
+    codewords.insert(access.addr / codeword_bytes);
+  }
+
+  report.num_banks_used = bank_accesses.size();
+  report.num_rows_used = rows.size();
+  if (!accesses.empty()) {
+    double mean = double(accesses.size()) / report.num_banks;
+    double max_accesses = 0;
+    double sum_sq = 0;
+    for (const auto& [bank, num_accesses] : bank_accesses) {
+      max_accesses = std::max(max_accesses, double(num_accesses));
+      sum_sq += (num_accesses - mean) * (num_accesses - mean);
+    }
+    // The unused banks are at 0
+    sum_sq += (report.num_banks - bank_accesses.size()) * mean * mean;
+    report.max_to_mean = max_accesses / mean;
+    report.cv = std::sqrt(sum_sq / report.num_banks) / mean;
+    report.row_hit_rate = double(num_row_hits) / accesses.size();
+  }
+
+  size_t num_split = 0;
+  size_t num_codeword_rows = 0;
+  for (uint64_t codeword : codewords) {
+    std::unordered_set<BankRow, BankRowHash> codeword_rows;
+    for (Addr_t offset = 0; offset < codeword_bytes; offset += line_bytes) {
+      codeword_rows.insert(locate(codeword * codeword_bytes + offset));
+    }
+    num_split += codeword_rows.size() > 1;
+    num_codeword_rows += codeword_rows.size();
+  }
+  report.num_codewords = codewords.size();
+  if (!codewords.empty()) {
+    report.codeword_split_rate = double(num_split) / codewords.size();
+    report.rows_per_codeword = double(num_codeword_rows) / codewords.size();
+  }
+  return report;
+}
+
+}       // namespace
+
+
+int main(int argc, char* argv[]) {
+  argparse::ArgumentParser program("ramulator_mapping_analyze", "2.0");
+  program.add_argument("-f", "--config_file").required()
+    .help("Simulator configuration whose memory system the mappings are applied to.");
+  program.add_argument("-t", "--trace").required()
+    .help("Trace whose addresses are mapped (text or binary).");
+  program.add_argument("-k", "--kind").default_value(std::string("LoadStore"))
+    .help("Records of the trace: LoadStore (LD/ST), SimpleO3 or LLCMiss (binary).");
+  program.add_argument("-m", "--mappings").nargs(argparse::nargs_pattern::any).default_value(std::vector<std::string>{})
+    .help("Candidate mappings: YAML files holding an AddrMapper node, or mapper names (the configured one by default).");
+  program.add_argument("--codeword_bytes").scan<'i', int64_t>().default_value(int64_t(4096))
+    .help("Bytes of the ECC codewords that should stay within one row.");
+  program.add_argument("--line_bytes").scan<'i', int64_t>().default_value(int64_t(64))
+    .help("Bytes per memory access, when walking the lines of a codeword.");
+
+  YAML::Node config;
+  std::vector<std::string> mappings;
+  std::string trace_path, kind;
+  int64_t codeword_bytes, line_bytes;
+  try {
+    program.parse_args(argc, argv);
+    config = Config::parse_config_file(program.get<std::string>("--config_file"), {});
+    trace_path = program.get<std::string>("--trace");
+    kind = program.get<std::string>("--kind");
+    mappings = program.get<std::vector<std::string>>("--mappings");
+    codeword_bytes = program.get<int64_t>("--codeword_bytes");
+    line_bytes = program.get<int64_t>("--line_bytes");
+    if (codeword_bytes <= 0 || line_bytes <= 0) {
+      throw std::runtime_error("codeword_bytes and line_bytes must be positive!");
+    }
+  }
+  catch (const std::runtime_error& err) {
+    spdlog::error(err.what());
+    std::cerr << program;
+    std::exit(1);
+  }
+  if (mappings.empty()) {
+    mappings.push_back("");
+  }
+
+  try {
+    std::vector<Access> accesses = load_trace(trace_path, kind);
+    spdlog::info("Mapping {} accesses of {}.", accesses.size(), trace_path);
+
+    fmt::print("{:<24} {:>11} {:>9} {:>7} {:>10} {:>9} {:>10} {:>8} {:>10}\n",
+               "mapping", "banks_used", "max/mean", "cv", "rows_used", "row_hit", "codewords", "split", "rows/cw");
+    for (const std::string& mapping : mappings) {
+      Report r = analyze(config, mapping, accesses, codeword_bytes, line_bytes);
+      fmt::print("{:<24} {:>5}/{:<5} {:>9.2f} {:>7.3f} {:>10} {:>9.3f} {:>10} {:>8.3f} {:>10.2f}\n",
+                 r.mapping, r.num_banks_used, r.num_banks, r.max_to_mean, r.cv, r.num_rows_used, r.row_hit_rate,
+                 r.num_codewords, r.codeword_split_rate, r.rows_per_codeword);
+    }
+  }
+  catch (const std::runtime_error& err) {
+    spdlog::error(err.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <initializer_list>
+#include <queue>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "memory_system/memory_system.h"
+#include "addr_mapper/addr_mapper.h"
+#include "dram/dram.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    A queueing model of the DRAM system that computes the latency of every request when it is sent.
+ *
+ * @details
+ * The DRAM device and the address mapper are the same as in GenericDRAM, but the DRAM is never ticked. A request is
+ * mapped to its bank, which keeps the row of its last request open (an open-row policy), and gets the latency of a row
+ * hit (nCL + nBL), miss (+ nRCD) or conflict (+ nRP + nRCD). The channel adds the waiting time of an M/D/1 queue whose
+ * service time is one burst, at the data-bus utilization of the channel over the last window cycles, scaled by
+ * queueing_factor. Reads also add decoder_latency (e.g., of an ECC decoder). The read callback is called once the
+ * latency has passed, and every request is accepted. Writes have no callback, as in the Generic controller.
+ *
+ * queueing_factor and decoder_latency can be calibrated from the statistics of a short cycle-accurate GenericDRAM run
+ * of the same device and workload (calibration_path): per channel, the measured average read latency minus the
+ * modeled latency at the measured row hits, misses and conflicts is the queueing delay, and its ratio to the M/D/1
+ * waiting time at the measured data-bus utilization is the factor. The factors of the channels are averaged over
+ * their reads.
+ *
+ */
+class AnalyticalMemorySystem final : public IMemorySystem, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IMemorySystem, AnalyticalMemorySystem, "Analytical", "A calibrated queueing model of the DRAM system for fast design-space exploration.");
+
+  private:
+    static constexpr float MAX_UTILIZATION = 0.95f;   // Keeps the M/D/1 waiting time finite
+
+    Clk_t m_clk = 0;
+    IDRAM* m_dram = nullptr;
+    IAddrMapper* m_addr_mapper = nullptr;
+
+    Clk_t m_hit_latency = 0;
+    Clk_t m_miss_latency = 0;
+    Clk_t m_conflict_latency = 0;
+    Clk_t m_burst_cycles = 0;
+    Clk_t m_window = 0;
+    float m_queueing_factor = 1.0f;
+    Clk_t m_decoder_latency = 0;
+
+    struct Channel {
+      std::vector<int> open_rows;           // Per flat bank, -1 if closed
+      size_t window_bursts = 0;             // Bursts in the running window
+      float utilization = 0;                // Data-bus utilization of the last window
+    };
+    std::vector<Channel> m_channels;
+    int m_row_level = -1;
+
+    struct Completion {
+      Clk_t depart;
+      uint64_t seq;                         // Send order, breaks ties between equal departs
+      Request req;
+      bool operator>(const Completion& other) const { return std::tie(depart, seq) > std::tie(other.depart, other.seq); };
+    };
+    std::priority_queue<Completion, std::vector<Completion>, std::greater<Completion>> m_completions;
+    uint64_t m_seq = 0;
+
+    size_t s_num_read_requests = 0;
+    size_t s_num_write_requests = 0;
+    size_t s_num_other_requests = 0;
+    size_t s_row_hits = 0;
+    size_t s_row_misses = 0;
+    size_t s_row_conflicts = 0;
+    size_t s_read_latency = 0;
+    size_t s_queueing_latency = 0;
+    float s_avg_read_latency = 0;
+    float s_avg_queueing_latency = 0;
+
+  public:
+    void init() override {
+      m_dram = create_child_ifce<IDRAM>();
+      m_addr_mapper = create_child_ifce<IAddrMapper>();
+
+      m_clock_ratio = param<uint>("clock_ratio").required();
+      m_window = param<Clk_t>("utilization_window").desc("Cycles over which the data-bus utilization of a channel is measured.").default_val(1000);
+      m_queueing_factor = param<float>("queueing_factor").desc("Scale of the M/D/1 waiting time (overridden by the calibration).").default_val(1.0f);
+      m_decoder_latency = param<Clk_t>("decoder_latency").desc("Cycles added to every read (overridden by the calibration).").default_val(0);
+      std::string calibration_path = param<std::string>("calibration_path").desc("Statistics of a GenericDRAM run to calibrate the model with.").default_val("");
+      if (m_window <= 0 || m_queueing_factor < 0 || m_decoder_latency < 0) {
+        throw ConfigurationError("Analytical: utilization_window must be positive, queueing_factor and decoder_latency not negative!");
+      }
+
+      m_burst_cycles = m_dram->m_read_latency - m_dram->m_timing_vals("nCL");
+      m_hit_latency = m_dram->m_read_latency;
+      m_miss_latency = m_hit_latency + timing({"nRCD", "nRCDRD"});
+      m_conflict_latency = m_miss_latency + timing({"nRP", "nRPab"});
+      m_row_level = m_dram->m_levels("row");
+
+      m_channels.resize(m_dram->get_level_size("channel"));
+      for (Channel& channel : m_channels) {
+        channel.open_rows.assign(m_dram->m_num_flat_banks, -1);
+      }
+
+      if (!calibration_path.empty()) {
+        calibrate(calibration_path);
+      }
+
+      register_stat(m_clk).name("memory_system_cycles");
+      register_stat(s_num_read_requests).name("total_num_read_requests");
+      register_stat(s_num_write_requests).name("total_num_write_requests");
+      register_stat(s_num_other_requests).name("total_num_other_requests");
+      register_stat(s_row_hits).name("row_hits");
+      register_stat(s_row_misses).name("row_misses");
+      register_stat(s_row_conflicts).name("row_conflicts");
+      register_stat(s_read_latency).name("read_latency");
+      register_stat(s_avg_read_latency).name("avg_read_latency");
+      register_stat(s_avg_queueing_latency).name("avg_queueing_latency");
+      register_stat(m_queueing_factor).name("queueing_factor");
+      register_stat(m_decoder_latency).name("decoder_latency");
+    };
+
+    void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override { };
+
+    bool send(Request req) override {
+      m_addr_mapper->apply(req);
+      Channel& channel = m_channels[req.addr_vec[0]];
+
+      int bank_id = m_dram->flat_bank_id(req.addr_vec);
+      int row = req.addr_vec[m_row_level];
+      Clk_t latency;
+      if (channel.open_rows[bank_id] == row) {
+        latency = m_hit_latency;
+        s_row_hits++;
+      } else if (channel.open_rows[bank_id] == -1) {
+        latency = m_miss_latency;
+        s_row_misses++;
+      } else {
+        latency = m_conflict_latency;
+        s_row_conflicts++;
+      }
+      channel.open_rows[bank_id] = row;
+      channel.window_bursts++;
+
+      Clk_t queueing = waiting_time(channel.utilization);
+      latency += queueing;
+
+      switch (req.type_id) {
+        case Request::Type::Read: {
+          s_num_read_requests++;
+          latency += m_decoder_latency;
+          s_read_latency += latency;
+          s_queueing_latency += queueing;
+          req.arrive = m_clk;
+          req.depart = m_clk + latency;
+          if (req.callback) {
+            m_completions.push({req.depart, m_seq++, req});
+          }
+          break;
+        }
+        case Request::Type::Write: {
+          s_num_write_requests++;
+          break;
+        }
+        default: {
+          s_num_other_requests++;
+          break;
+        }
+      }
+      return true;
+    };
+
+    void tick() override {
+      m_clk++;
+      if (m_clk % m_window == 0) {
+        for (Channel& channel : m_channels) {
+          channel.utilization = std::min<float>((float) (channel.window_bursts * m_burst_cycles) / (float) m_window, MAX_UTILIZATION);
+          channel.window_bursts = 0;
+        }
+      }
+      while (!m_completions.empty() && m_completions.top().depart <= m_clk) {
+        Request req = m_completions.top().req;
+        m_completions.pop();
+        req.callback(req);
+      }
+    };
+
+    void finalize() override {
+      s_avg_read_latency = s_num_read_requests ? (float) s_read_latency / (float) s_num_read_requests : 0.0f;
+      s_avg_queueing_latency = s_num_read_requests ? (float) s_queueing_latency / (float) s_num_read_requests : 0.0f;
+      IMemorySystem::finalize();
+    };
+
+    float get_tCK() override {
+      return m_dram->m_timing_vals("tCK_ps") / 1000.0f;
+    };
+
+  private:
+    /// The value of the first of the timing names the device has
+    Clk_t timing(std::initializer_list<std::string_view> names) {
+      for (std::string_view name : names) {
+        if (m_dram->m_timings.contains(name)) {
+          return m_dram->m_timing_vals(name);
+        }
+      }
+      throw ConfigurationError("Analytical: The DRAM has none of the timings {}!", fmt::join(names, ", "));
+    };
+
+    /// Waiting time of an M/D/1 queue with a service time of one burst
+    Clk_t waiting_time(float utilization) const {
+      float utilization_clamped = std::min(utilization, MAX_UTILIZATION);
+      return (Clk_t) (m_queueing_factor * utilization_clamped / (2.0f * (1.0f - utilization_clamped)) * m_burst_cycles);
+    };
+
+    /**
+     * @brief    Fits queueing_factor and decoder_latency to the per-channel statistics of a GenericDRAM run.
+     *
+     */
+    void calibrate(const std::string& path) {
+      // The frontend and the memory system print their statistics as separate documents
+      YAML::Node stats;
+      for (const YAML::Node& document : YAML::LoadAllFromFile(path)) {
+        stats.push_back(document);
+      }
+      double factor_sum = 0;
+      double decoder_sum = 0;
+      double num_reads = 0;
+      for (size_t channel_id = 0; channel_id < m_channels.size(); channel_id++) {
+        double latency, hits, misses, conflicts, utilization;
+        if (!find_stat(stats, fmt::format("avg_read_latency_{}", channel_id), latency) ||
+            !find_stat(stats, fmt::format("read_row_hits_{}", channel_id), hits) ||
+            !find_stat(stats, fmt::format("read_row_misses_{}", channel_id), misses) ||
+            !find_stat(stats, fmt::format("read_row_conflicts_{}", channel_id), conflicts) ||
+            !find_stat(stats, fmt::format("data_bus_utilization_{}", channel_id), utilization)) {
+          continue;
+        }
+        double reads = hits + misses + conflicts;
+        if (reads == 0) {
+          continue;
+        }
+        double decoder = 0;
+        find_stat(stats, fmt::format("avg_decoder_latency_{}", channel_id), decoder);
+
+        double row_latency = (hits * m_hit_latency + misses * m_miss_latency + conflicts * m_conflict_latency) / reads;
+        double queueing = std::max(latency - row_latency - decoder, 0.0);
+        double utilization_clamped = std::min<double>(utilization, MAX_UTILIZATION);
+        double md1 = utilization_clamped / (2.0 * (1.0 - utilization_clamped)) * m_burst_cycles;
+        factor_sum += reads * (md1 > 0 ? queueing / md1 : 1.0);
+        decoder_sum += reads * decoder;
+        num_reads += reads;
+      }
+      if (num_reads == 0) {
+        throw ConfigurationError("Analytical: {} has no read statistics of a GenericDRAM run to calibrate with!", path);
+      }
+      m_queueing_factor = (float) (factor_sum / num_reads);
+      m_decoder_latency = (Clk_t) (decoder_sum / num_reads + 0.5);
+    };
+
+    /// Searches the nested maps of the statistics for the first stat called name
+    static bool find_stat(const YAML::Node& node, const std::string& name, double& value) {
+      if (node.IsSequence()) {
+        for (const YAML::Node& child : node) {
+          if (find_stat(child, name, value)) {
+            return true;
+          }
+        }
+        return false;
+      }
+      if (!node.IsMap()) {
+        return false;
+      }
+      if (node[name] && node[name].IsScalar()) {
+        value = node[name].as<double>();
+        return true;
+      }
+      for (auto it = node.begin(); it != node.end(); ++it) {
+        if (find_stat(it->second, name, value)) {
+          return true;
+        }
+      }
+      return false;
+    };
+};
+
+}   // namespace Ramulator
@@ -75,7 +75,7 @@ class BHDRAMSystem final : public IBHMemorySystem, public Implementation {
       m_clk++;
       m_dram->tick();
       for (auto controller : m_controllers) {
-        controller->tick();
+        RAMULATOR_PROFILE_CALL(controller, tick());
       }
     };
 
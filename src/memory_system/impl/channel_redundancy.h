@@ -0,0 +1,270 @@
+#ifndef RAMULATOR_MEMORYSYSTEM_CHANNEL_REDUNDANCY_H
+#define RAMULATOR_MEMORYSYSTEM_CHANNEL_REDUNDANCY_H
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "base/type.h"
+#include "base/request.h"
+#include "base/exception.h"
+#include "dram_controller/impl/plugin/ecc/ecc.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    Redundancy across the channels of a memory system (RAID / chipkill style): the lines of a channel are
+ *           protected by parity or mirror copies in the other channels of its stripe.
+ *
+ * @details
+ * The channels are grouped into stripes of stripe_channels consecutive channels, and a line has a sibling at the same
+ * address vector in every other channel of its stripe. With "xor" (one parity channel) or "rs" (parity_channels
+ * Reed-Solomon parity channels), the parity of a row rotates over the channels of the stripe (RAID-5/6). A write
+ * reads the old parity and writes the new one once it returned. The data delta is taken from the controller (e.g., the
+ * read-modify-write of the ECC codeword), so the old data is not read again. With "mirror", every write is duplicated to
+ * all the siblings.
+ *
+ * When the ECC of a channel cannot correct a demand read (see IECCPlugin::set_uncorrectable_handler()), the read is
+ * held once its data arrived and rebuilt from its siblings: stripe_channels - parity_channels reads for "xor" and
+ * "rs" (any data symbols of the erasure code), one read for "mirror". It completes when the last of them returns.
+ *
+ * The requests of the redundancy are sent to the controllers of their channels like demand requests, and wait in a
+ * per-channel queue while their controller is full. They carry the address of the line they protect and are tagged
+ * with IECCPlugin::REDUNDANCY_TAG. The parity lines are not reserved: they alias lines of their channel, so only their
+ * traffic is modeled, and the rebuilt data is not computed.
+ *
+ * The channels only append to their own lists (held reads, completed requests), and the memory system processes
+ * them with tick() once no channel is ticking, so the channels can tick in parallel.
+ *
+ */
+class ChannelRedundancy {
+  public:
+    using SendFunc = std::function<bool(int channel_id, Request& req)>;
+
+  private:
+    enum class Mode { None, XOR, RS, Mirror };
+    Mode m_mode = Mode::None;
+    int m_stripe_channels = 1;
+    int m_parity_channels = 0;
+    int m_row_level = -1;
+    int m_RD_req_id = -1;
+    int m_WR_req_id = -1;
+    SendFunc m_send;
+    Clk_t m_clk = 0;
+
+    /// A rebuild or a parity update, waiting for its reads
+    struct Job {
+      Request demand{(Addr_t) -1, -1};    // The held demand read of a rebuild
+      bool is_rebuild = false;
+      Clk_t start = 0;
+      int outstanding = 0;                // Reads not returned yet
+      std::vector<Request> writes;        // Parity writes of an update, sent once its reads returned
+    };
+    std::vector<Job> m_jobs;              // Indexed by slot
+    std::vector<int> m_free_jobs;
+
+    std::vector<std::vector<Request>> m_held;     // Per channel, its uncorrectable reads since the last tick()
+    std::vector<std::vector<int>> m_returned;     // Per channel, the jobs of its redundancy reads that returned
+    std::vector<std::deque<Request>> m_outbox;    // Per channel, requests its controller did not accept yet
+
+  public:
+    size_t s_rebuilds = 0;                // Uncorrectable reads rebuilt from their siblings
+    size_t s_rebuild_reads = 0;
+    size_t s_rebuild_latency = 0;         // Cycles from the data of the held reads to their rebuild
+    float s_avg_rebuild_latency = 0;
+    size_t s_parity_reads = 0;            // Old parity reads of the parity updates
+    size_t s_parity_writes = 0;
+    size_t s_mirror_writes = 0;
+    size_t s_send_retry_cycles = 0;       // Cycles a channel had redundancy requests its controller rejected
+
+  public:
+    /**
+     * @brief    Sets the mode ("none", "xor", "rs" or "mirror"). Returns whether the redundancy is enabled.
+     *
+     */
+    bool configure(const std::string& mode, int stripe_channels, int parity_channels, int num_channels) {
+      if (mode == "none") {
+        return false;
+      } else if (mode == "xor") {
+        m_mode = Mode::XOR;
+        parity_channels = 1;
+      } else if (mode == "rs") {
+        m_mode = Mode::RS;
+      } else if (mode == "mirror") {
+        m_mode = Mode::Mirror;
+        parity_channels = stripe_channels - 1;
+      } else {
+        throw ConfigurationError("Unrecognized redundancy mode {} (none, xor, rs or mirror)!", mode);
+      }
+      if (stripe_channels < 2 || num_channels % stripe_channels != 0) {
+        throw ConfigurationError("The redundancy stripes need at least 2 channels and must divide the {} channels (got {})!", num_channels, stripe_channels);
+      }
+      if (parity_channels < 1 || parity_channels >= stripe_channels) {
+        throw ConfigurationError("A redundancy stripe of {} channels needs between 1 and {} parity channels (got {})!", stripe_channels, stripe_channels - 1, parity_channels);
+      }
+      m_stripe_channels = stripe_channels;
+      m_parity_channels = parity_channels;
+      m_held.resize(num_channels);
+      m_returned.resize(num_channels);
+      m_outbox.resize(num_channels);
+      return true;
+    };
+
+    /**
+     * @brief    Connects the redundancy to the device and to the function that sends a request to the controller of a
+     *           channel.
+     *
+     */
+    void setup(int row_level, int RD_req_id, int WR_req_id, SendFunc send) {
+      m_row_level = row_level;
+      m_RD_req_id = RD_req_id;
+      m_WR_req_id = WR_req_id;
+      m_send = std::move(send);
+    };
+
+    bool is_enabled() const { return m_mode != Mode::None; };
+
+    /// Called by a channel with a demand read whose codeword its ECC could not correct, once its data arrived
+    void hold(Request& req) {
+      m_held[req.addr_vec[0]].push_back(req);
+    };
+
+    /**
+     * @brief    Issues the parity update or the mirror copies of a demand write accepted by the controller of its
+     *           channel.
+     *
+     */
+    void on_write(const Request& req) {
+      if (m_mode == Mode::Mirror) {
+        for (int sibling : siblings(req.addr_vec, m_parity_channels)) {
+          enqueue(make_request(req, sibling, m_WR_req_id, -1));
+          s_mirror_writes++;
+        }
+        return;
+      }
+
+      int slot = new_job();
+      Job& job = m_jobs[slot];
+      job.start = m_clk;
+      for (int parity : siblings(req.addr_vec, m_parity_channels)) {
+        enqueue(make_request(req, parity, m_RD_req_id, slot));
+        job.writes.push_back(make_request(req, parity, m_WR_req_id, -1));
+      }
+      job.outstanding = m_parity_channels;
+      s_parity_reads += m_parity_channels;
+    };
+
+    /**
+     * @brief    Starts the rebuilds of the reads held since the last call, completes those whose reads all returned,
+     *           and sends the queued requests. Call every cycle, while no channel is ticking.
+     *
+     */
+    void tick() {
+      m_clk++;
+      for (std::vector<Request>& held : m_held) {
+        for (Request& req : held) {
+          start_rebuild(req);
+        }
+        held.clear();
+      }
+      for (std::vector<int>& returned : m_returned) {
+        for (int slot : returned) {
+          if (--m_jobs[slot].outstanding == 0) {
+            finish_job(slot);
+          }
+        }
+        returned.clear();
+      }
+      for (size_t channel_id = 0; channel_id < m_outbox.size(); channel_id++) {
+        std::deque<Request>& outbox = m_outbox[channel_id];
+        while (!outbox.empty() && m_send(channel_id, outbox.front())) {
+          outbox.pop_front();
+        }
+        s_send_retry_cycles += !outbox.empty();
+      }
+    };
+
+    void finalize() {
+      s_avg_rebuild_latency = s_rebuilds ? float(s_rebuild_latency) / float(s_rebuilds) : 0.0f;
+    };
+
+  private:
+    void start_rebuild(Request& req) {
+      int slot = new_job();
+      Job& job = m_jobs[slot];
+      job.demand = req;
+      job.is_rebuild = true;
+      job.start = m_clk;
+      int num_reads = m_mode == Mode::Mirror ? 1 : m_stripe_channels - m_parity_channels;
+      for (int sibling : siblings(req.addr_vec, num_reads)) {
+        enqueue(make_request(req, sibling, m_RD_req_id, slot));
+      }
+      job.outstanding = num_reads;
+      s_rebuild_reads += num_reads;
+    };
+
+    void finish_job(int slot) {
+      Job& job = m_jobs[slot];
+      if (job.is_rebuild) {
+        s_rebuilds++;
+        s_rebuild_latency += m_clk - job.start;
+        job.demand.depart = job.demand.depart + (m_clk - job.start);
+        if (job.demand.callback) {
+          job.demand.callback(job.demand);
+        }
+      } else {
+        for (const Request& write : job.writes) {
+          enqueue(write);
+          s_parity_writes++;
+        }
+      }
+      job = Job();
+      m_free_jobs.push_back(slot);
+    };
+
+    /// The first count other channels of the stripe of addr_vec, starting from the parity of its row
+    std::vector<int> siblings(const AddrVec_t& addr_vec, int count) const {
+      int channel_id = addr_vec[0];
+      int first = channel_id - channel_id % m_stripe_channels;
+      int rotation = addr_vec[m_row_level] < 0 ? 0 : addr_vec[m_row_level] % m_stripe_channels;
+      std::vector<int> channels;
+      for (int i = 0; i < m_stripe_channels && (int) channels.size() < count; i++) {
+        int sibling = first + (rotation + i) % m_stripe_channels;
+        if (sibling != channel_id) {
+          channels.push_back(sibling);
+        }
+      }
+      return channels;
+    };
+
+    /// A request of the redundancy to the sibling of req in channel_id. A read returns to the job in slot
+    Request make_request(const Request& req, int channel_id, int type_id, int slot) {
+      Request sibling(req.addr_vec, type_id);
+      sibling.addr = req.addr;
+      sibling.addr_vec[0] = channel_id;
+      sibling.scratchpad[IECCPlugin::REDUNDANCY_TAG_IDX] = IECCPlugin::REDUNDANCY_TAG;
+      if (slot != -1) {
+        sibling.callback = [this, slot](Request& req) { m_returned[req.addr_vec[0]].push_back(slot); };
+      }
+      return sibling;
+    };
+
+    void enqueue(const Request& req) {
+      m_outbox[req.addr_vec[0]].push_back(req);
+    };
+
+    int new_job() {
+      if (m_free_jobs.empty()) {
+        m_jobs.emplace_back();
+        return m_jobs.size() - 1;
+      }
+      int slot = m_free_jobs.back();
+      m_free_jobs.pop_back();
+      return slot;
+    };
+};
+
+}        // namespace Ramulator
+
+#endif   // RAMULATOR_MEMORYSYSTEM_CHANNEL_REDUNDANCY_H
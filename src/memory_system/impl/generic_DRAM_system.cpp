@@ -1,6 +1,15 @@
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <span>
+
 #include "memory_system/memory_system.h"
+#include "base/tick_pool.h"
+#include "base/numa.h"
 #include "translation/translation.h"
 #include "dram_controller/controller.h"
+#include "dram_controller/impl/plugin/ecc/ecc.h"
+#include "memory_system/impl/channel_redundancy.h"
 #include "addr_mapper/addr_mapper.h"
 #include "dram/dram.h"
 
@@ -15,10 +24,92 @@ class GenericDRAMSystem final : public IMemorySystem, public Implementation {
     IAddrMapper*  m_addr_mapper;
     std::vector<IDRAMController*> m_controllers;
 
+    bool m_event_driven = false;
+    std::vector<Clk_t> m_idle_cycles;       // Ticks each controller reported it can go without
+    std::vector<Clk_t> m_skipped_cycles;    // Ticks each controller has skipped and not caught up on yet
+
+    /**
+     * @brief    What one channel exchanges with the frontend while the channels tick in parallel or in quanta.
+     *
+     */
+    struct ChannelExchange {
+      struct Completion {
+        int slot;
+        Clk_t clk;                                        // Cycle of the channel at which the request completed
+        Request req;
+      };
+      std::vector<RequestCallback> callbacks;             // Original callbacks, indexed by slot
+      std::vector<int> free_slots;
+      std::vector<Completion> completed;                  // Completed since the last delivery, in order
+
+      std::vector<std::pair<Clk_t, Request>> inbox;       // (send cycle, request) sent during the running quantum
+      size_t num_inbox_head = 0;                          // Requests of the inbox the controller already accepted
+      Clk_t clk = 0;                                      // Cycle the channel has advanced to in quantum mode
+      size_t num_retry_cycles = 0;
+    };
+    int m_num_threads = 1;
+    Clk_t m_quantum = 1;
+    Clk_t m_quantum_start = 0;                             // Cycle at which the running quantum started
+    std::unique_ptr<TickPool> m_tick_pool;           // Only set when channels are ticked in parallel
+    std::vector<std::unique_ptr<ChannelExchange>> m_exchanges;     // Only set when channels tick in parallel or in quanta
+
+    /**
+     * @brief    Requests accepted for a channel that its controller has not admitted yet.
+     *
+     */
+    struct IngressQueue {
+      std::deque<Request> requests;
+      size_t s_num_rejections = 0;          // Sends rejected because the queue was full
+      size_t s_num_backpressure_cycles = 0; // Cycles the controller refused the request at the head
+      size_t s_max_occupancy = 0;
+    };
+    size_t m_ingress_size = 0;              // 0 = no ingress queues, requests go straight to the controllers
+    int m_admissions_per_cycle = -1;
+    std::vector<IngressQueue> m_ingress;
+
+    /**
+     * @brief    The ECC statistics of all channels, and of each channel, if the controllers have an ECCPlugin, and the data
+     *           goodput with the link error losses of the device.
+     *
+     */
+    struct ECCTotals {
+      std::vector<IECCPlugin*> plugins;       // Indexed by channel, nullptr for channels without ECC
+      IECCPlugin::Totals total;
+      std::vector<size_t> edc_failures;       // Per channel
+      std::vector<size_t> ecc_corrections;
+      std::vector<size_t> ecc_failures;
+      std::vector<size_t> parity_traffic_bytes;
+      float failures_per_gb = 0;              // ECC failures per GB of demand reads
+      float parity_bytes_per_request = 0;     // Parity DRAM traffic per demand request
+      size_t link_lost_bytes = 0;             // Data the link ECC and replays of the device kept off the data buses
+      float data_goodput = 0;                 // Demand data over all the data moved, parity and link replays included
+    };
+    ECCTotals m_ecc;
+
+    ChannelRedundancy m_redundancy;         // Parity or mirror copies of the lines across the channels
+
+    /**
+     * @brief    Where a thread of the tick pool ran at the end of the simulation, and how much of the device nodes of its
+     *           channels (which it built) is on its NUMA node. -1 where the OS cannot tell.
+     *
+     */
+    struct ThreadLocality {
+      int cpu = -1;
+      int numa_node = -1;
+      int num_channels = 0;
+      float local_memory_ratio = -1;
+    };
+    std::vector<ThreadLocality> m_thread_locality;        // Only set when channels are ticked in parallel
+    std::vector<std::span<const std::byte>> m_channel_memory;   // The device nodes of each channel, built by its thread
+
   public:
-    int s_num_read_requests = 0;
-    int s_num_write_requests = 0;
-    int s_num_other_requests = 0;
+    size_t s_num_read_requests = 0;
+    size_t s_num_write_requests = 0;
+    size_t s_num_other_requests = 0;
+
+    size_t s_num_quantum_retry_cycles = 0;
+    size_t s_total_callback_delay = 0;
+    size_t s_max_callback_delay = 0;
 
 
   public:
@@ -29,30 +120,153 @@ class GenericDRAMSystem final : public IMemorySystem, public Implementation {
 
       int num_channels = m_dram->get_level_size("channel");   
 
+      m_clock_ratio = param<uint>("clock_ratio").required();
+      m_event_driven = param<bool>("event_driven").desc("Skip the ticks of idle controllers and catch up on them when they get a request (statistics stay exact).").default_val(false);
+      m_idle_cycles.resize(num_channels, 0);
+      m_skipped_cycles.resize(num_channels, 0);
+
+      m_num_threads = param<int>("num_threads").desc("Number of threads that tick the channels in parallel (1 = tick them sequentially).").default_val(1);
+      if (m_num_threads < 1) {
+        throw ConfigurationError("GenericDRAM: num_threads must be at least 1 (got {})!", m_num_threads);
+      }
+      m_quantum = param<Clk_t>("sync_quantum").desc("Cycles the channels advance independently between exchanges with the frontend (1 = lock-step).").default_val(1);
+      if (m_quantum < 1) {
+        throw ConfigurationError("GenericDRAM: sync_quantum must be at least 1 (got {})!", m_quantum);
+      }
+      std::vector<int> thread_cpus = param<std::vector<int>>("thread_cpus").desc("The CPU each channel thread is pinned to, thread 0 (the simulation thread) first (empty = not pinned).").default_val(std::vector<int>());
+
+      // The threads exist before the channels, so that each channel is built by (and its memory local to) its thread
+      bool is_parallel = m_num_threads > 1 && num_channels > 1;
+      if (is_parallel && m_quantum > 1) {
+        m_tick_pool = std::make_unique<TickPool>(m_num_threads, num_channels, [this](int channel_id) { run_quantum(channel_id); }, thread_cpus);
+      } else if (is_parallel) {
+        m_tick_pool = std::make_unique<TickPool>(m_num_threads, num_channels, [this](int channel_id) { tick_channel(channel_id); }, thread_cpus);
+      }
+      if (is_parallel || m_quantum > 1) {
+        m_exchanges.resize(num_channels);
+      }
+
       // Create memory controllers
+      m_controllers.resize(num_channels);
+      m_channel_memory.resize(num_channels);
       for (int i = 0; i < num_channels; i++) {
-        IDRAMController* controller = create_child_ifce<IDRAMController>();
-        controller->m_impl->set_id(fmt::format("Channel {}", i));
-        controller->m_channel_id = i;
-        m_controllers.push_back(controller);
+        if (m_tick_pool) {
+          m_tick_pool->run_on(i, [this](int channel_id) {
+            SimulationContext::Scope scope(m_context);
+            create_channel(channel_id);
+          });
+        } else {
+          create_channel(i);
+        }
       }
 
-      m_clock_ratio = param<uint>("clock_ratio").required();
+      m_ingress_size = param<size_t>("ingress_queue_size").desc("Requests each channel buffers in front of its controller (0 = no ingress queue).").default_val(0);
+      m_admissions_per_cycle = param<int>("ingress_admissions_per_cycle").desc("Requests an ingress queue hands to its controller per cycle.").default_val(4);
+      if (m_ingress_size > 0) {
+        if (m_admissions_per_cycle < 1) {
+          throw ConfigurationError("GenericDRAM: ingress_admissions_per_cycle must be at least 1 (got {})!", m_admissions_per_cycle);
+        }
+        if (m_quantum > 1) {
+          throw ConfigurationError("GenericDRAM: ingress queues cannot be combined with sync_quantum (the quantum inboxes already buffer the requests)!");
+        }
+        m_ingress.resize(num_channels);
+      }
+
+      if (m_quantum > 1) {
+        m_dram->enable_channel_clocks();
+      }
+      if (m_tick_pool) {
+        m_thread_locality.resize(m_tick_pool->get_num_threads());
+        for (int i = 0; i < num_channels; i++) {
+          m_thread_locality[m_tick_pool->get_thread(i)].num_channels++;
+        }
+      }
 
       register_stat(m_clk).name("memory_system_cycles");
       register_stat(s_num_read_requests).name("total_num_read_requests");
       register_stat(s_num_write_requests).name("total_num_write_requests");
       register_stat(s_num_other_requests).name("total_num_other_requests");
+      if (m_quantum > 1) {
+        register_stat(s_num_quantum_retry_cycles).name("quantum_retry_cycles");
+        register_stat(s_total_callback_delay).name("quantum_total_callback_delay");
+        register_stat(s_max_callback_delay).name("quantum_max_callback_delay");
+      }
+      for (size_t i = 0; i < m_ingress.size(); i++) {
+        register_stat(m_ingress[i].s_num_rejections).name("ingress_rejections_{}", i);
+        register_stat(m_ingress[i].s_num_backpressure_cycles).name("ingress_backpressure_cycles_{}", i);
+        register_stat(m_ingress[i].s_max_occupancy).name("ingress_max_occupancy_{}", i);
+      }
+      for (size_t i = 0; i < m_thread_locality.size(); i++) {
+        register_stat(m_thread_locality[i].cpu).name("thread_{}_cpu", i);
+        register_stat(m_thread_locality[i].numa_node).name("thread_{}_numa_node", i);
+        register_stat(m_thread_locality[i].num_channels).name("thread_{}_channels", i);
+        register_stat(m_thread_locality[i].local_memory_ratio).name("thread_{}_local_memory_ratio", i);
+      }
+      register_ecc_stats();
+      init_redundancy();
     };
 
     void setup(IFrontEnd* frontend, IMemorySystem* memory_system) override { }
 
+    void connect_frontend(IFrontEnd* frontend) override {
+      if (!m_tick_pool) {
+        IMemorySystem::connect_frontend(frontend);
+        return;
+      }
+      // In the same order, but the components of a channel are set up by its thread, as they were created
+      m_frontend = frontend;
+      m_impl->setup(frontend, this);
+      for (Implementation* component : m_components) {
+        int channel_id = get_channel(component);
+        if (channel_id == -1) {
+          component->setup(frontend, this);
+          continue;
+        }
+        m_tick_pool->run_on(channel_id, [&](int) {
+          SimulationContext::Scope scope(m_context);
+          component->setup(frontend, this);
+        });
+      }
+    };
+
     bool send(Request req) override {
       m_addr_mapper->apply(req);
       int channel_id = req.addr_vec[0];
-      bool is_success = m_controllers[channel_id]->send(req);
+
+      int callback_slot = -1;
+      if (!m_exchanges.empty() && req.callback) {
+        callback_slot = buffer_callback(channel_id, req);
+      }
+
+      bool is_success = true;
+      if (m_quantum > 1) {
+        // The controller is behind the frontend until the quantum ends, so it gets the request then
+        m_exchanges[channel_id]->inbox.emplace_back(m_clk, req);
+      } else if (m_ingress_size > 0) {
+        // The controller gets the request before its next tick, when it would have gotten it without the queue
+        IngressQueue& ingress = m_ingress[channel_id];
+        is_success = ingress.requests.size() < m_ingress_size;
+        if (is_success) {
+          ingress.requests.push_back(req);
+          ingress.s_max_occupancy = std::max(ingress.s_max_occupancy, ingress.requests.size());
+        } else {
+          ingress.s_num_rejections++;
+        }
+      } else {
+        catch_up(channel_id);
+        is_success = m_controllers[channel_id]->send(req);
+        if (m_event_driven) {
+          m_idle_cycles[channel_id] = m_controllers[channel_id]->get_idle_cycles();
+        }
+      }
+      if (!is_success && callback_slot != -1) {
+        m_exchanges[channel_id]->free_slots.push_back(callback_slot);
+      }
 
       if (is_success) {
+        if (m_redundancy.is_enabled() && req.type_id != Request::Type::Read) {
+          m_redundancy.on_write(req);
+        }
         switch (req.type_id) {
           case Request::Type::Read: {
             s_num_read_requests++;
@@ -71,13 +285,90 @@ class GenericDRAMSystem final : public IMemorySystem, public Implementation {
 
       return is_success;
     };
+
+    size_t send(std::span<Request> reqs) override {
+      size_t num_sent = 0;
+      while (num_sent < reqs.size() && GenericDRAMSystem::send(reqs[num_sent])) {
+        num_sent++;
+      }
+      return num_sent;
+    };
     
     void tick() override {
       m_clk++;
       m_dram->tick();
-      for (auto controller : m_controllers) {
-        controller->tick();
+      if (m_quantum > 1) {
+        if (m_clk - m_quantum_start == m_quantum) {
+          end_quantum();
+          deliver_callbacks();
+        }
+        return;
+      }
+      if (m_tick_pool) {
+        m_tick_pool->tick_all();
+        if (m_redundancy.is_enabled()) {
+          m_redundancy.tick();
+        }
+        deliver_callbacks();
+        return;
+      }
+      for (size_t i = 0; i < m_controllers.size(); i++) {
+        tick_channel(i);
+      }
+      if (m_redundancy.is_enabled()) {
+        m_redundancy.tick();
+      }
+    };
+
+    void finalize() override {
+      if (m_tick_pool) {
+        measure_locality();
+      }
+      // The frontend is done, so the completions of the last quantum are not delivered
+      if (m_quantum > 1 && m_quantum_start < m_clk) {
+        end_quantum();
+      }
+      // The controllers compute their averages over their own clock
+      for (size_t i = 0; i < m_controllers.size(); i++) {
+        catch_up(i);
+      }
+      m_redundancy.finalize();
+      IMemorySystem::finalize();
+    };
+
+    void aggregate_stats() override {
+      if (m_ecc.plugins.empty() && !m_dram->m_link_retry) {
+        return;
+      }
+      IECCPlugin::Totals& total = m_ecc.total;
+      total = {};
+      for (size_t i = 0; i < m_ecc.plugins.size(); i++) {
+        if (!m_ecc.plugins[i]) {
+          continue;
+        }
+        IECCPlugin::Totals channel = m_ecc.plugins[i]->get_totals();
+        total.reads += channel.reads;
+        total.writes += channel.writes;
+        total.read_bytes += channel.read_bytes;
+        total.edc_failures += channel.edc_failures;
+        total.ecc_corrections += channel.ecc_corrections;
+        total.ecc_failures += channel.ecc_failures;
+        total.parity_bytes += channel.parity_bytes;
+        total.parity_traffic_bytes += channel.parity_traffic_bytes;
+        m_ecc.edc_failures[i] = channel.edc_failures;
+        m_ecc.ecc_corrections[i] = channel.ecc_corrections;
+        m_ecc.ecc_failures[i] = channel.ecc_failures;
+        m_ecc.parity_traffic_bytes[i] = channel.parity_traffic_bytes;
       }
+      m_ecc.failures_per_gb = total.read_bytes ? (float) ((double) total.ecc_failures * 1e9 / (double) total.read_bytes) : 0.0f;
+      size_t requests = m_ecc.plugins.empty() ? s_num_read_requests + s_num_write_requests : total.reads + total.writes;
+      m_ecc.parity_bytes_per_request = requests ? (float) total.parity_traffic_bytes / (float) requests : 0.0f;
+
+      // Both error sources in one figure: the array ECC parity traffic and the link replays
+      m_ecc.link_lost_bytes = m_dram->m_link_retry ? m_dram->m_link_retry->lost_bytes() : 0;
+      size_t demand_bytes = requests * m_dram->m_channel_width / 8 * m_dram->m_internal_prefetch_size;
+      size_t moved_bytes = demand_bytes + total.parity_traffic_bytes + m_ecc.link_lost_bytes;
+      m_ecc.data_goodput = moved_bytes ? (float) demand_bytes / (float) moved_bytes : 0.0f;
     };
 
     float get_tCK() override {
@@ -87,6 +378,303 @@ class GenericDRAMSystem final : public IMemorySystem, public Implementation {
     // const SpecDef& get_supported_requests() override {
     //   return m_dram->m_requests;
     // };
+
+  private:
+    /**
+     * @brief    Creates the controller of a channel (and its plugins), rebuilds the device nodes of the channel and its
+     *           exchange, on the thread that will tick the channel if the channels tick in parallel.
+     *
+     */
+    void create_channel(int channel_id) {
+      IDRAMController* controller = create_child_ifce<IDRAMController>();
+      controller->m_impl->set_id(fmt::format("Channel {}", channel_id));
+      controller->m_channel_id = channel_id;
+      m_controllers[channel_id] = controller;
+      if (m_tick_pool) {
+        m_channel_memory[channel_id] = m_dram->place_channel(channel_id);
+      }
+      if (!m_exchanges.empty()) {
+        m_exchanges[channel_id] = std::make_unique<ChannelExchange>();
+      }
+    };
+
+    /**
+     * @brief    The channel of the controller a component belongs to, or -1 for the components all channels share.
+     *
+     */
+    static int get_channel(const Implementation* component) {
+      for (const Implementation* impl = component; impl; impl = impl->get_parent()) {
+        if (const IDRAMController* controller = dynamic_cast<const IDRAMController*>(impl)) {
+          return controller->m_channel_id;
+        }
+      }
+      return -1;
+    };
+
+    /**
+     * @brief    Records where every thread of the tick pool runs, and which fraction of the device node pages of its
+     *           channels is on its NUMA node.
+     *
+     */
+    void measure_locality() {
+      std::vector<double> local_bytes(m_controllers.size(), 0.0);
+      m_tick_pool->run_all([this, &local_bytes](int channel_id) {
+        ThreadLocality& locality = m_thread_locality[m_tick_pool->get_thread(channel_id)];
+        locality.cpu = NUMA::current_cpu();
+        locality.numa_node = NUMA::cpu_node(locality.cpu);
+        double ratio = NUMA::node_fraction(m_channel_memory[channel_id], locality.numa_node);
+        local_bytes[channel_id] = ratio < 0 ? -1.0 : ratio * m_channel_memory[channel_id].size();
+      });
+      std::vector<double> local_sum(m_thread_locality.size(), 0.0);
+      std::vector<double> total_sum(m_thread_locality.size(), 0.0);
+      for (size_t i = 0; i < m_controllers.size(); i++) {
+        if (local_bytes[i] >= 0) {
+          int thread_id = m_tick_pool->get_thread(i);
+          local_sum[thread_id] += local_bytes[i];
+          total_sum[thread_id] += m_channel_memory[i].size();
+        }
+      }
+      for (size_t i = 0; i < m_thread_locality.size(); i++) {
+        m_thread_locality[i].local_memory_ratio = total_sum[i] > 0 ? float(local_sum[i] / total_sum[i]) : -1.0f;
+      }
+    };
+
+    /**
+     * @brief    Sets up the cross-channel redundancy, if configured: the writes update their parity or mirror copies,
+     *           and the ECCPlugins of the controllers hand it their uncorrectable reads to rebuild.
+     *
+     */
+    void init_redundancy() {
+      if (!has_param_group("redundancy")) {
+        return;
+      }
+      int num_channels = m_controllers.size();
+      std::string mode = param_group("redundancy").param<std::string>("mode").desc("Cross-channel redundancy: none, xor, rs or mirror.").default_val("none");
+      int stripe_channels = param_group("redundancy").param<int>("stripe_channels").desc("Channels per redundancy stripe, the parity or mirror channels included.").default_val(num_channels);
+      int parity_channels = param_group("redundancy").param<int>("parity_channels").desc("Reed-Solomon parity channels per stripe (rs mode).").default_val(2);
+      if (!m_redundancy.configure(mode, stripe_channels, parity_channels, num_channels)) {
+        return;
+      }
+      if (m_quantum > 1) {
+        throw ConfigurationError("GenericDRAM: cross-channel redundancy cannot be combined with sync_quantum (the channels exchange requests every cycle)!");
+      }
+
+      m_redundancy.setup(m_dram->m_levels("row"), m_dram->m_requests("read"), m_dram->m_requests("write"), [this](int channel_id, Request& req) {
+        catch_up(channel_id);
+        bool is_success = m_controllers[channel_id]->send(req);
+        if (m_event_driven) {
+          m_idle_cycles[channel_id] = m_controllers[channel_id]->get_idle_cycles();
+        }
+        return is_success;
+      });
+      for (IDRAMController* controller : m_controllers) {
+        if (IECCPlugin* plugin = controller->get_plugin<IECCPlugin>()) {
+          plugin->set_uncorrectable_handler([this](Request& req) { m_redundancy.hold(req); });
+        }
+      }
+
+      register_stat(m_redundancy.s_rebuilds).name("redundancy_rebuilds");
+      register_stat(m_redundancy.s_rebuild_reads).name("redundancy_rebuild_reads");
+      register_stat(m_redundancy.s_avg_rebuild_latency).name("redundancy_avg_rebuild_latency");
+      register_stat(m_redundancy.s_parity_reads).name("redundancy_parity_reads");
+      register_stat(m_redundancy.s_parity_writes).name("redundancy_parity_writes");
+      register_stat(m_redundancy.s_mirror_writes).name("redundancy_mirror_writes");
+      register_stat(m_redundancy.s_send_retry_cycles).name("redundancy_send_retry_cycles");
+    };
+
+    /**
+     * @brief    Registers the ECC statistics summed over the channels, if any controller has an ECCPlugin (the
+     *           controllers create their plugins in their init()).
+     *
+     */
+    void register_ecc_stats() {
+      bool has_ecc = false;
+      for (IDRAMController* controller : m_controllers) {
+        IECCPlugin* plugin = controller->get_plugin<IECCPlugin>();
+        m_ecc.plugins.push_back(plugin);
+        has_ecc |= plugin != nullptr;
+      }
+      if (has_ecc || m_dram->m_link_retry) {
+        register_stat(m_ecc.link_lost_bytes).name("link_lost_bytes");
+        register_stat(m_ecc.data_goodput).name("data_goodput");
+      }
+      if (!has_ecc) {
+        m_ecc.plugins.clear();
+        return;
+      }
+      size_t num_channels = m_controllers.size();
+      m_ecc.edc_failures.resize(num_channels, 0);
+      m_ecc.ecc_corrections.resize(num_channels, 0);
+      m_ecc.ecc_failures.resize(num_channels, 0);
+      m_ecc.parity_traffic_bytes.resize(num_channels, 0);
+
+      register_stat(m_ecc.total.reads).name("ecc_total_reads");
+      register_stat(m_ecc.total.writes).name("ecc_total_writes");
+      register_stat(m_ecc.total.edc_failures).name("ecc_total_edc_failures");
+      register_stat(m_ecc.total.ecc_corrections).name("ecc_total_corrections");
+      register_stat(m_ecc.total.ecc_failures).name("ecc_total_failures");
+      register_stat(m_ecc.total.parity_bytes).name("ecc_total_parity_bytes");
+      register_stat(m_ecc.total.parity_traffic_bytes).name("ecc_total_parity_traffic_bytes");
+      register_stat(m_ecc.failures_per_gb).name("ecc_failures_per_gb");
+      register_stat(m_ecc.parity_bytes_per_request).name("ecc_parity_bytes_per_request");
+      register_stat(m_ecc.edc_failures).name("ecc_edc_failures_per_channel");
+      register_stat(m_ecc.ecc_corrections).name("ecc_corrections_per_channel");
+      register_stat(m_ecc.ecc_failures).name("ecc_failures_per_channel");
+      register_stat(m_ecc.parity_traffic_bytes).name("ecc_parity_traffic_bytes_per_channel");
+    };
+
+    /**
+     * @brief    Admits requests from the ingress queue of a channel and ticks its controller, or skips the tick if the
+     *           controller reported to be idle. Only touches the state of its channel.
+     *
+     */
+    void tick_channel(int channel_id) {
+      bool has_ingress = m_ingress_size > 0 && !m_ingress[channel_id].requests.empty();
+      if (!has_ingress && m_event_driven && m_skipped_cycles[channel_id] < m_idle_cycles[channel_id]) {
+        m_skipped_cycles[channel_id]++;
+        return;
+      }
+      catch_up(channel_id);
+      if (has_ingress) {
+        admit_requests(channel_id);
+      }
+      RAMULATOR_PROFILE_CALL(m_controllers[channel_id], tick());
+      if (m_event_driven) {
+        m_idle_cycles[channel_id] = m_controllers[channel_id]->get_idle_cycles();
+      }
+    };
+
+    /**
+     * @brief    Hands up to ingress_admissions_per_cycle requests from the ingress queue of a channel to its controller,
+     *           stopping when the controller refuses one.
+     *
+     */
+    void admit_requests(int channel_id) {
+      IngressQueue& ingress = m_ingress[channel_id];
+      for (int i = 0; i < m_admissions_per_cycle && !ingress.requests.empty(); i++) {
+        if (!m_controllers[channel_id]->send(ingress.requests.front())) {
+          ingress.s_num_backpressure_cycles++;
+          return;
+        }
+        ingress.requests.pop_front();
+      }
+    };
+
+    /**
+     * @brief    Advances one channel to the clock of the memory system, handing it the requests sent meanwhile.
+     *
+     * @details
+     * A request sent at cycle c is offered to the controller before its tick to c + 1, as in lock-step mode. If the
+     * controller rejects it, it and the requests behind it wait for the next cycle (counted as retry cycles).
+     * Only touches the state of the channel, so the channels can run their quanta in parallel.
+     *
+     */
+    void run_quantum(int channel_id) {
+      ChannelExchange& exchange = *m_exchanges[channel_id];
+      std::vector<std::pair<Clk_t, Request>>& inbox = exchange.inbox;
+      while (exchange.clk < m_clk) {
+        while (exchange.num_inbox_head < inbox.size() && inbox[exchange.num_inbox_head].first <= exchange.clk) {
+          catch_up(channel_id);
+          bool is_success = m_controllers[channel_id]->send(inbox[exchange.num_inbox_head].second);
+          if (m_event_driven) {
+            m_idle_cycles[channel_id] = m_controllers[channel_id]->get_idle_cycles();
+          }
+          if (!is_success) {
+            exchange.num_retry_cycles++;
+            break;
+          }
+          exchange.num_inbox_head++;
+        }
+
+        exchange.clk++;
+        m_dram->tick_channel(channel_id);
+        tick_channel(channel_id);
+      }
+      inbox.erase(inbox.begin(), inbox.begin() + exchange.num_inbox_head);
+      exchange.num_inbox_head = 0;
+    };
+
+    /**
+     * @brief    Runs the quantum of every channel, on the tick pool if there is one.
+     *
+     */
+    void end_quantum() {
+      if (m_tick_pool) {
+        m_tick_pool->tick_all();
+      } else {
+        for (size_t i = 0; i < m_controllers.size(); i++) {
+          run_quantum(i);
+        }
+      }
+      m_quantum_start = m_clk;
+
+      for (std::unique_ptr<ChannelExchange>& exchange : m_exchanges) {
+        s_num_quantum_retry_cycles += exchange->num_retry_cycles;
+        exchange->num_retry_cycles = 0;
+      }
+    };
+
+    /**
+     * @brief    Stores the callback of req and replaces it with one that records the completion in its channel.
+     *
+     * @details
+     * The frontend is not thread-safe, so the controllers must not call into it while the channels tick in parallel,
+     * and in quantum mode they are ahead of it. The buffered completions are delivered by deliver_callbacks() on the
+     * simulation thread.
+     *
+     */
+    int buffer_callback(int channel_id, Request& req) {
+      ChannelExchange* state = m_exchanges[channel_id].get();
+      int slot;
+      if (state->free_slots.empty()) {
+        slot = state->callbacks.size();
+        state->callbacks.push_back(req.callback);
+      } else {
+        slot = state->free_slots.back();
+        state->free_slots.pop_back();
+        state->callbacks[slot] = req.callback;
+      }
+      req.callback = [state, slot](Request& req) { state->completed.push_back({slot, state->clk, req}); };
+      return slot;
+    };
+
+    /**
+     * @brief    Invokes the callbacks of the requests completed since the last delivery, by channel and then completion
+     *           order.
+     *
+     * @details
+     * In lock-step mode this is the order in which the channels invoke them when they are ticked sequentially. In
+     * quantum mode, the cycles the completions waited for the end of the quantum are the callback delay.
+     *
+     */
+    void deliver_callbacks() {
+      for (std::unique_ptr<ChannelExchange>& state : m_exchanges) {
+        for (ChannelExchange::Completion& completion : state->completed) {
+          RequestCallback callback = state->callbacks[completion.slot];
+          state->free_slots.push_back(completion.slot);
+          if (m_quantum > 1) {
+            size_t delay = m_clk - completion.clk;
+            s_total_callback_delay += delay;
+            s_max_callback_delay = std::max(s_max_callback_delay, delay);
+          }
+          completion.req.callback = callback;
+          callback(completion.req);
+        }
+        state->completed.clear();
+      }
+    };
+
+    /**
+     * @brief    Applies the ticks a controller skipped so that it is at the clock of the memory system again.
+     * 
+     */
+    void catch_up(int channel_id) {
+      if (m_skipped_cycles[channel_id] > 0) {
+        m_controllers[channel_id]->skip_cycles(m_skipped_cycles[channel_id]);
+        m_idle_cycles[channel_id] -= m_skipped_cycles[channel_id];
+        m_skipped_cycles[channel_id] = 0;
+      }
+    };
 };
   
 }   // namespace 
@@ -0,0 +1,416 @@
+#include <algorithm>
+#include <deque>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#include "memory_system/memory_system.h"
+#include "dram/dram.h"
+
+namespace Ramulator {
+
+/**
+ * @brief    A heterogeneous memory system that splits the address space across tiers (e.g., HBM3 and DDR5).
+ *
+ * @details
+ * Every tier is a complete memory system of its own (typically GenericDRAM, with its device, controllers, address
+ * mapper and plugins), configured in the tiers list. A request is routed to a tier either by address range (the
+ * tiers are laid out in order) or by interleaving blocks across the tiers in proportion to their capacities, and
+ * sent to the tier with its address relative to the tier. Each tier is ticked at its own clock ratio.
+ *
+ * With migration enabled, the pages of the slower tiers that are accessed at least hot_threshold times in an epoch
+ * are swapped with pages of the first (fast) tier that are not hot. A swap moves both pages with line-sized reads
+ * and writes through the tiers, so the migrations compete with the demand requests for bandwidth. The page table
+ * is updated when the swap is scheduled.
+ *
+ */
+class TieredDRAMSystem final : public IMemorySystem, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(IMemorySystem, TieredDRAMSystem, "TieredDRAM", "A heterogeneous memory system with one memory system per tier.");
+
+  protected:
+    Clk_t m_clk = 0;
+
+    struct Tier {
+      IMemorySystem* system = nullptr;
+      Addr_t capacity = 0;                          // Bytes
+      Addr_t base = 0;                              // First global address of the tier (range routing)
+      Addr_t num_stripe_blocks = 0;                 // Blocks of the tier per stripe (interleave routing)
+      Addr_t first_stripe_block = 0;                // Position of its first block in a stripe (interleave routing)
+      uint tick_period = 1;                         // Ticks of the tiered system per tick of the tier
+
+      std::deque<Request> migration_reqs;           // Migration traffic waiting for the tier to accept it
+      std::unordered_map<Addr_t, Addr_t> residents; // Local page -> global page, for the pages that were swapped
+
+      size_t s_num_requests = 0;
+    };
+    std::vector<Tier> m_tiers;
+    Addr_t m_capacity = 0;
+
+    enum class Routing { Range, Interleave };
+    Routing m_routing = Routing::Range;
+    Addr_t m_interleave_size = -1;
+    Addr_t m_stripe_blocks = 0;                     // Blocks per stripe across all tiers
+
+    struct PendingCallback {
+      RequestCallback callback;
+      Addr_t addr;                                  // Address the frontend sent, restored before the callback
+    };
+    std::vector<PendingCallback> m_callbacks;
+    std::vector<int> m_free_slots;
+
+    struct Location {
+      int tier;
+      Addr_t page;                                  // Page number within the tier
+    };
+    bool m_migration = false;
+    Addr_t m_page_size = -1;
+    Clk_t m_migration_epoch = -1;
+    int m_hot_threshold = -1;
+    int m_max_migrations = -1;
+    Addr_t m_line_size = -1;
+    Addr_t m_victim_page = 0;                       // CLOCK hand over the pages of the fast tier
+    std::unordered_map<Addr_t, Location> m_page_locations;   // Global pages that were swapped
+    std::unordered_map<Addr_t, int> m_page_accesses;         // Accesses per global page in the running epoch
+
+    size_t s_num_migrations = 0;
+    size_t s_migration_bytes = 0;
+    double s_migration_bandwidth = 0;
+
+  public:
+    void init() override {
+      const YAML::Node& tier_configs = m_config["tiers"];
+      if (!tier_configs || !tier_configs.IsSequence() || tier_configs.size() < 2) {
+        throw ConfigurationError("TieredDRAM: tiers must list at least two memory systems!");
+      }
+      for (YAML::const_iterator it = tier_configs.begin(); it != tier_configs.end(); ++it) {
+        Tier& tier = m_tiers.emplace_back();
+        tier.system = create_child_ifce<IMemorySystem>(*it);
+        tier.system->gather_components();
+        tier.system->set_nested();
+        if (tier.system->m_impl->get_id() == "_default_id") {
+          tier.system->m_impl->set_id(fmt::format("Tier {}", m_tiers.size() - 1));
+        }
+
+        IDRAM* dram = tier.system->get_ifce<IDRAM>();
+        tier.capacity = (Addr_t) dram->m_channel_width / 8;
+        for (int count : dram->m_organization.count) {
+          tier.capacity *= count;
+        }
+        tier.base = m_capacity;
+        m_capacity += tier.capacity;
+      }
+
+      // Tick at the least common multiple of the ratios of the tiers, each tier once every tick_period ticks
+      uint clock_ratio = 1;
+      for (Tier& tier : m_tiers) {
+        clock_ratio = std::lcm(clock_ratio, (uint) tier.system->get_clock_ratio());
+      }
+      for (Tier& tier : m_tiers) {
+        tier.tick_period = clock_ratio / tier.system->get_clock_ratio();
+      }
+      m_clock_ratio = clock_ratio;
+
+      std::string routing = param<std::string>("routing").desc("How addresses are split across the tiers (range or interleave).").default_val("range");
+      if (routing == "range") {
+        m_routing = Routing::Range;
+      } else if (routing == "interleave") {
+        m_routing = Routing::Interleave;
+      } else {
+        throw ConfigurationError("TieredDRAM: unknown routing {} (range or interleave)!", routing);
+      }
+      m_interleave_size = param<Addr_t>("interleave_size").desc("Bytes of a block in interleave routing.").default_val(4096);
+      if (m_routing == Routing::Interleave) {
+        setup_interleaving();
+      }
+
+      m_migration = param<bool>("migration").desc("Swap hot pages of the slower tiers into the first tier.").default_val(false);
+      m_page_size = param<Addr_t>("page_size").desc("Bytes of a migrated page.").default_val(4096);
+      m_migration_epoch = param<Clk_t>("migration_epoch").desc("Cycles between two migration decisions.").default_val(100000);
+      m_hot_threshold = param<int>("hot_threshold").desc("Accesses in an epoch that make a page hot.").default_val(32);
+      m_max_migrations = param<int>("max_migrations_per_epoch").desc("Pages swapped into the first tier per epoch.").default_val(16);
+      m_line_size = param<Addr_t>("migration_line_size").desc("Bytes each migration request moves.").default_val(64);
+      if (m_migration) {
+        validate_migration();
+      }
+
+      register_stat(m_clk).name("memory_system_cycles");
+      for (size_t i = 0; i < m_tiers.size(); i++) {
+        register_stat(m_tiers[i].s_num_requests).name("num_requests_tier_{}", i);
+      }
+      if (m_migration) {
+        register_stat(s_num_migrations).name("num_page_migrations");
+        register_stat(s_migration_bytes).name("migration_bytes");
+        register_stat(s_migration_bandwidth).name("migration_bandwidth_GBps");
+      }
+    };
+
+    void connect_frontend(IFrontEnd* frontend) override {
+      // Each tier sets up its own components, so that they find the device of their tier
+      m_frontend = frontend;
+      m_impl->setup(frontend, this);
+      for (Tier& tier : m_tiers) {
+        tier.system->connect_frontend(frontend);
+      }
+    };
+
+    bool send(Request req) override {
+      // Addresses wrap around the total capacity
+      Addr_t frontend_addr = req.addr;
+      Addr_t addr = req.addr % m_capacity;
+      Addr_t page = addr / m_page_size;
+      int tier_id = -1;
+      if (m_migration) {
+        Location location = locate(page);
+        tier_id = location.tier;
+        req.addr = location.page * m_page_size + addr % m_page_size;
+      } else {
+        req.addr = route(addr, tier_id);
+      }
+      Tier& tier = m_tiers[tier_id];
+
+      int slot = -1;
+      if (req.callback) {
+        slot = buffer_callback(req, frontend_addr);
+      }
+      bool is_success = tier.system->send(req);
+
+      if (!is_success) {
+        if (slot != -1) {
+          m_free_slots.push_back(slot);
+        }
+        return false;
+      }
+      tier.s_num_requests++;
+      if (m_migration && tier_id != 0) {
+        m_page_accesses[page]++;
+      }
+      return true;
+    };
+
+    void tick() override {
+      m_clk++;
+      for (Tier& tier : m_tiers) {
+        if (m_clk % tier.tick_period != 0) {
+          continue;
+        }
+        while (!tier.migration_reqs.empty() && tier.system->send(tier.migration_reqs.front())) {
+          tier.migration_reqs.pop_front();
+          s_migration_bytes += m_line_size;
+        }
+        tier.system->tick();
+      }
+
+      if (m_migration && m_clk % m_migration_epoch == 0) {
+        migrate_hot_pages();
+      }
+    };
+
+    void finalize() override {
+      for (Tier& tier : m_tiers) {
+        tier.system->finalize();
+      }
+      // A tick of the first tier takes tick_period ticks of the tiered system; bytes per ns are GB/s
+      double ns = m_clk * m_tiers[0].system->get_tCK() / m_tiers[0].tick_period;
+      if (ns > 0) {
+        s_migration_bandwidth = s_migration_bytes / ns;
+      }
+      emit_stats();
+    };
+
+    float get_tCK() override {
+      return m_tiers[0].system->get_tCK();
+    };
+
+  private:
+    void setup_interleaving() {
+      // Stripes hold blocks of every tier in proportion to the capacities
+      Addr_t blocks_gcd = 0;
+      for (Tier& tier : m_tiers) {
+        if (tier.capacity % m_interleave_size != 0) {
+          throw ConfigurationError("TieredDRAM: interleave_size must divide the capacity of every tier!");
+        }
+        blocks_gcd = std::gcd(blocks_gcd, tier.capacity / m_interleave_size);
+      }
+      for (Tier& tier : m_tiers) {
+        tier.num_stripe_blocks = tier.capacity / m_interleave_size / blocks_gcd;
+        tier.first_stripe_block = m_stripe_blocks;
+        m_stripe_blocks += tier.num_stripe_blocks;
+      }
+    };
+
+    void validate_migration() {
+      if (m_page_size <= 0 || m_line_size <= 0 || m_page_size % m_line_size != 0) {
+        throw ConfigurationError("TieredDRAM: page_size must be a positive multiple of migration_line_size!");
+      }
+      if (m_routing == Routing::Interleave && m_interleave_size % m_page_size != 0) {
+        throw ConfigurationError("TieredDRAM: interleave_size must be a multiple of page_size, so that a page lives in one tier!");
+      }
+      for (Tier& tier : m_tiers) {
+        if (tier.capacity % m_page_size != 0) {
+          throw ConfigurationError("TieredDRAM: page_size must divide the capacity of every tier!");
+        }
+      }
+      if (m_migration_epoch <= 0 || m_hot_threshold <= 0 || m_max_migrations <= 0) {
+        throw ConfigurationError("TieredDRAM: migration_epoch, hot_threshold and max_migrations_per_epoch must be positive!");
+      }
+    };
+
+    /**
+     * @brief    The tier and local page of a global page, following the migrations.
+     *
+     */
+    Location locate(Addr_t page) const {
+      if (auto it = m_page_locations.find(page); it != m_page_locations.end()) {
+        return it->second;
+      }
+      return default_location(page);
+    };
+
+    /**
+     * @brief    The tier (in tier_id) and address within the tier that a global address is routed to without migrations.
+     *
+     */
+    Addr_t route(Addr_t addr, int& tier_id) const {
+      tier_id = 0;
+      if (m_routing == Routing::Range) {
+        while (addr >= m_tiers[tier_id].base + m_tiers[tier_id].capacity) {
+          tier_id++;
+        }
+        return addr - m_tiers[tier_id].base;
+      }
+
+      Addr_t block = addr / m_interleave_size;
+      Addr_t stripe = block / m_stripe_blocks;
+      Addr_t position = block % m_stripe_blocks;
+      while (position >= m_tiers[tier_id].first_stripe_block + m_tiers[tier_id].num_stripe_blocks) {
+        tier_id++;
+      }
+      const Tier& tier = m_tiers[tier_id];
+      Addr_t local_block = stripe * tier.num_stripe_blocks + position - tier.first_stripe_block;
+      return local_block * m_interleave_size + addr % m_interleave_size;
+    };
+
+    /**
+     * @brief    The tier and local page a global page is routed to without migrations.
+     *
+     */
+    Location default_location(Addr_t page) const {
+      int tier_id = -1;
+      Addr_t local_addr = route(page * m_page_size, tier_id);
+      return {tier_id, local_addr / m_page_size};
+    };
+
+    /**
+     * @brief    The inverse of default_location(): the global page routed to a local page without migrations.
+     *
+     */
+    Addr_t default_page(int tier_id, Addr_t local_page) const {
+      const Tier& tier = m_tiers[tier_id];
+      Addr_t local_addr = local_page * m_page_size;
+      if (m_routing == Routing::Range) {
+        return (tier.base + local_addr) / m_page_size;
+      }
+
+      Addr_t local_block = local_addr / m_interleave_size;
+      Addr_t stripe = local_block / tier.num_stripe_blocks;
+      Addr_t block = stripe * m_stripe_blocks + tier.first_stripe_block + local_block % tier.num_stripe_blocks;
+      return (block * m_interleave_size + local_addr % m_interleave_size) / m_page_size;
+    };
+
+    Addr_t resident_page(int tier_id, Addr_t local_page) const {
+      const Tier& tier = m_tiers[tier_id];
+      if (auto it = tier.residents.find(local_page); it != tier.residents.end()) {
+        return it->second;
+      }
+      return default_page(tier_id, local_page);
+    };
+
+    /**
+     * @brief    Stores the callback of req and replaces it with one that restores the frontend address first.
+     *
+     */
+    int buffer_callback(Request& req, Addr_t frontend_addr) {
+      int slot;
+      if (m_free_slots.empty()) {
+        slot = m_callbacks.size();
+        m_callbacks.push_back({req.callback, frontend_addr});
+      } else {
+        slot = m_free_slots.back();
+        m_free_slots.pop_back();
+        m_callbacks[slot] = {req.callback, frontend_addr};
+      }
+      req.callback = [this, slot](Request& req) { deliver_callback(slot, req); };
+      return slot;
+    };
+
+    void deliver_callback(int slot, Request& req) {
+      PendingCallback pending = m_callbacks[slot];
+      m_free_slots.push_back(slot);
+      req.addr = pending.addr;
+      req.callback = pending.callback;
+      pending.callback(req);
+    };
+
+    /**
+     * @brief    Swaps the hottest pages of the slower tiers with pages of the first tier that are not hot.
+     *
+     */
+    void migrate_hot_pages() {
+      std::vector<std::pair<int, Addr_t>> hot_pages;     // (accesses, global page)
+      for (auto& [page, num_accesses] : m_page_accesses) {
+        if (num_accesses >= m_hot_threshold) {
+          hot_pages.emplace_back(num_accesses, page);
+        }
+      }
+      std::sort(hot_pages.begin(), hot_pages.end(), std::greater<>());
+      if ((int) hot_pages.size() > m_max_migrations) {
+        hot_pages.resize(m_max_migrations);
+      }
+
+      Addr_t num_fast_pages = m_tiers[0].capacity / m_page_size;
+      for (auto& [num_accesses, hot_page] : hot_pages) {
+        // CLOCK over the first tier: skip the pages that are hot as well (including the ones just swapped in)
+        Addr_t victim_page = -1;
+        Addr_t victim_global_page = -1;
+        for (int i = 0; i < 64 && victim_page == -1; i++) {
+          Addr_t local_page = m_victim_page;
+          m_victim_page = (m_victim_page + 1) % num_fast_pages;
+          Addr_t global_page = resident_page(0, local_page);
+          if (auto it = m_page_accesses.find(global_page); it == m_page_accesses.end() || it->second < m_hot_threshold) {
+            victim_page = local_page;
+            victim_global_page = global_page;
+          }
+        }
+        if (victim_page == -1) {
+          break;
+        }
+        swap_pages(hot_page, victim_global_page, victim_page);
+      }
+
+      m_page_accesses.clear();
+    };
+
+    void swap_pages(Addr_t hot_page, Addr_t victim_page, Addr_t fast_local_page) {
+      Location hot_location = locate(hot_page);
+
+      m_page_locations[hot_page] = {0, fast_local_page};
+      m_page_locations[victim_page] = hot_location;
+      m_tiers[0].residents[fast_local_page] = hot_page;
+      m_tiers[hot_location.tier].residents[hot_location.page] = victim_page;
+
+      // Read both pages from their old location and write them to the new one
+      Tier& fast_tier = m_tiers[0];
+      Tier& slow_tier = m_tiers[hot_location.tier];
+      for (Addr_t offset = 0; offset < m_page_size; offset += m_line_size) {
+        Addr_t fast_addr = fast_local_page * m_page_size + offset;
+        Addr_t slow_addr = hot_location.page * m_page_size + offset;
+        slow_tier.migration_reqs.push_back(Request(slow_addr, Request::Type::Read));
+        fast_tier.migration_reqs.push_back(Request(fast_addr, Request::Type::Read));
+        fast_tier.migration_reqs.push_back(Request(fast_addr, Request::Type::Write));
+        slow_tier.migration_reqs.push_back(Request(slow_addr, Request::Type::Write));
+      }
+      s_num_migrations++;
+    };
+};
+
+}   // namespace Ramulator
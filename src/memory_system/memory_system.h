@@ -2,6 +2,7 @@
 #define     RAMULATOR_MEMORYSYSTEM_MEMORY_H
 
 #include <map>
+#include <span>
 #include <vector>
 #include <string>
 #include <functional>
@@ -19,6 +20,8 @@ class IMemorySystem : public TopLevel<IMemorySystem> {
   protected:
     IFrontEnd* m_frontend;
     uint m_clock_ratio = 1;
+    bool m_is_nested = false;     // Part of another memory system, which prints the statistics
+    std::ostream* m_stats_out = &std::cout;
 
   public:
     virtual void connect_frontend(IFrontEnd* frontend) { 
@@ -33,14 +36,43 @@ class IMemorySystem : public TopLevel<IMemorySystem> {
       for (auto component : m_components) {
         component->finalize();
       }
+      aggregate_stats();
+      if (!m_is_nested) {
+        emit_stats();
+      }
+    };
+
+    /**
+     * @brief         Computes the statistics that combine those of the components (e.g., over all channels), once
+     *                the components are finalized
+     * 
+     */
+    virtual void aggregate_stats() { };
 
+    /**
+     * @brief         Prints the statistics of the memory system and all its components
+     * 
+     */
+    void emit_stats() {
       YAML::Emitter emitter;
       emitter << YAML::BeginMap;
       m_impl->print_stats(emitter);
       emitter << YAML::EndMap;
-      std::cout << emitter.c_str() << std::endl;
+      *m_stats_out << emitter.c_str() << std::endl;
     };
 
+    /**
+     * @brief         Sets where the statistics are printed (std::cout by default)
+     * 
+     */
+    void set_stats_output(std::ostream& stats_out) { m_stats_out = &stats_out; };
+
+    /**
+     * @brief         Marks the memory system as part of another one (e.g., a tier), which ticks it and prints its statistics
+     * 
+     */
+    void set_nested() { m_is_nested = true; };
+
     /**
      * @brief         Tries to send the request to the memory system
      * 
@@ -50,6 +82,20 @@ class IMemorySystem : public TopLevel<IMemorySystem> {
      */
     virtual bool send(Request req) = 0;
 
+    /**
+     * @brief         Tries to send the requests to the memory system in order, stopping at the first rejected one
+     * 
+     * @param    reqs     The requests
+     * @return   size_t   Number of requests accepted, i.e., reqs[0, n) are accepted and reqs[n] (if any) is rejected.
+     */
+    virtual size_t send(std::span<Request> reqs) {
+      size_t num_sent = 0;
+      while (num_sent < reqs.size() && send(reqs[num_sent])) {
+        num_sent++;
+      }
+      return num_sent;
+    };
+
     /**
      * @brief         Ticks the memory system
      * 
@@ -0,0 +1,697 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <argparse/argparse.hpp>
+#include <spdlog/spdlog.h>
+
+#include "base/base.h"
+#include "dram/dram.h"
+
+// Device-model harness: drives each DRAM spec of src/dram/impl directly, without a controller, with a synthetic
+// command stream. Every ready check of the device is compared with an independent model of its timing constraints,
+// the layouts of the timing state (node tree or flat tables, with or without the ready cycle cache) must issue the
+// same command timeline, and the timelines can be recorded as golden ones and compared against them later. It then
+// replays the timeline to report the time per issue_command(), check_ready() and get_preq_command().
+
+namespace {
+
+using Ramulator::AddrVec_t;
+using Ramulator::Clk_t;
+using Ramulator::IDRAM;
+
+struct Options {
+  std::vector<std::string> drams;
+  std::vector<std::string> variants;
+  size_t num_requests = 20000;
+  int window = 8;
+  int rows_per_bank = 4;
+  double write_ratio = 0.3;
+  int refresh_interval = 256;
+  uint64_t seed = 1;
+  int repeats = 3;
+  bool bench = true;
+  std::string golden_path;
+  std::string record_path;
+};
+
+struct DeviceSpec {
+  std::string dram;
+  std::string org;
+  std::string timing;
+  std::string org_overrides;    // Only channel 0 is driven, so the devices whose density allows it get one channel
+  std::string extra;            // Other params the device requires
+};
+
+const std::vector<DeviceSpec> DEVICES = {
+  {"DDR3",      "DDR3_4Gb_x8",    "DDR3_1600K",               "channel: 1, rank: 2", ""},
+  {"DDR4",      "DDR4_8Gb_x8",    "DDR4_2400R",               "channel: 1, rank: 2", ""},
+  {"DDR4-VRR",  "DDR4_8Gb_x8",    "DDR4_2400R",               "channel: 1, rank: 2", ""},
+  {"DDR4-RVRR", "DDR4_8Gb_x8",    "DDR4_2400R",               "channel: 1, rank: 2", ""},
+  {"DDR5",      "DDR5_16Gb_x8",   "DDR5_3200AN",              "channel: 1, rank: 2", "RFM: {BRC: 2}"},
+  {"DDR5-VRR",  "DDR5_16Gb_x8",   "DDR5_3200AN",              "channel: 1, rank: 2", "RFM: {BRC: 2}"},
+  {"DDR5-RVRR", "DDR5_16Gb_x8",   "DDR5_3200AN",              "channel: 1, rank: 2", "RFM: {BRC: 2}"},
+  {"GDDR6",     "GDDR6_8Gb_x16",  "GDDR6_2000_1350mV_double", "",                    ""},
+  {"HBM",       "HBM_4Gb",        "HBM_2Gbps",                "channel: 1",          ""},
+  {"HBM2",      "HBM2_4Gb",       "HBM2_2Gbps",               "channel: 1",          ""},
+  {"HBM3",      "HBM3_2Gb",       "HBM3_2Gbps",               "channel: 1",          ""},
+  {"LPDDR5",    "LPDDR5_8Gb_x16", "LPDDR5_6400",              "channel: 1, rank: 2", ""},
+};
+
+struct Variant {
+  std::string name;
+  bool flat_timing;
+  bool ready_clk_cache;
+};
+
+// The first variant is the reference the others must match
+const std::vector<Variant> VARIANTS = {
+  {"tree",       false, false},
+  {"tree+cache", false, true},
+  {"flat",       true,  false},
+  {"flat+cache", true,  true},
+};
+
+/**
+ * @brief    Creates the device alone (it needs no parent), with the logs its init() prints to std::cout discarded.
+ *
+ */
+std::unique_ptr<IDRAM> make_device(const DeviceSpec& spec, const Variant& variant) {
+  YAML::Node config = YAML::Load(fmt::format(
+    "DRAM:\n"
+    "  impl: {}\n"
+    "  org: {{preset: {}{}{}}}\n"
+    "  timing: {{preset: {}}}\n"
+    "  flat_timing: {}\n"
+    "  ready_clk_cache: {}\n"
+    "  {}\n",
+    spec.dram, spec.org, spec.org_overrides.empty() ? "" : ", ", spec.org_overrides, spec.timing,
+    variant.flat_timing, variant.ready_clk_cache, spec.extra));
+
+  std::streambuf* cout_buf = std::cout.rdbuf(nullptr);
+  Ramulator::Implementation* impl = nullptr;
+  try {
+    impl = Ramulator::Factory::create_implementation(IDRAM::get_name(), config, nullptr);
+  } catch (...) {
+    std::cout.rdbuf(cout_buf);
+    throw;
+  }
+  std::cout.rdbuf(cout_buf);
+  return std::unique_ptr<IDRAM>(dynamic_cast<IDRAM*>(impl));
+}
+
+/**
+ * @brief    An independent model of the cycle from which the device accepts each command
+ * @details
+ * The device tracks timing forward: issuing a command raises the ready cycles of the commands it constrains. This model
+ * works backward from the same m_timing_cons instead, like the TimingChecker plugin: it keeps the recent issue cycles
+ * of each command at each node, and the ready cycle of a command is the latest cycle that a constraint ending at it
+ * allows, over the nodes the device checks (its path down to the scope of the command, all children at a wildcard).
+ *
+ */
+class TimingModel {
+  private:
+    struct Constraint {
+      int preceding;
+      int val;
+      int window;
+      bool sibling;
+    };
+
+    // Two latest issues of a command to the children of one parent, from different children
+    struct LastIssues {
+      Clk_t clk = -1;
+      int child = -1;
+      Clk_t other_clk = -1;
+    };
+
+    int m_num_levels = 0;
+    int m_num_cmds = 0;
+    std::vector<int> m_fanouts;
+    std::vector<int> m_scopes;
+    std::vector<std::vector<Constraint>> m_constraints;     // [level * m_num_cmds + following command]
+    std::vector<int> m_history_windows;                     // [level * m_num_cmds + cmd]
+    std::vector<std::vector<Clk_t>> m_histories;            // [level * m_num_cmds + cmd][node * window + i]
+    std::vector<bool> m_tracks_siblings;
+    std::vector<std::vector<LastIssues>> m_last_issues;     // [level * m_num_cmds + cmd][parent node]
+    std::vector<std::vector<int>> m_targets;
+
+  public:
+    explicit TimingModel(IDRAM* dram) {
+      m_num_cmds = dram->m_commands.size();
+      int row_level = dram->m_levels("row");
+      const auto& count = dram->m_organization.count;
+      // The device keeps nodes down to the level above the rows
+      m_num_levels = 1;
+      while (m_num_levels < row_level && count[m_num_levels] > 0) {
+        m_num_levels++;
+      }
+      m_fanouts.assign(m_num_levels, 1);
+      std::vector<int> num_nodes(m_num_levels, 1);
+      for (int level = 1; level < m_num_levels; level++) {
+        m_fanouts[level] = count[level];
+        num_nodes[level] = num_nodes[level - 1] * count[level];
+      }
+      for (int cmd = 0; cmd < m_num_cmds; cmd++) {
+        m_scopes.push_back(dram->m_command_scopes(cmd));
+      }
+
+      m_constraints.assign(m_num_levels * m_num_cmds, {});
+      m_history_windows.assign(m_num_levels * m_num_cmds, 0);
+      m_tracks_siblings.assign(m_num_levels * m_num_cmds, false);
+      for (int level = 0; level < m_num_levels; level++) {
+        for (int preceding = 0; preceding < m_num_cmds; preceding++) {
+          for (const auto& t : dram->m_timing_cons[level][preceding]) {
+            if (t.sibling) {
+              if (level == 0) {
+                continue;
+              }
+              m_tracks_siblings[level * m_num_cmds + preceding] = true;
+            } else {
+              if (t.window <= 0) {
+                continue;
+              }
+              int& window = m_history_windows[level * m_num_cmds + preceding];
+              window = std::max(window, t.window);
+            }
+            m_constraints[level * m_num_cmds + t.cmd].push_back({preceding, t.val, t.window, t.sibling});
+          }
+        }
+      }
+      m_histories.resize(m_num_levels * m_num_cmds);
+      m_last_issues.resize(m_num_levels * m_num_cmds);
+      for (int level = 0; level < m_num_levels; level++) {
+        for (int cmd = 0; cmd < m_num_cmds; cmd++) {
+          int idx = level * m_num_cmds + cmd;
+          m_histories[idx].assign(size_t(num_nodes[level]) * m_history_windows[idx], -1);
+          if (m_tracks_siblings[idx]) {
+            m_last_issues[idx].assign(num_nodes[level - 1], {});
+          }
+        }
+      }
+      m_targets.resize(m_num_levels);
+    };
+
+    /// The earliest cycle the timing constraints allow the command (-1 = no constraint)
+    Clk_t ready_clk(int command, const AddrVec_t& addr_vec) {
+      int last_level = std::min(m_scopes[command], m_num_levels - 1);
+      expand_targets(addr_vec, last_level);
+      Clk_t ready = -1;
+      for (int level = 0; level <= last_level; level++) {
+        for (const Constraint& t : m_constraints[level * m_num_cmds + command]) {
+          int idx = level * m_num_cmds + t.preceding;
+          for (int node : m_targets[level]) {
+            Clk_t past;
+            if (t.sibling) {
+              const LastIssues& last = m_last_issues[idx][node / m_fanouts[level]];
+              past = (last.child != node % m_fanouts[level]) ? last.clk : last.other_clk;
+            } else {
+              past = m_histories[idx][size_t(node) * m_history_windows[idx] + t.window - 1];
+            }
+            if (past >= 0) {
+              ready = std::max(ready, past + t.val);
+            }
+          }
+        }
+      }
+      return ready;
+    };
+
+    void issue(int command, const AddrVec_t& addr_vec, Clk_t clk) {
+      // The device updates the timing of every node below the addressed ones, whatever the scope of the command
+      expand_targets(addr_vec, m_num_levels - 1);
+      for (int level = 0; level < m_num_levels; level++) {
+        int idx = level * m_num_cmds + command;
+        if (int window = m_history_windows[idx]; window > 0) {
+          for (int node : m_targets[level]) {
+            Clk_t* history = m_histories[idx].data() + size_t(node) * window;
+            std::copy_backward(history, history + window - 1, history + window);
+            history[0] = clk;
+          }
+        }
+        if (m_tracks_siblings[idx] && addr_vec[level] != -1) {
+          for (int parent : m_targets[level - 1]) {
+            LastIssues& last = m_last_issues[idx][parent];
+            if (last.child != addr_vec[level]) {
+              last.other_clk = last.clk;
+              last.child = addr_vec[level];
+            }
+            last.clk = clk;
+          }
+        }
+      }
+    };
+
+  private:
+    void expand_targets(const AddrVec_t& addr_vec, int last_level) {
+      m_targets[0].assign(1, 0);
+      for (int level = 1; level <= last_level; level++) {
+        m_targets[level].clear();
+        for (int parent : m_targets[level - 1]) {
+          int first = parent * m_fanouts[level];
+          if (addr_vec[level] == -1) {
+            for (int node = first; node < first + m_fanouts[level]; node++) {
+              m_targets[level].push_back(node);
+            }
+          } else {
+            m_targets[level].push_back(first + addr_vec[level]);
+          }
+        }
+      }
+    };
+};
+
+// The requests of a device: reads and writes to a few rows per bank, and periodic all-bank refreshes (of every rank, or
+// of the channel if the refresh is channel-wide)
+struct Stream {
+  std::vector<AddrVec_t> addrs;
+  std::vector<int> final_commands;
+};
+
+Stream make_stream(IDRAM* dram, const Options& opt) {
+  Stream stream;
+  std::mt19937_64 rng(opt.seed);
+  const auto& count = dram->m_organization.count;
+  int num_levels = dram->m_levels.size();
+  int row_level = dram->m_levels("row");
+  // LPDDR5 only has 16-burst reads and writes
+  bool has_bl16_only = !dram->m_requests.contains("read");
+  int read_cmd = dram->m_request_translations(dram->m_requests(has_bl16_only ? "read16" : "read"));
+  int write_cmd = dram->m_request_translations(dram->m_requests(has_bl16_only ? "write16" : "write"));
+  int refresh_cmd = dram->m_requests.contains("all-bank-refresh") ? dram->m_request_translations(dram->m_requests("all-bank-refresh")) : -1;
+  int num_refreshes = (refresh_cmd != -1 && dram->m_command_scopes(refresh_cmd) >= 1) ? count[1] : 1;
+  std::bernoulli_distribution is_write(opt.write_ratio);
+
+  for (size_t i = 0; i < opt.num_requests; i++) {
+    if (refresh_cmd != -1 && opt.refresh_interval > 0 && i > 0 && i % opt.refresh_interval == 0) {
+      for (int r = 0; r < num_refreshes; r++) {
+        AddrVec_t addr_vec(num_levels, -1);
+        addr_vec[0] = 0;
+        if (num_refreshes > 1) {
+          addr_vec[1] = r;
+        }
+        stream.addrs.push_back(addr_vec);
+        stream.final_commands.push_back(refresh_cmd);
+      }
+    }
+    AddrVec_t addr_vec(num_levels, 0);
+    for (int level = 1; level < num_levels; level++) {
+      int size = (level == row_level) ? std::min(count[level], opt.rows_per_bank) : count[level];
+      addr_vec[level] = std::uniform_int_distribution<int>(0, size - 1)(rng);
+    }
+    stream.addrs.push_back(addr_vec);
+    stream.final_commands.push_back(is_write(rng) ? write_cmd : read_cmd);
+  }
+  return stream;
+}
+
+struct IssuedCommand {
+  Clk_t clk;
+  int command;
+  int request;
+};
+
+struct Probe {
+  Clk_t clk;
+  int final_command;
+  int command;
+  int request;
+};
+
+struct Timeline {
+  std::vector<IssuedCommand> commands;
+  std::vector<Probe> probes;
+  Clk_t cycles = 0;
+  uint64_t hash = 0xcbf29ce484222325ull;
+  size_t ready_mismatches = 0;          // check_ready() disagrees with the timing model
+  size_t ready_clk_mismatches = 0;      // get_ready_clk() disagrees with the timing model
+  std::string first_mismatch;
+};
+
+void hash_value(uint64_t& hash, int64_t value) {
+  // FNV-1a over the bytes of value
+  for (int i = 0; i < 8; i++) {
+    hash ^= (value >> (8 * i)) & 0xff;
+    hash *= 0x100000001b3ull;
+  }
+}
+
+/**
+ * @brief    Serves the requests with a window of window requests: each cycle, every request of the window probes the
+ *           prerequisite of its command, and the oldest ready one is issued. Only the oldest request to a bank may
+ *           open or close its rows, so that two requests to different rows cannot close each other's forever.
+ *
+ */
+Timeline drive(IDRAM* dram, const Stream& stream, const Options& opt) {
+  constexpr Clk_t MAX_STALL_CYCLES = 1000000;
+  TimingModel model(dram);
+  Timeline timeline;
+  std::deque<int> window;
+  size_t next = 0;
+  int row_level = dram->m_levels("row");
+  Clk_t clk = 0;
+  Clk_t last_served_clk = 0;
+
+  auto is_same_bank = [row_level](const AddrVec_t& a, const AddrVec_t& b) {
+    for (int level = 0; level < row_level; level++) {
+      if (a[level] != b[level] && a[level] != -1 && b[level] != -1) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  while (next < stream.addrs.size() || !window.empty()) {
+    while ((int) window.size() < opt.window && next < stream.addrs.size()) {
+      window.push_back(next++);
+    }
+
+    int issued = -1;
+    int issued_command = -1;
+    for (size_t i = 0; i < window.size(); i++) {
+      int request = window[i];
+      const AddrVec_t& addr_vec = stream.addrs[request];
+      int command = dram->get_preq_command(stream.final_commands[request], addr_vec);
+      bool ready = dram->check_ready(command, addr_vec);
+      timeline.probes.push_back({clk, stream.final_commands[request], command, request});
+
+      Clk_t expected_clk = model.ready_clk(command, addr_vec);
+      Clk_t ready_clk = dram->get_ready_clk(command, addr_vec);
+      bool is_ready_mismatch = ready != (clk >= expected_clk);
+      bool is_ready_clk_mismatch = ready_clk != expected_clk;
+      timeline.ready_mismatches += is_ready_mismatch;
+      timeline.ready_clk_mismatches += is_ready_clk_mismatch;
+      if ((is_ready_mismatch || is_ready_clk_mismatch) && timeline.first_mismatch.empty()) {
+        timeline.first_mismatch = fmt::format("cycle {}: {} to [{}] ready={} ready_clk={}, model ready_clk={}", clk,
+                                              dram->m_commands(command), fmt::join(addr_vec, ", "), ready, ready_clk, expected_clk);
+      }
+
+      if (ready && issued == -1) {
+        bool is_owner = command == stream.final_commands[request] ||
+                        std::none_of(window.begin(), window.begin() + i, [&](int older) { return is_same_bank(stream.addrs[older], addr_vec); });
+        if (is_owner) {
+          issued = i;
+          issued_command = command;
+        }
+      }
+    }
+
+    if (issued != -1) {
+      int request = window[issued];
+      const AddrVec_t& addr_vec = stream.addrs[request];
+      dram->issue_command(issued_command, addr_vec);
+      model.issue(issued_command, addr_vec, clk);
+      timeline.commands.push_back({clk, issued_command, request});
+      hash_value(timeline.hash, clk);
+      hash_value(timeline.hash, issued_command);
+      for (int value : addr_vec) {
+        hash_value(timeline.hash, value);
+      }
+      if (issued_command == stream.final_commands[request]) {
+        window.erase(window.begin() + issued);
+        last_served_clk = clk;
+      }
+    }
+    if (clk - last_served_clk > MAX_STALL_CYCLES) {
+      int oldest = window.front();
+      int command = dram->get_preq_command(stream.final_commands[oldest], stream.addrs[oldest]);
+      throw std::runtime_error(fmt::format("No request was served for {} cycles at cycle {} (the oldest one waits for {} to [{}])!",
+                                           MAX_STALL_CYCLES, clk, dram->m_commands(command), fmt::join(stream.addrs[oldest], ", ")));
+    }
+
+    dram->tick();
+    clk++;
+  }
+  timeline.cycles = clk;
+  return timeline;
+}
+
+enum class Replay { Ticks, Issue, CheckReady, PreqCommand };
+
+/**
+ * @brief    Replays the timeline on a new device and returns the seconds it took. Each replay adds one kind of call to
+ *           the previous one, so the difference of two replays is the time of the calls it adds.
+ *
+ */
+double replay(const DeviceSpec& spec, const Variant& variant, const Stream& stream, const Timeline& timeline, Replay kind) {
+  std::unique_ptr<IDRAM> dram = make_device(spec, variant);
+  size_t next_command = 0;
+  size_t next_probe = 0;
+  size_t sink = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (Clk_t clk = 0; clk < timeline.cycles; clk++) {
+    if (kind == Replay::CheckReady || kind == Replay::PreqCommand) {
+      for (; next_probe < timeline.probes.size() && timeline.probes[next_probe].clk == clk; next_probe++) {
+        const Probe& probe = timeline.probes[next_probe];
+        const AddrVec_t& addr_vec = stream.addrs[probe.request];
+        int command = probe.command;
+        if (kind == Replay::PreqCommand) {
+          command = dram->get_preq_command(probe.final_command, addr_vec);
+        }
+        sink += dram->check_ready(command, addr_vec);
+      }
+    }
+    if (kind != Replay::Ticks) {
+      for (; next_command < timeline.commands.size() && timeline.commands[next_command].clk == clk; next_command++) {
+        const IssuedCommand& issued = timeline.commands[next_command];
+        dram->issue_command(issued.command, stream.addrs[issued.request]);
+      }
+    }
+    dram->tick();
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  static volatile size_t g_sink = 0;
+  g_sink = g_sink + sink;
+  return seconds;
+}
+
+struct Result {
+  std::string dram;
+  std::string variant;
+  size_t num_commands = 0;
+  size_t num_probes = 0;
+  Clk_t cycles = 0;
+  uint64_t hash = 0;
+  size_t ready_mismatches = 0;
+  size_t ready_clk_mismatches = 0;
+  bool timeline_matches = true;         // Same timeline as the reference variant
+  std::string golden;                   // "match", "differ" or "" (no golden timeline)
+  double issue_ns = 0;
+  double check_ready_ns = 0;
+  double preq_command_ns = 0;
+  std::string error;
+
+  bool ok() const {
+    return error.empty() && ready_mismatches == 0 && ready_clk_mismatches == 0 && timeline_matches && golden != "differ";
+  };
+};
+
+void bench(Result& r, const Options& opt, const DeviceSpec& spec, const Variant& variant, const Stream& stream, const Timeline& timeline) {
+  std::vector<double> best(4, 1e30);
+  for (int i = 0; i < opt.repeats; i++) {
+    for (Replay kind : {Replay::Ticks, Replay::Issue, Replay::CheckReady, Replay::PreqCommand}) {
+      double& b = best[(int) kind];
+      b = std::min(b, replay(spec, variant, stream, timeline, kind));
+    }
+  }
+  auto ns_per = [](double seconds, size_t calls) { return calls ? std::max(0.0, seconds) * 1e9 / calls : 0.0; };
+  r.issue_ns = ns_per(best[(int) Replay::Issue] - best[(int) Replay::Ticks], timeline.commands.size());
+  r.check_ready_ns = ns_per(best[(int) Replay::CheckReady] - best[(int) Replay::Issue], timeline.probes.size());
+  r.preq_command_ns = ns_per(best[(int) Replay::PreqCommand] - best[(int) Replay::CheckReady], timeline.probes.size());
+}
+
+void print_text(const std::vector<Result>& results) {
+  fmt::print("{:<10} {:<11} {:>9} {:>10} {:>10} {:>18} {:>10} {:>7} {:>6} {:>9} {:>9} {:>9}\n",
+             "dram", "variant", "commands", "probes", "cycles", "hash", "mismatch", "same", "golden",
+             "issue_ns", "ready_ns", "preq_ns");
+  for (const Result& r : results) {
+    if (!r.error.empty()) {
+      fmt::print("{:<10} {:<11} error: {}\n", r.dram, r.variant, r.error);
+      continue;
+    }
+    fmt::print("{:<10} {:<11} {:>9} {:>10} {:>10} {:>#18x} {:>10} {:>7} {:>6} {:>9.1f} {:>9.1f} {:>9.1f}\n",
+               r.dram, r.variant, r.num_commands, r.num_probes, r.cycles, r.hash,
+               r.ready_mismatches + r.ready_clk_mismatches, r.timeline_matches ? "yes" : "NO",
+               r.golden.empty() ? "-" : r.golden, r.issue_ns, r.check_ready_ns, r.preq_command_ns);
+  }
+}
+
+void print_json(const Options& opt, const std::vector<Result>& results) {
+  fmt::print("{{\n  \"config\": {{\"num_requests\": {}, \"window\": {}, \"rows_per_bank\": {}, \"write_ratio\": {}, \"refresh_interval\": {}, \"seed\": {}, \"repeats\": {}}},\n",
+             opt.num_requests, opt.window, opt.rows_per_bank, opt.write_ratio, opt.refresh_interval, opt.seed, opt.repeats);
+  fmt::print("  \"results\": [\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result& r = results[i];
+    const char* sep = (i + 1 < results.size()) ? "," : "";
+    if (!r.error.empty()) {
+      fmt::print("    {{\"dram\": \"{}\", \"variant\": \"{}\", \"error\": \"{}\"}}{}\n", r.dram, r.variant, r.error, sep);
+      continue;
+    }
+    fmt::print("    {{\"dram\": \"{}\", \"variant\": \"{}\", \"commands\": {}, \"probes\": {}, \"cycles\": {}, \"hash\": \"{:#x}\", "
+               "\"ready_mismatches\": {}, \"ready_clk_mismatches\": {}, \"timeline_matches\": {}, \"golden\": \"{}\", "
+               "\"issue_ns\": {:.2f}, \"check_ready_ns\": {:.2f}, \"preq_command_ns\": {:.2f}}}{}\n",
+               r.dram, r.variant, r.num_commands, r.num_probes, r.cycles, r.hash, r.ready_mismatches, r.ready_clk_mismatches,
+               r.timeline_matches, r.golden, r.issue_ns, r.check_ready_ns, r.preq_command_ns, sep);
+  }
+  fmt::print("  ]\n}}\n");
+}
+
+}       // namespace
+
+
+int main(int argc, char* argv[]) {
+  std::vector<std::string> all_drams;
+  for (const DeviceSpec& spec : DEVICES) {
+    all_drams.push_back(spec.dram);
+  }
+  std::vector<std::string> all_variants;
+  for (const Variant& variant : VARIANTS) {
+    all_variants.push_back(variant.name);
+  }
+
+  argparse::ArgumentParser program("ramulator_dram_harness", "2.0");
+  program.add_argument("-d", "--drams").nargs(argparse::nargs_pattern::at_least_one)
+    .default_value(all_drams)
+    .help("DRAM specs to drive.");
+  program.add_argument("-v", "--variants").nargs(argparse::nargs_pattern::at_least_one)
+    .default_value(all_variants)
+    .help("Layouts of the timing state: tree, tree+cache, flat, flat+cache. The first one is the reference of the others.");
+  program.add_argument("--num_requests").scan<'u', size_t>().default_value((size_t) 20000)
+    .help("Reads and writes per device.");
+  program.add_argument("--window").scan<'i', int>().default_value(8)
+    .help("Requests probed every cycle; the oldest ready one issues its command.");
+  program.add_argument("--rows_per_bank").scan<'i', int>().default_value(4)
+    .help("Rows the requests of each bank go to (fewer rows, more row hits).");
+  program.add_argument("--write_ratio").scan<'g', double>().default_value(0.3)
+    .help("Fraction of writes.");
+  program.add_argument("--refresh_interval").scan<'i', int>().default_value(256)
+    .help("Requests between two all-bank refreshes of every rank (0 = no refresh).");
+  program.add_argument("--seed").scan<'u', uint64_t>().default_value((uint64_t) 1)
+    .help("Seed of the requests.");
+  program.add_argument("--repeats").scan<'i', int>().default_value(3)
+    .help("Replays of each timeline; the fastest one is reported.");
+  program.add_argument("--no_bench").default_value(false).implicit_value(true)
+    .help("Only check the devices, without timing the replays.");
+  program.add_argument("--golden").default_value(std::string(""))
+    .help("Compare the timelines with the golden ones of this file.");
+  program.add_argument("--record").default_value(std::string(""))
+    .help("Write the timelines of the reference variant to this file as golden ones.");
+  program.add_argument("--json").default_value(false).implicit_value(true)
+    .help("Print the results as JSON.");
+
+  Options opt;
+  try {
+    program.parse_args(argc, argv);
+    opt.drams = program.get<std::vector<std::string>>("--drams");
+    opt.variants = program.get<std::vector<std::string>>("--variants");
+    opt.num_requests = program.get<size_t>("--num_requests");
+    opt.window = program.get<int>("--window");
+    opt.rows_per_bank = program.get<int>("--rows_per_bank");
+    opt.write_ratio = program.get<double>("--write_ratio");
+    opt.refresh_interval = program.get<int>("--refresh_interval");
+    opt.seed = program.get<uint64_t>("--seed");
+    opt.repeats = program.get<int>("--repeats");
+    opt.bench = !program.get<bool>("--no_bench");
+    opt.golden_path = program.get<std::string>("--golden");
+    opt.record_path = program.get<std::string>("--record");
+    if (opt.num_requests < 1 || opt.window < 1 || opt.rows_per_bank < 1 || opt.repeats < 1) {
+      throw std::runtime_error("num_requests, window, rows_per_bank and repeats must be positive!");
+    }
+  }
+  catch (const std::runtime_error& err) {
+    spdlog::error(err.what());
+    std::cerr << program;
+    std::exit(1);
+  }
+
+  YAML::Node golden;
+  if (!opt.golden_path.empty()) {
+    golden = YAML::LoadFile(opt.golden_path);
+  }
+  YAML::Node recorded;
+
+  std::vector<Result> results;
+  for (const std::string& dram_name : opt.drams) {
+    auto spec = std::find_if(DEVICES.begin(), DEVICES.end(), [&](const DeviceSpec& s) { return s.dram == dram_name; });
+    if (spec == DEVICES.end()) {
+      results.push_back(Result{dram_name, "-"});
+      results.back().error = fmt::format("Unknown DRAM \"{}\"", dram_name);
+      continue;
+    }
+
+    Stream stream;
+    uint64_t reference_hash = 0;
+    bool has_reference = false;
+    for (const std::string& variant_name : opt.variants) {
+      Result& r = results.emplace_back(Result{dram_name, variant_name});
+      auto variant = std::find_if(VARIANTS.begin(), VARIANTS.end(), [&](const Variant& v) { return v.name == variant_name; });
+      try {
+        if (variant == VARIANTS.end()) {
+          throw std::runtime_error(fmt::format("Unknown variant \"{}\"", variant_name));
+        }
+        std::unique_ptr<IDRAM> dram = make_device(*spec, *variant);
+        if (stream.addrs.empty()) {
+          stream = make_stream(dram.get(), opt);
+        }
+        Timeline timeline = drive(dram.get(), stream, opt);
+        r.num_commands = timeline.commands.size();
+        r.num_probes = timeline.probes.size();
+        r.cycles = timeline.cycles;
+        r.hash = timeline.hash;
+        r.ready_mismatches = timeline.ready_mismatches;
+        r.ready_clk_mismatches = timeline.ready_clk_mismatches;
+        if (!timeline.first_mismatch.empty()) {
+          spdlog::warn("{} ({}): first mismatch with the timing model at {}", dram_name, variant_name, timeline.first_mismatch);
+        }
+
+        if (!has_reference) {
+          reference_hash = timeline.hash;
+          has_reference = true;
+          if (!opt.record_path.empty()) {
+            recorded[dram_name]["commands"] = r.num_commands;
+            recorded[dram_name]["cycles"] = r.cycles;
+            recorded[dram_name]["hash"] = fmt::format("{:#x}", r.hash);
+          }
+        }
+        r.timeline_matches = (timeline.hash == reference_hash);
+        if (golden && golden[dram_name]) {
+          bool matches = golden[dram_name]["hash"].as<std::string>() == fmt::format("{:#x}", r.hash) &&
+                         golden[dram_name]["commands"].as<size_t>() == r.num_commands &&
+                         golden[dram_name]["cycles"].as<Clk_t>() == r.cycles;
+          r.golden = matches ? "match" : "differ";
+        }
+
+        if (opt.bench) {
+          bench(r, opt, *spec, *variant, stream, timeline);
+        }
+      } catch (const std::exception& err) {
+        r.error = err.what();
+      }
+    }
+  }
+
+  if (!opt.record_path.empty()) {
+    std::ofstream out(opt.record_path);
+    YAML::Emitter emitter;
+    emitter << recorded;
+    out << "# Golden command timelines of ramulator_dram_harness (seed " << opt.seed << ", " << opt.num_requests << " requests)\n";
+    out << emitter.c_str() << std::endl;
+  }
+
+  if (program.get<bool>("--json")) {
+    print_json(opt, results);
+  } else {
+    print_text(results);
+  }
+  bool has_failure = std::any_of(results.begin(), results.end(), [](const Result& r) { return !r.ok(); });
+  return has_failure ? 1 : 0;
+}
@@ -0,0 +1,268 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <argparse/argparse.hpp>
+#include <spdlog/spdlog.h>
+
+#include "base/exception.h"
+#include "frontend/impl/memory_trace/mapped_trace.h"
+#include "frontend/impl/memory_trace/binary_trace_format.h"
+#include "dram_controller/impl/plugin/command_trace_format.h"
+
+// Converts the text traces of LoadStoreTrace (LD/ST), ReadWriteTrace (R/W) and SimpleO3 into the binary trace format,
+// and binary traces back into text (including the LLCMiss traces SimpleO3 records). Also converts the binary command traces of TraceRecorder into its text format.
+
+namespace {
+
+using namespace Ramulator;
+
+BinaryTrace::Kind parse_kind(const std::string& kind) {
+  if (kind == "LoadStore") {
+    return BinaryTrace::Kind::LoadStore;
+  } else if (kind == "ReadWrite") {
+    return BinaryTrace::Kind::ReadWrite;
+  } else if (kind == "SimpleO3") {
+    return BinaryTrace::Kind::SimpleO3;
+  } else if (kind == "LLCMiss") {
+    return BinaryTrace::Kind::LLCMiss;
+  }
+  throw std::runtime_error(fmt::format("Unrecognized trace kind {}!", kind));
+}
+
+// Calls record(line) for every non-blank line of the text trace at path
+template<typename F>
+void for_each_line(const std::string& path, F&& record) {
+  MappedFile file(path);
+  const char* cursor = file.begin();
+  size_t line_number = 0;
+  while (cursor != file.end()) {
+    const char* line_end = static_cast<const char*>(memchr(cursor, '\n', file.end() - cursor));
+    if (line_end == nullptr) {
+      line_end = file.end();
+    }
+    TraceLineScanner line(cursor, line_end);
+    cursor = line_end == file.end() ? line_end : line_end + 1;
+    line_number++;
+    if (line.at_end()) {
+      continue;
+    }
+    if (!record(line) || !line.at_end()) {
+      throw ConfigurationError("Trace {} format invalid at line {}!", path, line_number);
+    }
+  }
+}
+
+// Reads the optional leading timestamp of a LoadStore or ReadWrite line (-1 if it has none)
+int64_t timestamp(TraceLineScanner& line) {
+  int64_t timestamp;
+  return line.integer(timestamp) ? timestamp : -1;
+}
+
+void to_binary(const std::string& input, const std::string& output, BinaryTrace::Kind kind) {
+  // The address vector levels of a ReadWrite trace and whether a trace is timestamped are those of its first record
+  std::unique_ptr<BinaryTrace::Writer> writer;
+  if (kind == BinaryTrace::Kind::SimpleO3) {
+    writer = std::make_unique<BinaryTrace::Writer>(output, kind);
+  }
+
+  switch (kind) {
+    case BinaryTrace::Kind::LoadStore: {
+      for_each_line(input, [&](TraceLineScanner& line) {
+        int64_t ts = timestamp(line);
+        std::string_view type = line.token();
+        int64_t addr;
+        if ((type != "LD" && type != "ST") || !line.integer(addr)) {
+          return false;
+        }
+        if (!writer) {
+          writer = std::make_unique<BinaryTrace::Writer>(output, kind, 0, ts != -1);
+        }
+        writer->load_store(type == "ST", addr, ts);
+        return true;
+      });
+      break;
+    }
+    case BinaryTrace::Kind::ReadWrite: {
+      for_each_line(input, [&](TraceLineScanner& line) {
+        int64_t ts = timestamp(line);
+        std::string_view type = line.token();
+        if (type != "R" && type != "W") {
+          return false;
+        }
+        AddrVec_t addr_vec;
+        do {
+          int64_t addr;
+          if (addr_vec.size() == AddrVec_t::capacity() || !line.integer(addr)) {
+            return false;
+          }
+          addr_vec.push_back(addr);
+        } while (line.consume(','));
+        if (!writer) {
+          writer = std::make_unique<BinaryTrace::Writer>(output, kind, addr_vec.size(), ts != -1);
+        }
+        writer->read_write(type == "W", addr_vec, ts);
+        return true;
+      });
+      break;
+    }
+    case BinaryTrace::Kind::SimpleO3: {
+      for_each_line(input, [&](TraceLineScanner& line) {
+        int64_t bubble_count, load_addr, store_addr = -1;
+        if (!line.integer(bubble_count) || !line.integer(load_addr)) {
+          return false;
+        }
+        if (!line.at_end() && !line.integer(store_addr)) {
+          return false;
+        }
+        writer->simple_o3(bubble_count, load_addr, store_addr);
+        return true;
+      });
+      break;
+    }
+    case BinaryTrace::Kind::LLCMiss: {
+      throw ConfigurationError("LLCMiss traces are recorded by SimpleO3, and only converted to text (--to_text)!");
+    }
+  }
+  if (!writer) {
+    throw ConfigurationError("Trace {} is empty!", input);
+  }
+  writer->close();
+}
+
+void to_text(const std::string& input, const std::string& output, BinaryTrace::Kind kind) {
+  BinaryTrace::Reader reader(input, kind);
+  FILE* file = std::fopen(output.c_str(), "w");
+  if (file == nullptr) {
+    throw ConfigurationError("Trace {} cannot be opened for writing!", output);
+  }
+
+  bool is_timestamped = reader.header().is_timestamped();
+  for (uint64_t i = 0; i < reader.header().num_records; i++) {
+    switch (kind) {
+      case BinaryTrace::Kind::LoadStore: {
+        bool is_write;
+        Addr_t addr;
+        reader.load_store(is_write, addr);
+        if (is_timestamped) {
+          fmt::print(file, "{} ", reader.timestamp());
+        }
+        fmt::print(file, "{} {}\n", is_write ? "ST" : "LD", addr);
+        break;
+      }
+      case BinaryTrace::Kind::ReadWrite: {
+        bool is_write;
+        AddrVec_t addr_vec;
+        reader.read_write(is_write, addr_vec);
+        if (is_timestamped) {
+          fmt::print(file, "{} ", reader.timestamp());
+        }
+        fmt::print(file, "{} {}\n", is_write ? "W" : "R", fmt::join(addr_vec, ","));
+        break;
+      }
+      case BinaryTrace::Kind::SimpleO3: {
+        int bubble_count;
+        Addr_t load_addr, store_addr;
+        reader.simple_o3(bubble_count, load_addr, store_addr);
+        if (store_addr == -1) {
+          fmt::print(file, "{} {}\n", bubble_count, load_addr);
+        } else {
+          fmt::print(file, "{} {} {}\n", bubble_count, load_addr, store_addr);
+        }
+        break;
+      }
+      case BinaryTrace::Kind::LLCMiss: {
+        // "<core_id> <R|WB|PF> <addr> <gap>", then "B <reads_in_flight>" if the record is blocked
+        static constexpr const char* OPS[] = {"R", "WB", "PF"};
+        BinaryTrace::LLCMissRecord record;
+        reader.llc_miss(record);
+        if (record.blocked) {
+          fmt::print(file, "{} {} {} {} B {}\n", record.core_id, OPS[int(record.op)], record.addr, record.gap, record.reads_in_flight);
+        } else {
+          fmt::print(file, "{} {} {} {}\n", record.core_id, OPS[int(record.op)], record.addr, record.gap);
+        }
+        break;
+      }
+    }
+  }
+  std::fclose(file);
+}
+
+// The text format of TraceRecorder: "<clk>, <command>, <addr_vec...>" per line
+void command_trace_to_text(const std::string& input, const std::string& output) {
+  CommandTrace::Reader reader(input);
+  FILE* file = std::fopen(output.c_str(), "w");
+  if (file == nullptr) {
+    throw ConfigurationError("Trace {} cannot be opened for writing!", output);
+  }
+
+  CommandTrace::Record record;
+  while (reader.next(record)) {
+    fmt::print(file, "{}, {}, {}\n", record.clk, reader.command_names()[record.command], fmt::join(record.addr_vec, ", "));
+  }
+  std::fclose(file);
+}
+
+size_t file_size(const std::string& path) {
+  return MappedFile(path).size();
+}
+
+}       // namespace
+
+
+int main(int argc, char* argv[]) {
+  argparse::ArgumentParser program("ramulator_trace_convert", "2.0");
+  program.add_argument("-i", "--input").required()
+    .help("Trace to convert.");
+  program.add_argument("-o", "--output").required()
+    .help("Where to write the converted trace.");
+  program.add_argument("-k", "--kind").default_value(std::string("LoadStore"))
+    .help("Records of the trace: LoadStore (LD/ST), ReadWrite (R/W), SimpleO3, LLCMiss (--to_text only), or Command (TraceRecorder, --to_text only).");
+  program.add_argument("--to_text").default_value(false).implicit_value(true)
+    .help("Convert a binary trace back to text.");
+
+  std::string input, output;
+  BinaryTrace::Kind kind;
+  bool is_command_trace = false;
+  try {
+    program.parse_args(argc, argv);
+    input = program.get<std::string>("--input");
+    output = program.get<std::string>("--output");
+    is_command_trace = program.get<std::string>("--kind") == "Command";
+    if (is_command_trace && !program.get<bool>("--to_text")) {
+      throw std::runtime_error("Command traces are only converted to text (--to_text)!");
+    }
+    if (!is_command_trace) {
+      kind = parse_kind(program.get<std::string>("--kind"));
+    }
+  }
+  catch (const std::runtime_error& err) {
+    spdlog::error(err.what());
+    std::cerr << program;
+    std::exit(1);
+  }
+
+  try {
+    auto start = std::chrono::steady_clock::now();
+    if (is_command_trace) {
+      command_trace_to_text(input, output);
+    } else if (program.get<bool>("--to_text")) {
+      to_text(input, output, kind);
+    } else {
+      to_binary(input, output, kind);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t input_size = file_size(input);
+    size_t output_size = file_size(output);
+    spdlog::info("Converted {} ({} bytes) to {} ({} bytes, {:.2f}x) in {:.3f} s.",
+                 input, input_size, output, output_size, output_size ? double(input_size) / output_size : 0.0, seconds);
+  }
+  catch (const std::runtime_error& err) {
+    spdlog::error(err.what());
+    return 1;
+  }
+  return 0;
+}
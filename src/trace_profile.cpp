@@ -0,0 +1,496 @@
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <cmath>
+
+#include <argparse/argparse.hpp>
+#include <spdlog/spdlog.h>
+
+#include "base/base.h"
+#include "base/config.h"
+#include "base/exception.h"
+#include "dram/dram.h"
+#include "addr_mapper/addr_mapper.h"
+#include "frontend/frontend.h"
+#include "memory_system/memory_system.h"
+#include "frontend/impl/memory_trace/trace_accesses.h"
+
+// Profiles the DRAM locality of a trace under the address mapping of a simulator configuration, in one pass over the
+// trace and in bounded memory: the row-buffer hits per bank, the row reuse distances, the spatial locality within the
+// ECC codewords and the read/write mix over time.
+
+namespace {
+
+using namespace Ramulator;
+namespace fs = std::filesystem;
+
+uint64_t mix(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ull;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+// The power-of-two bin of a distance: 0, 1, 2-3, 4-7, ...
+size_t distance_bin(uint64_t distance) {
+  return distance == 0 ? 0 : 64 - __builtin_clzll(distance);
+}
+
+std::string bin_name(size_t bin) {
+  if (bin <= 1) {
+    return std::to_string(bin);
+  }
+  return fmt::format("{}-{}", uint64_t(1) << (bin - 1), (uint64_t(1) << bin) - 1);
+}
+
+/**
+ * @brief    Estimates the row reuse distances of the banks in bounded memory
+ * @details
+ * The reuse distance of an access is the number of other rows of its bank accessed since the previous access of its
+ * row, so an access is a row-buffer hit with d+1 row buffers per bank (LRU) if its distance is at most d, and distance 0
+ * is the open-row hit. The distances are measured on the rows whose hash is below a threshold (fixed-size SHARDS
+ * sampling): the threshold is lowered, dropping the rows with the largest hashes, whenever more than max_samples rows
+ * are sampled, and every sampled access counts for 1/R accesses at a distance scaled by 1/R, with R the current
+ * sampling rate. Per bank, a Fenwick tree over the stamps of the last accesses of the sampled rows counts the rows
+ * accessed since a stamp. The stamps are renumbered when they run out.
+ *
+ */
+class RowReuseSketch {
+  private:
+    struct Bank {
+      std::unordered_map<int64_t, uint32_t> stamps;   // The stamp of the last access of every sampled row
+      std::vector<int32_t> tree = std::vector<int32_t>(65, 0);
+      uint32_t next_stamp = 1;
+
+      void add(uint32_t stamp, int32_t delta) {
+        for (; stamp < tree.size(); stamp += stamp & -stamp) {
+          tree[stamp] += delta;
+        }
+      };
+
+      // The number of sampled rows last accessed at or before stamp
+      size_t prefix(uint32_t stamp) const {
+        int64_t sum = 0;
+        for (; stamp > 0; stamp -= stamp & -stamp) {
+          sum += tree[stamp];
+        }
+        return sum;
+      };
+
+      void renumber() {
+        std::vector<std::pair<uint32_t, int64_t>> order;
+        order.reserve(stamps.size());
+        for (const auto& [row, stamp] : stamps) {
+          order.emplace_back(stamp, row);
+        }
+        std::sort(order.begin(), order.end());
+        tree.assign(std::max<size_t>(64, 2 * order.size()) + 1, 0);
+        next_stamp = 1;
+        for (const auto& [stamp, row] : order) {
+          stamps[row] = next_stamp;
+          add(next_stamp++, 1);
+        }
+      };
+    };
+
+    std::vector<Bank> m_banks;
+    std::set<std::tuple<uint64_t, uint64_t, int64_t>> m_samples;    // (hash, bank, row) of the sampled rows
+    size_t m_max_samples;
+    uint64_t m_threshold = ~uint64_t(0);                              // Rows whose hash is below are sampled
+
+  public:
+    std::vector<double> histogram;    // Estimated reuses per distance bin
+    double cold = 0;                  // Estimated first accesses of a row
+
+    RowReuseSketch(size_t num_banks, size_t max_samples): m_banks(num_banks), m_max_samples(max_samples) {};
+
+    double sampling_rate() const { return std::ldexp(double(m_threshold), -64); };
+
+    void access(uint64_t bank_id, int64_t row) {
+      uint64_t hash = mix(bank_id * 0x9E3779B97F4A7C15ull ^ uint64_t(row));
+      if (hash >= m_threshold) {
+        return;
+      }
+      double rate = sampling_rate();
+      Bank& bank = m_banks[bank_id];
+      auto it = bank.stamps.find(row);
+      if (it == bank.stamps.end()) {
+        cold += 1.0 / rate;
+        m_samples.emplace(hash, bank_id, row);
+      } else {
+        uint64_t distance = bank.stamps.size() - bank.prefix(it->second);
+        size_t bin = distance_bin(uint64_t(distance / rate));
+        if (bin >= histogram.size()) {
+          histogram.resize(bin + 1, 0);
+        }
+        histogram[bin] += 1.0 / rate;
+        bank.add(it->second, -1);
+        bank.stamps.erase(it);
+      }
+      if (bank.next_stamp == bank.tree.size()) {
+        bank.renumber();
+      }
+      bank.stamps[row] = bank.next_stamp;
+      bank.add(bank.next_stamp++, 1);
+
+      while (m_samples.size() > m_max_samples) {
+        auto largest = std::prev(m_samples.end());
+        auto [evicted_hash, evicted_bank, evicted_row] = *largest;
+        Bank& evicted = m_banks[evicted_bank];
+        evicted.add(evicted.stamps.at(evicted_row), -1);
+        evicted.stamps.erase(evicted_row);
+        m_threshold = evicted_hash;
+        m_samples.erase(largest);
+      }
+    };
+
+    size_t num_samples() const { return m_samples.size(); };
+};
+
+
+/**
+ * @brief    Tracks the lines the accesses touch within their codewords while the codewords are active
+ * @details
+ * A codeword stays active while it is among the max_active codewords touched last. Its episode (from its first access
+ * to its eviction or the end of the trace) is then summarized: the accesses, the distinct lines read or written, and
+ * whether its writes covered only part of it, so that an ECC over the whole codeword has to read it to update its
+ * parity.
+ *
+ */
+class CodewordTracker {
+  public:
+    struct Episode {
+      uint64_t codeword = 0;
+      size_t accesses = 0;
+      std::vector<bool> touched;
+      std::vector<bool> written;
+    };
+
+    struct Totals {
+      size_t episodes = 0;
+      size_t accesses = 0;
+      size_t lines_touched = 0;
+      size_t write_episodes = 0;
+      size_t partial_write_episodes = 0;
+      size_t split_episodes = 0;      // Whose touched lines map to more than one row of one bank
+      size_t rows = 0;                // Rows of one bank the touched lines map to, summed over the episodes
+    };
+
+  private:
+    std::list<Episode> m_lru;         // Most recently touched first
+    std::unordered_map<uint64_t, std::list<Episode>::iterator> m_active;
+    size_t m_max_active;
+    Addr_t m_codeword_bytes;
+    Addr_t m_line_bytes;
+    size_t m_lines_per_codeword;
+    std::function<std::pair<uint64_t, int64_t>(Addr_t)> m_locate;
+
+  public:
+    Totals totals;
+
+    CodewordTracker(size_t max_active, Addr_t codeword_bytes, Addr_t line_bytes, std::function<std::pair<uint64_t, int64_t>(Addr_t)> locate):
+    m_max_active(max_active), m_codeword_bytes(codeword_bytes), m_line_bytes(line_bytes),
+    m_lines_per_codeword(std::max<Addr_t>(1, (codeword_bytes + line_bytes - 1) / line_bytes)), m_locate(std::move(locate)) {};
+
+    size_t lines_per_codeword() const { return m_lines_per_codeword; };
+
+    void access(Addr_t addr, bool is_write) {
+      uint64_t codeword = uint64_t(addr) / m_codeword_bytes;
+      size_t line = (uint64_t(addr) % m_codeword_bytes) / m_line_bytes;
+      auto it = m_active.find(codeword);
+      if (it == m_active.end()) {
+        if (m_active.size() == m_max_active) {
+          close(m_lru.back());
+          m_active.erase(m_lru.back().codeword);
+          m_lru.pop_back();
+        }
+        m_lru.push_front({codeword, 0, std::vector<bool>(m_lines_per_codeword), std::vector<bool>(m_lines_per_codeword)});
+        it = m_active.emplace(codeword, m_lru.begin()).first;
+      } else if (it->second != m_lru.begin()) {
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+      }
+      Episode& episode = *it->second;
+      episode.accesses++;
+      episode.touched[line] = true;
+      if (is_write) {
+        episode.written[line] = true;
+      }
+    };
+
+    void close_all() {
+      for (const Episode& episode : m_lru) {
+        close(episode);
+      }
+      m_lru.clear();
+      m_active.clear();
+    };
+
+  private:
+    void close(const Episode& episode) {
+      totals.episodes++;
+      totals.accesses += episode.accesses;
+      size_t num_written = std::count(episode.written.begin(), episode.written.end(), true);
+      if (num_written > 0) {
+        totals.write_episodes++;
+        totals.partial_write_episodes += num_written < m_lines_per_codeword;
+      }
+      std::set<std::pair<uint64_t, int64_t>> rows;
+      for (size_t line = 0; line < m_lines_per_codeword; line++) {
+        if (episode.touched[line]) {
+          totals.lines_touched++;
+          rows.insert(m_locate(Addr_t(episode.codeword) * m_codeword_bytes + Addr_t(line) * m_line_bytes));
+        }
+      }
+      totals.split_episodes += rows.size() > 1;
+      totals.rows += rows.size();
+    };
+};
+
+
+struct BankCounts {
+  size_t accesses = 0;
+  size_t writes = 0;
+  size_t row_hits = 0;
+  bool has_open_row = false;
+  int64_t open_row = 0;
+};
+
+struct WindowCounts {
+  size_t accesses = 0;
+  size_t writes = 0;
+  size_t row_hits = 0;
+  std::unordered_set<uint64_t> banks;
+};
+
+// A mapping is a YAML file holding an AddrMapper node, or the name of an implementation without parameters
+YAML::Node load_mapping(const std::string& mapping) {
+  if (fs::exists(mapping)) {
+    return YAML::LoadFile(mapping);
+  }
+  YAML::Node node;
+  node["impl"] = mapping;
+  return node;
+}
+
+// The data_block_size of the ECCPlugin of the configuration, or its default if there is none
+int64_t configured_data_block_size(const YAML::Node& config) {
+  const YAML::Node& plugins = config["MemorySystem"]["Controller"]["plugins"];
+  if (plugins && plugins.IsSequence()) {
+    for (const YAML::Node& plugin : plugins) {
+      const YAML::Node& node = plugin["ControllerPlugin"];
+      if (node && node["impl"] && node["impl"].as<std::string>() == "ECCPlugin") {
+        return node["data_block_size"].as<int64_t>(128);
+      }
+    }
+  }
+  return 128;
+}
+
+double ratio(double numerator, double denominator) {
+  return denominator > 0 ? numerator / denominator : 0.0;
+}
+
+}       // namespace
+
+
+int main(int argc, char* argv[]) {
+  argparse::ArgumentParser program("ramulator_trace_profile", "2.0");
+  program.add_argument("-f", "--config_file").required()
+    .help("Simulator configuration whose memory system maps the addresses.");
+  program.add_argument("-t", "--trace").required()
+    .help("Trace to profile (text or binary).");
+  program.add_argument("-k", "--kind").default_value(std::string("LoadStore"))
+    .help("Records of the trace: LoadStore (LD/ST), SimpleO3 or LLCMiss (binary).");
+  program.add_argument("-m", "--mapping").default_value(std::string(""))
+    .help("Mapping to profile under: a YAML file holding an AddrMapper node, or a mapper name (the configured one by default).");
+  program.add_argument("--data_block_size").scan<'i', int64_t>().default_value(int64_t(0))
+    .help("Bytes of data per ECC codeword (0 = the data_block_size of the configured ECCPlugin).");
+  program.add_argument("--line_bytes").scan<'i', int64_t>().default_value(int64_t(64))
+    .help("Bytes per memory access.");
+  program.add_argument("--window").scan<'i', int64_t>().default_value(int64_t(1000000))
+    .help("Accesses per time window of the read/write mix (0 = no windows).");
+  program.add_argument("--max_sampled_rows").scan<'i', int64_t>().default_value(int64_t(65536))
+    .help("Rows the reuse distance sketch samples at most.");
+  program.add_argument("--active_codewords").scan<'i', int64_t>().default_value(int64_t(4096))
+    .help("Codewords tracked at once, most recently touched first.");
+  program.add_argument("--top").scan<'i', int64_t>().default_value(int64_t(8))
+    .help("Banks listed, most accessed first (0 = all).");
+
+  YAML::Node config;
+  std::string trace_path, kind, mapping;
+  int64_t data_block_size, line_bytes, window, max_sampled_rows, active_codewords, num_top;
+  try {
+    program.parse_args(argc, argv);
+    config = Config::parse_config_file(program.get<std::string>("--config_file"), {});
+    trace_path = program.get<std::string>("--trace");
+    kind = program.get<std::string>("--kind");
+    mapping = program.get<std::string>("--mapping");
+    data_block_size = program.get<int64_t>("--data_block_size");
+    line_bytes = program.get<int64_t>("--line_bytes");
+    window = program.get<int64_t>("--window");
+    max_sampled_rows = program.get<int64_t>("--max_sampled_rows");
+    active_codewords = program.get<int64_t>("--active_codewords");
+    num_top = program.get<int64_t>("--top");
+    if (data_block_size == 0) {
+      data_block_size = configured_data_block_size(config);
+    }
+    if (data_block_size <= 0 || line_bytes <= 0 || max_sampled_rows <= 0 || active_codewords <= 0) {
+      throw std::runtime_error("data_block_size, line_bytes, max_sampled_rows and active_codewords must be positive!");
+    }
+    if (window < 0 || num_top < 0) {
+      throw std::runtime_error("window and top cannot be negative!");
+    }
+  }
+  catch (const std::runtime_error& err) {
+    spdlog::error(err.what());
+    std::cerr << program;
+    std::exit(1);
+  }
+
+  try {
+    if (!mapping.empty()) {
+      config["MemorySystem"]["AddrMapper"] = load_mapping(mapping);
+    }
+    auto frontend = Factory::create_frontend(config);
+    auto memory_system = Factory::create_memory_system(config);
+    frontend->connect_memory_system(memory_system);
+    memory_system->connect_frontend(frontend);
+
+    IDRAM* dram = memory_system->get_ifce<IDRAM>();
+    IAddrMapper* mapper = memory_system->get_ifce<IAddrMapper>();
+    const auto& count = dram->m_organization.count;
+    int row_level = dram->m_levels("row");
+    size_t num_banks = 1;
+    for (int level = 0; level < row_level; level++) {
+      num_banks *= count[level];
+    }
+
+    // The flat bank id and the row of an address
+    auto locate = [&](Addr_t addr) {
+      Request req(addr, Request::Type::Read);
+      mapper->apply(req);
+      uint64_t bank = 0;
+      for (int level = 0; level < row_level; level++) {
+        bank = bank * count[level] + std::max(req.addr_vec[level], 0);
+      }
+      return std::pair<uint64_t, int64_t>(bank, req.addr_vec[row_level]);
+    };
+
+    std::vector<BankCounts> banks(num_banks);
+    RowReuseSketch reuse(num_banks, max_sampled_rows);
+    CodewordTracker codewords(active_codewords, data_block_size, line_bytes, locate);
+    WindowCounts current_window;
+    size_t num_accesses = 0;
+    size_t num_windows = 0;
+
+    auto print_window = [&]() {
+      if (num_windows == 0) {
+        fmt::print("{:<10} {:>14} {:>10} {:>10} {:>8} {:>9} {:>8}\n", "window", "first_access", "reads", "writes", "write%", "row_hit", "banks");
+      }
+      const WindowCounts& w = current_window;
+      fmt::print("{:<10} {:>14} {:>10} {:>10} {:>8.1f} {:>9.3f} {:>8}\n", num_windows, num_windows * window,
+                 w.accesses - w.writes, w.writes, 100.0 * ratio(w.writes, w.accesses), ratio(w.row_hits, w.accesses), w.banks.size());
+      num_windows++;
+      current_window = WindowCounts();
+    };
+
+    spdlog::info("Profiling {} under {} ({} banks, {}-byte codewords).", trace_path,
+                 config["MemorySystem"]["AddrMapper"]["impl"].as<std::string>(), num_banks, data_block_size);
+    TraceAccesses::for_each(trace_path, kind, [&](Addr_t addr, bool is_write) {
+      auto [bank_id, row] = locate(addr);
+      BankCounts& bank = banks[bank_id];
+      bool row_hit = bank.has_open_row && bank.open_row == row;
+      bank.accesses++;
+      bank.writes += is_write;
+      bank.row_hits += row_hit;
+      bank.has_open_row = true;
+      bank.open_row = row;
+
+      reuse.access(bank_id, row);
+      codewords.access(addr, is_write);
+
+      num_accesses++;
+      if (window > 0) {
+        current_window.accesses++;
+        current_window.writes += is_write;
+        current_window.row_hits += row_hit;
+        current_window.banks.insert(bank_id);
+        if (current_window.accesses == size_t(window)) {
+          print_window();
+        }
+      }
+    });
+    if (window > 0 && current_window.accesses > 0) {
+      print_window();
+    }
+    codewords.close_all();
+    if (num_windows > 0) {
+      fmt::print("\n");
+    }
+
+    // Banks
+    size_t num_writes = 0, num_row_hits = 0, num_banks_used = 0;
+    std::vector<uint64_t> order;
+    for (uint64_t bank_id = 0; bank_id < num_banks; bank_id++) {
+      num_writes += banks[bank_id].writes;
+      num_row_hits += banks[bank_id].row_hits;
+      if (banks[bank_id].accesses > 0) {
+        num_banks_used++;
+        order.push_back(bank_id);
+      }
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint64_t a, uint64_t b) { return banks[a].accesses > banks[b].accesses; });
+    if (num_top > 0 && order.size() > size_t(num_top)) {
+      order.resize(num_top);
+    }
+    fmt::print("accesses {} (reads {}, writes {}), banks used {}/{}, row hit rate {:.3f}\n\n", num_accesses,
+               num_accesses - num_writes, num_writes, num_banks_used, num_banks, ratio(num_row_hits, num_accesses));
+    fmt::print("{:<10} {:>12} {:>8} {:>8} {:>9}\n", "bank", "accesses", "share", "write%", "row_hit");
+    for (uint64_t bank_id : order) {
+      const BankCounts& bank = banks[bank_id];
+      fmt::print("{:<10} {:>12} {:>8.3f} {:>8.1f} {:>9.3f}\n", bank_id, bank.accesses, ratio(bank.accesses, num_accesses),
+                 100.0 * ratio(bank.writes, bank.accesses), ratio(bank.row_hits, bank.accesses));
+    }
+
+    // Row reuse distances
+    double num_estimated = reuse.cold;
+    for (double reuses : reuse.histogram) {
+      num_estimated += reuses;
+    }
+    fmt::print("\nrow reuse distance (other rows of the bank in between; {} rows sampled, rate {:.4f})\n",
+               reuse.num_samples(), reuse.sampling_rate());
+    fmt::print("{:<14} {:>8} {:>11}\n", "distance", "share", "cumulative");
+    double cumulative = 0;
+    for (size_t bin = 0; bin < reuse.histogram.size(); bin++) {
+      cumulative += reuse.histogram[bin];
+      fmt::print("{:<14} {:>8.3f} {:>11.3f}\n", bin_name(bin), ratio(reuse.histogram[bin], num_estimated), ratio(cumulative, num_estimated));
+    }
+    fmt::print("{:<14} {:>8.3f}\n", "first access", ratio(reuse.cold, num_estimated));
+
+    // Codewords
+    const CodewordTracker::Totals& t = codewords.totals;
+    fmt::print("\ncodewords ({} bytes, {} lines of {} bytes, {} active at most)\n", data_block_size, codewords.lines_per_codeword(),
+               line_bytes, active_codewords);
+    fmt::print("{:<28} {:>10}\n", "episodes", t.episodes);
+    fmt::print("{:<28} {:>10.2f}\n", "accesses/episode", ratio(t.accesses, t.episodes));
+    fmt::print("{:<28} {:>10.2f}\n", "lines/episode", ratio(t.lines_touched, t.episodes));
+    fmt::print("{:<28} {:>10.3f}\n", "coverage", ratio(t.lines_touched, double(t.episodes) * codewords.lines_per_codeword()));
+    fmt::print("{:<28} {:>10.3f}\n", "partial write episodes", ratio(t.partial_write_episodes, t.write_episodes));
+    fmt::print("{:<28} {:>10.3f}\n", "split episodes", ratio(t.split_episodes, t.episodes));
+    fmt::print("{:<28} {:>10.2f}\n", "rows/episode", ratio(t.rows, t.episodes));
+  }
+  catch (const std::runtime_error& err) {
+    spdlog::error(err.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,230 @@
+#include <array>
+#include <vector>
+
+#include "base/base.h"
+#include "base/utils.h"
+#include "base/exception.h"
+#include "translation/translation.h"
+#include "frontend/frontend.h"
+#include "frontend/impl/processor/set_assoc_array.h"
+
+
+namespace Ramulator {
+
+/**
+ * @brief    Random physical page allocation with 4KB to 1GB pages, a radix page table and per-core TLBs
+ * @details
+ * Each core has its own radix tree of 512-entry nodes that are allocated from one arena, so a translation is a few
+ * indexed loads instead of a hash lookup. A node holds the indices of its children, and a leaf holds the page frame + 1
+ * (0 is unmapped). The free frames are listed, so allocating a random free frame takes constant time. A TLB per core
+ * caches the recent translations. Its misses can stall the requests for a number of translate() calls, which the
+ * cores make once per cycle while they wait.
+ *
+ */
+class HugePageTranslation : public ITranslation, public Implementation {
+  RAMULATOR_REGISTER_IMPLEMENTATION(ITranslation, HugePageTranslation, "HugePageTranslation", "Randomly allocate physical pages of up to 1GB through radix page tables and per-core TLBs.");
+
+  private:
+    static constexpr int NODE_BITS = 9;
+    static constexpr uint32_t NODE_SIZE = 1 << NODE_BITS;
+    using Node = std::array<uint32_t, NODE_SIZE>;
+
+    RandomStream m_allocator_rng;
+
+    Addr_t m_max_paddr;
+    Addr_t m_pagesize;
+    int    m_offsetbits;
+    int    m_num_table_levels;
+
+    std::vector<Node> m_nodes;              // The arena of all page tables. Node 0 is never a child, so 0 is "none".
+    std::vector<uint32_t> m_roots;          // Per core
+
+    std::vector<uint32_t> m_free_frames;
+    std::vector<int64_t> m_free_frame_idx;  // Position of each frame in m_free_frames, -1 if allocated or reserved
+    std::vector<bool> m_reserved_frames;
+
+    struct TLB {
+      SetAssocArray entries;
+      std::vector<uint32_t> frames;         // Per line of entries
+      Addr_t pending_vpn = -1;              // The miss being walked
+      int pending_cycles = 0;
+    };
+    std::vector<TLB> m_tlbs;
+    int m_tlb_miss_latency = 0;
+
+    size_t s_tlb_hits = 0;
+    size_t s_tlb_misses = 0;
+    size_t s_page_faults = 0;
+    size_t s_page_swaps = 0;
+    size_t s_page_table_nodes = 0;
+
+  public:
+    void init() override {
+      int seed = param<int>("seed").desc("The seed for the random number generator used to allocate pages.").default_val(123);
+      m_allocator_rng = random_stream(seed);
+
+      m_max_paddr = param<Addr_t>("max_addr").desc("Max physical address of the memory system.").required();
+      m_pagesize = parse_capacity_str(param<std::string>("pagesize").desc("Page size (e.g., 4KB, 2MB or 1GB).").default_val("4KB"));
+      int tlb_entries = param<int>("tlb_entries").desc("TLB entries per core (0 = no TLB).").default_val(64);
+      int tlb_ways = param<int>("tlb_associativity").desc("TLB associativity.").default_val(4);
+      m_tlb_miss_latency = param<int>("tlb_miss_latency").desc("translate() calls that a TLB miss stalls a request for (0 = no stall).").default_val(0);
+
+      if (m_pagesize < 4096 || (m_pagesize & (m_pagesize - 1)) != 0) {
+        throw ConfigurationError("HugePageTranslation: pagesize must be a power of two of at least 4KB (got {} bytes)!", m_pagesize);
+      }
+      if (m_max_paddr < m_pagesize || m_max_paddr / m_pagesize > UINT32_MAX - 1) {
+        throw ConfigurationError("HugePageTranslation: max_addr must hold between 1 and 2^32 - 2 pages!");
+      }
+      if (tlb_entries < 0 || (tlb_entries > 0 && (tlb_ways <= 0 || tlb_entries % tlb_ways != 0)) || m_tlb_miss_latency < 0) {
+        throw ConfigurationError("HugePageTranslation: tlb_entries must be a multiple of tlb_associativity and tlb_miss_latency non-negative!");
+      }
+      m_offsetbits = calc_log2(m_pagesize);
+      m_num_table_levels = (64 - m_offsetbits + NODE_BITS - 1) / NODE_BITS;
+
+      // Initially, all physical pages are free
+      size_t num_frames = m_max_paddr / m_pagesize;
+      m_free_frames.resize(num_frames);
+      m_free_frame_idx.resize(num_frames);
+      m_reserved_frames.resize(num_frames, false);
+      for (size_t frame = 0; frame < num_frames; frame++) {
+        m_free_frames[frame] = frame;
+        m_free_frame_idx[frame] = frame;
+      }
+
+      int num_cores = cast_parent<IFrontEnd>()->get_num_cores();
+      m_nodes.emplace_back();
+      for (int core = 0; core < num_cores; core++) {
+        m_roots.push_back(new_node());
+        if (tlb_entries > 0) {
+          m_tlbs.push_back({SetAssocArray(tlb_entries / tlb_ways, tlb_ways), std::vector<uint32_t>(tlb_entries, 0)});
+        }
+      }
+
+      m_logger = Logging::create_logger("HugePageTranslation");
+      m_logger->info("{} frames of {} bytes, {}-level page tables.", num_frames, m_pagesize, m_num_table_levels);
+
+      register_stat(s_tlb_hits).name("tlb_hits");
+      register_stat(s_tlb_misses).name("tlb_misses");
+      register_stat(s_page_faults).name("page_faults");
+      register_stat(s_page_swaps).name("page_swaps");
+      register_stat(s_page_table_nodes).name("page_table_nodes");
+    };
+
+    bool translate(Request& req) override {
+      uint64_t vpn = uint64_t(req.addr) >> m_offsetbits;
+
+      uint32_t frame;
+      if (m_tlbs.empty()) {
+        frame = walk(req.source_id, vpn);
+      } else {
+        TLB& tlb = m_tlbs[req.source_id];
+        int set = vpn % tlb.entries.num_sets();
+        Addr_t tag = vpn / tlb.entries.num_sets();
+        if (int way = tlb.entries.find(set, tag); way != -1) {
+          s_tlb_hits++;
+          tlb.entries.touch(set, way);
+          frame = tlb.frames[tlb.entries.line(set, way)];
+        } else {
+          // A miss stalls the request until the walk is done
+          if (m_tlb_miss_latency > 0) {
+            if (tlb.pending_vpn != Addr_t(vpn)) {
+              s_tlb_misses++;
+              tlb.pending_vpn = vpn;
+              tlb.pending_cycles = m_tlb_miss_latency;
+              return false;
+            }
+            if (--tlb.pending_cycles > 0) {
+              return false;
+            }
+            tlb.pending_vpn = -1;
+          } else {
+            s_tlb_misses++;
+          }
+
+          frame = walk(req.source_id, vpn);
+          way = tlb.entries.find_empty(set);
+          if (way == -1) {
+            way = tlb.entries.find_victim(set);
+            tlb.entries.invalidate(set, way);
+          }
+          tlb.frames[tlb.entries.fill(set, way, tag, SetAssocArray::READY)] = frame;
+        }
+      }
+
+      Addr_t p_addr = (Addr_t(frame) << m_offsetbits) | (req.addr & (m_pagesize - 1));
+      DEBUG_LOG(DTRANSLATE, m_logger, "Translated Addr {}, VPN {} to Addr {}, PPN {}.", req.addr, vpn, p_addr, frame);
+      req.addr = p_addr;
+      return true;
+    };
+
+    bool reserve(const std::string& type, Addr_t addr) override {
+      uint64_t frame = addr >> m_offsetbits;
+      if (frame < m_reserved_frames.size()) {
+        m_reserved_frames[frame] = true;
+        take_frame(frame);
+      }
+      return true;
+    };
+
+    Addr_t get_max_addr() override {
+      return m_max_paddr;
+    };
+
+  private:
+    uint32_t new_node() {
+      m_nodes.emplace_back();
+      m_nodes.back().fill(0);
+      s_page_table_nodes++;
+      return m_nodes.size() - 1;
+    };
+
+    // Returns the frame of vpn in the page table of core, allocating the page on its first access
+    uint32_t walk(int core, uint64_t vpn) {
+      uint32_t node = m_roots[core];
+      for (int level = m_num_table_levels - 1; level > 0; level--) {
+        uint32_t idx = (vpn >> (level * NODE_BITS)) & (NODE_SIZE - 1);
+        if (m_nodes[node][idx] == 0) {
+          // new_node() can move the arena
+          uint32_t child = new_node();
+          m_nodes[node][idx] = child;
+        }
+        node = m_nodes[node][idx];
+      }
+      uint32_t& leaf = m_nodes[node][vpn & (NODE_SIZE - 1)];
+      if (leaf == 0) {
+        leaf = allocate_frame() + 1;
+      }
+      return leaf - 1;
+    };
+
+    uint32_t allocate_frame() {
+      s_page_faults++;
+      if (m_free_frames.empty()) {
+        // We run out of physical pages. Randomly replace a previously assigned page (swap latency not modeled!)
+        s_page_swaps++;
+        uint32_t frame = m_allocator_rng() % m_reserved_frames.size();
+        while (m_reserved_frames[frame]) {
+          frame = m_allocator_rng() % m_reserved_frames.size();
+        }
+        return frame;
+      }
+      uint32_t frame = m_free_frames[m_allocator_rng() % m_free_frames.size()];
+      take_frame(frame);
+      return frame;
+    };
+
+    // Removes frame from the free frames, if it is there
+    void take_frame(uint32_t frame) {
+      int64_t idx = m_free_frame_idx[frame];
+      if (idx == -1) {
+        return;
+      }
+      uint32_t last = m_free_frames.back();
+      m_free_frames[idx] = last;
+      m_free_frame_idx[last] = idx;
+      m_free_frames.pop_back();
+      m_free_frame_idx[frame] = -1;
+    };
+};
+
+}   // namespace Ramulator
@@ -1,7 +1,6 @@
 #include <iostream>
 #include <unordered_set>
 #include <vector>
-#include <random>
 
 #include "base/base.h"
 #include "translation/translation.h"
@@ -16,7 +15,7 @@ class RandomTranslation : public ITranslation, public Implementation {
   IFrontEnd* m_frontend;
 
   protected:
-    std::mt19937_64 m_allocator_rng;
+    RandomStream m_allocator_rng;
 
     Addr_t m_max_paddr;         // Max physical address
     Addr_t m_pagesize;          // Page size in bytes
@@ -35,7 +34,7 @@ class RandomTranslation : public ITranslation, public Implementation {
   public:
     void init() override {
       int seed = param<int>("seed").desc("The seed for the random number generator used to allocate pages.").default_val(123);
-      m_allocator_rng.seed(seed);
+      m_allocator_rng = random_stream(seed);
 
       m_max_paddr   = param<Addr_t>("max_addr").desc("Max physical address of the memory system.").required();
       m_pagesize    = param<Addr_t>("pagesize_KB").desc("Pagesize in KB.").default_val(4) << 10;